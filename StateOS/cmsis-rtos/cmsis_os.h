@@ -866,17 +866,12 @@ const osMailQDef_t os_mailQ_def_##name = \
 { (queue_sz), sizeof(type), NULL }
 #else
 #define osMailQDef(name, queue_sz, type) \
-static void              *os_mail_p_##name[2]; \
-static osMemoryPool_t   os_mail_mp_cb_##name; \
-static osMessageQueue_t os_mail_mq_cb_##name; \
-static uint32_t os_mail_mp_data_##name[osMemoryPoolMemSize  ((queue_sz),sizeof(type) )/4]; \
-static uint32_t os_mail_mq_data_##name[osMessageQueueMemSize((queue_sz),sizeof(void*))/4]; \
+static mlq_t os_mail_cb_##name; \
+static void *os_mail_data_##name[osMailQueueMemSize((queue_sz),sizeof(type))/sizeof(void*)]; \
 const osMailQDef_t os_mailQ_def_##name = \
-{ (queue_sz), sizeof(type), (&os_mail_p_##name), \
-  { NULL, 0U, (&os_mail_mp_cb_##name), osMemoryPoolCbSize, \
-              (&os_mail_mp_data_##name), sizeof(os_mail_mp_data_##name) }, \
-  { NULL, 0U, (&os_mail_mq_cb_##name), osMessageQueueCbSize, \
-              (&os_mail_mq_data_##name), sizeof(os_mail_mq_data_##name) } }
+{ (queue_sz), sizeof(type), (&os_mail_cb_##name), \
+  { NULL, 0U, NULL, 0U, (&os_mail_data_##name), sizeof(os_mail_data_##name) }, \
+  { NULL, 0U, NULL, 0U, NULL, 0U } }
 #endif
 #endif
  
@@ -248,121 +248,111 @@ os_InRegs osEvent osMessageGet (osMessageQId queue_id, uint32_t millisec) {
 
 #if (defined(osFeature_MailQ) && (osFeature_MailQ != 0)) && !defined(os1_Disable_MailQ)
 
-typedef struct os_mail_queue_s {
-  osMemoryPoolId_t   mp_id;
-  osMessageQueueId_t mq_id;
-} os_mail_queue_t;
+// mails are passed by pointer through one StateOS mail queue object (pool and FIFO queue in one control block)
 
 osMailQId osMailCreate (const osMailQDef_t *queue_def, osThreadId thread_id) {
-  os_mail_queue_t *ptr;
+  mlq_t *mlq;
   (void)thread_id;
 
   if (queue_def == NULL) {
     return NULL;
   }
 
-  ptr = queue_def->mail;
-  if (ptr == NULL) {
+  mlq = queue_def->mail;
+  if ((mlq == NULL) || (queue_def->mp_attr.mp_mem == NULL) ||
+      (queue_def->mp_attr.mp_size < osMailQueueMemSize(queue_def->queue_sz, queue_def->item_sz))) {
     return NULL;
   }
 
-  ptr->mp_id = osMemoryPoolNew  (queue_def->queue_sz, queue_def->item_sz, &queue_def->mp_attr);
-  ptr->mq_id = osMessageQueueNew(queue_def->queue_sz, sizeof(void *), &queue_def->mq_attr);
-  if ((ptr->mp_id == NULL) || (ptr->mq_id == NULL)) {
-    if (ptr->mp_id != NULL) {
-      osMemoryPoolDelete(ptr->mp_id);
-    }
-    if (ptr->mq_id != NULL) {
-      osMessageQueueDelete(ptr->mq_id);
-    }
-    return NULL;
-  }
+  mlq_init(mlq, queue_def->queue_sz, queue_def->item_sz, queue_def->mp_attr.mp_mem);
 
-  return ptr;
+  return mlq;
 }
 
 void *osMailAlloc (osMailQId queue_id, uint32_t millisec) {
-  os_mail_queue_t *ptr = (os_mail_queue_t *)queue_id;
+  mlq_t *mlq = (mlq_t *)queue_id;
+  void  *mail;
 
-  if (ptr == NULL) {
+  if (mlq == NULL) {
     return NULL;
   }
-  return osMemoryPoolAlloc(ptr->mp_id, millisec);
-}
-
-void *osMailCAlloc (osMailQId queue_id, uint32_t millisec) {
-  os_mail_queue_t *ptr = (os_mail_queue_t *)queue_id;
-  void            *block;
-  uint32_t         block_size;
-
-  if (ptr == NULL) {
+  if ((IS_IRQ_MODE() || IS_IRQ_MASKED()) && (millisec != 0U)) {
     return NULL;
   }
-  block_size = osMemoryPoolGetBlockSize(ptr->mp_id);
-  if (block_size == 0U) {
+  if (mlq_allocFor(mlq, &mail, millisec) != E_SUCCESS) {
     return NULL;
   }
-  block = osMemoryPoolAlloc(ptr->mp_id, millisec);
-  if (block != NULL) {
-    memset(block, 0, block_size);
-  }
 
-  return block;
+  return mail;
+}
+
+void *osMailCAlloc (osMailQId queue_id, uint32_t millisec) {
+  mlq_t *mlq = (mlq_t *)queue_id;
+  void  *mail;
 
+  mail = osMailAlloc(queue_id, millisec);
+  if (mail != NULL) {
+    memset(mail, 0, mlq->size * sizeof(que_t));
+  }
+
+  return mail;
 }
 
 osStatus osMailPut (osMailQId queue_id, const void *mail) {
-  os_mail_queue_t *ptr = (os_mail_queue_t *)queue_id;
+  mlq_t *mlq = (mlq_t *)queue_id;
 
-  if (ptr == NULL) {
+  if (mlq == NULL) {
     return osErrorParameter;
   }
   if (mail == NULL) {
     return osErrorValue;
   }
-  return osMessageQueuePut(ptr->mq_id, &mail, 0U, 0U);
+  mlq_give(mlq, mail);
+
+  return osOK;
 }
 
 os_InRegs osEvent osMailGet (osMailQId queue_id, uint32_t millisec) {
-  os_mail_queue_t *ptr = (os_mail_queue_t *)queue_id;
-  osStatus_t       status;
-  osEvent          event;
-  void            *mail;
+  mlq_t  *mlq = (mlq_t *)queue_id;
+  osEvent event;
+  void   *mail;
 
-  if (ptr == NULL) {
+  if (mlq == NULL) {
+    event.status = osErrorParameter;
+    return event;
+  }
+  if ((IS_IRQ_MODE() || IS_IRQ_MASKED()) && (millisec != 0U)) {
     event.status = osErrorParameter;
     return event;
   }
 
-  status = osMessageQueueGet(ptr->mq_id, &mail, NULL, millisec);
-  switch (status) {
-    case osOK:
+  switch (mlq_waitFor(mlq, &mail, millisec)) {
+    case E_SUCCESS:
       event.status = osEventMail;
       event.value.p = mail;
       break;
-    case osErrorResource:
-      event.status = osOK;
-      break;
-    case osErrorTimeout:
-      event.status = osEventTimeout;
+    case E_TIMEOUT:
+      event.status = (millisec != 0U) ? osEventTimeout : osOK;
       break;
     default:
-      event.status = status;
+      event.status = osErrorResource;
       break;
   }
   return event;
 }
 
 osStatus osMailFree (osMailQId queue_id, void *mail) {
-  os_mail_queue_t *ptr = (os_mail_queue_t *)queue_id;
+  mlq_t *mlq = (mlq_t *)queue_id;
 
-  if (ptr == NULL) {
+  if (mlq == NULL) {
     return osErrorParameter;
   }
   if (mail == NULL) {
     return osErrorValue;
   }
-  return osMemoryPoolFree(ptr->mp_id, mail);
+  mlq_free(mlq, mail);
+
+  return osOK;
 }
 
 #endif  // Mail Queue
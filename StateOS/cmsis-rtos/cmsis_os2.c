@@ -51,11 +51,115 @@
 
  ******************************************************************************/
 
+#define __CMSIS_OS2_C
+
 #include <string.h>
 #include "oscmsis.h"
 
 /* -------------------------------------------------------------------------- */
 
+#define POOL_DEF( pool, num, size ) \
+        static void *pool##__buf[(num) * (MHEAD + MSIZE(size))]; \
+        static mem_t pool = _MEM_INIT(num, size, pool##__buf)
+
+#if     OS_THREAD_NUM
+POOL_DEF(ThreadPool, OS_THREAD_NUM, ABOVE(osThreadCbSize) + osThreadStackSize(0));
+#define THREAD_POOL (&ThreadPool)
+#else
+#define THREAD_POOL NULL
+#endif
+
+#if     OS_TIMER_NUM
+POOL_DEF(TimerPool, OS_TIMER_NUM, osTimerCbSize);
+#define TIMER_POOL (&TimerPool)
+#else
+#define TIMER_POOL NULL
+#endif
+
+#if     OS_EVFLAGS_NUM
+POOL_DEF(EventFlagsPool, OS_EVFLAGS_NUM, osEventFlagsCbSize);
+#define EVFLAGS_POOL (&EventFlagsPool)
+#else
+#define EVFLAGS_POOL NULL
+#endif
+
+#if     OS_MUTEX_NUM
+POOL_DEF(MutexPool, OS_MUTEX_NUM, osMutexCbSize);
+#define MUTEX_POOL (&MutexPool)
+#else
+#define MUTEX_POOL NULL
+#endif
+
+#if     OS_SEMAPHORE_NUM
+POOL_DEF(SemaphorePool, OS_SEMAPHORE_NUM, osSemaphoreCbSize);
+#define SEMAPHORE_POOL (&SemaphorePool)
+#else
+#define SEMAPHORE_POOL NULL
+#endif
+
+#if     OS_MEMPOOL_NUM
+POOL_DEF(MemoryPoolPool, OS_MEMPOOL_NUM, ABOVE(osMemoryPoolCbSize) + OS_MEMPOOL_MEM);
+#define MEMPOOL_POOL (&MemoryPoolPool)
+#else
+#define MEMPOOL_POOL NULL
+#endif
+
+#if     OS_MSGQUEUE_NUM
+POOL_DEF(MessageQueuePool, OS_MSGQUEUE_NUM, ABOVE(osMessageQueueCbSize) + OS_MSGQUEUE_MEM);
+#define MSGQUEUE_POOL (&MessageQueuePool)
+#else
+#define MSGQUEUE_POOL NULL
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+static bool KernelSuspended = false; // between osKernelSuspend and osKernelResume
+
+/* -------------------------------------------------------------------------- */
+
+static void pool_bind (mem_t *mem)
+{
+	if (mem != NULL)
+		core_sys_bind(mem);
+}
+
+/* -------------------------------------------------------------------------- */
+
+// take memory object of 'size' bytes from the static pool 'mem', use the system heap if the pool is empty or too small
+// the object is released with sys_free, i.e. when the kernel object is deleted
+
+static void *pool_alloc (mem_t *mem, size_t size)
+{
+	static bool init = false;
+	void *ptr = NULL;
+
+	sys_lock();
+	{
+		if (!init)
+		{
+			init = true;
+			pool_bind(THREAD_POOL);
+			pool_bind(TIMER_POOL);
+			pool_bind(EVFLAGS_POOL);
+			pool_bind(MUTEX_POOL);
+			pool_bind(SEMAPHORE_POOL);
+			pool_bind(MEMPOOL_POOL);
+			pool_bind(MSGQUEUE_POOL);
+		}
+
+		if (mem != NULL && size <= mem->size * sizeof(que_t) && mem_take(mem, &ptr) == E_SUCCESS)
+			ptr = memset(ptr, 0, size);
+	}
+	sys_unlock();
+
+	if (ptr == NULL)
+		ptr = sys_alloc(size);
+
+	return ptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
 osStatus_t osKernelInitialize (void)
 {
 	if (IS_IRQ_MODE() || IS_IRQ_MASKED())
@@ -81,7 +185,7 @@ osStatus_t osKernelGetInfo (osVersion_t *version, char *id_buf, uint32_t id_size
 
 osKernelState_t osKernelGetState (void)
 {
-	return osKernelRunning;
+	return KernelSuspended ? osKernelSuspended : osKernelRunning;
 }
 
 osStatus_t osKernelStart (void)
@@ -128,12 +232,33 @@ int32_t osKernelRestoreLock (int32_t lock)
 
 uint32_t osKernelSuspend (void)
 {
-	return 0U;
+	cnt_t ticks;
+
+	if (IS_IRQ_MODE() || KernelSuspended)
+		return 0U;
+
+	ticks = core_sys_suspend();
+	if (ticks == 0)
+		return 0U; // suspension refused, the kernel is still running
+
+	KernelSuspended = true;
+
+	if (ticks == INFINITE)
+		return osWaitForever;
+#if OS_TIMER_SIZE > 32
+	if (ticks >= osWaitForever)
+		return osWaitForever - 1U;
+#endif
+	return (uint32_t)ticks;
 }
 
 void osKernelResume (uint32_t sleep_ticks)
 {
-	(void) sleep_ticks;
+	if (IS_IRQ_MODE() || !KernelSuspended)
+		return;
+
+	KernelSuspended = false;
+	core_sys_resume((cnt_t)sleep_ticks);
 }
 
 uint32_t osKernelGetTickCount (void)
@@ -148,7 +273,7 @@ uint32_t osKernelGetTickFreq (void)
 
 uint32_t osKernelGetSysTimerCount (void)
 {
-#if HW_TIMER_SIZE
+#if HW_TIMER_SIZE || !defined(SysTick)
 	return sys_time();
 #else
 	uint32_t cnt;
@@ -175,8 +300,10 @@ uint32_t osKernelGetSysTimerCount (void)
 
 uint32_t osKernelGetSysTimerFreq (void)
 {
-#if HW_TIMER_SIZE
+#if HW_TIMER_SIZE || !defined(SysTick)
 	return  OS_FREQUENCY;
+#elif OS_CPU_SCALING
+	return (SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? port_cpu_frequency : port_cpu_frequency / 8U;
 #elif (CPU_FREQUENCY)/(OS_FREQUENCY)-1 <= SysTick_LOAD_RELOAD_Msk
 	return CPU_FREQUENCY;
 #else
@@ -186,6 +313,30 @@ uint32_t osKernelGetSysTimerFreq (void)
 
 /* -------------------------------------------------------------------------- */
 
+osStatus_t osKernelGetHeapInfo (osHeapInfo_t *heap_info)
+{
+	hst_t info;
+
+	if (IS_IRQ_MODE() || IS_IRQ_MASKED())
+		return osErrorISR;
+
+	if (heap_info == NULL)
+		return osErrorParameter;
+
+	sys_heapInfo(&info);
+
+	heap_info->heap_size   = info.size;
+	heap_info->free_size   = info.free;
+	heap_info->max_block   = info.largest;
+	heap_info->peak_used   = info.peak;
+	heap_info->free_blocks = info.blocks;
+	heap_info->alloc_count = info.allocs;
+
+	return osOK;
+}
+
+/* -------------------------------------------------------------------------- */
+
 static void thread_handler (void)
 {
 	void *tmp = tsk_this(); // because of COSMIC compiler
@@ -232,7 +383,7 @@ osThreadId_t osThreadNew (osThreadFunc_t func, void *argument, const osThreadAtt
 	if (thread == NULL && stack_mem == NULL)
 	{
 		stack_size = osThreadStackSize(stack_size);
-		thread = sys_alloc(ABOVE(osThreadCbSize) + stack_size);
+		thread = pool_alloc(THREAD_POOL, ABOVE(osThreadCbSize) + stack_size);
 		stack_mem = (void *)((size_t)thread + ABOVE(osThreadCbSize));
 		if (thread == NULL)
 			return NULL;
@@ -240,7 +391,7 @@ osThreadId_t osThreadNew (osThreadFunc_t func, void *argument, const osThreadAtt
 	else
 	if (thread == NULL)
 	{
-		thread = sys_alloc(osThreadCbSize);
+		thread = pool_alloc(THREAD_POOL, osThreadCbSize);
 		if (thread == NULL)
 			return NULL;
 	}
@@ -248,7 +399,7 @@ osThreadId_t osThreadNew (osThreadFunc_t func, void *argument, const osThreadAtt
 	if (stack_mem == NULL)
 	{
 		stack_size = osThreadStackSize(stack_size);
-		stack_mem = sys_alloc(stack_size);
+		stack_mem = pool_alloc(THREAD_POOL, stack_size);
 		if (stack_mem == NULL)
 			return NULL;
 	}
@@ -256,7 +407,7 @@ osThreadId_t osThreadNew (osThreadFunc_t func, void *argument, const osThreadAtt
 	sys_lock();
 	{
 		tsk_init(&thread->tsk, (attr == NULL) ? osPriorityNormal : attr->priority, thread_handler, stack_mem, stack_size);
-		if (attr->cb_mem    == NULL || attr->cb_size    == 0U) thread->tsk.obj.res = thread;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) thread->tsk.obj.res = thread;
 		else
 		if (attr->stack_mem == NULL || attr->stack_size == 0U) thread->tsk.obj.res = stack_mem;
 		thread->tsk.join = (flags & osThreadJoinable) ? JOINABLE : DETACHED;
@@ -432,7 +583,7 @@ uint32_t osThreadGetStackSize (osThreadId_t thread_id)
 	if (IS_IRQ_MODE() || IS_IRQ_MASKED() || (thread_id == NULL))
 		return 0U;
 
-	return (uint32_t) thread->tsk.top - (uint32_t) thread->tsk.stack;
+	return (uint32_t)((size_t) thread->tsk.top - (size_t) thread->tsk.stack);
 }
 
 uint32_t osThreadGetStackSpace (osThreadId_t thread_id)
@@ -445,72 +596,37 @@ uint32_t osThreadGetStackSpace (osThreadId_t thread_id)
 	if (&thread->tsk == &MAIN)
 		return 0U;
 
+#if OS_STACK_MONITOR
+	return (uint32_t)((size_t) thread->tsk.top - (size_t) thread->tsk.stack - tsk_stackUsed(&thread->tsk));
+#else
 	if (&thread->tsk != tsk_this())
-		return (uint32_t) thread->tsk.sp - (uint32_t) thread->tsk.stack;
+		return (uint32_t)((size_t) thread->tsk.sp - (size_t) thread->tsk.stack);
 
-	return (uint32_t) port_get_sp() - (uint32_t) thread->tsk.stack;
+	return (uint32_t)((size_t) port_get_sp() - (size_t) thread->tsk.stack);
+#endif
 }
 
 uint32_t osThreadGetCount (void)
 {
-	tsk_t   *tsk;
-	tmr_t   *tmr;
-	uint32_t count = 0;
-
 	if (IS_IRQ_MODE() || IS_IRQ_MASKED())
 		return 0U;
 
-	sys_lock();
-	{
-		count++;
-
-		for (tsk = IDLE.obj.next; tsk != &IDLE; tsk = tsk->obj.next)
-			count++;
-
-		for (tmr = WAIT.obj.next; tmr != &WAIT; tmr = tmr->obj.next)
-			if (tmr->id == ID_DELAYED)
-				count++;
-	}
-	sys_unlock();
-
-	return count;
+	return tsk_count();
 }
 
 uint32_t osThreadEnumerate (osThreadId_t *thread_array, uint32_t array_items)
 {
-	tsk_t   *tsk;
-	tmr_t   *tmr;
-	uint32_t count = 0;
-
 	if (IS_IRQ_MODE() || IS_IRQ_MASKED() || (thread_array == NULL) || (array_items == 0U))
 		return 0U;
 
-	sys_lock();
-	{
-		thread_array[count++] = &IDLE;
-
-		for (tsk = IDLE.obj.next; (tsk != &IDLE) && (count < array_items); tsk = tsk->obj.next)
-			thread_array[count++] = tsk;
-
-		for (tmr = WAIT.obj.next; (tmr != &WAIT) && (count < array_items); tmr = tmr->obj.next)
-			if (tmr->id == ID_DELAYED)
-				thread_array[count++] = tmr;
-	}
-	sys_unlock();
-
-	return count;
+	return tsk_enumerate((tsk_t **)thread_array, array_items);
 }
 
 /* -------------------------------------------------------------------------- */
 
 uint32_t osThreadFlagsSet (osThreadId_t thread_id, uint32_t flags)
 {
-	osThread_t *thread = thread_id;
-
-	if ((thread_id == NULL) || ((flags & osFlagsError) != 0U))
-		return osFlagsErrorParameter;
-
-	return flg_give(&thread->flg, flags);
+	return __osThreadFlagsSet(thread_id, flags);
 }
 
 uint32_t osThreadFlagsClear (uint32_t flags)
@@ -537,20 +653,7 @@ uint32_t osThreadFlagsGet (void)
 
 uint32_t osThreadFlagsWait (uint32_t flags, uint32_t options, uint32_t timeout)
 {
-	void *tmp = tsk_this(); // because of COSMIC compiler
-	osThread_t *thread = tmp;
-
-	if (IS_IRQ_MODE() || IS_IRQ_MASKED())
-		return osFlagsErrorISR;
-	if ((flags & osFlagsError) != 0U)
-		return osFlagsErrorParameter;
-
-	switch (flg_waitFor(&thread->flg, flags, options, timeout))
-	{
-		case E_SUCCESS: return flags;
-		case E_TIMEOUT: return osFlagsErrorTimeout;
-		default:        return osFlagsErrorResource;
-	}
+	return __osThreadFlagsWait(flags, options, timeout);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -579,15 +682,6 @@ osStatus_t osDelayUntil (uint32_t ticks)
 	}
 }
 
-/* -------------------------------------------------------------------------- */
-
-static void timer_handler (void)
-{
-	void *tmp = tmr_thisISR(); // because of COSMIC compiler
-	osTimer_t *timer = tmp;
-
-	timer->func(timer->arg);
-}
 
 /* -------------------------------------------------------------------------- */
 
@@ -611,19 +705,17 @@ osTimerId_t osTimerNew (osTimerFunc_t func, osTimerType_t type, void *argument,
 
 	if (timer == NULL)
 	{
-		timer = sys_alloc(osTimerCbSize);
+		timer = pool_alloc(TIMER_POOL, osTimerCbSize);
 		if (timer == NULL)
 			return NULL;
 	}
 
 	sys_lock();
 	{
-		tmr_init(&timer->tmr, timer_handler);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) timer->tmr.obj.res = timer;
+		tmr_initArg(&timer->tmr, func, argument);
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) timer->tmr.obj.res = timer;
 		timer->flags = flags;
 		timer->name = (attr == NULL) ? NULL : attr->name;
-		timer->func = func;
-		timer->arg = argument;
 	}
 	sys_unlock();
 
@@ -714,7 +806,7 @@ osEventFlagsId_t osEventFlagsNew (const osEventFlagsAttr_t *attr)
 
 	if (ef == NULL)
 	{
-		ef = sys_alloc(osEventFlagsCbSize);
+		ef = pool_alloc(EVFLAGS_POOL, osEventFlagsCbSize);
 		if (ef == NULL)
 			return NULL;
 	}
@@ -722,7 +814,7 @@ osEventFlagsId_t osEventFlagsNew (const osEventFlagsAttr_t *attr)
 	sys_lock();
 	{
 		flg_init(&ef->flg, 0);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) ef->flg.res = ef;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) ef->flg.res = ef;
 		ef->flags = flags;
 		ef->name = (attr == NULL) ? NULL : attr->name;
 	}
@@ -733,12 +825,7 @@ osEventFlagsId_t osEventFlagsNew (const osEventFlagsAttr_t *attr)
 
 uint32_t osEventFlagsSet (osEventFlagsId_t ef_id, uint32_t flags)
 {
-	osEventFlags_t *ef = ef_id;
-
-	if ((ef_id == NULL) || ((flags & osFlagsError) != 0U))
-		return osFlagsErrorParameter;
-
-	return flg_give(&ef->flg, flags);
+	return __osEventFlagsSet(ef_id, flags);
 }
 
 uint32_t osEventFlagsClear (osEventFlagsId_t ef_id, uint32_t flags)
@@ -763,19 +850,7 @@ uint32_t osEventFlagsGet (osEventFlagsId_t ef_id)
 
 uint32_t osEventFlagsWait (osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout)
 {
-	osEventFlags_t *ef = ef_id;
-
-	if ((ef_id == NULL) || ((flags & osFlagsError) != 0U))
-		return osFlagsErrorParameter;
-	if ((IS_IRQ_MODE() || IS_IRQ_MASKED()) && (timeout != 0U))
-		return osFlagsErrorParameter;
-
-	switch (flg_waitFor(&ef->flg, flags, options, timeout))
-	{
-		case E_SUCCESS: return flags;
-		case E_TIMEOUT: return osFlagsErrorTimeout;
-		default:        return osFlagsErrorResource;
-	}
+	return __osEventFlagsWait(ef_id, flags, options, timeout);
 }
 
 osStatus_t osEventFlagsDelete (osEventFlagsId_t ef_id)
@@ -826,7 +901,7 @@ osMutexId_t osMutexNew (const osMutexAttr_t *attr)
 
 	if (mutex == NULL)
 	{
-		mutex = sys_alloc(osMutexCbSize);
+		mutex = pool_alloc(MUTEX_POOL, osMutexCbSize);
 		if (mutex == NULL)
 			return NULL;
 	}
@@ -834,7 +909,7 @@ osMutexId_t osMutexNew (const osMutexAttr_t *attr)
 	sys_lock();
 	{
 		mtx_init(&mutex->mtx);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) mutex->mtx.res = mutex;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) mutex->mtx.res = mutex;
 		mutex->flags = flags;
 		mutex->name = (attr == NULL) ? NULL : attr->name;
 	}
@@ -855,35 +930,12 @@ const char *osMutexGetName (osMutexId_t mutex_id)
 
 osStatus_t osMutexAcquire (osMutexId_t mutex_id, uint32_t timeout)
 {
-	osMutex_t *mutex = mutex_id;
-
-	if (IS_IRQ_MODE() || IS_IRQ_MASKED())
-		return osErrorISR;
-	if (mutex_id == NULL)
-		return osErrorParameter;
-
-	switch (mtx_waitFor(&mutex->mtx, timeout))
-	{
-		case E_SUCCESS: return osOK;
-		case E_TIMEOUT: return osErrorTimeout;
-		default:        return osErrorResource;
-	}
+	return __osMutexAcquire(mutex_id, timeout);
 }
 
 osStatus_t osMutexRelease (osMutexId_t mutex_id)
 {
-	osMutex_t *mutex = mutex_id;
-
-	if (IS_IRQ_MODE() || IS_IRQ_MASKED())
-		return osErrorISR;
-	if (mutex_id == NULL)
-		return osErrorParameter;
-
-	switch (mtx_give(&mutex->mtx))
-	{
-		case E_SUCCESS: return osOK;
-		default:        return osErrorResource;
-	}
+	return __osMutexRelease(mutex_id);
 }
 
 osThreadId_t osMutexGetOwner (osMutexId_t mutex_id)
@@ -932,7 +984,7 @@ osSemaphoreId_t osSemaphoreNew (uint32_t max_count, uint32_t initial_count, cons
 
 	if (semaphore == NULL)
 	{
-		semaphore = sys_alloc(osSemaphoreCbSize);
+		semaphore = pool_alloc(SEMAPHORE_POOL, osSemaphoreCbSize);
 		if (semaphore == NULL)
 			return NULL;
 	}
@@ -940,7 +992,7 @@ osSemaphoreId_t osSemaphoreNew (uint32_t max_count, uint32_t initial_count, cons
 	sys_lock();
 	{
 		sem_init(&semaphore->sem, initial_count, max_count);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) semaphore->sem.res = semaphore;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) semaphore->sem.res = semaphore;
 		semaphore->flags = flags;
 		semaphore->name = (attr == NULL) ? NULL : attr->name;
 	}
@@ -960,15 +1012,27 @@ const char *osSemaphoreGetName (osSemaphoreId_t semaphore_id)
 }
 
 osStatus_t osSemaphoreAcquire (osSemaphoreId_t semaphore_id, uint32_t timeout)
+{
+	return __osSemaphoreAcquire(semaphore_id, timeout);
+}
+
+osStatus_t osSemaphoreRelease (osSemaphoreId_t semaphore_id)
+{
+	return __osSemaphoreRelease(semaphore_id);
+}
+
+osStatus_t osSemaphoreAcquireN (osSemaphoreId_t semaphore_id, uint32_t count, uint32_t timeout)
 {
 	osSemaphore_t *semaphore = semaphore_id;
 
 	if (semaphore_id == NULL)
 		return osErrorParameter;
+	if (count == 0U || count > semaphore->sem.limit)
+		return osErrorParameter;
 	if ((IS_IRQ_MODE() || IS_IRQ_MASKED()) && (timeout != 0U))
 		return osErrorParameter;
 
-	switch (sem_waitFor(&semaphore->sem, timeout))
+	switch (sem_takeN(&semaphore->sem, count, timeout))
 	{
 		case E_SUCCESS: return osOK;
 		case E_TIMEOUT: return osErrorTimeout;
@@ -976,14 +1040,14 @@ osStatus_t osSemaphoreAcquire (osSemaphoreId_t semaphore_id, uint32_t timeout)
 	}
 }
 
-osStatus_t osSemaphoreRelease (osSemaphoreId_t semaphore_id)
+osStatus_t osSemaphoreReleaseN (osSemaphoreId_t semaphore_id, uint32_t count)
 {
 	osSemaphore_t *semaphore = semaphore_id;
 
 	if (semaphore_id == NULL)
 		return osErrorParameter;
 
-	switch (sem_give(&semaphore->sem))
+	switch (sem_giveN(&semaphore->sem, count))
 	{
 		case E_SUCCESS: return osOK;
 		default:        return osErrorResource;
@@ -1045,7 +1109,7 @@ osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, con
 
 	if (mp == NULL && data == NULL)
 	{
-		mp = sys_alloc(ABOVE(osMemoryPoolCbSize) + size);
+		mp = pool_alloc(MEMPOOL_POOL, ABOVE(osMemoryPoolCbSize) + size);
 		data = (void *)((size_t)mp + ABOVE(osMemoryPoolCbSize));
 		if (mp == NULL)
 			return NULL;
@@ -1053,14 +1117,14 @@ osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, con
 	else
 	if (mp == NULL)
 	{
-		mp = sys_alloc(osMemoryPoolCbSize);
+		mp = pool_alloc(MEMPOOL_POOL, osMemoryPoolCbSize);
 		if (mp == NULL)
 			return NULL;
 	}
 	else
 	if (data == NULL)
 	{
-		data = sys_alloc(size);
+		data = pool_alloc(MEMPOOL_POOL, size);
 		if (data == NULL)
 			return NULL;
 	}
@@ -1068,7 +1132,7 @@ osMemoryPoolId_t osMemoryPoolNew (uint32_t block_count, uint32_t block_size, con
 	sys_lock();
 	{
 		mem_init(&mp->mem, block_count, block_size, data);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) mp->mem.res = mp;
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) mp->mem.res = mp;
 		else
 		if (attr->mp_mem == NULL || attr->mp_size == 0U) mp->mem.res = data;
 		mp->flags = flags;
@@ -1091,31 +1155,12 @@ const char *osMemoryPoolGetName (osMemoryPoolId_t mp_id)
 
 void *osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout)
 {
-	osMemoryPool_t *mp = mp_id;
-	void           *block;
-
-	if (mp_id == NULL)
-		return NULL;
-	if ((IS_IRQ_MODE() || IS_IRQ_MASKED()) && (timeout != 0U))
-		return NULL;
-
-	switch (mem_waitFor(&mp->mem, &block, timeout))
-	{
-		case E_SUCCESS: return block;
-		default:        return NULL;
-	}
+	return __osMemoryPoolAlloc(mp_id, timeout);
 }
 
 osStatus_t osMemoryPoolFree (osMemoryPoolId_t mp_id, void *block)
 {
-	osMemoryPool_t *mp = mp_id;
-
-	if (mp_id == NULL)
-		return osErrorParameter;
-
-	mem_give(&mp->mem, block);
-
-	return osOK;
+	return __osMemoryPoolFree(mp_id, block);
 }
 
 uint32_t osMemoryPoolGetCapacity (osMemoryPoolId_t mp_id)
@@ -1219,7 +1264,7 @@ osMessageQueueId_t osMessageQueueNew (uint32_t msg_count, uint32_t msg_size, con
 
 	if (mq == NULL && data == NULL)
 	{
-		mq = sys_alloc(ABOVE(osMessageQueueCbSize) + size);
+		mq = pool_alloc(MSGQUEUE_POOL, ABOVE(osMessageQueueCbSize) + size);
 		data = (void *)((size_t)mq + ABOVE(osMessageQueueCbSize));
 		if (mq == NULL)
 			return NULL;
@@ -1227,24 +1272,24 @@ osMessageQueueId_t osMessageQueueNew (uint32_t msg_count, uint32_t msg_size, con
 	else
 	if (mq == NULL)
 	{
-		mq = sys_alloc(osMessageQueueCbSize);
+		mq = pool_alloc(MSGQUEUE_POOL, osMessageQueueCbSize);
 		if (mq == NULL)
 			return NULL;
 	}
 	else
 	if (data == NULL)
 	{
-		data = sys_alloc(size);
+		data = pool_alloc(MSGQUEUE_POOL, size);
 		if (data == NULL)
 			return NULL;
 	}
 
 	sys_lock();
 	{
-		box_init(&mq->box, msg_count, data, msg_size);
-		if (attr->cb_mem == NULL || attr->cb_size == 0U) mq->box.res = mq;
+		pbx_init(&mq->pbx, msg_count, data, msg_size);
+		if (attr == NULL || attr->cb_mem == NULL || attr->cb_size == 0U) mq->pbx.res = mq;
 		else
-		if (attr->mq_mem == NULL || attr->mq_size == 0U) mq->box.res = data;
+		if (attr->mq_mem == NULL || attr->mq_size == 0U) mq->pbx.res = data;
 		mq->flags = flags;
 		mq->name = (attr == NULL) ? NULL : attr->name;
 	}
@@ -1265,42 +1310,12 @@ const char *osMessageQueueGetName (osMessageQueueId_t mq_id)
 
 osStatus_t osMessageQueuePut (osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout)
 {
-	osMessageQueue_t *mq = mq_id;
-
-	(void)msg_prio; /* message priority is ignored */
-
-	if ((mq_id == NULL) || (msg_ptr == NULL))
-		return osErrorParameter;
-
-	if ((IS_IRQ_MODE() || IS_IRQ_MASKED()) && (timeout != 0U))
-		return osErrorParameter;
-
-	switch (box_sendFor(&mq->box, msg_ptr, timeout))
-	{
-		case E_SUCCESS: return osOK;
-		case E_TIMEOUT: return osErrorTimeout;
-		default:        return osErrorResource;
-	}
+	return __osMessageQueuePut(mq_id, msg_ptr, msg_prio, timeout);
 }
 
 osStatus_t osMessageQueueGet (osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout)
 {
-	osMessageQueue_t *mq = mq_id;
-
-	(void)msg_prio; /* message priority is ignored */
-
-	if ((mq_id == NULL) || (msg_ptr == NULL))
-		return osErrorParameter;
-
-	if ((IS_IRQ_MODE() || IS_IRQ_MASKED()) && (timeout != 0U))
-		return osErrorParameter;
-
-	switch (box_waitFor(&mq->box, msg_ptr, timeout))
-	{
-		case E_SUCCESS: return osOK;
-		case E_TIMEOUT: return osErrorTimeout;
-		default:        return osErrorResource;
-	}
+	return __osMessageQueueGet(mq_id, msg_ptr, msg_prio, timeout);
 }
 
 uint32_t osMessageQueueGetCapacity (osMessageQueueId_t mq_id)
@@ -1310,7 +1325,7 @@ uint32_t osMessageQueueGetCapacity (osMessageQueueId_t mq_id)
 	if (mq_id == NULL)
 		return 0U;
 
-	return mq->box.limit;
+	return mq->pbx.limit;
 }
 
 uint32_t osMessageQueueGetMsgSize (osMessageQueueId_t mq_id)
@@ -1320,7 +1335,7 @@ uint32_t osMessageQueueGetMsgSize (osMessageQueueId_t mq_id)
 	if (mq_id == NULL)
 		return 0U;
 
-	return mq->box.size;
+	return mq->pbx.size;
 }
 
 uint32_t osMessageQueueGetCount (osMessageQueueId_t mq_id)
@@ -1330,7 +1345,7 @@ uint32_t osMessageQueueGetCount (osMessageQueueId_t mq_id)
 	if (mq_id == NULL)
 		return 0U;
 
-	return mq->box.count;
+	return mq->pbx.count;
 }
 
 uint32_t osMessageQueueGetSpace (osMessageQueueId_t mq_id)
@@ -1343,7 +1358,7 @@ uint32_t osMessageQueueGetSpace (osMessageQueueId_t mq_id)
 
 	sys_lock();
 	{
-		count = mq->box.limit - mq->box.count;
+		count = mq->pbx.limit - mq->pbx.count;
 	}
 	sys_unlock();
 
@@ -1359,7 +1374,7 @@ osStatus_t osMessageQueueReset (osMessageQueueId_t mq_id)
 	if (mq_id == NULL)
 		return osErrorParameter;
 
-	box_kill(&mq->box);
+	pbx_kill(&mq->pbx);
 
 	return osOK;
 }
@@ -1373,7 +1388,7 @@ osStatus_t osMessageQueueDelete (osMessageQueueId_t mq_id)
 	if (mq_id == NULL)
 		return osErrorParameter;
 
-	box_delete(&mq->box);
+	pbx_delete(&mq->pbx);
 
 	return osOK;
 }
@@ -78,6 +78,16 @@ typedef struct {
   uint32_t                    kernel;   ///< Kernel version (major.minor.rev: mmnnnrrrr dec).
 } osVersion_t;
  
+/// Heap statistics (StateOS extension).
+typedef struct {
+  uint32_t                 heap_size;   ///< size of the heap in bytes.
+  uint32_t                 free_size;   ///< number of free bytes.
+  uint32_t                 max_block;   ///< size of the largest block that can be allocated.
+  uint32_t                 peak_used;   ///< maximum number of used bytes.
+  uint32_t               free_blocks;   ///< number of free blocks (fragments).
+  uint32_t               alloc_count;   ///< number of allocated blocks.
+} osHeapInfo_t;
+ 
 /// Kernel state.
 typedef enum {
   osKernelInactive        =  0,         ///< Inactive.
@@ -360,6 +370,11 @@ uint32_t osKernelGetSysTimerCount (void);
 /// \return frequency of the system timer in hertz, i.e. timer ticks per second.
 uint32_t osKernelGetSysTimerFreq (void);
  
+/// Get the RTOS kernel heap statistics (StateOS extension).
+/// \param[out]    heap_info     pointer to buffer for retrieving heap statistics.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osKernelGetHeapInfo (osHeapInfo_t *heap_info);
+ 
  
 //  ==== Thread Management Functions ====
  
@@ -625,6 +640,19 @@ osStatus_t osSemaphoreAcquire (osSemaphoreId_t semaphore_id, uint32_t timeout);
 /// \return status code that indicates the execution status of the function.
 osStatus_t osSemaphoreRelease (osSemaphoreId_t semaphore_id);
  
+/// Acquire a number of Semaphore tokens at once or timeout if not enough tokens are available (StateOS extension).
+/// \param[in]     semaphore_id  semaphore ID obtained by \ref osSemaphoreNew.
+/// \param[in]     count         number of tokens to acquire.
+/// \param[in]     timeout       \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osSemaphoreAcquireN (osSemaphoreId_t semaphore_id, uint32_t count, uint32_t timeout);
+ 
+/// Release a number of Semaphore tokens at once up to the initial maximum count (StateOS extension).
+/// \param[in]     semaphore_id  semaphore ID obtained by \ref osSemaphoreNew.
+/// \param[in]     count         number of tokens to release.
+/// \return status code that indicates the execution status of the function.
+osStatus_t osSemaphoreReleaseN (osSemaphoreId_t semaphore_id, uint32_t count);
+ 
 /// Get current Semaphore token count.
 /// \param[in]     semaphore_id  semaphore ID obtained by \ref osSemaphoreNew.
 /// \return number of tokens available.
@@ -753,4 +781,10 @@ osStatus_t osMessageQueueDelete (osMessageQueueId_t mq_id);
 }
 #endif
  
+// StateOS: with OS_CMSIS_INLINE the hot calls are expanded inline (see oscmsis.h)
+#include "osconfig.h"
+#if defined(OS_CMSIS_INLINE) && (OS_CMSIS_INLINE)
+#include "oscmsis.h"
+#endif
+ 
 #endif  // CMSIS_OS2_H_
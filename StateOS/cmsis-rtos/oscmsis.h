@@ -48,6 +48,42 @@ extern "C" {
 
 /*---------------------------------------------------------------------------*/
 
+/// Static object pools (0 => objects are allocated from the system heap)
+#ifndef OS_THREAD_NUM
+#define OS_THREAD_NUM        0  ///< number of threads with a default size stack
+#endif
+#ifndef OS_TIMER_NUM
+#define OS_TIMER_NUM         0  ///< number of timers
+#endif
+#ifndef OS_EVFLAGS_NUM
+#define OS_EVFLAGS_NUM       0  ///< number of event flags objects
+#endif
+#ifndef OS_MUTEX_NUM
+#define OS_MUTEX_NUM         0  ///< number of mutexes
+#endif
+#ifndef OS_SEMAPHORE_NUM
+#define OS_SEMAPHORE_NUM     0  ///< number of semaphores
+#endif
+#ifndef OS_MEMPOOL_NUM
+#define OS_MEMPOOL_NUM       0  ///< number of memory pools
+#endif
+#ifndef OS_MEMPOOL_MEM
+#define OS_MEMPOOL_MEM       0  ///< size of data storage of each memory pool in bytes
+#endif
+#ifndef OS_MSGQUEUE_NUM
+#define OS_MSGQUEUE_NUM      0  ///< number of message queues
+#endif
+#ifndef OS_MSGQUEUE_MEM
+#define OS_MSGQUEUE_MEM      0  ///< size of data storage of each message queue in bytes
+#endif
+
+/// Inline fast paths (0 => the hot calls are out-of-line functions of cmsis_os2.c)
+#ifndef OS_CMSIS_INLINE
+#define OS_CMSIS_INLINE      0  ///< hot calls are expanded inline in the caller
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 #define IS_IRQ_MODE()    port_isr_inside()
 #define IS_IRQ_MASKED()  port_isr_masked()
 
@@ -75,8 +111,6 @@ struct __Timer
 	tmr_t         tmr;   // StateOS timer object
 	uint32_t      flags; // attribute bits
 	const char  * name;  // timer name
-	osTimerFunc_t func;  // timer function
-	void        * arg;   // timer function argument
 };
 
 typedef struct __Timer osTimer_t;
@@ -140,15 +174,221 @@ typedef struct __MemoryPool osMemoryPool_t;
 
 struct __MessageQueue
 {
-	box_t        box;   // StateOS mail box object
+	pbx_t        pbx;   // StateOS priority mailbox queue object
 	uint32_t     flags; // attribute bits
-	const char * name;  // mail box name
+	const char * name;  // mailbox queue name
 };
 
 typedef struct __MessageQueue osMessageQueue_t;
 
 #define osMessageQueueCbSize sizeof(osMessageQueue_t)
-#define osMessageQueueMemSize(count, size) (((((size)+3)/4)*4)*count)
+#define osMessageQueueMemSize(count, size) (((PSIZE(count, size)+3)/4)*4)
+
+/*---------------------------------------------------------------------------*/
+
+// CMSIS-RTOS1 mail queue (StateOS mail queue object)
+#define osMailQueueCbSize sizeof(mlq_t)
+#define osMailQueueMemSize(count, size) MLQ_SIZE(count, size)
+
+/*---------------------------------------------------------------------------*/
+
+// Fast paths of the hot calls: the native kernel call and a table-based event translation
+// cmsis_os2.c implements the out-of-line functions with them,
+// with OS_CMSIS_INLINE the hot calls are expanded inline in the caller
+
+// E_TIMEOUT => 0, E_STOPPED => 1, E_SUCCESS => 2
+#define osEventIndex(event) (((event) + 2U) & 3U)
+
+__STATIC_INLINE
+osStatus_t osEventStatus (unsigned event)
+{
+	static const osStatus_t status[4] = { osErrorTimeout, osErrorResource, osOK, osError };
+
+	return status[osEventIndex(event)];
+}
+
+__STATIC_INLINE
+uint32_t osEventFlags (unsigned event, uint32_t flags)
+{
+	static const uint32_t status[4] = { osFlagsErrorTimeout, osFlagsErrorResource, 0U, osFlagsErrorUnknown };
+
+	return event == E_SUCCESS ? flags : status[osEventIndex(event)];
+}
+
+#define IS_IRQ_WAIT(timeout) (((timeout) != 0U) && (IS_IRQ_MODE() || IS_IRQ_MASKED()))
+
+__STATIC_INLINE
+uint32_t __osThreadFlagsSet (osThreadId_t thread_id, uint32_t flags)
+{
+	osThread_t *thread = (osThread_t *) thread_id;
+
+	if ((thread_id == NULL) || ((flags & osFlagsError) != 0U))
+		return osFlagsErrorParameter;
+
+	return flg_give(&thread->flg, flags);
+}
+
+__STATIC_INLINE
+uint32_t __osThreadFlagsWait (uint32_t flags, uint32_t options, uint32_t timeout)
+{
+	void *tmp = tsk_this(); // because of COSMIC compiler
+	osThread_t *thread = (osThread_t *) tmp;
+
+	if (IS_IRQ_MODE() || IS_IRQ_MASKED())
+		return osFlagsErrorISR;
+	if ((flags & osFlagsError) != 0U)
+		return osFlagsErrorParameter;
+
+	return osEventFlags(flg_waitFor(&thread->flg, flags, options, timeout), flags);
+}
+
+__STATIC_INLINE
+uint32_t __osEventFlagsSet (osEventFlagsId_t ef_id, uint32_t flags)
+{
+	osEventFlags_t *ef = (osEventFlags_t *) ef_id;
+
+	if ((ef_id == NULL) || ((flags & osFlagsError) != 0U))
+		return osFlagsErrorParameter;
+
+	return flg_give(&ef->flg, flags);
+}
+
+__STATIC_INLINE
+uint32_t __osEventFlagsWait (osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout)
+{
+	osEventFlags_t *ef = (osEventFlags_t *) ef_id;
+
+	if ((ef_id == NULL) || ((flags & osFlagsError) != 0U))
+		return osFlagsErrorParameter;
+	if (IS_IRQ_WAIT(timeout))
+		return osFlagsErrorParameter;
+
+	return osEventFlags(flg_waitFor(&ef->flg, flags, options, timeout), flags);
+}
+
+__STATIC_INLINE
+osStatus_t __osMutexAcquire (osMutexId_t mutex_id, uint32_t timeout)
+{
+	osMutex_t *mutex = (osMutex_t *) mutex_id;
+
+	if (IS_IRQ_MODE() || IS_IRQ_MASKED())
+		return osErrorISR;
+	if (mutex_id == NULL)
+		return osErrorParameter;
+
+	return osEventStatus(mtx_waitFor(&mutex->mtx, timeout));
+}
+
+__STATIC_INLINE
+osStatus_t __osMutexRelease (osMutexId_t mutex_id)
+{
+	osMutex_t *mutex = (osMutex_t *) mutex_id;
+
+	if (IS_IRQ_MODE() || IS_IRQ_MASKED())
+		return osErrorISR;
+	if (mutex_id == NULL)
+		return osErrorParameter;
+
+	return mtx_give(&mutex->mtx) == E_SUCCESS ? osOK : osErrorResource;
+}
+
+__STATIC_INLINE
+osStatus_t __osSemaphoreAcquire (osSemaphoreId_t semaphore_id, uint32_t timeout)
+{
+	osSemaphore_t *semaphore = (osSemaphore_t *) semaphore_id;
+
+	if (semaphore_id == NULL)
+		return osErrorParameter;
+	if (IS_IRQ_WAIT(timeout))
+		return osErrorParameter;
+
+	return osEventStatus(sem_waitFor(&semaphore->sem, timeout));
+}
+
+__STATIC_INLINE
+osStatus_t __osSemaphoreRelease (osSemaphoreId_t semaphore_id)
+{
+	osSemaphore_t *semaphore = (osSemaphore_t *) semaphore_id;
+
+	if (semaphore_id == NULL)
+		return osErrorParameter;
+
+	return sem_give(&semaphore->sem) == E_SUCCESS ? osOK : osErrorResource;
+}
+
+__STATIC_INLINE
+void *__osMemoryPoolAlloc (osMemoryPoolId_t mp_id, uint32_t timeout)
+{
+	osMemoryPool_t *mp = (osMemoryPool_t *) mp_id;
+	void           *block;
+
+	if (mp_id == NULL)
+		return NULL;
+	if (IS_IRQ_WAIT(timeout))
+		return NULL;
+
+	return mem_waitFor(&mp->mem, &block, timeout) == E_SUCCESS ? block : NULL;
+}
+
+__STATIC_INLINE
+osStatus_t __osMemoryPoolFree (osMemoryPoolId_t mp_id, void *block)
+{
+	osMemoryPool_t *mp = (osMemoryPool_t *) mp_id;
+
+	if (mp_id == NULL)
+		return osErrorParameter;
+
+	mem_give(&mp->mem, block);
+
+	return osOK;
+}
+
+__STATIC_INLINE
+osStatus_t __osMessageQueuePut (osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout)
+{
+	osMessageQueue_t *mq = (osMessageQueue_t *) mq_id;
+
+	if ((mq_id == NULL) || (msg_ptr == NULL))
+		return osErrorParameter;
+	if (IS_IRQ_WAIT(timeout))
+		return osErrorParameter;
+
+	return osEventStatus(pbx_sendFor(&mq->pbx, msg_ptr, msg_prio, timeout));
+}
+
+__STATIC_INLINE
+osStatus_t __osMessageQueueGet (osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout)
+{
+	osMessageQueue_t *mq = (osMessageQueue_t *) mq_id;
+	unsigned          prio;
+	unsigned          event;
+
+	if ((mq_id == NULL) || (msg_ptr == NULL))
+		return osErrorParameter;
+	if (IS_IRQ_WAIT(timeout))
+		return osErrorParameter;
+
+	event = pbx_waitFor(&mq->pbx, msg_ptr, &prio, timeout);
+	if ((event == E_SUCCESS) && (msg_prio != NULL))
+		*msg_prio = (uint8_t) prio;
+
+	return osEventStatus(event);
+}
+
+#if OS_CMSIS_INLINE && !defined(__CMSIS_OS2_C)
+#define osThreadFlagsSet     __osThreadFlagsSet
+#define osThreadFlagsWait    __osThreadFlagsWait
+#define osEventFlagsSet      __osEventFlagsSet
+#define osEventFlagsWait     __osEventFlagsWait
+#define osMutexAcquire       __osMutexAcquire
+#define osMutexRelease       __osMutexRelease
+#define osSemaphoreAcquire   __osSemaphoreAcquire
+#define osSemaphoreRelease   __osSemaphoreRelease
+#define osMemoryPoolAlloc    __osMemoryPoolAlloc
+#define osMemoryPoolFree     __osMemoryPoolFree
+#define osMessageQueuePut    __osMessageQueuePut
+#define osMessageQueueGet    __osMessageQueueGet
+#endif
 
 /* -------------------------------------------------------------------------- */
 
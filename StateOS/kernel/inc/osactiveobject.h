@@ -0,0 +1,455 @@
+/******************************************************************************
+
+    @file    StateOS: osactiveobject.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_AOB_H
+#define __STATEOS_AOB_H
+
+#include "oskernel.h"
+#include "osworkerpool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#define aobHandled   (  0U ) // event was handled by the state
+#define aobIgnored   (  1U ) // event was ignored (returned by the top state)
+#define aobSuper     (  2U ) // event is passed to the super state (returned by aob_super)
+#define aobTran      (  3U ) // transition to the target state (returned by aob_tran)
+
+#define aobEntry     ( ~0U ) // reserved event: entry action of the state
+#define aobExit      ( ~1U ) // reserved event: exit action of the state
+#define aobInit      ( ~2U ) // reserved event: initial transition of the state (return aob_tran to a substate)
+#define aobEmpty     ( ~3U ) // reserved event: query the super state (must not be handled)
+#define aobStart     ( ~4U ) // reserved event: initial transition of the active object (internal)
+
+#define AOB_DEPTH    (  8U ) // maximum nesting depth of states (including the top state)
+
+/******************************************************************************
+ *
+ * Name              : active object
+ *
+ * Note              : active object owns an event queue and a hierarchical state machine,
+ *                     events are dispatched by the worker tasks of a worker pool object
+ *                     in run-to-completion steps, one event per job,
+ *                     each active object is processed by at most one worker task at a time,
+ *                     every active object has at most one job in the queue of the worker pool,
+ *                     so the queue of the worker pool must be (at least) as long as the number of active objects
+ *
+ ******************************************************************************/
+
+typedef struct __aob aob_t, * const aob_id;
+
+typedef unsigned aos_t( aob_t *aob, unsigned event ); // state handler
+
+struct __aob
+{
+	aob_t  * next;  // next active object in the registry of started objects
+	wpl_t  * wpl;   // worker pool object dispatching events
+	aos_t  * state; // current state
+	aos_t  * temp;  // target or super state returned by the state handler
+	uint32_t subs;  // subscribed events (event values below 32)
+	volatile
+	bool     busy;  // active object has a job in the worker pool object
+
+	unsigned count; // number of queued events
+	unsigned limit; // size of the event queue (max number of queued events)
+	unsigned head;  // first element to read from data buffer
+	unsigned tail;  // first element to write into data buffer
+	unsigned*data;  // data buffer
+	unsigned lost;  // number of events lost because the event queue was full
+};
+
+/******************************************************************************
+ *
+ * Name              : _AOB_INIT
+ *
+ * Description       : create and initialize an active object
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object dispatching events
+ *   state           : initial state
+ *   limit           : size of the event queue (max number of queued events)
+ *   data            : event queue data buffer
+ *
+ * Return            : active object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _AOB_INIT( _wpl, _state, _limit, _data ) { 0, _wpl, _state, 0, 0, false, 0, _limit, 0, 0, _data, 0 }
+
+/******************************************************************************
+ *
+ * Name              : _AOB_DATA
+ *
+ * Description       : create an event queue data buffer of an active object
+ *
+ * Parameters
+ *   limit           : size of the event queue (max number of queued events)
+ *
+ * Return            : event queue data buffer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _AOB_DATA( _limit ) (unsigned[_limit]){ 0 }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : OS_AOB
+ *
+ * Description       : define and initialize an active object
+ *
+ * Parameters
+ *   aob             : name of a pointer to active object
+ *   wpl             : pointer to worker pool object dispatching events
+ *   state           : initial state
+ *   limit           : size of the event queue (max number of queued events)
+ *
+ ******************************************************************************/
+
+#define             OS_AOB( aob, wpl, state, limit )                                \
+                       unsigned aob##__buf[limit];                                   \
+                       aob_t aob##__aob = _AOB_INIT( wpl, state, limit, aob##__buf ); \
+                       aob_id aob = & aob##__aob
+
+/******************************************************************************
+ *
+ * Name              : static_AOB
+ *
+ * Description       : define and initialize a static active object
+ *
+ * Parameters
+ *   aob             : name of a pointer to active object
+ *   wpl             : pointer to worker pool object dispatching events
+ *   state           : initial state
+ *   limit           : size of the event queue (max number of queued events)
+ *
+ ******************************************************************************/
+
+#define         static_AOB( aob, wpl, state, limit )                                \
+                static unsigned aob##__buf[limit];                                   \
+                static aob_t aob##__aob = _AOB_INIT( wpl, state, limit, aob##__buf ); \
+                static aob_id aob = & aob##__aob
+
+/******************************************************************************
+ *
+ * Name              : AOB_INIT
+ *
+ * Description       : create and initialize an active object
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object dispatching events
+ *   state           : initial state
+ *   limit           : size of the event queue (max number of queued events)
+ *
+ * Return            : active object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                AOB_INIT( wpl, state, limit ) \
+                      _AOB_INIT( wpl, state, limit, _AOB_DATA( limit ) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : AOB_CREATE
+ * Alias             : AOB_NEW
+ *
+ * Description       : create and initialize an active object
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object dispatching events
+ *   state           : initial state
+ *   limit           : size of the event queue (max number of queued events)
+ *
+ * Return            : pointer to active object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                AOB_CREATE( wpl, state, limit ) \
+           (aob_t[]) { AOB_INIT  ( wpl, state, limit ) }
+#define                AOB_NEW \
+                       AOB_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : aob_init
+ *
+ * Description       : initialize an active object
+ *
+ * Parameters
+ *   aob             : pointer to active object
+ *   wpl             : pointer to worker pool object dispatching events
+ *   state           : initial state
+ *   limit           : size of the event queue (max number of queued events)
+ *   data            : event queue data buffer
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void aob_init( aob_t *aob, wpl_t *wpl, aos_t *state, unsigned limit, unsigned *data );
+
+/******************************************************************************
+ *
+ * Name              : aob_start
+ *
+ * Description       : register the active object and queue its initial transition:
+ *                     entry actions from the top state down to the initial state
+ *                     and the initial transitions (aobInit) of the entered states
+ *
+ * Parameters
+ *   aob             : pointer to active object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     start an active object only once
+ *
+ ******************************************************************************/
+
+void aob_start( aob_t *aob );
+
+/******************************************************************************
+ *
+ * Name              : aob_post
+ * ISR alias         : aob_postISR
+ *
+ * Description       : queue the event to the active object
+ *
+ * Parameters
+ *   aob             : pointer to active object
+ *   event           : event value (below reserved values)
+ *
+ * Return
+ *   E_SUCCESS       : event was successfully queued
+ *   E_TIMEOUT       : event queue of the active object is full, event was lost (and counted)
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned aob_post( aob_t *aob, unsigned event );
+
+__STATIC_INLINE
+unsigned aob_postISR( aob_t *aob, unsigned event ) { return aob_post(aob, event); }
+
+/******************************************************************************
+ *
+ * Name              : aob_subscribe
+ *
+ * Description       : subscribe the active object to the published event
+ *
+ * Parameters
+ *   aob             : pointer to active object
+ *   event           : event value (below 32)
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void aob_subscribe( aob_t *aob, unsigned event );
+
+/******************************************************************************
+ *
+ * Name              : aob_unsubscribe
+ *
+ * Description       : unsubscribe the active object from the published event
+ *
+ * Parameters
+ *   aob             : pointer to active object
+ *   event           : event value (below 32)
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void aob_unsubscribe( aob_t *aob, unsigned event );
+
+/******************************************************************************
+ *
+ * Name              : aob_publish
+ * ISR alias         : aob_publishISR
+ *
+ * Description       : queue the event to all started active objects subscribed to it
+ *
+ * Parameters
+ *   event           : event value (below 32)
+ *
+ * Return            : number of active objects that received the event
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     no memory is allocated, the event value is queued in every subscriber
+ *
+ ******************************************************************************/
+
+unsigned aob_publish( unsigned event );
+
+__STATIC_INLINE
+unsigned aob_publishISR( unsigned event ) { return aob_publish(event); }
+
+/******************************************************************************
+ *
+ * Name              : aob_top
+ *
+ * Description       : top state of every state machine, ignores all events
+ *
+ * Parameters
+ *   aob             : pointer to active object
+ *   event           : event value
+ *
+ * Return            : aobIgnored
+ *
+ ******************************************************************************/
+
+unsigned aob_top( aob_t *aob, unsigned event );
+
+/******************************************************************************
+ *
+ * Name              : aob_super
+ *
+ * Description       : pass the event to the super state,
+ *                     must be returned by the state handler for every unhandled event (including aobEmpty)
+ *
+ * Parameters
+ *   aob             : pointer to active object
+ *   state           : super state (aob_top for the outermost states)
+ *
+ * Return            : aobSuper
+ *
+ * Example           : default: return aob_super(aob, aob_top);
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned aob_super( aob_t *aob, aos_t *state ) { aob->temp = state; return aobSuper; }
+
+/******************************************************************************
+ *
+ * Name              : aob_tran
+ *
+ * Description       : take the transition to the target state,
+ *                     returned by the state handler for a handled event or for the aobInit event
+ *                     exit actions from the current state up to the common ancestor with the target state
+ *                     and entry actions from the common ancestor down to the target state are executed
+ *
+ * Parameters
+ *   aob             : pointer to active object
+ *   state           : target state
+ *
+ * Return            : aobTran
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned aob_tran( aob_t *aob, aos_t *state ) { aob->temp = state; return aobTran; }
+
+/******************************************************************************
+ *
+ * Name              : aob_isIn
+ *
+ * Description       : check if the current state of the active object is the given state or its substate
+ *
+ * Parameters
+ *   aob             : pointer to active object
+ *   state           : state
+ *
+ * Return
+ *   true            : active object is in the state
+ *   false           : active object is not in the state
+ *
+ * Note              : use only in the state handlers of the active object
+ *
+ ******************************************************************************/
+
+bool aob_isIn( aob_t *aob, aos_t *state );
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : ActiveObjectT<>
+ *
+ * Description       : create and initialize an active object
+ *
+ * Constructor parameters
+ *   limit           : size of the event queue (max number of queued events)
+ *   wpl             : pointer to worker pool object dispatching events
+ *   state           : initial state
+ *
+ ******************************************************************************/
+
+template<unsigned limit_>
+struct ActiveObjectT : public __aob
+{
+	ActiveObjectT( wpl_t *_wpl, aos_t *_state ): __aob _AOB_INIT(_wpl, _state, limit_, data_) {}
+
+	void     start      ( void )            {        aob_start      (this);         }
+	unsigned post       ( unsigned _event ) { return aob_post       (this, _event); }
+	unsigned postISR    ( unsigned _event ) { return aob_postISR    (this, _event); }
+	void     subscribe  ( unsigned _event ) {        aob_subscribe  (this, _event); }
+	void     unsubscribe( unsigned _event ) {        aob_unsubscribe(this, _event); }
+
+	private:
+	unsigned data_[limit_];
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_AOB_H
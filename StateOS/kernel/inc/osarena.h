@@ -0,0 +1,503 @@
+/******************************************************************************
+
+    @file    StateOS: osarena.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+
+#ifndef __STATEOS_ARN_H
+#define __STATEOS_ARN_H
+
+#include "oskernel.h"
+#include "ostask.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#define ASIZE( size ) \
+ ALIGNED_SIZE( size, stk_t )
+
+/******************************************************************************
+ *
+ * Name              : arena
+ *
+ * Note              : memory blocks are taken from the arena buffer by advancing the bump pointer;
+ *                     blocks are never released individually, the arena is released as a whole
+ *                     ('arn_reset') or back to a mark previously taken with 'arn_mark' ('arn_rewind')
+ *
+ ******************************************************************************/
+
+typedef struct __arn arn_t, * const arn_id;
+
+struct __arn
+{
+	void   * res;   // allocated arena object's resource
+	size_t   limit; // size of the arena buffer (in bytes)
+	void   * data;  // pointer to the arena buffer
+	size_t   used;  // number of bytes taken from the arena buffer (bump pointer)
+	size_t   peak;  // high-water mark of bytes taken from the arena buffer
+};
+
+/******************************************************************************
+ *
+ * Name              : _ARN_INIT
+ *
+ * Description       : create and initialize an arena object
+ *
+ * Parameters
+ *   size            : size of the arena buffer (in bytes)
+ *   data            : arena data buffer
+ *
+ * Return            : arena object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _ARN_INIT( _size, _data ) { 0, ASIZE(_size) * sizeof(stk_t), _data, 0, 0 }
+
+/******************************************************************************
+ *
+ * Name              : _ARN_DATA
+ *
+ * Description       : create an arena data buffer
+ *
+ * Parameters
+ *   size            : size of the arena buffer (in bytes)
+ *
+ * Return            : arena data buffer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _ARN_DATA( _size ) (stk_t[ASIZE(_size)]){ { 0 } }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : OS_ARN
+ *
+ * Description       : define and initialize an arena object
+ *
+ * Parameters
+ *   arn             : name of a pointer to arena object
+ *   size            : size of the arena buffer (in bytes)
+ *
+ ******************************************************************************/
+
+#define             OS_ARN( arn, size )                                \
+           __OS_NOINIT stk_t arn##__buf[ASIZE(size)];                   \
+                       arn_t arn##__arn = _ARN_INIT( size, arn##__buf ); \
+                       arn_id arn = & arn##__arn
+
+/******************************************************************************
+ *
+ * Name              : static_ARN
+ *
+ * Description       : define and initialize a static arena object
+ *
+ * Parameters
+ *   arn             : name of a pointer to arena object
+ *   size            : size of the arena buffer (in bytes)
+ *
+ ******************************************************************************/
+
+#define         static_ARN( arn, size )                                \
+    static __OS_NOINIT stk_t arn##__buf[ASIZE(size)];                   \
+                static arn_t arn##__arn = _ARN_INIT( size, arn##__buf ); \
+                static arn_id arn = & arn##__arn
+
+/******************************************************************************
+ *
+ * Name              : ARN_INIT
+ *
+ * Description       : create and initialize an arena object
+ *
+ * Parameters
+ *   size            : size of the arena buffer (in bytes)
+ *
+ * Return            : arena object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                ARN_INIT( size ) \
+                      _ARN_INIT( size, _ARN_DATA( size ) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : ARN_CREATE
+ * Alias             : ARN_NEW
+ *
+ * Description       : create and initialize an arena object
+ *
+ * Parameters
+ *   size            : size of the arena buffer (in bytes)
+ *
+ * Return            : pointer to arena object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                ARN_CREATE( size ) \
+           (arn_t[]) { ARN_INIT  ( size ) }
+#define                ARN_NEW \
+                       ARN_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : arn_init
+ *
+ * Description       : initialize an arena object
+ *
+ * Parameters
+ *   arn             : pointer to arena object
+ *   size            : size of the arena buffer (in bytes)
+ *   data            : arena data buffer (aligned to stk_t)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void arn_init( arn_t *arn, size_t size, void *data );
+
+/******************************************************************************
+ *
+ * Name              : arn_create
+ * Alias             : arn_new
+ *
+ * Description       : create and initialize a new arena object,
+ *                     the arena buffer is carved from the system heap as one memory segment
+ *
+ * Parameters
+ *   size            : size of the arena buffer (in bytes)
+ *
+ * Return            : pointer to arena object (arena successfully created)
+ *   0               : arena not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+arn_t *arn_create( size_t size );
+
+__STATIC_INLINE
+arn_t *arn_new( size_t size ) { return arn_create(size); }
+
+/******************************************************************************
+ *
+ * Name              : arn_delete
+ *
+ * Description       : reset the arena object and free allocated resource
+ *
+ * Parameters
+ *   arn             : pointer to arena object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void arn_delete( arn_t *arn );
+
+/******************************************************************************
+ *
+ * Name              : arn_alloc
+ * ISR alias         : arn_allocISR
+ *
+ * Description       : take a memory block from the arena object
+ *
+ * Parameters
+ *   arn             : pointer to arena object
+ *   size            : required size of the memory block (in bytes)
+ *
+ * Return            : pointer to the beginning of the memory block (aligned to stk_t)
+ *   0               : memory block not allocated (not enough free space in the arena)
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     the memory block is not cleared
+ *
+ ******************************************************************************/
+
+void *arn_alloc( arn_t *arn, size_t size );
+
+__STATIC_INLINE
+void *arn_allocISR( arn_t *arn, size_t size ) { return arn_alloc(arn, size); }
+
+/******************************************************************************
+ *
+ * Name              : arn_mark
+ *
+ * Description       : return the current position of the bump pointer of the arena object
+ *
+ * Parameters
+ *   arn             : pointer to arena object
+ *
+ * Return            : mark to be passed to arn_rewind
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+size_t arn_mark( arn_t *arn );
+
+/******************************************************************************
+ *
+ * Name              : arn_rewind
+ *
+ * Description       : release all memory blocks taken from the arena object since the 'mark' was taken
+ *
+ * Parameters
+ *   arn             : pointer to arena object
+ *   mark            : value previously returned by arn_mark
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void arn_rewind( arn_t *arn, size_t mark );
+
+/******************************************************************************
+ *
+ * Name              : arn_reset
+ *
+ * Description       : release all memory blocks taken from the arena object
+ *
+ * Parameters
+ *   arn             : pointer to arena object
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void arn_reset( arn_t *arn ) { arn_rewind(arn, 0); }
+
+/******************************************************************************
+ *
+ * Name              : arn_used
+ *
+ * Description       : return the number of bytes taken from the arena object
+ *
+ * Parameters
+ *   arn             : pointer to arena object
+ *
+ * Return            : number of bytes taken from the arena object
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+size_t arn_used( arn_t *arn );
+
+/******************************************************************************
+ *
+ * Name              : arn_space
+ *
+ * Description       : return the number of bytes still available in the arena object
+ *
+ * Parameters
+ *   arn             : pointer to arena object
+ *
+ * Return            : number of bytes still available in the arena object
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+size_t arn_space( arn_t *arn );
+
+/******************************************************************************
+ *
+ * Name              : arn_peak
+ *
+ * Description       : return the high-water mark of bytes taken from the arena object
+ *
+ * Parameters
+ *   arn             : pointer to arena object
+ *
+ * Return            : the largest number of bytes ever taken from the arena object at once
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+size_t arn_peak( arn_t *arn );
+
+#if OS_TASK_ARENA
+
+/******************************************************************************
+ *
+ * Name              : arn_setDefault
+ *
+ * Description       : set the default arena of the current task
+ *
+ * Parameters
+ *   arn             : pointer to arena object, 0: the current task has no default arena
+ *
+ * Return            : previous default arena of the current task
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+arn_t *arn_setDefault( arn_t *arn )
+{
+	arn_t *prv;
+
+	assert(!port_isr_inside());
+
+	prv = System.cur->arn;
+	System.cur->arn = arn;
+	return prv;
+}
+
+/******************************************************************************
+ *
+ * Name              : arn_getDefault
+ *
+ * Description       : return the default arena of the current task
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to the default arena of the current task, 0: none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+arn_t *arn_getDefault( void ) { return System.cur->arn; }
+
+/******************************************************************************
+ *
+ * Name              : arn_allocDefault
+ *
+ * Description       : take a memory block from the default arena of the current task
+ *
+ * Parameters
+ *   size            : required size of the memory block (in bytes)
+ *
+ * Return            : pointer to the beginning of the memory block (aligned to stk_t)
+ *   0               : memory block not allocated (not enough free space in the arena)
+ *
+ * Note              : use only in thread mode
+ *                     the memory block is not cleared
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void *arn_allocDefault( size_t size ) { assert(System.cur->arn); return arn_alloc(System.cur->arn, size); }
+
+#endif//OS_TASK_ARENA
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : ArenaT<>
+ *
+ * Description       : create and initialize an arena object
+ *
+ * Constructor parameters
+ *   size            : size of the arena buffer (in bytes)
+ *
+ ******************************************************************************/
+
+template<size_t size_>
+struct ArenaT : public __arn
+{
+	ArenaT( void ): __arn _ARN_INIT(size_, data_) {}
+
+	void  * alloc   ( size_t _size ) { return arn_alloc   (this, _size); }
+	void  * allocISR( size_t _size ) { return arn_allocISR(this, _size); }
+	size_t  mark    ( void )         { return arn_mark    (this);        }
+	void    rewind  ( size_t _mark ) {        arn_rewind  (this, _mark); }
+	void    reset   ( void )         {        arn_reset   (this);        }
+	size_t  used    ( void )         { return arn_used    (this);        }
+	size_t  space   ( void )         { return arn_space   (this);        }
+	size_t  peak    ( void )         { return arn_peak    (this);        }
+
+	private:
+	stk_t data_[ASIZE(size_)];
+};
+
+/******************************************************************************
+ *
+ * Class             : ArenaScope
+ *
+ * Description       : take a mark of the arena object and rewind the arena to it at the end of the scope
+ *
+ * Constructor parameters
+ *   arn             : pointer to arena object
+ *
+ ******************************************************************************/
+
+struct ArenaScope
+{
+	 ArenaScope( arn_t *_arn ): arn_(_arn), mark_(arn_mark(_arn)) {}
+	~ArenaScope( void ) { arn_rewind(arn_, mark_); }
+
+	ArenaScope( const ArenaScope & ) = delete;
+	ArenaScope &operator=( const ArenaScope & ) = delete;
+
+	private:
+	arn_t *arn_;
+	size_t mark_;
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_ARN_H
@@ -0,0 +1,406 @@
+/******************************************************************************
+
+    @file    StateOS: osasyncio.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+
+#ifndef __STATEOS_AIO_H
+#define __STATEOS_AIO_H
+
+#include "oskernel.h"
+#include "ostimer.h"
+#include "oseventqueue.h"
+#include "ostask.h"
+
+/* -------------------------------------------------------------------------- */
+
+#define aioIdle      ( 0U ) // request is not started
+#define aioPending   ( 1U ) // request is started and not completed yet
+#define aioDone      ( 2U ) // request is completed
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : asynchronous i/o request
+ *
+ * Note              : a task starts the request (aio_start) and the hardware operation, the driver completes the request
+ *                     from its interrupt handler (aio_complete); completion resumes the tasks waiting for the request,
+ *                     posts the result to the event queue and launches the callback procedure in the timer service task,
+ *                     so one task can drive several peripherals at once (aio_waitAny)
+ *
+ ******************************************************************************/
+
+typedef struct __aio aio_t, * const aio_id;
+
+typedef void acp_t( aio_t *aio ); // completion callback procedure
+
+struct __aio
+{
+	tsk_t  * queue; // next process in the DELAYED queue
+	void   * res;   // allocated request object's resource
+	tsk_t  * any;   // task waiting for any of several requests (aio_waitAny), 0: none
+	unsigned state; // aioIdle, aioPending, aioDone
+	unsigned result;// result of the request (set by the driver)
+	evq_t  * evq;   // event queue receiving the result on completion, 0: none
+	acp_t  * fun;   // callback procedure launched in the timer service task on completion, 0: none
+	tmr_t    tmr;   // timer launching the callback procedure
+};
+
+/******************************************************************************
+ *
+ * Name              : _AIO_INIT
+ *
+ * Description       : create and initialize an asynchronous i/o request object
+ *
+ * Parameters
+ *   aio             : name of the request object
+ *   evq             : event queue receiving the result on completion, 0: none
+ *   fun             : callback procedure launched on completion, 0: none
+ *
+ * Return            : request object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _AIO_INIT( _aio, _evq, _fun ) { 0, 0, 0, aioIdle, 0, _evq, _fun, _TMR_INIT_ARG(core_aio_callback, &(_aio)) }
+
+/******************************************************************************
+ *
+ * Name              : OS_AIO
+ *
+ * Description       : define and initialize an asynchronous i/o request object
+ *
+ * Parameters
+ *   aio             : name of a pointer to request object
+ *   evq             : event queue receiving the result on completion, 0: none
+ *   fun             : callback procedure launched on completion, 0: none
+ *
+ * Note              : if the timer service task is used (OS_TIMER_TASK), it must be started in thread mode
+ *                     (with any timer or with aio_init) before the first callback procedure is launched
+ *
+ ******************************************************************************/
+
+#define             OS_AIO( aio, evq, fun )                              \
+                       aio_t aio##__aio = _AIO_INIT( aio##__aio, evq, fun ); \
+                       aio_id aio = & aio##__aio
+
+/******************************************************************************
+ *
+ * Name              : static_AIO
+ *
+ * Description       : define and initialize a static asynchronous i/o request object
+ *
+ * Parameters
+ *   aio             : name of a pointer to request object
+ *   evq             : event queue receiving the result on completion, 0: none
+ *   fun             : callback procedure launched on completion, 0: none
+ *
+ * Note              : look at OS_AIO
+ *
+ ******************************************************************************/
+
+#define         static_AIO( aio, evq, fun )                              \
+                static aio_t aio##__aio = _AIO_INIT( aio##__aio, evq, fun ); \
+                static aio_id aio = & aio##__aio
+
+/******************************************************************************
+ *
+ * Name              : aio_init
+ *
+ * Description       : initialize an asynchronous i/o request object
+ *
+ * Parameters
+ *   aio             : pointer to request object
+ *   evq             : event queue receiving the result on completion, 0: none
+ *   fun             : callback procedure launched on completion
+ *                     in the timer service task (OS_TIMER_TASK) or in the system timer handler, 0: none
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void aio_init( aio_t *aio, evq_t *evq, acp_t *fun );
+
+/******************************************************************************
+ *
+ * Name              : aio_kill
+ *
+ * Description       : reset the request object and wake up all waiting tasks with 'E_STOPPED' event value
+ *
+ * Parameters
+ *   aio             : pointer to request object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void aio_kill( aio_t *aio );
+
+/******************************************************************************
+ *
+ * Name              : aio_start
+ * ISR alias         : aio_startISR
+ *
+ * Description       : mark the request object as pending, before the hardware operation is started
+ *
+ * Parameters
+ *   aio             : pointer to request object
+ *
+ * Return
+ *   E_SUCCESS       : request was started
+ *   E_TIMEOUT       : request is already pending
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned aio_start( aio_t *aio );
+
+__STATIC_INLINE
+unsigned aio_startISR( aio_t *aio ) { return aio_start(aio); }
+
+/******************************************************************************
+ *
+ * Name              : aio_complete
+ * ISR alias         : aio_completeISR
+ *
+ * Description       : complete the pending request with given result,
+ *                     resume all tasks waiting for the request, post the result to the event queue
+ *                     and launch the callback procedure
+ *
+ * Parameters
+ *   aio             : pointer to request object
+ *   result          : result of the request
+ *
+ * Return
+ *   E_SUCCESS       : request was completed
+ *   E_TIMEOUT       : request is not pending
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned aio_complete( aio_t *aio, unsigned result );
+
+__STATIC_INLINE
+unsigned aio_completeISR( aio_t *aio, unsigned result ) { return aio_complete(aio, result); }
+
+/******************************************************************************
+ *
+ * Name              : aio_take
+ * ISR alias         : aio_takeISR
+ *
+ * Description       : check if the request is completed, don't wait
+ *
+ * Parameters
+ *   aio             : pointer to request object
+ *
+ * Return
+ *   E_SUCCESS       : request is completed
+ *   E_TIMEOUT       : request is not completed
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned aio_take( aio_t *aio );
+
+__STATIC_INLINE
+unsigned aio_takeISR( aio_t *aio ) { return aio_take(aio); }
+
+/******************************************************************************
+ *
+ * Name              : aio_waitFor
+ *
+ * Description       : wait for given duration of time for completion of the pending request
+ *
+ * Parameters
+ *   aio             : pointer to request object
+ *   delay           : duration of time (maximum number of ticks to wait for completion of the request)
+ *                     IMMEDIATE: don't wait if the request is not completed
+ *                     INFINITE:  wait indefinitely until the request has been completed
+ *
+ * Return
+ *   E_SUCCESS       : request was completed
+ *   E_STOPPED       : request object was killed before the specified timeout expired
+ *   E_TIMEOUT       : request was not completed before the specified timeout expired (or it is not started)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned aio_waitFor( aio_t *aio, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : aio_waitUntil
+ *
+ * Description       : wait until given timepoint for completion of the pending request
+ *
+ * Parameters
+ *   aio             : pointer to request object
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : request was completed
+ *   E_STOPPED       : request object was killed before the specified timeout expired
+ *   E_TIMEOUT       : request was not completed before the specified timeout expired (or it is not started)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned aio_waitUntil( aio_t *aio, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : aio_wait
+ *
+ * Description       : wait indefinitely for completion of the pending request
+ *
+ * Parameters
+ *   aio             : pointer to request object
+ *
+ * Return
+ *   E_SUCCESS       : request was completed
+ *   E_STOPPED       : request object was killed
+ *   E_TIMEOUT       : request is not started
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned aio_wait( aio_t *aio ) { return aio_waitFor(aio, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : aio_waitAny
+ *
+ * Description       : wait for given duration of time for completion of any of the requests
+ *
+ * Parameters
+ *   list            : array of pointers to request objects
+ *   cnt             : number of request objects in the array
+ *   delay           : duration of time (maximum number of ticks to wait for completion of any request)
+ *                     IMMEDIATE: don't wait if none of the requests is completed
+ *                     INFINITE:  wait indefinitely until any of the requests has been completed
+ *
+ * Return            : index of the first completed request in the array
+ *   E_STOPPED       : one of the request objects was killed before the specified timeout expired
+ *   E_TIMEOUT       : none of the requests was completed before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *                     a request can be watched by only one task waiting in aio_waitAny at a time
+ *
+ ******************************************************************************/
+
+unsigned aio_waitAny( aio_t * const *list, unsigned cnt, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : aio_result
+ *
+ * Description       : return the result of the completed request
+ *
+ * Parameters
+ *   aio             : pointer to request object
+ *
+ * Return            : result of the request set by aio_complete
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned aio_result( aio_t *aio ) { return aio->result; }
+
+/******************************************************************************
+ *
+ * Name              : core_aio_callback
+ *
+ * Description       : callback procedure of the request timer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+void core_aio_callback( void *arg );
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : AsyncRequest
+ *
+ * Description       : create and initialize an asynchronous i/o request object
+ *
+ * Constructor parameters
+ *   evq             : event queue receiving the result on completion, 0: none
+ *   fun             : callback procedure launched on completion, 0: none
+ *
+ ******************************************************************************/
+
+struct AsyncRequest : public __aio
+{
+	AsyncRequest( evq_t *_evq = nullptr, acp_t *_fun = nullptr ): __aio _AIO_INIT(*this, _evq, _fun) {}
+	~AsyncRequest( void ) { assert(__aio::queue == nullptr); }
+
+	void     kill       ( void )             {        aio_kill       (this);          }
+	unsigned start      ( void )             { return aio_start      (this);          }
+	unsigned startISR   ( void )             { return aio_startISR   (this);          }
+	unsigned complete   ( unsigned _result ) { return aio_complete   (this, _result); }
+	unsigned completeISR( unsigned _result ) { return aio_completeISR(this, _result); }
+	unsigned take       ( void )             { return aio_take       (this);          }
+	unsigned takeISR    ( void )             { return aio_takeISR    (this);          }
+	unsigned waitFor    ( cnt_t _delay )     { return aio_waitFor    (this, _delay);  }
+	unsigned waitUntil  ( cnt_t _time )      { return aio_waitUntil  (this, _time);   }
+	unsigned wait       ( void )             { return aio_wait       (this);          }
+	unsigned result     ( void )             { return aio_result     (this);          }
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_AIO_H
@@ -306,7 +306,7 @@ unsigned bar_wait( bar_t *bar ) { return bar_waitFor(bar, INFINITE); }
 
 struct Barrier : public __bar
 {
-	 Barrier( const unsigned _limit ): __bar _BAR_INIT(_limit) {}
+	constexpr Barrier( const unsigned _limit ): __bar _BAR_INIT(_limit) {}
 	~Barrier( void ) { assert(__bar::queue == nullptr); }
 
 	void     kill     ( void )         {        bar_kill     (this);         }
@@ -0,0 +1,527 @@
+/******************************************************************************
+
+    @file    StateOS: osbroadcastring.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_BRD_H
+#define __STATEOS_BRD_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : broadcast ring
+ *
+ * Note              : one writer, many readers; every record is written once,
+ *                     every reader holds its own cursor and receives all records,
+ *                     the writer never waits: the oldest record is overwritten
+ *                     and readers that fell behind by more than the size of the ring skip
+ *                     the lost records, counted in the lag counter of the cursor
+ *
+ ******************************************************************************/
+
+typedef struct __brd brd_t, * const brd_id;
+
+struct __brd
+{
+	tsk_t  * queue; // next process in the DELAYED queue
+	void   * res;   // allocated broadcast ring object's resource
+	unsigned seq;   // number of written records (free-running)
+	unsigned head;  // position of the next record in the ring
+	unsigned limit; // size of the ring (max number of stored records)
+	unsigned size;  // size of a single record (in bytes)
+	char   * data;  // broadcast ring data buffer
+};
+
+/******************************************************************************
+ *
+ * Name              : broadcast ring cursor
+ *
+ ******************************************************************************/
+
+typedef struct __brc brc_t;
+
+struct __brc
+{
+	unsigned seq;   // sequence number of the next record to read
+	unsigned lag;   // number of records lost by the reader (overwritten before they were read)
+};
+
+/******************************************************************************
+ *
+ * Name              : _BRD_INIT
+ *
+ * Description       : create and initialize a broadcast ring object
+ *
+ * Parameters
+ *   limit           : size of the ring (max number of stored records)
+ *   size            : size of a single record (in bytes)
+ *   data            : broadcast ring data buffer
+ *
+ * Return            : broadcast ring object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _BRD_INIT( _limit, _size, _data ) { 0, 0, 0, 0, _limit, _size, _data }
+
+/******************************************************************************
+ *
+ * Name              : _BRD_DATA
+ *
+ * Description       : create a broadcast ring data buffer
+ *
+ * Parameters
+ *   limit           : size of the ring (max number of stored records)
+ *   size            : size of a single record (in bytes)
+ *
+ * Return            : broadcast ring data buffer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _BRD_DATA( _limit, _size ) (char[_limit * _size]){ 0 }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : OS_BRD
+ *
+ * Description       : define and initialize a broadcast ring object
+ *
+ * Parameters
+ *   brd             : name of a pointer to broadcast ring object
+ *   limit           : size of the ring (max number of stored records)
+ *   size            : size of a single record (in bytes)
+ *
+ ******************************************************************************/
+
+#define             OS_BRD( brd, limit, size )                                \
+           __OS_NOINIT char brd##__buf[limit*size];                            \
+                       brd_t brd##__brd = _BRD_INIT( limit, size, brd##__buf ); \
+                       brd_id brd = & brd##__brd
+
+/******************************************************************************
+ *
+ * Name              : static_BRD
+ *
+ * Description       : define and initialize a static broadcast ring object
+ *
+ * Parameters
+ *   brd             : name of a pointer to broadcast ring object
+ *   limit           : size of the ring (max number of stored records)
+ *   size            : size of a single record (in bytes)
+ *
+ ******************************************************************************/
+
+#define         static_BRD( brd, limit, size )                                \
+         static __OS_NOINIT char brd##__buf[limit*size];                       \
+                static brd_t brd##__brd = _BRD_INIT( limit, size, brd##__buf ); \
+                static brd_id brd = & brd##__brd
+
+/******************************************************************************
+ *
+ * Name              : BRD_INIT
+ *
+ * Description       : create and initialize a broadcast ring object
+ *
+ * Parameters
+ *   limit           : size of the ring (max number of stored records)
+ *   size            : size of a single record (in bytes)
+ *
+ * Return            : broadcast ring object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                BRD_INIT( limit, size ) \
+                      _BRD_INIT( limit, size, _BRD_DATA( limit, size ) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : BRD_CREATE
+ * Alias             : BRD_NEW
+ *
+ * Description       : create and initialize a broadcast ring object
+ *
+ * Parameters
+ *   limit           : size of the ring (max number of stored records)
+ *   size            : size of a single record (in bytes)
+ *
+ * Return            : pointer to broadcast ring object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                BRD_CREATE( limit, size ) \
+           (brd_t[]) { BRD_INIT  ( limit, size ) }
+#define                BRD_NEW \
+                       BRD_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : brd_init
+ *
+ * Description       : initialize a broadcast ring object
+ *
+ * Parameters
+ *   brd             : pointer to broadcast ring object
+ *   limit           : size of the ring (max number of stored records)
+ *   size            : size of a single record (in bytes)
+ *   data            : broadcast ring data buffer
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void brd_init( brd_t *brd, unsigned limit, unsigned size, void *data );
+
+/******************************************************************************
+ *
+ * Name              : brd_create
+ * Alias             : brd_new
+ *
+ * Description       : create and initialize a new broadcast ring object
+ *
+ * Parameters
+ *   limit           : size of the ring (max number of stored records)
+ *   size            : size of a single record (in bytes)
+ *
+ * Return            : pointer to broadcast ring object (broadcast ring successfully created)
+ *   0               : broadcast ring not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+brd_t *brd_create( unsigned limit, unsigned size );
+
+__STATIC_INLINE
+brd_t *brd_new( unsigned limit, unsigned size ) { return brd_create(limit, size); }
+
+/******************************************************************************
+ *
+ * Name              : brd_kill
+ *
+ * Description       : wake up all waiting readers with 'E_STOPPED' event value,
+ *                     cursors of the readers remain valid
+ *
+ * Parameters
+ *   brd             : pointer to broadcast ring object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void brd_kill( brd_t *brd );
+
+/******************************************************************************
+ *
+ * Name              : brd_delete
+ *
+ * Description       : reset the broadcast ring object and free allocated resource
+ *
+ * Parameters
+ *   brd             : pointer to broadcast ring object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void brd_delete( brd_t *brd );
+
+/******************************************************************************
+ *
+ * Name              : brd_subscribe
+ * ISR alias         : brd_subscribeISR
+ *
+ * Description       : initialize the cursor of a reader of the broadcast ring object,
+ *                     the reader will receive records written from now on
+ *
+ * Parameters
+ *   brd             : pointer to broadcast ring object
+ *   brc             : pointer to the cursor of the reader
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void brd_subscribe( brd_t *brd, brc_t *brc );
+
+__STATIC_INLINE
+void brd_subscribeISR( brd_t *brd, brc_t *brc ) { brd_subscribe(brd, brc); }
+
+/******************************************************************************
+ *
+ * Name              : brd_waitFor
+ *
+ * Description       : try to read the next record for the cursor from the broadcast ring object,
+ *                     wait for given duration of time while the reader has read all the records
+ *
+ * Parameters
+ *   brd             : pointer to broadcast ring object
+ *   brc             : pointer to the cursor of the reader
+ *   data            : pointer to write buffer
+ *   delay           : duration of time (maximum number of ticks to wait for a new record)
+ *                     IMMEDIATE: don't wait if there is no new record
+ *                     INFINITE:  wait indefinitely for a new record
+ *
+ * Return
+ *   E_SUCCESS       : record was successfully read from the broadcast ring object
+ *   E_STOPPED       : broadcast ring object was killed before the specified timeout expired
+ *   E_TIMEOUT       : no new record was written before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned brd_waitFor( brd_t *brd, brc_t *brc, void *data, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : brd_waitUntil
+ *
+ * Description       : try to read the next record for the cursor from the broadcast ring object,
+ *                     wait until given timepoint while the reader has read all the records
+ *
+ * Parameters
+ *   brd             : pointer to broadcast ring object
+ *   brc             : pointer to the cursor of the reader
+ *   data            : pointer to write buffer
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : record was successfully read from the broadcast ring object
+ *   E_STOPPED       : broadcast ring object was killed before the specified timeout expired
+ *   E_TIMEOUT       : no new record was written before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned brd_waitUntil( brd_t *brd, brc_t *brc, void *data, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : brd_wait
+ *
+ * Description       : try to read the next record for the cursor from the broadcast ring object,
+ *                     wait indefinitely while the reader has read all the records
+ *
+ * Parameters
+ *   brd             : pointer to broadcast ring object
+ *   brc             : pointer to the cursor of the reader
+ *   data            : pointer to write buffer
+ *
+ * Return
+ *   E_SUCCESS       : record was successfully read from the broadcast ring object
+ *   E_STOPPED       : broadcast ring object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned brd_wait( brd_t *brd, brc_t *brc, void *data ) { return brd_waitFor(brd, brc, data, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : brd_take
+ * ISR alias         : brd_takeISR
+ *
+ * Description       : try to read the next record for the cursor from the broadcast ring object,
+ *                     don't wait if the reader has read all the records
+ *
+ * Parameters
+ *   brd             : pointer to broadcast ring object
+ *   brc             : pointer to the cursor of the reader
+ *   data            : pointer to write buffer
+ *
+ * Return
+ *   E_SUCCESS       : record was successfully read from the broadcast ring object
+ *   E_TIMEOUT       : there is no new record
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned brd_take( brd_t *brd, brc_t *brc, void *data );
+
+__STATIC_INLINE
+unsigned brd_takeISR( brd_t *brd, brc_t *brc, void *data ) { return brd_take(brd, brc, data); }
+
+/******************************************************************************
+ *
+ * Name              : brd_give
+ * ISR alias         : brd_giveISR
+ *
+ * Description       : write a record to the broadcast ring object (overwrite the oldest one)
+ *                     and wake up all waiting readers
+ *
+ * Parameters
+ *   brd             : pointer to broadcast ring object
+ *   data            : pointer to read buffer
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     only one task or handler may write to the broadcast ring object
+ *
+ ******************************************************************************/
+
+void brd_give( brd_t *brd, const void *data );
+
+__STATIC_INLINE
+void brd_giveISR( brd_t *brd, const void *data ) { brd_give(brd, data); }
+
+/******************************************************************************
+ *
+ * Name              : brd_count
+ * ISR alias         : brd_countISR
+ *
+ * Description       : return the number of records available to the reader
+ *
+ * Parameters
+ *   brd             : pointer to broadcast ring object
+ *   brc             : pointer to the cursor of the reader
+ *
+ * Return            : number of records not read yet (up to the size of the ring)
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned brd_count( brd_t *brd, brc_t *brc );
+
+__STATIC_INLINE
+unsigned brd_countISR( brd_t *brd, brc_t *brc ) { return brd_count(brd, brc); }
+
+/******************************************************************************
+ *
+ * Name              : brd_lag
+ *
+ * Description       : return the number of records lost by the reader
+ *
+ * Parameters
+ *   brc             : pointer to the cursor of the reader
+ *
+ * Return            : number of records overwritten before the reader has read them
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned brd_lag( brc_t *brc ) { return brc->lag; }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : BroadcastRingT<>
+ *
+ * Description       : create and initialize a broadcast ring object
+ *
+ * Constructor parameters
+ *   limit           : size of the ring (max number of stored records)
+ *   size            : size of a single record (in bytes)
+ *
+ ******************************************************************************/
+
+template<unsigned limit_, unsigned size_>
+struct BroadcastRingT : public __brd
+{
+	 BroadcastRingT( void ): __brd _BRD_INIT(limit_, size_, data_) {}
+	~BroadcastRingT( void ) { assert(__brd::queue == nullptr); }
+
+	void     kill        ( void )                                         {        brd_kill        (this);                     }
+	void     subscribe   ( brc_t *_brc )                                  {        brd_subscribe   (this, _brc);               }
+	void     subscribeISR( brc_t *_brc )                                  {        brd_subscribeISR(this, _brc);               }
+	unsigned waitFor     ( brc_t *_brc,       void *_data, cnt_t _delay ) { return brd_waitFor     (this, _brc, _data, _delay); }
+	unsigned waitUntil   ( brc_t *_brc,       void *_data, cnt_t _time )  { return brd_waitUntil   (this, _brc, _data, _time);  }
+	unsigned wait        ( brc_t *_brc,       void *_data )               { return brd_wait        (this, _brc, _data);         }
+	unsigned take        ( brc_t *_brc,       void *_data )               { return brd_take        (this, _brc, _data);         }
+	unsigned takeISR     ( brc_t *_brc,       void *_data )               { return brd_takeISR     (this, _brc, _data);         }
+	void     give        (              const void *_data )               {        brd_give        (this, _data);               }
+	void     giveISR     (              const void *_data )               {        brd_giveISR     (this, _data);               }
+	unsigned count       ( brc_t *_brc )                                  { return brd_count       (this, _brc);               }
+	unsigned countISR    ( brc_t *_brc )                                  { return brd_countISR    (this, _brc);               }
+
+	private:
+	char data_[limit_ * size_];
+};
+
+/******************************************************************************
+ *
+ * Class             : BroadcastRingTT<>
+ *
+ * Description       : create and initialize a broadcast ring object
+ *
+ * Constructor parameters
+ *   limit           : size of the ring (max number of stored records)
+ *   T               : class of a single record
+ *
+ ******************************************************************************/
+
+template<unsigned limit_, class T>
+struct BroadcastRingTT : public BroadcastRingT<limit_, sizeof(T)>
+{
+	BroadcastRingTT( void ): BroadcastRingT<limit_, sizeof(T)>() {}
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_BRD_H
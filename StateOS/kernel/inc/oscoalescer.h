@@ -0,0 +1,270 @@
+/******************************************************************************
+
+    @file    StateOS: oscoalescer.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_COA_H
+#define __STATEOS_COA_H
+
+#include "oskernel.h"
+#include "ostimer.h"
+#include "ossemaphore.h"
+#include "oseventqueue.h"
+#include "ostask.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : interrupt coalescer
+ *
+ * Note              : coalescer accumulates signals of a high-rate interrupt handler in a counter,
+ *                     the target object is signalled once per batch: when the number of signals reaches the threshold
+ *                     or when the coalescing timer expires, started with the first signal of the batch
+ *
+ ******************************************************************************/
+
+typedef void cof_t( void *obj, unsigned count ); // coalescer flush procedure
+
+typedef struct __coa coa_t, * const coa_id;
+
+struct __coa
+{
+	tmr_t    tmr;   // coalescing timer
+	cof_t  * flush; // flush procedure, signals the target object with the number of accumulated signals
+	void   * obj;   // target object
+	unsigned count; // number of accumulated signals
+	unsigned limit; // threshold: number of signals flushed immediately
+	cnt_t    delay; // coalescing time: max delay of the first signal of the batch
+};
+
+/******************************************************************************
+ *
+ * Name              : coa_sem
+ * Name              : coa_evq
+ * Name              : coa_ntf
+ *
+ * Description       : flush procedures of the coalescer for target semaphore, event queue and task
+ *                     coa_sem: semaphore 'obj' is released 'count' times
+ *                     coa_evq: 'count' is sent as one event to event queue 'obj' (lost if the queue is full)
+ *                     coa_ntf: notification value of task 'obj' is incremented by 'count', the task is notified once
+ *
+ * Parameters
+ *   obj             : pointer to the target object
+ *   count           : number of accumulated signals
+ *
+ * Return            : none
+ *
+ ******************************************************************************/
+
+void coa_sem( void *obj, unsigned count );
+void coa_evq( void *obj, unsigned count );
+void coa_ntf( void *obj, unsigned count );
+
+/******************************************************************************
+ *
+ * Name              : _COA_INIT
+ *
+ * Description       : create and initialize a coalescer object
+ *
+ * Parameters
+ *   coa             : name of the coalescer object
+ *   flush           : flush procedure (coa_sem, coa_evq, coa_ntf or user-defined)
+ *   obj             : pointer to the target object
+ *   limit           : threshold: number of signals flushed immediately
+ *   delay           : coalescing time (in ticks): max delay of the first signal of the batch
+ *
+ * Return            : coalescer object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _COA_INIT( _coa, _flush, _obj, _limit, _delay ) { _TMR_INIT_ARG(core_coa_timeout, &(_coa)), _flush, _obj, 0, _limit, _delay }
+
+/******************************************************************************
+ *
+ * Name              : OS_COA
+ *
+ * Description       : define and initialize a coalescer object
+ *
+ * Parameters
+ *   coa             : name of a pointer to coalescer object
+ *   flush           : flush procedure (coa_sem, coa_evq, coa_ntf or user-defined)
+ *   obj             : pointer to the target object
+ *   limit           : threshold: number of signals flushed immediately
+ *   delay           : coalescing time (in ticks): max delay of the first signal of the batch
+ *
+ * Note              : if the timer service task is used (OS_TIMER_TASK), it must be started in thread mode
+ *                     (with any timer or with coa_init) before the first coalescing timer is started
+ *
+ ******************************************************************************/
+
+#define             OS_COA( coa, flush, obj, limit, delay )                              \
+                       coa_t coa##__coa = _COA_INIT( coa##__coa, flush, obj, limit, delay ); \
+                       coa_id coa = & coa##__coa
+
+/******************************************************************************
+ *
+ * Name              : static_COA
+ *
+ * Description       : define and initialize a static coalescer object
+ *
+ * Parameters
+ *   coa             : name of a pointer to coalescer object
+ *   flush           : flush procedure (coa_sem, coa_evq, coa_ntf or user-defined)
+ *   obj             : pointer to the target object
+ *   limit           : threshold: number of signals flushed immediately
+ *   delay           : coalescing time (in ticks): max delay of the first signal of the batch
+ *
+ * Note              : look at OS_COA
+ *
+ ******************************************************************************/
+
+#define         static_COA( coa, flush, obj, limit, delay )                              \
+                static coa_t coa##__coa = _COA_INIT( coa##__coa, flush, obj, limit, delay ); \
+                static coa_id coa = & coa##__coa
+
+/******************************************************************************
+ *
+ * Name              : coa_init
+ *
+ * Description       : initialize a coalescer object
+ *
+ * Parameters
+ *   coa             : pointer to coalescer object
+ *   flush           : flush procedure (coa_sem, coa_evq, coa_ntf or user-defined)
+ *   obj             : pointer to the target object
+ *   limit           : threshold: number of signals flushed immediately
+ *   delay           : coalescing time (in ticks): max delay of the first signal of the batch
+ *                     0: signals are flushed only when the threshold is reached (or with coa_flush)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void coa_init( coa_t *coa, cof_t *flush, void *obj, unsigned limit, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : coa_give
+ * ISR alias         : coa_giveISR
+ *
+ * Description       : accumulate one signal,
+ *                     flush the accumulated signals if the threshold is reached,
+ *                     start the coalescing timer with the first signal of the batch
+ *
+ * Parameters
+ *   coa             : pointer to coalescer object
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void coa_give( coa_t *coa );
+
+__STATIC_INLINE
+void coa_giveISR( coa_t *coa ) { coa_give(coa); }
+
+/******************************************************************************
+ *
+ * Name              : coa_flush
+ * ISR alias         : coa_flushISR
+ *
+ * Description       : flush the accumulated signals now
+ *
+ * Parameters
+ *   coa             : pointer to coalescer object
+ *
+ * Return            : number of flushed signals
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned coa_flush( coa_t *coa );
+
+__STATIC_INLINE
+unsigned coa_flushISR( coa_t *coa ) { return coa_flush(coa); }
+
+/******************************************************************************
+ *
+ * Name              : core_coa_timeout
+ *
+ * Description       : callback procedure of the coalescing timer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+void core_coa_timeout( void *arg );
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : Coalescer
+ *
+ * Description       : create and initialize a coalescer object
+ *
+ * Constructor parameters
+ *   flush           : flush procedure (coa_sem, coa_evq, coa_ntf or user-defined)
+ *   obj             : pointer to the target object
+ *   limit           : threshold: number of signals flushed immediately
+ *   delay           : coalescing time (in ticks): max delay of the first signal of the batch
+ *
+ ******************************************************************************/
+
+struct Coalescer : public __coa
+{
+	Coalescer( cof_t *_flush, void *_obj, unsigned _limit, cnt_t _delay ): __coa _COA_INIT(*this, _flush, _obj, _limit, _delay) {}
+
+	void     give    ( void ) {        coa_give    (this); }
+	void     giveISR ( void ) {        coa_giveISR (this); }
+	unsigned flush   ( void ) { return coa_flush   (this); }
+	unsigned flushISR( void ) { return coa_flushISR(this); }
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_COA_H
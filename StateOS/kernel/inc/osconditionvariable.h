@@ -34,6 +34,7 @@
 
 #include "oskernel.h"
 #include "osmutex.h"
+#include "osfastmutex.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -288,6 +289,76 @@ unsigned cnd_waitUntil( cnd_t *cnd, mtx_t *mtx, cnt_t time );
 __STATIC_INLINE
 unsigned cnd_wait( cnd_t *cnd, mtx_t *mtx ) { return cnd_waitFor(cnd, mtx, INFINITE); }
 
+/******************************************************************************
+ *
+ * Name              : cnd_waitFastFor
+ *
+ * Description       : wait for given duration of time on the condition variable releasing the currently owned fast mutex,
+ *                     and finally lock the fast mutex again
+ *
+ * Parameters
+ *   cnd             : pointer to condition variable object
+ *   mut             : currently owned fast mutex
+ *   delay           : duration of time (maximum number of ticks to wait on the condition variable object)
+ *                     IMMEDIATE: don't wait on the condition variable object
+ *                     INFINITE:  wait indefinitely on the condition variable object
+ *
+ * Return
+ *   E_SUCCESS       : condition variable object was successfully signalled and owned fast mutex locked again
+ *   E_STOPPED       : condition variable object was killed before the specified timeout expired
+ *   E_TIMEOUT       : condition variable object was not signalled before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned cnd_waitFastFor( cnd_t *cnd, mut_t *mut, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : cnd_waitFastUntil
+ *
+ * Description       : wait until given timepoint on the condition variable releasing the currently owned fast mutex,
+ *                     and finally lock the fast mutex again
+ *
+ * Parameters
+ *   cnd             : pointer to condition variable object
+ *   mut             : currently owned fast mutex
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : condition variable object was successfully signalled and owned fast mutex locked again
+ *   E_STOPPED       : condition variable object was killed before the specified timeout expired
+ *   E_TIMEOUT       : condition variable object was not signalled before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned cnd_waitFastUntil( cnd_t *cnd, mut_t *mut, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : cnd_waitFast
+ *
+ * Description       : wait indefinitely on the condition variable releasing the currently owned fast mutex,
+ *                     and finally lock the fast mutex again
+ *
+ * Parameters
+ *   cnd             : pointer to condition variable object
+ *   mut             : currently owned fast mutex
+ *
+ * Return
+ *   E_SUCCESS       : condition variable object was successfully signalled and owned fast mutex locked again
+ *   E_STOPPED       : condition variable object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned cnd_waitFast( cnd_t *cnd, mut_t *mut ) { return cnd_waitFastFor(cnd, mut, INFINITE); }
+
 /******************************************************************************
  *
  * Name              : cnd_give
@@ -304,6 +375,9 @@ unsigned cnd_wait( cnd_t *cnd, mtx_t *mtx ) { return cnd_waitFor(cnd, mtx, INFIN
  * Return            : none
  *
  * Note              : may be used both in thread and handler mode
+ *                     if the associated mutex or fast mutex is held by another task (usually the signalling one),
+ *                     the signalled tasks are moved directly to the mutex queue (wait morphing)
+ *                     and each of them is resumed once, when the mutex is handed over to it
  *
  ******************************************************************************/
 
@@ -333,13 +407,16 @@ void cnd_giveISR( cnd_t *cnd, bool all ) { cnd_give(cnd, all); }
 
 struct ConditionVariable : public __cnd
 {
-	 ConditionVariable( void ): __cnd _CND_INIT() {}
+	constexpr ConditionVariable( void ): __cnd _CND_INIT() {}
 	~ConditionVariable( void ) { assert(__cnd::queue == nullptr); }
 
 	void     kill     ( void )                      {        cnd_kill     (this);               }
 	unsigned waitFor  ( mtx_t *_mtx, cnt_t _delay ) { return cnd_waitFor  (this, _mtx, _delay); }
 	unsigned waitUntil( mtx_t *_mtx, cnt_t _time )  { return cnd_waitUntil(this, _mtx, _time);  }
 	unsigned wait     ( mtx_t *_mtx )               { return cnd_wait     (this, _mtx);         }
+	unsigned waitFor  ( mut_t *_mut, cnt_t _delay ) { return cnd_waitFastFor  (this, _mut, _delay); }
+	unsigned waitUntil( mut_t *_mut, cnt_t _time )  { return cnd_waitFastUntil(this, _mut, _time);  }
+	unsigned wait     ( mut_t *_mut )               { return cnd_waitFast     (this, _mut);         }
 	void     give     ( bool   _all = cndAll )      {        cnd_give     (this, _all);         }
 	void     giveISR  ( bool   _all = cndAll )      {        cnd_giveISR  (this, _all);         }
 };
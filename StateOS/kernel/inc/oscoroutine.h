@@ -0,0 +1,346 @@
+/******************************************************************************
+
+    @file    StateOS: oscoroutine.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_CO_H
+#define __STATEOS_CO_H
+
+#include "oskernel.h"
+#include "oscriticalsection.h"
+#include "ossignal.h"
+#include "ossemaphore.h"
+#include "osmailboxqueue.h"
+#include "oseventqueue.h"
+#include "ostimer.h"
+#include "ostask.h"
+#include "osselect.h"
+
+/* -------------------------------------------------------------------------- */
+
+#if defined(__cplusplus) && defined(__cpp_impl_coroutine)
+
+#if OS_SELECT
+
+#include <coroutine>
+
+/******************************************************************************
+ *
+ * Class             : Coroutine
+ *
+ * Description       : return type of a stackless coroutine executed by the coroutine scheduler
+ *                     coroutine frame is allocated from the system heap (sys_alloc)
+ *
+ * Example           : Coroutine blink( void ) { for (;;) { co_await Co::sleepFor(SEC); led.tick(); } }
+ *
+ ******************************************************************************/
+
+struct CoAwait;
+struct CoScheduler;
+
+struct Coroutine
+{
+	struct promise_type
+	{
+		Coroutine get_return_object( void ) { return Coroutine(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+		std::suspend_always initial_suspend( void ) noexcept { return {}; }
+		std::suspend_always final_suspend  ( void ) noexcept { return {}; }
+
+		void return_void        ( void ) {}
+		void unhandled_exception( void ) { abort(); }
+
+		static void *operator new   ( size_t _size ) { return core_sys_alloc(_size); }
+		static void  operator delete( void  *_ptr )  {        core_sys_free (_ptr);  }
+
+		CoAwait      *wait_ = nullptr; // awaiter the coroutine is suspended on
+		promise_type *next_ = nullptr; // next coroutine of the scheduler
+	};
+
+	using handle = std::coroutine_handle<promise_type>;
+
+	explicit
+	 Coroutine( handle _h ): h_(_h) {}
+	 Coroutine( Coroutine &&_co ): h_(_co.h_) { _co.h_ = nullptr; }
+	~Coroutine( void ) { if (h_) h_.destroy(); }
+
+	Coroutine( const Coroutine & ) = delete;
+	Coroutine &operator=( const Coroutine & ) = delete;
+
+	private:
+	handle h_;
+
+	friend struct CoScheduler;
+};
+
+/******************************************************************************
+ *
+ * Class             : CoAwait
+ *
+ * Description       : base of awaitable adapters for StateOS blocking objects
+ *                     the coroutine is suspended until the non-blocking 'take' of the object succeeds
+ *                     or the timeout expires; the object is watched by the wait-set of the scheduler
+ *
+ * Return of co_await: E_SUCCESS (or event value), E_STOPPED, E_TIMEOUT
+ *
+ ******************************************************************************/
+
+struct CoAwait
+{
+	CoAwait( unsigned (*_take)( CoAwait * ), const void *_obj, cnt_t _delay ): left_(nullptr), take_(_take), obj_(_obj), start_(time_()), delay_(_delay), event_(E_TIMEOUT) {}
+
+	bool     await_ready ( void ) { return poll_(time_()); }
+	void     await_suspend( Coroutine::handle _h ) { _h.promise().wait_ = this; }
+	unsigned await_resume( void ) { return event_; }
+
+	protected:
+	cnt_t (*left_)( CoAwait *, cnt_t ); // number of ticks until the object can become ready without a notification
+
+	private:
+	bool poll_( cnt_t _now )
+	{
+		event_ = take_(this);
+		if (event_ != E_TIMEOUT) return true;
+		return delay_ != INFINITE && _now - start_ >= delay_;
+	}
+
+	cnt_t due_( cnt_t _now ) // number of ticks until the awaiter has to be polled again
+	{
+		cnt_t delay = delay_ == INFINITE ? INFINITE : start_ + delay_ - _now;
+		cnt_t left  = left_ == nullptr   ? INFINITE : left_(this, _now);
+		return left < delay ? left : delay;
+	}
+
+	static
+	cnt_t time_( void ) { CriticalSection cs; return core_sys_time(); }
+
+	unsigned (*take_)( CoAwait * );
+	const void *obj_;
+	cnt_t    start_;
+	cnt_t    delay_;
+	unsigned event_;
+
+	friend struct CoScheduler;
+};
+
+/******************************************************************************
+ *
+ * Namespace         : Co
+ *
+ * Description       : provide set of awaitable adapters for coroutines
+ *                     waitFor(obj, ..., delay) waits for given duration of time (IMMEDIATE, INFINITE)
+ *                     wait(obj, ...) waits indefinitely
+ *
+ ******************************************************************************/
+
+namespace Co
+{
+	struct SemAwait : public CoAwait
+	{
+		SemAwait( sem_t *_sem, cnt_t _delay ): CoAwait(take_, _sem, _delay), sem_(_sem) {}
+		static unsigned take_( CoAwait *_aw ) { return sem_take(((SemAwait *)_aw)->sem_); }
+		sem_t *sem_;
+	};
+
+	struct SigAwait : public CoAwait
+	{
+		SigAwait( sig_t *_sig, cnt_t _delay ): CoAwait(take_, _sig, _delay), sig_(_sig) {}
+		static unsigned take_( CoAwait *_aw ) { return sig_take(((SigAwait *)_aw)->sig_); }
+		sig_t *sig_;
+	};
+
+	struct BoxAwait : public CoAwait
+	{
+		BoxAwait( box_t *_box, void *_data, cnt_t _delay ): CoAwait(take_, _box, _delay), box_(_box), data_(_data) {}
+		static unsigned take_( CoAwait *_aw ) { return box_take(((BoxAwait *)_aw)->box_, ((BoxAwait *)_aw)->data_); }
+		box_t *box_;
+		void  *data_;
+	};
+
+	struct EvqAwait : public CoAwait
+	{
+		EvqAwait( evq_t *_evq, cnt_t _delay ): CoAwait(take_, _evq, _delay), evq_(_evq) {}
+		static unsigned take_( CoAwait *_aw ) { return evq_take(((EvqAwait *)_aw)->evq_); }
+		evq_t *evq_;
+	};
+
+	// timers don't notify wait-sets, the awaiter is polled when the countdown of the timer ends
+	struct TmrAwait : public CoAwait
+	{
+		TmrAwait( tmr_t *_tmr, cnt_t _delay ): CoAwait(take_, nullptr, _delay), tmr_(_tmr) { left_ = end_; }
+		static unsigned take_( CoAwait *_aw ) { return tmr_take(((TmrAwait *)_aw)->tmr_); }
+		static cnt_t end_( CoAwait *_aw, cnt_t _now )
+		{
+			tmr_t *tmr = ((TmrAwait *)_aw)->tmr_;
+			CriticalSection cs;
+			cnt_t left = tmr->start + tmr->delay - _now;
+			return tmr->id == ID_TIMER && left > 0 && left <= tmr->delay ? left : 1;
+		}
+		tmr_t *tmr_;
+	};
+
+	struct SleepAwait : public CoAwait
+	{
+		SleepAwait( cnt_t _delay ): CoAwait(take_, nullptr, _delay) {}
+		static unsigned take_( CoAwait * ) { return E_TIMEOUT; }
+	};
+
+	struct YieldAwait : public SleepAwait
+	{
+		YieldAwait( void ): SleepAwait(IMMEDIATE) {}
+		bool await_ready( void ) { return false; }
+	};
+
+	static inline SemAwait   waitFor  ( sem_t *_sem,              cnt_t _delay ) { return SemAwait(_sem, _delay);          }
+	static inline SemAwait   wait     ( sem_t *_sem )                            { return SemAwait(_sem, INFINITE);        }
+	static inline SigAwait   waitFor  ( sig_t *_sig,              cnt_t _delay ) { return SigAwait(_sig, _delay);          }
+	static inline SigAwait   wait     ( sig_t *_sig )                            { return SigAwait(_sig, INFINITE);        }
+	static inline BoxAwait   waitFor  ( box_t *_box, void *_data, cnt_t _delay ) { return BoxAwait(_box, _data, _delay);   }
+	static inline BoxAwait   wait     ( box_t *_box, void *_data )               { return BoxAwait(_box, _data, INFINITE); }
+	static inline EvqAwait   waitFor  ( evq_t *_evq,              cnt_t _delay ) { return EvqAwait(_evq, _delay);          }
+	static inline EvqAwait   wait     ( evq_t *_evq )                            { return EvqAwait(_evq, INFINITE);        }
+	static inline TmrAwait   waitFor  ( tmr_t *_tmr,              cnt_t _delay ) { return TmrAwait(_tmr, _delay);          }
+	static inline TmrAwait   wait     ( tmr_t *_tmr )                            { return TmrAwait(_tmr, INFINITE);        }
+	static inline SleepAwait sleepFor ( cnt_t  _delay )                          { return SleepAwait(_delay);              }
+	static inline YieldAwait yield    ( void )                                   { return YieldAwait();                    }
+}
+
+/******************************************************************************
+ *
+ * Class             : CoScheduler
+ *
+ * Description       : scheduler of stackless coroutines executed by one task
+ *                     coroutines are resumed in round-robin order when their awaiters are ready;
+ *                     when no coroutine was resumed, the task blocks on a wait-set of the awaited objects
+ *                     until one of them is given or the nearest timeout of the awaiters expires
+ *                     (up to OS_SELECT different objects are watched, awaiters of further objects are polled every tick)
+ *
+ * Note              : spawn only from the scheduler task or before the scheduler is started
+ *
+ * Example           : CoScheduler sched; auto tsk = startTask(1, [] { sched.spawn(blink()); sched.run(); });
+ *
+ ******************************************************************************/
+
+struct CoScheduler
+{
+	CoScheduler( void ): list_(nullptr) {}
+
+	void spawn( Coroutine &&_co )
+	{
+		Coroutine::promise_type *p = &_co.h_.promise();
+		_co.h_ = nullptr;
+		p->next_ = list_;
+		list_ = p;
+	}
+
+	unsigned step( void ) // resume all ready coroutines, return the number of resumed coroutines
+	{
+		Coroutine::promise_type **ptr = &list_;
+		cnt_t now = CoAwait::time_();
+		unsigned cnt = 0;
+
+		while (*ptr)
+		{
+			Coroutine::promise_type *p = *ptr;
+			Coroutine::handle h = Coroutine::handle::from_promise(*p);
+
+			if (p->wait_ == nullptr || p->wait_->poll_(now))
+			{
+				p->wait_ = nullptr;
+				h.resume();
+				cnt++;
+				if (h.done())
+				{
+					*ptr = p->next_;
+					h.destroy();
+					continue;
+				}
+			}
+			ptr = &p->next_;
+		}
+
+		return cnt;
+	}
+
+	void run( void ) // run coroutines until all of them are finished
+	{
+		while (list_)
+		{
+			cnt_t delay = watch_(); // gives after this point wake up the scheduler
+			if (step() == 0)
+				sel_.waitFor(delay);
+		}
+	}
+
+	private:
+	// watch the objects of all awaiters with the wait-set, return the number of ticks until the nearest timeout
+	cnt_t watch_( void )
+	{
+		cnt_t now = CoAwait::time_();
+		cnt_t delay = INFINITE;
+
+		sel_.kill();
+		for (Coroutine::promise_type *p = list_; p; p = p->next_)
+		{
+			CoAwait *aw = p->wait_;
+			if (aw == nullptr)
+				continue;
+			cnt_t left = aw->due_(now);
+			if (aw->obj_ != nullptr && !add_(aw->obj_))
+				left = 1; // the wait-set is full, the awaiter is polled every tick
+			if (left < delay)
+				delay = left;
+		}
+		while (sel_.waitFor(IMMEDIATE) != E_TIMEOUT); // the objects are polled by 'step' anyway
+
+		return delay;
+	}
+
+	bool add_( const void *_obj )
+	{
+		for (unsigned i = 0; i < sel_.count; i++)
+			if (sel_.obj[i] == _obj)
+				return true;
+		if (sel_.count >= OS_SELECT)
+			return false;
+		sel_.add(_obj);
+		return true;
+	}
+
+	Coroutine::promise_type *list_;
+	Select sel_;
+};
+
+#endif//OS_SELECT
+
+#endif//__cpp_impl_coroutine
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_CO_H
@@ -49,13 +49,18 @@ extern "C" {
  * Return            : previous interrupts state
  *
  * Note              : for internal use
+ *                     asserts when called from a kernel-unaware handler (urgency above OS_LOCK_LEVEL)
  *
  ******************************************************************************/
 
 __STATIC_INLINE
 lck_t core_sys_lock( void )
 {
-	lck_t lck = port_get_lock();
+	lck_t lck;
+
+	assert(port_isr_aware());
+
+	lck = port_get_lock();
 	port_set_lock();
 	return lck;
 }
@@ -97,8 +102,13 @@ void core_sys_unlock( lck_t lck )
  *
  ******************************************************************************/
 
+#if OS_LOCK_PROFILE
+#define                sys_lock() \
+                       do { lck_t __LOCK = core_sys_lock(); static lps_t __SITE = _LPS_INIT(__FILE__, __LINE__); lpm_t __PROF; core_lps_enter(__LOCK, &__PROF)
+#else
 #define                sys_lock() \
                        do { lck_t __LOCK = core_sys_lock()
+#endif
 
 #define                sys_lockISR() \
                        sys_lock()
@@ -119,12 +129,61 @@ void core_sys_unlock( lck_t lck )
  *
  ******************************************************************************/
 
+#if OS_LOCK_PROFILE
+#define                sys_unlock() \
+                       core_lps_leave(__LOCK, &__PROF, &__SITE); core_sys_unlock(__LOCK); } while (0)
+#else
 #define                sys_unlock() \
                        core_sys_unlock(__LOCK); } while (0)
+#endif
 
 #define                sys_unlockISR() \
                        sys_unlock()
 
+/******************************************************************************
+ *
+ * Name              : sys_lockProfile
+ *
+ * Description       : return the list of critical section call sites recorded since the last reset
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to the first recorded call site, next sites are linked with the 'next' field
+ *
+ * Note              : use only in thread mode, available when OS_LOCK_PROFILE is set
+ *                     'max' and 'hist' of a call site are expressed in cpu cycles;
+ *                     critical sections of the CriticalSection class are recorded as a single call site
+ *
+ ******************************************************************************/
+
+#if OS_LOCK_PROFILE
+
+__STATIC_INLINE
+lps_t *sys_lockProfile( void ) { return core_lps_list(); }
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_lockProfileReset
+ *
+ * Description       : clear the statistics of all critical section call sites
+ *
+ * Parameters        : none
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, available when OS_LOCK_PROFILE is set
+ *
+ ******************************************************************************/
+
+#if OS_LOCK_PROFILE
+
+__STATIC_INLINE
+void sys_lockProfileReset( void ) { lck_t lck = core_sys_lock(); core_lps_reset(); core_sys_unlock(lck); }
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -146,11 +205,23 @@ void core_sys_unlock( lck_t lck )
 
 struct CriticalSection
 {
+#if OS_LOCK_PROFILE
+	 CriticalSection( void ) { lck = core_sys_lock(); core_lps_enter(lck, &prof); }
+	~CriticalSection( void ) { core_lps_leave(lck, &prof, site()); core_sys_unlock(lck); }
+#else
 	 CriticalSection( void ) { lck = core_sys_lock(); }
 	~CriticalSection( void ) { core_sys_unlock(lck);  }
+#endif
+
+	CriticalSection( const CriticalSection & ) = delete;
+	CriticalSection &operator=( const CriticalSection & ) = delete;
 
 	private:
 	lck_t lck;
+#if OS_LOCK_PROFILE
+	lpm_t prof;
+	static lps_t *site( void ) { static lps_t _site = _LPS_INIT("CriticalSection", 0); return &_site; }
+#endif
 };
 
 #endif//__cplusplus
@@ -0,0 +1,543 @@
+/******************************************************************************
+
+    @file    StateOS: osdoublebuffer.h
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_DBF_H
+#define __STATEOS_DBF_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : double buffer
+ *
+ * Note              : the producer (usually a DMA interrupt) fills the active buffer,
+ *                     dbf_swapISR passes the filled buffer to the consumer task by pointer and activates the next one,
+ *                     the consumer task returns every taken buffer with dbf_release (in the order of taking),
+ *                     if the next buffer is not free when the active one is swapped, an overrun is counted:
+ *                     the oldest filled buffer is dropped and reused if the consumer holds no buffer,
+ *                     otherwise the filled active buffer is dropped and filled again,
+ *                     data cache lines of the taken buffer are discarded if the port provides port_cache_invalidate
+ *                     (CACHE_LINE defined), e.g. STM32F7 port; buffers must be then aligned to the cache line
+ *
+ ******************************************************************************/
+
+typedef struct __dbf dbf_t, * const dbf_id;
+
+struct __dbf
+{
+	tsk_t  * queue; // next process in the DELAYED queue
+	void   * res;   // allocated double buffer object's resource
+	unsigned limit; // number of buffers
+	unsigned size;  // size of a single buffer (in bytes)
+	char   * data;  // buffers
+	unsigned fill;  // index of the active buffer (filled by the producer)
+	unsigned head;  // index of the oldest filled buffer not taken by the consumer
+	unsigned count; // number of filled buffers not taken by the consumer
+	unsigned owned; // number of buffers taken and not released by the consumer
+	unsigned lost;  // number of overruns
+};
+
+/******************************************************************************
+ *
+ * Name              : _DBF_INIT
+ *
+ * Description       : create and initialize a double buffer object
+ *
+ * Parameters
+ *   limit           : number of buffers (at least 2)
+ *   size            : size of a single buffer (in bytes)
+ *   data            : buffers (limit * size bytes)
+ *
+ * Return            : double buffer object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _DBF_INIT( _limit, _size, _data ) { 0, 0, _limit, _size, _data, 0, 0, 0, 0, 0 }
+
+/******************************************************************************
+ *
+ * Name              : _DBF_SIZE
+ *
+ * Description       : size of a single buffer of a double buffer object,
+ *                     rounded up to the multiple of CACHE_LINE if the port defines it
+ *
+ * Parameters
+ *   size            : size of a single buffer (in bytes)
+ *
+ * Return            : size of a single buffer (in bytes)
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifdef CACHE_LINE
+#define               _DBF_SIZE( _size ) CACHE_ROUND( _size )
+#define               _DBF_ALIGNED       __CACHE_ALIGNED
+#else
+#define               _DBF_SIZE( _size ) ( _size )
+#define               _DBF_ALIGNED
+#endif
+
+/******************************************************************************
+ *
+ * Name              : _DBF_DATA
+ *
+ * Description       : create buffers of a double buffer object
+ *
+ * Parameters
+ *   limit           : number of buffers (at least 2)
+ *   size            : size of a single buffer (in bytes)
+ *
+ * Return            : buffers of a double buffer object
+ *
+ * Note              : for internal use
+ *                     the compound literal is not aligned to the cache line
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _DBF_DATA( _limit, _size ) (char[_limit * _DBF_SIZE(_size)]){ 0 }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : OS_DBF
+ *
+ * Description       : define and initialize a double buffer object
+ *                     with buffers aligned to the cache line (if the port defines CACHE_LINE)
+ *
+ * Parameters
+ *   dbf             : name of a pointer to double buffer object
+ *   limit           : number of buffers (at least 2)
+ *   size            : size of a single buffer (in bytes)
+ *
+ ******************************************************************************/
+
+#define             OS_DBF( dbf, limit, size )                                                 \
+                       char dbf##__buf[limit * _DBF_SIZE(size)] _DBF_ALIGNED;                   \
+                       dbf_t dbf##__dbf = _DBF_INIT( limit, _DBF_SIZE(size), dbf##__buf );      \
+                       dbf_id dbf = & dbf##__dbf
+
+/******************************************************************************
+ *
+ * Name              : static_DBF
+ *
+ * Description       : define and initialize a static double buffer object
+ *                     with buffers aligned to the cache line (if the port defines CACHE_LINE)
+ *
+ * Parameters
+ *   dbf             : name of a pointer to double buffer object
+ *   limit           : number of buffers (at least 2)
+ *   size            : size of a single buffer (in bytes)
+ *
+ ******************************************************************************/
+
+#define         static_DBF( dbf, limit, size )                                                 \
+                static char dbf##__buf[limit * _DBF_SIZE(size)] _DBF_ALIGNED;                   \
+                static dbf_t dbf##__dbf = _DBF_INIT( limit, _DBF_SIZE(size), dbf##__buf );      \
+                static dbf_id dbf = & dbf##__dbf
+
+/******************************************************************************
+ *
+ * Name              : DBF_INIT
+ *
+ * Description       : create and initialize a double buffer object
+ *
+ * Parameters
+ *   limit           : number of buffers (at least 2)
+ *   size            : size of a single buffer (in bytes)
+ *
+ * Return            : double buffer object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                DBF_INIT( limit, size ) \
+                      _DBF_INIT( limit, _DBF_SIZE(size), _DBF_DATA( limit, size ) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : DBF_CREATE
+ * Alias             : DBF_NEW
+ *
+ * Description       : create and initialize a double buffer object
+ *
+ * Parameters
+ *   limit           : number of buffers (at least 2)
+ *   size            : size of a single buffer (in bytes)
+ *
+ * Return            : pointer to double buffer object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                DBF_CREATE( limit, size ) \
+           (dbf_t[]) { DBF_INIT  ( limit, size ) }
+#define                DBF_NEW \
+                       DBF_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : dbf_init
+ *
+ * Description       : initialize a double buffer object
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *   limit           : number of buffers (at least 2)
+ *   size            : size of a single buffer (in bytes)
+ *   data            : buffers (limit * size bytes)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void dbf_init( dbf_t *dbf, unsigned limit, unsigned size, void *data );
+
+/******************************************************************************
+ *
+ * Name              : dbf_create
+ * Alias             : dbf_new
+ *
+ * Description       : create and initialize a new double buffer object
+ *
+ * Parameters
+ *   limit           : number of buffers (at least 2)
+ *   size            : size of a single buffer (in bytes)
+ *
+ * Return            : pointer to double buffer object (double buffer successfully created)
+ *   0               : double buffer not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *                     buffers allocated from the system heap are not aligned to the cache line
+ *
+ ******************************************************************************/
+
+dbf_t *dbf_create( unsigned limit, unsigned size );
+
+__STATIC_INLINE
+dbf_t *dbf_new( unsigned limit, unsigned size ) { return dbf_create(limit, size); }
+
+/******************************************************************************
+ *
+ * Name              : dbf_kill
+ *
+ * Description       : reset the double buffer object and wake up all waiting tasks with 'E_STOPPED' event value
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void dbf_kill( dbf_t *dbf );
+
+/******************************************************************************
+ *
+ * Name              : dbf_delete
+ *
+ * Description       : reset the double buffer object and free allocated resource
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void dbf_delete( dbf_t *dbf );
+
+/******************************************************************************
+ *
+ * Name              : dbf_active
+ * ISR alias         : dbf_activeISR
+ *
+ * Description       : return the buffer being filled by the producer
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *
+ * Return            : pointer to the active buffer
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void *dbf_active( dbf_t *dbf ) { return dbf->data + dbf->fill * dbf->size; }
+
+__STATIC_INLINE
+void *dbf_activeISR( dbf_t *dbf ) { return dbf_active(dbf); }
+
+/******************************************************************************
+ *
+ * Name              : dbf_buffer
+ *
+ * Description       : return the buffer with the given index,
+ *                     e.g. to program both memory addresses of a double buffer mode DMA stream
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *   index           : index of the buffer (below the number of buffers)
+ *
+ * Return            : pointer to the buffer
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void *dbf_buffer( dbf_t *dbf, unsigned index ) { return dbf->data + index * dbf->size; }
+
+/******************************************************************************
+ *
+ * Name              : dbf_swap
+ * ISR alias         : dbf_swapISR
+ *
+ * Description       : pass the filled active buffer to the consumer and activate the next buffer,
+ *                     wake up the waiting task (if any) with the filled buffer
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *
+ * Return            : pointer to the new active buffer (to be filled by the producer)
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void *dbf_swap( dbf_t *dbf );
+
+__STATIC_INLINE
+void *dbf_swapISR( dbf_t *dbf ) { return dbf_swap(dbf); }
+
+/******************************************************************************
+ *
+ * Name              : dbf_waitFor
+ *
+ * Description       : try to take the oldest filled buffer from the double buffer object,
+ *                     wait for given duration of time while no buffer is filled
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *   data            : pointer to store the pointer to the filled buffer
+ *   delay           : duration of time (maximum number of ticks to wait while no buffer is filled)
+ *                     IMMEDIATE: don't wait if no buffer is filled
+ *                     INFINITE:  wait indefinitely while no buffer is filled
+ *
+ * Return
+ *   E_SUCCESS       : filled buffer was successfully taken
+ *   E_STOPPED       : double buffer object was killed before the specified timeout expired
+ *   E_TIMEOUT       : no buffer was filled before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned dbf_waitFor( dbf_t *dbf, void **data, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : dbf_waitUntil
+ *
+ * Description       : try to take the oldest filled buffer from the double buffer object,
+ *                     wait until given timepoint while no buffer is filled
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *   data            : pointer to store the pointer to the filled buffer
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : filled buffer was successfully taken
+ *   E_STOPPED       : double buffer object was killed before the specified timeout expired
+ *   E_TIMEOUT       : no buffer was filled before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned dbf_waitUntil( dbf_t *dbf, void **data, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : dbf_wait
+ *
+ * Description       : try to take the oldest filled buffer from the double buffer object,
+ *                     wait indefinitely while no buffer is filled
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *   data            : pointer to store the pointer to the filled buffer
+ *
+ * Return
+ *   E_SUCCESS       : filled buffer was successfully taken
+ *   E_STOPPED       : double buffer object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned dbf_wait( dbf_t *dbf, void **data ) { return dbf_waitFor(dbf, data, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : dbf_take
+ *
+ * Description       : try to take the oldest filled buffer from the double buffer object,
+ *                     don't wait if no buffer is filled
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *   data            : pointer to store the pointer to the filled buffer
+ *
+ * Return
+ *   E_SUCCESS       : filled buffer was successfully taken
+ *   E_TIMEOUT       : no buffer is filled
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned dbf_take( dbf_t *dbf, void **data );
+
+/******************************************************************************
+ *
+ * Name              : dbf_release
+ *
+ * Description       : return the oldest taken buffer to the double buffer object,
+ *                     so the producer can fill it again
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *   data            : pointer to the taken buffer
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     buffers must be released in the order they were taken
+ *
+ ******************************************************************************/
+
+void dbf_release( dbf_t *dbf, void *data );
+
+/******************************************************************************
+ *
+ * Name              : dbf_lost
+ * ISR alias         : dbf_lostISR
+ *
+ * Description       : return the number of overruns of the double buffer object
+ *
+ * Parameters
+ *   dbf             : pointer to double buffer object
+ *
+ * Return            : number of overruns
+ *
+ ******************************************************************************/
+
+unsigned dbf_lost( dbf_t *dbf );
+
+__STATIC_INLINE
+unsigned dbf_lostISR( dbf_t *dbf ) { return dbf_lost(dbf); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : DoubleBufferT<>
+ *
+ * Description       : create and initialize a double buffer object
+ *                     with buffers aligned to the cache line (if the port defines CACHE_LINE)
+ *
+ * Constructor parameters
+ *   limit           : number of buffers (at least 2)
+ *   size            : size of a single buffer (in bytes)
+ *
+ ******************************************************************************/
+
+template<unsigned limit_, unsigned size_>
+struct DoubleBufferT : public __dbf
+{
+	 DoubleBufferT( void ): __dbf _DBF_INIT(limit_, _DBF_SIZE(size_), data_) {}
+	~DoubleBufferT( void ) { assert(__dbf::queue == nullptr); }
+
+	DoubleBufferT( DoubleBufferT&& ) = delete;
+	DoubleBufferT( const DoubleBufferT& ) = delete;
+	DoubleBufferT& operator=( DoubleBufferT&& ) = delete;
+	DoubleBufferT& operator=( const DoubleBufferT& ) = delete;
+
+	void     kill     ( void )                       {        dbf_kill     (this);                }
+	void    *active   ( void )                       { return dbf_active   (this);                }
+	void    *activeISR( void )                       { return dbf_activeISR(this);                }
+	void    *buffer   ( unsigned _index )            { return dbf_buffer   (this, _index);        }
+	void    *swap     ( void )                       { return dbf_swap     (this);                }
+	void    *swapISR  ( void )                       { return dbf_swapISR  (this);                }
+	unsigned waitFor  ( void **_data, cnt_t _delay ) { return dbf_waitFor  (this, _data, _delay); }
+	unsigned waitUntil( void **_data, cnt_t _time )  { return dbf_waitUntil(this, _data, _time);  }
+	unsigned wait     ( void **_data )               { return dbf_wait     (this, _data);         }
+	unsigned take     ( void **_data )               { return dbf_take     (this, _data);         }
+	void     release  ( void  *_data )               {        dbf_release  (this, _data);         }
+	unsigned lost     ( void )                       { return dbf_lost     (this);                }
+	unsigned lostISR  ( void )                       { return dbf_lostISR  (this);                }
+
+	private:
+	char data_[limit_ * _DBF_SIZE(size_)] _DBF_ALIGNED;
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_DBF_H
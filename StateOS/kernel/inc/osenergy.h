@@ -0,0 +1,194 @@
+/******************************************************************************
+
+    @file    StateOS: osenergy.h
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_NRG_H
+#define __STATEOS_NRG_H
+
+#include "oskernel.h"
+#include "ostask.h"
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_ENERGY
+
+#define NRG_STATES      4 // number of recorded low-power states
+#define NRG_IDLE        0 // low-power state entered by the idle task with OS_TICKLESS_IDLE
+
+/******************************************************************************
+ *
+ * Name              : energy model calibration
+ *
+ ******************************************************************************/
+
+typedef struct __nrg nrg_t;
+
+struct __nrg
+{
+	uint32_t freq;               // frequency of the cpu cycle counter (Hz), not used with OS_CPU_SCALING
+	uint32_t cycle;              // dynamic energy of one cpu cycle (pJ)
+	uint32_t run;                // static power of the running cpu (uW)
+	uint32_t sleep[NRG_STATES];  // power of the cpu in low-power states (uW)
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : energy accounting
+ *
+ * Note              : every accounting of cpu cycles of a task (see OS_TASK_STATS) is converted into energy:
+ *                     cycles * (cycle + run / frequency), where the frequency is taken from the calibration
+ *                     or from port_cpu_frequency with OS_CPU_SCALING;
+ *                     time spent in low-power states is converted into energy: ticks * sleep[state] / OS_FREQUENCY,
+ *                     and charged to the idle task; with OS_TICKLESS_IDLE the idle task reports its sleep as state NRG_IDLE,
+ *                     deeper states managed by the application (sys_suspend / sys_resume) are reported with 'nrg_sleep';
+ *                     energy of interrupt handlers is charged to the interrupted task;
+ *                     sleep shorter than a system tick and sleep of the idle task without OS_TICKLESS_IDLE
+ *                     are charged as running
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ * Name              : nrg_calibrate
+ *
+ * Description       : set calibration constants of the energy model
+ *
+ * Parameters
+ *   cal             : pointer to the calibration constants (kept by reference), 0: energy accounting is stopped
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     call again after changing the constants, e.g. after changing the cpu voltage
+ *
+ ******************************************************************************/
+
+void nrg_calibrate( const nrg_t *cal );
+
+/******************************************************************************
+ *
+ * Name              : nrg_sleep
+ *
+ * Description       : charge the time spent in low-power state to the idle task
+ *
+ * Parameters
+ *   state           : low-power state (0 .. NRG_STATES-1)
+ *   ticks           : time spent in the low-power state (in system ticks)
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void nrg_sleep( unsigned state, cnt_t ticks );
+
+/******************************************************************************
+ *
+ * Name              : nrg_getTask
+ *
+ * Description       : return the estimated energy consumed by given task
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *
+ * Return            : energy consumed by the task (in picojoules)
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+uint64_t nrg_getTask( tsk_t *tsk );
+
+/******************************************************************************
+ *
+ * Name              : nrg_get
+ *
+ * Description       : return the estimated energy consumed by the current task
+ *
+ * Parameters        : none
+ *
+ * Return            : energy consumed by the current task (in picojoules)
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+uint64_t nrg_get( void ) { return nrg_getTask(System.cur); }
+
+/******************************************************************************
+ *
+ * Name              : nrg_reset
+ *
+ * Description       : clear the energy consumed by given task
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void nrg_reset( tsk_t *tsk );
+
+/******************************************************************************
+ *
+ * Name              : nrg_getState
+ *
+ * Description       : return the time spent in low-power state and its energy
+ *
+ * Parameters
+ *   state           : low-power state (0 .. NRG_STATES-1)
+ *   ticks           : pointer to the variable receiving the time spent in the state (in system ticks), may be 0
+ *
+ * Return            : energy consumed in the low-power state (in picojoules)
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+uint64_t nrg_getState( unsigned state, uint64_t *ticks );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//OS_TASK_ENERGY
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_NRG_H
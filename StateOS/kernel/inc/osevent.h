@@ -318,7 +318,7 @@ void evt_giveISR( evt_t *evt, unsigned event ) { evt_give(evt, event); }
 
 struct Event : public __evt
 {
-	 Event( void ): __evt _EVT_INIT() {}
+	constexpr Event( void ): __evt _EVT_INIT() {}
 	~Event( void ) { assert(__evt::queue == nullptr); }
 
 	void     kill     ( void )            {        evt_kill     (this);         }
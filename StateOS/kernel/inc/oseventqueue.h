@@ -55,7 +55,19 @@ struct __evq
 
 	unsigned head;  // first element to read from data buffer
 	unsigned tail;  // first element to write into data buffer
-	unsigned*data;  // data buffer
+	void   * data;  // data buffer
+	unsigned size;  // size of an element of data buffer (in bytes): sizeof(unsigned), 2 or 1
+	bool     over;  // overwrite mode: the oldest events are dropped when the event queue is full
+	unsigned drop;  // number of dropped events
+#if OS_EVQ_LOCKFREE
+	volatile
+	unsigned post;  // number of events written by the lock-free producer
+	volatile
+	unsigned done;  // number of written events counted in the queue
+	volatile
+	unsigned flag;  // event queue is waiting for the deferred service
+	evq_t  * link;  // next event queue waiting for the deferred service
+#endif
 };
 
 /******************************************************************************
@@ -74,7 +86,26 @@ struct __evq
  *
  ******************************************************************************/
 
-#define               _EVQ_INIT( _limit, _data ) { 0, 0, 0, _limit, 0, 0, _data }
+#define               _EVQ_INIT( _limit, _data ) { 0, 0, 0, _limit, 0, 0, _data, sizeof(unsigned), false, 0 }
+
+/******************************************************************************
+ *
+ * Name              : _EVQ_INIT_SIZE
+ *
+ * Description       : create and initialize an event queue object with elements of the given size
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored events)
+ *   data            : event queue data buffer
+ *   size            : size of an element of data buffer (in bytes): sizeof(unsigned), 2 or 1
+ *
+ * Return            : event queue object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _EVQ_INIT_SIZE( _limit, _data, _size ) { 0, 0, 0, _limit, 0, 0, _data, _size, false, 0 }
 
 /******************************************************************************
  *
@@ -108,7 +139,7 @@ struct __evq
  ******************************************************************************/
 
 #define             OS_EVQ( evq, limit )                                \
-                       unsigned evq##__buf[limit];                       \
+           __OS_NOINIT unsigned evq##__buf[limit];                       \
                        evq_t evq##__evq = _EVQ_INIT( limit, evq##__buf ); \
                        evq_id evq = & evq##__evq
 
@@ -125,10 +156,50 @@ struct __evq
  ******************************************************************************/
 
 #define         static_EVQ( evq, limit )                                \
-                static unsigned evq##__buf[limit];                       \
+    static __OS_NOINIT unsigned evq##__buf[limit];                       \
                 static evq_t evq##__evq = _EVQ_INIT( limit, evq##__buf ); \
                 static evq_id evq = & evq##__evq
 
+/******************************************************************************
+ *
+ * Name              : OS_EVQ_TYPE
+ *
+ * Description       : define and initialize an event queue object with elements of the given type
+ *
+ * Parameters
+ *   evq             : name of a pointer to event queue object
+ *   limit           : size of a queue (max number of stored events)
+ *   type            : type of an element of data buffer: unsigned, uint16_t or uint8_t
+ *
+ * Note              : events are truncated to the size of the element
+ *
+ ******************************************************************************/
+
+#define             OS_EVQ_TYPE( evq, limit, type )                                     \
+           __OS_NOINIT type evq##__buf[limit];                                           \
+                       evq_t evq##__evq = _EVQ_INIT_SIZE( limit, evq##__buf, sizeof(type) ); \
+                       evq_id evq = & evq##__evq
+
+/******************************************************************************
+ *
+ * Name              : static_EVQ_TYPE
+ *
+ * Description       : define and initialize a static event queue object with elements of the given type
+ *
+ * Parameters
+ *   evq             : name of a pointer to event queue object
+ *   limit           : size of a queue (max number of stored events)
+ *   type            : type of an element of data buffer: unsigned, uint16_t or uint8_t
+ *
+ * Note              : events are truncated to the size of the element
+ *
+ ******************************************************************************/
+
+#define         static_EVQ_TYPE( evq, limit, type )                                     \
+    static __OS_NOINIT type evq##__buf[limit];                                           \
+                static evq_t evq##__evq = _EVQ_INIT_SIZE( limit, evq##__buf, sizeof(type) ); \
+                static evq_id evq = & evq##__evq
+
 /******************************************************************************
  *
  * Name              : EVQ_INIT
@@ -191,6 +262,27 @@ struct __evq
 
 void evq_init( evq_t *evq, unsigned limit, unsigned *data );
 
+/******************************************************************************
+ *
+ * Name              : evq_initSize
+ *
+ * Description       : initialize an event queue object with elements of the given size
+ *
+ * Parameters
+ *   evq             : pointer to event queue object
+ *   limit           : size of a queue (max number of stored events)
+ *   data            : event queue data buffer (limit * size bytes)
+ *   size            : size of an element of data buffer (in bytes): sizeof(unsigned), 2 or 1
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     events are truncated to the size of the element
+ *
+ ******************************************************************************/
+
+void evq_initSize( evq_t *evq, unsigned limit, void *data, unsigned size );
+
 /******************************************************************************
  *
  * Name              : evq_create
@@ -213,6 +305,26 @@ evq_t *evq_create( unsigned limit );
 __STATIC_INLINE
 evq_t *evq_new( unsigned limit ) { return evq_create(limit); }
 
+/******************************************************************************
+ *
+ * Name              : evq_createSize
+ *
+ * Description       : create and initialize a new event queue object with elements of the given size
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored events)
+ *   size            : size of an element of data buffer (in bytes): sizeof(unsigned), 2 or 1
+ *
+ * Return            : pointer to event queue object (event queue successfully created)
+ *   0               : event queue not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *                     events are truncated to the size of the element
+ *
+ ******************************************************************************/
+
+evq_t *evq_createSize( unsigned limit, unsigned size );
+
 /******************************************************************************
  *
  * Name              : evq_kill
@@ -314,6 +426,34 @@ unsigned evq_waitUntil( evq_t *evq, cnt_t time );
 __STATIC_INLINE
 unsigned evq_wait( evq_t *evq ) { return evq_waitFor(evq, INFINITE); }
 
+/******************************************************************************
+ *
+ * Name              : evq_waitN
+ *
+ * Description       : try to transfer up to 'max' event data from the event queue object,
+ *                     wait for given duration of time while the event queue object is empty,
+ *                     then drain the event queue object and release all waiting senders in one critical section
+ *
+ * Parameters
+ *   evq             : pointer to event queue object
+ *   data            : pointer to store event data (array of 'max' elements)
+ *   max             : max number of event data to transfer
+ *   got             : pointer to store the number of transfered event data (may be 0)
+ *   delay           : duration of time (maximum number of ticks to wait while the event queue object is empty)
+ *                     IMMEDIATE: don't wait if the event queue object is empty
+ *                     INFINITE:  wait indefinitely while the event queue object is empty
+ *
+ * Return
+ *   E_SUCCESS       : at least one event data was successfully transfered from the event queue object
+ *   E_STOPPED       : event queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : event queue object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned evq_waitN( evq_t *evq, unsigned *data, unsigned max, unsigned *got, cnt_t delay );
+
 /******************************************************************************
  *
  * Name              : evq_take
@@ -458,6 +598,70 @@ unsigned evq_push( evq_t *evq, unsigned event );
 __STATIC_INLINE
 unsigned evq_pushISR( evq_t *evq, unsigned event ) { return evq_push(evq, event); }
 
+/******************************************************************************
+ *
+ * Name              : evq_setOverwrite
+ *
+ * Description       : set overwrite mode of the event queue object,
+ *                     in overwrite mode 'evq_give' and 'evq_send' never block nor fail for lack of space,
+ *                     they remove the oldest events (as 'evq_push') when the event queue object is full
+ *
+ * Parameters
+ *   evq             : pointer to event queue object
+ *   enable          : true: overwrite mode, false: normal mode
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     should be set after initialization, before the event queue object is used
+ *                     events posted by the lock-free 'evq_postISR' are not affected
+ *
+ ******************************************************************************/
+
+void evq_setOverwrite( evq_t *evq, bool enable );
+
+/******************************************************************************
+ *
+ * Name              : evq_dropped
+ *
+ * Description       : return the number of events removed from the event queue object to make space for new ones
+ *
+ * Parameters
+ *   evq             : pointer to event queue object
+ *
+ * Return            : number of dropped events
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned evq_dropped( evq_t *evq );
+
+/******************************************************************************
+ *
+ * Name              : evq_postISR
+ *
+ * Description       : try to transfer event data to the event queue object without masking interrupts,
+ *                     if the task is waiting on the event queue object, it will be woken up from the context switch handler
+ *
+ * Parameters
+ *   evq             : pointer to event queue object
+ *   event           : event value
+ *
+ * Return
+ *   E_SUCCESS       : event data was successfully transfered to the event queue object
+ *   E_TIMEOUT       : event queue object is full, try again
+ *
+ * Note              : use only in handler mode, available when OS_EVQ_LOCKFREE is set
+ *                     only one interrupt handler can write to the event queue object
+ *                     and the event queue object must not be written by any other function
+ *
+ ******************************************************************************/
+
+#if OS_EVQ_LOCKFREE
+unsigned evq_postISR( evq_t *evq, unsigned event );
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -474,19 +678,24 @@ unsigned evq_pushISR( evq_t *evq, unsigned event ) { return evq_push(evq, event)
  *
  * Constructor parameters
  *   limit           : size of a queue (max number of stored events)
+ *   T               : (optional) type of an element of data buffer: unsigned (default), uint16_t or uint8_t
+ *                     events are truncated to the size of the element
  *
  ******************************************************************************/
 
-template<unsigned limit_>
+template<unsigned limit_, class T = unsigned>
 struct EventQueueT : public __evq
 {
-	 EventQueueT( void ): __evq _EVQ_INIT(limit_, data_) {}
+	static_assert(sizeof(T) == sizeof(unsigned) || sizeof(T) == 2 || sizeof(T) == 1, "unsupported size of an event queue element");
+
+	 EventQueueT( void ): __evq _EVQ_INIT_SIZE(limit_, data_, sizeof(T)) {}
 	~EventQueueT( void ) { assert(__evq::queue == nullptr); }
 
 	void     kill     ( void )                          {        evq_kill     (this);                 }
 	unsigned waitFor  (                  cnt_t _delay ) { return evq_waitFor  (this,         _delay); }
 	unsigned waitUntil(                  cnt_t _time )  { return evq_waitUntil(this,         _time);  }
 	unsigned wait     ( void )                          { return evq_wait     (this);                 }
+	unsigned waitN    ( unsigned *_data, unsigned _max, unsigned *_got, cnt_t _delay ) { return evq_waitN(this, _data, _max, _got, _delay); }
 	unsigned take     ( void )                          { return evq_take     (this);                 }
 	unsigned takeISR  ( void )                          { return evq_takeISR  (this);                 }
 	unsigned sendFor  ( unsigned _event, cnt_t _delay ) { return evq_sendFor  (this, _event, _delay); }
@@ -496,9 +705,14 @@ struct EventQueueT : public __evq
 	unsigned giveISR  ( unsigned _event )               { return evq_giveISR  (this, _event);         }
 	unsigned push     ( unsigned _event )               { return evq_push     (this, _event);         }
 	unsigned pushISR  ( unsigned _event )               { return evq_pushISR  (this, _event);         }
+	void     setOverwrite( bool _enable )               {        evq_setOverwrite(this, _enable);     }
+	unsigned dropped  ( void )                          { return evq_dropped  (this);                 }
+#if OS_EVQ_LOCKFREE
+	unsigned postISR  ( unsigned _event )               { return evq_postISR  (this, _event);         }
+#endif
 
 	private:
-	unsigned data_[limit_];
+	T data_[limit_];
 };
 
 #endif//__cplusplus
@@ -0,0 +1,128 @@
+/******************************************************************************
+
+    @file    StateOS: osexecutive.h
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_TTE_H
+#define __STATEOS_TTE_H
+
+#include "oskernel.h"
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TIME_TRIGGER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : time-triggered executive
+ *
+ * Note              : the major frame is a static table of activities repeated cyclically;
+ *                     each activity is released at its offset and then every period within the major frame,
+ *                     releases are timed by the system timer (the hardware timer compare in tick-less mode),
+ *                     activities released at the same offset are executed in the order of the table,
+ *                     run-to-completion by the system timer handler, with the kernel locked;
+ *                     the ready queue is not used by the executive, tasks are scheduled by priority
+ *                     in the slack between the releases; an activity can release a task
+ *                     with an object or the task notification (ISR functions)
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ * Name              : tte_start
+ *
+ * Description       : start the major frame of the time-triggered executive from the current time
+ *
+ * Parameters
+ *   tab             : pointer to the table of activities (may be placed in flash), each activity:
+ *                     fun:    activity procedure
+ *                     offset: first release within the major frame (in ticks)
+ *                     period: release period within the major frame (in ticks), 0: released once per major frame
+ *   cnt             : number of activities in the table
+ *   frame           : duration of the major frame (in ticks)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     the table is used by the executive until 'tte_stop' or the next 'tte_start'
+ *
+ ******************************************************************************/
+
+void tte_start( const tta_t *tab, unsigned cnt, cnt_t frame );
+
+/******************************************************************************
+ *
+ * Name              : tte_stop
+ *
+ * Description       : stop the time-triggered executive, no more activities are released
+ *
+ * Parameters        : none
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void tte_stop( void );
+
+/******************************************************************************
+ *
+ * Name              : tte_late
+ * ISR alias         : tte_lateISR
+ *
+ * Description       : get the number of releases dispatched after their release time
+ *                     (the system timer handler was delayed, e.g. by a critical section or the previous activities)
+ *
+ * Parameters        : none
+ *
+ * Return            : number of late releases since the system start
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned tte_late( void );
+
+__STATIC_INLINE
+unsigned tte_lateISR( void ) { return tte_late(); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//OS_TIME_TRIGGER
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_TTE_H
@@ -296,6 +296,7 @@ unsigned mut_wait( mut_t *mut ) { return mut_waitFor(mut, INFINITE); }
  *   E_TIMEOUT       : fast mutex object can't be locked immediately
  *
  * Note              : use only in thread mode
+ *                     with OS_MUT_LOCKFREE it does not enter a critical section when the fast mutex is free
  *
  ******************************************************************************/
 
@@ -317,6 +318,7 @@ unsigned mut_take( mut_t *mut ) { return mut_waitFor(mut, IMMEDIATE); }
  *   E_TIMEOUT       : fast mutex object can't be unlocked
  *
  * Note              : use only in thread mode
+ *                     with OS_MUT_LOCKFREE it does not enter a critical section when no task is waiting
  *
  ******************************************************************************/
 
@@ -343,7 +345,7 @@ unsigned mut_give( mut_t *mut );
 
 struct FastMutex : public __mut
 {
-	 FastMutex( void ): __mut _MUT_INIT() {}
+	constexpr FastMutex( void ): __mut _MUT_INIT() {}
 	~FastMutex( void ) { assert(__mut::owner == nullptr); }
 
 	void     kill     ( void )         {        mut_kill     (this);         }
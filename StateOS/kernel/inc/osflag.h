@@ -64,6 +64,7 @@ struct __flg
 	tsk_t  * queue; // next process in the DELAYED queue
 	void   * res;   // allocated flag object's resource
 	unsigned flags; // flag's current value
+	unsigned wait;  // union of flags awaited by the tasks in the DELAYED queue (may contain flags no longer awaited)
 };
 
 /******************************************************************************
@@ -81,7 +82,7 @@ struct __flg
  *
  ******************************************************************************/
 
-#define               _FLG_INIT( init ) { 0, 0, init }
+#define               _FLG_INIT( init ) { 0, 0, init, 0 }
 
 /******************************************************************************
  *
@@ -374,6 +375,7 @@ unsigned flg_takeISR( flg_t *flg, unsigned flags, unsigned mode ) { return flg_t
  * Return            : flags in flag object after setting
  *
  * Note              : may be used both in thread and handler mode
+ *                     with OS_FLG_LOCKFREE it does not enter a critical section when no task is waiting
  *
  ******************************************************************************/
 
@@ -425,7 +427,7 @@ unsigned flg_clearISR( flg_t *flg, unsigned flags ) { return flg_clear(flg, flag
 
 struct Flag : public __flg
 {
-	 Flag( const unsigned _init = 0 ): __flg _FLG_INIT(_init) {}
+	constexpr Flag( const unsigned _init = 0 ): __flg _FLG_INIT(_init) {}
 	~Flag( void ) { assert(__flg::queue == nullptr); }
 
 	void     kill     ( void )                                          {        flg_kill     (this);                        }
@@ -0,0 +1,286 @@
+/******************************************************************************
+
+    @file    StateOS: osforkjoin.h
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_GRP_H
+#define __STATEOS_GRP_H
+
+#include "oskernel.h"
+#include "ossemaphore.h"
+#include "osworkerpool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : fork/join group
+ *
+ * Note              : the index range of a parallel loop is split into chunks of 'grain' indexes,
+ *                     helper jobs queued to the worker pool object and the forking task
+ *                     claim the next unprocessed chunk until the whole range is done,
+ *                     so idle workers take over the remaining work of the busy ones,
+ *                     the joining task executes the jobs of the worker pool object while waiting
+ *
+ ******************************************************************************/
+
+typedef struct __grp grp_t, * const grp_id;
+
+typedef void grf_t( void *ctx, unsigned begin, unsigned end ); // loop body executed for indexes [begin, end)
+
+struct __grp
+{
+	sem_t    sem;   // signalled when the last helper job of the group is finished
+	wpl_t  * wpl;   // worker pool object executing helper jobs
+	grf_t  * fun;   // loop body
+	void   * ctx;   // argument passed to the loop body
+	unsigned next;  // first index of the next unclaimed chunk
+	unsigned end;   // end of the index range
+	unsigned grain; // number of indexes in a chunk
+	unsigned count; // number of queued or running helper jobs
+};
+
+/******************************************************************************
+ *
+ * Name              : _GRP_INIT
+ *
+ * Description       : create and initialize a fork/join group
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object executing helper jobs
+ *
+ * Return            : fork/join group
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _GRP_INIT( _wpl ) { _SEM_INIT( 0, semBinary ), _wpl, 0, 0, 0, 0, 0, 0 }
+
+/******************************************************************************
+ *
+ * Name              : OS_GRP
+ *
+ * Description       : define and initialize a fork/join group
+ *
+ * Parameters
+ *   grp             : name of a pointer to fork/join group
+ *   wpl             : pointer to worker pool object executing helper jobs
+ *
+ ******************************************************************************/
+
+#define             OS_GRP( grp, wpl )                     \
+                       grp_t grp##__grp = _GRP_INIT( wpl ); \
+                       grp_id grp = & grp##__grp
+
+/******************************************************************************
+ *
+ * Name              : static_GRP
+ *
+ * Description       : define and initialize a static fork/join group
+ *
+ * Parameters
+ *   grp             : name of a pointer to fork/join group
+ *   wpl             : pointer to worker pool object executing helper jobs
+ *
+ ******************************************************************************/
+
+#define         static_GRP( grp, wpl )                     \
+                static grp_t grp##__grp = _GRP_INIT( wpl ); \
+                static grp_id grp = & grp##__grp
+
+/******************************************************************************
+ *
+ * Name              : GRP_INIT
+ *
+ * Description       : create and initialize a fork/join group
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object executing helper jobs
+ *
+ * Return            : fork/join group
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                GRP_INIT( wpl ) \
+                      _GRP_INIT( wpl )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : GRP_CREATE
+ * Alias             : GRP_NEW
+ *
+ * Description       : create and initialize a fork/join group
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object executing helper jobs
+ *
+ * Return            : pointer to fork/join group
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                GRP_CREATE( wpl ) \
+           (grp_t[]) { GRP_INIT  ( wpl ) }
+#define                GRP_NEW \
+                       GRP_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : grp_init
+ *
+ * Description       : initialize a fork/join group
+ *
+ * Parameters
+ *   grp             : pointer to fork/join group
+ *   wpl             : pointer to worker pool object executing helper jobs
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void grp_init( grp_t *grp, wpl_t *wpl );
+
+/******************************************************************************
+ *
+ * Name              : grp_fork
+ *
+ * Description       : start the parallel loop: split indexes [begin, end) into chunks
+ *                     and queue helper jobs to the worker pool object (one per worker task, at most one per chunk),
+ *                     helper jobs that do not fit in the queue of the worker pool object are skipped
+ *
+ * Parameters
+ *   grp             : pointer to fork/join group
+ *   begin           : first index of the loop
+ *   end             : end of the index range (first index past the loop)
+ *   grain           : number of indexes in a chunk (0: one index)
+ *   fun             : loop body
+ *   ctx             : argument passed to the loop body
+ *
+ * Return            : number of queued helper jobs
+ *
+ * Note              : use only in thread mode
+ *                     the previous loop of the group must be joined
+ *
+ ******************************************************************************/
+
+unsigned grp_fork( grp_t *grp, unsigned begin, unsigned end, unsigned grain, grf_t *fun, void *ctx );
+
+/******************************************************************************
+ *
+ * Name              : grp_join
+ *
+ * Description       : participate in the parallel loop until all chunks are claimed,
+ *                     then execute jobs of the worker pool object or wait until all helper jobs are finished
+ *
+ * Parameters
+ *   grp             : pointer to fork/join group
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, in the task that forked the loop
+ *
+ ******************************************************************************/
+
+void grp_join( grp_t *grp );
+
+/******************************************************************************
+ *
+ * Name              : par_for
+ *
+ * Description       : execute the loop body for indexes [begin, end) in parallel
+ *                     by the worker tasks of the worker pool object and the current task
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object executing helper jobs
+ *   begin           : first index of the loop
+ *   end             : end of the index range (first index past the loop)
+ *   grain           : number of indexes in a chunk (0: one index)
+ *   fun             : loop body
+ *   ctx             : argument passed to the loop body
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     not to be used by the worker tasks of the same worker pool object
+ *                     if the current task may be the only one executing its jobs
+ *
+ ******************************************************************************/
+
+void par_for( wpl_t *wpl, unsigned begin, unsigned end, unsigned grain, grf_t *fun, void *ctx );
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : ForkJoinGroup
+ *
+ * Description       : create and initialize a fork/join group
+ *
+ * Constructor parameters
+ *   wpl             : pointer to worker pool object executing helper jobs
+ *
+ ******************************************************************************/
+
+struct ForkJoinGroup : public __grp
+{
+	 ForkJoinGroup( wpl_t *_wpl ): __grp _GRP_INIT(_wpl) {}
+	~ForkJoinGroup( void ) { assert(__grp::count == 0); }
+
+	ForkJoinGroup( ForkJoinGroup&& ) = delete;
+	ForkJoinGroup( const ForkJoinGroup& ) = delete;
+	ForkJoinGroup& operator=( ForkJoinGroup&& ) = delete;
+	ForkJoinGroup& operator=( const ForkJoinGroup& ) = delete;
+
+	unsigned fork( unsigned _begin, unsigned _end, unsigned _grain, grf_t *_fun, void *_ctx ) { return grp_fork(this, _begin, _end, _grain, _fun, _ctx); }
+	void     join( void ) { grp_join(this); }
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_GRP_H
@@ -0,0 +1,273 @@
+/******************************************************************************
+
+    @file    StateOS: osidlehook.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_IDH_H
+#define __STATEOS_IDH_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : idle hook
+ *
+ * Note              : idle hook is a background procedure (stack scanning, deferred frees, log formatting,
+ *                     flash wear-levelling) executed by the idle task, without a dedicated task and its stack;
+ *                     in every pass the idle task serves one pending hook of the highest priority
+ *                     (hooks of equal priority are served round-robin) and then goes to sleep;
+ *                     the hook is called repeatedly while it reports pending work and its cycle budget is not exhausted,
+ *                     the hook is pending when started and when signalled with 'idh_signal',
+ *                     the idle task goes to sleep immediately (and may suppress system timer interrupts
+ *                     in the low power mode, OS_TICKLESS_IDLE) when no hook is pending
+ *
+ ******************************************************************************/
+
+typedef bool idf_t( void *arg ); // hook procedure, return true if work is still pending
+
+typedef struct __idh idh_t, * const idh_id;
+
+struct __idh
+{
+	idh_t  * next;   // next hook in the registry of started hooks (ordered by priority)
+	idf_t  * fun;    // hook procedure
+	void   * arg;    // argument of the hook procedure
+	unsigned prio;   // priority of the hook
+	uint32_t budget; // cycle budget: max number of cpu cycles spent in the hook in one pass of the idle task
+	volatile
+	bool     pend;   // the hook has work pending
+	bool     run;    // the hook is started (registered)
+};
+
+/******************************************************************************
+ *
+ * Name              : _IDH_INIT
+ *
+ * Description       : create and initialize an idle hook object
+ *
+ * Parameters
+ *   prio            : priority of the hook
+ *   fun             : hook procedure, returns true if work is still pending
+ *   arg             : argument of the hook procedure
+ *   budget          : cycle budget (see idh_init)
+ *
+ * Return            : idle hook object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _IDH_INIT( _prio, _fun, _arg, _budget ) { 0, _fun, _arg, _prio, _budget, false, false }
+
+/******************************************************************************
+ *
+ * Name              : OS_IDH
+ *
+ * Description       : define and initialize an idle hook object
+ *
+ * Parameters
+ *   idh             : name of a pointer to idle hook object
+ *   prio            : priority of the hook
+ *   fun             : hook procedure, returns true if work is still pending
+ *   arg             : argument of the hook procedure
+ *   budget          : cycle budget (see idh_init)
+ *
+ ******************************************************************************/
+
+#define             OS_IDH( idh, prio, fun, arg, budget )                       \
+                       idh_t idh##__idh = _IDH_INIT( prio, fun, arg, budget );   \
+                       idh_id idh = & idh##__idh
+
+/******************************************************************************
+ *
+ * Name              : static_IDH
+ *
+ * Description       : define and initialize a static idle hook object
+ *
+ * Parameters
+ *   idh             : name of a pointer to idle hook object
+ *   prio            : priority of the hook
+ *   fun             : hook procedure, returns true if work is still pending
+ *   arg             : argument of the hook procedure
+ *   budget          : cycle budget (see idh_init)
+ *
+ ******************************************************************************/
+
+#define         static_IDH( idh, prio, fun, arg, budget )                       \
+                static idh_t idh##__idh = _IDH_INIT( prio, fun, arg, budget );   \
+                static idh_id idh = & idh##__idh
+
+/******************************************************************************
+ *
+ * Name              : idh_init
+ *
+ * Description       : initialize an idle hook object
+ *
+ * Parameters
+ *   idh             : pointer to idle hook object
+ *   prio            : priority of the hook
+ *   fun             : hook procedure, returns true if work is still pending
+ *   arg             : argument of the hook procedure
+ *   budget          : cycle budget: max number of cpu cycles spent in the hook in one pass of the idle task,
+ *                     the hook is called again while it returns true and the budget is not exhausted
+ *                     0: the hook is called once per pass of the idle task
+ *                     the budget is ignored (the hook is called once per pass) if the port has no cycle counter
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     the hook procedure is executed by the idle task: it must not block
+ *
+ ******************************************************************************/
+
+void idh_init( idh_t *idh, unsigned prio, idf_t *fun, void *arg, uint32_t budget );
+
+/******************************************************************************
+ *
+ * Name              : idh_start
+ *
+ * Description       : add the idle hook object to the registry of the idle task,
+ *                     the hook is pending after start
+ *
+ * Parameters
+ *   idh             : pointer to idle hook object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void idh_start( idh_t *idh );
+
+/******************************************************************************
+ *
+ * Name              : idh_stop
+ *
+ * Description       : remove the idle hook object from the registry of the idle task
+ *
+ * Parameters
+ *   idh             : pointer to idle hook object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     the hook procedure preempted by the calling task is executed to completion
+ *
+ ******************************************************************************/
+
+void idh_stop( idh_t *idh );
+
+/******************************************************************************
+ *
+ * Name              : idh_signal
+ * ISR alias         : idh_signalISR
+ *
+ * Description       : mark the idle hook as pending (new work for the hook),
+ *                     the hook will be called when the system is idle
+ *
+ * Parameters
+ *   idh             : pointer to idle hook object
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void idh_signal( idh_t *idh );
+
+__STATIC_INLINE
+void idh_signalISR( idh_t *idh ) { idh_signal(idh); }
+
+/******************************************************************************
+ *
+ * Name              : idh_pending
+ * ISR alias         : idh_pendingISR
+ *
+ * Description       : check if the idle hook has work pending
+ *
+ * Parameters
+ *   idh             : pointer to idle hook object
+ *
+ * Return            : true if the hook is pending
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+bool idh_pending( idh_t *idh );
+
+__STATIC_INLINE
+bool idh_pendingISR( idh_t *idh ) { return idh_pending(idh); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : IdleHook
+ *
+ * Description       : create and initialize an idle hook object
+ *
+ * Constructor parameters
+ *   prio            : priority of the hook
+ *   fun             : hook procedure, returns true if work is still pending
+ *   arg             : argument of the hook procedure
+ *   budget          : cycle budget (see idh_init)
+ *
+ ******************************************************************************/
+
+struct IdleHook : public __idh
+{
+	 IdleHook( unsigned _prio, idf_t *_fun, void *_arg = nullptr, uint32_t _budget = 0 ): __idh _IDH_INIT(_prio, _fun, _arg, _budget) {}
+	~IdleHook( void ) { assert(__idh::run == false); }
+
+	void     start     ( void )          {        idh_start     (this);        }
+	void     stop      ( void )          {        idh_stop      (this);        }
+	void     signal    ( void )          {        idh_signal    (this);        }
+	void     signalISR ( void )          {        idh_signalISR (this);        }
+	bool     pending   ( void )          { return idh_pending   (this);        }
+	bool     pendingISR( void )          { return idh_pendingISR(this);        }
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_IDH_H
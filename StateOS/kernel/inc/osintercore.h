@@ -0,0 +1,417 @@
+/******************************************************************************
+
+    @file    StateOS: osintercore.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_ICC_H
+#define __STATEOS_ICC_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : inter-core channel
+ *                     single producer / single consumer queue of fixed-size messages between two cores
+ *                     running independent images of the system, e.g. cortex-m7 and cortex-m4 of a dual-core uC
+ *                     the ring is placed in memory shared by both cores, each core defines its own channel object;
+ *                     the producer rings the doorbell (e.g. hardware semaphore interrupt) of the consumer core
+ *                     after publishing a message, the doorbell interrupt handler resumes the waiting consumer task
+ *                     data cache lines of the ring are maintained if the port provides port_cache_clean
+ *                     and port_cache_invalidate (CACHE_LINE defined), e.g. STM32F7 port
+ *
+ ******************************************************************************/
+
+#define _ICC_LINE            32 // common cache line size: the shared layout must be the same on both cores
+
+#if defined(CACHE_LINE) && CACHE_LINE > _ICC_LINE
+#error  CACHE_LINE is greater than the line of the shared ring of inter-core channel!
+#endif
+
+#define _ICC_ROUND( _size ) (((_size) + _ICC_LINE - 1) & ~(_ICC_LINE - 1))
+
+typedef struct __icr icr_t;
+
+struct __icr    // shared ring, must be aligned to _ICC_LINE
+{
+	volatile
+	unsigned head;  // free-running index of the first message to read, updated only by the consumer core
+	char     hpad[_ICC_LINE - sizeof(unsigned)];
+	volatile
+	unsigned tail;  // free-running index of the first message to write, updated only by the producer core
+	char     tpad[_ICC_LINE - sizeof(unsigned)];
+};
+
+typedef struct __icc icc_t, * const icc_id;
+
+struct __icc
+{
+	tsk_t  * queue; // the consumer waiting for messages
+	void   * res;   // always 0 (the shared ring is not allocated)
+	icr_t  * ring;  // shared ring followed by the message slots
+	unsigned mask;  // number of message slots - 1 (number of slots is a power of 2)
+	unsigned size;  // size of a message (in bytes)
+	unsigned slot;  // size of a message slot (message size rounded up to the cache line)
+	fun_t  * bell;  // doorbell procedure: triggers the doorbell interrupt of the other core
+};
+
+/******************************************************************************
+ *
+ * Name              : ICC_SHARED
+ *
+ * Description       : size of the shared memory of an inter-core channel
+ *
+ * Parameters
+ *   limit           : number of message slots, must be a power of 2
+ *   size            : size of a message (in bytes)
+ *
+ * Return            : size of the shared memory (in bytes)
+ *
+ ******************************************************************************/
+
+#define                ICC_SHARED( limit, size ) \
+                       ( sizeof(icr_t) + (limit) * _ICC_ROUND(size) )
+
+/******************************************************************************
+ *
+ * Name              : _ICC_INIT
+ *
+ * Description       : create and initialize an inter-core channel object
+ *
+ * Parameters
+ *   ring            : address of the shared memory (ICC_SHARED bytes), aligned to _ICC_LINE
+ *   limit           : number of message slots, must be a power of 2
+ *   size            : size of a message (in bytes)
+ *   bell            : doorbell procedure of the producer (0 on the consumer core)
+ *
+ * Return            : inter-core channel object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _ICC_INIT( _ring, _limit, _size, _bell ) { 0, 0, (icr_t *)(_ring), (_limit) - 1, _size, _ICC_ROUND(_size), _bell }
+
+/******************************************************************************
+ *
+ * Name              : OS_ICC
+ *
+ * Description       : define and initialize an inter-core channel object
+ *
+ * Parameters
+ *   icc             : name of a pointer to inter-core channel object
+ *   ring            : address of the shared memory (ICC_SHARED bytes), aligned to _ICC_LINE
+ *   limit           : number of message slots, must be a power of 2
+ *   size            : size of a message (in bytes)
+ *   bell            : doorbell procedure of the producer (0 on the consumer core)
+ *
+ * Note              : both cores must use the same ring address, limit and size
+ *
+ ******************************************************************************/
+
+#define             OS_ICC( icc, ring, limit, size, bell )                        \
+                       icc_t icc##__icc = _ICC_INIT( ring, limit, size, bell ); \
+                       icc_id icc = & icc##__icc
+
+/******************************************************************************
+ *
+ * Name              : static_ICC
+ *
+ * Description       : define and initialize a static inter-core channel object
+ *
+ * Parameters
+ *   icc             : name of a pointer to inter-core channel object
+ *   ring            : address of the shared memory (ICC_SHARED bytes), aligned to _ICC_LINE
+ *   limit           : number of message slots, must be a power of 2
+ *   size            : size of a message (in bytes)
+ *   bell            : doorbell procedure of the producer (0 on the consumer core)
+ *
+ * Note              : look at OS_ICC
+ *
+ ******************************************************************************/
+
+#define         static_ICC( icc, ring, limit, size, bell )                        \
+                static icc_t icc##__icc = _ICC_INIT( ring, limit, size, bell ); \
+                static icc_id icc = & icc##__icc
+
+/******************************************************************************
+ *
+ * Name              : icc_init
+ *
+ * Description       : initialize an inter-core channel object
+ *
+ * Parameters
+ *   icc             : pointer to inter-core channel object
+ *   ring            : address of the shared memory (ICC_SHARED bytes), aligned to _ICC_LINE
+ *   limit           : number of message slots, must be a power of 2
+ *   size            : size of a message (in bytes)
+ *   bell            : doorbell procedure of the producer (0 on the consumer core)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     the shared ring is not modified, look at icc_clear
+ *
+ ******************************************************************************/
+
+void icc_init( icc_t *icc, void *ring, unsigned limit, unsigned size, fun_t *bell );
+
+/******************************************************************************
+ *
+ * Name              : icc_clear
+ *
+ * Description       : reset the shared ring of the inter-core channel
+ *
+ * Parameters
+ *   icc             : pointer to inter-core channel object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, only on one core
+ *                     before the other core starts using the channel
+ *
+ ******************************************************************************/
+
+void icc_clear( icc_t *icc );
+
+/******************************************************************************
+ *
+ * Name              : icc_waitFor
+ *
+ * Description       : try to transfer a message from the inter-core channel,
+ *                     wait for given duration of time while the channel is empty
+ *
+ * Parameters
+ *   icc             : pointer to inter-core channel object
+ *   data            : pointer to store the message
+ *   delay           : duration of time (maximum number of ticks to wait while the channel is empty)
+ *                     IMMEDIATE: don't wait if the channel is empty
+ *                     INFINITE:  wait indefinitely while the channel is empty
+ *
+ * Return
+ *   E_SUCCESS       : message was successfully transferred from the channel
+ *   E_STOPPED       : the waiting task was resumed with tsk_resume
+ *   E_TIMEOUT       : channel object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode, only on the consumer core
+ *                     critical section is entered only when the channel is empty
+ *
+ ******************************************************************************/
+
+unsigned icc_waitFor( icc_t *icc, void *data, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : icc_waitUntil
+ *
+ * Description       : try to transfer a message from the inter-core channel,
+ *                     wait until given timepoint while the channel is empty
+ *
+ * Parameters
+ *   icc             : pointer to inter-core channel object
+ *   data            : pointer to store the message
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : message was successfully transferred from the channel
+ *   E_STOPPED       : the waiting task was resumed with tsk_resume
+ *   E_TIMEOUT       : channel object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode, only on the consumer core
+ *                     critical section is entered only when the channel is empty
+ *
+ ******************************************************************************/
+
+unsigned icc_waitUntil( icc_t *icc, void *data, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : icc_wait
+ *
+ * Description       : try to transfer a message from the inter-core channel,
+ *                     wait indefinitely while the channel is empty
+ *
+ * Parameters
+ *   icc             : pointer to inter-core channel object
+ *   data            : pointer to store the message
+ *
+ * Return
+ *   E_SUCCESS       : message was successfully transferred from the channel
+ *   E_STOPPED       : the waiting task was resumed with tsk_resume
+ *
+ * Note              : use only in thread mode, only on the consumer core
+ *                     critical section is entered only when the channel is empty
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned icc_wait( icc_t *icc, void *data ) { return icc_waitFor(icc, data, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : icc_take
+ * ISR alias         : icc_takeISR
+ *
+ * Description       : try to transfer a message from the inter-core channel,
+ *                     don't wait if the channel is empty
+ *
+ * Parameters
+ *   icc             : pointer to inter-core channel object
+ *   data            : pointer to store the message
+ *
+ * Return
+ *   E_SUCCESS       : message was successfully transferred from the channel
+ *   E_TIMEOUT       : channel object is empty
+ *
+ * Note              : may be used both in thread and handler mode, only on the consumer core
+ *                     it does not enter a critical section
+ *
+ ******************************************************************************/
+
+unsigned icc_take( icc_t *icc, void *data );
+
+__STATIC_INLINE
+unsigned icc_takeISR( icc_t *icc, void *data ) { return icc_take(icc, data); }
+
+/******************************************************************************
+ *
+ * Name              : icc_give
+ * ISR alias         : icc_giveISR
+ *
+ * Description       : try to transfer a message to the inter-core channel and ring the doorbell of the consumer core,
+ *                     don't wait if the channel is full
+ *
+ * Parameters
+ *   icc             : pointer to inter-core channel object
+ *   data            : pointer to the message
+ *
+ * Return
+ *   E_SUCCESS       : message was successfully transferred to the channel
+ *   E_TIMEOUT       : channel object is full
+ *
+ * Note              : may be used both in thread and handler mode, only on the producer core
+ *                     it does not enter a critical section
+ *
+ ******************************************************************************/
+
+unsigned icc_give( icc_t *icc, const void *data );
+
+__STATIC_INLINE
+unsigned icc_giveISR( icc_t *icc, const void *data ) { return icc_give(icc, data); }
+
+/******************************************************************************
+ *
+ * Name              : icc_notifyISR
+ *
+ * Description       : resume the consumer task waiting for messages
+ *
+ * Parameters
+ *   icc             : pointer to inter-core channel object
+ *
+ * Return            : none
+ *
+ * Note              : use only in handler mode, in the doorbell interrupt handler of the consumer core
+ *                     (e.g. HSEM1_IRQHandler), after clearing the doorbell interrupt flag;
+ *                     priority of the doorbell interrupt must allow it to be masked by the critical section
+ *
+ ******************************************************************************/
+
+void icc_notifyISR( icc_t *icc );
+
+/******************************************************************************
+ *
+ * Name              : icc_count
+ * ISR alias         : icc_countISR
+ *
+ * Description       : return the number of messages in the inter-core channel
+ *
+ * Parameters
+ *   icc             : pointer to inter-core channel object
+ *
+ * Return            : number of messages in the channel
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned icc_count( icc_t *icc );
+
+__STATIC_INLINE
+unsigned icc_countISR( icc_t *icc ) { return icc_count(icc); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : InterCoreT<>
+ *
+ * Description       : create and initialize an inter-core channel object
+ *
+ * Constructor parameters
+ *   limit           : number of message slots, must be a power of 2
+ *   T               : class of a message
+ *   ring            : address of the shared memory (ICC_SHARED(limit, sizeof(T)) bytes), aligned to _ICC_LINE
+ *   bell            : doorbell procedure of the producer (0 on the consumer core)
+ *
+ ******************************************************************************/
+
+template<unsigned limit_, class T>
+struct InterCoreT : public __icc
+{
+	static_assert(limit_ > 0 && (limit_ & (limit_ - 1)) == 0, "number of message slots must be a power of 2");
+	static_assert(std::is_trivially_copyable<T>::value, "messages are copied byte by byte through the shared memory");
+
+	InterCoreT( void *_ring, fun_t *_bell = nullptr ): __icc _ICC_INIT(_ring, limit_, sizeof(T), _bell) {}
+
+	unsigned waitFor  ( T *_data, cnt_t _delay ) { return icc_waitFor  (this, _data, _delay); }
+	unsigned waitUntil( T *_data, cnt_t _time )  { return icc_waitUntil(this, _data, _time);  }
+	unsigned wait     ( T *_data )               { return icc_wait     (this, _data);         }
+	unsigned take     ( T *_data )               { return icc_take     (this, _data);         }
+	unsigned takeISR  ( T *_data )               { return icc_takeISR  (this, _data);         }
+	unsigned give     ( const T *_data )         { return icc_give     (this, _data);         }
+	unsigned giveISR  ( const T *_data )         { return icc_giveISR  (this, _data);         }
+	void     notifyISR( void )                   {        icc_notifyISR(this);                }
+	void     clear    ( void )                   {        icc_clear    (this);                }
+	unsigned count    ( void )                   { return icc_count    (this);                }
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_ICC_H
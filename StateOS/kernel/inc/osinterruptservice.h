@@ -0,0 +1,282 @@
+/******************************************************************************
+
+    @file    StateOS: osinterruptservice.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_IST_H
+#define __STATEOS_IST_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : interrupt service
+ *
+ * Note              : interrupt service binds an interrupt to a service task:
+ *                     the vector stub (ist_handlerISR) masks the interrupt in the interrupt controller
+ *                     and makes the waiting service task ready directly, the handler doesn't touch the peripheral;
+ *                     the service task handles the peripheral (clears its interrupt flags)
+ *                     and the interrupt is unmasked when the task waits for the next one (ist_wait)
+ *                     with OS_TASK_LATENCY the interrupt-to-task latency is recorded in the service task histogram
+ *
+ ******************************************************************************/
+
+typedef struct __ist ist_t, * const ist_id;
+
+struct __ist
+{
+	tsk_t  * queue; // the service task waiting for the interrupt
+	unsigned irq;   // number of the bound interrupt
+	volatile
+	unsigned count; // number of interrupts not yet served (the interrupt is masked until they are served)
+};
+
+/******************************************************************************
+ *
+ * Name              : _IST_INIT
+ *
+ * Description       : create and initialize an interrupt service object
+ *
+ * Parameters
+ *   irq             : number of the bound interrupt (e.g. USART2_IRQn)
+ *
+ * Return            : interrupt service object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _IST_INIT( _irq ) { 0, _irq, 0 }
+
+/******************************************************************************
+ *
+ * Name              : OS_IST
+ *
+ * Description       : define and initialize an interrupt service object
+ *                     and the vector stub of the bound interrupt
+ *
+ * Parameters
+ *   ist             : name of a pointer to interrupt service object
+ *   irq             : number of the bound interrupt (e.g. USART2_IRQn)
+ *   handler         : name of the interrupt handler (e.g. USART2_IRQHandler)
+ *
+ * Note              : the interrupt is enabled when the service task waits for it for the first time
+ *
+ ******************************************************************************/
+
+#define             OS_IST( ist, irq, handler )                                 \
+                       ist_t ist##__ist = _IST_INIT( irq );                      \
+                       void handler( void ) { ist_handlerISR(& ist##__ist); }     \
+                       ist_id ist = & ist##__ist
+
+/******************************************************************************
+ *
+ * Name              : static_IST
+ *
+ * Description       : define and initialize a static interrupt service object
+ *                     and the vector stub of the bound interrupt
+ *
+ * Parameters
+ *   ist             : name of a pointer to interrupt service object
+ *   irq             : number of the bound interrupt (e.g. USART2_IRQn)
+ *   handler         : name of the interrupt handler (e.g. USART2_IRQHandler)
+ *
+ * Note              : look at OS_IST
+ *
+ ******************************************************************************/
+
+#define         static_IST( ist, irq, handler )                                 \
+                static ist_t ist##__ist = _IST_INIT( irq );                      \
+                       void handler( void ) { ist_handlerISR(& ist##__ist); }     \
+                static ist_id ist = & ist##__ist
+
+/******************************************************************************
+ *
+ * Name              : ist_init
+ *
+ * Description       : initialize an interrupt service object and mask the bound interrupt
+ *
+ * Parameters
+ *   ist             : pointer to interrupt service object
+ *   irq             : number of the bound interrupt (e.g. USART2_IRQn)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     vector stub of the interrupt must call ist_handlerISR
+ *
+ ******************************************************************************/
+
+void ist_init( ist_t *ist, unsigned irq );
+
+/******************************************************************************
+ *
+ * Name              : ist_kill
+ *
+ * Description       : mask the bound interrupt, discard interrupts not yet served
+ *                     and wake up the waiting service task with 'E_STOPPED' event value
+ *
+ * Parameters
+ *   ist             : pointer to interrupt service object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void ist_kill( ist_t *ist );
+
+/******************************************************************************
+ *
+ * Name              : ist_waitFor
+ *
+ * Description       : unmask the bound interrupt and wait for it for given duration of time,
+ *                     return at once if there is an interrupt not yet served
+ *
+ * Parameters
+ *   ist             : pointer to interrupt service object
+ *   delay           : duration of time (maximum number of ticks to wait for the interrupt)
+ *                     IMMEDIATE: don't wait for the interrupt
+ *                     INFINITE:  wait indefinitely for the interrupt
+ *
+ * Return
+ *   E_SUCCESS       : the interrupt occurred, it is masked until the next call of ist_wait
+ *   E_STOPPED       : interrupt service object was killed
+ *   E_TIMEOUT       : the interrupt didn't occur before the specified timeout expired
+ *
+ * Note              : use only in thread mode, only by the service task
+ *
+ ******************************************************************************/
+
+unsigned ist_waitFor( ist_t *ist, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : ist_waitUntil
+ *
+ * Description       : unmask the bound interrupt and wait for it until given timepoint,
+ *                     return at once if there is an interrupt not yet served
+ *
+ * Parameters
+ *   ist             : pointer to interrupt service object
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : the interrupt occurred, it is masked until the next call of ist_wait
+ *   E_STOPPED       : interrupt service object was killed
+ *   E_TIMEOUT       : the interrupt didn't occur before the specified timeout expired
+ *
+ * Note              : use only in thread mode, only by the service task
+ *
+ ******************************************************************************/
+
+unsigned ist_waitUntil( ist_t *ist, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : ist_wait
+ *
+ * Description       : unmask the bound interrupt and wait indefinitely for it,
+ *                     return at once if there is an interrupt not yet served
+ *
+ * Parameters
+ *   ist             : pointer to interrupt service object
+ *
+ * Return
+ *   E_SUCCESS       : the interrupt occurred, it is masked until the next call of ist_wait
+ *   E_STOPPED       : interrupt service object was killed
+ *
+ * Note              : use only in thread mode, only by the service task
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned ist_wait( ist_t *ist ) { return ist_waitFor(ist, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : ist_handlerISR
+ *
+ * Description       : vector stub of the bound interrupt:
+ *                     mask the interrupt and resume the waiting service task
+ *
+ * Parameters
+ *   ist             : pointer to interrupt service object
+ *
+ * Return            : none
+ *
+ * Note              : use only in handler mode, in the handler of the bound interrupt
+ *
+ ******************************************************************************/
+
+void ist_handlerISR( ist_t *ist );
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : InterruptService
+ *
+ * Description       : create and initialize an interrupt service object
+ *
+ * Constructor parameters
+ *   irq             : number of the bound interrupt (e.g. USART2_IRQn)
+ *
+ * Note              : vector stub of the interrupt must call handlerISR
+ *
+ ******************************************************************************/
+
+struct InterruptService : public __ist
+{
+	 InterruptService( unsigned _irq ): __ist _IST_INIT(_irq) {}
+	~InterruptService( void ) { assert(__ist::queue == nullptr); }
+
+	void     kill      ( void )          {        ist_kill      (this);        }
+	unsigned waitFor   ( cnt_t _delay )  { return ist_waitFor   (this, _delay); }
+	unsigned waitUntil ( cnt_t _time )   { return ist_waitUntil (this, _time);  }
+	unsigned wait      ( void )          { return ist_wait      (this);         }
+	void     handlerISR( void )          {        ist_handlerISR(this);         }
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_IST_H
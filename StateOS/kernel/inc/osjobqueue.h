@@ -56,7 +56,10 @@ struct __job
 
 	unsigned head;  // first element to read from data buffer
 	unsigned tail;  // first element to write into data buffer
-	fun_t ** data;  // data buffer
+	void   * data;  // data buffer
+	fun_t * const *
+	         table; // table of job procedures of a compressed job queue (data buffer holds 8-bit indices into the table)
+	unsigned items; // number of job procedures in the table
 };
 
 /******************************************************************************
@@ -75,7 +78,27 @@ struct __job
  *
  ******************************************************************************/
 
-#define               _JOB_INIT( _limit, _data ) { 0, 0, 0, _limit, 0, 0, _data }
+#define               _JOB_INIT( _limit, _data ) { 0, 0, 0, _limit, 0, 0, _data, 0, 0 }
+
+/******************************************************************************
+ *
+ * Name              : _JOB_INIT_TABLE
+ *
+ * Description       : create and initialize a compressed job queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored job procedures)
+ *   data            : job queue data buffer (8-bit indices)
+ *   table           : table of job procedures
+ *   items           : number of job procedures in the table (up to 256)
+ *
+ * Return            : job queue object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _JOB_INIT_TABLE( _limit, _data, _table, _items ) { 0, 0, 0, _limit, 0, 0, _data, _table, _items }
 
 /******************************************************************************
  *
@@ -109,7 +132,7 @@ struct __job
  ******************************************************************************/
 
 #define             OS_JOB( job, limit )                                 \
-                       fun_t *job##__buf[limit];                          \
+           __OS_NOINIT fun_t *job##__buf[limit];                          \
                        job_t  job##__job = _JOB_INIT( limit, job##__buf ); \
                        job_id job = & job##__job
 
@@ -126,10 +149,48 @@ struct __job
  ******************************************************************************/
 
 #define         static_JOB( job, limit )                                 \
-                static fun_t *job##__buf[limit];                          \
+    static __OS_NOINIT fun_t *job##__buf[limit];                          \
                 static job_t  job##__job = _JOB_INIT( limit, job##__buf ); \
                 static job_id job = & job##__job
 
+/******************************************************************************
+ *
+ * Name              : OS_JOB_TABLE
+ *
+ * Description       : define and initialize a compressed job queue object,
+ *                     the queue stores 8-bit indices into the table of job procedures
+ *
+ * Parameters
+ *   job             : name of a pointer to job queue object
+ *   limit           : size of a queue (max number of stored job procedures)
+ *   table           : array of job procedures (up to 256); only these procedures can be sent to the queue
+ *
+ ******************************************************************************/
+
+#define             OS_JOB_TABLE( job, limit, table )                                                                  \
+           __OS_NOINIT uint8_t job##__buf[limit];                                                                       \
+                       job_t  job##__job = _JOB_INIT_TABLE( limit, job##__buf, table, sizeof(table) / sizeof(*(table)) ); \
+                       job_id job = & job##__job
+
+/******************************************************************************
+ *
+ * Name              : static_JOB_TABLE
+ *
+ * Description       : define and initialize a static compressed job queue object,
+ *                     the queue stores 8-bit indices into the table of job procedures
+ *
+ * Parameters
+ *   job             : name of a pointer to job queue object
+ *   limit           : size of a queue (max number of stored job procedures)
+ *   table           : array of job procedures (up to 256); only these procedures can be sent to the queue
+ *
+ ******************************************************************************/
+
+#define         static_JOB_TABLE( job, limit, table )                                                                  \
+    static __OS_NOINIT uint8_t job##__buf[limit];                                                                       \
+                static job_t  job##__job = _JOB_INIT_TABLE( limit, job##__buf, table, sizeof(table) / sizeof(*(table)) ); \
+                static job_id job = & job##__job
+
 /******************************************************************************
  *
  * Name              : JOB_INIT
@@ -192,6 +253,28 @@ struct __job
 
 void job_init( job_t *job, unsigned limit, fun_t **data );
 
+/******************************************************************************
+ *
+ * Name              : job_initTable
+ *
+ * Description       : initialize a compressed job queue object,
+ *                     the queue stores 8-bit indices into the table of job procedures
+ *
+ * Parameters
+ *   job             : pointer to job queue object
+ *   limit           : size of a queue (max number of stored job procedures)
+ *   data            : job queue data buffer (limit bytes)
+ *   table           : table of job procedures; only these procedures can be sent to the queue
+ *   items           : number of job procedures in the table (up to 256)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void job_initTable( job_t *job, unsigned limit, uint8_t *data, fun_t * const *table, unsigned items );
+
 /******************************************************************************
  *
  * Name              : job_create
@@ -214,6 +297,27 @@ job_t *job_create( unsigned limit );
 __STATIC_INLINE
 job_t *job_new( unsigned limit ) { return job_create(limit); }
 
+/******************************************************************************
+ *
+ * Name              : job_createTable
+ *
+ * Description       : create and initialize a new compressed job queue object,
+ *                     the queue stores 8-bit indices into the table of job procedures
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored job procedures)
+ *   table           : table of job procedures; only these procedures can be sent to the queue
+ *   items           : number of job procedures in the table (up to 256)
+ *
+ * Return            : pointer to job queue object (job queue successfully created)
+ *   0               : job queue not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+job_t *job_createTable( unsigned limit, fun_t * const *table, unsigned items );
+
 /******************************************************************************
  *
  * Name              : job_kill
@@ -504,6 +608,43 @@ struct staticJobQueueT : public __job
 	fun_t *data_[limit_];
 };
 
+/******************************************************************************
+ *
+ * Class             : JobTableT<>
+ *
+ * Description       : create and initialize a compressed job queue object,
+ *                     the queue stores 8-bit indices into the table of job procedures
+ *
+ * Constructor parameters
+ *   limit           : size of a queue (max number of stored job procedures)
+ *   table           : table of job procedures; only these procedures can be sent to the queue
+ *   items           : number of job procedures in the table (up to 256)
+ *
+ ******************************************************************************/
+
+template<unsigned limit_>
+struct JobTableT : public __job
+{
+	 JobTableT( fun_t * const *_table, unsigned _items ): __job _JOB_INIT_TABLE(limit_, data_, _table, _items) {}
+	~JobTableT( void ) { assert(__job::queue == nullptr); }
+
+	void     kill     ( void )                      {        job_kill     (this);               }
+	unsigned waitFor  ( cnt_t  _delay )             { return job_waitFor  (this, _delay);       }
+	unsigned waitUntil( cnt_t  _time )              { return job_waitUntil(this, _time);        }
+	unsigned wait     ( void )                      { return job_wait     (this);               }
+	unsigned take     ( void )                      { return job_take     (this);               }
+	unsigned sendFor  ( fun_t *_fun, cnt_t _delay ) { return job_sendFor  (this, _fun, _delay); }
+	unsigned sendUntil( fun_t *_fun, cnt_t _time )  { return job_sendUntil(this, _fun, _time);  }
+	unsigned send     ( fun_t *_fun )               { return job_send     (this, _fun);         }
+	unsigned give     ( fun_t *_fun )               { return job_give     (this, _fun);         }
+	unsigned giveISR  ( fun_t *_fun )               { return job_giveISR  (this, _fun);         }
+	unsigned push     ( fun_t *_fun )               { return job_push     (this, _fun);         }
+	unsigned pushISR  ( fun_t *_fun )               { return job_pushISR  (this, _fun);         }
+
+	private:
+	uint8_t data_[limit_];
+};
+
 /******************************************************************************
  *
  * Class             : JobQueueT<>
@@ -520,6 +661,8 @@ struct staticJobQueueT : public __job
 template<unsigned limit_>
 struct JobQueueT : public __box
 {
+	static_assert(std::is_trivially_copyable<FUN_t>::value, "FUN_t is copied byte by byte through the mailbox queue");
+
 	 JobQueueT( void ): __box _BOX_INIT(limit_, reinterpret_cast<char *>(data_), sizeof(FUN_t)) {}
 	~JobQueueT( void ) { assert(__box::queue == nullptr); }
 
@@ -0,0 +1,357 @@
+/******************************************************************************
+
+    @file    StateOS: osjobtimer.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_JTM_H
+#define __STATEOS_JTM_H
+
+#include "oskernel.h"
+#include "ostimer.h"
+#include "osjobqueue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : job timer
+ *
+ * Note              : job timer sends delayed and periodic job procedures to the target job queue,
+ *                     pending jobs are kept in a binary min-heap ordered by due time (O(log n) insert and expire),
+ *                     all of them are served by one kernel timer armed for the earliest due time
+ *
+ ******************************************************************************/
+
+typedef struct __jte jte_t;
+
+struct __jte
+{
+	cnt_t    time;  // due time of the job procedure
+	cnt_t    period;// period of a periodic job procedure, 0 for a one-shot job
+	fun_t  * fun;   // job procedure
+};
+
+typedef struct __jtm jtm_t, * const jtm_id;
+
+struct __jtm
+{
+	tmr_t    tmr;   // kernel timer armed for the earliest due time
+	job_t  * job;   // target job queue
+	cnt_t    base;  // reference time: all pending due times are not earlier than the base
+	unsigned count; // number of pending job procedures
+	unsigned limit; // size of the heap (max number of pending job procedures)
+	jte_t  * data;  // heap of pending job procedures
+};
+
+/******************************************************************************
+ *
+ * Name              : _JTM_INIT
+ *
+ * Description       : create and initialize a job timer object
+ *
+ * Parameters
+ *   jtm             : name of the job timer object
+ *   job             : pointer to the target job queue
+ *   limit           : max number of pending job procedures
+ *   data            : job timer data buffer
+ *
+ * Return            : job timer object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _JTM_INIT( _jtm, _job, _limit, _data ) { _TMR_INIT_ARG(core_jtm_timeout, &(_jtm)), _job, 0, 0, _limit, _data }
+
+/******************************************************************************
+ *
+ * Name              : OS_JTM
+ *
+ * Description       : define and initialize a job timer object
+ *
+ * Parameters
+ *   jtm             : name of a pointer to job timer object
+ *   job             : pointer to the target job queue
+ *   limit           : max number of pending job procedures
+ *
+ * Note              : if the timer service task is used (OS_TIMER_TASK), it must be started in thread mode
+ *                     (with any timer or with jtm_init) before the first job procedure is sent
+ *
+ ******************************************************************************/
+
+#define             OS_JTM( jtm, job, limit )                                             \
+           __OS_NOINIT jte_t  jtm##__buf[limit];                                           \
+                       jtm_t  jtm##__jtm = _JTM_INIT( jtm##__jtm, job, limit, jtm##__buf ); \
+                       jtm_id jtm = & jtm##__jtm
+
+/******************************************************************************
+ *
+ * Name              : static_JTM
+ *
+ * Description       : define and initialize a static job timer object
+ *
+ * Parameters
+ *   jtm             : name of a pointer to job timer object
+ *   job             : pointer to the target job queue
+ *   limit           : max number of pending job procedures
+ *
+ * Note              : look at OS_JTM
+ *
+ ******************************************************************************/
+
+#define         static_JTM( jtm, job, limit )                                             \
+    static __OS_NOINIT jte_t  jtm##__buf[limit];                                           \
+                static jtm_t  jtm##__jtm = _JTM_INIT( jtm##__jtm, job, limit, jtm##__buf ); \
+                static jtm_id jtm = & jtm##__jtm
+
+/******************************************************************************
+ *
+ * Name              : jtm_init
+ *
+ * Description       : initialize a job timer object
+ *
+ * Parameters
+ *   jtm             : pointer to job timer object
+ *   job             : pointer to the target job queue
+ *   limit           : max number of pending job procedures
+ *   data            : job timer data buffer (array of 'limit' elements)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void jtm_init( jtm_t *jtm, job_t *job, unsigned limit, jte_t *data );
+
+/******************************************************************************
+ *
+ * Name              : jtm_sendAfter
+ * ISR alias         : jtm_sendAfterISR
+ *
+ * Description       : send the job procedure to the target job queue after given duration of time
+ *
+ * Parameters
+ *   jtm             : pointer to job timer object
+ *   fun             : pointer to job procedure
+ *   delay           : duration of time (maximum number of ticks to delay the job procedure)
+ *                     IMMEDIATE: the job procedure is sent to the job queue at once (job_give)
+ *
+ * Return
+ *   E_SUCCESS       : job procedure was successfully scheduled (or sent)
+ *   E_TIMEOUT       : job timer (or job queue) is full, try again
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     the job procedure is lost if the job queue is full at the due time
+ *
+ ******************************************************************************/
+
+unsigned jtm_sendAfter( jtm_t *jtm, fun_t *fun, cnt_t delay );
+
+__STATIC_INLINE
+unsigned jtm_sendAfterISR( jtm_t *jtm, fun_t *fun, cnt_t delay ) { return jtm_sendAfter(jtm, fun, delay); }
+
+/******************************************************************************
+ *
+ * Name              : jtm_sendAt
+ * ISR alias         : jtm_sendAtISR
+ *
+ * Description       : send the job procedure to the target job queue at given point in time
+ *
+ * Parameters
+ *   jtm             : pointer to job timer object
+ *   fun             : pointer to job procedure
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : job procedure was successfully scheduled (or sent)
+ *   E_TIMEOUT       : job timer (or job queue) is full, try again
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned jtm_sendAt( jtm_t *jtm, fun_t *fun, cnt_t time );
+
+__STATIC_INLINE
+unsigned jtm_sendAtISR( jtm_t *jtm, fun_t *fun, cnt_t time ) { return jtm_sendAt(jtm, fun, time); }
+
+/******************************************************************************
+ *
+ * Name              : jtm_sendEvery
+ * ISR alias         : jtm_sendEveryISR
+ *
+ * Description       : send the job procedure to the target job queue periodically
+ *
+ * Parameters
+ *   jtm             : pointer to job timer object
+ *   fun             : pointer to job procedure
+ *   delay           : duration of time (maximum number of ticks to delay the first job procedure)
+ *   period          : duration of time (maximum number of ticks between the job procedures), must not be zero
+ *
+ * Return
+ *   E_SUCCESS       : job procedure was successfully scheduled
+ *   E_TIMEOUT       : job timer is full, try again
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     expirations missed because of a late timer service are merged
+ *
+ ******************************************************************************/
+
+unsigned jtm_sendEvery( jtm_t *jtm, fun_t *fun, cnt_t delay, cnt_t period );
+
+__STATIC_INLINE
+unsigned jtm_sendEveryISR( jtm_t *jtm, fun_t *fun, cnt_t delay, cnt_t period ) { return jtm_sendEvery(jtm, fun, delay, period); }
+
+/******************************************************************************
+ *
+ * Name              : jtm_cancel
+ * ISR alias         : jtm_cancelISR
+ *
+ * Description       : cancel all pending (delayed and periodic) instances of the job procedure
+ *
+ * Parameters
+ *   jtm             : pointer to job timer object
+ *   fun             : pointer to job procedure
+ *
+ * Return            : number of cancelled job procedures
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     job procedures already sent to the job queue are not affected
+ *
+ ******************************************************************************/
+
+unsigned jtm_cancel( jtm_t *jtm, fun_t *fun );
+
+__STATIC_INLINE
+unsigned jtm_cancelISR( jtm_t *jtm, fun_t *fun ) { return jtm_cancel(jtm, fun); }
+
+/******************************************************************************
+ *
+ * Name              : jtm_kill
+ * ISR alias         : jtm_killISR
+ *
+ * Description       : cancel all pending job procedures and stop the timer
+ *
+ * Parameters
+ *   jtm             : pointer to job timer object
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void jtm_kill( jtm_t *jtm );
+
+__STATIC_INLINE
+void jtm_killISR( jtm_t *jtm ) { jtm_kill(jtm); }
+
+/******************************************************************************
+ *
+ * Name              : jtm_count
+ * ISR alias         : jtm_countISR
+ *
+ * Description       : return the number of pending job procedures
+ *
+ * Parameters
+ *   jtm             : pointer to job timer object
+ *
+ * Return            : number of pending job procedures
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned jtm_count( jtm_t *jtm );
+
+__STATIC_INLINE
+unsigned jtm_countISR( jtm_t *jtm ) { return jtm_count(jtm); }
+
+/******************************************************************************
+ *
+ * Name              : core_jtm_timeout
+ *
+ * Description       : callback procedure of the job timer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+void core_jtm_timeout( void *arg );
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : JobTimerT<>
+ *
+ * Description       : create and initialize a job timer object
+ *
+ * Constructor parameters
+ *   limit           : max number of pending job procedures
+ *   job             : pointer to the target job queue
+ *
+ ******************************************************************************/
+
+template<unsigned limit_>
+struct JobTimerT : public __jtm
+{
+	 JobTimerT( job_t *_job ): __jtm _JTM_INIT(*this, _job, limit_, data_) {}
+	~JobTimerT( void ) { assert(__jtm::count == 0); }
+
+	unsigned sendAfter   ( fun_t *_fun, cnt_t _delay )                { return jtm_sendAfter   (this, _fun, _delay);          }
+	unsigned sendAfterISR( fun_t *_fun, cnt_t _delay )                { return jtm_sendAfterISR(this, _fun, _delay);          }
+	unsigned sendAt      ( fun_t *_fun, cnt_t _time )                 { return jtm_sendAt      (this, _fun, _time);           }
+	unsigned sendAtISR   ( fun_t *_fun, cnt_t _time )                 { return jtm_sendAtISR   (this, _fun, _time);           }
+	unsigned sendEvery   ( fun_t *_fun, cnt_t _delay, cnt_t _period ) { return jtm_sendEvery   (this, _fun, _delay, _period); }
+	unsigned sendEveryISR( fun_t *_fun, cnt_t _delay, cnt_t _period ) { return jtm_sendEveryISR(this, _fun, _delay, _period); }
+	unsigned cancel      ( fun_t *_fun )                              { return jtm_cancel      (this, _fun);                  }
+	unsigned cancelISR   ( fun_t *_fun )                              { return jtm_cancelISR   (this, _fun);                  }
+	void     kill        ( void )                                     {        jtm_kill        (this);                        }
+	void     killISR     ( void )                                     {        jtm_killISR     (this);                        }
+	unsigned count       ( void )                                     { return jtm_count       (this);                        }
+
+	private:
+	jte_t data_[limit_];
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_JTM_H
@@ -350,6 +350,8 @@ unsigned lst_takeISR( lst_t *lst, void **data ) { return lst_take(lst, data); }
  * Return            : none
  *
  * Note              : may be used both in thread and handler mode
+ *                     memory object must be preceded by a link word (que_t),
+ *                     memory objects of headerless memory pools (OS_MEM_HEADERLESS) can't be used
  *
  ******************************************************************************/
 
@@ -380,7 +382,7 @@ void lst_giveISR( lst_t *lst, const void *data ) { lst_give(lst, data); }
 template<class T>
 struct ListTT : public __lst
 {
-	 ListTT( void ): __lst _LST_INIT() {}
+	constexpr ListTT( void ): __lst _LST_INIT() {}
 	~ListTT( void ) { assert(__lst::queue == nullptr); }
 
 	void     kill     ( void )                            {        lst_kill     (this);                                           }
@@ -58,6 +58,11 @@ struct __box
 	char   * data;  // inherited from stream buffer
 
 	unsigned size;  // size of a single mail (in bytes)
+	bool     over;  // overwrite mode: the oldest mails are dropped when the mailbox queue is full
+	unsigned drop;  // number of dropped mails
+#if OS_OBJ_STATS
+	ost_t    ost;   // contention statistics
+#endif
 };
 
 /******************************************************************************
@@ -77,7 +82,7 @@ struct __box
  *
  ******************************************************************************/
 
-#define               _BOX_INIT( _limit, _data, _size ) { 0, 0, 0, _limit * _size, 0, 0, _data, _size }
+#define               _BOX_INIT( _limit, _data, _size ) { 0, 0, 0, _limit * _size, 0, 0, _data, _size, false, 0 _OST_INIT }
 
 /******************************************************************************
  *
@@ -113,7 +118,28 @@ struct __box
  ******************************************************************************/
 
 #define             OS_BOX( box, limit, size )                                \
-                       char box##__buf[limit*size];                            \
+           __OS_NOINIT char box##__buf[limit*size];                            \
+                       box_t box##__box = _BOX_INIT( limit, box##__buf, size ); \
+                       box_id box = & box##__box
+
+/******************************************************************************
+ *
+ * Name              : OS_BOX_NOINIT
+ *
+ * Description       : define and initialize a mailbox queue object
+ *                     with data buffer placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   box             : name of a pointer to mailbox queue object
+ *   limit           : size of a queue (max number of stored mails)
+ *   size            : size of a single mail (in bytes)
+ *
+ * Note              : use only at file scope
+ *
+ ******************************************************************************/
+
+#define      OS_BOX_NOINIT( box, limit, size )                                \
+              __NOINIT char box##__buf[limit*size];                            \
                        box_t box##__box = _BOX_INIT( limit, box##__buf, size ); \
                        box_id box = & box##__box
 
@@ -131,7 +157,26 @@ struct __box
  ******************************************************************************/
 
 #define         static_BOX( box, limit, size )                                \
-                static char box##__buf[limit*size];                            \
+    static __OS_NOINIT char box##__buf[limit*size];                            \
+                static box_t box##__box = _BOX_INIT( limit, box##__buf, size ); \
+                static box_id box = & box##__box
+
+/******************************************************************************
+ *
+ * Name              : static_BOX_NOINIT
+ *
+ * Description       : define and initialize a static mailbox queue object
+ *                     with data buffer placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   box             : name of a pointer to mailbox queue object
+ *   limit           : size of a queue (max number of stored mails)
+ *   size            : size of a single mail (in bytes)
+ *
+ ******************************************************************************/
+
+#define  static_BOX_NOINIT( box, limit, size )                                \
+       static __NOINIT char box##__buf[limit*size];                            \
                 static box_t box##__box = _BOX_INIT( limit, box##__buf, size ); \
                 static box_id box = & box##__box
 
@@ -327,6 +372,34 @@ unsigned box_waitUntil( box_t *box, void *data, cnt_t time );
 __STATIC_INLINE
 unsigned box_wait( box_t *box, void *data ) { return box_waitFor(box, data, INFINITE); }
 
+/******************************************************************************
+ *
+ * Name              : box_waitN
+ *
+ * Description       : try to transfer up to 'max' mailbox data from the mailbox queue object,
+ *                     wait for given duration of time while the mailbox queue object is empty,
+ *                     then drain the mailbox queue object and release all waiting senders in one critical section
+ *
+ * Parameters
+ *   box             : pointer to mailbox queue object
+ *   data            : pointer to store mailbox data (array of 'max' elements)
+ *   max             : max number of mailbox data to transfer
+ *   got             : pointer to store the number of transfered mailbox data (may be 0)
+ *   delay           : duration of time (maximum number of ticks to wait while the mailbox queue object is empty)
+ *                     IMMEDIATE: don't wait if the mailbox queue object is empty
+ *                     INFINITE:  wait indefinitely while the mailbox queue object is empty
+ *
+ * Return
+ *   E_SUCCESS       : at least one mailbox data was successfully transfered from the mailbox queue object
+ *   E_STOPPED       : mailbox queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : mailbox queue object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned box_waitN( box_t *box, void *data, unsigned max, unsigned *got, cnt_t delay );
+
 /******************************************************************************
  *
  * Name              : box_take
@@ -472,6 +545,44 @@ unsigned box_push( box_t *box, const void *data );
 __STATIC_INLINE
 unsigned box_pushISR( box_t *box, const void *data ) { return box_push(box, data); }
 
+/******************************************************************************
+ *
+ * Name              : box_setOverwrite
+ *
+ * Description       : set overwrite mode of the mailbox queue object,
+ *                     in overwrite mode 'box_give' and 'box_send' never block nor fail for lack of space,
+ *                     they remove the oldest mails (as 'box_push') when the mailbox queue object is full
+ *
+ * Parameters
+ *   box             : pointer to mailbox queue object
+ *   enable          : true: overwrite mode, false: normal mode
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     should be set after initialization, before the mailbox queue object is used
+ *
+ ******************************************************************************/
+
+void box_setOverwrite( box_t *box, bool enable );
+
+/******************************************************************************
+ *
+ * Name              : box_dropped
+ *
+ * Description       : return the number of mails removed from the mailbox queue object to make space for new ones
+ *
+ * Parameters
+ *   box             : pointer to mailbox queue object
+ *
+ * Return            : number of dropped mails
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned box_dropped( box_t *box );
+
 /******************************************************************************
  *
  * Name              : box_count
@@ -518,6 +629,9 @@ unsigned box_spaceISR( box_t *box ) { return box_space(box); }
 
 #ifdef __cplusplus
 
+#include <new>
+#include <utility>
+
 /******************************************************************************
  *
  * Class             : MailBoxQueueT<>
@@ -540,6 +654,7 @@ struct MailBoxQueueT : public __box
 	unsigned waitFor  (       void *_data, cnt_t _delay ) { return box_waitFor  (this, _data, _delay); }
 	unsigned waitUntil(       void *_data, cnt_t _time )  { return box_waitUntil(this, _data, _time);  }
 	unsigned wait     (       void *_data )               { return box_wait     (this, _data);         }
+	unsigned waitN    (       void *_data, unsigned _max, unsigned *_got, cnt_t _delay ) { return box_waitN(this, _data, _max, _got, _delay); }
 	unsigned take     (       void *_data )               { return box_take     (this, _data);         }
 	unsigned takeISR  (       void *_data )               { return box_takeISR  (this, _data);         }
 	unsigned sendFor  ( const void *_data, cnt_t _delay ) { return box_sendFor  (this, _data, _delay); }
@@ -549,6 +664,8 @@ struct MailBoxQueueT : public __box
 	unsigned giveISR  ( const void *_data )               { return box_giveISR  (this, _data);         }
 	unsigned push     ( const void *_data )               { return box_push     (this, _data);         }
 	unsigned pushISR  ( const void *_data )               { return box_pushISR  (this, _data);         }
+	void     setOverwrite( bool _enable )                 {        box_setOverwrite(this, _enable);    }
+	unsigned dropped  ( void )                            { return box_dropped  (this);                }
 	unsigned count    ( void )                            { return box_count    (this);                }
 	unsigned countISR ( void )                            { return box_countISR (this);                }
 	unsigned space    ( void )                            { return box_space    (this);                }
@@ -576,6 +693,76 @@ struct MailBoxQueueTT : public MailBoxQueueT<limit_, sizeof(T)>
 	MailBoxQueueTT( void ): MailBoxQueueT<limit_, sizeof(T)>() {}
 };
 
+/******************************************************************************
+ *
+ * Class             : Channel<>
+ *
+ * Description       : create and initialize a typed channel object
+ *                     messages are constructed in place, directly in the slot of the channel buffer
+ *                     and consumed by reference, without copying; message type doesn't have to be trivially copyable
+ *                     indices of free and filled slots are passed through two mailbox queues
+ *
+ * Constructor parameters
+ *   T               : class of a single message
+ *   limit           : size of a channel (max number of stored messages)
+ *
+ ******************************************************************************/
+
+template<class T, unsigned limit_>
+struct Channel
+{
+	struct Slot
+	{
+		 Slot( void ):                            ch_(nullptr), idx_(0) {}
+		 Slot( Channel *_ch, unsigned _idx ):     ch_(_ch),     idx_(_idx) {}
+		 Slot( Slot &&_slot ):                    ch_(_slot.ch_), idx_(_slot.idx_) { _slot.ch_ = nullptr; }
+		~Slot( void ) { if (ch_) ch_->release_(idx_); }
+
+		Slot( const Slot & ) = delete;
+		Slot &operator=( const Slot & ) = delete;
+
+		explicit
+		operator bool  ( void ) const { return ch_ != nullptr; }
+		T   &operator* ( void ) const { return  ch_->item_(idx_); }
+		T   *operator->( void ) const { return &ch_->item_(idx_); }
+
+		private:
+		Channel *ch_;
+		unsigned idx_;
+	};
+
+	 Channel( void ) { for (unsigned idx = 0; idx < limit_; idx++) free_.give(&idx); }
+	~Channel( void ) { unsigned idx; while (full_.take(&idx) == E_SUCCESS) item_(idx).~T(); }
+
+	template<class... A>
+	unsigned emplaceFor  ( cnt_t _delay, A&&... _args ) { unsigned idx; unsigned event = free_.waitFor  (&idx, _delay); if (event == E_SUCCESS) commit_(idx, std::forward<A>(_args)...); return event; }
+	template<class... A>
+	unsigned emplaceUntil( cnt_t _time,  A&&... _args ) { unsigned idx; unsigned event = free_.waitUntil(&idx, _time);  if (event == E_SUCCESS) commit_(idx, std::forward<A>(_args)...); return event; }
+	template<class... A>
+	unsigned emplace     (               A&&... _args ) { unsigned idx; unsigned event = free_.wait     (&idx);         if (event == E_SUCCESS) commit_(idx, std::forward<A>(_args)...); return event; }
+	template<class... A>
+	unsigned try_emplace (               A&&... _args ) { unsigned idx; unsigned event = free_.take     (&idx);         if (event == E_SUCCESS) commit_(idx, std::forward<A>(_args)...); return event; }
+
+	Slot     receiveFor  ( cnt_t _delay ) { unsigned idx; return full_.waitFor  (&idx, _delay) == E_SUCCESS ? Slot(this, idx) : Slot(); }
+	Slot     receiveUntil( cnt_t _time )  { unsigned idx; return full_.waitUntil(&idx, _time)  == E_SUCCESS ? Slot(this, idx) : Slot(); }
+	Slot     receive     ( void )         { unsigned idx; return full_.wait     (&idx)         == E_SUCCESS ? Slot(this, idx) : Slot(); }
+	Slot     try_receive ( void )         { unsigned idx; return full_.take     (&idx)         == E_SUCCESS ? Slot(this, idx) : Slot(); }
+
+	unsigned count       ( void )         { return full_.count(); }
+	unsigned space       ( void )         { return free_.count(); }
+
+	private:
+	T   &item_( unsigned _idx ) { return *reinterpret_cast<T *>(data_[_idx]); }
+
+	template<class... A>
+	void commit_ ( unsigned _idx, A&&... _args ) { new (data_[_idx]) T(std::forward<A>(_args)...); full_.give(&_idx); }
+	void release_( unsigned _idx )               { item_(_idx).~T();                                 free_.give(&_idx); }
+
+	MailBoxQueueT<limit_, sizeof(unsigned)> free_;
+	MailBoxQueueT<limit_, sizeof(unsigned)> full_;
+	alignas(T) char data_[limit_][sizeof(T)];
+};
+
 #endif//__cplusplus
 
 /* -------------------------------------------------------------------------- */
@@ -0,0 +1,603 @@
+/******************************************************************************
+
+    @file    StateOS: osmailqueue.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_MLQ_H
+#define __STATEOS_MLQ_H
+
+#include "oskernel.h"
+#include "osmemorypool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : mail queue
+ *                     like a CMSIS-RTOS mail queue
+ *
+ * Note              : memory pool of mails and FIFO queue of posted mails in one object,
+ *                     mails are passed by pointer (zero-copy), every operation enters one critical section
+ *
+ ******************************************************************************/
+
+typedef struct __mlq mlq_t, * const mlq_id;
+
+struct __mlq
+{
+	tsk_t  * queue; // next process in the DELAYED queue (receivers)
+	void   * res;   // allocated mail queue object's resource
+	tsk_t  * alloc; // next process in the DELAYED queue of tasks waiting for a free mail
+	que_t    head;  // first posted mail
+	que_t  * tail;  // last posted mail
+	que_t    free;  // list of released mails
+	unsigned index; // number of mails taken from the data buffer for the first time
+
+	unsigned limit; // size of a mail queue (max number of mails)
+	unsigned size;  // size of a mail (in words)
+	void   * data;  // pointer to mail queue buffer
+	unsigned count; // number of posted mails
+};
+
+/******************************************************************************
+ *
+ * Name              : _MLQ_INIT
+ *
+ * Description       : create and initialize a mail queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of mails)
+ *   size            : size of a mail (in bytes)
+ *   data            : mail queue data buffer
+ *
+ * Return            : mail queue object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _MLQ_INIT( _limit, _size, _data ) { 0, 0, 0, _QUE_INIT(), 0, _QUE_INIT(), 0, _limit, MSIZE(_size), _data, 0 }
+
+/******************************************************************************
+ *
+ * Name              : _MLQ_DATA
+ *
+ * Description       : create a mail queue data buffer
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of mails)
+ *   size            : size of a mail (in bytes)
+ *
+ * Return            : mail queue data buffer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _MLQ_DATA( _limit, _size ) (void *[_limit * (1 + MSIZE(_size))]){ 0 }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : MLQ_SIZE
+ *
+ * Description       : size of a mail queue data buffer (in bytes)
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of mails)
+ *   size            : size of a mail (in bytes)
+ *
+ ******************************************************************************/
+
+#define                MLQ_SIZE( limit, size ) \
+                   ((limit) * (1 + MSIZE(size)) * sizeof(que_t))
+
+/******************************************************************************
+ *
+ * Name              : OS_MLQ
+ *
+ * Description       : define and initialize a mail queue object
+ *
+ * Parameters
+ *   mlq             : name of a pointer to mail queue object
+ *   limit           : size of a queue (max number of mails)
+ *   size            : size of a mail (in bytes)
+ *
+ ******************************************************************************/
+
+#define             OS_MLQ( mlq, limit, size )                                \
+           __OS_NOINIT void*mlq##__buf[limit*(1+MSIZE(size))];                 \
+                       mlq_t mlq##__mlq = _MLQ_INIT( limit, size, mlq##__buf ); \
+                       mlq_id mlq = & mlq##__mlq
+
+/******************************************************************************
+ *
+ * Name              : static_MLQ
+ *
+ * Description       : define and initialize a static mail queue object
+ *
+ * Parameters
+ *   mlq             : name of a pointer to mail queue object
+ *   limit           : size of a queue (max number of mails)
+ *   size            : size of a mail (in bytes)
+ *
+ ******************************************************************************/
+
+#define         static_MLQ( mlq, limit, size )                                \
+         static __OS_NOINIT void*mlq##__buf[limit*(1+MSIZE(size))];            \
+                static mlq_t mlq##__mlq = _MLQ_INIT( limit, size, mlq##__buf ); \
+                static mlq_id mlq = & mlq##__mlq
+
+/******************************************************************************
+ *
+ * Name              : MLQ_INIT
+ *
+ * Description       : create and initialize a mail queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of mails)
+ *   size            : size of a mail (in bytes)
+ *
+ * Return            : mail queue object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                MLQ_INIT( limit, size ) \
+                      _MLQ_INIT( limit, size, _MLQ_DATA( limit, size ) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : MLQ_CREATE
+ * Alias             : MLQ_NEW
+ *
+ * Description       : create and initialize a mail queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of mails)
+ *   size            : size of a mail (in bytes)
+ *
+ * Return            : pointer to mail queue object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                MLQ_CREATE( limit, size ) \
+           (mlq_t[]) { MLQ_INIT  ( limit, size ) }
+#define                MLQ_NEW \
+                       MLQ_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : mlq_init
+ *
+ * Description       : initialize a mail queue object
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *   limit           : size of a queue (max number of mails)
+ *   size            : size of a mail (in bytes)
+ *   data            : mail queue data buffer (of MLQ_SIZE(limit, size) bytes)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void mlq_init( mlq_t *mlq, unsigned limit, unsigned size, void *data );
+
+/******************************************************************************
+ *
+ * Name              : mlq_create
+ * Alias             : mlq_new
+ *
+ * Description       : create and initialize a new mail queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of mails)
+ *   size            : size of a mail (in bytes)
+ *
+ * Return            : pointer to mail queue object (mail queue successfully created)
+ *   0               : mail queue not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+mlq_t *mlq_create( unsigned limit, unsigned size );
+
+__STATIC_INLINE
+mlq_t *mlq_new( unsigned limit, unsigned size ) { return mlq_create(limit, size); }
+
+/******************************************************************************
+ *
+ * Name              : mlq_kill
+ *
+ * Description       : discard all posted mails and wake up all waiting tasks with 'E_STOPPED' event value
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     mails allocated by tasks stay valid and must be released with mlq_free
+ *
+ ******************************************************************************/
+
+void mlq_kill( mlq_t *mlq );
+
+/******************************************************************************
+ *
+ * Name              : mlq_delete
+ *
+ * Description       : reset the mail queue object and free allocated resource
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void mlq_delete( mlq_t *mlq );
+
+/******************************************************************************
+ *
+ * Name              : mlq_allocFor
+ *
+ * Description       : try to allocate a free mail from the mail queue object,
+ *                     wait for given duration of time while all mails are in use
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *   data            : pointer to store the pointer to the mail
+ *   delay           : duration of time (maximum number of ticks to wait while all mails are in use)
+ *                     IMMEDIATE: don't wait if all mails are in use
+ *                     INFINITE:  wait indefinitely while all mails are in use
+ *
+ * Return
+ *   E_SUCCESS       : pointer to mail was successfully transfered to the data pointer
+ *   E_STOPPED       : mail queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : all mails are in use and no mail was released before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned mlq_allocFor( mlq_t *mlq, void **data, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : mlq_allocUntil
+ *
+ * Description       : try to allocate a free mail from the mail queue object,
+ *                     wait until given timepoint while all mails are in use
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *   data            : pointer to store the pointer to the mail
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : pointer to mail was successfully transfered to the data pointer
+ *   E_STOPPED       : mail queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : all mails are in use and no mail was released before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned mlq_allocUntil( mlq_t *mlq, void **data, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : mlq_alloc
+ * ISR alias         : mlq_allocISR
+ *
+ * Description       : try to allocate a free mail from the mail queue object,
+ *                     don't wait if all mails are in use
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *   data            : pointer to store the pointer to the mail
+ *
+ * Return
+ *   E_SUCCESS       : pointer to mail was successfully transfered to the data pointer
+ *   E_TIMEOUT       : all mails are in use
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned mlq_alloc( mlq_t *mlq, void **data );
+
+__STATIC_INLINE
+unsigned mlq_allocISR( mlq_t *mlq, void **data ) { return mlq_alloc(mlq, data); }
+
+/******************************************************************************
+ *
+ * Name              : mlq_free
+ * ISR alias         : mlq_freeISR
+ *
+ * Description       : release the mail allocated from the mail queue object,
+ *                     the mail is transfered directly to the task waiting for a free mail
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *   data            : pointer to the mail
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void mlq_free( mlq_t *mlq, const void *data );
+
+__STATIC_INLINE
+void mlq_freeISR( mlq_t *mlq, const void *data ) { mlq_free(mlq, data); }
+
+/******************************************************************************
+ *
+ * Name              : mlq_give
+ * ISR alias         : mlq_giveISR
+ *
+ * Description       : post the mail allocated from the mail queue object to the end of the queue,
+ *                     the mail is transfered directly to the waiting receiver
+ *                     (there is always room for every allocated mail, so the function never waits)
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *   data            : pointer to the mail
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void mlq_give( mlq_t *mlq, const void *data );
+
+__STATIC_INLINE
+void mlq_giveISR( mlq_t *mlq, const void *data ) { mlq_give(mlq, data); }
+
+/******************************************************************************
+ *
+ * Name              : mlq_waitFor
+ *
+ * Description       : try to receive the first posted mail from the mail queue object,
+ *                     wait for given duration of time while the mail queue object is empty
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *   data            : pointer to store the pointer to the mail
+ *   delay           : duration of time (maximum number of ticks to wait while the mail queue object is empty)
+ *                     IMMEDIATE: don't wait if the mail queue object is empty
+ *                     INFINITE:  wait indefinitely while the mail queue object is empty
+ *
+ * Return
+ *   E_SUCCESS       : pointer to mail was successfully transfered to the data pointer
+ *   E_STOPPED       : mail queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : mail queue object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *                     the received mail must be released with mlq_free
+ *
+ ******************************************************************************/
+
+unsigned mlq_waitFor( mlq_t *mlq, void **data, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : mlq_waitUntil
+ *
+ * Description       : try to receive the first posted mail from the mail queue object,
+ *                     wait until given timepoint while the mail queue object is empty
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *   data            : pointer to store the pointer to the mail
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : pointer to mail was successfully transfered to the data pointer
+ *   E_STOPPED       : mail queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : mail queue object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *                     the received mail must be released with mlq_free
+ *
+ ******************************************************************************/
+
+unsigned mlq_waitUntil( mlq_t *mlq, void **data, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : mlq_wait
+ *
+ * Description       : try to receive the first posted mail from the mail queue object,
+ *                     wait indefinitely while the mail queue object is empty
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *   data            : pointer to store the pointer to the mail
+ *
+ * Return
+ *   E_SUCCESS       : pointer to mail was successfully transfered to the data pointer
+ *   E_STOPPED       : mail queue object was killed
+ *
+ * Note              : use only in thread mode
+ *                     the received mail must be released with mlq_free
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned mlq_wait( mlq_t *mlq, void **data ) { return mlq_waitFor(mlq, data, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : mlq_take
+ * ISR alias         : mlq_takeISR
+ *
+ * Description       : try to receive the first posted mail from the mail queue object,
+ *                     don't wait if the mail queue object is empty
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *   data            : pointer to store the pointer to the mail
+ *
+ * Return
+ *   E_SUCCESS       : pointer to mail was successfully transfered to the data pointer
+ *   E_TIMEOUT       : mail queue object is empty
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     the received mail must be released with mlq_free
+ *
+ ******************************************************************************/
+
+unsigned mlq_take( mlq_t *mlq, void **data );
+
+__STATIC_INLINE
+unsigned mlq_takeISR( mlq_t *mlq, void **data ) { return mlq_take(mlq, data); }
+
+/******************************************************************************
+ *
+ * Name              : mlq_count
+ * ISR alias         : mlq_countISR
+ *
+ * Description       : return the number of posted mails in the mail queue object
+ *
+ * Parameters
+ *   mlq             : pointer to mail queue object
+ *
+ * Return            : number of posted mails
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned mlq_count( mlq_t *mlq ) { return mlq->count; }
+
+__STATIC_INLINE
+unsigned mlq_countISR( mlq_t *mlq ) { return mlq->count; }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : MailQueueT<>
+ *
+ * Description       : create and initialize a mail queue object
+ *
+ * Constructor parameters
+ *   limit           : size of a queue (max number of mails)
+ *   size            : size of a mail (in bytes)
+ *
+ ******************************************************************************/
+
+template<unsigned limit_, unsigned size_>
+struct MailQueueT : public __mlq
+{
+	 MailQueueT( void ): __mlq _MLQ_INIT(limit_, size_, data_) {}
+	~MailQueueT( void ) { assert(__mlq::queue == nullptr && __mlq::alloc == nullptr); }
+
+	void     kill      ( void )                             {        mlq_kill      (this);                }
+	unsigned allocFor  (       void **_data, cnt_t _delay ) { return mlq_allocFor  (this, _data, _delay); }
+	unsigned allocUntil(       void **_data, cnt_t _time )  { return mlq_allocUntil(this, _data, _time);  }
+	unsigned alloc     (       void **_data )               { return mlq_alloc     (this, _data);         }
+	unsigned allocISR  (       void **_data )               { return mlq_allocISR  (this, _data);         }
+	void     free      ( const void  *_data )               {        mlq_free      (this, _data);         }
+	void     freeISR   ( const void  *_data )               {        mlq_freeISR   (this, _data);         }
+	void     give      ( const void  *_data )               {        mlq_give      (this, _data);         }
+	void     giveISR   ( const void  *_data )               {        mlq_giveISR   (this, _data);         }
+	unsigned waitFor   (       void **_data, cnt_t _delay ) { return mlq_waitFor   (this, _data, _delay); }
+	unsigned waitUntil (       void **_data, cnt_t _time )  { return mlq_waitUntil (this, _data, _time);  }
+	unsigned wait      (       void **_data )               { return mlq_wait      (this, _data);         }
+	unsigned take      (       void **_data )               { return mlq_take      (this, _data);         }
+	unsigned takeISR   (       void **_data )               { return mlq_takeISR   (this, _data);         }
+	unsigned count     ( void )                             { return mlq_count     (this);                }
+	unsigned countISR  ( void )                             { return mlq_countISR  (this);                }
+
+	private:
+	void *data_[limit_ * (1 + MSIZE(size_))];
+};
+
+/******************************************************************************
+ *
+ * Class             : MailQueueTT<>
+ *
+ * Description       : create and initialize a mail queue object
+ *
+ * Constructor parameters
+ *   limit           : size of a queue (max number of mails)
+ *   T               : class of a mail
+ *
+ ******************************************************************************/
+
+template<unsigned limit_, class T>
+struct MailQueueTT : public MailQueueT<limit_, sizeof(T)>
+{
+	MailQueueTT( void ): MailQueueT<limit_, sizeof(T)>() {}
+
+	unsigned allocFor  ( T **_data, cnt_t _delay ) { return mlq_allocFor  (this, reinterpret_cast<void **>(_data), _delay); }
+	unsigned allocUntil( T **_data, cnt_t _time )  { return mlq_allocUntil(this, reinterpret_cast<void **>(_data), _time);  }
+	unsigned alloc     ( T **_data )               { return mlq_alloc     (this, reinterpret_cast<void **>(_data));         }
+	unsigned allocISR  ( T **_data )               { return mlq_allocISR  (this, reinterpret_cast<void **>(_data));         }
+	unsigned waitFor   ( T **_data, cnt_t _delay ) { return mlq_waitFor   (this, reinterpret_cast<void **>(_data), _delay); }
+	unsigned waitUntil ( T **_data, cnt_t _time )  { return mlq_waitUntil (this, reinterpret_cast<void **>(_data), _time);  }
+	unsigned wait      ( T **_data )               { return mlq_wait      (this, reinterpret_cast<void **>(_data));         }
+	unsigned take      ( T **_data )               { return mlq_take      (this, reinterpret_cast<void **>(_data));         }
+	unsigned takeISR   ( T **_data )               { return mlq_takeISR   (this, reinterpret_cast<void **>(_data));         }
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_MLQ_H
@@ -44,6 +44,9 @@ extern "C" {
 #define MSIZE( size ) \
  ALIGNED_SIZE( size, que_t )
 
+#define MHEAD \
+ ( OS_MEM_HEADERLESS ? 0 : 1 ) // number of link words (que_t) in front of a memory object
+
 /******************************************************************************
  *
  * Name              : memory pool
@@ -61,6 +64,31 @@ struct __mem
 	unsigned limit; // size of a memory pool (max number of objects)
 	unsigned size;  // size of memory object (in words)
 	void   * data;  // pointer to memory pool buffer
+#if OS_MEM_LOCKFREE
+	volatile
+	uint32_t top;   // index of the first free memory object (lower half) and ABA tag (upper half)
+#endif
+	volatile
+	unsigned count; // number of memory objects in use
+	volatile
+	unsigned peak;  // high-water mark of memory objects in use
+	volatile
+	unsigned fails; // number of unsuccessful attempts to get memory object
+};
+
+/******************************************************************************
+ *
+ * Name              : memory pool statistics
+ *
+ ******************************************************************************/
+
+typedef struct __mst mst_t;
+
+struct __mst
+{
+	unsigned count; // number of memory objects in use
+	unsigned peak;  // high-water mark of memory objects in use
+	unsigned fails; // number of unsuccessful attempts to get memory object
 };
 
 /******************************************************************************
@@ -79,7 +107,11 @@ struct __mem
  *
  ******************************************************************************/
 
-#define               _MEM_INIT( _limit, _size, _data ) { 0, 0, _QUE_INIT(), _limit, MSIZE(_size), _data }
+#if OS_MEM_LOCKFREE
+#define               _MEM_INIT( _limit, _size, _data ) { 0, 0, _QUE_INIT(), _limit, MSIZE(_size), _data, 0, 0, 0, 0 }
+#else
+#define               _MEM_INIT( _limit, _size, _data ) { 0, 0, _QUE_INIT(), _limit, MSIZE(_size), _data, 0, 0, 0 }
+#endif
 
 /******************************************************************************
  *
@@ -98,7 +130,7 @@ struct __mem
  ******************************************************************************/
 
 #ifndef __cplusplus
-#define               _MEM_DATA( _limit, _size ) (void *[_limit * (1 + MSIZE(_size))]){ 0 }
+#define               _MEM_DATA( _limit, _size ) (void *[_limit * (MHEAD + MSIZE(_size))]){ 0 }
 #endif
 
 /******************************************************************************
@@ -115,7 +147,29 @@ struct __mem
  ******************************************************************************/
 
 #define             OS_MEM( mem, limit, size )                                \
-                       void*mem##__buf[limit*(1+MSIZE(size))];                 \
+           __OS_NOINIT void*mem##__buf[limit*(MHEAD+MSIZE(size))];             \
+                       mem_t mem##__mem = _MEM_INIT( limit, size, mem##__buf ); \
+                       mem_id mem = & mem##__mem
+
+/******************************************************************************
+ *
+ * Name              : OS_MEM_NOINIT
+ *
+ * Description       : define and initialize a memory pool object
+ *                     with data buffer placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   mem             : name of a pointer to memory pool object
+ *   limit           : size of a buffer (max number of objects)
+ *   size            : size of memory object (in bytes)
+ *
+ * Note              : use only at file scope
+ *                     memory objects are not zeroed
+ *
+ ******************************************************************************/
+
+#define      OS_MEM_NOINIT( mem, limit, size )                                \
+              __NOINIT void*mem##__buf[limit*(MHEAD+MSIZE(size))];             \
                        mem_t mem##__mem = _MEM_INIT( limit, size, mem##__buf ); \
                        mem_id mem = & mem##__mem
 
@@ -133,7 +187,28 @@ struct __mem
  ******************************************************************************/
 
 #define         static_MEM( mem, limit, size )                                \
-                static void*mem##__buf[limit*(1+MSIZE(size))];                 \
+    static __OS_NOINIT void*mem##__buf[limit*(MHEAD+MSIZE(size))];             \
+                static mem_t mem##__mem = _MEM_INIT( limit, size, mem##__buf ); \
+                static mem_id mem = & mem##__mem
+
+/******************************************************************************
+ *
+ * Name              : static_MEM_NOINIT
+ *
+ * Description       : define and initialize a static memory pool object
+ *                     with data buffer placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   mem             : name of a pointer to memory pool object
+ *   limit           : size of a buffer (max number of objects)
+ *   size            : size of memory object (in bytes)
+ *
+ * Note              : memory objects are not zeroed
+ *
+ ******************************************************************************/
+
+#define  static_MEM_NOINIT( mem, limit, size )                                \
+       static __NOINIT void*mem##__buf[limit*(MHEAD+MSIZE(size))];             \
                 static mem_t mem##__mem = _MEM_INIT( limit, size, mem##__buf ); \
                 static mem_id mem = & mem##__mem
 
@@ -299,8 +374,7 @@ void mem_delete( mem_t *mem );
  *
  ******************************************************************************/
 
-__STATIC_INLINE
-unsigned mem_waitFor( mem_t *mem, void **data, cnt_t delay ) { return lst_waitFor((lst_t *)mem, data, delay); }
+unsigned mem_waitFor( mem_t *mem, void **data, cnt_t delay );
 
 /******************************************************************************
  *
@@ -323,8 +397,7 @@ unsigned mem_waitFor( mem_t *mem, void **data, cnt_t delay ) { return lst_waitFo
  *
  ******************************************************************************/
 
-__STATIC_INLINE
-unsigned mem_waitUntil( mem_t *mem, void **data, cnt_t time ) { return lst_waitUntil((lst_t *)mem, data, time); }
+unsigned mem_waitUntil( mem_t *mem, void **data, cnt_t time );
 
 /******************************************************************************
  *
@@ -346,7 +419,7 @@ unsigned mem_waitUntil( mem_t *mem, void **data, cnt_t time ) { return lst_waitU
  ******************************************************************************/
 
 __STATIC_INLINE
-unsigned mem_wait( mem_t *mem, void **data ) { return lst_wait((lst_t *)mem, data); }
+unsigned mem_wait( mem_t *mem, void **data ) { return mem_waitFor(mem, data, INFINITE); }
 
 /******************************************************************************
  *
@@ -365,14 +438,14 @@ unsigned mem_wait( mem_t *mem, void **data ) { return lst_wait((lst_t *)mem, dat
  *   E_TIMEOUT       : memory pool object is empty
  *
  * Note              : may be used both in thread and handler mode
+ *                     with OS_MEM_LOCKFREE it does not enter a critical section
  *
  ******************************************************************************/
 
-__STATIC_INLINE
-unsigned mem_take( mem_t *mem, void **data ) { return lst_take((lst_t*)mem, data); }
+unsigned mem_take( mem_t *mem, void **data );
 
 __STATIC_INLINE
-unsigned mem_takeISR( mem_t *mem, void **data ) { return lst_takeISR((lst_t *)mem, data); }
+unsigned mem_takeISR( mem_t *mem, void **data ) { return mem_take(mem, data); }
 
 /******************************************************************************
  *
@@ -388,14 +461,321 @@ unsigned mem_takeISR( mem_t *mem, void **data ) { return lst_takeISR((lst_t *)me
  * Return            : none
  *
  * Note              : may be used both in thread and handler mode
+ *                     with OS_MEM_LOCKFREE it enters a critical section only when a task is waiting for memory object
  *
  ******************************************************************************/
 
+void mem_give( mem_t *mem, const void *data );
+
 __STATIC_INLINE
-void mem_give( mem_t *mem, const void *data ) { lst_give((lst_t *)mem, data); }
+void mem_giveISR( mem_t *mem, const void *data ) { mem_give(mem, data); }
+
+/******************************************************************************
+ *
+ * Name              : mem_getStats
+ *
+ * Description       : take a snapshot of usage statistics of the memory pool object
+ *
+ * Parameters
+ *   mem             : pointer to memory pool object
+ *   stats           : pointer to store the memory pool statistics
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void mem_getStats( mem_t *mem, mst_t *stats );
+
+/******************************************************************************
+ *
+ * Name              : memory pool magazine
+ *
+ * Note              : cache of memory objects placed in front of a shared memory pool object,
+ *                     owned by a single core or by a group of tasks;
+ *                     'mag_take' / 'mag_give' don't touch the free list of the memory pool
+ *                     until the magazine is empty or full, then half of the magazine is exchanged in one batch;
+ *                     memory objects cached in magazines are counted by the memory pool as used
+ *
+ ******************************************************************************/
+
+typedef struct __mag mag_t, * const mag_id;
+
+struct __mag
+{
+	mem_t  * mem;   // memory pool behind the magazine
+	void   * res;   // allocated magazine object's resource
+	unsigned count; // number of memory objects cached in the magazine
+	unsigned limit; // size of the magazine (max number of cached memory objects)
+	void  ** data;  // magazine buffer (pointers to cached memory objects)
+};
+
+/******************************************************************************
+ *
+ * Name              : _MAG_INIT
+ *
+ * Description       : create and initialize a memory pool magazine object
+ *
+ * Parameters
+ *   mem             : pointer to memory pool object
+ *   limit           : size of a magazine (max number of cached memory objects)
+ *   data            : magazine buffer
+ *
+ * Return            : memory pool magazine object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _MAG_INIT( _mem, _limit, _data ) { _mem, 0, 0, _limit, _data }
+
+/******************************************************************************
+ *
+ * Name              : _MAG_DATA
+ *
+ * Description       : create a memory pool magazine buffer
+ *
+ * Parameters
+ *   limit           : size of a magazine (max number of cached memory objects)
+ *
+ * Return            : magazine buffer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _MAG_DATA( _limit ) (void *[_limit]){ 0 }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : OS_MAG
+ *
+ * Description       : define and initialize a memory pool magazine object
+ *
+ * Parameters
+ *   mag             : name of a pointer to memory pool magazine object
+ *   mem             : pointer to memory pool object
+ *   limit           : size of a magazine (max number of cached memory objects)
+ *
+ ******************************************************************************/
+
+#define             OS_MAG( mag, mem, limit )                                \
+           __OS_NOINIT void*mag##__buf[limit];                               \
+                       mag_t mag##__mag = _MAG_INIT( mem, limit, mag##__buf ); \
+                       mag_id mag = & mag##__mag
+
+/******************************************************************************
+ *
+ * Name              : static_MAG
+ *
+ * Description       : define and initialize a static memory pool magazine object
+ *
+ * Parameters
+ *   mag             : name of a pointer to memory pool magazine object
+ *   mem             : pointer to memory pool object
+ *   limit           : size of a magazine (max number of cached memory objects)
+ *
+ ******************************************************************************/
+
+#define         static_MAG( mag, mem, limit )                                \
+    static __OS_NOINIT void*mag##__buf[limit];                               \
+                static mag_t mag##__mag = _MAG_INIT( mem, limit, mag##__buf ); \
+                static mag_id mag = & mag##__mag
+
+/******************************************************************************
+ *
+ * Name              : MAG_INIT
+ *
+ * Description       : create and initialize a memory pool magazine object
+ *
+ * Parameters
+ *   mem             : pointer to memory pool object
+ *   limit           : size of a magazine (max number of cached memory objects)
+ *
+ * Return            : memory pool magazine object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                MAG_INIT( mem, limit ) \
+                      _MAG_INIT( mem, limit, _MAG_DATA( limit ) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : MAG_CREATE
+ * Alias             : MAG_NEW
+ *
+ * Description       : create and initialize a memory pool magazine object
+ *
+ * Parameters
+ *   mem             : pointer to memory pool object
+ *   limit           : size of a magazine (max number of cached memory objects)
+ *
+ * Return            : pointer to memory pool magazine object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                MAG_CREATE( mem, limit ) \
+           (mag_t[]) { MAG_INIT  ( mem, limit ) }
+#define                MAG_NEW \
+                       MAG_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : mag_init
+ *
+ * Description       : initialize a memory pool magazine object
+ *
+ * Parameters
+ *   mag             : pointer to memory pool magazine object
+ *   mem             : pointer to memory pool object
+ *   limit           : size of a magazine (max number of cached memory objects)
+ *   data            : magazine buffer
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void mag_init( mag_t *mag, mem_t *mem, unsigned limit, void *data );
+
+/******************************************************************************
+ *
+ * Name              : mag_create
+ * Alias             : mag_new
+ *
+ * Description       : create and initialize a new memory pool magazine object
+ *
+ * Parameters
+ *   mem             : pointer to memory pool object
+ *   limit           : size of a magazine (max number of cached memory objects)
+ *
+ * Return            : pointer to memory pool magazine object (magazine successfully created)
+ *   0               : magazine not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+mag_t *mag_create( mem_t *mem, unsigned limit );
+
+__STATIC_INLINE
+mag_t *mag_new( mem_t *mem, unsigned limit ) { return mag_create(mem, limit); }
+
+/******************************************************************************
+ *
+ * Name              : mag_flush
+ *
+ * Description       : return all memory objects cached in the magazine to the memory pool object
+ *
+ * Parameters
+ *   mag             : pointer to memory pool magazine object
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void mag_flush( mag_t *mag );
+
+/******************************************************************************
+ *
+ * Name              : mag_delete
+ *
+ * Description       : flush the memory pool magazine object and free allocated resource
+ *
+ * Parameters
+ *   mag             : pointer to memory pool magazine object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void mag_delete( mag_t *mag );
+
+/******************************************************************************
+ *
+ * Name              : mag_take
+ * ISR alias         : mag_takeISR
+ *
+ * Description       : try to get memory object from the magazine,
+ *                     refill the magazine from the memory pool object if it is empty,
+ *                     don't wait if the memory pool object is empty too
+ *
+ * Parameters
+ *   mag             : pointer to memory pool magazine object
+ *   data            : pointer to store the pointer to the memory object
+ *
+ * Return
+ *   E_SUCCESS       : pointer to memory object was successfully transfered to the data pointer
+ *   E_TIMEOUT       : magazine and memory pool object are empty
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned mag_take( mag_t *mag, void **data );
 
 __STATIC_INLINE
-void mem_giveISR( mem_t *mem, const void *data ) { lst_giveISR((lst_t *)mem, data); }
+unsigned mag_takeISR( mag_t *mag, void **data ) { return mag_take(mag, data); }
+
+/******************************************************************************
+ *
+ * Name              : mag_give
+ * ISR alias         : mag_giveISR
+ *
+ * Description       : transfer memory object to the magazine,
+ *                     return half of the magazine to the memory pool object if it is full,
+ *                     transfer memory object directly to the memory pool object if a task is waiting for it
+ *
+ * Parameters
+ *   mag             : pointer to memory pool magazine object
+ *   data            : pointer to memory object (taken from the memory pool object of the magazine)
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void mag_give( mag_t *mag, const void *data );
+
+__STATIC_INLINE
+void mag_giveISR( mag_t *mag, const void *data ) { mag_give(mag, data); }
+
+/******************************************************************************
+ *
+ * Name              : mag_count
+ * ISR alias         : mag_countISR
+ *
+ * Description       : return the number of memory objects cached in the magazine
+ *
+ * Parameters
+ *   mag             : pointer to memory pool magazine object
+ *
+ * Return            : number of cached memory objects
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned mag_count( mag_t *mag ) { return mag->count; }
+
+__STATIC_INLINE
+unsigned mag_countISR( mag_t *mag ) { return mag_count(mag); }
 
 #ifdef __cplusplus
 }
@@ -431,9 +811,10 @@ struct MemoryPoolT : public __mem
 	unsigned takeISR  (       void **_data )               { return mem_takeISR  (this, _data);         }
 	void     give     ( const void  *_data )               {        mem_give     (this, _data);         }
 	void     giveISR  ( const void  *_data )               {        mem_giveISR  (this, _data);         }
+	void     getStats (       mst_t *_stats )              {        mem_getStats (this, _stats);        }
 
 	private:
-	void *data_[limit_ * (1 + MSIZE(size_))];
+	void *data_[limit_ * (MHEAD + MSIZE(size_))];
 };
 
 /******************************************************************************
@@ -460,6 +841,36 @@ struct MemoryPoolTT : public MemoryPoolT<limit_, sizeof(T)>
 	unsigned takeISR  ( T **_data )               { return mem_takeISR  (this, reinterpret_cast<void **>(_data));         }
 };
 
+/******************************************************************************
+ *
+ * Class             : MemoryMagazineT<>
+ *
+ * Description       : create and initialize a memory pool magazine object
+ *
+ * Constructor parameters
+ *   limit           : size of a magazine (max number of cached memory objects)
+ *   mem             : memory pool object
+ *
+ ******************************************************************************/
+
+template<unsigned limit_>
+struct MemoryMagazineT : public __mag
+{
+	 MemoryMagazineT( mem_t &_mem ): __mag _MAG_INIT(&_mem, limit_, data_) {}
+	~MemoryMagazineT( void ) { mag_flush(this); }
+
+	void     flush    ( void )                             {        mag_flush    (this);                }
+	unsigned take     (       void **_data )               { return mag_take     (this, _data);         }
+	unsigned takeISR  (       void **_data )               { return mag_takeISR  (this, _data);         }
+	void     give     ( const void  *_data )               {        mag_give     (this, _data);         }
+	void     giveISR  ( const void  *_data )               {        mag_giveISR  (this, _data);         }
+	unsigned count    ( void )                             { return mag_count    (this);                }
+	unsigned countISR ( void )                             { return mag_countISR (this);                }
+
+	private:
+	void *data_[limit_];
+};
+
 #endif//__cplusplus
 
 /* -------------------------------------------------------------------------- */
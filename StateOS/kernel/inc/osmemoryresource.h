@@ -0,0 +1,276 @@
+/******************************************************************************
+
+    @file    StateOS: osmemoryresource.h
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_PMR_H
+#define __STATEOS_PMR_H
+
+#include "oskernel.h"
+#include "osmemorypool.h"
+#include "osarena.h"
+
+/* -------------------------------------------------------------------------- */
+
+#if defined(__cplusplus) && (__cplusplus >= 201703L) && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
+
+#if defined(__cpp_lib_memory_resource)
+
+/******************************************************************************
+ *
+ * Class             : SystemHeapResource
+ *
+ * Description       : polymorphic memory resource allocating from the system heap (sys_alloc / sys_free)
+ *
+ * Constructor parameters
+ *   upstream        : memory resource used when the system heap is exhausted
+ *
+ * Note              : requests aligned above alignof(void *) are over-allocated,
+ *                     the pointer to the allocated segment is kept in front of the aligned block
+ *
+ ******************************************************************************/
+
+struct SystemHeapResource : public std::pmr::memory_resource
+{
+	SystemHeapResource( std::pmr::memory_resource *_upstream = std::pmr::null_memory_resource() ): upstream_(_upstream) {}
+
+	private:
+	std::pmr::memory_resource *upstream_;
+
+	void *do_allocate( size_t _bytes, size_t _align ) override
+	{
+		void *ptr;
+
+		if (_align <= alignof(void *))
+			ptr = core_sys_alloc(_bytes);
+		else
+		{
+			ptr = core_sys_alloc(_bytes + _align);
+			if (ptr)
+			{
+				void *base = ptr;
+				ptr = reinterpret_cast<void *>((reinterpret_cast<uintptr_t>(ptr) + _align) & ~(uintptr_t)(_align - 1));
+				static_cast<void **>(ptr)[-1] = base;
+			}
+		}
+
+		return ptr ? ptr : upstream_->allocate(_bytes, _align);
+	}
+
+	void do_deallocate( void *_ptr, size_t _bytes, size_t _align ) override
+	{
+		(void) _bytes;
+
+		core_sys_free(_align <= alignof(void *) ? _ptr : static_cast<void **>(_ptr)[-1]);
+	}
+
+	bool do_is_equal( const std::pmr::memory_resource &_other ) const noexcept override
+	{
+		return this == &_other;
+	}
+};
+
+/******************************************************************************
+ *
+ * Class             : MemoryPoolResource
+ *
+ * Description       : polymorphic memory resource allocating fixed-size blocks from a memory pool in constant time
+ *
+ * Constructor parameters
+ *   mem             : memory pool object
+ *   upstream        : memory resource used for requests larger than the memory object of the pool,
+ *                     aligned above alignof(void *) or when the pool is exhausted
+ *
+ * Note              : the memory pool is taken without waiting (mem_take)
+ *
+ ******************************************************************************/
+
+struct MemoryPoolResource : public std::pmr::memory_resource
+{
+	MemoryPoolResource( mem_t &_mem, std::pmr::memory_resource *_upstream = std::pmr::null_memory_resource() ): mem_(&_mem), upstream_(_upstream) {}
+
+	static
+	bool fits( mem_t *_mem, size_t _bytes, size_t _align ) { return _bytes <= _mem->size * sizeof(que_t) && _align <= alignof(que_t); }
+
+	static
+	bool owns( mem_t *_mem, void *_ptr )
+	{
+		que_t *ptr = static_cast<que_t *>(_ptr);
+		que_t *lim = static_cast<que_t *>(_mem->data);
+		return ptr >= lim && ptr < lim + _mem->limit * (MHEAD + _mem->size);
+	}
+
+	private:
+	mem_t *mem_;
+	std::pmr::memory_resource *upstream_;
+
+	void *do_allocate( size_t _bytes, size_t _align ) override
+	{
+		void *ptr;
+
+		if (fits(mem_, _bytes, _align) && mem_take(mem_, &ptr) == E_SUCCESS)
+			return ptr;
+
+		return upstream_->allocate(_bytes, _align);
+	}
+
+	void do_deallocate( void *_ptr, size_t _bytes, size_t _align ) override
+	{
+		if (owns(mem_, _ptr))
+			mem_give(mem_, _ptr);
+		else
+			upstream_->deallocate(_ptr, _bytes, _align);
+	}
+
+	bool do_is_equal( const std::pmr::memory_resource &_other ) const noexcept override
+	{
+		return this == &_other;
+	}
+};
+
+/******************************************************************************
+ *
+ * Class             : MemoryPoolsResource
+ *
+ * Description       : polymorphic memory resource selecting a memory pool by size class
+ *
+ * Constructor parameters
+ *   pools           : array of pointers to memory pool objects, sorted by increasing size of their memory objects
+ *   count           : number of memory pool objects in the array
+ *   upstream        : memory resource used for requests that do not fit any pool or when all fitting pools are exhausted
+ *
+ * Note              : a request is served by the first pool with large enough memory objects that is not exhausted,
+ *                     the pool of a released block is found by its address
+ *
+ ******************************************************************************/
+
+struct MemoryPoolsResource : public std::pmr::memory_resource
+{
+	MemoryPoolsResource( mem_t * const *_pools, size_t _count, std::pmr::memory_resource *_upstream = std::pmr::null_memory_resource() ): pools_(_pools), count_(_count), upstream_(_upstream) {}
+
+	template<size_t limit_>
+	MemoryPoolsResource( mem_t * const (&_pools)[limit_], std::pmr::memory_resource *_upstream = std::pmr::null_memory_resource() ): MemoryPoolsResource(_pools, limit_, _upstream) {}
+
+	private:
+	mem_t * const *pools_;
+	size_t count_;
+	std::pmr::memory_resource *upstream_;
+
+	void *do_allocate( size_t _bytes, size_t _align ) override
+	{
+		void *ptr;
+
+		for (size_t i = 0; i < count_; i++)
+			if (MemoryPoolResource::fits(pools_[i], _bytes, _align) && mem_take(pools_[i], &ptr) == E_SUCCESS)
+				return ptr;
+
+		return upstream_->allocate(_bytes, _align);
+	}
+
+	void do_deallocate( void *_ptr, size_t _bytes, size_t _align ) override
+	{
+		for (size_t i = 0; i < count_; i++)
+		{
+			if (MemoryPoolResource::owns(pools_[i], _ptr))
+			{
+				mem_give(pools_[i], _ptr);
+				return;
+			}
+		}
+
+		upstream_->deallocate(_ptr, _bytes, _align);
+	}
+
+	bool do_is_equal( const std::pmr::memory_resource &_other ) const noexcept override
+	{
+		return this == &_other;
+	}
+};
+
+/******************************************************************************
+ *
+ * Class             : ArenaResource
+ *
+ * Description       : polymorphic memory resource allocating from an arena object (bump pointer)
+ *
+ * Constructor parameters
+ *   arn             : arena object
+ *   upstream        : memory resource used for requests aligned above alignof(stk_t) or when the arena is exhausted
+ *
+ * Note              : deallocation of blocks taken from the arena does nothing,
+ *                     the memory is recovered when the arena is rewound (arn_rewind, arn_reset, ArenaScope)
+ *
+ ******************************************************************************/
+
+struct ArenaResource : public std::pmr::memory_resource
+{
+	ArenaResource( arn_t &_arn, std::pmr::memory_resource *_upstream = std::pmr::null_memory_resource() ): arn_(&_arn), upstream_(_upstream) {}
+
+	private:
+	arn_t *arn_;
+	std::pmr::memory_resource *upstream_;
+
+	bool owns( void *_ptr )
+	{
+		char *ptr = static_cast<char *>(_ptr);
+		char *lim = static_cast<char *>(arn_->data);
+		return ptr >= lim && ptr < lim + arn_->limit;
+	}
+
+	void *do_allocate( size_t _bytes, size_t _align ) override
+	{
+		void *ptr = 0;
+
+		if (_align <= alignof(stk_t))
+			ptr = arn_alloc(arn_, _bytes ? _bytes : 1);
+
+		return ptr ? ptr : upstream_->allocate(_bytes, _align);
+	}
+
+	void do_deallocate( void *_ptr, size_t _bytes, size_t _align ) override
+	{
+		if (!owns(_ptr))
+			upstream_->deallocate(_ptr, _bytes, _align);
+	}
+
+	bool do_is_equal( const std::pmr::memory_resource &_other ) const noexcept override
+	{
+		return this == &_other;
+	}
+};
+
+#endif//__cpp_lib_memory_resource
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_PMR_H
@@ -33,11 +33,37 @@
 #define __STATEOS_MSG_H
 
 #include "oskernel.h"
+#include "osstreambuffer.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define msgPrefixWord ( 0U ) // length prefix stored as unsigned (default)
+#define msgPrefix8    ( 1U ) // length prefix stored as 8-bit value (messages up to 255 bytes)
+#define msgPrefix16   ( 2U ) // length prefix stored as 16-bit value (messages up to 65535 bytes)
+#define msgPrefixVar  ( 3U ) // length prefix stored as varint (7 bits per byte, 1 byte for messages up to 127 bytes)
+
+/******************************************************************************
+ *
+ * Name              : MSG_PREFIX
+ *
+ * Description       : size of the length prefix of a message for the given encoding
+ *
+ * Parameters
+ *   code            : length prefix encoding: msgPrefixWord, msgPrefix8, msgPrefix16, msgPrefixVar
+ *   size            : size of the message (in bytes)
+ *
+ * Return            : size of the length prefix (in bytes)
+ *
+ ******************************************************************************/
+
+#define MSG_PREFIX( code, size ) \
+   ( (code) == msgPrefix8  ? 1U : \
+     (code) == msgPrefix16 ? 2U : \
+     (code) == msgPrefixVar ? ((size) < 0x80U ? 1U : (size) < 0x4000U ? 2U : (size) < 0x200000U ? 3U : (size) < 0x10000000U ? 4U : 5U) : \
+     (unsigned) sizeof(unsigned) )
+
 /******************************************************************************
  *
  * Name              : message buffer
@@ -56,6 +82,9 @@ struct __msg
 	unsigned head;  // inherited from stream buffer
 	unsigned tail;  // inherited from stream buffer
 	char   * data;  // inherited from stream buffer
+	unsigned code;  // length prefix encoding
+	bool     over;  // overwrite mode: the oldest whole messages are dropped when the message buffer is full
+	unsigned drop;  // number of dropped messages
 };
 
 /******************************************************************************
@@ -74,7 +103,26 @@ struct __msg
  *
  ******************************************************************************/
 
-#define               _MSG_INIT( _limit, _data ) { 0, 0, 0, _limit, 0, 0, _data }
+#define               _MSG_INIT( _limit, _data ) { 0, 0, 0, _limit, 0, 0, _data, msgPrefixWord, false, 0 }
+
+/******************************************************************************
+ *
+ * Name              : _MSG_INIT_PREFIX
+ *
+ * Description       : create and initialize a message buffer object with the given length prefix encoding
+ *
+ * Parameters
+ *   limit           : size of a buffer (max number of stored bytes)
+ *   data            : message buffer data
+ *   code            : length prefix encoding: msgPrefixWord, msgPrefix8, msgPrefix16, msgPrefixVar
+ *
+ * Return            : message buffer object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _MSG_INIT_PREFIX( _limit, _data, _code ) { 0, 0, 0, _limit, 0, 0, _data, _code, false, 0 }
 
 /******************************************************************************
  *
@@ -108,6 +156,19 @@ struct __msg
 #define               _VA_MSG( _limit, _size ) \
                        ( (_size + 0) ? ((_limit) * (sizeof(unsigned) + (_size + 0))) : (_limit) )
 
+/******************************************************************************
+ *
+ * Name              : _VA_MSG_PREFIX
+ *
+ * Description       : calculate buffer size from optional parameter for the given length prefix encoding
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _VA_MSG_PREFIX( _code, _limit, _size ) \
+                       ( (_size + 0) ? ((_limit) * (MSG_PREFIX(_code, _size + 0) + (_size + 0))) : (_limit) )
+
 /******************************************************************************
  *
  * Name              : OS_MSG
@@ -122,10 +183,50 @@ struct __msg
  ******************************************************************************/
 
 #define             OS_MSG( msg, limit, ... )                                                 \
-                       char msg##__buf[_VA_MSG(limit, __VA_ARGS__)];                           \
+           __OS_NOINIT char msg##__buf[_VA_MSG(limit, __VA_ARGS__)];                           \
+                       msg_t msg##__msg = _MSG_INIT( _VA_MSG(limit, __VA_ARGS__), msg##__buf ); \
+                       msg_id msg = & msg##__msg
+
+/******************************************************************************
+ *
+ * Name              : OS_MSG_NOINIT
+ *
+ * Description       : define and initialize a message buffer object
+ *                     with data buffer placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   msg             : name of a pointer to message buffer object
+ *   limit           : size of a buffer (max number of stored bytes / objects)
+ *   type            : (optional) size of the object (in bytes)
+ *
+ * Note              : use only at file scope
+ *
+ ******************************************************************************/
+
+#define      OS_MSG_NOINIT( msg, limit, ... )                                                 \
+              __NOINIT char msg##__buf[_VA_MSG(limit, __VA_ARGS__)];                           \
                        msg_t msg##__msg = _MSG_INIT( _VA_MSG(limit, __VA_ARGS__), msg##__buf ); \
                        msg_id msg = & msg##__msg
 
+/******************************************************************************
+ *
+ * Name              : OS_MSG_PREFIX
+ *
+ * Description       : define and initialize a message buffer object with the given length prefix encoding
+ *
+ * Parameters
+ *   msg             : name of a pointer to message buffer object
+ *   code            : length prefix encoding: msgPrefixWord, msgPrefix8, msgPrefix16, msgPrefixVar
+ *   limit           : size of a buffer (max number of stored bytes / objects)
+ *   type            : (optional) size of the object (in bytes)
+ *
+ ******************************************************************************/
+
+#define             OS_MSG_PREFIX( msg, code, limit, ... )                                                         \
+           __OS_NOINIT char msg##__buf[_VA_MSG_PREFIX(code, limit, __VA_ARGS__)];                                \
+                       msg_t msg##__msg = _MSG_INIT_PREFIX( _VA_MSG_PREFIX(code, limit, __VA_ARGS__), msg##__buf, code ); \
+                       msg_id msg = & msg##__msg
+
 /******************************************************************************
  *
  * Name              : static_MSG
@@ -140,10 +241,48 @@ struct __msg
  ******************************************************************************/
 
 #define         static_MSG( msg, limit, ... )                                                 \
-                static char msg##__buf[_VA_MSG(limit, __VA_ARGS__)];                           \
+    static __OS_NOINIT char msg##__buf[_VA_MSG(limit, __VA_ARGS__)];                           \
                 static msg_t msg##__msg = _MSG_INIT( _VA_MSG(limit, __VA_ARGS__), msg##__buf ); \
                 static msg_id msg = & msg##__msg
 
+/******************************************************************************
+ *
+ * Name              : static_MSG_NOINIT
+ *
+ * Description       : define and initialize a static message buffer object
+ *                     with data buffer placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   msg             : name of a pointer to message buffer object
+ *   limit           : size of a buffer (max number of stored bytes / objects)
+ *   type            : (optional) size of the object (in bytes)
+ *
+ ******************************************************************************/
+
+#define  static_MSG_NOINIT( msg, limit, ... )                                                 \
+       static __NOINIT char msg##__buf[_VA_MSG(limit, __VA_ARGS__)];                           \
+                static msg_t msg##__msg = _MSG_INIT( _VA_MSG(limit, __VA_ARGS__), msg##__buf ); \
+                static msg_id msg = & msg##__msg
+
+/******************************************************************************
+ *
+ * Name              : static_MSG_PREFIX
+ *
+ * Description       : define and initialize a static message buffer object with the given length prefix encoding
+ *
+ * Parameters
+ *   msg             : name of a pointer to message buffer object
+ *   code            : length prefix encoding: msgPrefixWord, msgPrefix8, msgPrefix16, msgPrefixVar
+ *   limit           : size of a buffer (max number of stored bytes / objects)
+ *   type            : (optional) size of the object (in bytes)
+ *
+ ******************************************************************************/
+
+#define         static_MSG_PREFIX( msg, code, limit, ... )                                                         \
+    static __OS_NOINIT char msg##__buf[_VA_MSG_PREFIX(code, limit, __VA_ARGS__)];                                \
+                static msg_t msg##__msg = _MSG_INIT_PREFIX( _VA_MSG_PREFIX(code, limit, __VA_ARGS__), msg##__buf, code ); \
+                static msg_id msg = & msg##__msg
+
 /******************************************************************************
  *
  * Name              : MSG_INIT
@@ -208,6 +347,30 @@ struct __msg
 
 void msg_init( msg_t *msg, unsigned limit, void *data );
 
+/******************************************************************************
+ *
+ * Name              : msg_initPrefix
+ *
+ * Description       : initialize a message buffer object with the given length prefix encoding
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   limit           : size of a buffer (max number of stored bytes)
+ *   data            : message buffer data
+ *   code            : length prefix encoding
+ *                     msgPrefixWord: unsigned prefix (as msg_init)
+ *                     msgPrefix8:    8-bit prefix, messages up to 255 bytes
+ *                     msgPrefix16:   16-bit prefix, messages up to 65535 bytes
+ *                     msgPrefixVar:  varint prefix, 1 byte for messages up to 127 bytes, 2 bytes up to 16383 bytes
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void msg_initPrefix( msg_t *msg, unsigned limit, void *data, unsigned code );
+
 /******************************************************************************
  *
  * Name              : msg_create
@@ -230,6 +393,25 @@ msg_t *msg_create( unsigned limit );
 __STATIC_INLINE
 msg_t *msg_new( unsigned limit ) { return msg_create(limit); }
 
+/******************************************************************************
+ *
+ * Name              : msg_createPrefix
+ *
+ * Description       : create and initialize a new message buffer object with the given length prefix encoding
+ *
+ * Parameters
+ *   limit           : size of a buffer (max number of stored bytes)
+ *   code            : length prefix encoding: msgPrefixWord, msgPrefix8, msgPrefix16, msgPrefixVar
+ *
+ * Return            : pointer to message buffer object (message buffer successfully created)
+ *   0               : message buffer not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+msg_t *msg_createPrefix( unsigned limit, unsigned code );
+
 /******************************************************************************
  *
  * Name              : msg_kill
@@ -329,6 +511,50 @@ unsigned msg_waitUntil( msg_t *msg, void *data, unsigned size, cnt_t time );
 __STATIC_INLINE
 unsigned msg_wait( msg_t *msg, void *data, unsigned size ) { return msg_waitFor(msg, data, size, INFINITE); }
 
+/******************************************************************************
+ *
+ * Name              : msg_waitv
+ *
+ * Description       : try to transfer data from the message buffer object directly to the fragments of write buffer (scatter),
+ *                     wait for given duration of time while the message buffer object is empty
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   iov             : array of fragments of write buffer, filled in order
+ *   cnt             : number of fragments
+ *   delay           : duration of time (maximum number of ticks to wait while the message buffer object is empty)
+ *                     IMMEDIATE: don't wait if the message buffer object is empty
+ *                     INFINITE:  wait indefinitely while the message buffer object is empty
+ *
+ * Return            : number of bytes read from the message buffer
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned msg_waitv( msg_t *msg, const iov_t *iov, unsigned cnt, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : msg_waitvUntil
+ *
+ * Description       : try to transfer data from the message buffer object directly to the fragments of write buffer (scatter),
+ *                     wait until given timepoint while the message buffer object is empty
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   iov             : array of fragments of write buffer, filled in order
+ *   cnt             : number of fragments
+ *   time            : timepoint value
+ *
+ * Return            : number of bytes read from the message buffer
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned msg_waitvUntil( msg_t *msg, const iov_t *iov, unsigned cnt, cnt_t time );
+
 /******************************************************************************
  *
  * Name              : msg_take
@@ -418,6 +644,52 @@ unsigned msg_sendUntil( msg_t *msg, const void *data, unsigned size, cnt_t time
 __STATIC_INLINE
 unsigned msg_send( msg_t *msg, const void *data, unsigned size ) { return msg_sendFor(msg, data, size, INFINITE); }
 
+/******************************************************************************
+ *
+ * Name              : msg_sendv
+ *
+ * Description       : try to transfer data directly from the fragments of read buffer to the message buffer object (gather),
+ *                     as a single message, wait for given duration of time while the message buffer object is full
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   iov             : array of fragments of read buffer, read in order
+ *   cnt             : number of fragments
+ *   delay           : duration of time (maximum number of ticks to wait while the message buffer object is full)
+ *                     IMMEDIATE: don't wait if the message buffer object is full
+ *                     INFINITE:  wait indefinitely while the message buffer object is full
+ *
+ * Return            : number of bytes written to the message buffer (total size of the fragments)
+ *
+ * Note              : use only in thread mode
+ *                     fragments must not be changed until the function returns
+ *
+ ******************************************************************************/
+
+unsigned msg_sendv( msg_t *msg, const iov_t *iov, unsigned cnt, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : msg_sendvUntil
+ *
+ * Description       : try to transfer data directly from the fragments of read buffer to the message buffer object (gather),
+ *                     as a single message, wait until given timepoint while the message buffer object is full
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   iov             : array of fragments of read buffer, read in order
+ *   cnt             : number of fragments
+ *   time            : timepoint value
+ *
+ * Return            : number of bytes written to the message buffer (total size of the fragments)
+ *
+ * Note              : use only in thread mode
+ *                     fragments must not be changed until the function returns
+ *
+ ******************************************************************************/
+
+unsigned msg_sendvUntil( msg_t *msg, const iov_t *iov, unsigned cnt, cnt_t time );
+
 /******************************************************************************
  *
  * Name              : msg_give
@@ -466,6 +738,118 @@ unsigned msg_push( msg_t *msg, const void *data, unsigned size );
 __STATIC_INLINE
 unsigned msg_pushISR( msg_t *msg, const void *data, unsigned size ) { return msg_push(msg, data, size); }
 
+/******************************************************************************
+ *
+ * Name              : msg_splice
+ * ISR alias         : msg_spliceISR
+ *
+ * Description       : try to move data from the stream buffer object to the message buffer object as one message,
+ *                     the data is copied directly between the ring buffers in a single critical section
+ *                     (no intermediate buffer), waiting readers and writers of both objects are served,
+ *                     don't wait if the stream buffer object is empty or the message buffer object is full
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   src             : pointer to source stream buffer object
+ *   size            : maximum number of bytes to move (maximum size of the message)
+ *
+ * Return            : number of bytes moved (size of the message written to the message buffer)
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned msg_splice( msg_t *msg, stm_t *src, unsigned size );
+
+__STATIC_INLINE
+unsigned msg_spliceISR( msg_t *msg, stm_t *src, unsigned size ) { return msg_splice(msg, src, size); }
+
+/******************************************************************************
+ *
+ * Name              : msg_spliceFor
+ *
+ * Description       : try to move data from the stream buffer object to the message buffer object as one message,
+ *                     wait for given duration of time while the stream buffer object is empty
+ *                     (or contains less data than its trigger level), as 'msg_splice'
+ *                     never wait for free space in the message buffer object
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   src             : pointer to source stream buffer object
+ *   size            : maximum number of bytes to move (maximum size of the message)
+ *   delay           : duration of time (maximum number of ticks to wait while the stream buffer object is empty)
+ *                     IMMEDIATE: don't wait if the stream buffer object is empty
+ *                     INFINITE:  wait indefinitely while the stream buffer object is empty
+ *
+ * Return            : number of bytes moved (size of the message written to the message buffer)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned msg_spliceFor( msg_t *msg, stm_t *src, unsigned size, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : msg_spliceUntil
+ *
+ * Description       : try to move data from the stream buffer object to the message buffer object as one message,
+ *                     wait until given timepoint while the stream buffer object is empty
+ *                     (or contains less data than its trigger level), as 'msg_splice'
+ *                     never wait for free space in the message buffer object
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   src             : pointer to source stream buffer object
+ *   size            : maximum number of bytes to move (maximum size of the message)
+ *   time            : timepoint value
+ *
+ * Return            : number of bytes moved (size of the message written to the message buffer)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned msg_spliceUntil( msg_t *msg, stm_t *src, unsigned size, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : msg_setOverwrite
+ *
+ * Description       : set overwrite mode of the message buffer object,
+ *                     in overwrite mode 'msg_give' and 'msg_send' never block nor fail for lack of space,
+ *                     they remove the oldest whole messages (as 'msg_push') when the message buffer object is full
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *   enable          : true: overwrite mode, false: normal mode
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     should be set after initialization, before the message buffer object is used
+ *
+ ******************************************************************************/
+
+void msg_setOverwrite( msg_t *msg, bool enable );
+
+/******************************************************************************
+ *
+ * Name              : msg_dropped
+ *
+ * Description       : return the number of messages removed from the message buffer object to make space for new ones
+ *
+ * Parameters
+ *   msg             : pointer to message buffer object
+ *
+ * Return            : number of dropped messages
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned msg_dropped( msg_t *msg );
+
 /******************************************************************************
  *
  * Name              : msg_count
@@ -545,13 +929,14 @@ unsigned msg_limitISR( msg_t *msg ) { return msg_limit(msg); }
  *
  * Constructor parameters
  *   limit           : size of a buffer (max number of stored bytes)
+ *   code            : (optional) length prefix encoding: msgPrefixWord (default), msgPrefix8, msgPrefix16, msgPrefixVar
  *
  ******************************************************************************/
 
-template<unsigned limit_>
+template<unsigned limit_, unsigned code_ = msgPrefixWord>
 struct MessageBufferT : public __msg
 {
-	 MessageBufferT( void ): __msg _MSG_INIT(limit_, data_) {}
+	 MessageBufferT( void ): __msg _MSG_INIT_PREFIX(limit_, data_, code_) {}
 	~MessageBufferT( void ) { assert(__msg::queue == nullptr); }
 
 	void     kill     ( void )                                            {        msg_kill     (this);                       }
@@ -561,12 +946,22 @@ struct MessageBufferT : public __msg
 	unsigned take     (       void *_data, unsigned _size )               { return msg_take     (this, _data, _size);         }
 	unsigned takeISR  (       void *_data, unsigned _size )               { return msg_takeISR  (this, _data, _size);         }
 	unsigned sendFor  ( const void *_data, unsigned _size, cnt_t _delay ) { return msg_sendFor  (this, _data, _size, _delay); }
+	unsigned waitv    ( const iov_t *_iov, unsigned _cnt, cnt_t _delay )  { return msg_waitv    (this, _iov, _cnt, _delay);   }
+	unsigned waitvUntil( const iov_t *_iov, unsigned _cnt, cnt_t _time )  { return msg_waitvUntil(this, _iov, _cnt, _time);   }
+	unsigned sendv    ( const iov_t *_iov, unsigned _cnt, cnt_t _delay )  { return msg_sendv    (this, _iov, _cnt, _delay);   }
+	unsigned sendvUntil( const iov_t *_iov, unsigned _cnt, cnt_t _time )  { return msg_sendvUntil(this, _iov, _cnt, _time);   }
 	unsigned sendUntil( const void *_data, unsigned _size, cnt_t _time )  { return msg_sendUntil(this, _data, _size, _time);  }
 	unsigned send     ( const void *_data, unsigned _size )               { return msg_send     (this, _data, _size);         }
 	unsigned give     ( const void *_data, unsigned _size )               { return msg_give     (this, _data, _size);         }
 	unsigned giveISR  ( const void *_data, unsigned _size )               { return msg_giveISR  (this, _data, _size);         }
 	unsigned push     ( const void *_data, unsigned _size )               { return msg_push     (this, _data, _size);         }
 	unsigned pushISR  ( const void *_data, unsigned _size )               { return msg_pushISR  (this, _data, _size);         }
+	unsigned splice   ( stm_t *_src, unsigned _size )                     { return msg_splice   (this, _src, _size);          }
+	unsigned spliceISR( stm_t *_src, unsigned _size )                     { return msg_spliceISR(this, _src, _size);          }
+	unsigned spliceFor( stm_t *_src, unsigned _size, cnt_t _delay )       { return msg_spliceFor(this, _src, _size, _delay);  }
+	unsigned spliceUntil( stm_t *_src, unsigned _size, cnt_t _time )      { return msg_spliceUntil(this, _src, _size, _time); }
+	void     setOverwrite( bool _enable )                                 {        msg_setOverwrite(this, _enable);           }
+	unsigned dropped  ( void )                                            { return msg_dropped  (this);                       }
 	unsigned count    ( void )                                            { return msg_count    (this);                       }
 	unsigned countISR ( void )                                            { return msg_countISR (this);                       }
 	unsigned space    ( void )                                            { return msg_space    (this);                       }
@@ -587,13 +982,14 @@ struct MessageBufferT : public __msg
  * Constructor parameters
  *   limit           : size of a buffer (max number of stored objects)
  *   T               : class of an object
+ *   code            : (optional) length prefix encoding: msgPrefixWord (default), msgPrefix8, msgPrefix16, msgPrefixVar
  *
  ******************************************************************************/
 
-template<unsigned limit_, class T>
-struct MessageBufferTT : public MessageBufferT<limit_*(sizeof(unsigned)+sizeof(T))>
+template<unsigned limit_, class T, unsigned code_ = msgPrefixWord>
+struct MessageBufferTT : public MessageBufferT<limit_*(MSG_PREFIX(code_, sizeof(T))+sizeof(T)), code_>
 {
-	MessageBufferTT( void ): MessageBufferT<limit_*(sizeof(unsigned)+sizeof(T))>() {}
+	MessageBufferTT( void ): MessageBufferT<limit_*(MSG_PREFIX(code_, sizeof(T))+sizeof(T)), code_>() {}
 
 	unsigned waitFor  (       T *_data, cnt_t _delay ) { return msg_waitFor  (this, _data, sizeof(T), _delay); }
 	unsigned waitUntil(       T *_data, cnt_t _time )  { return msg_waitUntil(this, _data, sizeof(T), _time);  }
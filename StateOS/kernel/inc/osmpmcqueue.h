@@ -0,0 +1,623 @@
+/******************************************************************************
+
+    @file    StateOS: osmpmcqueue.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_MPQ_H
+#define __STATEOS_MPQ_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : mpmc queue
+ *
+ * Note              : bounded lock-free multi-producer / multi-consumer mailbox queue
+ *                     every slot of the data buffer holds a sequence number followed by a mail,
+ *                     slots are claimed with an atomic compare-and-swap of 'head' / 'tail'
+ *                     and released by writing the sequence number, interrupts are not masked
+ *                     sequence numbers are stored relative to the slot index, so the zeroed buffer is an empty queue
+ *
+ ******************************************************************************/
+
+typedef struct __mpq mpq_t, * const mpq_id;
+
+struct __mpq
+{
+	tsk_t  * queue; // next process in the DELAYED queue (consumers waiting while the queue is empty)
+	void   * res;   // allocated mpmc queue object's resource
+	tsk_t  * send;  // next process in the DELAYED queue of producers (waiting while the queue is full)
+	volatile
+	unsigned head;  // free-running position of the next slot to read
+	volatile
+	unsigned tail;  // free-running position of the next slot to write
+	unsigned mask;  // size of a queue - 1 (size is a power of 2)
+	unsigned size;  // size of a single mail (in bytes)
+	unsigned*data;  // data buffer (slots)
+};
+
+/******************************************************************************
+ *
+ * Name              : _MPQ_INIT
+ *
+ * Description       : create and initialize a mpmc queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails), must be a power of 2
+ *   data            : mpmc queue data buffer (must be zeroed)
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : mpmc queue object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _MPQ_INIT( _limit, _data, _size ) { 0, 0, 0, 0, 0, (_limit) - 1, _size, _data }
+
+/******************************************************************************
+ *
+ * Name              : _MPQ_DATA
+ *
+ * Description       : create a mpmc queue data buffer
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails), must be a power of 2
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : mpmc queue data buffer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _MPQ_DATA( _limit, _size ) (unsigned[_MPQ_SIZE(_limit) * _MPQ_SLOT(_size)]){ 0 }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : _MPQ_SIZE
+ *
+ * Description       : check size of a mpmc queue, compilation fails if it is not a power of 2
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _MPQ_SIZE( _limit ) \
+                       ( ((_limit) > 0 && ((_limit) & ((_limit) - 1)) == 0) ? (_limit) : -1 )
+
+/******************************************************************************
+ *
+ * Name              : _MPQ_SLOT
+ *
+ * Description       : size of a single slot of the mpmc queue data buffer (in words):
+ *                     sequence number and mail aligned to unsigned
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _MPQ_SLOT( _size ) \
+                       ( 1 + ALIGNED_SIZE(_size, unsigned) )
+
+/******************************************************************************
+ *
+ * Name              : OS_MPQ
+ *
+ * Description       : define and initialize a mpmc queue object
+ *
+ * Parameters
+ *   mpq             : name of a pointer to mpmc queue object
+ *   limit           : size of a queue (max number of stored mails), must be a power of 2
+ *   size            : size of a single mail (in bytes)
+ *
+ * Note              : data buffer is not placed in the '.noinit' section, it must be zeroed at startup
+ *
+ ******************************************************************************/
+
+#define             OS_MPQ( mpq, limit, size )                                \
+                       unsigned mpq##__buf[_MPQ_SIZE(limit) * _MPQ_SLOT(size)]; \
+                       mpq_t mpq##__mpq = _MPQ_INIT( limit, mpq##__buf, size ); \
+                       mpq_id mpq = & mpq##__mpq
+
+/******************************************************************************
+ *
+ * Name              : static_MPQ
+ *
+ * Description       : define and initialize a static mpmc queue object
+ *
+ * Parameters
+ *   mpq             : name of a pointer to mpmc queue object
+ *   limit           : size of a queue (max number of stored mails), must be a power of 2
+ *   size            : size of a single mail (in bytes)
+ *
+ * Note              : data buffer is not placed in the '.noinit' section, it must be zeroed at startup
+ *
+ ******************************************************************************/
+
+#define         static_MPQ( mpq, limit, size )                                \
+                static unsigned mpq##__buf[_MPQ_SIZE(limit) * _MPQ_SLOT(size)]; \
+                static mpq_t mpq##__mpq = _MPQ_INIT( limit, mpq##__buf, size ); \
+                static mpq_id mpq = & mpq##__mpq
+
+/******************************************************************************
+ *
+ * Name              : MPQ_INIT
+ *
+ * Description       : create and initialize a mpmc queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails), must be a power of 2
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : mpmc queue object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                MPQ_INIT( limit, size ) \
+                      _MPQ_INIT( limit, _MPQ_DATA( limit, size ), size )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : MPQ_CREATE
+ * Alias             : MPQ_NEW
+ *
+ * Description       : create and initialize a mpmc queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails), must be a power of 2
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : pointer to mpmc queue object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                MPQ_CREATE( limit, size ) \
+           (mpq_t[]) { MPQ_INIT  ( limit, size ) }
+#define                MPQ_NEW \
+                       MPQ_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : mpq_init
+ *
+ * Description       : initialize a mpmc queue object
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *   limit           : size of a queue (max number of stored mails), must be a power of 2
+ *   data            : mpmc queue data buffer (limit * _MPQ_SLOT(size) words)
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void mpq_init( mpq_t *mpq, unsigned limit, void *data, unsigned size );
+
+/******************************************************************************
+ *
+ * Name              : mpq_create
+ * Alias             : mpq_new
+ *
+ * Description       : create and initialize a new mpmc queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails), must be a power of 2
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : pointer to mpmc queue object (mpmc queue successfully created)
+ *   0               : mpmc queue not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+mpq_t *mpq_create( unsigned limit, unsigned size );
+
+__STATIC_INLINE
+mpq_t *mpq_new( unsigned limit, unsigned size ) { return mpq_create(limit, size); }
+
+/******************************************************************************
+ *
+ * Name              : mpq_kill
+ *
+ * Description       : reset the mpmc queue object and wake up all waiting tasks with 'E_STOPPED' event value
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     producers and consumers must not use the mpmc queue at the same time
+ *
+ ******************************************************************************/
+
+void mpq_kill( mpq_t *mpq );
+
+/******************************************************************************
+ *
+ * Name              : mpq_delete
+ *
+ * Description       : reset the mpmc queue object and free allocated resource
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void mpq_delete( mpq_t *mpq );
+
+/******************************************************************************
+ *
+ * Name              : mpq_take
+ * ISR alias         : mpq_takeISR
+ *
+ * Description       : try to transfer mailbox data from the mpmc queue object,
+ *                     don't wait if the mpmc queue object is empty
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *   data            : pointer to store mailbox data
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered from the mpmc queue object
+ *   E_TIMEOUT       : mpmc queue object is empty
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     interrupts are masked only to wake up a producer waiting for free space
+ *
+ ******************************************************************************/
+
+unsigned mpq_take( mpq_t *mpq, void *data );
+
+__STATIC_INLINE
+unsigned mpq_takeISR( mpq_t *mpq, void *data ) { return mpq_take(mpq, data); }
+
+/******************************************************************************
+ *
+ * Name              : mpq_waitFor
+ *
+ * Description       : try to transfer mailbox data from the mpmc queue object,
+ *                     wait for given duration of time while the mpmc queue object is empty
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *   data            : pointer to store mailbox data
+ *   delay           : duration of time (maximum number of ticks to wait while the mpmc queue object is empty)
+ *                     IMMEDIATE: don't wait if the mpmc queue object is empty
+ *                     INFINITE:  wait indefinitely while the mpmc queue object is empty
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered from the mpmc queue object
+ *   E_STOPPED       : mpmc queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : mpmc queue object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned mpq_waitFor( mpq_t *mpq, void *data, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : mpq_waitUntil
+ *
+ * Description       : try to transfer mailbox data from the mpmc queue object,
+ *                     wait until given timepoint while the mpmc queue object is empty
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *   data            : pointer to store mailbox data
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered from the mpmc queue object
+ *   E_STOPPED       : mpmc queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : mpmc queue object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned mpq_waitUntil( mpq_t *mpq, void *data, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : mpq_wait
+ *
+ * Description       : try to transfer mailbox data from the mpmc queue object,
+ *                     wait indefinitely while the mpmc queue object is empty
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *   data            : pointer to store mailbox data
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered from the mpmc queue object
+ *   E_STOPPED       : mpmc queue object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned mpq_wait( mpq_t *mpq, void *data ) { return mpq_waitFor(mpq, data, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : mpq_give
+ * ISR alias         : mpq_giveISR
+ *
+ * Description       : try to transfer mailbox data to the mpmc queue object,
+ *                     don't wait if the mpmc queue object is full
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *   data            : pointer to mailbox data
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered to the mpmc queue object
+ *   E_TIMEOUT       : mpmc queue object is full
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     interrupts are masked only to wake up a consumer waiting for data
+ *
+ ******************************************************************************/
+
+unsigned mpq_give( mpq_t *mpq, const void *data );
+
+__STATIC_INLINE
+unsigned mpq_giveISR( mpq_t *mpq, const void *data ) { return mpq_give(mpq, data); }
+
+/******************************************************************************
+ *
+ * Name              : mpq_sendFor
+ *
+ * Description       : try to transfer mailbox data to the mpmc queue object,
+ *                     wait for given duration of time while the mpmc queue object is full
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *   data            : pointer to mailbox data
+ *   delay           : duration of time (maximum number of ticks to wait while the mpmc queue object is full)
+ *                     IMMEDIATE: don't wait if the mpmc queue object is full
+ *                     INFINITE:  wait indefinitely while the mpmc queue object is full
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered to the mpmc queue object
+ *   E_STOPPED       : mpmc queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : mpmc queue object is full and was not issued data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned mpq_sendFor( mpq_t *mpq, const void *data, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : mpq_sendUntil
+ *
+ * Description       : try to transfer mailbox data to the mpmc queue object,
+ *                     wait until given timepoint while the mpmc queue object is full
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *   data            : pointer to mailbox data
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered to the mpmc queue object
+ *   E_STOPPED       : mpmc queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : mpmc queue object is full and was not issued data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned mpq_sendUntil( mpq_t *mpq, const void *data, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : mpq_send
+ *
+ * Description       : try to transfer mailbox data to the mpmc queue object,
+ *                     wait indefinitely while the mpmc queue object is full
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *   data            : pointer to mailbox data
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered to the mpmc queue object
+ *   E_STOPPED       : mpmc queue object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned mpq_send( mpq_t *mpq, const void *data ) { return mpq_sendFor(mpq, data, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : mpq_count
+ * ISR alias         : mpq_countISR
+ *
+ * Description       : return the amount of data contained in the mpmc queue
+ *                     (approximate, if the mpmc queue is in use at the same time)
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *
+ * Return            : amount of data contained in the mpmc queue
+ *
+ ******************************************************************************/
+
+unsigned mpq_count( mpq_t *mpq );
+
+__STATIC_INLINE
+unsigned mpq_countISR( mpq_t *mpq ) { return mpq_count(mpq); }
+
+/******************************************************************************
+ *
+ * Name              : mpq_space
+ * ISR alias         : mpq_spaceISR
+ *
+ * Description       : return the amount of free space in the mpmc queue
+ *                     (approximate, if the mpmc queue is in use at the same time)
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *
+ * Return            : amount of free space in the mpmc queue
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned mpq_space( mpq_t *mpq ) { return mpq->mask + 1 - mpq_count(mpq); }
+
+__STATIC_INLINE
+unsigned mpq_spaceISR( mpq_t *mpq ) { return mpq_space(mpq); }
+
+/******************************************************************************
+ *
+ * Name              : mpq_limit
+ * ISR alias         : mpq_limitISR
+ *
+ * Description       : return the size of the mpmc queue
+ *
+ * Parameters
+ *   mpq             : pointer to mpmc queue object
+ *
+ * Return            : size of the mpmc queue (max number of stored mails)
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned mpq_limit( mpq_t *mpq ) { return mpq->mask + 1; }
+
+__STATIC_INLINE
+unsigned mpq_limitISR( mpq_t *mpq ) { return mpq_limit(mpq); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : MpmcQueueT<>
+ *
+ * Description       : create and initialize a mpmc queue object
+ *
+ * Constructor parameters
+ *   limit           : size of a queue (max number of stored mails), must be a power of 2
+ *   size            : size of a single mail (in bytes)
+ *
+ ******************************************************************************/
+
+template<unsigned limit_, unsigned size_>
+struct MpmcQueueT : public __mpq
+{
+	static_assert(limit_ > 0 && (limit_ & (limit_ - 1)) == 0, "size of a mpmc queue must be a power of 2");
+
+	 MpmcQueueT( void ): __mpq _MPQ_INIT(limit_, data_, size_), data_{} {}
+	~MpmcQueueT( void ) { assert(__mpq::queue == nullptr && __mpq::send == nullptr); }
+
+	void     kill     ( void )                            {        mpq_kill     (this);                }
+	unsigned waitFor  (       void *_data, cnt_t _delay ) { return mpq_waitFor  (this, _data, _delay); }
+	unsigned waitUntil(       void *_data, cnt_t _time )  { return mpq_waitUntil(this, _data, _time);  }
+	unsigned wait     (       void *_data )               { return mpq_wait     (this, _data);         }
+	unsigned take     (       void *_data )               { return mpq_take     (this, _data);         }
+	unsigned takeISR  (       void *_data )               { return mpq_takeISR  (this, _data);         }
+	unsigned sendFor  ( const void *_data, cnt_t _delay ) { return mpq_sendFor  (this, _data, _delay); }
+	unsigned sendUntil( const void *_data, cnt_t _time )  { return mpq_sendUntil(this, _data, _time);  }
+	unsigned send     ( const void *_data )               { return mpq_send     (this, _data);         }
+	unsigned give     ( const void *_data )               { return mpq_give     (this, _data);         }
+	unsigned giveISR  ( const void *_data )               { return mpq_giveISR  (this, _data);         }
+	unsigned count    ( void )                            { return mpq_count    (this);                }
+	unsigned countISR ( void )                            { return mpq_countISR (this);                }
+	unsigned space    ( void )                            { return mpq_space    (this);                }
+	unsigned spaceISR ( void )                            { return mpq_spaceISR (this);                }
+	unsigned limit    ( void )                            { return mpq_limit    (this);                }
+	unsigned limitISR ( void )                            { return mpq_limitISR (this);                }
+
+	private:
+	unsigned data_[limit_ * _MPQ_SLOT(size_)];
+};
+
+/******************************************************************************
+ *
+ * Class             : MpmcQueueTT<>
+ *
+ * Description       : create and initialize a mpmc queue object
+ *
+ * Constructor parameters
+ *   limit           : size of a queue (max number of stored mails), must be a power of 2
+ *   T               : class of a single mail
+ *
+ ******************************************************************************/
+
+template<unsigned limit_, class T>
+struct MpmcQueueTT : public MpmcQueueT<limit_, sizeof(T)>
+{
+	MpmcQueueTT( void ): MpmcQueueT<limit_, sizeof(T)>() {}
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_MPQ_H
@@ -43,6 +43,9 @@ extern "C" {
  * Name              : mutex
  *                     like a POSIX pthread_mutex_t
  *
+ * Note              : priority inheritance mutex (ceiling == 0) or priority ceiling mutex (ceiling > 0),
+ *                     the owner of priority ceiling mutex immediately gets the ceiling priority
+ *
  ******************************************************************************/
 
 typedef struct __mtx mtx_t, * const mtx_id;
@@ -54,6 +57,11 @@ struct __mtx
 	tsk_t  * owner; // owner task
 	unsigned count; // mutex's curent value
 	mtx_t  * list;  // list of mutexes held by owner
+	unsigned ceiling; // priority ceiling (0 for priority inheritance)
+	bool     barging; // release makes the mutex free and wakes up a waiter to retry, instead of handing it over
+#if OS_OBJ_STATS
+	ost_t    ost;   // contention statistics
+#endif
 };
 
 /******************************************************************************
@@ -70,7 +78,40 @@ struct __mtx
  *
  ******************************************************************************/
 
-#define               _MTX_INIT() { 0, 0, 0, 0, 0 }
+#define               _MTX_INIT() _MTX_INIT_CEILING( 0 )
+
+/******************************************************************************
+ *
+ * Name              : _MTX_INIT_CEILING
+ *
+ * Description       : create and initialize a priority ceiling mutex object
+ *
+ * Parameters
+ *   ceiling         : priority ceiling, the highest priority of tasks using the mutex
+ *
+ * Return            : mutex object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _MTX_INIT_CEILING( _ceiling ) { 0, 0, 0, 0, 0, _ceiling, false _OST_INIT }
+
+/******************************************************************************
+ *
+ * Name              : _MTX_INIT_BARGING
+ *
+ * Description       : create and initialize a barging mutex object
+ *
+ * Parameters        : none
+ *
+ * Return            : mutex object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _MTX_INIT_BARGING() { 0, 0, 0, 0, 0, 0, true _OST_INIT }
 
 /******************************************************************************
  *
@@ -102,6 +143,68 @@ struct __mtx
                 static mtx_t mtx##__mtx = _MTX_INIT(); \
                 static mtx_id mtx = & mtx##__mtx
 
+/******************************************************************************
+ *
+ * Name              : OS_MTX_CEILING
+ *
+ * Description       : define and initialize a priority ceiling mutex object
+ *
+ * Parameters
+ *   mtx             : name of a pointer to mutex object
+ *   ceiling         : priority ceiling, the highest priority of tasks using the mutex
+ *
+ ******************************************************************************/
+
+#define             OS_MTX_CEILING( mtx, ceiling )                    \
+                       mtx_t mtx##__mtx = _MTX_INIT_CEILING( ceiling ); \
+                       mtx_id mtx = & mtx##__mtx
+
+/******************************************************************************
+ *
+ * Name              : static_MTX_CEILING
+ *
+ * Description       : define and initialize a static priority ceiling mutex object
+ *
+ * Parameters
+ *   mtx             : name of a pointer to mutex object
+ *   ceiling         : priority ceiling, the highest priority of tasks using the mutex
+ *
+ ******************************************************************************/
+
+#define         static_MTX_CEILING( mtx, ceiling )                    \
+                static mtx_t mtx##__mtx = _MTX_INIT_CEILING( ceiling ); \
+                static mtx_id mtx = & mtx##__mtx
+
+/******************************************************************************
+ *
+ * Name              : OS_MTX_BARGING
+ *
+ * Description       : define and initialize a barging mutex object
+ *
+ * Parameters
+ *   mtx             : name of a pointer to mutex object
+ *
+ ******************************************************************************/
+
+#define             OS_MTX_BARGING( mtx )                     \
+                       mtx_t mtx##__mtx = _MTX_INIT_BARGING(); \
+                       mtx_id mtx = & mtx##__mtx
+
+/******************************************************************************
+ *
+ * Name              : static_MTX_BARGING
+ *
+ * Description       : define and initialize a static barging mutex object
+ *
+ * Parameters
+ *   mtx             : name of a pointer to mutex object
+ *
+ ******************************************************************************/
+
+#define         static_MTX_BARGING( mtx )                     \
+                static mtx_t mtx##__mtx = _MTX_INIT_BARGING(); \
+                static mtx_id mtx = & mtx##__mtx
+
 /******************************************************************************
  *
  * Name              : MTX_INIT
@@ -160,6 +263,44 @@ struct __mtx
 
 void mtx_init( mtx_t *mtx );
 
+/******************************************************************************
+ *
+ * Name              : mtx_initCeiling
+ *
+ * Description       : initialize a priority ceiling mutex object
+ *
+ * Parameters
+ *   mtx             : pointer to mutex object
+ *   ceiling         : priority ceiling, the highest priority of tasks using the mutex
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void mtx_initCeiling( mtx_t *mtx, unsigned ceiling );
+
+/******************************************************************************
+ *
+ * Name              : mtx_initBarging
+ *
+ * Description       : initialize a barging mutex object (priority inheritance)
+ *                     mtx_give makes the mutex free and wakes up the first waiting task, which tries to lock it again;
+ *                     the releasing task can lock the mutex again without a context switch (no lock convoy),
+ *                     at the cost of fairness: the woken task may find the mutex locked and wait again
+ *
+ * Parameters
+ *   mtx             : pointer to mutex object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void mtx_initBarging( mtx_t *mtx );
+
 /******************************************************************************
  *
  * Name              : mtx_create
@@ -181,6 +322,49 @@ mtx_t *mtx_create( void );
 __STATIC_INLINE
 mtx_t *mtx_new( void ) { return mtx_create(); }
 
+/******************************************************************************
+ *
+ * Name              : mtx_createCeiling
+ * Alias             : mtx_newCeiling
+ *
+ * Description       : create and initialize a new priority ceiling mutex object
+ *
+ * Parameters
+ *   ceiling         : priority ceiling, the highest priority of tasks using the mutex
+ *
+ * Return            : pointer to mutex object (mutex successfully created)
+ *   0               : mutex not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+mtx_t *mtx_createCeiling( unsigned ceiling );
+
+__STATIC_INLINE
+mtx_t *mtx_newCeiling( unsigned ceiling ) { return mtx_createCeiling(ceiling); }
+
+/******************************************************************************
+ *
+ * Name              : mtx_createBarging
+ * Alias             : mtx_newBarging
+ *
+ * Description       : create and initialize a new barging mutex object (priority inheritance)
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to mutex object (mutex successfully created)
+ *   0               : mutex not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+mtx_t *mtx_createBarging( void );
+
+__STATIC_INLINE
+mtx_t *mtx_newBarging( void ) { return mtx_createBarging(); }
+
 /******************************************************************************
  *
  * Name              : mtx_kill
@@ -338,13 +522,13 @@ unsigned mtx_give( mtx_t *mtx );
  * Description       : create and initialize a mutex object
  *
  * Constructor parameters
- *                   : none
+ *   ceiling         : priority ceiling (0 for priority inheritance mutex)
  *
  ******************************************************************************/
 
 struct Mutex : public __mtx
 {
-	 Mutex( void ): __mtx _MTX_INIT() {}
+	constexpr Mutex( const unsigned _ceiling = 0 ): __mtx _MTX_INIT_CEILING(_ceiling) {}
 	~Mutex( void ) { assert(__mtx::owner == nullptr); }
 
 	void     kill     ( void )         {        mtx_kill     (this);         }
@@ -355,6 +539,50 @@ struct Mutex : public __mtx
 	unsigned give     ( void )         { return mtx_give     (this);         }
 };
 
+/******************************************************************************
+ *
+ * Class             : BargingMutex
+ *
+ * Description       : create and initialize a barging mutex object (priority inheritance)
+ *
+ * Constructor parameters
+ *                   : none
+ *
+ ******************************************************************************/
+
+struct BargingMutex : public Mutex
+{
+	constexpr BargingMutex( void ): Mutex() { __mtx::barging = true; }
+};
+
+/******************************************************************************
+ *
+ * Class             : LockGuard<>
+ *
+ * Description       : scoped guard of a mutex object
+ *                     lock the mutex (wait indefinitely) when created and unlock it when destroyed
+ *                     mutex that was not locked (e.g. killed while waiting) is not affected by the unlock
+ *
+ * Constructor parameters
+ *   T               : class of the mutex object (Mutex, FastMutex)
+ *   mtx             : mutex object
+ *
+ ******************************************************************************/
+
+template<class T = Mutex>
+struct LockGuard
+{
+	explicit
+	 LockGuard( T &_mtx ): mtx(_mtx) { mtx.wait(); }
+	~LockGuard( void )               { mtx.give(); }
+
+	LockGuard( const LockGuard & ) = delete;
+	LockGuard &operator=( const LockGuard & ) = delete;
+
+	private:
+	T &mtx;
+};
+
 #endif//__cplusplus
 
 /* -------------------------------------------------------------------------- */
@@ -0,0 +1,360 @@
+/******************************************************************************
+
+    @file    StateOS: ospacket.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_PKT_H
+#define __STATEOS_PKT_H
+
+#include "oskernel.h"
+#include "oslist.h"
+#include "osmemorypool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : packet buffer
+ *
+ * Note              : packet is a chain of fixed-size buffers allocated from memory pools (mem_t),
+ *                     the first buffer holds the reference counter and the headroom reserved for headers,
+ *                     packet is released to its pools when the last reference is dropped,
+ *                     packet is passed without copying through list objects (lst_t),
+ *                     it can be queued in one list at a time; to hand it over to several consumers
+ *                     take a reference for each of them and pass the pointer (e.g. through a mailbox queue)
+ *
+ ******************************************************************************/
+
+typedef struct __pkt pkt_t;
+
+struct __pkt
+{
+	que_t    link;   // link of the packet in the list object
+	pkt_t  * next;   // next buffer of the packet
+	mem_t  * mem;    // memory pool of the buffer
+	volatile
+	unsigned refs;   // number of references to the packet (first buffer only)
+	unsigned total;  // length of the packet (first buffer only)
+	unsigned offset; // offset of the data in the buffer
+	unsigned length; // length of the data in the buffer
+};
+
+/******************************************************************************
+ *
+ * Name              : PKT_SIZE
+ *
+ * Description       : size of memory object of a memory pool dedicated to packet buffers
+ *
+ * Parameters
+ *   size            : size of data of a buffer (in bytes)
+ *
+ ******************************************************************************/
+
+#define                PKT_SIZE( size ) \
+                     ( sizeof(pkt_t) + (size) )
+
+/******************************************************************************
+ *
+ * Name              : pkt_alloc
+ * ISR alias         : pkt_allocISR
+ *
+ * Description       : allocate a packet from the memory pool object,
+ *                     chain as many buffers as are needed for given length and headroom,
+ *                     don't wait if the memory pool object is empty
+ *
+ * Parameters
+ *   mem             : pointer to memory pool object of PKT_SIZE() objects
+ *   size            : length of the packet (in bytes)
+ *   reserve         : headroom reserved for headers in the first buffer (in bytes)
+ *
+ * Return            : pointer to the packet with one reference
+ *   0               : not enough free buffers in the memory pool object (nothing allocated)
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+pkt_t *pkt_alloc( mem_t *mem, unsigned size, unsigned reserve );
+
+__STATIC_INLINE
+pkt_t *pkt_allocISR( mem_t *mem, unsigned size, unsigned reserve ) { return pkt_alloc(mem, size, reserve); }
+
+/******************************************************************************
+ *
+ * Name              : pkt_ref
+ * ISR alias         : pkt_refISR
+ *
+ * Description       : take an additional reference to the packet
+ *
+ * Parameters
+ *   pkt             : pointer to the packet
+ *
+ * Return            : pointer to the packet
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+pkt_t *pkt_ref( pkt_t *pkt );
+
+__STATIC_INLINE
+pkt_t *pkt_refISR( pkt_t *pkt ) { return pkt_ref(pkt); }
+
+/******************************************************************************
+ *
+ * Name              : pkt_free
+ * ISR alias         : pkt_freeISR
+ *
+ * Description       : drop a reference to the packet,
+ *                     release all buffers of the packet to their memory pools with the last reference
+ *
+ * Parameters
+ *   pkt             : pointer to the packet
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void pkt_free( pkt_t *pkt );
+
+__STATIC_INLINE
+void pkt_freeISR( pkt_t *pkt ) { pkt_free(pkt); }
+
+/******************************************************************************
+ *
+ * Name              : pkt_data
+ *
+ * Description       : return pointer to the data of the buffer of the packet
+ *
+ * Parameters
+ *   pkt             : pointer to the packet (or to the next buffer of the packet)
+ *
+ * Return            : pointer to the data of the buffer, there are pkt->length bytes of data
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void *pkt_data( pkt_t *pkt ) { return (char *)(pkt + 1) + pkt->offset; }
+
+/******************************************************************************
+ *
+ * Name              : pkt_length
+ *
+ * Description       : return length of the packet
+ *
+ * Parameters
+ *   pkt             : pointer to the packet
+ *
+ * Return            : length of the packet (in bytes)
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned pkt_length( pkt_t *pkt ) { return pkt->total; }
+
+/******************************************************************************
+ *
+ * Name              : pkt_push
+ *
+ * Description       : prepend a header to the packet using the headroom of the first buffer
+ *
+ * Parameters
+ *   pkt             : pointer to the packet
+ *   size            : size of the header (in bytes)
+ *
+ * Return            : pointer to the header (new beginning of the packet)
+ *   0               : not enough headroom in the first buffer
+ *
+ * Note              : packet must not be shared with other consumers
+ *
+ ******************************************************************************/
+
+void *pkt_push( pkt_t *pkt, unsigned size );
+
+/******************************************************************************
+ *
+ * Name              : pkt_pull
+ *
+ * Description       : remove a header from the beginning of the packet (it becomes a headroom)
+ *
+ * Parameters
+ *   pkt             : pointer to the packet
+ *   size            : size of the header (in bytes)
+ *
+ * Return            : pointer to the new beginning of the packet
+ *   0               : header is longer than the data of the first buffer
+ *
+ * Note              : packet must not be shared with other consumers
+ *
+ ******************************************************************************/
+
+void *pkt_pull( pkt_t *pkt, unsigned size );
+
+/******************************************************************************
+ *
+ * Name              : pkt_read
+ *
+ * Description       : copy data from the packet, starting from given offset
+ *
+ * Parameters
+ *   pkt             : pointer to the packet
+ *   offset          : offset of the data in the packet (in bytes)
+ *   data            : pointer to write buffer
+ *   size            : size of the write buffer (in bytes)
+ *
+ * Return            : number of copied bytes
+ *
+ ******************************************************************************/
+
+unsigned pkt_read( pkt_t *pkt, unsigned offset, void *data, unsigned size );
+
+/******************************************************************************
+ *
+ * Name              : pkt_write
+ *
+ * Description       : copy data to the packet, starting from given offset
+ *
+ * Parameters
+ *   pkt             : pointer to the packet
+ *   offset          : offset of the data in the packet (in bytes)
+ *   data            : pointer to read buffer
+ *   size            : size of the read buffer (in bytes)
+ *
+ * Return            : number of copied bytes
+ *
+ ******************************************************************************/
+
+unsigned pkt_write( pkt_t *pkt, unsigned offset, const void *data, unsigned size );
+
+/******************************************************************************
+ *
+ * Name              : pkt_give
+ * ISR alias         : pkt_giveISR
+ *
+ * Description       : hand over the packet (with its reference) to the list object without copying
+ *
+ * Parameters
+ *   lst             : pointer to list object
+ *   pkt             : pointer to the packet
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void pkt_give( lst_t *lst, pkt_t *pkt ) { lst_give(lst, &pkt->link + 1); }
+
+__STATIC_INLINE
+void pkt_giveISR( lst_t *lst, pkt_t *pkt ) { pkt_give(lst, pkt); }
+
+/******************************************************************************
+ *
+ * Name              : pkt_waitFor
+ *
+ * Description       : try to get the packet from the list object,
+ *                     wait for given duration of time while the list object is empty
+ *
+ * Parameters
+ *   lst             : pointer to list object
+ *   pkt             : pointer to store the pointer to the packet
+ *   delay           : duration of time (maximum number of ticks to wait while the list object is empty)
+ *                     IMMEDIATE: don't wait if the list object is empty
+ *                     INFINITE:  wait indefinitely while the list object is empty
+ *
+ * Return
+ *   E_SUCCESS       : pointer to the packet was successfully transfered to the pkt pointer
+ *   E_STOPPED       : list object was killed before the specified timeout expired
+ *   E_TIMEOUT       : list object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned pkt_waitFor( lst_t *lst, pkt_t **pkt, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : pkt_wait
+ *
+ * Description       : try to get the packet from the list object,
+ *                     wait indefinitely while the list object is empty
+ *
+ * Parameters
+ *   lst             : pointer to list object
+ *   pkt             : pointer to store the pointer to the packet
+ *
+ * Return
+ *   E_SUCCESS       : pointer to the packet was successfully transfered to the pkt pointer
+ *   E_STOPPED       : list object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned pkt_wait( lst_t *lst, pkt_t **pkt ) { return pkt_waitFor(lst, pkt, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : pkt_take
+ * ISR alias         : pkt_takeISR
+ *
+ * Description       : try to get the packet from the list object,
+ *                     don't wait if the list object is empty
+ *
+ * Parameters
+ *   lst             : pointer to list object
+ *   pkt             : pointer to store the pointer to the packet
+ *
+ * Return
+ *   E_SUCCESS       : pointer to the packet was successfully transfered to the pkt pointer
+ *   E_TIMEOUT       : list object is empty
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned pkt_take( lst_t *lst, pkt_t **pkt );
+
+__STATIC_INLINE
+unsigned pkt_takeISR( lst_t *lst, pkt_t **pkt ) { return pkt_take(lst, pkt); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_PKT_H
@@ -0,0 +1,124 @@
+/******************************************************************************
+
+    @file    StateOS: ospartition.h
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_PRT_H
+#define __STATEOS_PRT_H
+
+#include "oskernel.h"
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_PARTITION
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : time-partitioned scheduler
+ *
+ * Note              : the major frame is a table of windows repeated cyclically;
+ *                     within each window the priority scheduler runs only the tasks of the partition of the window
+ *                     and unpartitioned tasks (partition 0, e.g. the main and idle task, the timer service task);
+ *                     tasks are assigned to partitions with 'tsk_setPartition';
+ *                     windows are timed by the system timer (also in tick-less mode), a window is switched
+ *                     by the context switch handler, tasks of the next partition preempt the running task
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ * Name              : prt_start
+ *
+ * Description       : start the major frame of the time-partitioned scheduler from the current time
+ *
+ * Parameters
+ *   tab             : pointer to the table of windows, each window:
+ *                     part: partition scheduled in the window, 0: only unpartitioned tasks are scheduled
+ *                     time: duration of the window (in ticks)
+ *   cnt             : number of windows in the table
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     the table is used by the scheduler until 'prt_stop' or the next 'prt_start'
+ *
+ ******************************************************************************/
+
+void prt_start( const pwn_t *tab, unsigned cnt );
+
+/******************************************************************************
+ *
+ * Name              : prt_stop
+ *
+ * Description       : stop the time-partitioned scheduler, ready tasks of all partitions are scheduled
+ *
+ * Parameters        : none
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void prt_stop( void );
+
+/******************************************************************************
+ *
+ * Name              : prt_active
+ * ISR alias         : prt_activeISR
+ *
+ * Description       : get partition of the current window
+ *
+ * Parameters        : none
+ *
+ * Return            : partition of the current window,
+ *                     PRT_ALL if the time-partitioned scheduler is stopped
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned prt_active( void );
+
+__STATIC_INLINE
+unsigned prt_activeISR( void ) { return prt_active(); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//OS_TASK_PARTITION
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_PRT_H
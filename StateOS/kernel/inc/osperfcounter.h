@@ -0,0 +1,160 @@
+/******************************************************************************
+
+    @file    StateOS: osperfcounter.h
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_PFC_H
+#define __STATEOS_PFC_H
+
+#include "oskernel.h"
+#include "ostask.h"
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_PERF
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : hardware performance counters
+ *
+ * Note              : events of the DWT unit are attributed to the running task at every context switch
+ *                     and every system tick, so each task sees its own counts;
+ *                     the event counters of the DWT unit are 8-bit wide and wrap every 256 events,
+ *                     events are lost if a task runs longer than 256 cycles between the accountings,
+ *                     use 'perf_sample' from a fast periodic interrupt to keep the counts exact;
+ *                     events of interrupt handlers are attributed to the interrupted task
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ * Name              : perf_sample
+ *
+ * Description       : attribute the events counted since the last accounting to the current task
+ *
+ * Parameters        : none
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void perf_sample( void );
+
+/******************************************************************************
+ *
+ * Name              : perf_getTask
+ *
+ * Description       : take a snapshot of the performance counters of given task
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   perf            : pointer to the structure receiving the counters
+ *   clear           : clear the counters of the task after the snapshot
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void perf_getTask( tsk_t *tsk, pfc_t *perf, bool clear );
+
+/******************************************************************************
+ *
+ * Name              : perf_get
+ *
+ * Description       : take a snapshot of the performance counters of the current task
+ *
+ * Parameters
+ *   perf            : pointer to the structure receiving the counters
+ *   clear           : clear the counters of the current task after the snapshot
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void perf_get( pfc_t *perf, bool clear ) { perf_getTask(System.cur, perf, clear); }
+
+/******************************************************************************
+ *
+ * Name              : perf_reset
+ *
+ * Description       : clear the performance counters of given task
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void perf_reset( tsk_t *tsk );
+
+/******************************************************************************
+ *
+ * Name              : perf_instructions
+ *
+ * Description       : estimate the number of instructions executed, as defined by the DWT unit:
+ *                     cycles - cpi - exc - sleep - lsu + fold
+ *
+ * Parameters
+ *   perf            : pointer to the snapshot of the performance counters
+ *
+ * Return            : number of instructions executed
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+uint32_t perf_instructions( const pfc_t *perf )
+{
+	return perf->cyc - perf->cpi - perf->exc - perf->sleep - perf->lsu + perf->fold;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//OS_TASK_PERF
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_PFC_H
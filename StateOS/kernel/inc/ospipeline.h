@@ -0,0 +1,441 @@
+/******************************************************************************
+
+    @file    StateOS: ospipeline.h
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_STG_H
+#define __STATEOS_STG_H
+
+#include "oskernel.h"
+#include "osmailboxqueue.h"
+#include "osmemorypool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#define STG_BATCH    ( 16U ) // maximum number of buffers processed by the stage in one activation
+
+/******************************************************************************
+ *
+ * Name              : pipeline stage
+ *
+ * Note              : stages pass pointers to buffers allocated from the memory pool object shared by the pipeline,
+ *                     buffers are never copied, only their pointers are queued between the stages,
+ *                     the input queue of the stage holds at most 'limit' buffers (credits of the upstream stage),
+ *                     the upstream stage is blocked while the input queue of the downstream stage is full (back-pressure),
+ *                     the first stage is blocked while all buffers of the memory pool object are in the pipeline,
+ *                     a fused stage has no input queue and is executed in the task of its upstream stage,
+ *                     so several stages can be run by one task
+ *
+ ******************************************************************************/
+
+typedef struct __stg stg_t, * const stg_id;
+
+typedef void stp_t( stg_t *stg, void **item, unsigned count ); // processing procedure of the stage
+
+struct __stg
+{
+	box_t    box;   // input queue of the stage (pointers to buffers)
+	mem_t  * mem;   // memory pool object of buffers shared by the pipeline
+	stg_t  * next;  // downstream stage (0: the last stage of the pipeline)
+	stp_t  * proc;  // processing procedure of the stage
+	unsigned batch; // maximum number of buffers processed in one activation
+	bool     fused; // stage is executed in the task of its upstream stage
+};
+
+/******************************************************************************
+ *
+ * Name              : _STG_INIT
+ *
+ * Description       : create and initialize a pipeline stage
+ *
+ * Parameters
+ *   mem             : pointer to memory pool object shared by the pipeline
+ *   proc            : processing procedure of the stage
+ *   batch           : maximum number of buffers processed in one activation (up to STG_BATCH)
+ *   limit           : size of the input queue (max number of queued buffers)
+ *   data            : input queue data buffer
+ *
+ * Return            : pipeline stage
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _STG_INIT( _mem, _proc, _batch, _limit, _data ) { _BOX_INIT( _limit, (char *)(_data), sizeof(void *) ), _mem, 0, _proc, _batch, false }
+
+/******************************************************************************
+ *
+ * Name              : _STG_DATA
+ *
+ * Description       : create an input queue data buffer of a pipeline stage
+ *
+ * Parameters
+ *   limit           : size of the input queue (max number of queued buffers)
+ *
+ * Return            : input queue data buffer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _STG_DATA( _limit ) _BOX_DATA( _limit, sizeof(void *) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : OS_STG
+ *
+ * Description       : define and initialize a pipeline stage
+ *
+ * Parameters
+ *   stg             : name of a pointer to pipeline stage
+ *   mem             : pointer to memory pool object shared by the pipeline
+ *   proc            : processing procedure of the stage
+ *   batch           : maximum number of buffers processed in one activation (up to STG_BATCH)
+ *   limit           : size of the input queue (max number of queued buffers)
+ *
+ ******************************************************************************/
+
+#define             OS_STG( stg, mem, proc, batch, limit )                                \
+                       void *stg##__buf[limit];                                            \
+                       stg_t stg##__stg = _STG_INIT( mem, proc, batch, limit, stg##__buf ); \
+                       stg_id stg = & stg##__stg
+
+/******************************************************************************
+ *
+ * Name              : static_STG
+ *
+ * Description       : define and initialize a static pipeline stage
+ *
+ * Parameters
+ *   stg             : name of a pointer to pipeline stage
+ *   mem             : pointer to memory pool object shared by the pipeline
+ *   proc            : processing procedure of the stage
+ *   batch           : maximum number of buffers processed in one activation (up to STG_BATCH)
+ *   limit           : size of the input queue (max number of queued buffers)
+ *
+ ******************************************************************************/
+
+#define         static_STG( stg, mem, proc, batch, limit )                                \
+                static void *stg##__buf[limit];                                            \
+                static stg_t stg##__stg = _STG_INIT( mem, proc, batch, limit, stg##__buf ); \
+                static stg_id stg = & stg##__stg
+
+/******************************************************************************
+ *
+ * Name              : STG_INIT
+ *
+ * Description       : create and initialize a pipeline stage
+ *
+ * Parameters
+ *   mem             : pointer to memory pool object shared by the pipeline
+ *   proc            : processing procedure of the stage
+ *   batch           : maximum number of buffers processed in one activation (up to STG_BATCH)
+ *   limit           : size of the input queue (max number of queued buffers)
+ *
+ * Return            : pipeline stage
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                STG_INIT( mem, proc, batch, limit ) \
+                      _STG_INIT( mem, proc, batch, limit, _STG_DATA( limit ) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : STG_CREATE
+ * Alias             : STG_NEW
+ *
+ * Description       : create and initialize a pipeline stage
+ *
+ * Parameters
+ *   mem             : pointer to memory pool object shared by the pipeline
+ *   proc            : processing procedure of the stage
+ *   batch           : maximum number of buffers processed in one activation (up to STG_BATCH)
+ *   limit           : size of the input queue (max number of queued buffers)
+ *
+ * Return            : pointer to pipeline stage
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                STG_CREATE( mem, proc, batch, limit ) \
+           (stg_t[]) { STG_INIT  ( mem, proc, batch, limit ) }
+#define                STG_NEW \
+                       STG_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : stg_init
+ *
+ * Description       : initialize a pipeline stage
+ *
+ * Parameters
+ *   stg             : pointer to pipeline stage
+ *   mem             : pointer to memory pool object shared by the pipeline
+ *   proc            : processing procedure of the stage
+ *   batch           : maximum number of buffers processed in one activation (up to STG_BATCH)
+ *   limit           : size of the input queue (max number of queued buffers)
+ *   data            : input queue data buffer (array of 'limit' pointers)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void stg_init( stg_t *stg, mem_t *mem, stp_t *proc, unsigned batch, unsigned limit, void **data );
+
+/******************************************************************************
+ *
+ * Name              : stg_link
+ *
+ * Description       : connect the downstream stage, buffers are passed to its input queue
+ *                     and processed by the task running the downstream stage
+ *
+ * Parameters
+ *   stg             : pointer to pipeline stage
+ *   next            : pointer to downstream stage
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, before the pipeline is started
+ *
+ ******************************************************************************/
+
+void stg_link( stg_t *stg, stg_t *next );
+
+/******************************************************************************
+ *
+ * Name              : stg_fuse
+ *
+ * Description       : connect the downstream stage executed directly by the task of the pipeline stage,
+ *                     buffers are passed to the processing procedure of the downstream stage without queuing
+ *
+ * Parameters
+ *   stg             : pointer to pipeline stage
+ *   next            : pointer to downstream stage (must not be run by any task)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, before the pipeline is started
+ *
+ ******************************************************************************/
+
+void stg_fuse( stg_t *stg, stg_t *next );
+
+/******************************************************************************
+ *
+ * Name              : stg_alloc
+ *
+ * Description       : take a buffer from the memory pool object shared by the pipeline,
+ *                     wait indefinitely while all buffers are in the pipeline
+ *
+ * Parameters
+ *   stg             : pointer to pipeline stage
+ *
+ * Return            : pointer to buffer or 0 if the memory pool object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void *stg_alloc( stg_t *stg );
+
+/******************************************************************************
+ *
+ * Name              : stg_free
+ *
+ * Description       : return the buffer to the memory pool object shared by the pipeline
+ *
+ * Parameters
+ *   stg             : pointer to pipeline stage
+ *   item            : pointer to buffer
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void stg_free( stg_t *stg, void *item );
+
+/******************************************************************************
+ *
+ * Name              : stg_put
+ *
+ * Description       : pass the buffer to the pipeline stage,
+ *                     wait indefinitely while the input queue of the stage is full,
+ *                     a fused stage processes the buffer immediately
+ *
+ * Parameters
+ *   stg             : pointer to pipeline stage
+ *   item            : pointer to buffer
+ *
+ * Return
+ *   E_SUCCESS       : buffer was successfully passed to the pipeline stage
+ *   E_STOPPED       : input queue of the pipeline stage was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned stg_put( stg_t *stg, void *item );
+
+/******************************************************************************
+ *
+ * Name              : stg_send
+ *
+ * Description       : pass the processed buffer to the downstream stage,
+ *                     the last stage of the pipeline returns the buffer to the memory pool object
+ *
+ * Parameters
+ *   stg             : pointer to pipeline stage
+ *   item            : pointer to buffer
+ *
+ * Return
+ *   E_SUCCESS       : buffer was successfully passed to the downstream stage
+ *   E_STOPPED       : input queue of the downstream stage was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned stg_send( stg_t *stg, void *item );
+
+/******************************************************************************
+ *
+ * Name              : stg_run
+ *
+ * Description       : wait indefinitely for buffers in the input queue of the pipeline stage,
+ *                     then take up to 'batch' buffers and pass them to the processing procedure of the stage
+ *
+ * Parameters
+ *   stg             : pointer to pipeline stage
+ *
+ * Return            : number of processed buffers (0 if the input queue of the stage was killed)
+ *
+ * Note              : use only in thread mode, in the task running the stage
+ *                     the processing procedure is responsible for every buffer: stg_send or stg_free it
+ *
+ * Example           : for (;;) stg_run(stg);
+ *
+ ******************************************************************************/
+
+unsigned stg_run( stg_t *stg );
+
+/******************************************************************************
+ *
+ * Name              : stg_count
+ *
+ * Description       : return the number of buffers queued in the input queue of the pipeline stage
+ *
+ * Parameters
+ *   stg             : pointer to pipeline stage
+ *
+ * Return            : number of queued buffers
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned stg_count( stg_t *stg ) { return box_count(&stg->box); }
+
+/******************************************************************************
+ *
+ * Name              : stg_space
+ *
+ * Description       : return the number of credits of the upstream stage (free space in the input queue)
+ *
+ * Parameters
+ *   stg             : pointer to pipeline stage
+ *
+ * Return            : number of buffers the upstream stage can pass without blocking
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned stg_space( stg_t *stg ) { return box_space(&stg->box); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : PipelineStageT<>
+ *
+ * Description       : create and initialize a pipeline stage
+ *
+ * Constructor parameters
+ *   limit           : size of the input queue (max number of queued buffers)
+ *   mem             : memory pool object shared by the pipeline
+ *   proc            : processing procedure of the stage
+ *   batch           : maximum number of buffers processed in one activation (up to STG_BATCH)
+ *
+ ******************************************************************************/
+
+template<unsigned limit_>
+struct PipelineStageT : public __stg
+{
+	PipelineStageT( mem_t *_mem, stp_t *_proc, unsigned _batch = 1 ): __stg _STG_INIT(_mem, _proc, _batch, limit_, data_) {}
+
+	void     link ( stg_t *_next ) {        stg_link (this, _next); }
+	void     fuse ( stg_t *_next ) {        stg_fuse (this, _next); }
+	void    *alloc( void )         { return stg_alloc(this);        }
+	void     free ( void *_item )  {        stg_free (this, _item); }
+	unsigned put  ( void *_item )  { return stg_put  (this, _item); }
+	unsigned send ( void *_item )  { return stg_send (this, _item); }
+	unsigned run  ( void )         { return stg_run  (this);        }
+	unsigned count( void )         { return stg_count(this);        }
+	unsigned space( void )         { return stg_space(this);        }
+
+	private:
+	void *data_[limit_];
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_STG_H
@@ -0,0 +1,567 @@
+/******************************************************************************
+
+    @file    StateOS: ospriorityjobqueue.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_PJQ_H
+#define __STATEOS_PJQ_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : priority job queue
+ *
+ ******************************************************************************/
+
+typedef struct __pjs pjs_t;
+
+struct __pjs
+{
+	fun_t  * fun;   // job procedure
+	unsigned next;  // next job slot of the same priority level or of the list of free slots
+};
+
+typedef struct __pjq pjq_t, * const pjq_id;
+
+struct __pjq
+{
+	tsk_t  * queue; // next process in the DELAYED queue
+	void   * res;   // allocated priority job queue object's resource
+	unsigned count; // number of jobs in the queue
+	unsigned limit; // size of a queue (max number of stored jobs)
+
+	unsigned levels;// number of priority levels (up to 32)
+	uint32_t map;   // bitmap of non-empty priority levels
+	unsigned used;  // number of job slots used so far
+	unsigned free;  // first slot of the list of free slots (valid if count < used)
+	pjs_t  * data;  // priority job queue data buffer: job slots followed by heads and tails of priority levels
+};
+
+/******************************************************************************
+ *
+ * Name              : JSIZE
+ *
+ * Description       : size of the priority job queue data buffer (in job slots)
+ *
+ * Parameters
+ *   levels          : number of priority levels (up to 32)
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ ******************************************************************************/
+
+#define JSIZE( levels, limit ) \
+     ((limit) + (levels))
+
+/******************************************************************************
+ *
+ * Name              : _PJQ_INIT
+ *
+ * Description       : create and initialize a priority job queue object
+ *
+ * Parameters
+ *   levels          : number of priority levels (up to 32)
+ *   limit           : size of a queue (max number of stored jobs)
+ *   data            : priority job queue data buffer (JSIZE(levels, limit) job slots)
+ *
+ * Return            : priority job queue object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _PJQ_INIT( _levels, _limit, _data ) { 0, 0, 0, _limit, _levels, 0, 0, 0, _data }
+
+/******************************************************************************
+ *
+ * Name              : _PJQ_DATA
+ *
+ * Description       : create a priority job queue data buffer
+ *
+ * Parameters
+ *   levels          : number of priority levels (up to 32)
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ * Return            : priority job queue data buffer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _PJQ_DATA( _levels, _limit ) (pjs_t[JSIZE(_levels, _limit)]){ { 0, 0 } }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : OS_PJQ
+ *
+ * Description       : define and initialize a priority job queue object
+ *
+ * Parameters
+ *   pjq             : name of a pointer to priority job queue object
+ *   levels          : number of priority levels (up to 32)
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ ******************************************************************************/
+
+#define             OS_PJQ( pjq, levels, limit )                                  \
+           __OS_NOINIT pjs_t pjq##__buf[JSIZE(levels, limit)];                   \
+                       pjq_t pjq##__pjq = _PJQ_INIT( levels, limit, pjq##__buf ); \
+                       pjq_id pjq = & pjq##__pjq
+
+/******************************************************************************
+ *
+ * Name              : static_PJQ
+ *
+ * Description       : define and initialize a static priority job queue object
+ *
+ * Parameters
+ *   pjq             : name of a pointer to priority job queue object
+ *   levels          : number of priority levels (up to 32)
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ ******************************************************************************/
+
+#define         static_PJQ( pjq, levels, limit )                                  \
+    static __OS_NOINIT pjs_t pjq##__buf[JSIZE(levels, limit)];                   \
+                static pjq_t pjq##__pjq = _PJQ_INIT( levels, limit, pjq##__buf ); \
+                static pjq_id pjq = & pjq##__pjq
+
+/******************************************************************************
+ *
+ * Name              : PJQ_INIT
+ *
+ * Description       : create and initialize a priority job queue object
+ *
+ * Parameters
+ *   levels          : number of priority levels (up to 32)
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ * Return            : priority job queue object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                PJQ_INIT( levels, limit ) \
+                      _PJQ_INIT( levels, limit, _PJQ_DATA( levels, limit ) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : PJQ_CREATE
+ * Alias             : PJQ_NEW
+ *
+ * Description       : create and initialize a priority job queue object
+ *
+ * Parameters
+ *   levels          : number of priority levels (up to 32)
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ * Return            : pointer to priority job queue object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                PJQ_CREATE( levels, limit ) \
+           (pjq_t[]) { PJQ_INIT  ( levels, limit ) }
+#define                PJQ_NEW \
+                       PJQ_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : pjq_init
+ *
+ * Description       : initialize a priority job queue object
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *   levels          : number of priority levels (up to 32)
+ *   limit           : size of a queue (max number of stored jobs)
+ *   data            : priority job queue data buffer (JSIZE(levels, limit) job slots)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void pjq_init( pjq_t *pjq, unsigned levels, unsigned limit, pjs_t *data );
+
+/******************************************************************************
+ *
+ * Name              : pjq_create
+ * Alias             : pjq_new
+ *
+ * Description       : create and initialize a new priority job queue object
+ *
+ * Parameters
+ *   levels          : number of priority levels (up to 32)
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ * Return            : pointer to priority job queue object (priority job queue successfully created)
+ *   0               : priority job queue not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+pjq_t *pjq_create( unsigned levels, unsigned limit );
+
+__STATIC_INLINE
+pjq_t *pjq_new( unsigned levels, unsigned limit ) { return pjq_create(levels, limit); }
+
+/******************************************************************************
+ *
+ * Name              : pjq_kill
+ *
+ * Description       : reset the priority job queue object and wake up all waiting tasks with 'E_STOPPED' event value
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void pjq_kill( pjq_t *pjq );
+
+/******************************************************************************
+ *
+ * Name              : pjq_delete
+ *
+ * Description       : reset the priority job queue object and free allocated resource
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void pjq_delete( pjq_t *pjq );
+
+/******************************************************************************
+ *
+ * Name              : pjq_waitFor
+ *
+ * Description       : try to transfer the oldest job of the highest priority level from the priority job queue object
+ *                     and execute the job procedure,
+ *                     wait for given duration of time while the priority job queue object is empty
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *   delay           : duration of time (maximum number of ticks to wait while the priority job queue object is empty)
+ *                     IMMEDIATE: don't wait if the priority job queue object is empty
+ *                     INFINITE:  wait indefinitely while the priority job queue object is empty
+ *
+ * Return
+ *   E_SUCCESS       : job data was successfully transfered from the priority job queue object
+ *   E_STOPPED       : priority job queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : priority job queue object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned pjq_waitFor( pjq_t *pjq, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : pjq_waitUntil
+ *
+ * Description       : try to transfer the oldest job of the highest priority level from the priority job queue object
+ *                     and execute the job procedure,
+ *                     wait until given timepoint while the priority job queue object is empty
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : job data was successfully transfered from the priority job queue object
+ *   E_STOPPED       : priority job queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : priority job queue object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned pjq_waitUntil( pjq_t *pjq, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : pjq_wait
+ *
+ * Description       : try to transfer the oldest job of the highest priority level from the priority job queue object
+ *                     and execute the job procedure,
+ *                     wait indefinitely while the priority job queue object is empty
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *
+ * Return
+ *   E_SUCCESS       : job data was successfully transfered from the priority job queue object
+ *   E_STOPPED       : priority job queue object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned pjq_wait( pjq_t *pjq ) { return pjq_waitFor(pjq, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : pjq_take
+ * ISR alias         : pjq_takeISR
+ *
+ * Description       : try to transfer the oldest job of the highest priority level from the priority job queue object
+ *                     and execute the job procedure,
+ *                     don't wait if the priority job queue object is empty
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *
+ * Return
+ *   E_SUCCESS       : job data was successfully transfered from the priority job queue object
+ *   E_TIMEOUT       : priority job queue object is empty
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned pjq_take( pjq_t *pjq );
+
+__STATIC_INLINE
+unsigned pjq_takeISR( pjq_t *pjq ) { return pjq_take(pjq); }
+
+/******************************************************************************
+ *
+ * Name              : pjq_sendFor
+ *
+ * Description       : try to transfer job data to the priority job queue object,
+ *                     wait for given duration of time while the priority job queue object is full
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *   fun             : pointer to job procedure
+ *   prio            : priority level of the job (0..levels-1, higher is more urgent), jobs of the same level are executed in fifo order
+ *   delay           : duration of time (maximum number of ticks to wait while the priority job queue object is full)
+ *                     IMMEDIATE: don't wait if the priority job queue object is full
+ *                     INFINITE:  wait indefinitely while the priority job queue object is full
+ *
+ * Return
+ *   E_SUCCESS       : job data was successfully transfered to the priority job queue object
+ *   E_STOPPED       : priority job queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : priority job queue object is full and was not issued data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned pjq_sendFor( pjq_t *pjq, fun_t *fun, unsigned prio, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : pjq_sendUntil
+ *
+ * Description       : try to transfer job data to the priority job queue object,
+ *                     wait until given timepoint while the priority job queue object is full
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *   fun             : pointer to job procedure
+ *   prio            : priority level of the job (0..levels-1, higher is more urgent), jobs of the same level are executed in fifo order
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : job data was successfully transfered to the priority job queue object
+ *   E_STOPPED       : priority job queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : priority job queue object is full and was not issued data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned pjq_sendUntil( pjq_t *pjq, fun_t *fun, unsigned prio, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : pjq_send
+ *
+ * Description       : try to transfer job data to the priority job queue object,
+ *                     wait indefinitely while the priority job queue object is full
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *   fun             : pointer to job procedure
+ *   prio            : priority level of the job (0..levels-1, higher is more urgent), jobs of the same level are executed in fifo order
+ *
+ * Return
+ *   E_SUCCESS       : job data was successfully transfered to the priority job queue object
+ *   E_STOPPED       : priority job queue object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned pjq_send( pjq_t *pjq, fun_t *fun, unsigned prio ) { return pjq_sendFor(pjq, fun, prio, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : pjq_give
+ * ISR alias         : pjq_giveISR
+ *
+ * Description       : try to transfer job data to the priority job queue object,
+ *                     don't wait if the priority job queue object is full
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *   fun             : pointer to job procedure
+ *   prio            : priority level of the job (0..levels-1, higher is more urgent), jobs of the same level are executed in fifo order
+ *
+ * Return
+ *   E_SUCCESS       : job data was successfully transfered to the priority job queue object
+ *   E_TIMEOUT       : priority job queue object is full
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned pjq_give( pjq_t *pjq, fun_t *fun, unsigned prio );
+
+__STATIC_INLINE
+unsigned pjq_giveISR( pjq_t *pjq, fun_t *fun, unsigned prio ) { return pjq_give(pjq, fun, prio); }
+
+/******************************************************************************
+ *
+ * Name              : pjq_count
+ * ISR alias         : pjq_countISR
+ *
+ * Description       : return the number of jobs contained in the priority job queue
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *
+ * Return            : number of jobs contained in the priority job queue
+ *
+ ******************************************************************************/
+
+unsigned pjq_count( pjq_t *pjq );
+
+__STATIC_INLINE
+unsigned pjq_countISR( pjq_t *pjq ) { return pjq_count(pjq); }
+
+/******************************************************************************
+ *
+ * Name              : pjq_space
+ * ISR alias         : pjq_spaceISR
+ *
+ * Description       : return the amount of free space in the priority job queue
+ *
+ * Parameters
+ *   pjq             : pointer to priority job queue object
+ *
+ * Return            : amount of free space in the priority job queue
+ *
+ ******************************************************************************/
+
+unsigned pjq_space( pjq_t *pjq );
+
+__STATIC_INLINE
+unsigned pjq_spaceISR( pjq_t *pjq ) { return pjq_space(pjq); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : PrioJobQueueT<>
+ *
+ * Description       : create and initialize a priority job queue object
+ *
+ * Constructor parameters
+ *   levels          : number of priority levels (up to 32)
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ ******************************************************************************/
+
+template<unsigned levels_, unsigned limit_>
+struct PrioJobQueueT : public __pjq
+{
+	static_assert(levels_ > 0 && levels_ <= 32, "number of priority levels must be 1..32");
+
+	 PrioJobQueueT( void ): __pjq _PJQ_INIT(levels_, limit_, data_) {}
+	~PrioJobQueueT( void ) { assert(__pjq::queue == nullptr); }
+
+	void     kill     ( void )                                      {        pjq_kill     (this);                      }
+	unsigned waitFor  ( cnt_t  _delay )                             { return pjq_waitFor  (this, _delay);              }
+	unsigned waitUntil( cnt_t  _time )                              { return pjq_waitUntil(this, _time);               }
+	unsigned wait     ( void )                                      { return pjq_wait     (this);                      }
+	unsigned take     ( void )                                      { return pjq_take     (this);                      }
+	unsigned takeISR  ( void )                                      { return pjq_takeISR  (this);                      }
+	unsigned sendFor  ( fun_t *_fun, unsigned _prio, cnt_t _delay ) { return pjq_sendFor  (this, _fun, _prio, _delay); }
+	unsigned sendUntil( fun_t *_fun, unsigned _prio, cnt_t _time )  { return pjq_sendUntil(this, _fun, _prio, _time);  }
+	unsigned send     ( fun_t *_fun, unsigned _prio )               { return pjq_send     (this, _fun, _prio);         }
+	unsigned give     ( fun_t *_fun, unsigned _prio )               { return pjq_give     (this, _fun, _prio);         }
+	unsigned giveISR  ( fun_t *_fun, unsigned _prio )               { return pjq_giveISR  (this, _fun, _prio);         }
+	unsigned count    ( void )                                      { return pjq_count    (this);                      }
+	unsigned countISR ( void )                                      { return pjq_countISR (this);                      }
+	unsigned space    ( void )                                      { return pjq_space    (this);                      }
+	unsigned spaceISR ( void )                                      { return pjq_spaceISR (this);                      }
+
+	private:
+	pjs_t data_[JSIZE(levels_, limit_)];
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_PJQ_H
@@ -0,0 +1,579 @@
+/******************************************************************************
+
+    @file    StateOS: osprioritymailboxqueue.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_PBX_H
+#define __STATEOS_PBX_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : priority mailbox queue
+ *
+ ******************************************************************************/
+
+typedef struct __pbx pbx_t, * const pbx_id;
+
+struct __pbx
+{
+	tsk_t  * queue; // next process in the DELAYED queue
+	void   * res;   // allocated priority mailbox queue object's resource
+	unsigned count; // number of mails in the queue
+	unsigned limit; // size of a queue (max number of stored mails)
+
+	unsigned used;  // number of mail slots used so far
+	unsigned seq;   // sequence number of the next mail (fifo order of mails with the same priority)
+	unsigned size;  // size of a single mail (in bytes)
+	unsigned*data;  // priority mailbox queue data buffer: binary heap of mails followed by mail slots
+	                // heap entry: pair of key (priority and sequence number) and slot number
+};
+
+/******************************************************************************
+ *
+ * Name              : PSIZE
+ *
+ * Description       : size of the priority mailbox queue data buffer (in bytes)
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails)
+ *   size            : size of a single mail (in bytes)
+ *
+ ******************************************************************************/
+
+#define PSIZE( limit, size ) \
+     ((limit) * (2 * sizeof(unsigned) + (size)))
+
+/******************************************************************************
+ *
+ * Name              : _PBX_INIT
+ *
+ * Description       : create and initialize a priority mailbox queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails)
+ *   data            : priority mailbox queue data buffer (array of unsigned)
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : priority mailbox queue object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _PBX_INIT( _limit, _data, _size ) { 0, 0, 0, _limit, 0, 0, _size, _data }
+
+/******************************************************************************
+ *
+ * Name              : _PBX_DATA
+ *
+ * Description       : create a priority mailbox queue data buffer
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails)
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : priority mailbox queue data buffer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _PBX_DATA( _limit, _size ) (unsigned[ALIGNED_SIZE(PSIZE(_limit, _size), unsigned)]){ 0 }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : OS_PBX
+ *
+ * Description       : define and initialize a priority mailbox queue object
+ *
+ * Parameters
+ *   pbx             : name of a pointer to priority mailbox queue object
+ *   limit           : size of a queue (max number of stored mails)
+ *   size            : size of a single mail (in bytes)
+ *
+ ******************************************************************************/
+
+#define             OS_PBX( pbx, limit, size )                                \
+           __OS_NOINIT unsigned pbx##__buf[ALIGNED_SIZE(PSIZE(limit, size), unsigned)]; \
+                       pbx_t pbx##__pbx = _PBX_INIT( limit, pbx##__buf, size ); \
+                       pbx_id pbx = & pbx##__pbx
+
+/******************************************************************************
+ *
+ * Name              : static_PBX
+ *
+ * Description       : define and initialize a static priority mailbox queue object
+ *
+ * Parameters
+ *   pbx             : name of a pointer to priority mailbox queue object
+ *   limit           : size of a queue (max number of stored mails)
+ *   size            : size of a single mail (in bytes)
+ *
+ ******************************************************************************/
+
+#define         static_PBX( pbx, limit, size )                                \
+    static __OS_NOINIT unsigned pbx##__buf[ALIGNED_SIZE(PSIZE(limit, size), unsigned)]; \
+                static pbx_t pbx##__pbx = _PBX_INIT( limit, pbx##__buf, size ); \
+                static pbx_id pbx = & pbx##__pbx
+
+/******************************************************************************
+ *
+ * Name              : PBX_INIT
+ *
+ * Description       : create and initialize a priority mailbox queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails)
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : priority mailbox queue object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                PBX_INIT( limit, size ) \
+                      _PBX_INIT( limit, _PBX_DATA( limit, size ), size )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : PBX_CREATE
+ * Alias             : PBX_NEW
+ *
+ * Description       : create and initialize a priority mailbox queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails)
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : pointer to priority mailbox queue object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                PBX_CREATE( limit, size ) \
+           (pbx_t[]) { PBX_INIT  ( limit, size ) }
+#define                PBX_NEW \
+                       PBX_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : pbx_init
+ *
+ * Description       : initialize a priority mailbox queue object
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *   limit           : size of a queue (max number of stored mails)
+ *   data            : priority mailbox queue data buffer (PSIZE(limit, size) bytes, aligned to unsigned)
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void pbx_init( pbx_t *pbx, unsigned limit, void *data, unsigned size );
+
+/******************************************************************************
+ *
+ * Name              : pbx_create
+ * Alias             : pbx_new
+ *
+ * Description       : create and initialize a new priority mailbox queue object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored mails)
+ *   size            : size of a single mail (in bytes)
+ *
+ * Return            : pointer to priority mailbox queue object (priority mailbox queue successfully created)
+ *   0               : priority mailbox queue not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+pbx_t *pbx_create( unsigned limit, unsigned size );
+
+__STATIC_INLINE
+pbx_t *pbx_new( unsigned limit, unsigned size ) { return pbx_create(limit, size); }
+
+/******************************************************************************
+ *
+ * Name              : pbx_kill
+ *
+ * Description       : reset the priority mailbox queue object and wake up all waiting tasks with 'E_STOPPED' event value
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void pbx_kill( pbx_t *pbx );
+
+/******************************************************************************
+ *
+ * Name              : pbx_delete
+ *
+ * Description       : reset the priority mailbox queue object and free allocated resource
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void pbx_delete( pbx_t *pbx );
+
+/******************************************************************************
+ *
+ * Name              : pbx_waitFor
+ *
+ * Description       : try to transfer mailbox data with the highest priority from the priority mailbox queue object,
+ *                     wait for given duration of time while the priority mailbox queue object is empty
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *   data            : pointer to store mailbox data
+ *   prio            : pointer to store priority of mailbox data (may be 0)
+ *   delay           : duration of time (maximum number of ticks to wait while the priority mailbox queue object is empty)
+ *                     IMMEDIATE: don't wait if the priority mailbox queue object is empty
+ *                     INFINITE:  wait indefinitely while the priority mailbox queue object is empty
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered from the priority mailbox queue object
+ *   E_STOPPED       : priority mailbox queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : priority mailbox queue object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned pbx_waitFor( pbx_t *pbx, void *data, unsigned *prio, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : pbx_waitUntil
+ *
+ * Description       : try to transfer mailbox data with the highest priority from the priority mailbox queue object,
+ *                     wait until given timepoint while the priority mailbox queue object is empty
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *   data            : pointer to store mailbox data
+ *   prio            : pointer to store priority of mailbox data (may be 0)
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered from the priority mailbox queue object
+ *   E_STOPPED       : priority mailbox queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : priority mailbox queue object is empty and was not received data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned pbx_waitUntil( pbx_t *pbx, void *data, unsigned *prio, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : pbx_wait
+ *
+ * Description       : try to transfer mailbox data with the highest priority from the priority mailbox queue object,
+ *                     wait indefinitely while the priority mailbox queue object is empty
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *   data            : pointer to store mailbox data
+ *   prio            : pointer to store priority of mailbox data (may be 0)
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered from the priority mailbox queue object
+ *   E_STOPPED       : priority mailbox queue object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned pbx_wait( pbx_t *pbx, void *data, unsigned *prio ) { return pbx_waitFor(pbx, data, prio, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : pbx_take
+ * ISR alias         : pbx_takeISR
+ *
+ * Description       : try to transfer mailbox data with the highest priority from the priority mailbox queue object,
+ *                     don't wait if the priority mailbox queue object is empty
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *   data            : pointer to store mailbox data
+ *   prio            : pointer to store priority of mailbox data (may be 0)
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered from the priority mailbox queue object
+ *   E_TIMEOUT       : priority mailbox queue object is empty
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned pbx_take( pbx_t *pbx, void *data, unsigned *prio );
+
+__STATIC_INLINE
+unsigned pbx_takeISR( pbx_t *pbx, void *data, unsigned *prio ) { return pbx_take(pbx, data, prio); }
+
+/******************************************************************************
+ *
+ * Name              : pbx_sendFor
+ *
+ * Description       : try to transfer mailbox data to the priority mailbox queue object,
+ *                     wait for given duration of time while the priority mailbox queue object is full
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *   data            : pointer to mailbox data
+ *   prio            : priority of mailbox data (0..255), mails with the same priority are received in fifo order
+ *   delay           : duration of time (maximum number of ticks to wait while the priority mailbox queue object is full)
+ *                     IMMEDIATE: don't wait if the priority mailbox queue object is full
+ *                     INFINITE:  wait indefinitely while the priority mailbox queue object is full
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered to the priority mailbox queue object
+ *   E_STOPPED       : priority mailbox queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : priority mailbox queue object is full and was not issued data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned pbx_sendFor( pbx_t *pbx, const void *data, unsigned prio, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : pbx_sendUntil
+ *
+ * Description       : try to transfer mailbox data to the priority mailbox queue object,
+ *                     wait until given timepoint while the priority mailbox queue object is full
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *   data            : pointer to mailbox data
+ *   prio            : priority of mailbox data (0..255), mails with the same priority are received in fifo order
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered to the priority mailbox queue object
+ *   E_STOPPED       : priority mailbox queue object was killed before the specified timeout expired
+ *   E_TIMEOUT       : priority mailbox queue object is full and was not issued data before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned pbx_sendUntil( pbx_t *pbx, const void *data, unsigned prio, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : pbx_send
+ *
+ * Description       : try to transfer mailbox data to the priority mailbox queue object,
+ *                     wait indefinitely while the priority mailbox queue object is full
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *   data            : pointer to mailbox data
+ *   prio            : priority of mailbox data (0..255), mails with the same priority are received in fifo order
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered to the priority mailbox queue object
+ *   E_STOPPED       : priority mailbox queue object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned pbx_send( pbx_t *pbx, const void *data, unsigned prio ) { return pbx_sendFor(pbx, data, prio, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : pbx_give
+ * ISR alias         : pbx_giveISR
+ *
+ * Description       : try to transfer mailbox data to the priority mailbox queue object,
+ *                     don't wait if the priority mailbox queue object is full
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *   data            : pointer to mailbox data
+ *   prio            : priority of mailbox data (0..255), mails with the same priority are received in fifo order
+ *
+ * Return
+ *   E_SUCCESS       : mailbox data was successfully transfered to the priority mailbox queue object
+ *   E_TIMEOUT       : priority mailbox queue object is full
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned pbx_give( pbx_t *pbx, const void *data, unsigned prio );
+
+__STATIC_INLINE
+unsigned pbx_giveISR( pbx_t *pbx, const void *data, unsigned prio ) { return pbx_give(pbx, data, prio); }
+
+/******************************************************************************
+ *
+ * Name              : pbx_count
+ * ISR alias         : pbx_countISR
+ *
+ * Description       : return the amount of data contained in the priority mailbox queue
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *
+ * Return            : amount of data contained in the priority mailbox queue
+ *
+ ******************************************************************************/
+
+unsigned pbx_count( pbx_t *pbx );
+
+__STATIC_INLINE
+unsigned pbx_countISR( pbx_t *pbx ) { return pbx_count(pbx); }
+
+/******************************************************************************
+ *
+ * Name              : pbx_space
+ * ISR alias         : pbx_spaceISR
+ *
+ * Description       : return the amount of free space in the priority mailbox queue
+ *
+ * Parameters
+ *   pbx             : pointer to priority mailbox queue object
+ *
+ * Return            : amount of free space in the priority mailbox queue
+ *
+ ******************************************************************************/
+
+unsigned pbx_space( pbx_t *pbx );
+
+__STATIC_INLINE
+unsigned pbx_spaceISR( pbx_t *pbx ) { return pbx_space(pbx); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : PrioMailBoxQueueT<>
+ *
+ * Description       : create and initialize a priority mailbox queue object
+ *
+ * Constructor parameters
+ *   limit           : size of a queue (max number of stored mails)
+ *   size            : size of a single mail (in bytes)
+ *
+ ******************************************************************************/
+
+template<unsigned limit_, unsigned size_>
+struct PrioMailBoxQueueT : public __pbx
+{
+	 PrioMailBoxQueueT( void ): __pbx _PBX_INIT(limit_, data_, size_) {}
+	~PrioMailBoxQueueT( void ) { assert(__pbx::queue == nullptr); }
+
+	void     kill     ( void )                                            {        pbx_kill     (this);                       }
+	unsigned waitFor  (       void *_data, unsigned *_prio, cnt_t _delay ) { return pbx_waitFor  (this, _data, _prio, _delay); }
+	unsigned waitUntil(       void *_data, unsigned *_prio, cnt_t _time )  { return pbx_waitUntil(this, _data, _prio, _time);  }
+	unsigned wait     (       void *_data, unsigned *_prio = nullptr )     { return pbx_wait     (this, _data, _prio);         }
+	unsigned take     (       void *_data, unsigned *_prio = nullptr )     { return pbx_take     (this, _data, _prio);         }
+	unsigned takeISR  (       void *_data, unsigned *_prio = nullptr )     { return pbx_takeISR  (this, _data, _prio);         }
+	unsigned sendFor  ( const void *_data, unsigned  _prio, cnt_t _delay ) { return pbx_sendFor  (this, _data, _prio, _delay); }
+	unsigned sendUntil( const void *_data, unsigned  _prio, cnt_t _time )  { return pbx_sendUntil(this, _data, _prio, _time);  }
+	unsigned send     ( const void *_data, unsigned  _prio )               { return pbx_send     (this, _data, _prio);         }
+	unsigned give     ( const void *_data, unsigned  _prio )               { return pbx_give     (this, _data, _prio);         }
+	unsigned giveISR  ( const void *_data, unsigned  _prio )               { return pbx_giveISR  (this, _data, _prio);         }
+	unsigned count    ( void )                                            { return pbx_count    (this);                       }
+	unsigned countISR ( void )                                            { return pbx_countISR (this);                       }
+	unsigned space    ( void )                                            { return pbx_space    (this);                       }
+	unsigned spaceISR ( void )                                            { return pbx_spaceISR (this);                       }
+
+	private:
+	unsigned data_[ALIGNED_SIZE(PSIZE(limit_, size_), unsigned)];
+};
+
+/******************************************************************************
+ *
+ * Class             : PrioMailBoxQueueTT<>
+ *
+ * Description       : create and initialize a priority mailbox queue object
+ *
+ * Constructor parameters
+ *   limit           : size of a queue (max number of stored mails)
+ *   T               : class of a single mail
+ *
+ ******************************************************************************/
+
+template<unsigned limit_, class T>
+struct PrioMailBoxQueueTT : public PrioMailBoxQueueT<limit_, sizeof(T)>
+{
+	PrioMailBoxQueueTT( void ): PrioMailBoxQueueT<limit_, sizeof(T)>() {}
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_PBX_H
@@ -0,0 +1,195 @@
+/******************************************************************************
+
+    @file    StateOS: osrcu.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+
+#ifndef __STATEOS_RCU_H
+#define __STATEOS_RCU_H
+
+#include "oskernel.h"
+#include "ostask.h"
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_RCU_SIZE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : read-copy-update
+ *
+ * Note              : readers access shared data published by 'rcu_assign' inside read-side sections
+ *                     ('rcu_readLock' / 'rcu_readUnlock') without masking interrupts or blocking;
+ *                     the writer publishes a new copy of the data and retires the old one with 'rcu_retire',
+ *                     the old copy is freed by the idle task when no task is inside a read-side section
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ * Name              : rcu_readLock
+ *
+ * Description       : enter a read-side section of the current task (sections may be nested)
+ *
+ * Parameters        : none
+ *
+ * Return            : none
+ *
+ * Note              : do not use waiting functions inside rcu_readLock / rcu_readUnlock
+ *                     use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void rcu_readLock( void )
+{
+	System.cur->rcu++;
+	port_set_barrier();
+}
+
+/******************************************************************************
+ *
+ * Name              : rcu_readUnlock
+ *
+ * Description       : exit from a read-side section of the current task
+ *
+ * Parameters        : none
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void rcu_readUnlock( void )
+{
+	assert(System.cur->rcu > 0);
+	port_set_barrier();
+	System.cur->rcu--;
+}
+
+/******************************************************************************
+ *
+ * Name              : rcu_assign
+ *
+ * Description       : publish a new copy of shared data
+ *                     (the copy is completely written before the pointer becomes visible)
+ *
+ * Parameters
+ *   ptr             : pointer variable of shared data
+ *   val             : pointer to the new copy of shared data
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+#define                rcu_assign( ptr, val ) \
+                       do { port_mem_barrier(); (ptr) = (val); } while (0)
+
+/******************************************************************************
+ *
+ * Name              : rcu_fetch
+ *
+ * Description       : read pointer of shared data published by 'rcu_assign'
+ *
+ * Parameters
+ *   ptr             : pointer variable of shared data
+ *
+ * Return            : pointer to the current copy of shared data
+ *
+ * Note              : use only inside a read-side section
+ *
+ ******************************************************************************/
+
+#define                rcu_fetch( ptr ) \
+                     (*(__typeof__(ptr) volatile *)&(ptr))
+
+/******************************************************************************
+ *
+ * Name              : rcu_retire
+ *
+ * Description       : hand the old copy of shared data (allocated with sys_alloc) to the list of blocks
+ *                     to be freed when no task is inside a read-side section
+ *
+ * Parameters
+ *   ptr             : pointer to the old copy of shared data
+ *
+ * Return
+ *   E_SUCCESS       : block was queued for release
+ *   E_TIMEOUT       : list of retired blocks is full (OS_RCU_SIZE), try again later
+ *
+ * Note              : use only in thread mode
+ *                     the block is released by the idle task, so it is freed only if the system is not fully loaded
+ *
+ ******************************************************************************/
+
+unsigned rcu_retire( void *ptr );
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : RcuGuard
+ *
+ * Description       : scoped read-side section of read-copy-update
+ *
+ * Constructor parameters
+ *                   : none
+ *
+ ******************************************************************************/
+
+struct RcuGuard
+{
+	 RcuGuard( void ) { rcu_readLock();   }
+	~RcuGuard( void ) { rcu_readUnlock(); }
+
+	RcuGuard( const RcuGuard & ) = delete;
+	RcuGuard &operator=( const RcuGuard & ) = delete;
+};
+
+#endif//__cplusplus
+
+#endif//OS_RCU_SIZE
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_RCU_H
@@ -0,0 +1,500 @@
+/******************************************************************************
+
+    @file    StateOS: osringbuffer.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_RNG_H
+#define __STATEOS_RNG_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : ring buffer
+ *                     single producer / single consumer byte stream,
+ *                     the producer and the consumer don't mask interrupts unless the consumer is waiting for data
+ *
+ ******************************************************************************/
+
+typedef struct __rng rng_t, * const rng_id;
+
+struct __rng
+{
+	tsk_t  * queue; // the consumer waiting for data
+	void   * res;   // allocated ring buffer object's resource
+	unsigned mask;  // size of data buffer - 1 (size is a power of 2)
+	volatile
+	unsigned head;  // free-running index of the first byte to read, updated only by the consumer
+	volatile
+	unsigned tail;  // free-running index of the first byte to write, updated only by the producer
+	char   * data;  // data buffer
+};
+
+/******************************************************************************
+ *
+ * Name              : _RNG_INIT
+ *
+ * Description       : create and initialize a ring buffer object
+ *
+ * Parameters
+ *   limit           : size of a buffer (max number of stored bytes), must be a power of 2
+ *   data            : ring buffer data
+ *
+ * Return            : ring buffer object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _RNG_INIT( _limit, _data ) { 0, 0, (_limit) - 1, 0, 0, _data }
+
+/******************************************************************************
+ *
+ * Name              : _RNG_DATA
+ *
+ * Description       : create a ring buffer data
+ *
+ * Parameters
+ *   limit           : size of a buffer (max number of stored bytes), must be a power of 2
+ *
+ * Return            : ring buffer data
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _RNG_DATA( _limit ) (char[_RNG_SIZE(_limit)]){ 0 }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : _RNG_SIZE
+ *
+ * Description       : check size of a ring buffer, compilation fails if it is not a power of 2
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _RNG_SIZE( _limit ) \
+                       ( ((_limit) > 0 && ((_limit) & ((_limit) - 1)) == 0) ? (_limit) : -1 )
+
+/******************************************************************************
+ *
+ * Name              : OS_RNG
+ *
+ * Description       : define and initialize a ring buffer object
+ *
+ * Parameters
+ *   rng             : name of a pointer to ring buffer object
+ *   limit           : size of a buffer (max number of stored bytes), must be a power of 2
+ *
+ ******************************************************************************/
+
+#define             OS_RNG( rng, limit )                                \
+           __OS_NOINIT char rng##__buf[_RNG_SIZE(limit)];               \
+                       rng_t rng##__rng = _RNG_INIT( limit, rng##__buf ); \
+                       rng_id rng = & rng##__rng
+
+/******************************************************************************
+ *
+ * Name              : static_RNG
+ *
+ * Description       : define and initialize a static ring buffer object
+ *
+ * Parameters
+ *   rng             : name of a pointer to ring buffer object
+ *   limit           : size of a buffer (max number of stored bytes), must be a power of 2
+ *
+ ******************************************************************************/
+
+#define         static_RNG( rng, limit )                                \
+    static __OS_NOINIT char rng##__buf[_RNG_SIZE(limit)];               \
+                static rng_t rng##__rng = _RNG_INIT( limit, rng##__buf ); \
+                static rng_id rng = & rng##__rng
+
+/******************************************************************************
+ *
+ * Name              : RNG_INIT
+ *
+ * Description       : create and initialize a ring buffer object
+ *
+ * Parameters
+ *   limit           : size of a buffer (max number of stored bytes), must be a power of 2
+ *
+ * Return            : ring buffer object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                RNG_INIT( limit ) \
+                      _RNG_INIT( limit, _RNG_DATA( limit ) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : RNG_CREATE
+ * Alias             : RNG_NEW
+ *
+ * Description       : create and initialize a ring buffer object
+ *
+ * Parameters
+ *   limit           : size of a buffer (max number of stored bytes), must be a power of 2
+ *
+ * Return            : pointer to ring buffer object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                RNG_CREATE( limit ) \
+           (rng_t[]) { RNG_INIT  ( limit ) }
+#define                RNG_NEW \
+                       RNG_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : rng_init
+ *
+ * Description       : initialize a ring buffer object
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *   limit           : size of a buffer (max number of stored bytes), must be a power of 2
+ *   data            : ring buffer data
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void rng_init( rng_t *rng, unsigned limit, void *data );
+
+/******************************************************************************
+ *
+ * Name              : rng_create
+ * Alias             : rng_new
+ *
+ * Description       : create and initialize a new ring buffer object
+ *
+ * Parameters
+ *   limit           : size of a buffer (max number of stored bytes), must be a power of 2
+ *
+ * Return            : pointer to ring buffer object (ring buffer successfully created)
+ *   0               : ring buffer not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+rng_t *rng_create( unsigned limit );
+
+__STATIC_INLINE
+rng_t *rng_new( unsigned limit ) { return rng_create(limit); }
+
+/******************************************************************************
+ *
+ * Name              : rng_kill
+ *
+ * Description       : reset the ring buffer object and wake up the waiting consumer with 'E_STOPPED' event value
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     the producer must not use the ring buffer at the same time
+ *
+ ******************************************************************************/
+
+void rng_kill( rng_t *rng );
+
+/******************************************************************************
+ *
+ * Name              : rng_delete
+ *
+ * Description       : reset the ring buffer object and free allocated resource
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void rng_delete( rng_t *rng );
+
+/******************************************************************************
+ *
+ * Name              : rng_waitFor
+ *
+ * Description       : try to transfer data from the ring buffer object,
+ *                     wait for given duration of time while the ring buffer object is empty
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *   data            : pointer to write buffer
+ *   size            : size of write buffer
+ *   delay           : duration of time (maximum number of ticks to wait while the ring buffer object is empty)
+ *                     IMMEDIATE: don't wait if the ring buffer object is empty
+ *                     INFINITE:  wait indefinitely while the ring buffer object is empty
+ *
+ * Return            : number of bytes read from the ring buffer
+ *
+ * Note              : use only in thread mode, only by the consumer
+ *                     critical section is entered only when the ring buffer object is empty
+ *
+ ******************************************************************************/
+
+unsigned rng_waitFor( rng_t *rng, void *data, unsigned size, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : rng_waitUntil
+ *
+ * Description       : try to transfer data from the ring buffer object,
+ *                     wait until given timepoint while the ring buffer object is empty
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *   data            : pointer to write buffer
+ *   size            : size of write buffer
+ *   time            : timepoint value
+ *
+ * Return            : number of bytes read from the ring buffer
+ *
+ * Note              : use only in thread mode, only by the consumer
+ *                     critical section is entered only when the ring buffer object is empty
+ *
+ ******************************************************************************/
+
+unsigned rng_waitUntil( rng_t *rng, void *data, unsigned size, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : rng_wait
+ *
+ * Description       : try to transfer data from the ring buffer object,
+ *                     wait indefinitely while the ring buffer object is empty
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *   data            : pointer to write buffer
+ *   size            : size of write buffer
+ *
+ * Return            : number of bytes read from the ring buffer
+ *
+ * Note              : use only in thread mode, only by the consumer
+ *                     critical section is entered only when the ring buffer object is empty
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned rng_wait( rng_t *rng, void *data, unsigned size ) { return rng_waitFor(rng, data, size, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : rng_take
+ * ISR alias         : rng_takeISR
+ *
+ * Description       : try to transfer data from the ring buffer object,
+ *                     don't wait if the ring buffer object is empty
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *   data            : pointer to write buffer
+ *   size            : size of write buffer
+ *
+ * Return            : number of bytes read from the ring buffer
+ *
+ * Note              : may be used both in thread and handler mode, only by the consumer
+ *                     it does not enter a critical section
+ *
+ ******************************************************************************/
+
+unsigned rng_take( rng_t *rng, void *data, unsigned size );
+
+__STATIC_INLINE
+unsigned rng_takeISR( rng_t *rng, void *data, unsigned size ) { return rng_take(rng, data, size); }
+
+/******************************************************************************
+ *
+ * Name              : rng_give
+ * ISR alias         : rng_giveISR
+ *
+ * Description       : transfer data to the ring buffer object, as much as fits in it,
+ *                     don't wait if the ring buffer object is full
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *   data            : pointer to read buffer
+ *   size            : size of read buffer
+ *
+ * Return            : number of bytes written to the ring buffer
+ *
+ * Note              : may be used both in thread and handler mode, only by the producer
+ *                     critical section is entered only to wake up the waiting consumer
+ *
+ ******************************************************************************/
+
+unsigned rng_give( rng_t *rng, const void *data, unsigned size );
+
+__STATIC_INLINE
+unsigned rng_giveISR( rng_t *rng, const void *data, unsigned size ) { return rng_give(rng, data, size); }
+
+/******************************************************************************
+ *
+ * Name              : rng_count
+ * ISR alias         : rng_countISR
+ *
+ * Description       : return the amount of data contained in the ring buffer
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *
+ * Return            : number of data bytes in the ring buffer
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned rng_count( rng_t *rng ) { return rng->tail - rng->head; }
+
+__STATIC_INLINE
+unsigned rng_countISR( rng_t *rng ) { return rng_count(rng); }
+
+/******************************************************************************
+ *
+ * Name              : rng_space
+ * ISR alias         : rng_spaceISR
+ *
+ * Description       : return the amount of free space in the ring buffer
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *
+ * Return            : number of free bytes in the ring buffer
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned rng_space( rng_t *rng ) { return rng->mask + 1 - rng_count(rng); }
+
+__STATIC_INLINE
+unsigned rng_spaceISR( rng_t *rng ) { return rng_space(rng); }
+
+/******************************************************************************
+ *
+ * Name              : rng_limit
+ * ISR alias         : rng_limitISR
+ *
+ * Description       : return the size of the ring buffer
+ *
+ * Parameters
+ *   rng             : pointer to ring buffer object
+ *
+ * Return            : size of the ring buffer
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned rng_limit( rng_t *rng ) { return rng->mask + 1; }
+
+__STATIC_INLINE
+unsigned rng_limitISR( rng_t *rng ) { return rng_limit(rng); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : RingBufferT<>
+ *
+ * Description       : create and initialize a ring buffer object
+ *
+ * Constructor parameters
+ *   limit           : size of a buffer (max number of stored bytes), must be a power of 2
+ *
+ ******************************************************************************/
+
+template<unsigned limit_>
+struct RingBufferT : public __rng
+{
+	static_assert(limit_ > 0 && (limit_ & (limit_ - 1)) == 0, "size of a ring buffer must be a power of 2");
+
+	 RingBufferT( void ): __rng _RNG_INIT(limit_, data_) {}
+	~RingBufferT( void ) { assert(__rng::queue == nullptr); }
+
+	void     kill     ( void )                                            {        rng_kill     (this);                       }
+	unsigned waitFor  (       void *_data, unsigned _size, cnt_t _delay ) { return rng_waitFor  (this, _data, _size, _delay); }
+	unsigned waitUntil(       void *_data, unsigned _size, cnt_t _time )  { return rng_waitUntil(this, _data, _size, _time);  }
+	unsigned wait     (       void *_data, unsigned _size )               { return rng_wait     (this, _data, _size);         }
+	unsigned take     (       void *_data, unsigned _size )               { return rng_take     (this, _data, _size);         }
+	unsigned takeISR  (       void *_data, unsigned _size )               { return rng_takeISR  (this, _data, _size);         }
+	unsigned give     ( const void *_data, unsigned _size )               { return rng_give     (this, _data, _size);         }
+	unsigned giveISR  ( const void *_data, unsigned _size )               { return rng_giveISR  (this, _data, _size);         }
+	unsigned count    ( void )                                            { return rng_count    (this);                       }
+	unsigned countISR ( void )                                            { return rng_countISR (this);                       }
+	unsigned space    ( void )                                            { return rng_space    (this);                       }
+	unsigned spaceISR ( void )                                            { return rng_spaceISR (this);                       }
+	unsigned limit    ( void )                                            { return rng_limit    (this);                       }
+	unsigned limitISR ( void )                                            { return rng_limitISR (this);                       }
+
+	private:
+	char data_[limit_];
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_RNG_H
@@ -0,0 +1,475 @@
+/******************************************************************************
+
+    @file    StateOS: osrwlock.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_RWL_H
+#define __STATEOS_RWL_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : reader-writer lock
+ *                     like a POSIX pthread_rwlock_t
+ *
+ * Note              : many readers or one writer can hold the lock at the same time,
+ *                     writer preference: a new reader doesn't get the lock while any writer is waiting,
+ *                     all readers waiting when the writer releases the lock get it in one batch
+ *
+ ******************************************************************************/
+
+typedef struct __rwl rwl_t, * const rwl_id;
+
+struct __rwl
+{
+	tsk_t  * queue; // next process in the DELAYED queue (readers)
+	void   * res;   // allocated reader-writer lock object's resource
+	tsk_t  * write; // next process in the DELAYED queue of writers
+	tsk_t  * owner; // writer holding the lock
+	unsigned count; // number of readers holding the lock
+};
+
+/******************************************************************************
+ *
+ * Name              : _RWL_INIT
+ *
+ * Description       : create and initialize a reader-writer lock object
+ *
+ * Parameters        : none
+ *
+ * Return            : reader-writer lock object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _RWL_INIT() { 0, 0, 0, 0, 0 }
+
+/******************************************************************************
+ *
+ * Name              : OS_RWL
+ *
+ * Description       : define and initialize a reader-writer lock object
+ *
+ * Parameters
+ *   rwl             : name of a pointer to reader-writer lock object
+ *
+ ******************************************************************************/
+
+#define             OS_RWL( rwl )                     \
+                       rwl_t rwl##__rwl = _RWL_INIT(); \
+                       rwl_id rwl = & rwl##__rwl
+
+/******************************************************************************
+ *
+ * Name              : static_RWL
+ *
+ * Description       : define and initialize a static reader-writer lock object
+ *
+ * Parameters
+ *   rwl             : name of a pointer to reader-writer lock object
+ *
+ ******************************************************************************/
+
+#define         static_RWL( rwl )                     \
+                static rwl_t rwl##__rwl = _RWL_INIT(); \
+                static rwl_id rwl = & rwl##__rwl
+
+/******************************************************************************
+ *
+ * Name              : RWL_INIT
+ *
+ * Description       : create and initialize a reader-writer lock object
+ *
+ * Parameters        : none
+ *
+ * Return            : reader-writer lock object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                RWL_INIT() \
+                      _RWL_INIT()
+#endif
+
+/******************************************************************************
+ *
+ * Name              : RWL_CREATE
+ * Alias             : RWL_NEW
+ *
+ * Description       : create and initialize a reader-writer lock object
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to reader-writer lock object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                RWL_CREATE() \
+           (rwl_t[]) { RWL_INIT  () }
+#define                RWL_NEW \
+                       RWL_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : rwl_init
+ *
+ * Description       : initialize a reader-writer lock object
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void rwl_init( rwl_t *rwl );
+
+/******************************************************************************
+ *
+ * Name              : rwl_create
+ * Alias             : rwl_new
+ *
+ * Description       : create and initialize a new reader-writer lock object
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to reader-writer lock object (reader-writer lock successfully created)
+ *   0               : reader-writer lock not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+rwl_t *rwl_create( void );
+
+__STATIC_INLINE
+rwl_t *rwl_new( void ) { return rwl_create(); }
+
+/******************************************************************************
+ *
+ * Name              : rwl_kill
+ *
+ * Description       : reset the reader-writer lock object and wake up all waiting tasks with 'E_STOPPED' event value
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void rwl_kill( rwl_t *rwl );
+
+/******************************************************************************
+ *
+ * Name              : rwl_delete
+ *
+ * Description       : reset the reader-writer lock object and free allocated resource
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void rwl_delete( rwl_t *rwl );
+
+/******************************************************************************
+ *
+ * Name              : rwl_takeRead
+ *
+ * Description       : try to lock the reader-writer lock object for reading,
+ *                     don't wait if the reader-writer lock object can't be locked immediately
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *
+ * Return
+ *   E_SUCCESS       : reader-writer lock object was successfully locked
+ *   E_TIMEOUT       : reader-writer lock object can't be locked immediately
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned rwl_takeRead( rwl_t *rwl );
+
+/******************************************************************************
+ *
+ * Name              : rwl_waitReadFor
+ *
+ * Description       : try to lock the reader-writer lock object for reading,
+ *                     wait for given duration of time while the reader-writer lock object can't be locked
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *   delay           : duration of time (maximum number of ticks to wait for lock the reader-writer lock object)
+ *                     IMMEDIATE: don't wait if the reader-writer lock object can't be locked
+ *                     INFINITE:  wait indefinitely until the reader-writer lock object has been locked
+ *
+ * Return
+ *   E_SUCCESS       : reader-writer lock object was successfully locked
+ *   E_STOPPED       : reader-writer lock object was killed before the specified timeout expired
+ *   E_TIMEOUT       : reader-writer lock object was not locked before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned rwl_waitReadFor( rwl_t *rwl, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : rwl_waitReadUntil
+ *
+ * Description       : try to lock the reader-writer lock object for reading,
+ *                     wait until given timepoint while the reader-writer lock object can't be locked
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : reader-writer lock object was successfully locked
+ *   E_STOPPED       : reader-writer lock object was killed before the specified timeout expired
+ *   E_TIMEOUT       : reader-writer lock object was not locked before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned rwl_waitReadUntil( rwl_t *rwl, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : rwl_waitRead
+ *
+ * Description       : try to lock the reader-writer lock object for reading,
+ *                     wait indefinitely while the reader-writer lock object can't be locked
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *
+ * Return
+ *   E_SUCCESS       : reader-writer lock object was successfully locked
+ *   E_STOPPED       : reader-writer lock object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned rwl_waitRead( rwl_t *rwl ) { return rwl_waitReadFor(rwl, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : rwl_giveRead
+ *
+ * Description       : unlock the reader-writer lock object locked for reading
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *
+ * Return
+ *   E_SUCCESS       : reader-writer lock object was successfully unlocked
+ *   E_TIMEOUT       : reader-writer lock object was not locked for reading
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned rwl_giveRead( rwl_t *rwl );
+
+/******************************************************************************
+ *
+ * Name              : rwl_takeWrite
+ *
+ * Description       : try to lock the reader-writer lock object for writing,
+ *                     don't wait if the reader-writer lock object can't be locked immediately
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *
+ * Return
+ *   E_SUCCESS       : reader-writer lock object was successfully locked
+ *   E_TIMEOUT       : reader-writer lock object can't be locked immediately
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned rwl_takeWrite( rwl_t *rwl );
+
+/******************************************************************************
+ *
+ * Name              : rwl_waitWriteFor
+ *
+ * Description       : try to lock the reader-writer lock object for writing,
+ *                     wait for given duration of time while the reader-writer lock object can't be locked
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *   delay           : duration of time (maximum number of ticks to wait for lock the reader-writer lock object)
+ *                     IMMEDIATE: don't wait if the reader-writer lock object can't be locked
+ *                     INFINITE:  wait indefinitely until the reader-writer lock object has been locked
+ *
+ * Return
+ *   E_SUCCESS       : reader-writer lock object was successfully locked
+ *   E_STOPPED       : reader-writer lock object was killed before the specified timeout expired
+ *   E_TIMEOUT       : reader-writer lock object was not locked before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned rwl_waitWriteFor( rwl_t *rwl, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : rwl_waitWriteUntil
+ *
+ * Description       : try to lock the reader-writer lock object for writing,
+ *                     wait until given timepoint while the reader-writer lock object can't be locked
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : reader-writer lock object was successfully locked
+ *   E_STOPPED       : reader-writer lock object was killed before the specified timeout expired
+ *   E_TIMEOUT       : reader-writer lock object was not locked before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned rwl_waitWriteUntil( rwl_t *rwl, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : rwl_waitWrite
+ *
+ * Description       : try to lock the reader-writer lock object for writing,
+ *                     wait indefinitely while the reader-writer lock object can't be locked
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *
+ * Return
+ *   E_SUCCESS       : reader-writer lock object was successfully locked
+ *   E_STOPPED       : reader-writer lock object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned rwl_waitWrite( rwl_t *rwl ) { return rwl_waitWriteFor(rwl, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : rwl_giveWrite
+ *
+ * Description       : unlock the reader-writer lock object locked for writing
+ *
+ * Parameters
+ *   rwl             : pointer to reader-writer lock object
+ *
+ * Return
+ *   E_SUCCESS       : reader-writer lock object was successfully unlocked
+ *   E_TIMEOUT       : reader-writer lock object was not locked for writing by current task
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned rwl_giveWrite( rwl_t *rwl );
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : RWLock
+ *
+ * Description       : create and initialize a reader-writer lock object
+ *
+ * Constructor parameters
+ *                   : none
+ *
+ ******************************************************************************/
+
+struct RWLock : public __rwl
+{
+	constexpr RWLock( void ): __rwl _RWL_INIT() {}
+	~RWLock( void ) { assert(__rwl::owner == nullptr && __rwl::count == 0); }
+
+	void     kill          ( void )         {        rwl_kill          (this);         }
+	unsigned takeRead      ( void )         { return rwl_takeRead      (this);         }
+	unsigned waitReadFor   ( cnt_t _delay ) { return rwl_waitReadFor   (this, _delay); }
+	unsigned waitReadUntil ( cnt_t _time )  { return rwl_waitReadUntil (this, _time);  }
+	unsigned waitRead      ( void )         { return rwl_waitRead      (this);         }
+	unsigned giveRead      ( void )         { return rwl_giveRead      (this);         }
+	unsigned takeWrite     ( void )         { return rwl_takeWrite     (this);         }
+	unsigned waitWriteFor  ( cnt_t _delay ) { return rwl_waitWriteFor  (this, _delay); }
+	unsigned waitWriteUntil( cnt_t _time )  { return rwl_waitWriteUntil(this, _time);  }
+	unsigned waitWrite     ( void )         { return rwl_waitWrite     (this);         }
+	unsigned giveWrite     ( void )         { return rwl_giveWrite     (this);         }
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_RWL_H
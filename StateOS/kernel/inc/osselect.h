@@ -0,0 +1,348 @@
+/******************************************************************************
+
+    @file    StateOS: osselect.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_SEL_H
+#define __STATEOS_SEL_H
+
+#include "oskernel.h"
+
+#if OS_SELECT
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : wait-set
+ *
+ * Note              : a wait-set watches up to OS_SELECT objects (semaphores, signals, mailbox queues, stream buffers,
+ *                     message buffers, event queues); the object notifies the wait-set from its give path when it holds
+ *                     data that was not passed directly to a waiting task; notification only tells which object may be ready,
+ *                     it can be coalesced with the previous one or be spurious (another task took the data first),
+ *                     so the object must be drained with a non-blocking function (e.g. 'sem_take', 'box_take')
+ *
+ ******************************************************************************/
+
+typedef struct __sel sel_t, * const sel_id;
+
+struct __sel
+{
+	tsk_t  * queue; // next process in the DELAYED queue
+	void   * res;   // allocated wait-set object's resource
+	sel_t  * next;  // next wait-set object in the list of the watching wait-sets
+	unsigned flags; // bit mask of the ready objects
+	unsigned count; // number of the watched objects
+	void   * obj[OS_SELECT]; // watched objects
+};
+
+/******************************************************************************
+ *
+ * Name              : _SEL_INIT
+ *
+ * Description       : create and initialize a wait-set object
+ *
+ * Parameters        : none
+ *
+ * Return            : wait-set object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _SEL_INIT() { 0, 0, 0, 0, 0, { 0 } }
+
+/******************************************************************************
+ *
+ * Name              : OS_SEL
+ *
+ * Description       : define and initialize a wait-set object
+ *
+ * Parameters
+ *   sel             : name of a pointer to wait-set object
+ *
+ ******************************************************************************/
+
+#define             OS_SEL( sel )                     \
+                       sel_t sel##__sel = _SEL_INIT(); \
+                       sel_id sel = & sel##__sel
+
+/******************************************************************************
+ *
+ * Name              : static_SEL
+ *
+ * Description       : define and initialize a static wait-set object
+ *
+ * Parameters
+ *   sel             : name of a pointer to wait-set object
+ *
+ ******************************************************************************/
+
+#define         static_SEL( sel )                     \
+                static sel_t sel##__sel = _SEL_INIT(); \
+                static sel_id sel = & sel##__sel
+
+/******************************************************************************
+ *
+ * Name              : SEL_INIT
+ *
+ * Description       : create and initialize a wait-set object
+ *
+ * Parameters        : none
+ *
+ * Return            : wait-set object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                SEL_INIT() \
+                      _SEL_INIT()
+#endif
+
+/******************************************************************************
+ *
+ * Name              : SEL_CREATE
+ * Alias             : SEL_NEW
+ *
+ * Description       : create and initialize a wait-set object
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to wait-set object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                SEL_CREATE() \
+           (sel_t[]) { SEL_INIT  () }
+#define                SEL_NEW \
+                       SEL_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sel_init
+ *
+ * Description       : initialize a wait-set object
+ *
+ * Parameters
+ *   sel             : pointer to wait-set object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     wait-set object watching any objects must be killed first
+ *
+ ******************************************************************************/
+
+void sel_init( sel_t *sel );
+
+/******************************************************************************
+ *
+ * Name              : sel_create
+ * Alias             : sel_new
+ *
+ * Description       : create and initialize a new wait-set object
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to wait-set object (wait-set successfully created)
+ *   0               : wait-set not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+sel_t *sel_create( void );
+
+__STATIC_INLINE
+sel_t *sel_new( void ) { return sel_create(); }
+
+/******************************************************************************
+ *
+ * Name              : sel_kill
+ *
+ * Description       : remove all watched objects from the wait-set object
+ *                     and wake up all waiting tasks with 'E_STOPPED' event value
+ *
+ * Parameters
+ *   sel             : pointer to wait-set object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void sel_kill( sel_t *sel );
+
+/******************************************************************************
+ *
+ * Name              : sel_delete
+ *
+ * Description       : reset the wait-set object and free allocated resource
+ *
+ * Parameters
+ *   sel             : pointer to wait-set object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void sel_delete( sel_t *sel );
+
+/******************************************************************************
+ *
+ * Name              : sel_add
+ *
+ * Description       : add an object to the wait-set object
+ *                     the object is initially marked as ready, as it may already hold data
+ *
+ * Parameters
+ *   sel             : pointer to wait-set object
+ *   obj             : pointer to semaphore, signal, mailbox queue, stream buffer, message buffer or event queue object
+ *
+ * Return            : index of the object in the wait-set object (0 .. OS_SELECT - 1)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned sel_add( sel_t *sel, const void *obj );
+
+/******************************************************************************
+ *
+ * Name              : sel_waitFor
+ *
+ * Description       : wait for any of the objects of the wait-set object to become ready for given duration of time
+ *
+ * Parameters
+ *   sel             : pointer to wait-set object
+ *   delay           : duration of time (maximum number of ticks to wait for any ready object)
+ *                     IMMEDIATE: don't wait if no object is ready
+ *                     INFINITE:  wait indefinitely until any object becomes ready
+ *
+ * Return
+ *   E_STOPPED       : wait-set object was killed before the specified timeout expired
+ *   E_TIMEOUT       : no object became ready before the specified timeout expired
+ *   'another'       : index of the ready object (the lowest one, if more objects are ready)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned sel_waitFor( sel_t *sel, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : sel_waitUntil
+ *
+ * Description       : wait for any of the objects of the wait-set object to become ready until given timepoint
+ *
+ * Parameters
+ *   sel             : pointer to wait-set object
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_STOPPED       : wait-set object was killed before the specified timeout expired
+ *   E_TIMEOUT       : no object became ready before the specified timeout expired
+ *   'another'       : index of the ready object (the lowest one, if more objects are ready)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned sel_waitUntil( sel_t *sel, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : sel_wait
+ *
+ * Description       : wait indefinitely until any of the objects of the wait-set object becomes ready
+ *
+ * Parameters
+ *   sel             : pointer to wait-set object
+ *
+ * Return
+ *   E_STOPPED       : wait-set object was killed
+ *   'another'       : index of the ready object (the lowest one, if more objects are ready)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned sel_wait( sel_t *sel ) { return sel_waitFor(sel, INFINITE); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : Select
+ *
+ * Description       : create and initialize a wait-set object
+ *
+ * Constructor parameters
+ *                   : none
+ *
+ ******************************************************************************/
+
+struct Select : public __sel
+{
+	constexpr Select( void ): __sel _SEL_INIT() {}
+	~Select( void ) { assert(__sel::queue == nullptr); sel_kill(this); }
+
+	unsigned add      ( const void *_obj ) { return sel_add      (this, _obj);   }
+	void     kill     ( void )             {        sel_kill     (this);         }
+	unsigned waitFor  ( cnt_t _delay )     { return sel_waitFor  (this, _delay); }
+	unsigned waitUntil( cnt_t _time )      { return sel_waitUntil(this, _time);  }
+	unsigned wait     ( void )             { return sel_wait     (this);         }
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//OS_SELECT
+
+#endif//__STATEOS_SEL_H
@@ -58,6 +58,9 @@ struct __sem
 	void   * res;   // allocated semaphore object's resource
 	unsigned count; // semaphore's current value
 	unsigned limit; // semaphore's value limit
+#if OS_OBJ_STATS
+	ost_t    ost;   // contention statistics
+#endif
 };
 
 /******************************************************************************
@@ -79,7 +82,7 @@ struct __sem
  *
  ******************************************************************************/
 
-#define               _SEM_INIT( _init, _limit ) { 0, 0, _init, _limit }
+#define               _SEM_INIT( _init, _limit ) { 0, 0, _init, _limit _OST_INIT }
 
 /******************************************************************************
  *
@@ -350,6 +353,7 @@ unsigned sem_wait( sem_t *sem ) { return sem_waitFor(sem, INFINITE); }
  *   E_TIMEOUT       : semaphore object can't be locked immediately
  *
  * Note              : may be used both in thread and handler mode
+ *                     with OS_SEM_LOCKFREE it does not enter a critical section when no task is waiting
  *
  ******************************************************************************/
 
@@ -358,6 +362,33 @@ unsigned sem_take( sem_t *sem );
 __STATIC_INLINE
 unsigned sem_takeISR( sem_t *sem ) { return sem_take(sem); }
 
+/******************************************************************************
+ *
+ * Name              : sem_takeN
+ *
+ * Description       : try to lock given number of units of the semaphore object at once,
+ *                     wait for given duration of time if the units can't be locked immediately
+ *
+ * Parameters
+ *   sem             : pointer to semaphore object
+ *   num             : number of units to lock (1 .. limit)
+ *   delay           : duration of time (maximum number of ticks to wait for lock the units)
+ *                     IMMEDIATE: don't wait if the units can't be locked immediately
+ *                     INFINITE:  wait indefinitely until the units have been locked
+ *
+ * Return
+ *   E_SUCCESS       : all the units were successfully locked
+ *   E_STOPPED       : semaphore object was killed before the specified timeout expired
+ *   E_TIMEOUT       : the units were not locked before the specified timeout expired
+ *
+ * Note              : waiting tasks are served in the queue order (by priority, then fifo);
+ *                     no task can lock the semaphore object before the first waiting task is satisfied
+ *                     use only in thread mode, unless delay is IMMEDIATE
+ *
+ ******************************************************************************/
+
+unsigned sem_takeN( sem_t *sem, unsigned num, cnt_t delay );
+
 /******************************************************************************
  *
  * Name              : sem_sendFor
@@ -441,6 +472,7 @@ unsigned sem_send( sem_t *sem ) { return sem_sendFor(sem, INFINITE); }
  *   E_TIMEOUT       : semaphore object can't be unlocked immediately
  *
  * Note              : may be used both in thread and handler mode
+ *                     with OS_SEM_LOCKFREE it does not enter a critical section when no task is waiting
  *
  ******************************************************************************/
 
@@ -449,6 +481,28 @@ unsigned sem_give( sem_t *sem );
 __STATIC_INLINE
 unsigned sem_giveISR( sem_t *sem ) { return sem_give(sem); }
 
+/******************************************************************************
+ *
+ * Name              : sem_giveN
+ *
+ * Description       : try to unlock given number of units of the semaphore object at once,
+ *                     don't wait if the units can't be unlocked immediately;
+ *                     waiting tasks are resumed in a single pass over the queue
+ *
+ * Parameters
+ *   sem             : pointer to semaphore object
+ *   num             : number of units to unlock
+ *
+ * Return
+ *   E_SUCCESS       : all the units were successfully unlocked
+ *   E_TIMEOUT       : the units can't be unlocked without exceeding the limit, nothing was unlocked
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned sem_giveN( sem_t *sem, unsigned num );
+
 #ifdef __cplusplus
 }
 #endif
@@ -474,20 +528,22 @@ unsigned sem_giveISR( sem_t *sem ) { return sem_give(sem); }
 
 struct Semaphore : public __sem
 {
-	 Semaphore( const unsigned _init, const unsigned _limit = semCounting ): __sem _SEM_INIT(_init, _limit) {}
+	constexpr Semaphore( const unsigned _init, const unsigned _limit = semCounting ): __sem _SEM_INIT(_init, _limit) {}
 	~Semaphore( void ) { assert(__sem::queue == nullptr); }
 
-	void     kill     ( void )         {        sem_kill     (this);         }
-	unsigned waitFor  ( cnt_t _delay ) { return sem_waitFor  (this, _delay); }
-	unsigned waitUntil( cnt_t _time )  { return sem_waitUntil(this, _time);  }
-	unsigned wait     ( void )         { return sem_wait     (this);         }
-	unsigned take     ( void )         { return sem_take     (this);         }
-	unsigned takeISR  ( void )         { return sem_takeISR  (this);         }
-	unsigned sendFor  ( cnt_t _delay ) { return sem_sendFor  (this, _delay); }
-	unsigned sendUntil( cnt_t _time )  { return sem_sendUntil(this, _time);  }
-	unsigned send     ( void )         { return sem_send     (this);         }
-	unsigned give     ( void )         { return sem_give     (this);         }
-	unsigned giveISR  ( void )         { return sem_giveISR  (this);         }
+	void     kill     ( void )                        {        sem_kill     (this);               }
+	unsigned waitFor  ( cnt_t _delay )                { return sem_waitFor  (this, _delay);       }
+	unsigned waitUntil( cnt_t _time )                 { return sem_waitUntil(this, _time);        }
+	unsigned wait     ( void )                        { return sem_wait     (this);               }
+	unsigned take     ( void )                        { return sem_take     (this);               }
+	unsigned takeISR  ( void )                        { return sem_takeISR  (this);               }
+	unsigned takeN    ( unsigned _num, cnt_t _delay ) { return sem_takeN    (this, _num, _delay); }
+	unsigned sendFor  ( cnt_t _delay )                { return sem_sendFor  (this, _delay);       }
+	unsigned sendUntil( cnt_t _time )                 { return sem_sendUntil(this, _time);        }
+	unsigned send     ( void )                        { return sem_send     (this);               }
+	unsigned give     ( void )                        { return sem_give     (this);               }
+	unsigned giveISR  ( void )                        { return sem_giveISR  (this);               }
+	unsigned giveN    ( unsigned _num )               { return sem_giveN    (this, _num);         }
 };
 
 /******************************************************************************
@@ -503,7 +559,7 @@ struct Semaphore : public __sem
 
 struct BinarySemaphore : public Semaphore
 {
-	BinarySemaphore( const unsigned _init = 0 ): Semaphore(_init, semBinary) {}
+	constexpr BinarySemaphore( const unsigned _init = 0 ): Semaphore(_init, semBinary) {}
 };
 
 /******************************************************************************
@@ -519,7 +575,7 @@ struct BinarySemaphore : public Semaphore
 
 struct CountingSemaphore : public Semaphore
 {
-	CountingSemaphore( const unsigned _init = 0 ): Semaphore(_init, semCounting) {}
+	constexpr CountingSemaphore( const unsigned _init = 0 ): Semaphore(_init, semCounting) {}
 };
 
 #endif//__cplusplus
@@ -0,0 +1,359 @@
+/******************************************************************************
+
+    @file    StateOS: osseqlock.h
+    @author  Rajmund Szymanski
+    @date    14.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+
+#ifndef __STATEOS_SEQ_H
+#define __STATEOS_SEQ_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sequence lock
+ *
+ * Note              : sequence counter is odd while the writer is updating the protected data;
+ *                     readers never mask interrupts and never block, they retry the read instead;
+ *                     a reader must never preempt the writer (e.g. a handler reading data updated in thread mode):
+ *                     the interrupted writer can't finish the update and the reader would retry forever,
+ *                     only the writer may run in the higher priority context
+ *
+ ******************************************************************************/
+
+typedef volatile unsigned seq_t, * const seq_id;
+
+/******************************************************************************
+ *
+ * Name              : _SEQ_INIT
+ *
+ * Description       : create and initialize a sequence lock object
+ *
+ * Parameters        : none
+ *
+ * Return            : sequence lock object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _SEQ_INIT()   0
+
+/******************************************************************************
+ *
+ * Name              : OS_SEQ
+ *
+ * Description       : define and initialize a sequence lock object
+ *
+ * Parameters
+ *   seq             : name of a pointer to sequence lock object
+ *
+ ******************************************************************************/
+
+#define             OS_SEQ( seq )                     \
+                       seq_t seq##__seq = _SEQ_INIT(); \
+                       seq_id seq = & seq##__seq
+
+/******************************************************************************
+ *
+ * Name              : static_SEQ
+ *
+ * Description       : define and initialize a static sequence lock object
+ *
+ * Parameters
+ *   seq             : name of a pointer to sequence lock object
+ *
+ ******************************************************************************/
+
+#define         static_SEQ( seq )                     \
+                static seq_t seq##__seq = _SEQ_INIT(); \
+                static seq_id seq = & seq##__seq
+
+/******************************************************************************
+ *
+ * Name              : SEQ_INIT
+ *
+ * Description       : create and initialize a sequence lock object
+ *
+ * Parameters        : none
+ *
+ * Return            : sequence lock object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                SEQ_INIT() \
+                      _SEQ_INIT()
+#endif
+
+/******************************************************************************
+ *
+ * Name              : SEQ_CREATE
+ * Alias             : SEQ_NEW
+ *
+ * Description       : create and initialize a sequence lock object
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to sequence lock object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                SEQ_CREATE() \
+           (seq_t[]) { SEQ_INIT  () }
+#define                SEQ_NEW \
+                       SEQ_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : seq_init
+ *
+ * Description       : initialize a sequence lock object
+ *
+ * Parameters
+ *   seq             : pointer to sequence lock object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void seq_init( seq_t *seq ) { *seq = 0; }
+
+/******************************************************************************
+ *
+ * Name              : seq_writeBegin
+ *
+ * Description       : start updating the data protected by the sequence lock object
+ *
+ * Parameters
+ *   seq             : pointer to sequence lock object
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     writers are not serialized: there must be only one writer at a time
+ *                     (e.g. a single interrupt handler or writers inside a critical section)
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void seq_writeBegin( seq_t *seq )
+{
+	*seq = *seq + 1;
+	port_mem_barrier();
+}
+
+/******************************************************************************
+ *
+ * Name              : seq_writeEnd
+ *
+ * Description       : finish updating the data protected by the sequence lock object
+ *
+ * Parameters
+ *   seq             : pointer to sequence lock object
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void seq_writeEnd( seq_t *seq )
+{
+	port_mem_barrier();
+	*seq = *seq + 1;
+}
+
+/******************************************************************************
+ *
+ * Name              : seq_readBegin
+ *
+ * Description       : start reading the data protected by the sequence lock object
+ *
+ * Parameters
+ *   seq             : pointer to sequence lock object
+ *
+ * Return            : value of the sequence counter to be passed to seq_readRetry
+ *
+ * Note              : may be used both in thread and handler mode,
+ *                     but a reader must not preempt the writer, otherwise it would retry forever
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned seq_readBegin( seq_t *seq )
+{
+	unsigned cnt = *seq;
+	port_mem_barrier();
+	return cnt;
+}
+
+/******************************************************************************
+ *
+ * Name              : seq_readRetry
+ *
+ * Description       : finish reading the data protected by the sequence lock object
+ *
+ * Parameters
+ *   seq             : pointer to sequence lock object
+ *   cnt             : value returned by seq_readBegin
+ *
+ * Return
+ *   true            : the data were updated during the read, the read must be repeated
+ *   false           : the data read are consistent
+ *
+ * Note              : may be used both in thread and handler mode,
+ *                     but a reader must not preempt the writer, otherwise it would retry forever
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+bool seq_readRetry( seq_t *seq, unsigned cnt )
+{
+	port_mem_barrier();
+	return (cnt & 1) != 0 || *seq != cnt;
+}
+
+/******************************************************************************
+ *
+ * Name              : seq_write
+ *
+ * Description       : copy 'size' bytes from 'src' to the data 'dst' protected by the sequence lock object
+ *
+ * Parameters
+ *   seq             : pointer to sequence lock object
+ *   dst             : pointer to the protected data
+ *   src             : pointer to the new data
+ *   size            : size of the data (in bytes)
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void seq_write( seq_t *seq, void *dst, const void *src, size_t size )
+{
+	seq_writeBegin(seq);
+	memcpy(dst, src, size);
+	seq_writeEnd(seq);
+}
+
+/******************************************************************************
+ *
+ * Name              : seq_read
+ *
+ * Description       : copy a consistent snapshot of 'size' bytes of the data 'src'
+ *                     protected by the sequence lock object to 'dst', retry if the writer intervened
+ *
+ * Parameters
+ *   seq             : pointer to sequence lock object
+ *   dst             : pointer to the buffer for the snapshot
+ *   src             : pointer to the protected data
+ *   size            : size of the data (in bytes)
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode,
+ *                     but a reader must not preempt the writer, otherwise it would retry forever
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void seq_read( seq_t *seq, void *dst, const void *src, size_t size )
+{
+	unsigned cnt;
+
+	do
+	{
+		cnt = seq_readBegin(seq);
+		memcpy(dst, src, size);
+	}
+	while (seq_readRetry(seq, cnt));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : SeqLocked<>
+ *
+ * Description       : create and initialize an object of type T protected by a sequence lock
+ *
+ * Constructor parameters
+ *   init            : initial value of the protected object
+ *
+ * Note              : T must be trivially copyable
+ *                     'load' must not preempt 'store', otherwise it would retry forever
+ *
+ ******************************************************************************/
+
+template<class T>
+struct SeqLocked
+{
+	static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+	constexpr
+	SeqLocked( void ): seq_(_SEQ_INIT()), data_() {}
+	SeqLocked( const T &_init ): seq_(_SEQ_INIT()), data_(_init) {}
+
+	void store( const T &_val ) {        seq_write(&seq_, &data_, &_val, sizeof(T)); }
+	T    load ( void )          { T val; seq_read (&seq_, &val, &data_, sizeof(T)); return val; }
+
+	private:
+	seq_t seq_;
+	T     data_;
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_SEQ_H
@@ -354,6 +354,7 @@ unsigned sig_takeISR( sig_t *sig ) { return sig_take(sig); }
  * Return            : none
  *
  * Note              : may be used both in thread and handler mode
+ *                     with OS_SIG_LOCKFREE it does not enter a critical section when no task is waiting
  *
  ******************************************************************************/
 
@@ -406,7 +407,7 @@ void sig_clearISR( sig_t *sig ) { sig_clear(sig); }
 
 struct Signal : public __sig
 {
-	 Signal( const unsigned _type = sigClear ): __sig _SIG_INIT(_type) {}
+	constexpr Signal( const unsigned _type = sigClear ): __sig _SIG_INIT(_type) {}
 	~Signal( void ) { assert(__sig::queue == nullptr); }
 
 	void     kill     ( void )         {        sig_kill     (this);         }
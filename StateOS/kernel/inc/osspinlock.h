@@ -277,6 +277,19 @@ struct SpinLock : private CriticalSection
 	spn_id spn;
 };
 
+/******************************************************************************
+ *
+ * Class             : SpinGuard
+ *
+ * Description       : scoped guard of a spin lock object (alias of SpinLock)
+ *
+ * Constructor parameters
+ *   spn             : pointer to spin lock object
+ *
+ ******************************************************************************/
+
+typedef SpinLock SpinGuard;
+
 #endif//__cplusplus
 
 /* -------------------------------------------------------------------------- */
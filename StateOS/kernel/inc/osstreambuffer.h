@@ -56,6 +56,9 @@ struct __stm
 	unsigned head;  // first element to read from data buffer
 	unsigned tail;  // first element to write into data buffer
 	char   * data;  // data buffer
+	unsigned level; // trigger level: minimum number of bytes to wake up the reader, 0: any
+	bool     over;  // overwrite mode: the oldest data are dropped when the stream buffer is full
+	unsigned drop;  // number of dropped bytes
 };
 
 /******************************************************************************
@@ -74,7 +77,7 @@ struct __stm
  *
  ******************************************************************************/
 
-#define               _STM_INIT( _limit, _data ) { 0, 0, 0, _limit, 0, 0, _data }
+#define               _STM_INIT( _limit, _data ) { 0, 0, 0, _limit, 0, 0, _data, 0, false, 0 }
 
 /******************************************************************************
  *
@@ -122,7 +125,28 @@ struct __stm
  ******************************************************************************/
 
 #define             OS_STM( stm, limit, ... )                                                 \
-                       char stm##__buf[_VA_STM(limit, __VA_ARGS__)];                           \
+           __OS_NOINIT char stm##__buf[_VA_STM(limit, __VA_ARGS__)];                           \
+                       stm_t stm##__stm = _STM_INIT( _VA_STM(limit, __VA_ARGS__), stm##__buf ); \
+                       stm_id stm = & stm##__stm
+
+/******************************************************************************
+ *
+ * Name              : OS_STM_NOINIT
+ *
+ * Description       : define and initialize a stream buffer object
+ *                     with data buffer placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   stm             : name of a pointer to stream buffer object
+ *   limit           : size of a buffer (max number of stored bytes / objects)
+ *   type            : (optional) size of the object (in bytes); default: 1
+ *
+ * Note              : use only at file scope
+ *
+ ******************************************************************************/
+
+#define      OS_STM_NOINIT( stm, limit, ... )                                                 \
+              __NOINIT char stm##__buf[_VA_STM(limit, __VA_ARGS__)];                           \
                        stm_t stm##__stm = _STM_INIT( _VA_STM(limit, __VA_ARGS__), stm##__buf ); \
                        stm_id stm = & stm##__stm
 
@@ -140,7 +164,26 @@ struct __stm
  ******************************************************************************/
 
 #define         static_STM( stm, limit, ... )                                                 \
-                static char stm##__buf[_VA_STM(limit, __VA_ARGS__)];                           \
+    static __OS_NOINIT char stm##__buf[_VA_STM(limit, __VA_ARGS__)];                           \
+                static stm_t stm##__stm = _STM_INIT( _VA_STM(limit, __VA_ARGS__), stm##__buf ); \
+                static stm_id stm = & stm##__stm
+
+/******************************************************************************
+ *
+ * Name              : static_STM_NOINIT
+ *
+ * Description       : define and initialize a static stream buffer object
+ *                     with data buffer placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   stm             : name of a pointer to stream buffer object
+ *   limit           : size of a buffer (max number of stored bytes / objects)
+ *   type            : (optional) size of the object (in bytes); default: 1
+ *
+ ******************************************************************************/
+
+#define  static_STM_NOINIT( stm, limit, ... )                                                 \
+       static __NOINIT char stm##__buf[_VA_STM(limit, __VA_ARGS__)];                           \
                 static stm_t stm##__stm = _STM_INIT( _VA_STM(limit, __VA_ARGS__), stm##__buf ); \
                 static stm_id stm = & stm##__stm
 
@@ -329,6 +372,78 @@ unsigned stm_waitUntil( stm_t *stm, void *data, unsigned size, cnt_t time );
 __STATIC_INLINE
 unsigned stm_wait( stm_t *stm, void *data, unsigned size ) { return stm_waitFor(stm, data, size, INFINITE); }
 
+/******************************************************************************
+ *
+ * Name              : stm_waitMin
+ *
+ * Description       : try to transfer at least 'min' and at most 'max' bytes from the stream buffer object,
+ *                     wait for given duration of time while the stream buffer object contains less than 'min' bytes
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   data            : pointer to write buffer
+ *   min             : minimum number of bytes to wake up the task (overrides the trigger level of the stream buffer)
+ *   max             : size of write buffer
+ *   delay           : duration of time (maximum number of ticks to wait for 'min' bytes)
+ *                     IMMEDIATE: don't wait if the stream buffer object contains less than 'min' bytes
+ *                     INFINITE:  wait indefinitely for 'min' bytes
+ *
+ * Return            : number of bytes read from the stream buffer
+ *                     when the timeout expired, the data available in the stream buffer are read (may be less than 'min')
+ *
+ * Note              : use only in thread mode
+ *                     the task is also woken up with less than 'min' bytes when a writer has no space in the stream buffer
+ *
+ ******************************************************************************/
+
+unsigned stm_waitMin( stm_t *stm, void *data, unsigned min, unsigned max, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : stm_waitMinUntil
+ *
+ * Description       : try to transfer at least 'min' and at most 'max' bytes from the stream buffer object,
+ *                     wait until given timepoint while the stream buffer object contains less than 'min' bytes
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   data            : pointer to write buffer
+ *   min             : minimum number of bytes to wake up the task (overrides the trigger level of the stream buffer)
+ *   max             : size of write buffer
+ *   time            : timepoint value
+ *
+ * Return            : number of bytes read from the stream buffer
+ *                     when the timeout expired, the data available in the stream buffer are read (may be less than 'min')
+ *
+ * Note              : use only in thread mode
+ *                     the task is also woken up with less than 'min' bytes when a writer has no space in the stream buffer
+ *
+ ******************************************************************************/
+
+unsigned stm_waitMinUntil( stm_t *stm, void *data, unsigned min, unsigned max, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : stm_setTrigger
+ *
+ * Description       : set trigger level of the stream buffer object,
+ *                     the reader blocked in 'stm_wait' is not woken up until the stream buffer object contains
+ *                     at least 'level' bytes (or the whole requested size, if smaller), the timeout expires
+ *                     or a writer has no space in the stream buffer
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   level           : trigger level in bytes, 0 or 1: the reader is woken up by any data
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     with the trigger level, 'stm_wait' reads the data available when the timeout expired
+ *
+ ******************************************************************************/
+
+void stm_setTrigger( stm_t *stm, unsigned level );
+
 /******************************************************************************
  *
  * Name              : stm_take
@@ -466,6 +581,213 @@ unsigned stm_push( stm_t *stm, const void *data, unsigned size );
 __STATIC_INLINE
 unsigned stm_pushISR( stm_t *stm, const void *data, unsigned size ) { return stm_push(stm, data, size); }
 
+/******************************************************************************
+ *
+ * Name              : stm_splice
+ * ISR alias         : stm_spliceISR
+ *
+ * Description       : try to move data from the source stream buffer object to the stream buffer object,
+ *                     the data is copied directly between the ring buffers in a single critical section
+ *                     (no intermediate buffer), waiting readers and writers of both objects are served,
+ *                     don't wait if the source stream buffer object is empty or the stream buffer object is full
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   src             : pointer to source stream buffer object
+ *   size            : maximum number of bytes to move
+ *
+ * Return            : number of bytes moved between the stream buffers
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned stm_splice( stm_t *stm, stm_t *src, unsigned size );
+
+__STATIC_INLINE
+unsigned stm_spliceISR( stm_t *stm, stm_t *src, unsigned size ) { return stm_splice(stm, src, size); }
+
+/******************************************************************************
+ *
+ * Name              : stm_spliceFor
+ *
+ * Description       : try to move data from the source stream buffer object to the stream buffer object,
+ *                     wait for given duration of time while the source stream buffer object is empty
+ *                     (or contains less data than its trigger level), as 'stm_splice'
+ *                     never wait for free space in the stream buffer object
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   src             : pointer to source stream buffer object
+ *   size            : maximum number of bytes to move
+ *   delay           : duration of time (maximum number of ticks to wait while the source stream buffer object is empty)
+ *                     IMMEDIATE: don't wait if the source stream buffer object is empty
+ *                     INFINITE:  wait indefinitely while the source stream buffer object is empty
+ *
+ * Return            : number of bytes moved between the stream buffers
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned stm_spliceFor( stm_t *stm, stm_t *src, unsigned size, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : stm_spliceUntil
+ *
+ * Description       : try to move data from the source stream buffer object to the stream buffer object,
+ *                     wait until given timepoint while the source stream buffer object is empty
+ *                     (or contains less data than its trigger level), as 'stm_splice'
+ *                     never wait for free space in the stream buffer object
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   src             : pointer to source stream buffer object
+ *   size            : maximum number of bytes to move
+ *   time            : timepoint value
+ *
+ * Return            : number of bytes moved between the stream buffers
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned stm_spliceUntil( stm_t *stm, stm_t *src, unsigned size, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : stm_setOverwrite
+ *
+ * Description       : set overwrite mode of the stream buffer object,
+ *                     in overwrite mode 'stm_give' and 'stm_send' never block nor fail for lack of space,
+ *                     they remove the oldest data (as 'stm_push') when the stream buffer object is full
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   enable          : true: overwrite mode, false: normal mode
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     should be set after initialization, before the stream buffer object is used
+ *
+ ******************************************************************************/
+
+void stm_setOverwrite( stm_t *stm, bool enable );
+
+/******************************************************************************
+ *
+ * Name              : stm_dropped
+ *
+ * Description       : return the number of bytes removed from the stream buffer object to make space for new ones
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *
+ * Return            : number of dropped bytes
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned stm_dropped( stm_t *stm );
+
+/******************************************************************************
+ *
+ * Name              : stm_reserve
+ * ISR alias         : stm_reserveISR
+ *
+ * Description       : get direct access to the contiguous free space of the stream buffer object
+ *                     data written there becomes available to readers after the call to stm_commit
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   data            : pointer to store the address of the free space
+ *   size            : maximum number of bytes to reserve
+ *
+ * Return            : number of bytes available for writing at the address stored in 'data'
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     stream buffer object must have the only producer while the space is reserved
+ *
+ ******************************************************************************/
+
+unsigned stm_reserve( stm_t *stm, void **data, unsigned size );
+
+__STATIC_INLINE
+unsigned stm_reserveISR( stm_t *stm, void **data, unsigned size ) { return stm_reserve(stm, data, size); }
+
+/******************************************************************************
+ *
+ * Name              : stm_commit
+ * ISR alias         : stm_commitISR
+ *
+ * Description       : make available 'size' bytes written into the space reserved by stm_reserve,
+ *                     resume execution of the tasks waiting for data
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   size            : number of bytes written, not greater than the reserved size
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void stm_commit( stm_t *stm, unsigned size );
+
+__STATIC_INLINE
+void stm_commitISR( stm_t *stm, unsigned size ) { stm_commit(stm, size); }
+
+/******************************************************************************
+ *
+ * Name              : stm_peek
+ * ISR alias         : stm_peekISR
+ *
+ * Description       : get direct access to the contiguous data stored in the stream buffer object
+ *                     data is released after the call to stm_consume
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   data            : pointer to store the address of the data
+ *
+ * Return            : number of bytes available for reading at the address stored in 'data'
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     stream buffer object must have the only consumer while the data is accessed
+ *
+ ******************************************************************************/
+
+unsigned stm_peek( stm_t *stm, const void **data );
+
+__STATIC_INLINE
+unsigned stm_peekISR( stm_t *stm, const void **data ) { return stm_peek(stm, data); }
+
+/******************************************************************************
+ *
+ * Name              : stm_consume
+ * ISR alias         : stm_consumeISR
+ *
+ * Description       : release 'size' bytes of the data accessed by stm_peek,
+ *                     resume execution of the tasks waiting for free space
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   size            : number of bytes read, not greater than the size returned by stm_peek
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+void stm_consume( stm_t *stm, unsigned size );
+
+__STATIC_INLINE
+void stm_consumeISR( stm_t *stm, unsigned size ) { stm_consume(stm, size); }
+
 /******************************************************************************
  *
  * Name              : stm_count
@@ -558,6 +880,9 @@ struct StreamBufferT : public __stm
 	unsigned waitFor  (       void *_data, unsigned _size, cnt_t _delay ) { return stm_waitFor  (this, _data, _size, _delay); }
 	unsigned waitUntil(       void *_data, unsigned _size, cnt_t _time )  { return stm_waitUntil(this, _data, _size, _time);  }
 	unsigned wait     (       void *_data, unsigned _size )               { return stm_wait     (this, _data, _size);         }
+	unsigned waitMin  (       void *_data, unsigned _min, unsigned _max, cnt_t _delay ) { return stm_waitMin     (this, _data, _min, _max, _delay); }
+	unsigned waitMinUntil(    void *_data, unsigned _min, unsigned _max, cnt_t _time )  { return stm_waitMinUntil(this, _data, _min, _max, _time);  }
+	void     setTrigger( unsigned _level )                                {        stm_setTrigger(this, _level);              }
 	unsigned take     (       void *_data, unsigned _size )               { return stm_take     (this, _data, _size);         }
 	unsigned takeISR  (       void *_data, unsigned _size )               { return stm_takeISR  (this, _data, _size);         }
 	unsigned sendFor  ( const void *_data, unsigned _size, cnt_t _delay ) { return stm_sendFor  (this, _data, _size, _delay); }
@@ -567,6 +892,20 @@ struct StreamBufferT : public __stm
 	unsigned giveISR  ( const void *_data, unsigned _size )               { return stm_giveISR  (this, _data, _size);         }
 	unsigned push     ( const void *_data, unsigned _size )               { return stm_push     (this, _data, _size);         }
 	unsigned pushISR  ( const void *_data, unsigned _size )               { return stm_pushISR  (this, _data, _size);         }
+	unsigned splice   ( stm_t *_src, unsigned _size )                     { return stm_splice   (this, _src, _size);          }
+	unsigned spliceISR( stm_t *_src, unsigned _size )                     { return stm_spliceISR(this, _src, _size);          }
+	unsigned spliceFor( stm_t *_src, unsigned _size, cnt_t _delay )       { return stm_spliceFor(this, _src, _size, _delay);  }
+	unsigned spliceUntil( stm_t *_src, unsigned _size, cnt_t _time )      { return stm_spliceUntil(this, _src, _size, _time); }
+	void     setOverwrite( bool _enable )                                 {        stm_setOverwrite(this, _enable);           }
+	unsigned dropped  ( void )                                            { return stm_dropped  (this);                       }
+	unsigned reserve  (       void **_data, unsigned _size )              { return stm_reserve  (this, _data, _size);         }
+	unsigned reserveISR(      void **_data, unsigned _size )              { return stm_reserveISR(this, _data, _size);        }
+	void     commit   ( unsigned _size )                                  {        stm_commit   (this, _size);                }
+	void     commitISR( unsigned _size )                                  {        stm_commitISR(this, _size);                }
+	unsigned peek     ( const void **_data )                              { return stm_peek     (this, _data);                }
+	unsigned peekISR  ( const void **_data )                              { return stm_peekISR  (this, _data);                }
+	void     consume  ( unsigned _size )                                  {        stm_consume  (this, _size);                }
+	void     consumeISR( unsigned _size )                                 {        stm_consumeISR(this, _size);               }
 	unsigned count    ( void )                                            { return stm_count    (this);                       }
 	unsigned countISR ( void )                                            { return stm_countISR (this);                       }
 	unsigned space    ( void )                                            { return stm_space    (this);                       }
@@ -34,12 +34,26 @@
 
 #include "oskernel.h"
 #include "osmutex.h"
+#include "osfastmutex.h"
 #include "ostimer.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* -------------------------------------------------------------------------- */
+
+#define ntfIncrement  ( 0U ) // increment notification value (counting semaphore)
+#define ntfOverwrite  ( 1U ) // overwrite notification value (mailbox)
+#define ntfSetBits    ( 2U ) // set bits of notification value (event flags)
+#define ntfAdd        ( 3U ) // add to notification value (counting semaphore released many times at once)
+
+#define LAT_BUCKETS   ( 16 ) // number of buckets of wake-to-run latency histogram (OS_TASK_LATENCY)
+#define REG_CHUNK     (  8 ) // number of tasks enumerated in one critical section (tsk_enumerate)
+
+#define RTC_LIVE      ( 1U ) // run-to-completion task: the state is being executed on the shared stack (OS_TASK_RTC)
+#define RTC_DONE      ( 2U ) // run-to-completion task: the state has completed, the context is created when the task is dispatched
+
 /******************************************************************************
  *
  * Name              : task (thread)
@@ -50,19 +64,38 @@ struct __tsk
 {
 	obj_t    obj;   // inherited from timer
 	tid_t    id;    // task's id: ID_STOPPED, ID_READY, ID_DELAYED, ID_IDLE
+#if OS_COMPACT_TCB
+	uint8_t  basic; // basic priority, packed with the task's id
+	uint8_t  prio;  // current priority, packed with the task's id
+	#define _TSK_PRIO_ID( _prio ) _prio, _prio,
+	#define _TSK_PRIO( _prio )
+#else
+	#define _TSK_PRIO_ID( _prio )
+	#define _TSK_PRIO( _prio ) _prio, _prio,
+#endif
 
 	fun_t  * state; // task state (initial task function, doesn't have to be noreturn-type)
+	act_t  * action;// task state with argument (tsk_startArg), executed instead of state if set
+	void   * arg;   // argument of the task state with argument
 	cnt_t    start; // inherited from timer
 	cnt_t    delay; // inherited from timer
+#if OS_COMPACT_TCB
+	uint16_t slice;	// time slice
+	uint16_t quant; // length of time slice, 0: (OS_FREQUENCY)/(OS_ROBIN)
+#else
 	cnt_t    slice;	// time slice
+	cnt_t    quant; // length of time slice, 0: (OS_FREQUENCY)/(OS_ROBIN)
+#endif
 
-	tsk_t  * back;  // previous process in the DELAYED queue
+	tsk_t  * back;  // previous process in the DELAYED queue (the first one: the last process)
 	void   * stack; // base of stack
 	stk_t  * top;   // top of stack
 	void   * sp;    // current stack pointer
 
+#if OS_COMPACT_TCB == 0
 	unsigned basic; // basic priority
 	unsigned prio;  // current priority
+#endif
 
 	tsk_t  * join;  // joinable state
 	void   * guard; // object that controls the pending process
@@ -74,6 +107,12 @@ struct __tsk
 	tsk_t  * tree;  // tree of tasks waiting for mutexes
 	}        mtx;
 
+	struct {
+	tsk_t  * queue; // the task itself, if waiting for notification
+	unsigned value; // notification value
+	unsigned state; // notification state: pending or not
+	}        ntf;
+
 	union  {
 
 	struct {
@@ -81,13 +120,17 @@ struct __tsk
 	unsigned mode;
 	}        flg;   // temporary data used by flag object
 
+	struct {
+	unsigned num;   // taker: number of units to take, sender: 0
+	}        sem;   // temporary data used by semaphore object
+
 	struct {
 	union  {
 	const
 	void  ** out;
 	void  ** in;
 	}        data;
-	}        lst;   // temporary data used by list / memory pool object
+	}        lst;   // temporary data used by list / memory pool / mail queue object
 
 	struct {
 	union  {
@@ -96,6 +139,7 @@ struct __tsk
 	char   * in;
 	}        data;
 	unsigned size;
+	unsigned min;   // reader: minimum number of bytes to wake up, writer: 0
 	}        stm;   // temporary data used by stream buffer object
 
 	struct {
@@ -103,8 +147,11 @@ struct __tsk
 	const
 	char   * out;
 	char   * in;
+	const
+	iov_t  * iov;
 	}        data;
 	unsigned size;
+	unsigned cnt;   // number of data fragments, 0: contiguous data
 	}        msg;   // temporary data used by message buffer object
 
 	struct {
@@ -115,23 +162,205 @@ struct __tsk
 	}        data;
 	}        box;   // temporary data used by mailbox queue object
 
+	struct {
+	union  {
+	const
+	void   * out;
+	void   * in;
+	}        data;
+	unsigned prio;
+	}        pbx;   // temporary data used by priority mailbox queue object
+
 	struct {
 	fun_t  * fun;
 	}        job;   // temporary data used by job queue object
 
+	struct {
+	fun_t  * fun;
+	unsigned prio;
+	}        pjq;   // temporary data used by priority job queue object
+
+	struct {
+	act_t  * fun;
+	void   * arg;
+	}        wpl;   // temporary data used by worker pool object
+
 	struct {
 	unsigned event;
 	}        evq;   // temporary data used by event queue object
 
+	struct {
+	void  ** data;
+	}        dbf;   // temporary data used by double buffer object
+
+	struct {
+	unsigned take;
+	}        ntf;   // temporary data used by task notification
+
+	struct {
+	mtx_t  * mtx;   // associated mutex, 0: waiting task was moved to the mutex queue
+	mut_t  * mut;   // associated fast mutex, 0: waiting task was moved to the fast mutex queue
+	}        cnd;   // temporary data used by condition variable object
+
+	struct {
+	const
+	volatile
+	uint32_t * addr;
+	}        adr;   // temporary data used by wait on address
+
 	}        tmp;
+
+	struct {
+	tsk_t  * prev;  // previous task in the registry of started tasks
+	tsk_t  * next;  // next task in the registry of started tasks
+	}        reg;
 #if defined(__ARMCC_VERSION) && !defined(__MICROLIB)
 	char     libspace[96];
-	#define _TSK_EXTRA { 0 }
+	#define _TSK_EXTRA , { 0 }
 #else
 	#define _TSK_EXTRA
 #endif
+#if OS_TASK_STATS
+	struct {
+	uint64_t time;  // number of cpu cycles consumed by the task
+	unsigned count; // number of context switches to the task
+	}        stat;
+	#define _TSK_STATS , { 0, 0 }
+#else
+	#define _TSK_STATS
+#endif
+#if OS_STACK_MONITOR
+	void   * mark;  // high-water mark of the task stack (lowest address known to be used)
+	#define _TSK_MARK  , 0
+#else
+	#define _TSK_MARK
+#endif
+#if OS_EDF_PRIO
+	cnt_t    deadline; // absolute deadline, used when the task priority is OS_EDF_PRIO
+	#define _TSK_EDF   , 0
+#else
+	#define _TSK_EDF
+#endif
+#if OS_TASK_THRESHOLD
+	unsigned thresh; // preemption threshold, only tasks of higher priority can preempt the task
+	#define _TSK_THR   , 0
+#else
+	#define _TSK_THR
+#endif
+#if OS_TASK_BUDGET
+	struct {
+	cnt_t    limit;  // execution budget within the replenishment period (in ticks), 0: no limit
+	cnt_t    period; // replenishment period (in ticks)
+	cnt_t    stamp;  // start of the current replenishment period
+	cnt_t    used;   // number of ticks consumed in the current replenishment period
+	}        bgt;
+	#define _TSK_BGT   , { 0, 0, 0, 0 }
+#else
+	#define _TSK_BGT
+#endif
+#if OS_TASK_AGING
+	struct {
+	unsigned ceil;   // maximum priority the task can be raised to while it is ready, 0: no aging
+	unsigned boost;  // number of priority levels the task has been raised by
+	cnt_t    wait;   // number of ticks the task has been ready and not running since the last raise
+	bool     run;    // the task has got the cpu since the last system tick
+	}        age;
+	#define _TSK_AGE   , { 0, 0, 0, false }
+#else
+	#define _TSK_AGE
+#endif
+#if OS_PERIOD_STATS
+	struct {
+	unsigned overruns; // number of periods overrun (the next release time had already passed in tsk_sleepNext / tmr_waitNext)
+	cnt_t    jitter;   // maximum release jitter (time from the release to the resumption of the task)
+	act_t  * hook;     // overrun callback procedure, 0: none
+	}        per;
+	#define _TSK_PER   , { 0, 0, 0 }
+#else
+	#define _TSK_PER
+#endif
+#if OS_TASK_LATENCY
+	struct {
+	bool     woken; // the task has been woken up and has not been switched to yet
+	uint32_t stamp; // time of the wakeup (in cpu cycles)
+	uint32_t hist[LAT_BUCKETS]; // bucket 'i' counts wake-to-run times of 2^i .. 2^(i+1)-1 cycles, the last one: all longer times
+	}        lat;
+	#define _TSK_LAT   , { false, 0, { 0 } }
+#else
+	#define _TSK_LAT
+#endif
+#if OS_TASK_PARTITION
+	unsigned part;  // partition of the task (tsk_setPartition), 0: unpartitioned task, scheduled in every window
+	#define _TSK_PRT   , 0
+#else
+	#define _TSK_PRT
+#endif
+#if OS_TASK_PERF
+	pfc_t    perf;  // hardware events counted while the task was running (perf_getTask)
+	#define _TSK_PFC   , { 0, 0, 0, 0, 0, 0 }
+#else
+	#define _TSK_PFC
+#endif
+#if OS_TASK_RTC
+	unsigned rtc;   // 0: ordinary task, RTC_LIVE / RTC_DONE: run-to-completion task sharing the stack (tsk_initRTC)
+	#define _TSK_RTC   , 0
+#else
+	#define _TSK_RTC
+#endif
+#if OS_TASK_ARENA
+	struct __arn *arn; // default arena of the task, 0: none
+	#define _TSK_ARN   , 0
+#else
+	#define _TSK_ARN
+#endif
+#if OS_HEAP_QUOTA
+	hqt_t  * hqt;   // heap quota the memory segments allocated by the task are charged to, 0: none
+	#define _TSK_HQT   , 0
+#else
+	#define _TSK_HQT
+#endif
+#if OS_RCU_SIZE
+	unsigned rcu;   // nesting level of read-copy-update read-side sections
+	#define _TSK_RCU   , 0
+#else
+	#define _TSK_RCU
+#endif
+#if OS_TASK_ENERGY
+	uint64_t energy; // estimated energy consumed by the task (pJ)
+	#define _TSK_NRG   , 0
+#else
+	#define _TSK_NRG
+#endif
+#if OS_TASK_REENT
+	struct _reent *reent; // newlib reentrancy structure of the task, 0: the global one
+	#define _TSK_RNT   , 0
+#else
+	#define _TSK_RNT
+#endif
+};
+
+/******************************************************************************
+ *
+ * Name              : task statistics
+ *
+ ******************************************************************************/
+
+#if OS_TASK_STATS
+
+typedef struct __sts sts_t;
+
+struct __sts
+{
+	tsk_t  * tsk;   // pointer to task object
+	uint64_t time;  // number of cpu cycles consumed by the task
+	unsigned count; // number of context switches to the task
+#if OS_TASK_ENERGY
+	uint64_t energy; // estimated energy consumed by the task (pJ)
+#endif
 };
 
+#endif
+
 /******************************************************************************
  *
  * Name              : _TSK_INIT
@@ -152,7 +381,7 @@ struct __tsk
  ******************************************************************************/
 
 #define               _TSK_INIT( _prio, _state, _stack, _size ) \
-                       { _OBJ_INIT(), ID_STOPPED, _state, 0, 0, 0, 0, _stack, _stack+SSIZE(_size), 0, _prio, _prio, 0, 0, 0, { 0, 0 }, { { 0, 0 } }, _TSK_EXTRA }
+                       { _OBJ_INIT(), ID_STOPPED, _TSK_PRIO_ID(_prio) _state, 0, 0, 0, 0, 0, 0, 0, _stack, _stack+SSIZE(_size), 0, _TSK_PRIO(_prio) 0, 0, 0, { 0, 0 }, { 0, 0, 0 }, { { 0, 0 } }, { 0, 0 } _TSK_EXTRA _TSK_STATS _TSK_MARK _TSK_EDF _TSK_THR _TSK_BGT _TSK_AGE _TSK_PER _TSK_LAT _TSK_PRT _TSK_PFC _TSK_RTC _TSK_ARN _TSK_HQT _TSK_RCU _TSK_NRG _TSK_RNT }
 
 /******************************************************************************
  *
@@ -227,7 +456,30 @@ struct __tsk
  ******************************************************************************/
 
 #define             OS_WRK( tsk, prio, state, size )                                \
-                       stk_t tsk##__stk[SSIZE( size )];                              \
+           __OS_NOINIT stk_t tsk##__stk[SSIZE( size )];                              \
+                       tsk_t tsk##__tsk = _TSK_INIT( prio, state, tsk##__stk, size ); \
+                       tsk_id tsk = & tsk##__tsk
+
+/******************************************************************************
+ *
+ * Name              : OS_WRK_NOINIT
+ *
+ * Description       : define and initialize complete work area for task object
+ *                     with task stack placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   tsk             : name of a pointer to task object
+ *   prio            : initial task priority (any unsigned int value)
+ *   state           : task state (initial task function) doesn't have to be noreturn-type
+ *                     it will be executed into an infinite system-implemented loop
+ *   size            : size of task private stack (in bytes)
+ *
+ * Note              : use only at file scope
+ *
+ ******************************************************************************/
+
+#define      OS_WRK_NOINIT( tsk, prio, state, size )                                \
+              __NOINIT stk_t tsk##__stk[SSIZE( size )];                              \
                        tsk_t tsk##__tsk = _TSK_INIT( prio, state, tsk##__stk, size ); \
                        tsk_id tsk = & tsk##__tsk
 
@@ -249,6 +501,27 @@ struct __tsk
 #define             OS_TSK( tsk, prio, state, ... ) \
                     OS_WRK( tsk, prio, state, _VA_STK(__VA_ARGS__) )
 
+/******************************************************************************
+ *
+ * Name              : OS_TSK_NOINIT
+ *
+ * Description       : define and initialize complete work area for task object with default stack size
+ *                     with task stack placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   tsk             : name of a pointer to task object
+ *   prio            : initial task priority (any unsigned int value)
+ *   state           : task state (initial task function) doesn't have to be noreturn-type
+ *                     it will be executed into an infinite system-implemented loop
+ *   size            : (optional) size of task private stack (in bytes); default: OS_STACK_SIZE
+ *
+ * Note              : use only at file scope
+ *
+ ******************************************************************************/
+
+#define      OS_TSK_NOINIT( tsk, prio, state, ... ) \
+                    OS_WRK_NOINIT( tsk, prio, state, _VA_STK(__VA_ARGS__) )
+
 /******************************************************************************
  *
  * Name              : OS_WRK_DEF
@@ -342,7 +615,28 @@ struct __tsk
  ******************************************************************************/
 
 #define         static_WRK( tsk, prio, state, size )                                \
-                static stk_t tsk##__stk[SSIZE( size )];                              \
+    static __OS_NOINIT stk_t tsk##__stk[SSIZE( size )];                              \
+                static tsk_t tsk##__tsk = _TSK_INIT( prio, state, tsk##__stk, size ); \
+                static tsk_id tsk = & tsk##__tsk
+
+/******************************************************************************
+ *
+ * Name              : static_WRK_NOINIT
+ *
+ * Description       : define and initialize static work area for task object
+ *                     with task stack placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   tsk             : name of a pointer to task object
+ *   prio            : initial task priority (any unsigned int value)
+ *   state           : task state (initial task function) doesn't have to be noreturn-type
+ *                     it will be executed into an infinite system-implemented loop
+ *   size            : size of task private stack (in bytes)
+ *
+ ******************************************************************************/
+
+#define  static_WRK_NOINIT( tsk, prio, state, size )                                \
+       static __NOINIT stk_t tsk##__stk[SSIZE( size )];                              \
                 static tsk_t tsk##__tsk = _TSK_INIT( prio, state, tsk##__stk, size ); \
                 static tsk_id tsk = & tsk##__tsk
 
@@ -364,6 +658,25 @@ struct __tsk
 #define         static_TSK( tsk, prio, state, ... ) \
                 static_WRK( tsk, prio, state, _VA_STK(__VA_ARGS__) )
 
+/******************************************************************************
+ *
+ * Name              : static_TSK_NOINIT
+ *
+ * Description       : define and initialize static work area for task object with default stack size
+ *                     with task stack placed in the '.noinit' section (not zeroed at startup)
+ *
+ * Parameters
+ *   tsk             : name of a pointer to task object
+ *   prio            : initial task priority (any unsigned int value)
+ *   state           : task state (initial task function) doesn't have to be noreturn-type
+ *                     it will be executed into an infinite system-implemented loop
+ *   size            : (optional) size of task private stack (in bytes); default: OS_STACK_SIZE
+ *
+ ******************************************************************************/
+
+#define  static_TSK_NOINIT( tsk, prio, state, ... ) \
+                static_WRK_NOINIT( tsk, prio, state, _VA_STK(__VA_ARGS__) )
+
 /******************************************************************************
  *
  * Name              : static_WRK_DEF
@@ -595,6 +908,7 @@ void tsk_init( tsk_t *tsk, unsigned prio, fun_t *state, void *stack, unsigned si
  *   0               : task not created (not enough free memory)
  *
  * Note              : use only in thread mode
+ *                     with OS_TASK_CACHE a released work area with the stack of the same size is reused
  *
  ******************************************************************************/
 
@@ -603,6 +917,65 @@ tsk_t *wrk_create( unsigned prio, fun_t *state, unsigned size );
 __STATIC_INLINE
 tsk_t *wrk_new( unsigned prio, fun_t *state, unsigned size ) { return wrk_create(prio, state, size); }
 
+#if OS_TASK_RTC
+
+/******************************************************************************
+ *
+ * Name              : tsk_initRTC
+ *
+ * Description       : initialize complete work area for run-to-completion task object and start the task
+ *                     the state is executed when the task is started and then again as long as the task notification
+ *                     is pending (tsk_notify); there is no saved context between the executions, so the stack can be
+ *                     shared by all run-to-completion tasks of the same priority
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   prio            : task priority (any unsigned int value except OS_EDF_PRIO)
+ *   state           : task state (task function) executed to completion
+ *   stack           : base of the stack storage shared by the run-to-completion tasks of this priority
+ *   size            : size of the shared stack (in bytes)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     the state must not block (only IMMEDIATE waits are allowed) nor change the task priority,
+ *                     tasks of the same priority execute their states one after another without time slicing;
+ *                     the state clears the notification with tsk_notifyWaitFor(&value, IMMEDIATE)
+ *                     or tsk_notifyTakeFor(IMMEDIATE) (then it is executed once per ntfIncrement)
+ *
+ ******************************************************************************/
+
+void tsk_initRTC( tsk_t *tsk, unsigned prio, fun_t *state, void *stack, unsigned size );
+
+/******************************************************************************
+ *
+ * Name              : tsk_createRTC
+ * Alias             : tsk_newRTC
+ *
+ * Description       : create and initialize run-to-completion task object and start the task
+ *                     the stack shared by the run-to-completion tasks of the priority is allocated
+ *                     by the first task created with this priority
+ *
+ * Parameters
+ *   prio            : task priority (any unsigned int value except OS_EDF_PRIO)
+ *   state           : task state (task function) executed to completion
+ *   size            : size of the shared stack (in bytes), must not exceed the size of the stack already allocated
+ *
+ * Return            : pointer to task object (task successfully created)
+ *   0               : task not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *                     restrictions of tsk_initRTC apply
+ *
+ ******************************************************************************/
+
+tsk_t *tsk_createRTC( unsigned prio, fun_t *state, unsigned size );
+
+__STATIC_INLINE
+tsk_t *tsk_newRTC( unsigned prio, fun_t *state, unsigned size ) { return tsk_createRTC(prio, state, size); }
+
+#endif//OS_TASK_RTC
+
 /******************************************************************************
  *
  * Name              : tsk_create
@@ -664,6 +1037,27 @@ void tsk_start( tsk_t *tsk );
 
 void tsk_startFrom( tsk_t *tsk, fun_t *state );
 
+/******************************************************************************
+ *
+ * Name              : tsk_startArg
+ *
+ * Description       : start previously defined/created/stopped task object with the task state with argument
+ *                     the task state receives the argument directly, so it doesn't have to use tsk_this
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   action          : task state with argument, doesn't have to be noreturn-type
+ *                     it will be executed into an infinite system-implemented loop
+ *   arg             : argument of the task state
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void tsk_startArg( tsk_t *tsk, act_t *action, void *arg );
+
 /******************************************************************************
  *
  * Name              : tsk_stop
@@ -712,6 +1106,7 @@ void tsk_kill( tsk_t *tsk );
  * Return            : none
  *
  * Note              : use only in thread mode
+ *                     with OS_TASK_CACHE the work area created by wrk_create is kept for reuse, as long as the cache is not full
  *
  ******************************************************************************/
 
@@ -817,84 +1212,297 @@ void tsk_setPrio( unsigned prio ) { tsk_prio(prio); }
 
 /******************************************************************************
  *
- * Name              : tsk_getPrio
+ * Name              : tsk_setSlice
  *
- * Description       : get current task priority
+ * Description       : set length of round-robin time slice of given task
  *
- * Parameters        : none
+ * Parameters
+ *   tsk             : pointer to task object
+ *   slice           : length of time slice (number of ticks)
+ *                     0: default length (OS_FREQUENCY)/(OS_ROBIN)
  *
- * Return            : current task priority value
+ * Return            : none
  *
  * Note              : use only in thread mode
+ *                     has effect in preemptive mode (OS_ROBIN)
+ *                     in tick-less mode the system timer for context switch is restarted with the slice of the incoming task
  *
  ******************************************************************************/
 
-__STATIC_INLINE
-unsigned tsk_getPrio( void ) { return System.cur->basic; }
+void tsk_setSlice( tsk_t *tsk, cnt_t slice );
 
 /******************************************************************************
  *
- * Name              : tsk_waitFor
+ * Name              : tsk_setDeadline
  *
- * Description       : delay execution of current task for given duration of time and wait for flags or message
+ * Description       : set absolute deadline of current task
  *
  * Parameters
- *   flags           : all flags to wait
- *                     0: wait for any flag or message
- *   delay           : duration of time (maximum number of ticks to delay execution of current task)
- *                     IMMEDIATE: don't delay execution of current task
- *                     INFINITE:  delay indefinitely execution of current task
+ *   time            : timepoint value
  *
- * Return
- *   E_TIMEOUT       : task object was not released before the specified timeout expired
- *   'another'       : task object resumed by the direct transfer of 'another' flags or message (tsk_give)
+ * Return            : none
  *
- * Note              : use only in thread mode
+ * Note              : use only in thread mode, available when OS_EDF_PRIO is set
+ *                     ready tasks with priority OS_EDF_PRIO are ordered by their deadlines
+ *                     'tsk_sleepNext' / 'tmr_waitNext' set the deadline to the end of the next period
  *
  ******************************************************************************/
 
-unsigned tsk_waitFor( unsigned flags, cnt_t delay );
+#if OS_EDF_PRIO
+
+void tsk_setDeadline( cnt_t time );
+
+#endif
 
 /******************************************************************************
  *
- * Name              : tsk_waitUntil
+ * Name              : tsk_getDeadline
  *
- * Description       : delay execution of current task until given timepoint and wait for flags or message
+ * Description       : get absolute deadline of current task
  *
- * Parameters
- *   flags           : all flags to wait
- *                     0: wait for any flags or message
- *   time            : timepoint value
+ * Parameters        : none
  *
- * Return
- *   E_TIMEOUT       : task object was not released before the specified timeout expired
- *   'another'       : task object resumed by the direct transfer of 'another' flags or message (tsk_give)
+ * Return            : current task deadline
  *
- * Note              : use only in thread mode
+ * Note              : use only in thread mode, available when OS_EDF_PRIO is set
  *
  ******************************************************************************/
 
-unsigned tsk_waitUntil( unsigned flags, cnt_t time );
+#if OS_EDF_PRIO
+
+__STATIC_INLINE
+cnt_t tsk_getDeadline( void ) { return System.cur->deadline; }
+
+#endif
 
 /******************************************************************************
  *
- * Name              : tsk_wait
+ * Name              : tsk_setThreshold
  *
- * Description       : delay indefinitely execution of current task and wait for flags or message
+ * Description       : set preemption threshold of current task
+ *                     while the task is running, only tasks with priority above the threshold can preempt it;
+ *                     ready tasks of priority up to the threshold are switched to when the task waits, yields
+ *                     or its round-robin time slice expires
  *
  * Parameters
- *   flags           : all flags to wait
- *                     0: wait for any flag or message
+ *   thresh          : new preemption threshold, not above the task priority: no threshold
  *
- * Return
- *   'another'       : task object resumed by the direct transfer of 'another' flags or message (tsk_give)
+ * Return            : none
  *
- * Note              : use only in thread mode
+ * Note              : use only in thread mode, available when OS_TASK_THRESHOLD is set
  *
  ******************************************************************************/
 
-__STATIC_INLINE
-unsigned tsk_wait( unsigned flags ) { return tsk_waitFor(flags, INFINITE); }
+#if OS_TASK_THRESHOLD
+
+void tsk_setThreshold( unsigned thresh );
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_getThreshold
+ *
+ * Description       : get preemption threshold of current task
+ *
+ * Parameters        : none
+ *
+ * Return            : current task preemption threshold
+ *
+ * Note              : use only in thread mode, available when OS_TASK_THRESHOLD is set
+ *
+ ******************************************************************************/
+
+#if OS_TASK_THRESHOLD
+
+__STATIC_INLINE
+unsigned tsk_getThreshold( void ) { return System.cur->thresh; }
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_setBudget
+ *
+ * Description       : set execution budget of given task
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   limit           : maximum number of ticks the task can run within every replenishment period
+ *                     0: no limit
+ *   period          : replenishment period (number of ticks)
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, available when OS_TASK_BUDGET is set
+ *                     the task running at the system tick is charged for it;
+ *                     a task that exhausts its budget is demoted to the lowest priority (0)
+ *                     and gets its priority back when the next replenishment period begins
+ *
+ ******************************************************************************/
+
+#if OS_TASK_BUDGET
+
+void tsk_setBudget( tsk_t *tsk, cnt_t limit, cnt_t period );
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_setAging
+ *
+ * Description       : set priority aging ceiling of given task
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   ceil            : maximum priority the task can be raised to while it is ready to run and not running
+ *                     0: no aging
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, available when OS_TASK_AGING is set
+ *                     the priority of the ready task is raised by one level every OS_TASK_AGING ticks
+ *                     until it reaches the ceiling or the task is switched to;
+ *                     the raised priority is kept until the next system tick or until the task is switched out,
+ *                     so the task waits at most (ceil - basic priority) * OS_TASK_AGING ticks behind the tasks
+ *                     of priority lower than the ceiling
+ *
+ ******************************************************************************/
+
+#if OS_TASK_AGING
+
+void tsk_setAging( tsk_t *tsk, unsigned ceil );
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_reent
+ *
+ * Description       : give the current task its own newlib reentrancy structure
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to the reentrancy structure of the current task
+ *                     (the global one if the structure could not be allocated)
+ *
+ * Note              : use only in thread mode, available when OS_TASK_REENT is set
+ *                     the structure is allocated on the system heap at the first call,
+ *                     call it before the first use of errno, stdio or other stateful functions of the library
+ *
+ ******************************************************************************/
+
+#if OS_TASK_REENT
+
+struct _reent *tsk_reent( void );
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_setPartition
+ *
+ * Description       : assign given task to the partition of the time-partitioned scheduler
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   part            : partition of the task
+ *                     0: unpartitioned task, scheduled in every window of the major frame
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, available when OS_TASK_PARTITION is set
+ *                     while partition scheduling is running (prt_start), a ready task of a partition
+ *                     outside the current window is not scheduled until the window of its partition
+ *
+ ******************************************************************************/
+
+#if OS_TASK_PARTITION
+
+void tsk_setPartition( tsk_t *tsk, unsigned part );
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_getPrio
+ *
+ * Description       : get current task priority
+ *
+ * Parameters        : none
+ *
+ * Return            : current task priority value
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned tsk_getPrio( void ) { return System.cur->basic; }
+
+/******************************************************************************
+ *
+ * Name              : tsk_waitFor
+ *
+ * Description       : delay execution of current task for given duration of time and wait for flags or message
+ *
+ * Parameters
+ *   flags           : all flags to wait
+ *                     0: wait for any flag or message
+ *   delay           : duration of time (maximum number of ticks to delay execution of current task)
+ *                     IMMEDIATE: don't delay execution of current task
+ *                     INFINITE:  delay indefinitely execution of current task
+ *
+ * Return
+ *   E_TIMEOUT       : task object was not released before the specified timeout expired
+ *   'another'       : task object resumed by the direct transfer of 'another' flags or message (tsk_give)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned tsk_waitFor( unsigned flags, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : tsk_waitUntil
+ *
+ * Description       : delay execution of current task until given timepoint and wait for flags or message
+ *
+ * Parameters
+ *   flags           : all flags to wait
+ *                     0: wait for any flags or message
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_TIMEOUT       : task object was not released before the specified timeout expired
+ *   'another'       : task object resumed by the direct transfer of 'another' flags or message (tsk_give)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned tsk_waitUntil( unsigned flags, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : tsk_wait
+ *
+ * Description       : delay indefinitely execution of current task and wait for flags or message
+ *
+ * Parameters
+ *   flags           : all flags to wait
+ *                     0: wait for any flag or message
+ *
+ * Return
+ *   'another'       : task object resumed by the direct transfer of 'another' flags or message (tsk_give)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned tsk_wait( unsigned flags ) { return tsk_waitFor(flags, INFINITE); }
 
 /******************************************************************************
  *
@@ -918,6 +1526,160 @@ void tsk_give( tsk_t *tsk, unsigned flags );
 __STATIC_INLINE
 void tsk_giveISR( tsk_t *tsk, unsigned flags ) { tsk_give(tsk, flags); }
 
+/******************************************************************************
+ *
+ * Name              : tsk_notify
+ * ISR alias         : tsk_notifyISR
+ *
+ * Description       : update notification value of the task and mark the notification as pending,
+ *                     resume the task if it is waiting for the notification (tsk_notifyTake, tsk_notifyWait)
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   action          : ntfIncrement: increment notification value, 'value' is ignored
+ *                     ntfOverwrite: overwrite notification value with 'value'
+ *                     ntfSetBits:   set 'value' bits in notification value
+ *                     ntfAdd:       add 'value' to notification value
+ *   value           : value used by the action
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     lightweight replacement of binary / counting semaphore, mailbox or event flags
+ *                     with a single receiver; it doesn't need any separate object
+ *
+ ******************************************************************************/
+
+void tsk_notify( tsk_t *tsk, unsigned action, unsigned value );
+
+__STATIC_INLINE
+void tsk_notifyISR( tsk_t *tsk, unsigned action, unsigned value ) { tsk_notify(tsk, action, value); }
+
+/******************************************************************************
+ *
+ * Name              : tsk_notifyTakeFor
+ *
+ * Description       : wait for non-zero notification value of current task for given duration of time
+ *                     and decrement it (counting semaphore semantics)
+ *
+ * Parameters
+ *   delay           : duration of time (maximum number of ticks to wait for notification)
+ *                     IMMEDIATE: don't wait if notification value is zero
+ *                     INFINITE:  wait indefinitely until notification value is non-zero
+ *
+ * Return
+ *   E_SUCCESS       : notification value was successfully decremented
+ *   E_TIMEOUT       : notification value was zero until the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned tsk_notifyTakeFor( cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : tsk_notifyTakeUntil
+ *
+ * Description       : wait for non-zero notification value of current task until given timepoint
+ *                     and decrement it (counting semaphore semantics)
+ *
+ * Parameters
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : notification value was successfully decremented
+ *   E_TIMEOUT       : notification value was zero until the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned tsk_notifyTakeUntil( cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : tsk_notifyTake
+ *
+ * Description       : wait indefinitely for non-zero notification value of current task
+ *                     and decrement it (counting semaphore semantics)
+ *
+ * Parameters        : none
+ *
+ * Return
+ *   E_SUCCESS       : notification value was successfully decremented
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned tsk_notifyTake( void ) { return tsk_notifyTakeFor(INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : tsk_notifyWaitFor
+ *
+ * Description       : wait for pending notification of current task for given duration of time,
+ *                     then get and clear notification value (mailbox / event flags semantics)
+ *
+ * Parameters
+ *   value           : pointer to store notification value (may be null)
+ *   delay           : duration of time (maximum number of ticks to wait for notification)
+ *                     IMMEDIATE: don't wait if notification is not pending
+ *                     INFINITE:  wait indefinitely until notification is pending
+ *
+ * Return
+ *   E_SUCCESS       : notification value was successfully received
+ *   E_TIMEOUT       : notification was not pending until the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned tsk_notifyWaitFor( unsigned *value, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : tsk_notifyWaitUntil
+ *
+ * Description       : wait for pending notification of current task until given timepoint,
+ *                     then get and clear notification value (mailbox / event flags semantics)
+ *
+ * Parameters
+ *   value           : pointer to store notification value (may be null)
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : notification value was successfully received
+ *   E_TIMEOUT       : notification was not pending until the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned tsk_notifyWaitUntil( unsigned *value, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : tsk_notifyWait
+ *
+ * Description       : wait indefinitely for pending notification of current task,
+ *                     then get and clear notification value (mailbox / event flags semantics)
+ *
+ * Parameters
+ *   value           : pointer to store notification value (may be null)
+ *
+ * Return
+ *   E_SUCCESS       : notification value was successfully received
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned tsk_notifyWait( unsigned *value ) { return tsk_notifyWaitFor(value, INFINITE); }
+
 /******************************************************************************
  *
  * Name              : tsk_sleepFor
@@ -944,6 +1706,32 @@ unsigned tsk_sleepFor( cnt_t delay ) { return tmr_waitFor(&WAIT, delay); }
 __STATIC_INLINE
 unsigned tsk_delay( cnt_t delay ) { return tsk_sleepFor(delay); }
 
+/******************************************************************************
+ *
+ * Name              : tsk_sleepForHR
+ *
+ * Description       : delay execution of current task for given duration of time in microseconds
+ *                     whole system ticks are slept, the final sub-tick remainder is busy-waited
+ *                     on the high-resolution system time (sys_timeHR)
+ *
+ * Parameters
+ *   delay           : duration of time in microseconds
+ *
+ * Return
+ *   E_TIMEOUT       : task object successfully finished countdown
+ *   E_STOPPED       : task object was resumed (tsk_resume)
+ *
+ * Note              : use only in thread mode
+ *                     available when 1000000 is a multiple of OS_FREQUENCY
+ *
+ ******************************************************************************/
+
+#if 1000000 % (OS_FREQUENCY) == 0
+
+unsigned tsk_sleepForHR( uint32_t delay );
+
+#endif
+
 /******************************************************************************
  *
  * Name              : tsk_sleepNext
@@ -1049,6 +1837,182 @@ unsigned tsk_resume( tsk_t *tsk );
 __STATIC_INLINE
 unsigned tsk_resumeISR( tsk_t *tsk ) { return tsk_resume(tsk); }
 
+/******************************************************************************
+ *
+ * Name              : tsk_count
+ * ISR alias         : tsk_countISR
+ *
+ * Description       : return the number of started tasks (including the idle task)
+ *
+ * Parameters        : none
+ *
+ * Return            : number of started tasks
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned tsk_count( void ) { return System.tasks; }
+
+__STATIC_INLINE
+unsigned tsk_countISR( void ) { return tsk_count(); }
+
+/******************************************************************************
+ *
+ * Name              : tsk_enumerate
+ *
+ * Description       : store pointers to all started tasks in the array
+ *                     the first entry always describes the idle task
+ *
+ * Parameters
+ *   list            : pointer to the array of task pointers
+ *   count           : number of entries in the array of task pointers
+ *
+ * Return            : number of stored entries
+ *
+ * Note              : use only in thread mode
+ *                     the registry of started tasks is scanned in chunks of REG_CHUNK tasks,
+ *                     interrupts are enabled between the chunks;
+ *                     the scan is restarted if a task was stopped in the meantime
+ *
+ ******************************************************************************/
+
+unsigned tsk_enumerate( tsk_t **list, unsigned count );
+
+/******************************************************************************
+ *
+ * Name              : tsk_getStats
+ *
+ * Description       : take a snapshot of cpu usage of all tasks (except stopped ones)
+ *                     the first entry always describes the idle task
+ *
+ * Parameters
+ *   stats           : pointer to the array of task statistics
+ *   count           : number of entries in the array of task statistics
+ *
+ * Return            : number of stored entries
+ *
+ * Note              : use only in thread mode, available when OS_TASK_STATS is set
+ *                     the time is expressed in cpu cycles,
+ *                     the energy (OS_TASK_ENERGY) is expressed in picojoules
+ *
+ ******************************************************************************/
+
+#if OS_TASK_STATS
+unsigned tsk_getStats( sts_t *stats, unsigned count );
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_stackUsed
+ *
+ * Description       : return the maximum number of bytes of the task stack used so far (high-water mark)
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *
+ * Return            : number of bytes of the task stack used since the task was started,
+ *                     0 for the main and idle task
+ *
+ * Note              : use only in thread mode, available when OS_STACK_MONITOR is set
+ *                     stack is painted when the task is started and the unused part is examined
+ *                     incrementally by the idle task; this function finishes the examination
+ *
+ ******************************************************************************/
+
+#if OS_STACK_MONITOR
+unsigned tsk_stackUsed( tsk_t *tsk );
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_getLatency
+ *
+ * Description       : take a snapshot of wake-to-run latency histogram of given task:
+ *                     the time from the wakeup of the task (the task becomes ready) to the context switch to it
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   hist            : pointer to the array of LAT_BUCKETS entries,
+ *                     entry 'i' receives the number of wakeups with latency of 2^i .. 2^(i+1)-1 cpu cycles
+ *   clear           : clear the histogram of the task after the snapshot
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, available when OS_TASK_LATENCY is set
+ *
+ ******************************************************************************/
+
+#if OS_TASK_LATENCY
+void tsk_getLatency( tsk_t *tsk, uint32_t *hist, bool clear );
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_setOverrunHook
+ *
+ * Description       : set callback procedure executed when given periodic task overruns its period
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   hook            : overrun callback procedure, executed with pointer to the task object as argument
+ *                     0: no callback
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, available when OS_PERIOD_STATS is set
+ *                     the callback is executed by the overrunning task from 'tsk_sleepNext' / 'tmr_waitNext'
+ *                     inside the critical section, so it must not call blocking functions
+ *
+ ******************************************************************************/
+
+#if OS_PERIOD_STATS
+void tsk_setOverrunHook( tsk_t *tsk, act_t *hook );
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_getOverruns
+ *
+ * Description       : return the number of periods overrun by given periodic task
+ *                     (the next release time had already passed when 'tsk_sleepNext' / 'tmr_waitNext' was called)
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *
+ * Return            : number of overruns
+ *
+ * Note              : may be used both in thread and handler mode, available when OS_PERIOD_STATS is set
+ *
+ ******************************************************************************/
+
+#if OS_PERIOD_STATS
+__STATIC_INLINE
+unsigned tsk_getOverruns( tsk_t *tsk ) { return tsk->per.overruns; }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : tsk_getJitter
+ *
+ * Description       : return the maximum release jitter of given periodic task: the time from the end of the countdown
+ *                     of 'tsk_sleepNext' / 'tmr_waitNext' to the resumption of the task
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *
+ * Return            : maximum release jitter (in ticks)
+ *
+ * Note              : may be used both in thread and handler mode, available when OS_PERIOD_STATS is set
+ *
+ ******************************************************************************/
+
+#if OS_PERIOD_STATS
+__STATIC_INLINE
+cnt_t tsk_getJitter( tsk_t *tsk ) { return tsk->per.jitter; }
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -1082,11 +2046,30 @@ struct staticTaskT : public __tsk
 	unsigned join     ( void )            { return tsk_join      (this);         }
 	void     start    ( void )            {        tsk_start     (this);         }
 	void     startFrom( fun_t  * _state ) {        tsk_startFrom (this, _state); }
+	void     startArg ( act_t  * _action, void *_arg ) { tsk_startArg(this, _action, _arg); }
 	void     give     ( unsigned _flags ) {        tsk_give      (this, _flags); }
 	void     giveISR  ( unsigned _flags ) {        tsk_giveISR   (this, _flags); }
+	void     notify   ( unsigned _action, unsigned _value ) { tsk_notify   (this, _action, _value); }
+	void     notifyISR( unsigned _action, unsigned _value ) { tsk_notifyISR(this, _action, _value); }
 	unsigned suspend  ( void )            { return tsk_suspend   (this);         }
 	unsigned resume   ( void )            { return tsk_resume    (this);         }
 	unsigned resumeISR( void )            { return tsk_resumeISR (this);         }
+#if OS_STACK_MONITOR
+	unsigned stackUsed( void )            { return tsk_stackUsed (this);         }
+#endif
+#if OS_TASK_LATENCY
+	void     getLatency( uint32_t *_hist, bool _clear = false ) { tsk_getLatency(this, _hist, _clear); }
+#endif
+#if OS_PERIOD_STATS
+	void     setOverrunHook( act_t *_hook ) {  tsk_setOverrunHook(this, _hook); }
+	unsigned getOverruns   ( void )         { return tsk_getOverruns(this);      }
+	cnt_t    getJitter     ( void )         { return tsk_getJitter  (this);      }
+#endif
+
+	void     setSlice ( cnt_t    _slice ) {        tsk_setSlice  (this, _slice); }
+#if OS_TASK_BUDGET
+	void     setBudget( cnt_t    _limit, cnt_t _period ) { tsk_setBudget(this, _limit, _period); }
+#endif
 
 	unsigned prio     ( void )            { return __tsk::basic;                 }
 	unsigned getPrio  ( void )            { return __tsk::basic;                 }
@@ -1181,6 +2164,10 @@ namespace ThisTask
 	static inline void     setPrio   ( unsigned _prio )                {        tsk_setPrio   (_prio);                 }
 	static inline unsigned getPrio   ( void )                          { return tsk_getPrio   ();                      }
 	static inline unsigned prio      ( void )                          { return tsk_getPrio   ();                      }
+#if OS_EDF_PRIO
+	static inline void     setDeadline( cnt_t   _time )                {        tsk_setDeadline(_time);                }
+	static inline cnt_t    getDeadline( void )                         { return tsk_getDeadline();                     }
+#endif
 
 	static inline void     kill      ( void )                          {        tsk_kill      (System.cur);            }
 	static inline unsigned detach    ( void )                          { return tsk_detach    (System.cur);            }
@@ -1189,6 +2176,12 @@ namespace ThisTask
 	static inline unsigned waitFor   ( unsigned _flags, cnt_t _delay ) { return tsk_waitFor   (_flags, _delay);        }
 	static inline unsigned waitUntil ( unsigned _flags, cnt_t _time )  { return tsk_waitUntil (_flags, _time);         }
 	static inline unsigned wait      ( unsigned _flags )               { return tsk_wait      (_flags);                }
+	static inline unsigned notifyTakeFor  ( cnt_t _delay )                    { return tsk_notifyTakeFor  (_delay);         }
+	static inline unsigned notifyTakeUntil( cnt_t _time )                     { return tsk_notifyTakeUntil(_time);          }
+	static inline unsigned notifyTake     ( void )                            { return tsk_notifyTake     ();               }
+	static inline unsigned notifyWaitFor  ( unsigned *_value, cnt_t _delay )  { return tsk_notifyWaitFor  (_value, _delay); }
+	static inline unsigned notifyWaitUntil( unsigned *_value, cnt_t _time )   { return tsk_notifyWaitUntil(_value, _time);  }
+	static inline unsigned notifyWait     ( unsigned *_value )                { return tsk_notifyWait     (_value);         }
 	static inline unsigned sleepFor  ( cnt_t    _delay )               { return tsk_sleepFor  (_delay);                }
 	static inline unsigned sleepNext ( cnt_t    _delay )               { return tsk_sleepNext (_delay);                }
 	static inline unsigned sleepUntil( cnt_t    _time )                { return tsk_sleepUntil(_time);                 }
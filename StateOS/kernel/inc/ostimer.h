@@ -50,9 +50,12 @@ struct __tmr
 	tid_t    id;    // timer's id: ID_STOPPED, ID_DELAYED, ID_TIMER
 
 	fun_t  * state; // callback procedure
+	act_t  * action;// callback procedure with argument (tmr_initArg), launched instead of state if set
+	void   * arg;   // argument of the callback procedure with argument
 	cnt_t    start;
 	cnt_t    delay;
 	cnt_t    period;
+	cnt_t    slack; // tolerated lateness of expirations (tick-less mode and tick-less idle)
 };
 
 /******************************************************************************
@@ -71,7 +74,26 @@ struct __tmr
  *
  ******************************************************************************/
 
-#define               _TMR_INIT( _state ) { _OBJ_INIT(), ID_STOPPED, _state, 0, 0, 0 }
+#define               _TMR_INIT( _state ) { _OBJ_INIT(), ID_STOPPED, _state, 0, 0, 0, 0, 0, 0 }
+
+/******************************************************************************
+ *
+ * Name              : _TMR_INIT_ARG
+ *
+ * Description       : create and initialize a timer object with a callback procedure with argument
+ *
+ * Parameters
+ *   action          : callback procedure with argument
+ *                     0: no callback
+ *   arg             : argument of the callback procedure
+ *
+ * Return            : timer object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _TMR_INIT_ARG( _action, _arg ) { _OBJ_INIT(), ID_STOPPED, 0, _action, _arg, 0, 0, 0, 0 }
 
 /******************************************************************************
  *
@@ -301,8 +323,13 @@ struct __tmr
  *
  ******************************************************************************/
 
+#if OS_TIMER_TASK
+__STATIC_INLINE
+tmr_t *tmr_thisISR( void ) { return (tmr_t *) PEND.obj.next; }
+#else
 __STATIC_INLINE
 tmr_t *tmr_thisISR( void ) { return (tmr_t *) WAIT.obj.next; }
+#endif
 
 /******************************************************************************
  *
@@ -323,6 +350,27 @@ tmr_t *tmr_thisISR( void ) { return (tmr_t *) WAIT.obj.next; }
 
 void tmr_init( tmr_t *tmr, fun_t *state );
 
+/******************************************************************************
+ *
+ * Name              : tmr_initArg
+ *
+ * Description       : initialize a timer object with a callback procedure with argument
+ *                     the callback procedure receives the argument directly, so it doesn't have to use tmr_thisISR
+ *
+ * Parameters
+ *   tmr             : pointer to timer object
+ *   action          : callback procedure with argument
+ *                     0: no callback
+ *   arg             : argument of the callback procedure
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void tmr_initArg( tmr_t *tmr, act_t *action, void *arg );
+
 /******************************************************************************
  *
  * Name              : tmr_create
@@ -405,6 +453,35 @@ void tmr_delete( tmr_t *tmr );
 
 void tmr_start( tmr_t *tmr, cnt_t delay, cnt_t period );
 
+/******************************************************************************
+ *
+ * Name              : tmr_startSlack
+ *
+ * Description       : start/restart periodic timer for given duration of time, allowing given lateness of expirations
+ *                     when the timer has finished the countdown, the callback procedure is launched
+ *                     do this periodically if period > 0
+ *                     expirations of timers falling within the slack window are serviced in one interrupt
+ *
+ * Parameters
+ *   tmr             : pointer to timer object
+ *   delay           : duration of time (maximum number of ticks to countdown) for first expiration
+ *                     IMMEDIATE: don't countdown
+ *                     INFINITE:  countdown indefinitely
+ *   period          : duration of time (maximum number of ticks to countdown) for all next expirations
+ *                     IMMEDIATE: don't countdown
+ *                     INFINITE:  countdown indefinitely
+ *   slack           : maximum number of ticks each expiration may be delayed
+ *                     the slack remains in effect for subsequent starts of the timer
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     slack has effect in tick-less mode and with OS_TICKLESS_IDLE
+ *
+ ******************************************************************************/
+
+void tmr_startSlack( tmr_t *tmr, cnt_t delay, cnt_t period, cnt_t slack );
+
 /******************************************************************************
  *
  * Name              : tmr_startFor
@@ -477,6 +554,34 @@ void tmr_startPeriodic( tmr_t *tmr, cnt_t period ) { tmr_start(tmr, period, peri
 
 void tmr_startFrom( tmr_t *tmr, cnt_t delay, cnt_t period, fun_t *proc );
 
+/******************************************************************************
+ *
+ * Name              : tmr_startArg
+ *
+ * Description       : start/restart periodic timer for given duration of time
+ *                     when the timer has finished the countdown, the callback procedure is launched with the argument
+ *                     do this periodically if period > 0
+ *
+ * Parameters
+ *   tmr             : pointer to timer object
+ *   delay           : duration of time (maximum number of ticks to countdown) for first expiration
+ *                     IMMEDIATE: don't countdown
+ *                     INFINITE:  countdown indefinitely
+ *   period          : duration of time (maximum number of ticks to countdown) for all next expirations
+ *                     IMMEDIATE: don't countdown
+ *                     INFINITE:  countdown indefinitely
+ *   action          : callback procedure with argument
+ *                     0: no callback
+ *   arg             : argument of the callback procedure
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void tmr_startArg( tmr_t *tmr, cnt_t delay, cnt_t period, act_t *action, void *arg );
+
 /******************************************************************************
  *
  * Name              : tmr_startNext
@@ -663,7 +768,7 @@ unsigned tmr_takeISR( tmr_t *tmr ) { return tmr_take(tmr); }
  ******************************************************************************/
 
 __STATIC_INLINE
-void tmr_flipISR( fun_t *proc ) { tmr_thisISR()->state = proc; }
+void tmr_flipISR( fun_t *proc ) { tmr_t *tmr = tmr_thisISR(); tmr->state = proc; tmr->action = 0; }
 
 /******************************************************************************
  *
@@ -685,6 +790,183 @@ void tmr_flipISR( fun_t *proc ) { tmr_thisISR()->state = proc; }
 __STATIC_INLINE
 void tmr_delayISR( cnt_t delay ) { tmr_thisISR()->delay = delay; }
 
+/******************************************************************************
+ *
+ * Name              : timer group
+ *
+ * Note              : timer group starts, stops and shifts all its member timers in one critical section,
+ *                     members are merged into the timers queue in one pass and the hardware timer is reprogrammed once
+ *
+ ******************************************************************************/
+
+typedef struct __tmm tmm_t;
+
+struct __tmm
+{
+	tmr_t  * tmr;   // member timer
+	cnt_t    delay; // delay of the first expiration, relative to the base of the group
+	cnt_t    period;// period of the next expirations
+};
+
+typedef struct __tmg tmg_t, * const tmg_id;
+
+struct __tmg
+{
+	unsigned count; // number of member timers
+	unsigned limit; // size of the member table (max number of member timers)
+	tmm_t  * data;  // member table, ordered by delays
+	cnt_t    base;  // base of the group: start time of all members
+};
+
+/******************************************************************************
+ *
+ * Name              : _TMG_INIT
+ *
+ * Description       : create and initialize a timer group
+ *
+ * Parameters
+ *   limit           : size of the member table (max number of member timers)
+ *   data            : member table
+ *
+ * Return            : timer group
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _TMG_INIT( _limit, _data ) { 0, _limit, _data, 0 }
+
+/******************************************************************************
+ *
+ * Name              : OS_TMG
+ *
+ * Description       : define and initialize a timer group
+ *
+ * Parameters
+ *   tmg             : name of a pointer to timer group
+ *   limit           : size of the member table (max number of member timers)
+ *
+ ******************************************************************************/
+
+#define             OS_TMG( tmg, limit )                                \
+                       tmm_t tmg##__buf[limit];                          \
+                       tmg_t tmg##__tmg = _TMG_INIT( limit, tmg##__buf ); \
+                       tmg_id tmg = & tmg##__tmg
+
+/******************************************************************************
+ *
+ * Name              : static_TMG
+ *
+ * Description       : define and initialize a static timer group
+ *
+ * Parameters
+ *   tmg             : name of a pointer to timer group
+ *   limit           : size of the member table (max number of member timers)
+ *
+ ******************************************************************************/
+
+#define         static_TMG( tmg, limit )                                \
+                static tmm_t tmg##__buf[limit];                          \
+                static tmg_t tmg##__tmg = _TMG_INIT( limit, tmg##__buf ); \
+                static tmg_id tmg = & tmg##__tmg
+
+/******************************************************************************
+ *
+ * Name              : tmg_init
+ *
+ * Description       : initialize a timer group
+ *
+ * Parameters
+ *   tmg             : pointer to timer group
+ *   limit           : size of the member table (max number of member timers)
+ *   data            : member table
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void tmg_init( tmg_t *tmg, unsigned limit, tmm_t *data );
+
+/******************************************************************************
+ *
+ * Name              : tmg_add
+ *
+ * Description       : add the timer to the timer group
+ *
+ * Parameters
+ *   tmg             : pointer to timer group
+ *   tmr             : pointer to timer object (not a member of any group)
+ *   delay           : duration of time for the first expiration, relative to the base of the group
+ *   period          : duration of time for all next expirations
+ *                     IMMEDIATE: one-shot timer
+ *
+ * Return
+ *   E_SUCCESS       : timer was successfully added to the group
+ *   E_TIMEOUT       : member table is full
+ *
+ * Note              : use only in thread mode
+ *                     callbacks of member timers can use tmr_thisISR as usual
+ *
+ ******************************************************************************/
+
+unsigned tmg_add( tmg_t *tmg, tmr_t *tmr, cnt_t delay, cnt_t period );
+
+/******************************************************************************
+ *
+ * Name              : tmg_start
+ *
+ * Description       : start/restart all member timers of the timer group,
+ *                     the current time becomes the base of the group
+ *
+ * Parameters
+ *   tmg             : pointer to timer group
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void tmg_start( tmg_t *tmg );
+
+/******************************************************************************
+ *
+ * Name              : tmg_stop
+ *
+ * Description       : stop all member timers of the timer group
+ *
+ * Parameters
+ *   tmg             : pointer to timer group
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void tmg_stop( tmg_t *tmg );
+
+/******************************************************************************
+ *
+ * Name              : tmg_shift
+ *
+ * Description       : move the base of the timer group forward, postponing the next expiration of all running member timers
+ *
+ * Parameters
+ *   tmg             : pointer to timer group
+ *   delta           : duration of time added to the base of the group
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     stopped member timers are not started, periods of member timers are not changed
+ *
+ ******************************************************************************/
+
+void tmg_shift( tmg_t *tmg, cnt_t delta );
+
 #ifdef __cplusplus
 }
 #endif
@@ -706,15 +988,18 @@ void tmr_delayISR( cnt_t delay ) { tmr_thisISR()->delay = delay; }
 
 struct staticTimer : public __tmr
 {
-	 staticTimer( void ):          __tmr _TMR_INIT(0) {}
-	 staticTimer( fun_t *_state ): __tmr _TMR_INIT(_state) {}
+	constexpr staticTimer( void ):          __tmr _TMR_INIT(0) {}
+	constexpr staticTimer( fun_t *_state ): __tmr _TMR_INIT(_state) {}
 	~staticTimer( void ) { assert(__tmr::id == ID_STOPPED); }
 
 	void kill         ( void )                                       {        tmr_kill         (this);                          }
 	void start        ( cnt_t _delay, cnt_t _period )                {        tmr_start        (this, _delay, _period);         }
+	void startSlack   ( cnt_t _delay, cnt_t _period, cnt_t _slack )  {        tmr_startSlack   (this, _delay, _period, _slack); }
 	void startFor     ( cnt_t _delay )                               {        tmr_startFor     (this, _delay);                  }
 	void startPeriodic( cnt_t _period )                              {        tmr_startPeriodic(this,         _period);         }
 	void startFrom    ( cnt_t _delay, cnt_t _period, fun_t *_state ) {        tmr_startFrom    (this, _delay, _period, _state); }
+	void startArg     ( cnt_t _delay, cnt_t _period, act_t *_action, void *_arg )
+	                                                                 {        tmr_startArg     (this, _delay, _period, _action, _arg); }
 	void startNext    ( cnt_t _delay )                               {        tmr_startNext    (this, _delay);                  }
 	void startUntil   ( cnt_t _time )                                {        tmr_startUntil   (this, _time);                   }
 	void stop         ( void )                                       {        tmr_stop         (this);                          }
@@ -744,12 +1029,12 @@ struct Timer : public staticTimer
 {
 	Timer( void ): staticTimer() {}
 #if OS_FUNCTIONAL
-	Timer( FUN_t _state ): staticTimer(run_), fun_(_state) {}
+	Timer( FUN_t _state ): staticTimer(), fun_(_state) { __tmr::action = run_; __tmr::arg = this; }
 
-	void  startFrom( cnt_t _delay, cnt_t _period, FUN_t _state ) { fun_ = _state; tmr_startFrom(this, _delay, _period, run_); }
+	void  startFrom( cnt_t _delay, cnt_t _period, FUN_t _state ) { fun_ = _state; tmr_startArg(this, _delay, _period, run_, this); }
 
 	static
-	void  run_( void ) { ((Timer *)WAIT.obj.next)->fun_(); }
+	void  run_( void *_arg ) { ((Timer *)_arg)->fun_(); }
 	FUN_t fun_;
 #else
 	Timer( FUN_t _state ): staticTimer(_state) {}
@@ -858,8 +1143,8 @@ struct startTimerUntil : public Timer
 namespace ThisTimer
 {
 #if OS_FUNCTIONAL
-	static inline void flipISR ( FUN_t _state ) { ((Timer *)WAIT.obj.next)->fun_ = _state;
-	                                              tmr_flipISR (Timer::run_);               }
+	static inline void flipISR ( FUN_t _state ) { Timer *tmr = (Timer *)tmr_thisISR(); tmr->fun_ = _state;
+	                                              tmr->state = 0; tmr->action = Timer::run_; tmr->arg = tmr; }
 #else
 	static inline void flipISR ( FUN_t _state ) { tmr_flipISR (_state);                    }
 #endif
@@ -0,0 +1,542 @@
+/******************************************************************************
+
+    @file    StateOS: osworkerpool.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file contains definitions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_WPL_H
+#define __STATEOS_WPL_H
+
+#include "oskernel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : worker pool job
+ *
+ ******************************************************************************/
+
+typedef struct __wpj wpj_t;
+
+struct __wpj
+{
+	act_t  * fun;   // job procedure
+	void   * arg;   // argument passed to the job procedure
+};
+
+/******************************************************************************
+ *
+ * Name              : worker pool
+ *
+ * Note              : worker tasks wait on the pool object in priority order,
+ *                     every queued job wakes up at most one of them
+ *
+ ******************************************************************************/
+
+typedef struct __wpl wpl_t, * const wpl_id;
+
+struct __wpl
+{
+	tsk_t  * queue; // inherited from semaphore
+	void   * res;   // allocated worker pool object's resource
+	unsigned count; // inherited from semaphore
+	unsigned limit; // inherited from semaphore
+
+	unsigned head;  // first element to read from data buffer
+	unsigned tail;  // first element to write into data buffer
+	wpj_t  * data;  // data buffer
+
+	unsigned size;  // number of worker tasks owned by the pool
+	tsk_t ** wrk;   // worker tasks owned by the pool
+};
+
+/******************************************************************************
+ *
+ * Name              : _WPL_INIT
+ *
+ * Description       : create and initialize a worker pool object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored jobs)
+ *   data            : worker pool data buffer
+ *
+ * Return            : worker pool object
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#define               _WPL_INIT( _limit, _data ) { 0, 0, 0, _limit, 0, 0, _data, 0, 0 }
+
+/******************************************************************************
+ *
+ * Name              : _WPL_DATA
+ *
+ * Description       : create a worker pool data buffer
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ * Return            : worker pool data buffer
+ *
+ * Note              : for internal use
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define               _WPL_DATA( _limit ) (wpj_t[_limit]){ { 0, 0 } }
+#endif
+
+/******************************************************************************
+ *
+ * Name              : OS_WPL
+ *
+ * Description       : define and initialize a worker pool object
+ *                     worker tasks must be defined separately and call wpl_wait
+ *
+ * Parameters
+ *   wpl             : name of a pointer to worker pool object
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ ******************************************************************************/
+
+#define             OS_WPL( wpl, limit )                                 \
+           __OS_NOINIT wpj_t  wpl##__buf[limit];                          \
+                       wpl_t  wpl##__wpl = _WPL_INIT( limit, wpl##__buf ); \
+                       wpl_id wpl = & wpl##__wpl
+
+/******************************************************************************
+ *
+ * Name              : static_WPL
+ *
+ * Description       : define and initialize a static worker pool object
+ *                     worker tasks must be defined separately and call wpl_wait
+ *
+ * Parameters
+ *   wpl             : name of a pointer to worker pool object
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ ******************************************************************************/
+
+#define         static_WPL( wpl, limit )                                 \
+    static __OS_NOINIT wpj_t  wpl##__buf[limit];                          \
+                static wpl_t  wpl##__wpl = _WPL_INIT( limit, wpl##__buf ); \
+                static wpl_id wpl = & wpl##__wpl
+
+/******************************************************************************
+ *
+ * Name              : WPL_INIT
+ *
+ * Description       : create and initialize a worker pool object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ * Return            : worker pool object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                WPL_INIT( limit ) \
+                      _WPL_INIT( limit, _WPL_DATA( limit ) )
+#endif
+
+/******************************************************************************
+ *
+ * Name              : WPL_CREATE
+ * Alias             : WPL_NEW
+ *
+ * Description       : create and initialize a worker pool object
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ * Return            : pointer to worker pool object
+ *
+ * Note              : use only in 'C' code
+ *
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#define                WPL_CREATE( limit ) \
+           (wpl_t[]) { WPL_INIT  ( limit ) }
+#define                WPL_NEW \
+                       WPL_CREATE
+#endif
+
+/******************************************************************************
+ *
+ * Name              : wpl_init
+ *
+ * Description       : initialize a worker pool object
+ *                     worker tasks must be defined separately and call wpl_wait
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *   limit           : size of a queue (max number of stored jobs)
+ *   data            : worker pool data buffer
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void wpl_init( wpl_t *wpl, unsigned limit, wpj_t *data );
+
+/******************************************************************************
+ *
+ * Name              : wpl_create
+ * Alias             : wpl_new
+ *
+ * Description       : create and initialize a new worker pool object with its own worker tasks
+ *
+ * Parameters
+ *   limit           : size of a queue (max number of stored jobs)
+ *   workers         : number of worker tasks
+ *   prio            : priority of worker tasks
+ *   size            : size of private stack of every worker task (in bytes)
+ *
+ * Return            : pointer to worker pool object (worker pool successfully created)
+ *   0               : worker pool not created (not enough free memory)
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+wpl_t *wpl_create( unsigned limit, unsigned workers, unsigned prio, unsigned size );
+
+__STATIC_INLINE
+wpl_t *wpl_new( unsigned limit, unsigned workers, unsigned prio, unsigned size ) { return wpl_create(limit, workers, prio, size); }
+
+/******************************************************************************
+ *
+ * Name              : wpl_kill
+ *
+ * Description       : reset the worker pool object and wake up all waiting tasks with 'E_STOPPED' event,
+ *                     queued jobs are discarded, worker tasks owned by the pool keep waiting for new jobs
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+void wpl_kill( wpl_t *wpl );
+
+/******************************************************************************
+ *
+ * Name              : wpl_delete
+ *
+ * Description       : reset the worker pool object, delete worker tasks owned by the pool
+ *                     and free allocated resource
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     don't use in a job procedure executed by the worker pool
+ *
+ ******************************************************************************/
+
+void wpl_delete( wpl_t *wpl );
+
+/******************************************************************************
+ *
+ * Name              : wpl_waitFor
+ *
+ * Description       : try to transfer a job from the worker pool object and execute the job procedure,
+ *                     wait for given duration of time while the worker pool object is empty
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *   delay           : duration of time (maximum number of ticks to wait while the worker pool object is empty)
+ *                     IMMEDIATE: don't wait if the worker pool object is empty
+ *                     INFINITE:  wait indefinitely while the worker pool object is empty
+ *
+ * Return
+ *   E_SUCCESS       : job was successfully transfered from the worker pool object
+ *   E_STOPPED       : worker pool object was killed before the specified timeout expired
+ *   E_TIMEOUT       : worker pool object is empty and was not received a job before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned wpl_waitFor( wpl_t *wpl, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : wpl_waitUntil
+ *
+ * Description       : try to transfer a job from the worker pool object and execute the job procedure,
+ *                     wait until given timepoint while the worker pool object is empty
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : job was successfully transfered from the worker pool object
+ *   E_STOPPED       : worker pool object was killed before the specified timeout expired
+ *   E_TIMEOUT       : worker pool object is empty and was not received a job before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned wpl_waitUntil( wpl_t *wpl, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : wpl_wait
+ *
+ * Description       : try to transfer a job from the worker pool object and execute the job procedure,
+ *                     wait indefinitely while the worker pool object is empty
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *
+ * Return
+ *   E_SUCCESS       : job was successfully transfered from the worker pool object
+ *   E_STOPPED       : worker pool object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned wpl_wait( wpl_t *wpl ) { return wpl_waitFor(wpl, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : wpl_take
+ * ISR alias         : wpl_takeISR
+ *
+ * Description       : try to transfer a job from the worker pool object and execute the job procedure,
+ *                     don't wait if the worker pool object is empty
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *
+ * Return
+ *   E_SUCCESS       : job was successfully transfered from the worker pool object
+ *   E_TIMEOUT       : worker pool object is empty
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned wpl_take( wpl_t *wpl );
+
+__STATIC_INLINE
+unsigned wpl_takeISR( wpl_t *wpl ) { return wpl_take(wpl); }
+
+/******************************************************************************
+ *
+ * Name              : wpl_sendFor
+ *
+ * Description       : try to transfer a job to the worker pool object,
+ *                     wait for given duration of time while the worker pool object is full
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *   fun             : pointer to job procedure
+ *   arg             : argument passed to the job procedure
+ *   delay           : duration of time (maximum number of ticks to wait while the worker pool object is full)
+ *                     IMMEDIATE: don't wait if the worker pool object is full
+ *                     INFINITE:  wait indefinitely while the worker pool object is full
+ *
+ * Return
+ *   E_SUCCESS       : job was successfully transfered to the worker pool object
+ *   E_STOPPED       : worker pool object was killed before the specified timeout expired
+ *   E_TIMEOUT       : worker pool object is full and was not issued a job before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned wpl_sendFor( wpl_t *wpl, act_t *fun, void *arg, cnt_t delay );
+
+/******************************************************************************
+ *
+ * Name              : wpl_sendUntil
+ *
+ * Description       : try to transfer a job to the worker pool object,
+ *                     wait until given timepoint while the worker pool object is full
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *   fun             : pointer to job procedure
+ *   arg             : argument passed to the job procedure
+ *   time            : timepoint value
+ *
+ * Return
+ *   E_SUCCESS       : job was successfully transfered to the worker pool object
+ *   E_STOPPED       : worker pool object was killed before the specified timeout expired
+ *   E_TIMEOUT       : worker pool object is full and was not issued a job before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+unsigned wpl_sendUntil( wpl_t *wpl, act_t *fun, void *arg, cnt_t time );
+
+/******************************************************************************
+ *
+ * Name              : wpl_send
+ *
+ * Description       : try to transfer a job to the worker pool object,
+ *                     wait indefinitely while the worker pool object is full
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *   fun             : pointer to job procedure
+ *   arg             : argument passed to the job procedure
+ *
+ * Return
+ *   E_SUCCESS       : job was successfully transfered to the worker pool object
+ *   E_STOPPED       : worker pool object was killed
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+unsigned wpl_send( wpl_t *wpl, act_t *fun, void *arg ) { return wpl_sendFor(wpl, fun, arg, INFINITE); }
+
+/******************************************************************************
+ *
+ * Name              : wpl_give
+ * ISR alias         : wpl_giveISR
+ *
+ * Description       : try to transfer a job to the worker pool object,
+ *                     don't wait if the worker pool object is full
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *   fun             : pointer to job procedure
+ *   arg             : argument passed to the job procedure
+ *
+ * Return
+ *   E_SUCCESS       : job was successfully transfered to the worker pool object
+ *   E_TIMEOUT       : worker pool object is full
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned wpl_give( wpl_t *wpl, act_t *fun, void *arg );
+
+__STATIC_INLINE
+unsigned wpl_giveISR( wpl_t *wpl, act_t *fun, void *arg ) { return wpl_give(wpl, fun, arg); }
+
+/******************************************************************************
+ *
+ * Name              : wpl_push
+ * ISR alias         : wpl_pushISR
+ *
+ * Description       : try to transfer a job to the worker pool object,
+ *                     remove the oldest job if the worker pool object is full
+ *
+ * Parameters
+ *   wpl             : pointer to worker pool object
+ *   fun             : pointer to job procedure
+ *   arg             : argument passed to the job procedure
+ *
+ * Return
+ *   E_SUCCESS       : job was successfully transfered to the worker pool object
+ *   E_TIMEOUT       : there are tasks waiting for writing to the worker pool object
+ *
+ * Note              : may be used both in thread and handler mode
+ *
+ ******************************************************************************/
+
+unsigned wpl_push( wpl_t *wpl, act_t *fun, void *arg );
+
+__STATIC_INLINE
+unsigned wpl_pushISR( wpl_t *wpl, act_t *fun, void *arg ) { return wpl_push(wpl, fun, arg); }
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+
+/******************************************************************************
+ *
+ * Class             : WorkerPoolT<>
+ *
+ * Description       : create and initialize a worker pool object
+ *                     worker tasks must be defined separately and call wait
+ *
+ * Constructor parameters
+ *   limit           : size of a queue (max number of stored jobs)
+ *
+ ******************************************************************************/
+
+template<unsigned limit_>
+struct WorkerPoolT : public __wpl
+{
+	 WorkerPoolT( void ): __wpl _WPL_INIT(limit_, data_) {}
+	~WorkerPoolT( void ) { assert(__wpl::queue == nullptr); }
+
+	void     kill     ( void )                                   {        wpl_kill     (this);                     }
+	unsigned waitFor  ( cnt_t  _delay )                          { return wpl_waitFor  (this, _delay);             }
+	unsigned waitUntil( cnt_t  _time )                           { return wpl_waitUntil(this, _time);              }
+	unsigned wait     ( void )                                   { return wpl_wait     (this);                     }
+	unsigned take     ( void )                                   { return wpl_take     (this);                     }
+	unsigned sendFor  ( act_t *_fun, void *_arg, cnt_t _delay )  { return wpl_sendFor  (this, _fun, _arg, _delay); }
+	unsigned sendUntil( act_t *_fun, void *_arg, cnt_t _time )   { return wpl_sendUntil(this, _fun, _arg, _time);  }
+	unsigned send     ( act_t *_fun, void *_arg )                { return wpl_send     (this, _fun, _arg);         }
+	unsigned give     ( act_t *_fun, void *_arg )                { return wpl_give     (this, _fun, _arg);         }
+	unsigned giveISR  ( act_t *_fun, void *_arg )                { return wpl_giveISR  (this, _fun, _arg);         }
+	unsigned push     ( act_t *_fun, void *_arg )                { return wpl_push     (this, _fun, _arg);         }
+	unsigned pushISR  ( act_t *_fun, void *_arg )                { return wpl_pushISR  (this, _fun, _arg);         }
+
+	private:
+	wpj_t data_[limit_];
+};
+
+#endif//__cplusplus
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_WPL_H
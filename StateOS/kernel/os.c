@@ -30,6 +30,7 @@
  ******************************************************************************/
 
 #include "oskernel.h"
+#include "inc/ostask.h"
 #include "inc/oscriticalsection.h"
 
 /* -------------------------------------------------------------------------- */
@@ -48,3 +49,179 @@ cnt_t sys_time( void )
 }
 
 /* -------------------------------------------------------------------------- */
+uint64_t sys_time64( void )
+/* -------------------------------------------------------------------------- */
+{
+#if HW_TIMER_SIZE == 0 && OS_TIMER_SIZE < 64
+	return core_sys_time64();
+#else
+	uint64_t cnt;
+
+	sys_lock();
+	{
+		cnt = core_sys_time64();
+	}
+	sys_unlock();
+
+	return cnt;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if 1000000 % (OS_FREQUENCY) == 0
+
+/* -------------------------------------------------------------------------- */
+uint32_t sys_timeHR( void )
+/* -------------------------------------------------------------------------- */
+{
+	uint32_t hrt;
+
+	sys_lock();
+	{
+		hrt = core_hrt_time();
+	}
+	sys_unlock();
+
+	return hrt;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_DEFER_SIZE
+
+static struct
+{
+	volatile uint32_t head; // next deferred call to execute (advanced only by the handler)
+	volatile uint32_t tail; // next free slot (reserved by producers with compare-and-swap)
+	struct {
+	act_t  * volatile fun;  // zero while the slot is free or not yet filled
+	void   * arg;
+	}        data[OS_DEFER_SIZE];
+}	Defer = { 0, 0, { { 0, 0 } } };
+
+/* -------------------------------------------------------------------------- */
+unsigned sys_defer( act_t *fun, void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	uint32_t tail;
+	unsigned i;
+
+	assert(fun);
+
+	do
+	{
+		tail = Defer.tail;
+		if (tail - Defer.head >= OS_DEFER_SIZE)
+			return E_TIMEOUT;
+	}
+	while (!port_atomic_cas32(&Defer.tail, tail, tail + 1));
+
+	i = tail % OS_DEFER_SIZE;
+	Defer.data[i].arg = arg;
+	port_mem_barrier();
+	Defer.data[i].fun = fun;
+
+	port_ctx_switch();
+
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+void core_dfr_handler( void )
+/* -------------------------------------------------------------------------- */
+{
+	act_t  * fun;
+	void   * arg;
+	unsigned i;
+
+	// the slot at the head may be reserved by a preempted thread mode producer;
+	// it will be executed in the context switch handler requested by that producer
+	while (Defer.head != Defer.tail)
+	{
+		i = Defer.head % OS_DEFER_SIZE;
+		fun = Defer.data[i].fun;
+		if (fun == 0)
+			break;
+		port_mem_barrier();
+		arg = Defer.data[i].arg;
+		Defer.data[i].fun = 0;
+		port_mem_barrier();
+		Defer.head++;
+
+		fun(arg);
+	}
+}
+
+#endif//OS_DEFER_SIZE
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_WAIT_QUEUES
+
+static obj_t WaitAddr[OS_WAIT_QUEUES];
+
+/* -------------------------------------------------------------------------- */
+static
+obj_t *priv_adr_queue( const volatile uint32_t *addr )
+/* -------------------------------------------------------------------------- */
+{
+	uintptr_t key = (uintptr_t) addr / sizeof(uint32_t);
+
+	return &WaitAddr[(key ^ (key >> 5)) & (OS_WAIT_QUEUES - 1)];
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned sys_waitAddr( const volatile uint32_t *addr, uint32_t expected, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_SUCCESS;
+
+	assert(!port_isr_inside());
+	assert(addr);
+
+	sys_lock();
+	{
+		if (*addr == expected)
+		{
+			System.cur->tmp.adr.addr = addr;
+			event = core_tsk_waitFor(priv_adr_queue(addr), delay);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned sys_wakeAddr( const volatile uint32_t *addr, unsigned num )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t  * tsk;
+	tsk_t  * nxt;
+	unsigned cnt = 0;
+
+	assert(addr);
+
+	sys_lock();
+	{
+		for (tsk = priv_adr_queue(addr)->queue; tsk && cnt < num; tsk = nxt)
+		{
+			nxt = tsk->obj.queue;
+			if (tsk->tmp.adr.addr == addr)
+			{
+				core_tsk_wakeup(tsk, E_SUCCESS);
+				cnt++;
+			}
+		}
+	}
+	sys_unlock();
+
+	return cnt;
+}
+
+#endif//OS_WAIT_QUEUES
+
+/* -------------------------------------------------------------------------- */
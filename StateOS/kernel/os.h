@@ -47,6 +47,7 @@
 #include "oskernel.h"
 #include "inc/oscriticalsection.h"
 #include "inc/osspinlock.h"
+#include "inc/osseqlock.h"
 #include "inc/ossignal.h"
 #include "inc/osevent.h"
 #include "inc/osflag.h"
@@ -55,15 +56,43 @@
 #include "inc/osmutex.h"
 #include "inc/osfastmutex.h"
 #include "inc/osconditionvariable.h"
+#include "inc/osrwlock.h"
 #include "inc/oslist.h"
 #include "inc/osmemorypool.h"
+#include "inc/osarena.h"
+#include "inc/osmailqueue.h"
+#include "inc/ospacket.h"
 #include "inc/osstreambuffer.h"
+#include "inc/osringbuffer.h"
+#include "inc/osintercore.h"
 #include "inc/osmessagebuffer.h"
+#include "inc/osbroadcastring.h"
 #include "inc/osmailboxqueue.h"
+#include "inc/osprioritymailboxqueue.h"
+#include "inc/osmpmcqueue.h"
 #include "inc/osjobqueue.h"
+#include "inc/ospriorityjobqueue.h"
+#include "inc/osworkerpool.h"
+#include "inc/osactiveobject.h"
 #include "inc/oseventqueue.h"
+#include "inc/osselect.h"
 #include "inc/ostimer.h"
+#include "inc/oscoalescer.h"
+#include "inc/osinterruptservice.h"
+#include "inc/osidlehook.h"
+#include "inc/osjobtimer.h"
+#include "inc/osasyncio.h"
 #include "inc/ostask.h"
+#include "inc/osperfcounter.h"
+#include "inc/osenergy.h"
+#include "inc/ospartition.h"
+#include "inc/osexecutive.h"
+#include "inc/osrcu.h"
+#include "inc/oscoroutine.h"
+#include "inc/osmemoryresource.h"
+#include "inc/ospipeline.h"
+#include "inc/osforkjoin.h"
+#include "inc/osdoublebuffer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -87,6 +116,26 @@ extern "C" {
 __STATIC_INLINE
 void sys_init( void ) { port_sys_init(); }
 
+/******************************************************************************
+ *
+ * Name              : sys_isrStackUsed
+ *
+ * Description       : return the maximum number of bytes of the dedicated interrupt stack used so far (high-water mark)
+ *
+ * Parameters        : none
+ *
+ * Return            : number of bytes of the interrupt stack used since the system was initialized
+ *
+ * Note              : available when the port uses the dedicated interrupt stack (OS_ISR_STACK > 0)
+ *                     the interrupt stack is painted by port_sys_init and fully examined by this function
+ *
+ ******************************************************************************/
+
+#if OS_ISR_STACK
+__STATIC_INLINE
+unsigned sys_isrStackUsed( void ) { return core_isr_used(); }
+#endif
+
 /******************************************************************************
  *
  * Name              : sys_alloc
@@ -124,6 +173,90 @@ void *sys_alloc( size_t size ) { return core_sys_alloc(size); }
 __STATIC_INLINE
 void sys_free( void *ptr ) { core_sys_free(ptr); }
 
+/******************************************************************************
+ *
+ * Name              : sys_heapInfo
+ *
+ * Description       : take a snapshot of the system heap statistics
+ *                     free bytes, peak usage and number of allocated segments are maintained by sys_alloc and sys_free,
+ *                     the largest free segment is searched in the highest size class (OS_HEAP_TLSF) or in the whole heap
+ *                     memory segments of static pools bound to the system allocator are not counted
+ *
+ * Parameters
+ *   info            : pointer to store the system heap statistics
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     only the number of allocated segments is known when the system heap is not defined (OS_HEAP_SIZE == 0)
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void sys_heapInfo( hst_t *info ) { core_sys_info(info); }
+
+#if OS_HEAP_QUOTA
+
+/******************************************************************************
+ *
+ * Name              : OS_HQT
+ *
+ * Description       : define and initialize a system heap quota object
+ *
+ * Parameters
+ *   hqt             : name of a pointer to system heap quota object
+ *   limit           : maximum number of live bytes allocated by the owners of the quota, 0: no limit
+ *
+ ******************************************************************************/
+
+#define             OS_HQT( hqt, limit )                         \
+                       hqt_t hqt##__hqt = { limit, 0, 0, 0 };   \
+                       hqt_t * const hqt = & hqt##__hqt
+
+/******************************************************************************
+ *
+ * Name              : sys_heapQuota
+ *
+ * Description       : charge memory segments allocated by the task to the system heap quota object,
+ *                     a quota object may be shared by a group of tasks;
+ *                     a memory segment is charged back to its owner when released, even by another task
+ *
+ * Parameters
+ *   tsk             : pointer to task object
+ *   hqt             : pointer to system heap quota object, 0: allocations of the task are not charged
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     sys_alloc returns 0 without searching the heap when the allocation would exceed the quota;
+ *                     xxx_create functions of such a task fail as on exhausted heap
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void sys_heapQuota( tsk_t *tsk, hqt_t *hqt ) { core_sys_quota(tsk, hqt); }
+
+/******************************************************************************
+ *
+ * Name              : sys_quotaInfo
+ *
+ * Description       : take a snapshot of the system heap quota object
+ *
+ * Parameters
+ *   hqt             : pointer to system heap quota object
+ *   info            : pointer to store the limit, live bytes, peak usage and number of rejected allocations
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *
+ ******************************************************************************/
+
+__STATIC_INLINE
+void sys_quotaInfo( hqt_t *hqt, hqt_t *info ) { core_sys_quotaInfo(hqt, info); }
+
+#endif//OS_HEAP_QUOTA
+
 /******************************************************************************
  *
  * Name              : sys_time
@@ -144,6 +277,280 @@ cnt_t sys_time( void );
 __STATIC_INLINE
 cnt_t sys_timeISR( void ) { return sys_time(); }
 
+/******************************************************************************
+ *
+ * Name              : sys_time64
+ * ISR alias         : sys_time64ISR
+ *
+ * Description       : return current value of system counter extended to 64 bits
+ *                     (monotonic time for long-term timestamps, independent of OS_TIMER_SIZE)
+ *
+ * Parameters        : none
+ *
+ * Return            : current value of 64-bit system counter
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     in non-tick-less mode doesn't mask interrupts
+ *                     in tick-less mode the time is extended on every timer interrupt and every call,
+ *                     at least one of them must occur within each period of the system counter
+ *
+ ******************************************************************************/
+
+uint64_t sys_time64( void );
+
+__STATIC_INLINE
+uint64_t sys_time64ISR( void ) { return sys_time64(); }
+
+/******************************************************************************
+ *
+ * Name              : sys_timeHR
+ * ISR alias         : sys_timeHRISR
+ *
+ * Description       : return current system time in microseconds
+ *                     in non-tick-less mode the system counter is combined with the live value
+ *                     of the system timer (SysTick), so the time advances also between ticks
+ *
+ * Parameters        : none
+ *
+ * Return            : current system time in microseconds (wraps around after 2^32 us or with the system counter)
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     available when 1000000 is a multiple of OS_FREQUENCY;
+ *                     ports without access to the system timer counter (host) return time with tick resolution
+ *
+ ******************************************************************************/
+
+#if 1000000 % (OS_FREQUENCY) == 0
+
+uint32_t sys_timeHR( void );
+
+__STATIC_INLINE
+uint32_t sys_timeHRISR( void ) { return sys_timeHR(); }
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_defer
+ * ISR alias         : sys_deferISR
+ *
+ * Description       : queue a call of procedure 'fun' with argument 'arg' to be executed
+ *                     in the context switch handler (PendSV), before choosing the next task
+ *                     the deferred procedure runs in handler mode with interrupts masked,
+ *                     so it may use only functions allowed in handler mode
+ *
+ * Parameters
+ *   fun             : pointer to deferred procedure
+ *   arg             : argument passed to the deferred procedure
+ *
+ * Return
+ *   E_SUCCESS       : call was successfully queued
+ *   E_TIMEOUT       : ring of deferred calls is full
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     doesn't mask interrupts, so it may be used also in kernel-unaware handlers
+ *                     (urgency above OS_LOCK_LEVEL), available when OS_DEFER_SIZE is set
+ *
+ ******************************************************************************/
+
+#if OS_DEFER_SIZE
+
+unsigned sys_defer( act_t *fun, void *arg );
+
+__STATIC_INLINE
+unsigned sys_deferISR( act_t *fun, void *arg ) { return sys_defer(fun, arg); }
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_waitAddr
+ *
+ * Description       : wait on address: if the word at 'addr' is still equal to 'expected',
+ *                     wait for given duration of time until 'sys_wakeAddr' is called for the same address;
+ *                     the word is checked in a critical section, so a wakeup between the check and the wait can't be lost
+ *
+ * Parameters
+ *   addr            : address of the watched word
+ *   expected        : expected value of the watched word
+ *   delay           : duration of time (maximum number of ticks to wait)
+ *                     IMMEDIATE: don't wait
+ *                     INFINITE:  wait indefinitely until woken
+ *
+ * Return
+ *   E_SUCCESS       : task was woken with 'sys_wakeAddr' or the word was not equal to 'expected'
+ *   E_TIMEOUT       : task was not woken before the specified timeout expired
+ *
+ * Note              : use only in thread mode
+ *                     available when OS_WAIT_QUEUES is set
+ *                     the caller should check the word again after return (spurious returns are allowed)
+ *
+ ******************************************************************************/
+
+#if OS_WAIT_QUEUES
+
+unsigned sys_waitAddr( const volatile uint32_t *addr, uint32_t expected, cnt_t delay );
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_wakeAddr
+ * ISR alias         : sys_wakeAddrISR
+ *
+ * Description       : wake up to 'num' tasks waiting on address 'addr' (in the order of priority, then fifo)
+ *
+ * Parameters
+ *   addr            : address of the watched word
+ *   num             : maximum number of tasks to wake
+ *
+ * Return            : number of woken tasks
+ *
+ * Note              : may be used both in thread and handler mode
+ *                     available when OS_WAIT_QUEUES is set
+ *
+ ******************************************************************************/
+
+#if OS_WAIT_QUEUES
+
+unsigned sys_wakeAddr( const volatile uint32_t *addr, unsigned num );
+
+__STATIC_INLINE
+unsigned sys_wakeAddrISR( const volatile uint32_t *addr, unsigned num ) { return sys_wakeAddr(addr, num); }
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_traceIsrEnter
+ *
+ * Description       : record the entry to the interrupt handler 'id' as a kernel event (TRC_ISR_ENTER)
+ *                     in the trace buffer and / or in the ITM trace stream
+ *
+ * Parameters
+ *   id              : identifier of the interrupt handler (e.g. IRQ number)
+ *
+ * Return            : none
+ *
+ * Note              : use only in handler mode (kernel-aware handlers);
+ *                     generates no code when kernel events are not traced (OS_TRACE_SIZE == 0 and OS_TRACE_ITM == 0)
+ *
+ ******************************************************************************/
+
+#if OS_TRACE_SIZE || OS_TRACE_ITM
+
+__STATIC_INLINE
+void sys_traceIsrEnter( unsigned id ) { lck_t lck = core_sys_lock(); core_trc_event(TRC_ISR_ENTER, 0, id); core_sys_unlock(lck); }
+
+#else
+
+__STATIC_INLINE
+void sys_traceIsrEnter( unsigned id ) { (void) id; }
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_traceIsrExit
+ *
+ * Description       : record the exit from the interrupt handler 'id' as a kernel event (TRC_ISR_EXIT)
+ *                     in the trace buffer and / or in the ITM trace stream
+ *
+ * Parameters
+ *   id              : identifier of the interrupt handler (e.g. IRQ number)
+ *
+ * Return            : none
+ *
+ * Note              : use only in handler mode (kernel-aware handlers);
+ *                     generates no code when kernel events are not traced (OS_TRACE_SIZE == 0 and OS_TRACE_ITM == 0)
+ *
+ ******************************************************************************/
+
+#if OS_TRACE_SIZE || OS_TRACE_ITM
+
+__STATIC_INLINE
+void sys_traceIsrExit( unsigned id ) { lck_t lck = core_sys_lock(); core_trc_event(TRC_ISR_EXIT, 0, id); core_sys_unlock(lck); }
+
+#else
+
+__STATIC_INLINE
+void sys_traceIsrExit( unsigned id ) { (void) id; }
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_profileReset
+ *
+ * Description       : discard all samples stored in the profiler buffer (PROFILE)
+ *
+ * Parameters        : none
+ *
+ * Return            : none
+ *
+ * Note              : may be used both in thread and handler mode;
+ *                     generates no code when the profiler is not used (OS_PROFILE_SIZE == 0)
+ *
+ ******************************************************************************/
+
+#if OS_PROFILE_SIZE
+
+__STATIC_INLINE
+void sys_profileReset( void ) { lck_t lck = core_sys_lock(); PROFILE.head = 0; core_sys_unlock(lck); }
+
+#else
+
+__STATIC_INLINE
+void sys_profileReset( void ) {}
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_objStats
+ *
+ * Description       : return the list of objects (mutexes, semaphores and mailbox queues)
+ *                     with contention statistics recorded since the last reset
+ *
+ * Parameters        : none
+ *
+ * Return            : pointer to statistics of the first recorded object, next objects are linked with the 'next' field
+ *
+ * Note              : use only in thread mode, available when OS_OBJ_STATS is set
+ *                     'time' and 'max' are expressed in system ticks, measured from the start of the wait
+ *                     to the resumption of the task; an object is linked into the list with its first recorded event
+ *                     and unlinked by its 'init' and 'delete' functions
+ *
+ ******************************************************************************/
+
+#if OS_OBJ_STATS
+
+__STATIC_INLINE
+ost_t *sys_objStats( void ) { return core_ost_list(); }
+
+#endif
+
+/******************************************************************************
+ *
+ * Name              : sys_objStatsReset
+ *
+ * Description       : clear the contention statistics of all objects
+ *
+ * Parameters        : none
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode, available when OS_OBJ_STATS is set
+ *
+ ******************************************************************************/
+
+#if OS_OBJ_STATS
+
+__STATIC_INLINE
+void sys_objStatsReset( void ) { lck_t lck = core_sys_lock(); core_ost_reset(); core_sys_unlock(lck); }
+
+#endif
+
 /******************************************************************************
  *
  * Name              : stk_assert
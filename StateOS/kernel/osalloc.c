@@ -31,12 +31,302 @@
 
 #include "oskernel.h"
 #include "inc/oscriticalsection.h"
+#include "inc/osmemorypool.h"
+#include "inc/ostask.h"
 
 /* -------------------------------------------------------------------------- */
 // SYSTEM ALLOC/FREE SERVICES
 /* -------------------------------------------------------------------------- */
 
-#if OS_HEAP_SIZE
+#if OS_HEAP_SIZE && OS_HEAP_TLSF
+
+/* -------------------------------------------------------------------------- */
+
+typedef struct __hdr hdr_t;
+
+struct __hdr
+{
+	hdr_t  * prev; // previous physical memory segment
+	size_t   size; // size of the memory segment in hdr_t units (shifted left), the lowest bit set when free
+};
+
+typedef struct __blk blk_t;
+
+struct __blk
+{
+	hdr_t    hdr;
+	blk_t  * next; // next free memory segment of the same size class
+	blk_t  * back; // previous free memory segment of the same size class
+};
+
+/* -------------------------------------------------------------------------- */
+
+#define HSIZE( size ) \
+ ALIGNED_SIZE( size, hdr_t )
+
+#define SL_BITS    3
+#define SL_COUNT  (1U << SL_BITS)
+#define FL_COUNT  24
+
+#define BSIZE( blk ) \
+     ((blk)->hdr.size >> 1)
+
+#define BFREE( blk ) \
+     ((blk)->hdr.size & 1)
+
+#define BNEXT( blk ) \
+     ((blk_t *)((hdr_t *)(blk) + BSIZE(blk)))
+
+/* -------------------------------------------------------------------------- */
+
+static
+hdr_t Heap[HSIZE(OS_HEAP_SIZE)+1] =
+  { { 0, HSIZE(OS_HEAP_SIZE) << 1 | 1 }, [HSIZE(OS_HEAP_SIZE)] = { Heap, 0 } };
+
+static
+struct { bool init; uint32_t fl; uint32_t sl[FL_COUNT]; blk_t *free[FL_COUNT][SL_COUNT]; } Tlsf;
+
+static
+struct { size_t free; size_t peak; unsigned blocks; unsigned allocs; } Stat;
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_map( size_t size, unsigned *fl, unsigned *sl )
+{
+	unsigned msb;
+
+	if (size < SL_COUNT)
+	{
+		*fl = 0;
+		*sl = size;
+	}
+	else
+	{
+		msb = port_get_msb(size);
+		*fl = msb - SL_BITS + 1;
+		*sl = (size >> (msb - SL_BITS)) - SL_COUNT;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_insert( blk_t *blk )
+{
+	unsigned fl, sl;
+
+	priv_map(BSIZE(blk), &fl, &sl);
+
+	Stat.free += BSIZE(blk) * sizeof(hdr_t);
+	Stat.blocks++;
+
+	blk->hdr.size |= 1;
+	blk->back = 0;
+	blk->next = Tlsf.free[fl][sl];
+	if (blk->next)
+		blk->next->back = blk;
+	Tlsf.free[fl][sl] = blk;
+	Tlsf.sl[fl] |= 1U << sl;
+	Tlsf.fl     |= 1U << fl;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_remove( blk_t *blk )
+{
+	unsigned fl, sl;
+
+	priv_map(BSIZE(blk), &fl, &sl);
+
+	Stat.free -= BSIZE(blk) * sizeof(hdr_t);
+	Stat.blocks--;
+
+	blk->hdr.size &= ~(size_t)1;
+	if (blk->next)
+		blk->next->back = blk->back;
+	if (blk->back)
+		blk->back->next = blk->next;
+	else
+	if ((Tlsf.free[fl][sl] = blk->next) == 0)
+		if ((Tlsf.sl[fl] &= ~(1U << sl)) == 0)
+			Tlsf.fl &= ~(1U << fl);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+blk_t *priv_search( size_t size )
+{
+	blk_t  * blk;
+	unsigned fl, sl;
+	uint32_t msk;
+
+	priv_map(size, &fl, &sl);
+
+	if (fl >= FL_COUNT)
+		return 0;
+
+	blk = Tlsf.free[fl][sl];				// blocks of the same size class may be too small
+
+	if (size >= SL_COUNT)
+		priv_map(size + (1U << (port_get_msb(size) - SL_BITS)) - 1, &fl, &sl); // round up to the next size class
+
+	if (fl < FL_COUNT)
+	{
+		msk = Tlsf.sl[fl] & (~0U << sl);
+		if (msk == 0)
+		{
+			msk = Tlsf.fl & (~0U << fl << 1);
+			if (msk)
+			{
+				fl = port_get_msb(msk & -msk);
+				msk = Tlsf.sl[fl];
+			}
+		}
+		if (msk)
+			return Tlsf.free[fl][port_get_msb(msk & -msk)];
+	}
+
+	while (blk && BSIZE(blk) < size)		// last chance: search the list of the same size class
+		blk = blk->next;
+
+	return blk;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_init( void )
+{
+	if (!Tlsf.init)
+	{
+		Tlsf.init = true;
+		priv_insert((blk_t *)Heap);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void *priv_heap_alloc( size_t size )
+{
+	blk_t *blk;
+	blk_t *nxt;
+
+	assert(HSIZE(size));
+
+	size = HSIZE(size) + 1;
+
+	sys_lock();
+	{
+		priv_init();
+
+		blk = priv_search(size);
+
+		if (blk)
+		{
+			priv_remove(blk);
+
+			if (BSIZE(blk) >= size + 2)			// memory segment is larger than required
+			{
+				nxt = (blk_t *)((hdr_t *)blk + size);
+				nxt->hdr.prev = &blk->hdr;
+				nxt->hdr.size = (BSIZE(blk) - size) << 1;
+				BNEXT(nxt)->hdr.prev = &nxt->hdr;
+				blk->hdr.size = size << 1;
+				priv_insert(nxt);
+			}
+
+			Stat.allocs++;
+			if (Stat.peak < sizeof(Heap) - sizeof(hdr_t) - Stat.free)
+				Stat.peak = sizeof(Heap) - sizeof(hdr_t) - Stat.free;
+		}
+	}
+	sys_unlock();
+
+	assert(blk);
+
+	if (blk)
+		blk = memset(&blk->hdr + 1, 0, (BSIZE(blk) - 1) * sizeof(hdr_t));
+
+	return blk;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_heap_free( void *base )
+{
+	blk_t *blk;
+	blk_t *nxt;
+
+	if (base == 0)
+		return;
+
+	blk = (blk_t *)((hdr_t *) base - 1);
+
+	sys_lock();
+	{
+		assert(!BFREE(blk));
+
+		nxt = BNEXT(blk);
+		if (BFREE(nxt))							// merge with the next free memory segment
+		{
+			priv_remove(nxt);
+			blk->hdr.size += nxt->hdr.size;
+		}
+
+		nxt = (blk_t *) blk->hdr.prev;
+		if (nxt && BFREE(nxt))					// merge with the previous free memory segment
+		{
+			priv_remove(nxt);
+			nxt->hdr.size += blk->hdr.size;
+			blk = nxt;
+		}
+
+		BNEXT(blk)->hdr.prev = &blk->hdr;
+		priv_insert(blk);
+
+		Stat.allocs--;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_heap_info( hst_t *info )
+{
+	blk_t   *blk;
+	unsigned fl;
+
+	sys_lock();
+	{
+		priv_init();
+
+		info->size    = sizeof(Heap) - sizeof(hdr_t);
+		info->free    = Stat.free;
+		info->largest = 0;
+		info->peak    = Stat.peak;
+		info->blocks  = Stat.blocks;
+		info->allocs  = Stat.allocs;
+
+		if (Tlsf.fl)							// the largest free segment belongs to the highest size class
+		{
+			fl = port_get_msb(Tlsf.fl);
+			for (blk = Tlsf.free[fl][port_get_msb(Tlsf.sl[fl])]; blk; blk = blk->next)
+				if (info->largest < (BSIZE(blk) - 1) * sizeof(hdr_t))
+					info->largest = (BSIZE(blk) - 1) * sizeof(hdr_t);
+		}
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#elif OS_HEAP_SIZE
 
 /* -------------------------------------------------------------------------- */
 
@@ -59,9 +349,63 @@ static
 hdr_t Heap[HSIZE(OS_HEAP_SIZE)+1] =
   { { Heap+HSIZE(OS_HEAP_SIZE), HSIZE(OS_HEAP_SIZE) } };
 
+static
+struct { size_t free; size_t peak; unsigned allocs; } Stat =
+       { HSIZE(OS_HEAP_SIZE) * sizeof(hdr_t), 0, 0 };
+
+#if OS_HEAP_COALESCE
+static
+struct { hdr_t *cur; bool pend; } Coalesce = { Heap, false }; // position of the incremental coalescing, segments released since the last sweep
+#endif
+
 /* -------------------------------------------------------------------------- */
 
-void *core_sys_alloc( size_t size )
+static
+void priv_heap_merge( hdr_t *heap )
+{
+	hdr_t *next;
+
+	while ((next = heap->next)->size)		// it is possible to merge adjacent free memory segments
+	{
+		heap->next = next->next;
+		heap->size += next->size;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+hdr_t *priv_heap_fit( size_t size, bool merge )
+{
+	hdr_t *heap;
+
+	for (heap = Heap; heap; heap = heap->next)
+	{
+		if (heap->size == 0)				// memory segment has already been allocated
+			continue;
+
+		if (merge)
+			priv_heap_merge(heap);
+
+		if (heap->size >= size)				// memory segment is large enough
+			break;
+	}
+
+#if OS_HEAP_COALESCE
+	if (merge)								// the position of the incremental coalescing may have been merged
+	{
+		Coalesce.cur  = Heap;
+		Coalesce.pend = heap != 0;			// the rest of the heap has not been coalesced
+	}
+#endif
+
+	return heap;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void *priv_heap_alloc( size_t size )
 {
 	hdr_t *heap;
 	hdr_t *next;
@@ -72,19 +416,17 @@ void *core_sys_alloc( size_t size )
 
 	sys_lock();
 	{
-		for (heap = Heap; heap; heap = heap->next)
-		{
-			if (heap->size == 0)				// memory segment has already been allocated
-				continue;
-
-			while ((next = heap->next)->size)	// it is possible to merge adjacent free memory segments
-			{
-				heap->next = next->next;
-				heap->size += next->size;
-			}
+#if OS_HEAP_COALESCE
+		heap = priv_heap_fit(size, false);
+		if (heap == 0 && (Coalesce.pend || Coalesce.cur != Heap))
+			heap = priv_heap_fit(size, true);	// merges are pending: coalesce the whole heap and retry
+#else
+		heap = priv_heap_fit(size, true);
+#endif
 
-			if (heap->size < size)				// memory segment is too small
-				continue;
+		if (heap)
+		{
+			next = heap->next;
 
 			if (heap->size > size)				// memory segment is larger than required
 			{
@@ -96,7 +438,11 @@ void *core_sys_alloc( size_t size )
 			heap = memset(heap, 0, size * sizeof(hdr_t));
 			heap->next = next;
 			heap = heap + 1;
-			break;								// memory segment was successfully allocated
+
+			Stat.free -= size * sizeof(hdr_t);
+			Stat.allocs++;
+			if (Stat.peak < sizeof(Heap) - sizeof(hdr_t) - Stat.free)
+				Stat.peak = sizeof(Heap) - sizeof(hdr_t) - Stat.free;
 		}
 	}
 	sys_unlock();
@@ -108,7 +454,8 @@ void *core_sys_alloc( size_t size )
 
 /* -------------------------------------------------------------------------- */
 
-void core_sys_free( void *base )
+static
+void priv_heap_free( void *base )
 {
 	hdr_t *heap;
 
@@ -122,6 +469,12 @@ void core_sys_free( void *base )
 				continue;
 
 			heap->size = heap->next - heap;
+
+			Stat.free += heap->size * sizeof(hdr_t);
+			Stat.allocs--;
+#if OS_HEAP_COALESCE
+			Coalesce.pend = true;
+#endif
 			break;								// memory segment was successfully released
 		}
 	}
@@ -130,9 +483,90 @@ void core_sys_free( void *base )
 
 /* -------------------------------------------------------------------------- */
 
+#if OS_HEAP_COALESCE
+
+bool core_sys_coalesce( void )
+{
+	hdr_t   *heap;
+	hdr_t   *next;
+	unsigned n;
+	bool     pend;
+
+	sys_lock();
+	{
+		for (n = 0; n < OS_HEAP_COALESCE && (Coalesce.pend || Coalesce.cur != Heap); n++)
+		{
+			heap = Coalesce.cur;
+			next = heap->next;
+
+			if (heap->size && next->size)		// merge one adjacent free memory segment
+			{
+				heap->next = next->next;
+				heap->size += next->size;
+				continue;
+			}
+
+			if (heap == Heap)					// the first segment is done: segments released from now on need another sweep
+				Coalesce.pend = false;
+
+			Coalesce.cur = next->next ? next : Heap; // the end of the heap: the sweep is finished
+		}
+
+		pend = Coalesce.pend || Coalesce.cur != Heap;
+	}
+	sys_unlock();
+
+	return pend;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_heap_info( hst_t *info )
+{
+	hdr_t *heap;
+
+	sys_lock();
+	{
+		info->size    = sizeof(Heap) - sizeof(hdr_t);
+		info->free    = Stat.free;
+		info->largest = 0;
+		info->peak    = Stat.peak;
+		info->blocks  = 0;
+		info->allocs  = Stat.allocs;
+
+		for (heap = Heap; heap; heap = heap->next)
+		{
+			if (heap->size == 0)				// memory segment has already been allocated
+				continue;
+
+			priv_heap_merge(heap);				// adjacent free memory segments form one fragment
+
+			info->blocks++;
+			if (info->largest < (heap->size - 1) * sizeof(hdr_t))
+				info->largest = (heap->size - 1) * sizeof(hdr_t);
+		}
+#if OS_HEAP_COALESCE
+		Coalesce.cur  = Heap;					// the whole heap has been coalesced
+		Coalesce.pend = false;
+#endif
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+
 #else
 
-void *core_sys_alloc( size_t size )
+static
+unsigned Allocs = 0;
+
+/* -------------------------------------------------------------------------- */
+
+static
+void *priv_heap_alloc( size_t size )
 {
 	void *base;
 
@@ -141,8 +575,14 @@ void *core_sys_alloc( size_t size )
 	base = malloc(size);
 
 	if (base)
+	{
 		base = memset(base, 0, size);
 
+		sys_lock();
+		Allocs++;
+		sys_unlock();
+	}
+
 	assert(base);
 
 	return base;
@@ -150,11 +590,292 @@ void *core_sys_alloc( size_t size )
 
 /* -------------------------------------------------------------------------- */
 
-void core_sys_free( void *base )
+static
+void priv_heap_free( void *base )
 {
+	if (base)
+	{
+		sys_lock();
+		Allocs--;
+		sys_unlock();
+	}
+
 	free(base);
 }
 
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_heap_info( hst_t *info )
+{
+	memset(info, 0, sizeof(hst_t));				// the size of the heap is not known
+
+	info->allocs = Allocs;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+/* -------------------------------------------------------------------------- */
+// SYSTEM HEAP QUOTAS
+/* -------------------------------------------------------------------------- */
+
+#if OS_HEAP_QUOTA
+
+/* -------------------------------------------------------------------------- */
+
+typedef struct __qhd qhd_t;
+
+struct __qhd
+{
+	hqt_t  * hqt;  // heap quota the memory segment is charged to, 0: none
+	size_t   size; // number of bytes charged to the heap quota
+};
+
+/* -------------------------------------------------------------------------- */
+
+static
+void *priv_sys_alloc( size_t size )
+{
+	hqt_t *hqt;
+	qhd_t *hdr = 0;
+
+	sys_lock();
+	{
+		hqt = System.cur->hqt;
+
+		if (hqt && hqt->limit && size > hqt->limit - hqt->used)
+			hqt->fails++;						// rejected without searching the heap
+		else
+		{
+			hdr = priv_heap_alloc(sizeof(qhd_t) + size);
+
+			if (hdr)
+			{
+				hdr->hqt  = hqt;
+				hdr->size = size;
+				hdr = hdr + 1;
+
+				if (hqt)
+				{
+					hqt->used += size;
+					if (hqt->peak < hqt->used)
+						hqt->peak = hqt->used;
+				}
+			}
+		}
+	}
+	sys_unlock();
+
+	return hdr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_sys_free( void *base )
+{
+	qhd_t *hdr = (qhd_t *) base - 1;
+
+	sys_lock();
+	{
+		if (hdr->hqt)							// charged to the owner recorded at allocation time
+			hdr->hqt->used -= hdr->size;
+
+		priv_heap_free(hdr);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_sys_quota( tsk_t *tsk, hqt_t *hqt )
+{
+	assert(tsk);
+
+	sys_lock();
+	{
+		tsk->hqt = hqt;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_sys_quotaInfo( hqt_t *hqt, hqt_t *info )
+{
+	assert(hqt);
+	assert(info);
+
+	sys_lock();
+	{
+		*info = *hqt;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#else
+
+#define priv_sys_alloc priv_heap_alloc
+#define priv_sys_free  priv_heap_free
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+/* -------------------------------------------------------------------------- */
+// SYSTEM STATIC POOLS
+/* -------------------------------------------------------------------------- */
+
+#define POOL_COUNT    16                  // max number of memory pools bound to the system allocator
+
+/* -------------------------------------------------------------------------- */
+
+static
+struct { unsigned count; mem_t *mem[POOL_COUNT]; } Pool = { 0, { 0 } };
+
+/* -------------------------------------------------------------------------- */
+
+static
+bool priv_pool_owns( mem_t *mem, void *base )
+{
+	que_t *ptr = mem->data;
+
+	return (que_t *)base >= ptr + MHEAD && (que_t *)base < ptr + mem->limit * (MHEAD + mem->size);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+bool priv_pool_free( void *base )
+{
+	unsigned i;
+
+	for (i = 0; i < Pool.count; i++)
+	{
+		if (priv_pool_owns(Pool.mem[i], base))
+		{
+			mem_give(Pool.mem[i], base);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_sys_bind( mem_t *mem )
+{
+	assert(mem);
+
+	sys_lock();
+	{
+		assert(Pool.count < POOL_COUNT);
+
+		mem_bind(mem);
+		Pool.mem[Pool.count++] = mem;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+// SYSTEM SLAB ALLOCATOR
+/* -------------------------------------------------------------------------- */
+
+#if OS_HEAP_SLAB
+
+/* -------------------------------------------------------------------------- */
+
+#define SLAB_COUNT     3                  // number of size classes
+#define SLAB_SIZE( i ) (16U << (i))       // size classes: 16, 32, 64 bytes
+
+/* -------------------------------------------------------------------------- */
+
+static void *Slab16[OS_HEAP_SLAB * (MHEAD + MSIZE(SLAB_SIZE(0)))];
+static void *Slab32[OS_HEAP_SLAB * (MHEAD + MSIZE(SLAB_SIZE(1)))];
+static void *Slab64[OS_HEAP_SLAB * (MHEAD + MSIZE(SLAB_SIZE(2)))];
+
+static
+struct { bool init; mem_t mem[SLAB_COUNT]; } Slab =
+       { false, { _MEM_INIT(OS_HEAP_SLAB, SLAB_SIZE(0), Slab16),
+                  _MEM_INIT(OS_HEAP_SLAB, SLAB_SIZE(1), Slab32),
+                  _MEM_INIT(OS_HEAP_SLAB, SLAB_SIZE(2), Slab64) } };
+
+/* -------------------------------------------------------------------------- */
+
+void *core_sys_alloc( size_t size )
+{
+	void   * base = 0;
+	unsigned i;
+
+	assert(size);
+
+	sys_lock();
+	{
+		if (!Slab.init)
+		{
+			Slab.init = true;
+			for (i = 0; i < SLAB_COUNT; i++)
+				core_sys_bind(&Slab.mem[i]);
+		}
+
+		for (i = 0; i < SLAB_COUNT; i++)
+		{
+			if (size > SLAB_SIZE(i))
+				continue;
+
+			if (mem_take(&Slab.mem[i], &base) == E_SUCCESS)
+				base = memset(base, 0, SLAB_SIZE(i));
+			break;						// size class found; use the heap if the pool is empty
+		}
+
+		if (base == 0)
+			base = priv_sys_alloc(size);
+	}
+	sys_unlock();
+
+	return base;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#else
+
+/* -------------------------------------------------------------------------- */
+
+void *core_sys_alloc( size_t size )
+{
+	return priv_sys_alloc(size);
+}
+
+/* -------------------------------------------------------------------------- */
+
 #endif
 
 /* -------------------------------------------------------------------------- */
+
+void core_sys_free( void *base )
+{
+	if (base == 0)
+		return;
+
+	if (priv_pool_free(base))			// memory object was returned to its pool
+		return;
+
+	priv_sys_free(base);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_sys_info( hst_t *info )
+{
+	assert(info);
+
+	priv_heap_info(info);
+}
+
+/* -------------------------------------------------------------------------- */
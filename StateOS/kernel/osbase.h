@@ -72,6 +72,7 @@ typedef uint64_t     cnt_t;
 typedef struct __tmr tmr_t, * const tmr_id; // timer
 typedef struct __tsk tsk_t, * const tsk_id; // task
 typedef         void fun_t(); // timer/task procedure
+typedef         void act_t( void * ); // worker pool job procedure
 
 /* -------------------------------------------------------------------------- */
 
@@ -90,15 +91,63 @@ typedef struct __obj
 
 /* -------------------------------------------------------------------------- */
 
+// data fragment (scatter / gather transfer)
+
+typedef struct __iov
+{
+	void   * data;  // fragment data
+	unsigned size;  // fragment size in bytes
+
+}	iov_t;
+
+/* -------------------------------------------------------------------------- */
+
+// system heap statistics
+
+typedef struct __hst
+{
+	size_t   size;    // size of the system heap in bytes
+	size_t   free;    // number of free bytes (including headers of free segments)
+	size_t   largest; // size of the largest memory segment that can be allocated
+	size_t   peak;    // maximum number of used bytes so far
+	unsigned blocks;  // number of free memory segments (fragments)
+	unsigned allocs;  // number of allocated memory segments
+
+}	hst_t;
+
+/* -------------------------------------------------------------------------- */
+
+// system heap quota (owner of memory segments allocated from the system heap)
+
+typedef struct __hqt
+{
+	size_t   limit;   // maximum number of live bytes of the owner, 0: no limit
+	size_t   used;    // number of live bytes allocated by the owner
+	size_t   peak;    // maximum number of live bytes so far
+	unsigned fails;   // number of allocations rejected by the quota
+
+}	hqt_t;
+
+/* -------------------------------------------------------------------------- */
+
 // system data
 
 typedef struct __sys
 {
 	tsk_t  * cur;   // pointer to the current task control block
+	unsigned tasks; // number of started tasks (including idle task)
+	unsigned drops; // number of tasks removed from the registry of started tasks
 #if HW_TIMER_SIZE < OS_TIMER_SIZE
 	volatile
 	cnt_t    cnt;   // system timer counter
 #endif
+#if OS_TIMER_SIZE < 64
+	volatile
+	uint32_t epoch; // extension of system time to 64 bits: counted halves (tick mode) or periods (tick-less mode) of the counter
+#if HW_TIMER_SIZE
+	cnt_t    last;  // system time at the last extension
+#endif
+#endif
 }	sys_t;
 
 /* -------------------------------------------------------------------------- */
@@ -124,15 +173,20 @@ typedef struct __sys
 
 /* -------------------------------------------------------------------------- */
 
-typedef enum __tid
+enum __tid
 {
 	ID_STOPPED = 0, // task or timer stopped
 	ID_READY,       // task ready to run
 	ID_DELAYED,     // task in the delayed state
 	ID_TIMER,       // timer in the countdown state
 	ID_IDLE         // idle process
+};
 
-}	tid_t;
+#if OS_COMPACT_TCB
+typedef uint8_t      tid_t; // packed with the task priorities
+#else
+typedef enum __tid   tid_t;
+#endif
 
 /* -------------------------------------------------------------------------- */
 
@@ -32,30 +32,264 @@
 #include "oskernel.h"
 #include "inc/ostimer.h"
 #include "inc/ostask.h"
+#if OS_TASK_REENT
+#include <reent.h>
+#endif
 
 /* -------------------------------------------------------------------------- */
 // SYSTEM INTERNAL SERVICES
 /* -------------------------------------------------------------------------- */
 
+#if OS_STACK_MONITOR
+
+#define STK_PAINT 0xFFFFFFFFU
+#define STK_CHUNK 32U
+
+static struct { tsk_t *tsk; uint32_t *ptr; } Scan = { 0, 0 }; // task stack being examined by the idle task
+
+/* -------------------------------------------------------------------------- */
+
+static
+bool priv_stk_match( tsk_t *tsk, tsk_t **fst, bool *fnd )
+{
+	if (tsk->mark == 0)  // task stack is not painted (main and idle task)
+		return false;
+
+	if (*fnd)
+		return true;
+
+	if (*fst == 0)
+		*fst = tsk;
+
+	if (tsk == Scan.tsk)
+	{
+		if (Scan.ptr)    // examination of the task stack is not finished yet
+			return true;
+		*fnd = true;
+	}
+
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+tsk_t *priv_stk_next( void )
+{
+	tsk_t *tsk;
+	tmr_t *tmr;
+#if OS_TIMER_WHEEL
+	obj_t *spk;
+#endif
+	tsk_t *fst = 0;
+	bool   fnd = false;
+
+	for (tsk = IDLE.obj.next; tsk != &IDLE; tsk = tsk->obj.next)
+		if (priv_stk_match(tsk, &fst, &fnd))
+			return tsk;
+
+	for (tmr = WAIT.obj.next; tmr != &WAIT; tmr = tmr->obj.next)
+		if (tmr->id == ID_DELAYED && priv_stk_match((tsk_t *)tmr, &fst, &fnd))
+			return (tsk_t *)tmr;
+#if OS_TIMER_WHEEL
+	for (spk = WHEEL; spk < WHEEL + OS_TIMER_WHEEL; spk++)
+		if (spk->next)
+			for (tmr = spk->next; tmr != (void *)spk; tmr = tmr->obj.next)
+				if (tmr->id == ID_DELAYED && priv_stk_match((tsk_t *)tmr, &fst, &fnd))
+					return (tsk_t *)tmr;
+#endif
+	return fst;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_stk_monitor( void )
+{
+	tsk_t *tsk;
+
+	port_set_lock();
+	{
+		tsk = priv_stk_next();
+
+		if (tsk)
+		{
+			if (tsk != Scan.tsk || Scan.ptr == 0)
+			{
+				Scan.tsk = tsk;
+				Scan.ptr = core_stk_base(tsk);
+			}
+
+			Scan.ptr = core_stk_scan(tsk, Scan.ptr, STK_CHUNK);
+		}
+	}
+	port_clr_lock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint32_t *core_stk_scan( tsk_t *tsk, uint32_t *ptr, unsigned cnt )
+{
+	while (ptr < (uint32_t *)tsk->mark)
+	{
+		if (*ptr != STK_PAINT)
+		{
+			tsk->mark = ptr;
+			break;
+		}
+
+		ptr++;
+
+		if (--cnt == 0)
+			return ptr;
+	}
+
+	return 0;
+}
+
+#else
+
+#define priv_stk_monitor()
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TIMER_WHEEL == 0
+
+// return time remaining until the timers queue must be serviced, starting from the first timer 'tmr' (not expired)
+// expirations falling within the slack window of an earlier timer are serviced together with it
+
+static
+cnt_t priv_tmr_window( tmr_t *tmr, cnt_t now )
+{
+	cnt_t lim = CNT_MAX;
+	cnt_t due, end;
+
+	for (; tmr->delay != INFINITE; tmr = tmr->obj.next)
+	{
+		due = (cnt_t)(tmr->start + tmr->delay - now);
+		if (due > lim)
+			break;
+		end = due;
+		if (tmr->id == ID_TIMER && (end = due + tmr->slack) < due)
+			end = CNT_MAX;
+		if (lim > end)
+			lim = end;
+	}
+
+	return lim;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// return number of ticks the system timer can be suppressed for, INFINITE: no timeout is pending
+
+static
+cnt_t priv_tmr_sleep( void )
+{
+	tmr_t *tmr = WAIT.obj.next;
+	cnt_t  now = core_sys_time();
+	cnt_t  cnt = (cnt_t)(tmr->start + tmr->delay - now);
+
+	if (tmr->delay == INFINITE)
+		return INFINITE;
+
+	if (cnt > tmr->delay)
+		return 0;
+
+	return priv_tmr_window(tmr, now);
+}
+
+#endif//OS_TIMER_WHEEL == 0
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TICKLESS_IDLE
+
+static
+void priv_tsk_idle( void )
+{
+	cnt_t cnt;
+	bool  pend;
+
+	priv_stk_monitor();
+#if OS_RCU_SIZE
+	core_rcu_reclaim();
+#endif
+	pend = core_idh_handler();
+#if OS_HEAP_COALESCE
+	if (core_sys_coalesce())				// pending merges of the system heap: next pass without sleeping
+		return;
+#endif
+
+	port_set_lock();
+	{
+		cnt = IDLE.obj.next == &IDLE && !pend ? priv_tmr_sleep() : 0; // pending idle hooks are served in the next tick
+
+#if OS_TASK_ENERGY
+		core_cur_account();
+		cnt = port_sys_sleep(cnt);
+		core_cur_sleep(cnt);
+		System.cnt += cnt;
+#else
+		System.cnt += port_sys_sleep(cnt);
+#endif
+	}
+	port_clr_lock();
+}
+
+#else
+
 static
 void priv_tsk_idle( void )
 {
+	priv_stk_monitor();
+#if OS_RCU_SIZE
+	core_rcu_reclaim();
+#endif
+	core_idh_handler();
+#if OS_HEAP_COALESCE
+	if (core_sys_coalesce())				// pending merges of the system heap: next pass without sleeping
+		return;
+#endif
+
 	__WFI();
 }
 
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 static
 void priv_ctx_switchNow( void )
 {
+#if OS_LOCK_PROFILE
+	lpm_t *prof = LockCur;
+	if (prof)
+	{
+		// the task blocks inside the critical section: close the current masked interval
+		uint32_t time = port_cyc_time() - prof->stamp;
+		if (prof->time < time)
+			prof->time = time;
+		LockCur = 0;
+	}
+#endif
 	port_ctx_switch();
 	port_clr_lock(); port_set_barrier();
 	port_set_lock();
+#if OS_LOCK_PROFILE
+	if (prof)
+	{
+		prof->stamp = port_cyc_time();
+		LockCur = prof;
+	}
+#endif
 }
 
 /* -------------------------------------------------------------------------- */
 
-static
+static __RAMFUNC
 void priv_rdy_insert( obj_t *obj, obj_t *nxt )
 {
 	obj_t *prv = nxt->prev;
@@ -68,7 +302,7 @@ void priv_rdy_insert( obj_t *obj, obj_t *nxt )
 
 /* -------------------------------------------------------------------------- */
 
-static
+static __RAMFUNC
 void priv_rdy_remove( obj_t *obj )
 {
 	obj_t *nxt = obj->next;
@@ -82,10 +316,93 @@ void priv_rdy_remove( obj_t *obj )
 // SYSTEM TIMER SERVICES
 /* -------------------------------------------------------------------------- */
 
-tmr_t WAIT = { .obj={ .prev=&WAIT.obj, .next=&WAIT.obj }, .id=ID_TIMER, .delay=INFINITE }; // timers queue
+__FAST_DATA tmr_t WAIT = { .obj={ .prev=&WAIT.obj, .next=&WAIT.obj }, .id=ID_TIMER, .delay=INFINITE }; // timers queue
+
+#if OS_TIMER_TASK
+__FAST_DATA tmr_t PEND = { .obj={ .prev=&PEND.obj, .next=&PEND.obj }, .id=ID_TIMER, .delay=INFINITE }; // expired timers queue of the timer service task
+#endif
+
+#if OS_TASK_PARTITION
+static tmr_t PrtTimer = { .id=ID_STOPPED, .delay=INFINITE }; // window timer of the partition scheduler
+#endif
+
+#if OS_TIME_TRIGGER
+static tmr_t TteTimer = { .id=ID_STOPPED, .delay=INFINITE }; // release timer of the time-triggered executive
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TIMER_WHEEL
+
+__FAST_DATA obj_t WHEEL[OS_TIMER_WHEEL]; // timers wheel
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_tmr_due( tmr_t *tmr )
+{
+	tmr_t *nxt = WAIT.obj.next;
+
+	while (nxt->delay != INFINITE)
+		nxt = nxt->obj.next;
+
+	priv_rdy_insert(&tmr->obj, &nxt->obj);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_tmr_insert( tmr_t *tmr, tid_t id )
+{
+	obj_t *spk;
+	cnt_t  cnt = (cnt_t)(tmr->start + tmr->delay - core_sys_time());
+	tmr->id = id;
+
+	if (tmr->delay == INFINITE)
+	{
+		priv_rdy_insert(&tmr->obj, &WAIT.obj);
+		return;
+	}
+
+	if (cnt == 0 || cnt > tmr->delay)
+	{
+		priv_tmr_due(tmr); // timer finished counting
+		return;
+	}
+
+	spk = &WHEEL[(cnt_t)(tmr->start + tmr->delay) & (OS_TIMER_WHEEL - 1)];
+	if (spk->next == 0)
+		spk->prev = spk->next = spk;
+
+	priv_rdy_insert(&tmr->obj, spk);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static __RAMFUNC
+void priv_tmr_rotate( void )
+{
+	tmr_t *tmr, *nxt;
+	obj_t *spk = &WHEEL[core_sys_time() & (OS_TIMER_WHEEL - 1)];
+
+	if (spk->next == 0)
+		return;
+
+	for (tmr = spk->next; tmr != (void *)spk; tmr = nxt)
+	{
+		nxt = tmr->obj.next;
+		if (tmr->delay < (cnt_t)(core_sys_time() - tmr->start + 1))
+		{
+			priv_rdy_remove(&tmr->obj);
+			priv_tmr_due(tmr);
+		}
+	}
+}
 
 /* -------------------------------------------------------------------------- */
 
+#else
+
 static
 void priv_tmr_insert( tmr_t *tmr, tid_t id )
 {
@@ -99,6 +416,8 @@ void priv_tmr_insert( tmr_t *tmr, tid_t id )
 	priv_rdy_insert(&tmr->obj, &nxt->obj);
 }
 
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 static
@@ -125,20 +444,61 @@ void core_tmr_remove( tmr_t *tmr )
 
 /* -------------------------------------------------------------------------- */
 
+tmr_t *core_tmr_merge( tmr_t *tmr, tid_t id, tmr_t *hint )
+{
+#if OS_TIMER_WHEEL
+	(void) hint;
+
+	priv_tmr_insert(tmr, id); // insertion into the wheel doesn't search the queue
+	return 0;
+#else
+	tmr_t *nxt = &WAIT;
+	tmr->id = id;
+
+	if (tmr->delay == INFINITE)
+	{
+		priv_rdy_insert(&tmr->obj, &WAIT.obj);
+		return hint;
+	}
+
+	if (hint != 0 && hint->delay <= (cnt_t)(tmr->start + tmr->delay - hint->start))
+		nxt = hint; // the hint doesn't expire after the timer
+
+	do nxt = nxt->obj.next;
+	while (nxt->delay < (cnt_t)(tmr->start + tmr->delay - nxt->start));
+
+	priv_rdy_insert(&tmr->obj, &nxt->obj);
+	return tmr;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tmr_force( void )
+{
+	port_tmr_force();
+}
+
+/* -------------------------------------------------------------------------- */
+
 #if HW_TIMER_SIZE
 
-static
+static __RAMFUNC
 bool priv_tmr_expired( tmr_t *tmr )
 {
+	cnt_t now;
+
 	port_tmr_stop();
 
 	if (tmr->delay == INFINITE)
 	return false; // return if timer counting indefinitely
 
-	if (tmr->delay <= (cnt_t)(core_sys_time() - tmr->start))
+	now = core_sys_time();
+
+	if (tmr->delay <= (cnt_t)(now - tmr->start))
 	return true;  // return if timer finished counting
 
-	port_tmr_start((cnt_t)(tmr->start + tmr->delay));
+	port_tmr_start((cnt_t)(now + priv_tmr_window(tmr, now))); // the latest time common to slack windows
 
 	if (tmr->delay >  (cnt_t)(core_sys_time() - tmr->start))
 	return false; // return if timer still counts
@@ -152,7 +512,7 @@ bool priv_tmr_expired( tmr_t *tmr )
 
 #else
 
-static
+static __RAMFUNC
 bool priv_tmr_expired( tmr_t *tmr )
 {
 	if (tmr->delay >= (cnt_t)(core_sys_time() - tmr->start + 1))
@@ -165,11 +525,24 @@ bool priv_tmr_expired( tmr_t *tmr )
 
 /* -------------------------------------------------------------------------- */
 
-static
+static __RAMFUNC
 void priv_tmr_wakeup( tmr_t *tmr, unsigned event )
 {
+#if OS_TIMER_TASK
+	if (tmr->action || tmr->state)
+	{
+		priv_tmr_remove(tmr); // the callback is executed by the timer service task
+		priv_rdy_insert(&tmr->obj, &PEND.obj);
+		core_one_wakeup(&PEND, event);
+		return;
+	}
+#else
+	if (tmr->action)
+		tmr->action(tmr->arg);
+	else
 	if (tmr->state)
 		tmr->state();
+#endif
 
 	core_tmr_remove(tmr);
 	if (tmr->delay >= (cnt_t)(core_sys_time() - tmr->start + 1))
@@ -180,6 +553,24 @@ void priv_tmr_wakeup( tmr_t *tmr, unsigned event )
 
 /* -------------------------------------------------------------------------- */
 
+#if HW_TIMER_SIZE && OS_TIMER_SIZE < 64
+
+uint64_t core_sys_time64( void )
+{
+	cnt_t now = core_sys_time();
+
+	if (now < System.last)
+		System.epoch++; // the counter has wrapped around
+	System.last = now;
+
+	return ((uint64_t)System.epoch << OS_TIMER_SIZE) | now;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+__RAMFUNC
 void core_tmr_handler( void )
 {
 	tmr_t *tmr;
@@ -188,12 +579,33 @@ void core_tmr_handler( void )
 
 	port_set_lock();
 	{
+#if HW_TIMER_SIZE && OS_TIMER_SIZE < 64
+		core_sys_time64(); // extend 64-bit system time
+#endif
+#if OS_TIMER_WHEEL
+		priv_tmr_rotate();
+#endif
 		while (priv_tmr_expired(tmr = WAIT.obj.next))
 		{
 			tmr->start += tmr->delay;
 
 			if (tmr->id == ID_TIMER)
 			{
+#if OS_TASK_PARTITION
+				if (tmr == &PrtTimer)
+				{
+					core_prt_handler(); // the window has elapsed
+					continue;
+				}
+#endif
+#if OS_TIME_TRIGGER
+				if (tmr == &TteTimer)
+				{
+					core_tte_handler(); // activities are released
+					continue;
+				}
+#endif
+				core_trc_event(TRC_TMR_EXPIRE, tmr, 0);
 				tmr->delay = tmr->period;
 
 				priv_tmr_wakeup((tmr_t *)tmr, E_SUCCESS);
@@ -205,16 +617,80 @@ void core_tmr_handler( void )
 	port_clr_lock();
 }
 
+#if OS_TIMER_TASK
+
+void core_tmr_service( void )
+{
+	tmr_t *tmr;
+	fun_t *fun;
+	act_t *act;
+	void  *arg;
+
+	for (;;)
+	{
+		port_set_lock();
+		{
+			while ((tmr = PEND.obj.next) == &PEND)
+				core_tsk_waitFor(&PEND, INFINITE);
+			fun = tmr->state;
+			act = tmr->action;
+			arg = tmr->arg;
+		}
+		port_clr_lock();
+
+		// the timer stays at the head of the queue, so the callback can use tmr_thisISR
+		if (act)
+			act(arg);
+		else
+			fun();
+
+		port_set_lock();
+		{
+			if (tmr == PEND.obj.next) // the timer has not been stopped or restarted
+			{
+				core_tmr_remove(tmr);
+				if (tmr->delay != 0)
+				{
+					while (tmr->delay != INFINITE && tmr->delay < (cnt_t)(core_sys_time() - tmr->start + 1))
+						tmr->start += tmr->delay; // expirations missed by the late callback are merged
+					core_tmr_insert(tmr, ID_TIMER);
+				}
+			}
+			core_all_wakeup(tmr, E_SUCCESS);
+		}
+		port_clr_lock();
+	}
+}
+
+#endif
+
 /* -------------------------------------------------------------------------- */
 // SYSTEM TASK SERVICES
 /* -------------------------------------------------------------------------- */
 
+#if OS_ISR_STACK
+
+unsigned core_isr_used( void )
+{
+	uint32_t *ptr = (uint32_t *)port_isr_stack;
+	uint32_t *top = (uint32_t *)(port_isr_stack + SSIZE(OS_ISR_STACK));
+
+	while (ptr < top && *ptr == 0xFFFFFFFFU)
+		ptr++;
+
+	return (unsigned)((size_t)top - (size_t)ptr);
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
 #ifndef MAIN_TOP
-static  stk_t     MAIN_STK[SSIZE(OS_STACK_SIZE)];
+static  __FAST_NOINIT stk_t MAIN_STK[SSIZE(OS_STACK_SIZE)];
 #define MAIN_TOP (MAIN_STK+SSIZE(OS_STACK_SIZE))
 #endif
 
-static  union  { stk_t STK[SSIZE(OS_IDLE_STACK)];
+static  __FAST_DATA union { stk_t STK[SSIZE(OS_IDLE_STACK)];
         struct { char  stk[ABOVE(OS_IDLE_STACK)-sizeof(ctx_t)]; ctx_t ctx; } CTX; }
         IDLE_STACK = { .CTX = { .ctx = _CTX_INIT(core_tsk_loop) } };
 #define IDLE_STK (void *)(&IDLE_STACK)
@@ -222,347 +698,1735 @@ static  union  { stk_t STK[SSIZE(OS_IDLE_STACK)];
 #define IDLE_TOP (stk_t*)(&IDLE_STACK)+SSIZE(OS_IDLE_STACK)
 #define IDLE_SP  (void *)(&IDLE_STACK.CTX.ctx)
 
-tsk_t MAIN = { .obj={ .prev=&IDLE.obj, .next=&IDLE.obj }, .id=ID_READY, .top=MAIN_TOP, .basic=OS_MAIN_PRIO, .prio=OS_MAIN_PRIO }; // main task
-tsk_t IDLE = { .obj={ .prev=&MAIN.obj, .next=&MAIN.obj }, .id=ID_IDLE, .state=priv_tsk_idle, .stack=IDLE_STK, .top=IDLE_TOP, .sp=IDLE_SP }; // idle task and tasks queue
-sys_t System = { .cur=&MAIN };
+__FAST_DATA tsk_t MAIN = { .obj={ .prev=&IDLE.obj, .next=&IDLE.obj }, .id=ID_READY, .top=MAIN_TOP, .basic=OS_MAIN_PRIO, .prio=OS_MAIN_PRIO, .reg={ .prev=&IDLE, .next=&IDLE } }; // main task
+__FAST_DATA tsk_t IDLE = { .obj={ .prev=&MAIN.obj, .next=&MAIN.obj }, .id=ID_IDLE, .state=priv_tsk_idle, .stack=IDLE_STK, .top=IDLE_TOP, .sp=IDLE_SP, .reg={ .prev=&MAIN, .next=&MAIN } }; // idle task, tasks queue and registry of started tasks
+__FAST_DATA sys_t System = { .cur=&MAIN, .tasks=2 };
 
 /* -------------------------------------------------------------------------- */
 
-static
-void priv_tsk_insert( tsk_t *tsk )
-{
-	tsk_t *nxt = &IDLE;
-#if OS_ROBIN && HW_TIMER_SIZE == 0
-	tsk->slice = 0;
+#if OS_TRACE_SIZE
+
+trb_t TRACE = { .magic=TRC_MAGIC, .size=OS_TRACE_SIZE, .unit=TRC_UNIT }; // kernel events trace buffer
+
 #endif
-	if (tsk->prio)
-		do nxt = nxt->obj.next;
-		while (tsk->prio <= nxt->prio);
 
-	priv_rdy_insert(&tsk->obj, &nxt->obj);
-}
+#if OS_PROFILE_SIZE
+
+prb_t PROFILE = { .magic=PRF_MAGIC, .size=OS_PROFILE_SIZE, .rate=OS_FREQUENCY }; // statistical pc-sampling profiler buffer
+
+#endif
+
+#if OS_TRACE_ITM
+
+volatile uint32_t TRACE_LOST = 0; // number of kernel events not streamed through ITM
+
+#endif
 
 /* -------------------------------------------------------------------------- */
 
-static
-void priv_tsk_remove( tsk_t *tsk )
+#if OS_EDF_PRIO
+
+// return true if task 'tsk' of the EDF priority level must be placed before task 'nxt' in the ready queue
+// (its deadline is earlier; tasks with equal deadlines are fifo)
+static __RAMFUNC
+bool priv_edf_before( tsk_t *tsk, tsk_t *nxt )
 {
-	priv_rdy_remove(&tsk->obj);
+	return nxt->prio == OS_EDF_PRIO && (cnt_t)(tsk->deadline - nxt->deadline) > ((CNT_MAX)>>1);
 }
 
+#endif
+
 /* -------------------------------------------------------------------------- */
 
-void core_tsk_insert( tsk_t *tsk )
+#if OS_PRIO_BITMAP
+
+#define PRIO_WORDS (((OS_PRIO_BITMAP)+31)/32)
+
+static __FAST_DATA struct { uint32_t grp; uint32_t map[PRIO_WORDS]; tsk_t *head[OS_PRIO_BITMAP]; } Ready = // ready bitmap and heads of priority levels
+       { .grp = 1U << (OS_MAIN_PRIO / 32), .map = { [OS_MAIN_PRIO / 32] = 1U << (OS_MAIN_PRIO % 32) }, .head = { [OS_MAIN_PRIO] = &MAIN } };
+
+/* -------------------------------------------------------------------------- */
+
+static __RAMFUNC
+tsk_t *priv_prio_below( unsigned prio )
 {
-	tsk->id = ID_READY;
-	priv_tsk_insert(tsk);
-	if (tsk == IDLE.obj.next)
-		port_ctx_switch();
+	unsigned idx = prio / 32;
+	uint32_t msk = Ready.map[idx] & ((1U << (prio % 32)) - 1);
+
+	if (msk == 0)
+	{
+		msk = Ready.grp & ((1U << idx) - 1);
+		if (msk == 0)
+			return &IDLE; // there is no ready task with priority lower than 'prio'
+		idx = port_get_msb(msk);
+		msk = Ready.map[idx];
+	}
+
+	return Ready.head[idx * 32 + port_get_msb(msk)];
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_tsk_remove( tsk_t *tsk )
+static __RAMFUNC
+void priv_prio_set( tsk_t *tsk )
 {
-	tsk->id = ID_STOPPED;
-	priv_tsk_remove(tsk);
-	if (tsk == System.cur)
-		priv_ctx_switchNow();
+	unsigned prio = tsk->prio;
+
+	assert(prio < OS_PRIO_BITMAP);
+
+	Ready.head[prio] = tsk;
+	Ready.map[prio / 32] |= 1U << (prio % 32);
+	Ready.grp |= 1U << (prio / 32);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_ctx_init( tsk_t *tsk )
+static __RAMFUNC
+void priv_prio_clr( tsk_t *tsk )
 {
-#ifdef DEBUG
-	memset(tsk->stack, 0xFF, (size_t)tsk->top - (size_t)tsk->stack);
-#endif
-	tsk->sp = (ctx_t *)tsk->top - 1;
-	port_ctx_init(tsk->sp, core_tsk_loop);
+	unsigned prio = tsk->prio;
+	tsk_t *nxt = tsk->obj.next;
+
+	if (Ready.head[prio] != tsk)
+		return;
+
+	if (nxt != &IDLE && nxt->prio == prio)
+		Ready.head[prio] = nxt;
+	else
+	if ((Ready.map[prio / 32] &= ~(1U << (prio % 32))) == 0)
+		Ready.grp &= ~(1U << (prio / 32));
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_ctx_switch( void )
+static
+bool priv_prio_ready( unsigned prio )
 {
-	tsk_t *cur = IDLE.obj.next;
-	tsk_t *nxt = cur->obj.next;
-	if (nxt->prio == cur->prio)
-		port_ctx_switch();
+	return (Ready.map[prio / 32] & (1U << (prio % 32))) != 0;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_tsk_loop( void )
+static __RAMFUNC
+void priv_tsk_insert( tsk_t *tsk )
 {
-	for (;;)
+	tsk_t *nxt = priv_prio_below(tsk->prio);
+#if ROBIN_TICK
+	tsk->slice = 0;
+#endif
+#if OS_EDF_PRIO
+	if (tsk->prio == OS_EDF_PRIO && priv_prio_ready(OS_EDF_PRIO))
 	{
-		port_clr_lock();
-		System.cur->state();
-		port_set_lock();
-		core_ctx_switch();
+		nxt = Ready.head[OS_EDF_PRIO];
+		if (priv_edf_before(tsk, nxt))
+		{
+			priv_rdy_insert(&tsk->obj, &nxt->obj);
+			priv_prio_set(tsk);
+			return;
+		}
+		do nxt = nxt->obj.next;
+		while (nxt->prio == OS_EDF_PRIO && !priv_edf_before(tsk, nxt));
 	}
+#endif
+	priv_rdy_insert(&tsk->obj, &nxt->obj);
+	if (!priv_prio_ready(tsk->prio))
+		priv_prio_set(tsk);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_tsk_append( tsk_t *tsk, void *obj )
+static
+void priv_tsk_push( tsk_t *tsk )
 {
-	tsk_t *prv;
-	tsk_t *nxt = obj;
-	tsk->guard = obj;
+	tsk_t *nxt = priv_prio_ready(tsk->prio) ? Ready.head[tsk->prio] : priv_prio_below(tsk->prio);
 
-	do prv = nxt, nxt = nxt->obj.queue;
-	while (nxt && tsk->prio <= nxt->prio);
-
-	if (nxt)
-	nxt->back = tsk;
-	tsk->back = prv;
-	tsk->obj.queue = nxt;
-	prv->obj.queue = tsk;
+	priv_rdy_insert(&tsk->obj, &nxt->obj);
+	priv_prio_set(tsk);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_tsk_unlink( tsk_t *tsk, unsigned event )
+static __RAMFUNC
+void priv_tsk_remove( tsk_t *tsk )
 {
-	tsk_t *prv = tsk->back;
-	tsk_t *nxt = tsk->obj.queue;
-	tsk->event = event;
-
-	if (nxt)
-	nxt->back = prv;
-	prv->obj.queue = nxt;
-	tsk->obj.queue = 0; // necessary because of tsk_wait[Until|For] functions
-	tsk->guard = 0;
+	priv_prio_clr(tsk);
+	priv_rdy_remove(&tsk->obj);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_tsk_transfer( tsk_t *tsk, void *obj )
+#else
+
+static __RAMFUNC
+void priv_tsk_insert( tsk_t *tsk )
 {
-	core_tsk_unlink(tsk, tsk->event);
-	core_tsk_append(tsk, obj);
+	tsk_t *nxt = &IDLE;
+#if ROBIN_TICK
+	tsk->slice = 0;
+#endif
+	if (tsk->prio)
+		do nxt = nxt->obj.next;
+#if OS_EDF_PRIO
+		while (tsk->prio < nxt->prio || (tsk->prio == nxt->prio && !(tsk->prio == OS_EDF_PRIO && priv_edf_before(tsk, nxt))));
+#else
+		while (tsk->prio <= nxt->prio);
+#endif
+
+	priv_rdy_insert(&tsk->obj, &nxt->obj);
 }
 
 /* -------------------------------------------------------------------------- */
 
-static
-void priv_tsk_wait( tsk_t *tsk, void *obj )
+static __RAMFUNC
+void priv_tsk_remove( tsk_t *tsk )
 {
-	assert(!port_isr_inside());
-
-	core_tsk_append((tsk_t *)tsk, obj);
-	priv_tsk_remove((tsk_t *)tsk);
-	core_tmr_insert((tmr_t *)tsk, ID_DELAYED);
+	priv_rdy_remove(&tsk->obj);
 }
 
+#endif
+
+/* -------------------------------------------------------------------------- */
+// PARTITION SCHEDULER
 /* -------------------------------------------------------------------------- */
 
-unsigned core_tsk_waitFor( void *obj, cnt_t delay )
-{
-	tsk_t *cur = System.cur;
+#if OS_TASK_PARTITION
 
-	cur->start = core_sys_time();
-	cur->delay = delay;
+// the ready queue holds only the ready tasks of the partition of the current window and unpartitioned tasks,
+// ready tasks of other partitions are parked until the window of their partition
 
-	if (cur->delay == IMMEDIATE)
-		return E_TIMEOUT;
+static struct
+{
+	const
+	pwn_t  * tab;   // windows of the major frame, 0: partition scheduling is stopped
+	unsigned cnt;   // number of windows of the major frame
+	unsigned idx;   // index of the current window
+	unsigned active;// partition of the tasks in the ready queue
+	unsigned next;  // partition of the current window, applied by the next context switch
+	bool     sync;  // the ready queue has to be reconciled with the partition of the current window
+	obj_t    park;  // ready tasks of partitions outside the current window
+}	Prt = { 0, 0, 0, PRT_ALL, PRT_ALL, false, { .prev=&Prt.park, .next=&Prt.park } };
 
-	priv_tsk_wait(cur, obj);
-	priv_ctx_switchNow();
+/* -------------------------------------------------------------------------- */
 
-	return cur->event;
+// return true if the task 'tsk' belongs to a partition outside the current window
+static __RAMFUNC
+bool priv_prt_parked( tsk_t *tsk )
+{
+	return tsk->part != 0 && Prt.active != PRT_ALL && tsk->part != Prt.active;
 }
 
 /* -------------------------------------------------------------------------- */
 
-unsigned core_tsk_waitNext( void *obj, cnt_t delay )
+static
+void priv_prt_park( tsk_t *tsk )
 {
-	tsk_t *cur = System.cur;
-
-	cur->delay = delay;
-
-	if (cur->delay == IMMEDIATE)
-		return E_TIMEOUT;
+	priv_rdy_insert(&tsk->obj, &Prt.park);
+}
 
-	priv_tsk_wait(cur, obj);
-	priv_ctx_switchNow();
+/* -------------------------------------------------------------------------- */
 
-	return cur->event;
+// make 'part' the partition of the current window, the ready queue is reconciled by the context switch handler
+static
+void priv_prt_request( unsigned part )
+{
+	Prt.next = part;
+	Prt.sync = true;
+	port_ctx_switch();
 }
 
 /* -------------------------------------------------------------------------- */
 
-unsigned core_tsk_waitUntil( void *obj, cnt_t time )
+// reconcile the ready queue with the partition of the current window;
+// called by the context switch handler, so the current task is never parked while it is running
+static __RAMFUNC
+void priv_prt_switch( void )
 {
-	tsk_t *cur = System.cur;
-
-	cur->start = core_sys_time();
-	cur->delay = time - cur->start;
+	tsk_t *tsk, *nxt;
 
-	if (cur->delay > ((CNT_MAX)>>1))
-		return E_TIMEOUT;
+	Prt.active = Prt.next;
+	Prt.sync   = false;
 
-	priv_tsk_wait(cur, obj);
-	priv_ctx_switchNow();
+	for (tsk = Prt.park.next; tsk != (void *)&Prt.park; tsk = nxt)
+	{
+		nxt = tsk->obj.next;
+		if (!priv_prt_parked(tsk))
+		{
+			priv_rdy_remove(&tsk->obj);
+			priv_tsk_insert(tsk);
+		}
+	}
 
-	return cur->event;
+	for (tsk = IDLE.obj.next; tsk != &IDLE; tsk = nxt)
+	{
+		nxt = tsk->obj.next;
+		if (priv_prt_parked(tsk))
+		{
+			priv_tsk_remove(tsk);
+			priv_prt_park(tsk);
+		}
+	}
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_tsk_suspend( tsk_t *tsk )
+void core_prt_start( const pwn_t *tab, unsigned cnt )
 {
-	tsk->delay = INFINITE;
+	if (PrtTimer.id != ID_STOPPED)
+		core_tmr_remove(&PrtTimer);
 
-	priv_tsk_wait(tsk, &WAIT);
-	if (tsk == System.cur)
-		priv_ctx_switchNow();
+	Prt.tab = tab;
+	Prt.cnt = cnt;
+	Prt.idx = 0;
+
+	if (tab == 0)
+	{
+		priv_prt_request(PRT_ALL);
+		return;
+	}
+
+	PrtTimer.start = core_sys_time();
+	PrtTimer.delay = tab[0].time;
+	core_tmr_insert(&PrtTimer, ID_TIMER);
+	priv_prt_request(tab[0].part);
 }
 
 /* -------------------------------------------------------------------------- */
 
-tsk_t *core_tsk_wakeup( tsk_t *tsk, unsigned event )
+void core_prt_assign( tsk_t *tsk, unsigned part )
 {
-	if (tsk)
+	tsk->part = part;
+
+	if (tsk == System.cur)
 	{
-		core_tsk_unlink((tsk_t *)tsk, event);
-		core_tmr_remove((tmr_t *)tsk);
-		core_tsk_insert((tsk_t *)tsk);
+		if (priv_prt_parked(tsk))
+			priv_prt_request(Prt.next);
+	}
+	else
+	if (tsk->id == ID_READY)
+	{
+		priv_tsk_remove(tsk);
+		core_tsk_insert(tsk);
 	}
-
-	return tsk;
 }
 
 /* -------------------------------------------------------------------------- */
 
-tsk_t *core_one_wakeup( void *obj, unsigned event )
+unsigned core_prt_active( void )
 {
-	obj_t *lst = obj;
-
-	return core_tsk_wakeup(lst->queue, event);
+	return Prt.next;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_all_wakeup( void *obj, unsigned event )
+__RAMFUNC
+void core_prt_handler( void )
 {
-	obj_t *lst = obj;
+	if (++Prt.idx >= Prt.cnt)
+		Prt.idx = 0;
 
-	while (core_tsk_wakeup(lst->queue, event));
+	// the window timer is restarted from the end of the elapsed window, so the major frame doesn't drift
+	PrtTimer.delay = Prt.tab[Prt.idx].time;
+	priv_tmr_remove(&PrtTimer);
+	priv_tmr_insert(&PrtTimer, ID_TIMER);
+
+	priv_prt_request(Prt.tab[Prt.idx].part);
 }
 
+#endif
+
+/* -------------------------------------------------------------------------- */
+// TIME-TRIGGERED EXECUTIVE
 /* -------------------------------------------------------------------------- */
 
-void core_tsk_prio( tsk_t *tsk, unsigned prio )
+#if OS_TIME_TRIGGER
+
+// activities are executed by the system timer handler at their release times,
+// the release timer is restarted from the previous release time, so the major frame doesn't drift
+
+static struct
 {
-	mtx_t *mtx;
+	const
+	tta_t  * tab;   // activities of the major frame, 0: time-triggered executive is stopped
+	unsigned cnt;   // number of activities of the major frame
+	cnt_t    frame; // duration of the major frame (in ticks)
+	cnt_t    time;  // offset of the next release within the major frame
+	unsigned late;  // number of releases dispatched after their release time
+}	Tte = { 0, 0, 0, 0, 0 };
 
-	if (prio < tsk->basic)
-		prio = tsk->basic;
+/* -------------------------------------------------------------------------- */
 
-	for (mtx = tsk->mtx.list; mtx; mtx = mtx->list)
-		if (mtx->queue)
-			if (prio < mtx->queue->prio)
-				prio = mtx->queue->prio;
+// return the first release at or after offset 'time' of the major frame,
+// the first release of the next major frame (added to the frame duration) if there is none
 
-	if (tsk->prio != prio)
-	{
-		tsk->prio = prio;
+static
+cnt_t priv_tte_next( cnt_t time )
+{
+	const tta_t *act;
+	cnt_t nxt = CNT_MAX;
+	cnt_t rel;
 
-		if (tsk == System.cur)
-		{
-			tsk = tsk->obj.next;
-			if (tsk->prio > prio)
-				port_ctx_switch();
-		}
+	for (act = Tte.tab; act < Tte.tab + Tte.cnt; act++)
+	{
+		if (act->offset >= time)
+			rel = act->offset;
 		else
-		if (tsk->id == ID_READY)
-		{
-			priv_tsk_remove(tsk);
-			core_tsk_insert(tsk);
-		}
+		if (act->period)
+			rel = act->offset + (time - act->offset + act->period - 1) / act->period * act->period;
 		else
-		if (tsk->id == ID_DELAYED)
-		{
-			core_tsk_transfer(tsk, tsk->guard);
-			if (tsk->mtx.tree)
-				core_tsk_prio(tsk->mtx.tree, prio);
-		}
+			continue;
+
+		if (rel < Tte.frame && nxt > rel)
+			nxt = rel;
 	}
+
+	if (nxt == CNT_MAX && time > 0)
+		nxt = Tte.frame + priv_tte_next(0);
+
+	return nxt;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void core_cur_prio( unsigned prio )
+void core_tte_start( const tta_t *tab, unsigned cnt, cnt_t frame )
 {
-	mtx_t *mtx;
-	tsk_t *tsk = System.cur;
+	if (TteTimer.id != ID_STOPPED)
+		core_tmr_remove(&TteTimer);
 
-	if (prio < tsk->basic)
-		prio = tsk->basic;
+	Tte.tab   = tab;
+	Tte.cnt   = cnt;
+	Tte.frame = frame;
 
-	for (mtx = tsk->mtx.list; mtx; mtx = mtx->list)
-		if (mtx->queue)
-			if (prio < mtx->queue->prio)
-				prio = mtx->queue->prio;
+	if (tab == 0)
+		return;
 
-	if (tsk->prio != prio)
-	{
-		tsk->prio = prio;
-		tsk = tsk->obj.next;
-		if (tsk->prio > prio)
-			port_ctx_switch();
-	}
+	Tte.time = priv_tte_next(0);
+	TteTimer.start = core_sys_time();
+	TteTimer.delay = Tte.time;
+	core_tmr_insert(&TteTimer, ID_TIMER);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void *core_tsk_handler( void *sp )
+unsigned core_tte_late( void )
 {
-	tsk_t *cur, *nxt;
-
-	core_stk_assert();
+	return Tte.late;
+}
 
-	port_set_lock();
-	{
-		core_ctx_reset();
+/* -------------------------------------------------------------------------- */
 
-		cur = System.cur;
-		cur->sp = sp;
+__RAMFUNC
+void core_tte_handler( void )
+{
+	const tta_t *act;
+	cnt_t time = Tte.time;
+	cnt_t next = priv_tte_next(time + 1);
 
-		nxt = IDLE.obj.next;
+	if (TteTimer.start != core_sys_time())
+		Tte.late++;
 
-#if OS_ROBIN && HW_TIMER_SIZE == 0
-		if (cur == nxt || (nxt->slice >= (OS_FREQUENCY)/(OS_ROBIN) && (nxt->slice = 0) == 0))
-#else
-		if (cur == nxt)
-#endif
-		{
-			priv_tsk_remove(nxt);
-			priv_tsk_insert(nxt);
-			nxt = IDLE.obj.next;
-		}
+	// the release timer is restarted before the activities are executed, they can't delay the next release
+	TteTimer.delay = next - time;
+	Tte.time = next < Tte.frame ? next : next - Tte.frame;
+	priv_tmr_remove(&TteTimer);
+	priv_tmr_insert(&TteTimer, ID_TIMER);
 
-		System.cur = nxt;
-		sp = nxt->sp;
+	for (act = Tte.tab; act < Tte.tab + Tte.cnt; act++)
+	{
+		if (time == act->offset || (time > act->offset && act->period && (time - act->offset) % act->period == 0))
+			act->fun();
 	}
-	port_clr_lock();
-
-	return sp;
 }
 
+#endif
 /* -------------------------------------------------------------------------- */
 
-#if HW_TIMER_SIZE == 0
-
-void core_sys_tick( void )
+// return true if the current task is no longer the first task of the highest priority
+static
+bool priv_cur_prio( tsk_t *cur, unsigned prio )
 {
-	System.cnt++;
-	core_tmr_handler();
-	#if OS_ROBIN
-	if (++System.cur->slice >= (OS_FREQUENCY)/(OS_ROBIN))
+#if OS_PRIO_BITMAP
+	priv_tsk_remove(cur);
+	cur->prio = prio;
+	priv_tsk_push(cur);
+	return IDLE.obj.next != cur;
+#else
+	tsk_t *nxt = cur->obj.next;
+	cur->prio = prio;
+	return nxt->prio > prio;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+// return true if the current task is no longer the first task of the highest priority
+// the current task of the EDF priority level takes its place among the EDF tasks by its deadline
+static
+bool priv_cur_move( tsk_t *cur, unsigned prio )
+{
+#if OS_EDF_PRIO
+	if (prio == OS_EDF_PRIO)
+	{
+		priv_tsk_remove(cur);
+		cur->prio = prio;
+		priv_tsk_insert(cur);
+		return IDLE.obj.next != cur;
+	}
+#endif
+	return priv_cur_prio(cur, prio);
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_THRESHOLD
+
+static
+bool CurYield = false; // the current task gives way to the tasks held back by its preemption threshold
+
+// return true if the preemption of the current task by the ready task 'nxt' is deferred by the preemption threshold
+static __RAMFUNC
+bool priv_cur_deferred( tsk_t *nxt )
+{
+	tsk_t *cur = System.cur;
+
+#if OS_TASK_PARTITION
+	if (priv_prt_parked(cur))
+		return false;					// the window of the partition of the current task has elapsed
+#endif
+	return cur != &IDLE && cur != nxt && cur->id == ID_READY && nxt->prio <= cur->thresh;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+// force context switch, the first task in ready queue preempts the current task
+// the switch is only pended, even with OS_SYNC_SWITCH: the caller still holds the lock and may wake more tasks
+static
+void priv_ctx_preempt( void )
+{
+#if OS_TASK_THRESHOLD
+	if (priv_cur_deferred(IDLE.obj.next))
+		return;
+#endif
+	port_ctx_switch();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tsk_insert( tsk_t *tsk )
+{
+	core_trc_event(TRC_TSK_INSERT, tsk, tsk->prio);
+	tsk->id = ID_READY;
+#if OS_TASK_PARTITION
+	if (priv_prt_parked(tsk))
+	{
+		priv_prt_park(tsk); // the task waits for the window of its partition
+		return;
+	}
+#endif
+	priv_tsk_insert(tsk);
+	if (tsk == IDLE.obj.next)
+		priv_ctx_preempt();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tsk_remove( tsk_t *tsk )
+{
+	core_trc_event(TRC_TSK_REMOVE, tsk, tsk->prio);
+	tsk->id = ID_STOPPED;
+	priv_tsk_remove(tsk);
+	if (tsk == System.cur)
+		priv_ctx_switchNow();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tsk_register( tsk_t *tsk )
+{
+	tsk_t *prv = IDLE.reg.prev;
+
+	// new tasks are appended at the end, the enumeration in progress is not disturbed
+	tsk->reg.prev = prv;
+	tsk->reg.next = &IDLE;
+	IDLE.reg.prev = tsk;
+	prv->reg.next = tsk;
+
+	System.tasks++;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tsk_unregister( tsk_t *tsk )
+{
+	tsk_t *prv = tsk->reg.prev;
+	tsk_t *nxt = tsk->reg.next;
+
+	nxt->reg.prev = prv;
+	prv->reg.next = nxt;
+
+	System.tasks--;
+	System.drops++;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_ctx_init( tsk_t *tsk )
+{
+#if OS_TASK_RTC
+	if (tsk->rtc)
+	{
+		// the shared stack may hold a live frame of another task of the same priority,
+		// the context will be created by the context switch handler (priv_rtc_dispatch)
+		tsk->rtc = RTC_DONE;
+		tsk->sp = (ctx_t *)tsk->top - 1;
+	}
+	else
+#endif
+	{
+#if defined(DEBUG) || OS_STACK_MONITOR
+		memset(tsk->stack, 0xFF, (size_t)tsk->top - (size_t)tsk->stack);
+#endif
+		tsk->sp = (ctx_t *)tsk->top - 1;
+		port_ctx_init(tsk->sp, core_tsk_loop);
+	}
+#if OS_EDF_PRIO
+	tsk->deadline = core_sys_time();
+#endif
+#if OS_STACK_MONITOR
+	tsk->mark = tsk->sp;
+	if (Scan.tsk == tsk)
+		Scan.ptr = 0;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_ctx_switch( void )
+{
+	tsk_t *cur = IDLE.obj.next;
+	tsk_t *nxt = cur->obj.next;
+#if OS_TASK_THRESHOLD
+	if (cur != System.cur)
+	{
+		// the preemption of the current task has been deferred by its threshold
+		CurYield = true;
+		port_ctx_switch();
+		return;
+	}
+#endif
+	if (nxt->prio == cur->prio)
+		port_ctx_switch();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_RTC
+
+// the state of the run-to-completion task has returned, its frame on the shared stack is released;
+// the task waits for a notification (or yields to the tasks of the same priority, if the notification
+// is already pending) and is resumed with a new context created by the context switch handler
+
+static
+void priv_rtc_complete( tsk_t *cur )
+{
+	tsk_t *nxt = cur->obj.next;
+
+	if (cur->ntf.state == 0)
+	{
+		cur->rtc = RTC_DONE;
+		cur->tmp.ntf.take = 0;
+		core_tsk_waitFor(&cur->ntf, INFINITE); // doesn't return
+	}
+	else
+	if (nxt->prio == cur->prio)
+	{
+		cur->rtc = RTC_DONE;
+		port_ctx_switch();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+static __RAMFUNC
+void priv_rtc_dispatch( tsk_t *nxt )
+{
+	if (nxt->rtc == RTC_DONE)
+	{
+		nxt->rtc = RTC_LIVE;
+		nxt->sp = (ctx_t *)nxt->top - 1;
+		port_ctx_init(nxt->sp, core_tsk_loop);
+	}
+}
+
+#define  priv_rtc_live(tsk) ((tsk)->rtc == RTC_LIVE)
+
+#else
+
+#define  priv_rtc_live(tsk) false
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+void core_tsk_loop( void )
+{
+	for (;;)
+	{
+		port_clr_lock();
+		if (System.cur->action)
+			System.cur->action(System.cur->arg);
+		else
+			System.cur->state();
+		port_set_lock();
+#if OS_TASK_RTC
+		if (System.cur->rtc)
+			priv_rtc_complete(System.cur);
+		else
+#endif
+		core_ctx_switch();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+// the queue of the object is ordered by priority and is fifo for tasks of equal priority;
+// 'back' of the first task points to the last one, so appending a task with priority
+// not higher than that of the last task (e.g. workers of a pool) does not walk the queue
+
+void core_tsk_append( tsk_t *tsk, void *obj )
+{
+	tsk_t *lst = obj;
+	tsk_t *fst = lst->obj.queue;
+	tsk_t *prv;
+	tsk_t *nxt;
+	tsk->guard = obj;
+
+	if (fst == 0)
+	{
+		tsk->back = tsk;
+		tsk->obj.queue = 0;
+		lst->obj.queue = tsk;
+		return;
+	}
+
+	prv = fst->back;
+
+	if (tsk->prio <= prv->prio)
+	{
+		fst->back = tsk;
+		tsk->back = prv;
+		tsk->obj.queue = 0;
+		prv->obj.queue = tsk;
+		return;
+	}
+
+	for (nxt = fst; tsk->prio <= nxt->prio; nxt = nxt->obj.queue);
+
+	prv = nxt == fst ? lst : nxt->back;
+	tsk->back = nxt->back;
+	nxt->back = tsk;
+	tsk->obj.queue = nxt;
+	prv->obj.queue = tsk;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tsk_unlink( tsk_t *tsk, unsigned event )
+{
+	tsk_t *lst = tsk->guard;
+	tsk_t *prv = tsk->back;
+	tsk_t *nxt = tsk->obj.queue;
+	tsk->event = event;
+
+	if (lst->obj.queue == tsk)
+	lst->obj.queue = nxt;
+	else
+	prv->obj.queue = nxt;
+	if (nxt)
+	nxt->back = prv;
+	else
+	if (lst->obj.queue)
+	lst->obj.queue->back = prv;
+	tsk->obj.queue = 0; // necessary because of tsk_wait[Until|For] functions
+	tsk->guard = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tsk_transfer( tsk_t *tsk, void *obj )
+{
+	core_tsk_unlink(tsk, tsk->event);
+	core_tsk_append(tsk, obj);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_tsk_wait( tsk_t *tsk, void *obj )
+{
+	assert(!port_isr_inside());
+#if OS_RCU_SIZE
+	assert(tsk->rcu == 0); // waiting inside a read-side section is not allowed
+#endif
+
+	core_trc_event(TRC_TSK_WAIT, tsk, (uint32_t)(uintptr_t) obj);
+	core_tsk_append((tsk_t *)tsk, obj);
+	priv_tsk_remove((tsk_t *)tsk);
+	core_tmr_insert((tmr_t *)tsk, ID_DELAYED);
+}
+
+/* -------------------------------------------------------------------------- */
+
+unsigned core_tsk_waitFor( void *obj, cnt_t delay )
+{
+	tsk_t *cur = System.cur;
+
+	cur->start = core_sys_time();
+	cur->delay = delay;
+
+	if (cur->delay == IMMEDIATE)
+		return E_TIMEOUT;
+
+	priv_tsk_wait(cur, obj);
+	priv_ctx_switchNow();
+
+	return cur->event;
+}
+
+/* -------------------------------------------------------------------------- */
+
+unsigned core_tsk_waitNext( void *obj, cnt_t delay )
+{
+	tsk_t *cur = System.cur;
+
+	cur->delay = delay;
+
+	if (cur->delay == IMMEDIATE)
+		return E_TIMEOUT;
+
+#if OS_EDF_PRIO
+	if (cur->delay != INFINITE)
+		cur->deadline = cur->start + cur->delay * 2; // the end of the next period
+#endif
+#if OS_PERIOD_STATS
+	if (cur->delay != INFINITE && cur->delay <= (cnt_t)(core_sys_time() - cur->start))
+	{
+		// the next release time has already passed: the task has overrun its period
+		cur->per.overruns++;
+		if (cur->per.hook)
+			cur->per.hook(cur);
+	}
+#endif
+
+	priv_tsk_wait(cur, obj);
+	priv_ctx_switchNow();
+
+#if OS_PERIOD_STATS
+	if (cur->event == E_TIMEOUT)
+	{
+		// the task was released at the end of its countdown (cur->start)
+		cnt_t jitter = (cnt_t)(core_sys_time() - cur->start);
+		if (cur->per.jitter < jitter)
+			cur->per.jitter = jitter;
+	}
+#endif
+
+	return cur->event;
+}
+
+/* -------------------------------------------------------------------------- */
+
+unsigned core_tsk_waitUntil( void *obj, cnt_t time )
+{
+	tsk_t *cur = System.cur;
+
+	cur->start = core_sys_time();
+	cur->delay = time - cur->start;
+
+	if (cur->delay > ((CNT_MAX)>>1))
+		return E_TIMEOUT;
+
+	priv_tsk_wait(cur, obj);
+	priv_ctx_switchNow();
+
+	return cur->event;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tsk_suspend( tsk_t *tsk )
+{
+	tsk->delay = INFINITE;
+
+	priv_tsk_wait(tsk, &WAIT);
+	if (tsk == System.cur)
+		priv_ctx_switchNow();
+}
+
+/* -------------------------------------------------------------------------- */
+
+tsk_t *core_tsk_wakeup( tsk_t *tsk, unsigned event )
+{
+	if (tsk)
+	{
+		core_trc_event(TRC_TSK_WAKEUP, tsk, event);
+#if OS_TASK_LATENCY
+		tsk->lat.stamp = port_cyc_time();
+		tsk->lat.woken = true;
+#endif
+		core_tsk_unlink((tsk_t *)tsk, event);
+		core_tmr_remove((tmr_t *)tsk);
+		core_tsk_insert((tsk_t *)tsk);
+	}
+
+	return tsk;
+}
+
+/* -------------------------------------------------------------------------- */
+
+tsk_t *core_one_wakeup( void *obj, unsigned event )
+{
+	obj_t *lst = obj;
+
+	return core_tsk_wakeup(lst->queue, event);
+}
+
+/* -------------------------------------------------------------------------- */
+
+// resume at most 'count' tasks from object 'lst' delayed queue with event value 'event'
+static
+void priv_all_wakeup( obj_t *lst, unsigned event, unsigned count )
+{
+	tsk_t *tsk;
+	tsk_t *cur = IDLE.obj.next;
+#if OS_PRIO_BITMAP == 0
+	tsk_t *nxt = cur; // merge position in the ready queue
+#endif
+
+	// the queue of the object is ordered by priority, so all tasks are merged into the ready queue in one pass
+	for (; count > 0 && (tsk = lst->queue) != 0; count--)
+	{
+		core_trc_event(TRC_TSK_WAKEUP, tsk, event);
+#if OS_TASK_LATENCY
+		tsk->lat.stamp = port_cyc_time();
+		tsk->lat.woken = true;
+#endif
+		core_tsk_unlink(tsk, event);
+		core_tmr_remove((tmr_t *)tsk);
+		core_trc_event(TRC_TSK_INSERT, tsk, tsk->prio);
+		tsk->id = ID_READY;
+#if OS_TASK_PARTITION
+		if (priv_prt_parked(tsk))
+		{
+			priv_prt_park(tsk);
+			continue;
+		}
+#endif
+#if OS_PRIO_BITMAP
+		priv_tsk_insert(tsk);
+#else
+	#if OS_EDF_PRIO
+		if (tsk->prio == OS_EDF_PRIO)
+		{
+			// tasks of the EDF priority level are merged by their deadlines, not in the order of the object queue
+			priv_tsk_insert(tsk);
+			continue;
+		}
+	#endif
+	#if ROBIN_TICK
+		tsk->slice = 0;
+	#endif
+		while (nxt != &IDLE && tsk->prio <= nxt->prio)
+			nxt = nxt->obj.next;
+		priv_rdy_insert(&tsk->obj, &nxt->obj);
+#endif
+	}
+
+	if (IDLE.obj.next != cur)
+		priv_ctx_preempt();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_all_wakeup( void *obj, unsigned event )
+{
+	priv_all_wakeup(obj, event, ~0U);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_all_detach( void *obj, obj_t *hld )
+{
+	obj_t *lst = obj;
+	tsk_t *tsk;
+
+	hld->queue = lst->queue;
+	lst->queue = 0;
+
+	// tasks keep waiting in the holder, so their timeouts and priority changes are still handled
+	for (tsk = hld->queue; tsk; tsk = tsk->obj.queue)
+		tsk->guard = hld;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#define WAKEUP_CHUNK 8U // maximum number of tasks resumed in one critical section
+
+void core_all_release( obj_t *hld, unsigned event )
+{
+	lck_t lck;
+
+	while (hld->queue)
+	{
+		lck = port_get_lock(); // the lock state of the caller is restored after each chunk
+		port_set_lock();
+		{
+			priv_all_wakeup(hld, event, WAKEUP_CHUNK);
+		}
+		port_put_lock(lck);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+// return basic priority of task 'tsk', the lowest priority (0) if the task has exhausted its execution budget,
+// raised by the priority aging of the ready task
+static
+unsigned priv_tsk_basic( tsk_t *tsk )
+{
+#if OS_TASK_BUDGET
+	if (tsk->bgt.limit && tsk->bgt.used >= tsk->bgt.limit)
+		return 0;
+#endif
+#if OS_TASK_AGING
+	if (tsk->age.boost)
+		return tsk->basic + tsk->age.boost < tsk->age.ceil ? tsk->basic + tsk->age.boost : tsk->age.ceil;
+#endif
+	return tsk->basic;
+}
+
+/* -------------------------------------------------------------------------- */
+
+// return priority of task 'tsk' inherited from the held mutexes, not less than 'prio' and the basic priority
+// mutex queues are ordered by priority, so the first waiter of every held mutex has the highest priority
+static
+unsigned priv_tsk_inherit( tsk_t *tsk, unsigned prio )
+{
+	mtx_t *mtx;
+
+	if (prio < priv_tsk_basic(tsk))
+		prio = priv_tsk_basic(tsk);
+
+	for (mtx = tsk->mtx.list; mtx; mtx = mtx->list)
+	{
+		if (prio < mtx->ceiling)
+			prio = mtx->ceiling;
+		if (mtx->queue)
+			if (prio < mtx->queue->prio)
+				prio = mtx->queue->prio;
+	}
+
+	return prio;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tsk_prio( tsk_t *tsk, unsigned prio )
+{
+#if OS_MTX_DEPTH
+	unsigned depth = OS_MTX_DEPTH;
+#endif
+
+	// propagate along the chain of mutex owners until the priority no longer changes
+	for (;;)
+	{
+		prio = priv_tsk_inherit(tsk, prio);
+
+		if (tsk->prio == prio)
+			break;
+
+		if (tsk == System.cur)
+		{
+			if (priv_cur_move(tsk, prio))
+				port_ctx_switch();
+			break;
+		}
+
+		if (tsk->id == ID_READY)
+		{
+			priv_tsk_remove(tsk);
+			tsk->prio = prio;
+			core_tsk_insert(tsk);
+			break;
+		}
+
+		tsk->prio = prio;
+
+		if (tsk->id != ID_DELAYED)
+			break;
+
+		core_tsk_transfer(tsk, tsk->guard);
+
+		if (tsk->mtx.tree == 0)
+			break;
+#if OS_MTX_DEPTH
+		if (--depth == 0)
+			break;
+#endif
+		tsk = tsk->mtx.tree;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_cur_prio( unsigned prio )
+{
+	tsk_t *tsk = System.cur;
+
+	prio = priv_tsk_inherit(tsk, prio);
+
+	if (tsk->prio != prio)
+	{
+		if (priv_cur_move(tsk, prio))
+			port_ctx_switch();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_cur_raise( unsigned prio )
+{
+	if (System.cur->prio < prio)
+		(void) priv_cur_prio(System.cur, prio);
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_THRESHOLD
+
+void core_cur_threshold( unsigned thresh )
+{
+	System.cur->thresh = thresh;
+
+	if (IDLE.obj.next != System.cur)
+		priv_ctx_preempt();
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_EDF_PRIO
+
+void core_cur_deadline( cnt_t time )
+{
+	tsk_t *cur = System.cur;
+
+	cur->deadline = time;
+
+	if (cur->prio == OS_EDF_PRIO && priv_cur_move(cur, OS_EDF_PRIO))
+		port_ctx_switch();
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_STATS
+
+static
+uint32_t Stamp = 0;
+
+void core_cur_account( void )
+{
+	uint32_t now = port_cyc_time();
+	uint32_t cyc = (uint32_t)(now - Stamp);
+
+	System.cur->stat.time += cyc;
+	Stamp = now;
+#if OS_TASK_ENERGY
+	core_nrg_run(cyc);
+#endif
+}
+
+#if OS_TASK_ENERGY
+
+void core_cur_sleep( cnt_t cnt )
+{
+	uint32_t now;
+
+	if (cnt == 0) // sleep shorter than a system tick is charged as running
+	{
+		core_cur_account();
+		return;
+	}
+
+	now = port_cyc_time();
+	System.cur->stat.time += (uint32_t)(now - Stamp); // sleeping cpu: no energy of running cycles
+	Stamp = now;
+	core_nrg_sleep(0, cnt);
+}
+
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_PERF
+
+static
+pfc_t PfcStamp = { 0 };
+
+void core_pfc_account( void )
+{
+	port_pfc_account(&System.cur->perf, &PfcStamp);
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_LOCK_PROFILE
+
+lpm_t *LockCur = 0;
+
+static
+lps_t *LockList = 0;
+
+void core_lps_record( lpm_t *prof, lps_t *site )
+{
+	uint32_t time = port_cyc_time() - prof->stamp;
+	unsigned idx;
+
+	if (time < prof->time)
+		time = prof->time;
+
+	if (site->count++ == 0)
+	{
+		site->max  = 0;
+		site->next = LockList;
+		LockList = site;
+	}
+
+	if (site->max < time)
+		site->max = time;
+
+	idx = time ? port_get_msb(time) : 0;
+	site->hist[idx < LPS_BUCKETS ? idx : LPS_BUCKETS - 1]++;
+
+	LockCur = 0;
+}
+
+lps_t *core_lps_list( void )
+{
+	return LockList;
+}
+
+void core_lps_reset( void )
+{
+	lps_t *site;
+
+	for (site = LockList; site; site = site->next)
+	{
+		site->count = 0;
+		memset(site->hist, 0, sizeof(site->hist));
+	}
+
+	LockList = 0;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_OBJ_STATS
+
+#define OST_NOWAIT (~2U) // current task has not been blocked, 'wait' returned without suspending it
+
+static
+ost_t *StatList = 0;
+
+static
+void priv_ost_record( ost_t *ost, const void *obj )
+{
+	if (ost->obj == 0)
+	{
+		ost->obj  = obj;
+		ost->next = StatList;
+		StatList = ost;
+	}
+}
+
+void core_ost_take( ost_t *ost, const void *obj, bool contended )
+{
+	priv_ost_record(ost, obj);
+
+	ost->taken++;
+	if (contended)
+		ost->contended++;
+}
+
+unsigned core_ost_wait( ost_t *ost, void *obj, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+{
+	tsk_t  * cur = System.cur;
+	cnt_t    start = core_sys_time();
+	unsigned event;
+	cnt_t    delay;
+
+	cur->event = OST_NOWAIT;
+	event = wait(obj, time);
+
+	// the event value is set when the task is released from the queue of the object
+	if (cur->event != OST_NOWAIT)
+	{
+		delay = core_sys_time() - start;
+
+		priv_ost_record(ost, obj);
+
+		ost->waits++;
+		ost->time += delay;
+		if (ost->max < delay)
+			ost->max = delay;
+	}
+
+	return event;
+}
+
+void core_ost_remove( ost_t *ost )
+{
+	ost_t **ptr;
+
+	for (ptr = &StatList; *ptr; ptr = &(*ptr)->next)
+	{
+		if (*ptr == ost)
+		{
+			*ptr = ost->next;
+			break;
+		}
+	}
+}
+
+ost_t *core_ost_list( void )
+{
+	return StatList;
+}
+
+void core_ost_reset( void )
+{
+	ost_t *ost;
+
+	for (ost = StatList; ost; ost = ost->next)
+	{
+		ost->obj       = 0;
+		ost->taken     = 0;
+		ost->contended = 0;
+		ost->waits     = 0;
+		ost->time      = 0;
+		ost->max       = 0;
+	}
+
+	StatList = 0;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_LATENCY
+
+// record wake-to-run time of task 'tsk' which is being switched to
+static __RAMFUNC
+void priv_lat_record( tsk_t *tsk )
+{
+	uint32_t time = port_cyc_time() - tsk->lat.stamp;
+	unsigned idx  = time ? port_get_msb(time) : 0;
+
+	tsk->lat.hist[idx < LAT_BUCKETS ? idx : LAT_BUCKETS - 1]++;
+	tsk->lat.woken = false;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if ROBIN_TICK
+
+static __RAMFUNC
+cnt_t priv_tsk_slice( tsk_t *tsk )
+{
+	return tsk->quant ? tsk->quant : (OS_FREQUENCY)/(OS_ROBIN);
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+// choose the next task to run, the current task 'cur' yields to the tasks of the same priority
+static __RAMFUNC
+tsk_t *priv_tsk_next( tsk_t *cur )
+{
+	tsk_t *nxt;
+
+#if OS_DEFER_SIZE
+	core_dfr_handler();
+#endif
+#if OS_EVQ_LOCKFREE
+	core_evq_handler();
+#endif
+#if OS_TASK_PARTITION
+	if (Prt.sync)
+		priv_prt_switch();
+#endif
+	core_ctx_reset();
+
+	nxt = IDLE.obj.next;
+
+#if OS_TASK_THRESHOLD
+	if (CurYield)
+		CurYield = false;
+	else
+	if (priv_cur_deferred(nxt))
+		return cur;						// the first task in ready queue doesn't exceed the threshold of the current task
+#endif
+
+	// a run-to-completion task keeps the shared stack until its state returns
+#if ROBIN_TICK
+	if (nxt != &IDLE && !priv_rtc_live(nxt) && (cur == nxt || (nxt->slice >= priv_tsk_slice(nxt) && (nxt->slice = 0) == 0)))
+#else
+	if (nxt != &IDLE && !priv_rtc_live(nxt) && cur == nxt)
+#endif
+	{
+		priv_tsk_remove(nxt);
+		priv_tsk_insert(nxt);
+		nxt = IDLE.obj.next;
+	}
+
+	return nxt;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_AGING
+
+// the task 'nxt' has been switched to and stops aging, the priority raised by aging is dropped by the next tick
+// (changing the priority here, in the middle of the context switch, could requeue tasks and request another switch)
+static
+void priv_age_reset( tsk_t *nxt )
+{
+	nxt->age.wait = 0;
+	nxt->age.run  = true;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+// save stack pointer 'sp' of the current task 'cur' and make 'nxt' the current task
+// return the stack pointer of the task 'nxt'
+static __RAMFUNC
+void *priv_tsk_enter( tsk_t *cur, tsk_t *nxt, void *sp )
+{
+	cur->sp = sp;
+
+#if OS_TASK_STATS
+	core_cur_account();
+	if (nxt != cur) nxt->stat.count++;
+#endif
+#if OS_TASK_PERF
+	core_pfc_account();
+#endif
+#if OS_TASK_LATENCY
+	if (nxt->lat.woken) priv_lat_record(nxt);
+#endif
+#if OS_TRACE_SIZE || OS_TRACE_ITM
+	if (nxt != cur) core_trc_event(TRC_TSK_SWITCH, nxt, (uint32_t)(uintptr_t) cur);
+#endif
+#if OS_STACK_GUARD
+	if (nxt != cur) port_stk_guard(nxt->stack);
+#endif
+#ifdef HW_STACK_LIMIT
+	if (nxt != cur) port_stk_limit(nxt->stack);
+#endif
+#if ROBIN_TIMER
+	if (nxt != cur) port_rob_start(nxt->quant);
+#endif
+#if OS_TASK_RTC
+	priv_rtc_dispatch(nxt);
+#endif
+	System.cur = nxt;
+#if OS_TASK_REENT
+	if (nxt != cur) _impure_ptr = nxt->reent ? nxt->reent : _global_impure_ptr;
+#endif
+#if OS_TASK_AGING
+	if (nxt != cur)
+		priv_age_reset(nxt);
+#endif
+
+	return nxt->sp;
+}
+
+/* -------------------------------------------------------------------------- */
+
+__RAMFUNC
+void *core_tsk_handler( void *sp )
+{
+	tsk_t *cur;
+
+	core_stk_assert();
+
+	port_set_lock();
+	{
+		cur = System.cur;
+		sp = priv_tsk_enter(cur, priv_tsk_next(cur), sp);
+	}
+	port_clr_lock();
+
+	return sp;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_SYNC_SWITCH
+
+void core_ctx_sync( void )
+{
+	tsk_t *cur = System.cur;
+	tsk_t *nxt = cur->obj.next;
+
+	if (cur == IDLE.obj.next && nxt->prio == cur->prio)
+	{
+		nxt = priv_tsk_next(cur);
+		if (nxt != cur && port_ctx_ready(nxt->sp))
+		{
+			port_ctx_sync();
+			return;
+		}
+	}
+#if OS_TASK_THRESHOLD
+	else
+	if (cur != IDLE.obj.next)
+		CurYield = true;				// the preemption of the current task has been deferred by its threshold
+#endif
+
+	port_ctx_switch(); // the context of the next task can only be restored by the exception return
+}
+
+/* -------------------------------------------------------------------------- */
+
+__RAMFUNC
+void *core_tsk_sync( void *sp )
+{
+	core_stk_assert();
+
+	return priv_tsk_enter(System.cur, IDLE.obj.next, sp);
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_BUDGET
+
+// start a new replenishment period of task 'tsk' if the current one has elapsed
+static
+void priv_bgt_replenish( tsk_t *tsk, cnt_t now )
+{
+	if (tsk->bgt.limit && (cnt_t)(now - tsk->bgt.stamp) >= tsk->bgt.period)
+	{
+		bool depleted = tsk->bgt.used >= tsk->bgt.limit;
+		tsk->bgt.stamp = now;
+		tsk->bgt.used  = 0;
+		if (depleted)
+			core_tsk_prio(tsk, 0); // restore the basic priority
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_tsk_budget( tsk_t *tsk, cnt_t limit, cnt_t period )
+{
+	tsk->bgt.limit  = limit;
+	tsk->bgt.period = period;
+	tsk->bgt.stamp  = core_sys_time();
+	tsk->bgt.used   = 0;
+	core_tsk_prio(tsk, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_bgt_handler( void )
+{
+	tsk_t *tsk, *prv;
+	tsk_t *cur;
+	cnt_t  now;
+
+	port_set_lock();
+	{
+		now = core_sys_time();
+
+		// demoted tasks are at the tail of the ready queue (the lowest priority level)
+		for (tsk = IDLE.obj.prev; tsk != &IDLE && tsk->prio == 0; tsk = prv)
+		{
+			prv = tsk->obj.prev;
+			priv_bgt_replenish(tsk, now);
+		}
+
+		cur = System.cur;
+		if (cur->bgt.limit)
+		{
+			priv_bgt_replenish(cur, now);
+			if (++cur->bgt.used == cur->bgt.limit)
+				core_tsk_prio(cur, 0); // budget exhausted: demote to the lowest priority
+		}
+	}
+	port_clr_lock();
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_AGING
+
+void core_tsk_aging( tsk_t *tsk, unsigned ceil )
+{
+	tsk->age.ceil  = ceil;
+	tsk->age.boost = 0;
+	tsk->age.wait  = 0;
+	tsk->age.run   = false;
+	core_tsk_prio(tsk, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+// walk the ready queue with every system tick: O(number of ready tasks) in the tick handler
+void core_age_handler( void )
+{
+	tsk_t *tsk, *nxt;
+	tsk_t *cur;
+
+	port_set_lock();
+	{
+		cur = System.cur;
+
+		// a raised task moves towards the head of the ready queue, so it is not visited again;
+		// a task that has lost its raised priority moves back and can be visited again as a waiting task
+		for (tsk = IDLE.obj.next; tsk != &IDLE; tsk = nxt)
+		{
+			nxt = tsk->obj.next;
+			if (tsk->age.run)
+			{
+				tsk->age.run = false;
+				if (tsk->age.boost)
+				{
+					tsk->age.boost = 0; // the raised task has got the cpu
+					core_tsk_prio(tsk, 0);
+				}
+			}
+			else
+			if (tsk != cur && tsk->prio < tsk->age.ceil && ++tsk->age.wait >= OS_TASK_AGING)
+			{
+				tsk->age.wait = 0;
+				tsk->age.boost++;
+				core_tsk_prio(tsk, 0);
+			}
+		}
+	}
+	port_clr_lock();
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+static bool SysSuspended = false; // system timer stopped by core_sys_suspend
+
+cnt_t core_sys_suspend( void )
+{
+#if OS_TIMER_WHEEL
+	return 0; // the timer wheel is rotated with every system tick
+#else
+	tsk_t *nxt;
+	cnt_t  cnt = 0;
+
+	port_set_lock();
+
+	nxt = IDLE.obj.next;
+	if (nxt == System.cur)
+		nxt = nxt->obj.next;
+	if (nxt == &IDLE) // no other task is ready to run
+	{
+		SysSuspended = port_sys_suspend();
+		if (SysSuspended)
+		{
+			cnt = priv_tmr_sleep();
+			if (cnt == 0) // a timer is already due
+			{
+				SysSuspended = false;
+				port_sys_resume();
+			}
+		}
+	}
+
+	if (cnt == 0)
+		port_clr_lock(); // suspension refused, the system is not locked
+
+	return cnt;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+void core_sys_resume( cnt_t ticks )
+{
+	if (SysSuspended)
+	{
+		SysSuspended = false;
+#if HW_TIMER_SIZE == 0
+	#if OS_TIMER_SIZE < 64
+		// count the halves of the counter period crossed while sleeping
+		uint32_t epoch = (uint32_t)(((uint64_t)(System.cnt & (CNT_MAX >> 1)) + ticks) >> (OS_TIMER_SIZE - 1));
+	#endif
+		System.cnt += ticks;
+	#if OS_TIMER_SIZE < 64
+		System.epoch += epoch;
+	#endif
+#else
+		(void) ticks; // the system timer counter has not been stopped
+#endif
+		port_sys_resume();
+		core_tmr_handler(); // all timers expired while sleeping
+	}
+
+	port_clr_lock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if HW_TIMER_SIZE == 0
+
+__RAMFUNC
+void core_sys_tick( void )
+{
+	System.cnt++;
+	#if OS_TIMER_SIZE < 64
+	if ((System.cnt & (CNT_MAX >> 1)) == 0)
+		System.epoch++; // the counter has crossed the half of its period
+	#endif
+	#if OS_TASK_PERF
+	core_pfc_account();
+	#endif
+	core_tmr_handler();
+	#if OS_TASK_BUDGET
+	core_bgt_handler();
+	#endif
+	#if OS_TASK_AGING
+	core_age_handler();
+	#endif
+	#if ROBIN_TICK
+	if (++System.cur->slice >= priv_tsk_slice(System.cur))
 		core_ctx_switch();
 	#endif
 }
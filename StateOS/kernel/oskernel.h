@@ -51,8 +51,59 @@
 #ifdef  __cplusplus
 
 #if OS_FUNCTIONAL
-#include <functional>
-typedef std::function<void( void )> FUN_t;
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/******************************************************************************
+ *
+ * Class             : FunctionT<>
+ *
+ * Description       : heap-free replacement of std::function<void( void )>
+ *                     function object is stored in place, in the buffer of fixed capacity
+ *                     stored function object must be trivially copyable (e.g. lambda capturing pointers, references or scalars),
+ *                     therefore FunctionT<> is also trivially copyable and can be passed byte by byte through the mailbox queue
+ *
+ * Template parameters
+ *   size            : capacity of the buffer (in bytes)
+ *
+ ******************************************************************************/
+
+template<size_t size_>
+struct FunctionT
+{
+	FunctionT( void ):           fun_(nullptr) {}
+	FunctionT( std::nullptr_t ): fun_(nullptr) {}
+
+	template<class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, FunctionT>::value>::type>
+	FunctionT( F _f ): fun_(run_<F>)
+	{
+		static_assert(std::is_trivially_copyable<F>::value, "function object must be trivially copyable");
+		static_assert(sizeof(F)  <= size_,                  "function object too large, increase OS_FUNCTIONAL_SIZE");
+		static_assert(alignof(F) <= alignof(std::max_align_t), "function object over-aligned");
+		new (data_) F(_f);
+	}
+
+	void operator()( void ) const { assert(fun_); fun_(data_); }
+
+	explicit
+	operator bool( void ) const { return fun_ != nullptr; }
+
+	private:
+	template<class F>
+	static
+	void run_( void *_data ) { (*reinterpret_cast<F *>(_data))(); }
+
+	void (*fun_)( void * );
+	alignas(std::max_align_t)
+	mutable char data_[size_];
+};
+
+/* -------------------------------------------------------------------------- */
+
+typedef FunctionT<OS_FUNCTIONAL_SIZE> FUN_t;
+
 #else
 typedef     void (* FUN_t)( void );
 #endif
@@ -79,6 +130,22 @@ typedef     void (* FUN_t)( void );
 #define SSIZE( size ) \
  ALIGNED_SIZE( size, stk_t )
 
+// storage class of stacks and data buffers defined with OS_XXX and static_XXX macros
+#if OS_NOINIT
+#define __OS_NOINIT __NOINIT
+#else
+#define __OS_NOINIT
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+// scheduler policy selected at build time; code of unused variants is not compiled
+// ROBIN_TICK:  preemptive mode, time slice counted by the system tick handler (tick mode)
+// ROBIN_TIMER: preemptive mode, time slice measured by the context switch timer (tick-less mode)
+// ready queue (list / bitmap) is selected with OS_PRIO_BITMAP, timer queue (list / wheel) with OS_TIMER_WHEEL
+#define ROBIN_TICK  ((OS_ROBIN) && HW_TIMER_SIZE == 0)
+#define ROBIN_TIMER ((OS_ROBIN) && HW_TIMER_SIZE != 0)
+
 /* -------------------------------------------------------------------------- */
 
 #ifdef __cplusplus
@@ -90,12 +157,30 @@ extern "C" {
 extern tsk_t MAIN;   // main task
 extern tsk_t IDLE;   // idle task, tasks' queue
 extern tmr_t WAIT;   // timers' queue
+#if OS_TIMER_TASK
+extern tmr_t PEND;   // expired timers' queue
+#endif
 extern sys_t System; // system data
+#if OS_TIMER_WHEEL
+extern obj_t WHEEL[]; // timers' wheel
+#endif
 
 /* -------------------------------------------------------------------------- */
 
+// core_stk_base: the lowest address of the task stack available for the task
+#if OS_STACK_GUARD
+// stack overflow is detected by the mpu
+#define core_stk_assert()
+#define core_stk_base( tsk ) GUARD_TOP((tsk)->stack)
+#elif defined(HW_STACK_LIMIT)
+// stack overflow is detected by the stack limit register
+#define core_stk_assert()
+#define core_stk_base( tsk ) ((tsk)->stack)
+#else
 #define core_stk_assert() \
         assert((System.cur == &MAIN) || (System.cur->stack <= port_get_sp()))
+#define core_stk_base( tsk ) ((tsk)->stack)
+#endif
 
 /* -------------------------------------------------------------------------- */
 
@@ -109,14 +194,38 @@ void port_sys_init( void );
 // initiate task 'tsk' for context switch
 void core_ctx_init( tsk_t *tsk );
 
+#if OS_STACK_MONITOR
+// examine at most 'cnt' words of the unused part of the stack of task 'tsk', starting from 'ptr'
+// update the high-water mark of the task stack
+// return the position to continue from, or 0 when the whole unused part has been examined
+uint32_t *core_stk_scan( tsk_t *tsk, uint32_t *ptr, unsigned cnt );
+#endif
+
+#if OS_ISR_STACK
+// return the number of bytes of the dedicated interrupt stack used so far (high-water mark)
+// the interrupt stack is painted by port_sys_init
+unsigned core_isr_used( void );
+#endif
+
 // save status of the current process and force yield system control to the next
 void core_ctx_switch( void );
 
+#if OS_SYNC_SWITCH
+// save status of the current process and yield system control to the next process of the same priority
+// with the synchronous context switch (without the context switch exception), if possible
+// otherwise force yield system control to the next (as core_ctx_switch)
+void core_ctx_sync( void );
+#endif
+
 // save status of the current process and immediately yield system control to the next
 __STATIC_INLINE
 void core_ctx_switchNow( void )
 {
+#if OS_SYNC_SWITCH
+	core_ctx_sync();
+#else
 	core_ctx_switch();
+#endif
 	port_clr_lock(); port_set_barrier();
 }
 
@@ -139,6 +248,41 @@ void *core_sys_alloc( size_t size );
 // system free procedure
 void core_sys_free( void *ptr );
 
+// take a snapshot of the system heap statistics
+void core_sys_info( hst_t *info );
+
+#if OS_HEAP_COALESCE
+// merge adjacent free memory segments of the system heap, at most OS_HEAP_COALESCE segments in one pass
+// return true if merges are still pending
+bool core_sys_coalesce( void );
+#endif
+
+#if OS_HEAP_QUOTA
+
+// charge memory segments allocated by task 'tsk' to heap quota 'hqt' (0: none)
+void core_sys_quota( tsk_t *tsk, hqt_t *hqt );
+
+// take a snapshot of heap quota 'hqt'
+void core_sys_quotaInfo( hqt_t *hqt, hqt_t *info );
+
+#endif
+
+#if OS_LIBC_MUTEX
+
+// lock the c library with the recursive library mutex (thread mode) or by masking interrupts (handler mode, critical section)
+void core_lib_lock( void );
+
+// unlock the c library locked by core_lib_lock
+void core_lib_unlock( void );
+
+#endif
+
+struct __mem;
+
+// bind static memory pool 'mem' to the system allocator
+// memory objects of the pool released with core_sys_free are returned to the pool
+void core_sys_bind( struct __mem *mem );
+
 /* -------------------------------------------------------------------------- */
 
 // insert timer 'tmr' into timers READY queue with id 'id' and start it
@@ -147,9 +291,23 @@ void core_tmr_insert( tmr_t *tmr, tid_t id );
 // remove timer 'tmr' from timers READY queue
 void core_tmr_remove( tmr_t *tmr );
 
+// insert timer 'tmr' of a group of timers into timers READY queue with id 'id', the timer interrupt is not forced
+// the search for the place starts from timer 'hint' (0: from the beginning) if 'tmr' doesn't expire before it
+// return the hint for the next timer of the group; call core_tmr_force after the last timer of the group
+tmr_t *core_tmr_merge( tmr_t *tmr, tid_t id, tmr_t *hint );
+
+// force the timer interrupt to reprogram the hardware timer for the first timer in the queue
+void core_tmr_force( void );
+
 // timers queue handler procedure
 void core_tmr_handler( void );
 
+#if OS_TIMER_TASK
+// procedure of the timer service task, executes callbacks of expired timers
+__NO_RETURN
+void core_tmr_service( void );
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 // reset stack and restart the current task
@@ -163,6 +321,12 @@ void core_tsk_insert( tsk_t *tsk );
 // remove task 'tsk' from tasks READY queue
 void core_tsk_remove( tsk_t *tsk );
 
+// link task 'tsk' to the registry of started tasks
+void core_tsk_register( tsk_t *tsk );
+
+// unlink task 'tsk' from the registry of started tasks
+void core_tsk_unregister( tsk_t *tsk );
+
 // append task 'tsk' to the delayed queue of object 'obj'
 void core_tsk_append( tsk_t *tsk, void *obj );
 
@@ -222,11 +386,22 @@ tsk_t *core_one_wakeup( void *obj, unsigned event );
 // resume execution of all tasks from object 'obj' delayed queue with event value 'event'
 // remove all tasks from object 'obj' delayed queue
 // remove all resumed tasks from timers READY queue
-// insert all resumed tasks into tasks READY queue
+// insert all resumed tasks into tasks READY queue in a single merge pass
 // force context switch if priority of any resumed task is greater then priority of the current task and kernel works in preemptive mode
 void core_all_wakeup( void *obj, unsigned event );
 
+// move all tasks from object 'obj' delayed queue to the holder 'hld' delayed queue
+// must be called under the system lock; the walk along the queue only updates the guards of tasks
+void core_all_detach( void *obj, obj_t *hld );
+
+// resume execution of all tasks from the holder 'hld' delayed queue with event value 'event'
+// tasks are resumed in short critical sections; called outside the system lock, interrupts are served between them,
+// called under the system lock (e.g. mtx_kill from tsk_kill), the wakeups are deferred until the outermost unlock
+// holder 'hld' must stay valid until the function returns
+void core_all_release( obj_t *hld, unsigned event );
+
 // set task 'tsk' priority
+// the priority is propagated iteratively along the chain of mutex owners (at most OS_MTX_DEPTH tasks) until it no longer changes
 // force context switch if new priority of task 'tsk' is greater then priority of current task and kernel works in preemptive mode
 void core_tsk_prio( tsk_t *tsk, unsigned prio );
 
@@ -234,12 +409,78 @@ void core_tsk_prio( tsk_t *tsk, unsigned prio );
 // force context switch if new priority of the current task is less then priority of next task in ready queue and kernel works in preemptive mode
 void core_cur_prio( unsigned prio );
 
+#if OS_TASK_THRESHOLD
+// set the preemption threshold of the current task
+// force context switch if the first task in ready queue exceeds the new threshold
+void core_cur_threshold( unsigned thresh );
+#endif
+
+#if OS_EDF_PRIO
+// set the absolute deadline of the current task
+// force context switch if the current task of the EDF priority level is no longer the first task in ready queue
+void core_cur_deadline( cnt_t time );
+#endif
+
+// raise the current task priority to 'prio' in constant time
+// the current task stays at the head of ready queue, so no context switch is needed
+void core_cur_raise( unsigned prio );
+
 // tasks queue handler procedure
 // save stack pointer 'sp' of the current task
 // reset context switch timer counter
 // return a pointer to the stack pointer of the next READY task the highest priority
 void *core_tsk_handler( void *sp );
 
+#if OS_SYNC_SWITCH
+// synchronous context switch handler procedure, called by port_ctx_sync with the lock held
+// save stack pointer 'sp' of the current task
+// return a pointer to the stack pointer of the next task chosen by core_ctx_sync
+void *core_tsk_sync( void *sp );
+#endif
+
+#if OS_TASK_STATS
+// add the cpu cycles consumed since the last accounting to the current task
+void core_cur_account( void );
+#endif
+
+#if OS_TASK_ENERGY
+// add the cpu cycles of the low-power sleep of the idle task lasting 'cnt' system ticks to the current task (OS_TICKLESS_IDLE)
+void core_cur_sleep( cnt_t cnt );
+// charge the energy of 'cyc' running cpu cycles to the current task
+void core_nrg_run( uint32_t cyc );
+// charge the energy of 'cnt' system ticks spent in low-power state 'state' to the idle task
+void core_nrg_sleep( unsigned state, cnt_t cnt );
+#endif
+
+#if OS_TASK_PERF
+// add the hardware events counted since the last accounting to the current task
+void core_pfc_account( void );
+#endif
+
+#if OS_EVQ_LOCKFREE
+// deferred service of event queues filled by lock-free isr producer
+// wake up tasks blocked on these event queues
+// must be called from the context switch handler with interrupts masked
+void core_evq_handler( void );
+#endif
+
+#if OS_DEFER_SIZE
+// execute calls deferred by interrupt handlers with 'sys_defer'
+// must be called from the context switch handler with interrupts masked
+void core_dfr_handler( void );
+#endif
+
+#if OS_RCU_SIZE
+// free the blocks retired with 'rcu_retire' if no task is inside a read-side section
+// must be called from the idle task
+void core_rcu_reclaim( void );
+#endif
+
+// serve one pending idle hook (see idh_start) within its cycle budget
+// return true if any idle hook is still pending
+// must be called from the idle task
+bool core_idh_handler( void );
+
 /* -------------------------------------------------------------------------- */
 
 // return current system time in tick-less mode
@@ -247,6 +488,12 @@ void *core_tsk_handler( void *sp );
 cnt_t port_sys_time( void );
 #endif
 
+// restart the timer for context switch triggering in tick-less mode with preemption
+// for time slice 'slice' (number of ticks) of the incoming task, 0: default (OS_FREQUENCY)/(OS_ROBIN)
+#if ROBIN_TIMER
+void port_rob_start( cnt_t slice );
+#endif
+
 // return current system time
 __STATIC_INLINE
 cnt_t core_sys_time( void )
@@ -258,6 +505,133 @@ cnt_t core_sys_time( void )
 #endif
 }
 
+// return current system time extended to 64 bits
+#if OS_TIMER_SIZE == 64
+// must be called with interrupts masked
+__STATIC_INLINE
+uint64_t core_sys_time64( void )
+{
+	return core_sys_time();
+}
+#elif HW_TIMER_SIZE == 0
+// lock-free: the parity of 'epoch' (counted halves of the counter period) is compared
+// with the most significant bit of the counter, which is updated before 'epoch'
+__STATIC_INLINE
+uint64_t core_sys_time64( void )
+{
+	uint32_t epoch = System.epoch;
+	cnt_t    cnt   = System.cnt;
+
+	if ((epoch ^ (uint32_t)(cnt >> (OS_TIMER_SIZE - 1))) & 1U)
+		epoch++; // the counter has just crossed the half of its period
+	return ((uint64_t)(epoch >> 1) << OS_TIMER_SIZE) | cnt;
+}
+#else
+// must be called with interrupts masked, at least once per period of the system counter
+uint64_t core_sys_time64( void );
+#endif
+
+// return current system time in microseconds, with the resolution of the system timer counter
+// must be called with interrupts masked
+#if 1000000 % (OS_FREQUENCY) == 0
+__STATIC_INLINE
+uint32_t core_hrt_time( void )
+{
+	cnt_t cnt = core_sys_time();
+#if defined(HW_TICK_FREQUENCY) && (HW_TICK_FREQUENCY) % 1000000 == 0
+	uint32_t tck = port_tck_time(&cnt) / ((HW_TICK_FREQUENCY) / 1000000);
+#elif defined(HW_TICK_FREQUENCY)
+	uint32_t tck = (uint32_t)((uint64_t) port_tck_time(&cnt) * 1000000 / (HW_TICK_FREQUENCY));
+#else
+	uint32_t tck = 0;
+#endif
+	return (uint32_t) cnt * (1000000 / (OS_FREQUENCY)) + tck;
+}
+#endif
+
+// suspend the scheduler and stop system timer interrupts for the low power mode managed by the application
+// return number of ticks until the nearest timeout (INFINITE: no timeout is pending)
+// 0: the system can't sleep (other tasks are ready to run, a timer is due or the port can't stop the system timer),
+//    the system is left unlocked and core_sys_resume must not be called
+// otherwise the system stays locked until core_sys_resume
+cnt_t core_sys_suspend( void );
+
+// resume the scheduler and system timer interrupts after 'ticks' system ticks of the low power mode
+// system time is advanced by 'ticks' (ignored in tick-less mode) and all expired timers are processed
+void core_sys_resume( cnt_t ticks );
+
+// suppress system timer interrupts in the idle task for up to 'ticks' system ticks
+// return number of skipped ticks
+#if OS_TICKLESS_IDLE
+cnt_t port_sys_sleep( cnt_t ticks );
+#endif
+
+#if OS_TASK_BUDGET
+// set execution budget of task 'tsk': 'limit' ticks within every 'period' ticks, 0: no limit
+// the task is demoted to the lowest priority when the budget is exhausted and restored when it is replenished
+void core_tsk_budget( tsk_t *tsk, cnt_t limit, cnt_t period );
+
+// charge the current task for the system tick and replenish execution budgets of demoted tasks
+void core_bgt_handler( void );
+#endif
+
+#if OS_TASK_AGING
+// set priority aging ceiling of task 'tsk', 0: no aging
+// the ready task is raised by one priority level every OS_TASK_AGING ticks up to the ceiling
+void core_tsk_aging( tsk_t *tsk, unsigned ceil );
+
+// age the ready tasks waiting for the cpu
+void core_age_handler( void );
+#endif
+
+#if OS_TASK_PARTITION
+#define PRT_ALL       (~0U) // partition scheduling is stopped, ready tasks of all partitions are scheduled
+
+// window of the major frame: ready tasks of partition 'part' and unpartitioned tasks run for 'time' ticks
+typedef struct __pwn pwn_t;
+
+struct __pwn
+{
+	unsigned part;  // partition scheduled in the window, 0: only unpartitioned tasks
+	cnt_t    time;  // duration of the window (in ticks)
+};
+
+// start the major frame of 'cnt' windows 'tab' repeated cyclically from the current time
+// tab == 0: stop partition scheduling
+void core_prt_start( const pwn_t *tab, unsigned cnt );
+
+// assign task 'tsk' to partition 'part', 0: unpartitioned task (scheduled in every window)
+void core_prt_assign( tsk_t *tsk, unsigned part );
+
+// return partition of the current window, PRT_ALL if partition scheduling is stopped
+unsigned core_prt_active( void );
+
+// internal handler of the window timer, start the next window of the major frame
+void core_prt_handler( void );
+#endif
+
+#if OS_TIME_TRIGGER
+// time-triggered activity: 'fun' is released at 'offset' and then every 'period' ticks within the major frame
+typedef struct __tta tta_t;
+
+struct __tta
+{
+	fun_t  * fun;    // activity, executed run-to-completion by the system timer handler
+	cnt_t    offset; // first release within the major frame (in ticks)
+	cnt_t    period; // release period within the major frame (in ticks), 0: released once per major frame
+};
+
+// start the major frame of 'frame' ticks with 'cnt' activities 'tab' repeated cyclically from the current time
+// tab == 0: stop the time-triggered executive
+void core_tte_start( const tta_t *tab, unsigned cnt, cnt_t frame );
+
+// return number of releases dispatched after their release time
+unsigned core_tte_late( void );
+
+// internal handler of the release timer, execute activities released at the current offset
+void core_tte_handler( void );
+#endif
+
 // internal handler of system timer
 #if HW_TIMER_SIZE == 0
 void core_sys_tick( void );
@@ -273,6 +647,265 @@ void core_sys_tick( void )
 
 /* -------------------------------------------------------------------------- */
 
+#if OS_TRACE_SIZE || OS_TRACE_ITM
+
+// kernel events stored in the trace buffer / streamed through ITM
+
+#define TRC_TSK_INSERT  1U  // task 'obj' inserted into tasks READY queue, 'arg' is its priority
+#define TRC_TSK_REMOVE  2U  // task 'obj' removed from tasks READY queue, 'arg' is its priority
+#define TRC_TSK_SWITCH  3U  // context switch to task 'obj' from task 'arg'
+#define TRC_TMR_EXPIRE  4U  // timer 'obj' expired
+#define TRC_TSK_WAIT    5U  // task 'obj' started waiting on object 'arg'
+#define TRC_TSK_WAKEUP  6U  // task 'obj' was released with event value 'arg'
+#define TRC_ISR_ENTER   7U  // interrupt handler 'arg' entered (sys_traceIsrEnter)
+#define TRC_ISR_EXIT    8U  // interrupt handler 'arg' exited (sys_traceIsrExit)
+
+#define TRC_MAGIC       0x43525453U // "STRC"
+
+#ifdef  HW_CYCLE_COUNTER
+#define TRC_UNIT        1U  // timestamps in cpu cycles
+#else
+#define TRC_UNIT        0U  // timestamps in system ticks
+#endif
+
+// trace record (16 bytes, little endian)
+
+typedef struct __trc
+{
+	uint32_t time;  // timestamp: cpu cycles (if available) or system ticks
+	uint32_t code;  // event code: TRC_XXX
+	uint32_t obj;   // address of the object
+	uint32_t arg;   // event argument
+}	trc_t;
+
+#if OS_TRACE_SIZE
+
+// trace buffer: header followed by OS_TRACE_SIZE records
+
+typedef struct __trb
+{
+	uint32_t magic; // TRC_MAGIC
+	uint32_t size;  // number of records: OS_TRACE_SIZE
+	volatile
+	uint32_t head;  // total number of stored events, the oldest record is overwritten
+	uint32_t unit;  // timestamp unit: 0 - system ticks, 1 - cpu cycles
+	trc_t    rec[OS_TRACE_SIZE];
+}	trb_t;
+
+extern trb_t TRACE;  // kernel events trace buffer
+
+#endif
+
+#if OS_TRACE_ITM
+
+// number of kernel events not streamed through ITM (ITM disabled or stimulus fifo full)
+extern volatile uint32_t TRACE_LOST;
+
+#endif
+
+// store kernel event 'code' concerning object 'obj' with argument 'arg' in the trace buffer
+// and / or stream it through ITM stimulus ports; never waits for the ITM
+// must be called with interrupts masked
+__STATIC_INLINE
+void core_trc_event( uint32_t code, const void *obj, uint32_t arg )
+{
+#ifdef HW_CYCLE_COUNTER
+	uint32_t time = port_cyc_time();
+#else
+	uint32_t time = (uint32_t) core_sys_time();
+#endif
+#if OS_TRACE_SIZE
+	trc_t *rec = &TRACE.rec[TRACE.head++ & (OS_TRACE_SIZE - 1)];
+	rec->time = time;
+	rec->code = code;
+	rec->obj  = (uint32_t)(uintptr_t) obj;
+	rec->arg  = arg;
+#endif
+#if OS_TRACE_ITM
+	if (!port_trc_send(time, code, (uint32_t)(uintptr_t) obj, arg))
+		TRACE_LOST++;
+#endif
+}
+
+#else
+
+#define core_trc_event( code, obj, arg )
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_PROFILE_SIZE
+
+#define PRF_MAGIC       0x46525053U // "SPRF"
+
+// profiler sample (8 bytes, little endian)
+
+typedef struct __prs
+{
+	uint32_t pc;    // address of the code interrupted by the system tick
+	uint32_t tsk;   // address of the current task (System.cur)
+}	prs_t;
+
+// profiler buffer: header followed by OS_PROFILE_SIZE samples
+
+typedef struct __prb
+{
+	uint32_t magic; // PRF_MAGIC
+	uint32_t size;  // number of samples: OS_PROFILE_SIZE
+	volatile
+	uint32_t head;  // total number of taken samples, the oldest sample is overwritten
+	uint32_t rate;  // sampling frequency in Hz: OS_FREQUENCY
+	prs_t    rec[OS_PROFILE_SIZE];
+}	prb_t;
+
+extern prb_t PROFILE; // statistical pc-sampling profiler buffer
+
+// store the address 'pc' of the interrupted code and the current task in the profiler buffer
+// called by the port from the system tick handler
+__STATIC_INLINE
+void core_prf_sample( uintptr_t pc )
+{
+	prs_t *rec = &PROFILE.rec[PROFILE.head++ & (OS_PROFILE_SIZE - 1)];
+	rec->pc  = (uint32_t) pc;
+	rec->tsk = (uint32_t)(uintptr_t) System.cur;
+}
+
+#else
+
+#define core_prf_sample( pc )
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_SELECT
+
+// notify all wait-set objects watching object 'obj' that the object has become ready
+// must be called with interrupts masked
+void core_sel_notify( void *obj );
+
+#else
+
+#define core_sel_notify( obj ) ((void)(obj))
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_LOCK_PROFILE
+
+#define LPS_BUCKETS     16  // number of histogram buckets of critical section lengths
+
+// critical section call site statistics
+
+typedef struct __lps lps_t;
+
+struct __lps
+{
+	lps_t  * next;  // next recorded call site
+	const
+	char   * file;  // source file of the call site
+	unsigned line;  // source line of the call site
+	unsigned count; // number of measured critical sections
+	uint32_t max;   // the longest critical section (in cpu cycles)
+	uint32_t hist[LPS_BUCKETS]; // bucket 'i' counts sections of 2^i .. 2^(i+1)-1 cycles, the last one: all longer sections
+};
+
+#define _LPS_INIT( _file, _line ) { 0, _file, _line, 0, 0, { 0 } }
+
+// critical section in progress
+
+typedef struct __lpm
+{
+	uint32_t stamp; // start of the current masked interval
+	uint32_t time;  // the longest masked interval before the task blocked inside the section
+}	lpm_t;
+
+extern lpm_t *LockCur; // outermost critical section in progress, 0: none
+
+// start measurement of the critical section entered with previous interrupts state 'lck'
+__STATIC_INLINE
+void core_lps_enter( lck_t lck, lpm_t *prof )
+{
+	if (lck == 0)
+	{
+		prof->time  = 0;
+		prof->stamp = port_cyc_time();
+		LockCur = prof;
+	}
+}
+
+// finish measurement of the critical section and record it in the statistics of call site 'site'
+void core_lps_record( lpm_t *prof, lps_t *site );
+
+__STATIC_INLINE
+void core_lps_leave( lck_t lck, lpm_t *prof, lps_t *site )
+{
+	if (lck == 0)
+		core_lps_record(prof, site);
+}
+
+// list of recorded call sites
+lps_t *core_lps_list( void );
+
+// clear the statistics of all call sites
+void core_lps_reset( void );
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_OBJ_STATS
+
+// contention statistics of a mutex, semaphore or mailbox queue object
+
+typedef struct __ost ost_t;
+
+struct __ost
+{
+	ost_t  * next;  // next object in the list of objects with recorded statistics
+	const
+	void   * obj;   // the object, 0: statistics not recorded since the last reset
+	unsigned taken; // number of acquisitions (mutex locks, semaphore takes, mailbox receives)
+	unsigned contended; // number of acquisitions completed after a blocking wait
+	unsigned waits; // number of blocking waits (including timeouts, killed objects and blocked senders)
+	cnt_t    time;  // cumulative time of blocking waits (in ticks)
+	cnt_t    max;   // the longest blocking wait (in ticks)
+};
+
+#define _OST_INIT , { 0, 0, 0, 0, 0, 0, 0 }
+
+// record an acquisition of the object 'obj' with statistics 'ost'
+void core_ost_take( ost_t *ost, const void *obj, bool contended );
+
+// call 'wait(obj, time)' and record the blocking wait (if any) in the statistics 'ost' of the object 'obj'
+unsigned core_ost_wait( ost_t *ost, void *obj, cnt_t time, unsigned(*wait)(void*,cnt_t) );
+
+// remove the statistics 'ost' from the list of recorded objects (object is reinitialized or deleted)
+void core_ost_remove( ost_t *ost );
+
+// list of objects with recorded statistics
+ost_t *core_ost_list( void );
+
+// clear the statistics of all objects
+void core_ost_reset( void );
+
+// record an acquisition / a wait of the object 'obj' in its own statistics
+#define core_stat_take( obj, contended ) core_ost_take(&(obj)->ost, obj, contended)
+#define core_stat_wait( obj, time, wait ) core_ost_wait(&(obj)->ost, obj, time, wait)
+
+#else
+
+#define _OST_INIT
+
+#define core_stat_take( obj, contended ) ((void) 0)
+#define core_stat_wait( obj, time, wait ) wait(obj, time)
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
 #ifdef __cplusplus
 }
 #endif
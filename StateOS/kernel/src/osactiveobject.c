@@ -0,0 +1,383 @@
+/******************************************************************************
+
+    @file    StateOS: osactiveobject.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osactiveobject.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+
+static aob_t *Registry = 0; // list of started active objects
+
+/* -------------------------------------------------------------------------- */
+void aob_init( aob_t *aob, wpl_t *wpl, aos_t *state, unsigned limit, unsigned *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(aob);
+	assert(wpl);
+	assert(state);
+	assert(limit);
+	assert(data);
+
+	sys_lock();
+	{
+		memset(aob, 0, sizeof(aob_t));
+
+		aob->wpl   = wpl;
+		aob->state = state;
+		aob->limit = limit;
+		aob->data  = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned aob_top( aob_t *aob, unsigned event )
+/* -------------------------------------------------------------------------- */
+{
+	(void) event;
+
+	aob->temp = 0;
+	return aobIgnored;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+aos_t *priv_aob_super( aob_t *aob, aos_t *state )
+/* -------------------------------------------------------------------------- */
+{
+	if (state == aob_top)
+		return 0;
+
+	aob->temp = 0;
+	state(aob, aobEmpty);
+	assert(aob->temp);
+	return aob->temp;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_aob_enter( aob_t *aob, aos_t **path, unsigned depth )
+/* -------------------------------------------------------------------------- */
+{
+	// path[0] is the innermost state to enter
+	while (depth-- > 0)
+		path[depth](aob, aobEntry);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_aob_init( aob_t *aob )
+/* -------------------------------------------------------------------------- */
+{
+	aos_t *path[AOB_DEPTH];
+	aos_t *state;
+	unsigned depth;
+
+	while (aob->state(aob, aobInit) == aobTran)
+	{
+		// enter the states from the current state (excluded) down to the target state
+		for (state = aob->temp, depth = 0; state != aob->state; state = priv_aob_super(aob, state))
+		{
+			assert(state);
+			assert(depth < AOB_DEPTH);
+			path[depth++] = state;
+		}
+
+		aob->state = path[0];
+		priv_aob_enter(aob, path, depth);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_aob_trans( aob_t *aob, aos_t *source, aos_t *target )
+/* -------------------------------------------------------------------------- */
+{
+	aos_t *path[AOB_DEPTH];
+	aos_t *state;
+	unsigned depth;
+	unsigned i;
+
+	// exit from the current state up to the source state (excluded)
+	for (state = aob->state; state != source; state = priv_aob_super(aob, state))
+		state(aob, aobExit);
+
+	if (source == target)
+	{
+		// self-transition: exit and enter the source state
+		source(aob, aobExit);
+		path[0] = target;
+		depth = 1;
+	}
+	else
+	{
+		// build the path from the target state up to the top state
+		for (state = target, depth = 0; state; state = priv_aob_super(aob, state))
+		{
+			assert(depth < AOB_DEPTH);
+			path[depth++] = state;
+		}
+
+		// exit from the source state up to the least common ancestor (excluded)
+		for (state = source; state; state = priv_aob_super(aob, state))
+		{
+			for (i = 0; i < depth; i++)
+				if (path[i] == state)
+					break;
+			if (i < depth)
+			{
+				depth = i;
+				break;
+			}
+			state(aob, aobExit);
+		}
+	}
+
+	aob->state = target;
+	priv_aob_enter(aob, path, depth);
+	priv_aob_init(aob);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_aob_start( aob_t *aob )
+/* -------------------------------------------------------------------------- */
+{
+	aos_t *path[AOB_DEPTH];
+	aos_t *state;
+	unsigned depth;
+
+	// enter the states from the top state (excluded) down to the initial state
+	for (state = aob->state, depth = 0; state != aob_top; state = priv_aob_super(aob, state))
+	{
+		assert(depth < AOB_DEPTH);
+		path[depth++] = state;
+	}
+
+	priv_aob_enter(aob, path, depth);
+	priv_aob_init(aob);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_aob_dispatch( aob_t *aob, unsigned event )
+/* -------------------------------------------------------------------------- */
+{
+	aos_t *state;
+	unsigned result;
+
+	if (event == aobStart)
+	{
+		priv_aob_start(aob);
+		return;
+	}
+
+	// pass the event up the state hierarchy until it is handled
+	for (state = aob->state; state; state = aob->temp)
+	{
+		aob->temp = 0;
+		result = state(aob, event);
+
+		if (result == aobTran)
+		{
+			priv_aob_trans(aob, state, aob->temp);
+			break;
+		}
+
+		if (result != aobSuper)
+			break;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_aob_run( void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	aob_t *aob = arg;
+	unsigned event;
+	unsigned head;
+
+	sys_lock();
+	{
+		head = aob->head;
+		event = aob->data[head++];
+		aob->head = head < aob->limit ? head : 0;
+		aob->count--;
+	}
+	sys_unlock();
+
+	priv_aob_dispatch(aob, event);
+
+	sys_lock();
+	{
+		// one event per job: the other active objects of the worker pool are not starved
+		if (aob->count == 0 || wpl_give(aob->wpl, priv_aob_run, aob) != E_SUCCESS)
+			aob->busy = false;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_aob_put( aob_t *aob, unsigned event )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned tail;
+
+	if (aob->count >= aob->limit)
+	{
+		aob->lost++;
+		return E_TIMEOUT;
+	}
+
+	tail = aob->tail;
+	aob->data[tail++] = event;
+	aob->tail = tail < aob->limit ? tail : 0;
+	aob->count++;
+
+	if (!aob->busy)
+	{
+		aob->busy = true;
+		if (wpl_give(aob->wpl, priv_aob_run, aob) != E_SUCCESS)
+		{
+			assert(!"worker pool queue is shorter than the number of active objects");
+			aob->busy = false; // event stays queued until the next one is posted
+		}
+	}
+
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+void aob_start( aob_t *aob )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(aob);
+	assert(aob->next == 0 && Registry != aob);
+
+	sys_lock();
+	{
+		aob->next = Registry;
+		Registry = aob;
+		priv_aob_put(aob, aobStart);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned aob_post( aob_t *aob, unsigned event )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned result;
+
+	assert(aob);
+	assert(event < aobStart);
+
+	sys_lock();
+	{
+		result = priv_aob_put(aob, event);
+	}
+	sys_unlock();
+
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+void aob_subscribe( aob_t *aob, unsigned event )
+/* -------------------------------------------------------------------------- */
+{
+	assert(aob);
+	assert(event < 32);
+
+	sys_lock();
+	{
+		aob->subs |= 1UL << event;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void aob_unsubscribe( aob_t *aob, unsigned event )
+/* -------------------------------------------------------------------------- */
+{
+	assert(aob);
+	assert(event < 32);
+
+	sys_lock();
+	{
+		aob->subs &= ~(1UL << event);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned aob_publish( unsigned event )
+/* -------------------------------------------------------------------------- */
+{
+	aob_t *aob;
+	unsigned count = 0;
+
+	assert(event < 32);
+
+	sys_lock();
+	{
+		for (aob = Registry; aob; aob = aob->next)
+			if ((aob->subs & (1UL << event)) && priv_aob_put(aob, event) == E_SUCCESS)
+				count++;
+	}
+	sys_unlock();
+
+	return count;
+}
+
+/* -------------------------------------------------------------------------- */
+bool aob_isIn( aob_t *aob, aos_t *state )
+/* -------------------------------------------------------------------------- */
+{
+	aos_t *temp;
+	aos_t *s;
+
+	assert(aob);
+
+	temp = aob->temp;
+	for (s = aob->state; s; s = priv_aob_super(aob, s))
+		if (s == state)
+			break;
+
+	aob->temp = temp;
+
+	return s != 0;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,199 @@
+/******************************************************************************
+
+    @file    StateOS: osarena.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+
+#include "inc/osarena.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void arn_init( arn_t *arn, size_t size, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(arn);
+	assert(size);
+	assert(data);
+	assert(((size_t)data & (sizeof(stk_t) - 1)) == 0);
+
+	sys_lock();
+	{
+		memset(arn, 0, sizeof(arn_t));
+
+		arn->limit = LIMITED(size, stk_t);
+		arn->data  = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+arn_t *arn_create( size_t size )
+/* -------------------------------------------------------------------------- */
+{
+	arn_t *arn;
+
+	assert(!port_isr_inside());
+	assert(size);
+
+	size = ABOVE(size);
+
+	sys_lock();
+	{
+		arn = core_sys_alloc(ABOVE(sizeof(arn_t)) + size);
+		arn_init(arn, size, (void *)((size_t)arn + ABOVE(sizeof(arn_t))));
+		arn->res = arn;
+	}
+	sys_unlock();
+
+	return arn;
+}
+
+/* -------------------------------------------------------------------------- */
+void arn_delete( arn_t *arn )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(arn);
+
+	arn_reset(arn);
+	core_sys_free(arn->res);
+}
+
+/* -------------------------------------------------------------------------- */
+void *arn_alloc( arn_t *arn, size_t size )
+/* -------------------------------------------------------------------------- */
+{
+	void *ptr = 0;
+
+	assert(arn);
+	assert(arn->data);
+	assert(size);
+
+	size = ABOVE(size);
+
+	sys_lock();
+	{
+		if (size <= arn->limit - arn->used)
+		{
+			ptr = (char *)arn->data + arn->used;
+			arn->used += size;
+			if (arn->peak < arn->used)
+				arn->peak = arn->used;
+		}
+	}
+	sys_unlock();
+
+	return ptr;
+}
+
+/* -------------------------------------------------------------------------- */
+size_t arn_mark( arn_t *arn )
+/* -------------------------------------------------------------------------- */
+{
+	size_t mark;
+
+	assert(arn);
+
+	sys_lock();
+	{
+		mark = arn->used;
+	}
+	sys_unlock();
+
+	return mark;
+}
+
+/* -------------------------------------------------------------------------- */
+void arn_rewind( arn_t *arn, size_t mark )
+/* -------------------------------------------------------------------------- */
+{
+	assert(arn);
+
+	sys_lock();
+	{
+		assert(mark <= arn->used);
+
+		arn->used = mark;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+size_t arn_used( arn_t *arn )
+/* -------------------------------------------------------------------------- */
+{
+	size_t used;
+
+	assert(arn);
+
+	sys_lock();
+	{
+		used = arn->used;
+	}
+	sys_unlock();
+
+	return used;
+}
+
+/* -------------------------------------------------------------------------- */
+size_t arn_space( arn_t *arn )
+/* -------------------------------------------------------------------------- */
+{
+	size_t space;
+
+	assert(arn);
+
+	sys_lock();
+	{
+		space = arn->limit - arn->used;
+	}
+	sys_unlock();
+
+	return space;
+}
+
+/* -------------------------------------------------------------------------- */
+size_t arn_peak( arn_t *arn )
+/* -------------------------------------------------------------------------- */
+{
+	size_t peak;
+
+	assert(arn);
+
+	sys_lock();
+	{
+		peak = arn->peak;
+	}
+	sys_unlock();
+
+	return peak;
+}
+
+/* -------------------------------------------------------------------------- */
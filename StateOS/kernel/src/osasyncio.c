@@ -0,0 +1,265 @@
+/******************************************************************************
+
+    @file    StateOS: osasyncio.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+
+#include "inc/osasyncio.h"
+#include "inc/oscriticalsection.h"
+
+static obj_t AioAny = { 0 }; // tasks waiting in aio_waitAny
+
+/* -------------------------------------------------------------------------- */
+void aio_init( aio_t *aio, evq_t *evq, acp_t *fun )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(aio);
+
+	sys_lock();
+	{
+		memset(aio, 0, sizeof(aio_t));
+
+		tmr_initArg(&aio->tmr, core_aio_callback, aio);
+#if OS_TIMER_TASK
+		if (fun)
+		{
+			tmr_start(&aio->tmr, INFINITE, 0); // start the timer service task launching the callback
+			core_tmr_remove(&aio->tmr);
+		}
+#endif
+		aio->evq = evq;
+		aio->fun = fun;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_aio_wakeup( aio_t *aio, unsigned event )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk = aio->any;
+
+	core_all_wakeup(aio, event);
+
+	if (tsk)
+	{
+		aio->any = 0;
+		if (tsk->guard == &AioAny)
+			core_tsk_wakeup(tsk, event);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+void aio_kill( aio_t *aio )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(aio);
+
+	sys_lock();
+	{
+		if (aio->tmr.id != ID_STOPPED)
+			core_tmr_remove(&aio->tmr);
+
+		aio->state = aioIdle;
+
+		priv_aio_wakeup(aio, E_STOPPED);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned aio_start( aio_t *aio )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(aio);
+
+	sys_lock();
+	{
+		if (aio->state != aioPending)
+		{
+			aio->state  = aioPending;
+			aio->result = 0;
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned aio_complete( aio_t *aio, unsigned result )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(aio);
+
+	sys_lock();
+	{
+		if (aio->state == aioPending)
+		{
+			aio->state  = aioDone;
+			aio->result = result;
+
+			priv_aio_wakeup(aio, E_SUCCESS);
+
+			if (aio->evq)
+				(void) evq_give(aio->evq, result);
+
+			if (aio->fun)
+			{
+				if (aio->tmr.id != ID_STOPPED)
+					core_tmr_remove(&aio->tmr); // pending in the timer service task
+				aio->tmr.start  = core_sys_time();
+				aio->tmr.delay  = 0;
+				aio->tmr.period = 0;
+				core_tmr_insert(&aio->tmr, ID_TIMER);
+			}
+
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned aio_take( aio_t *aio )
+/* -------------------------------------------------------------------------- */
+{
+	assert(aio);
+
+	return aio->state == aioDone ? E_SUCCESS : E_TIMEOUT;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_aio_wait( aio_t *aio, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(!port_isr_inside());
+	assert(aio);
+
+	sys_lock();
+	{
+		if (aio->state == aioDone)
+			event = E_SUCCESS;
+		else
+		if (aio->state == aioPending)
+			event = wait(aio, time);
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned aio_waitFor( aio_t *aio, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_aio_wait(aio, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned aio_waitUntil( aio_t *aio, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_aio_wait(aio, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_aio_scan( aio_t * const *list, unsigned cnt )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned i;
+
+	for (i = 0; i < cnt; i++)
+		if (list[i]->state == aioDone)
+			return i;
+
+	return E_TIMEOUT;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned aio_waitAny( aio_t * const *list, unsigned cnt, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+	unsigned i;
+
+	assert(!port_isr_inside());
+	assert(list || cnt == 0);
+
+	sys_lock();
+	{
+		event = priv_aio_scan(list, cnt);
+
+		if (event == E_TIMEOUT && delay != IMMEDIATE)
+		{
+			for (i = 0; i < cnt; i++)
+			{
+				assert(list[i]->any == 0);
+				list[i]->any = System.cur;
+			}
+
+			event = core_tsk_waitFor(&AioAny, delay);
+
+			for (i = 0; i < cnt; i++)
+				if (list[i]->any == System.cur)
+					list[i]->any = 0;
+
+			if (event == E_SUCCESS)
+				event = priv_aio_scan(list, cnt);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+void core_aio_callback( void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	aio_t *aio = arg;
+
+	aio->fun(aio);
+}
+
+/* -------------------------------------------------------------------------- */
@@ -74,6 +74,8 @@ bar_t *bar_create( unsigned limit )
 void bar_kill( bar_t *bar )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(bar);
 
@@ -81,21 +83,19 @@ void bar_kill( bar_t *bar )
 	{
 		bar->count = bar->limit;
 
-		core_all_wakeup(bar, E_STOPPED);
+		core_all_detach(bar, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void bar_delete( bar_t *bar )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
-	{
-		bar_kill(bar);
-		core_sys_free(bar->res);
-	}
-	sys_unlock();
+	bar_kill(bar);
+	core_sys_free(bar->res);
 }
 
 /* -------------------------------------------------------------------------- */
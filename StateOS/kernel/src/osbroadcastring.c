@@ -0,0 +1,230 @@
+/******************************************************************************
+
+    @file    StateOS: osbroadcastring.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osbroadcastring.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void brd_init( brd_t *brd, unsigned limit, unsigned size, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(brd);
+	assert(limit);
+	assert(size);
+	assert(data);
+
+	sys_lock();
+	{
+		memset(brd, 0, sizeof(brd_t));
+
+		brd->limit = limit;
+		brd->size  = size;
+		brd->data  = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+brd_t *brd_create( unsigned limit, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	brd_t *brd;
+
+	assert(!port_isr_inside());
+	assert(limit);
+	assert(size);
+
+	sys_lock();
+	{
+		brd = core_sys_alloc(ABOVE(sizeof(brd_t)) + limit * size);
+		brd_init(brd, limit, size, (void *)((size_t)brd + ABOVE(sizeof(brd_t))));
+		brd->res = brd;
+	}
+	sys_unlock();
+
+	return brd;
+}
+
+/* -------------------------------------------------------------------------- */
+void brd_kill( brd_t *brd )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t hld;
+
+	assert(!port_isr_inside());
+	assert(brd);
+
+	sys_lock();
+	{
+		core_all_detach(brd, &hld);
+	}
+	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
+}
+
+/* -------------------------------------------------------------------------- */
+void brd_delete( brd_t *brd )
+/* -------------------------------------------------------------------------- */
+{
+	brd_kill(brd);
+	core_sys_free(brd->res);
+}
+
+/* -------------------------------------------------------------------------- */
+void brd_subscribe( brd_t *brd, brc_t *brc )
+/* -------------------------------------------------------------------------- */
+{
+	assert(brd);
+	assert(brc);
+
+	sys_lock();
+	{
+		brc->seq = brd->seq;
+		brc->lag = 0;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_brd_count( brd_t *brd, brc_t *brc )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt = brd->seq - brc->seq;
+
+	if (cnt > brd->limit)
+	{
+		// the reader fell behind the writer, the oldest records were overwritten
+		brc->lag += cnt - brd->limit;
+		brc->seq  = brd->seq - brd->limit;
+		cnt = brd->limit;
+	}
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_brd_get( brd_t *brd, brc_t *brc, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned pos = (brd->head + brd->limit - priv_brd_count(brd, brc)) % brd->limit;
+
+	memcpy(data, &brd->data[pos * brd->size], brd->size);
+	brc->seq++;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_brd_wait( brd_t *brd, brc_t *brc, void *data, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_SUCCESS;
+
+	assert(brd);
+	assert(brc);
+	assert(data);
+
+	sys_lock();
+	{
+		if (brc->seq == brd->seq)
+			event = wait ? wait(brd, time) : E_TIMEOUT;
+
+		// every successful wakeup is caused by a new record
+		if (event == E_SUCCESS)
+			priv_brd_get(brd, brc, data);
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned brd_take( brd_t *brd, brc_t *brc, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_brd_wait(brd, brc, data, 0, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned brd_waitFor( brd_t *brd, brc_t *brc, void *data, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_brd_wait(brd, brc, data, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned brd_waitUntil( brd_t *brd, brc_t *brc, void *data, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_brd_wait(brd, brc, data, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+void brd_give( brd_t *brd, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(brd);
+	assert(data);
+
+	sys_lock();
+	{
+		memcpy(&brd->data[brd->head * brd->size], data, brd->size);
+		if (++brd->head == brd->limit)
+			brd->head = 0;
+		brd->seq++;
+
+		core_all_wakeup(brd, E_SUCCESS);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned brd_count( brd_t *brd, brc_t *brc )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(brd);
+	assert(brc);
+
+	sys_lock();
+	{
+		cnt = priv_brd_count(brd, brc);
+	}
+	sys_unlock();
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,162 @@
+/******************************************************************************
+
+    @file    StateOS: oscoalescer.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/oscoalescer.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void coa_sem( void *obj, unsigned count )
+/* -------------------------------------------------------------------------- */
+{
+	while (count-- > 0 && sem_give(obj) == E_SUCCESS);
+}
+
+/* -------------------------------------------------------------------------- */
+void coa_evq( void *obj, unsigned count )
+/* -------------------------------------------------------------------------- */
+{
+	(void) evq_give(obj, count);
+}
+
+/* -------------------------------------------------------------------------- */
+void coa_ntf( void *obj, unsigned count )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_notify(obj, ntfAdd, count);
+}
+
+/* -------------------------------------------------------------------------- */
+void coa_init( coa_t *coa, cof_t *flush, void *obj, unsigned limit, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(coa);
+	assert(flush);
+	assert(limit);
+
+	sys_lock();
+	{
+		memset(coa, 0, sizeof(coa_t));
+
+		tmr_initArg(&coa->tmr, core_coa_timeout, coa);
+#if OS_TIMER_TASK
+		tmr_start(&coa->tmr, INFINITE, 0); // start the timer service task executing the flush
+		core_tmr_remove(&coa->tmr);
+#endif
+		coa->flush = flush;
+		coa->obj   = obj;
+		coa->limit = limit;
+		coa->delay = delay;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_coa_flush( coa_t *coa )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned count = coa->count;
+
+	if (coa->tmr.id != ID_STOPPED)
+		core_tmr_remove(&coa->tmr);
+
+	if (count > 0)
+	{
+		coa->count = 0;
+		coa->flush(coa->obj, count);
+	}
+
+	return count;
+}
+
+/* -------------------------------------------------------------------------- */
+void coa_give( coa_t *coa )
+/* -------------------------------------------------------------------------- */
+{
+	assert(coa);
+
+	sys_lock();
+	{
+		if (++coa->count >= coa->limit)
+		{
+			(void) priv_coa_flush(coa);
+		}
+		else
+		if (coa->count == 1 && coa->delay != 0)
+		{
+			if (coa->tmr.id != ID_STOPPED)
+				core_tmr_remove(&coa->tmr); // pending in the timer service task
+			coa->tmr.start  = core_sys_time();
+			coa->tmr.delay  = coa->delay;
+			coa->tmr.period = 0;
+			core_tmr_insert(&coa->tmr, ID_TIMER);
+		}
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned coa_flush( coa_t *coa )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned count;
+
+	assert(coa);
+
+	sys_lock();
+	{
+		count = priv_coa_flush(coa);
+	}
+	sys_unlock();
+
+	return count;
+}
+
+/* -------------------------------------------------------------------------- */
+void core_coa_timeout( void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	coa_t *coa = arg;
+	unsigned count;
+
+	sys_lock();
+	{
+		count = coa->count;
+		coa->count = 0;
+	}
+	sys_unlock();
+
+	if (count > 0)
+		coa->flush(coa->obj, count);
+}
+
+/* -------------------------------------------------------------------------- */
@@ -30,6 +30,7 @@
  ******************************************************************************/
 
 #include "inc/osconditionvariable.h"
+#include "inc/ostask.h"
 #include "inc/oscriticalsection.h"
 
 /* -------------------------------------------------------------------------- */
@@ -69,26 +70,26 @@ cnd_t *cnd_create( void )
 void cnd_kill( cnd_t *cnd )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(cnd);
 
 	sys_lock();
 	{
-		core_all_wakeup(cnd, E_STOPPED);
+		core_all_detach(cnd, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void cnd_delete( cnd_t *cnd )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
-	{
-		cnd_kill(cnd);
-		core_sys_free(cnd->res);
-	}
-	sys_unlock();
+	cnd_kill(cnd);
+	core_sys_free(cnd->res);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -104,9 +105,15 @@ unsigned priv_cnd_wait( cnd_t *cnd, mtx_t *mtx, cnt_t time, unsigned(*wait)(void
 
 	sys_lock();
 	{
+		System.cur->tmp.cnd.mtx = mtx;
+		System.cur->tmp.cnd.mut = 0;
+
 		if ((event = mtx_give(mtx))   == E_SUCCESS)
 		if ((event = wait(cnd, time)) == E_SUCCESS)
+		if (System.cur->tmp.cnd.mtx)  // otherwise the mutex has been already handed over by its owner
 		     event = mtx_wait(mtx);
+
+		System.cur->mtx.tree = 0;
 	}
 	sys_unlock();
 
@@ -127,6 +134,112 @@ unsigned cnd_waitUntil( cnd_t *cnd, mtx_t *mtx, cnt_t time )
 	return priv_cnd_wait(cnd, mtx, time, core_tsk_waitUntil);
 }
 
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_cnd_waitFast( cnd_t *cnd, mut_t *mut, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(cnd);
+	assert(mut);
+
+	sys_lock();
+	{
+		System.cur->tmp.cnd.mtx = 0;
+		System.cur->tmp.cnd.mut = mut;
+
+		if ((event = mut_give(mut))   == E_SUCCESS)
+		if ((event = wait(cnd, time)) == E_SUCCESS)
+		if (System.cur->tmp.cnd.mut)  // otherwise the fast mutex has been already handed over by its owner
+		{
+			if (mut->owner == 0)
+				mut->owner = System.cur;
+			else
+				event = core_tsk_waitFor(mut, INFINITE);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned cnd_waitFastFor( cnd_t *cnd, mut_t *mut, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_cnd_waitFast(cnd, mut, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned cnd_waitFastUntil( cnd_t *cnd, mut_t *mut, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_cnd_waitFast(cnd, mut, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_cnd_wakeupFast( tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	mut_t *mut = tsk->tmp.cnd.mut;
+
+	if (mut->owner == 0 || mut->owner == tsk)
+	{
+		core_tsk_wakeup(tsk, E_SUCCESS);
+		return;
+	}
+
+	// wait morphing: the task is moved to the fast mutex queue and waits indefinitely for the handover,
+	// the fast mutex has no priority inheritance, so the owner is left untouched
+	tsk->tmp.cnd.mut = 0;
+
+	core_tmr_remove((tmr_t *)tsk);
+	tsk->delay = INFINITE;
+	core_tmr_insert((tmr_t *)tsk, ID_DELAYED);
+
+	core_tsk_transfer(tsk, mut);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_cnd_wakeup( tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	mtx_t *mtx = tsk->tmp.cnd.mtx;
+
+	if (tsk->tmp.cnd.mut)
+	{
+		priv_cnd_wakeupFast(tsk);
+		return;
+	}
+
+	if (mtx->owner == 0 || mtx->owner == tsk || mtx->barging)
+	{
+		core_tsk_wakeup(tsk, E_SUCCESS);
+		return;
+	}
+
+	// wait morphing: the task would be blocked on the mutex immediately after its wakeup,
+	// so it is moved to the mutex queue and waits indefinitely for the mutex handover
+	tsk->tmp.cnd.mtx = 0;
+
+	core_tmr_remove((tmr_t *)tsk);
+	tsk->delay = INFINITE;
+	core_tmr_insert((tmr_t *)tsk, ID_DELAYED);
+
+	if (mtx->ceiling == 0)
+	{
+		tsk->mtx.tree = mtx->owner;
+		if (mtx->owner->prio < tsk->prio)
+			core_tsk_prio(mtx->owner, tsk->prio);
+	}
+
+	core_tsk_transfer(tsk, mtx);
+}
+
 /* -------------------------------------------------------------------------- */
 void cnd_give( cnd_t *cnd, bool all )
 /* -------------------------------------------------------------------------- */
@@ -135,8 +248,8 @@ void cnd_give( cnd_t *cnd, bool all )
 
 	sys_lock();
 	{
-		if (all) core_all_wakeup(cnd, E_SUCCESS);
-		else     core_one_wakeup(cnd, E_SUCCESS);
+		if (all) while (cnd->queue) priv_cnd_wakeup(cnd->queue);
+		else     if    (cnd->queue) priv_cnd_wakeup(cnd->queue);
 	}
 	sys_unlock();
 }
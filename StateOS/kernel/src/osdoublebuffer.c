@@ -0,0 +1,268 @@
+/******************************************************************************
+
+    @file    StateOS: osdoublebuffer.c
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osdoublebuffer.h"
+#include "inc/ostask.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void dbf_init( dbf_t *dbf, unsigned limit, unsigned size, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(dbf);
+	assert(limit >= 2);
+	assert(size);
+	assert(data);
+
+	sys_lock();
+	{
+		memset(dbf, 0, sizeof(dbf_t));
+
+		dbf->limit = limit;
+		dbf->size  = size;
+		dbf->data  = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+dbf_t *dbf_create( unsigned limit, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	dbf_t *dbf;
+
+	assert(!port_isr_inside());
+	assert(limit >= 2);
+	assert(size);
+
+	sys_lock();
+	{
+		dbf = core_sys_alloc(ABOVE(sizeof(dbf_t)) + limit * size);
+		dbf_init(dbf, limit, size, (void *)((size_t)dbf + ABOVE(sizeof(dbf_t))));
+		dbf->res = dbf;
+	}
+	sys_unlock();
+
+	return dbf;
+}
+
+/* -------------------------------------------------------------------------- */
+void dbf_kill( dbf_t *dbf )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t hld;
+
+	assert(!port_isr_inside());
+	assert(dbf);
+
+	sys_lock();
+	{
+		dbf->fill  = 0;
+		dbf->head  = 0;
+		dbf->count = 0;
+		dbf->owned = 0;
+
+		core_all_detach(dbf, &hld);
+	}
+	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
+}
+
+/* -------------------------------------------------------------------------- */
+void dbf_delete( dbf_t *dbf )
+/* -------------------------------------------------------------------------- */
+{
+	dbf_kill(dbf);
+	core_sys_free(dbf->res);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_dbf_next( dbf_t *dbf, unsigned index )
+/* -------------------------------------------------------------------------- */
+{
+	return index + 1 < dbf->limit ? index + 1 : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_dbf_get( dbf_t *dbf, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	*data = dbf->data + dbf->head * dbf->size;
+	dbf->head = priv_dbf_next(dbf, dbf->head);
+	dbf->count--;
+	dbf->owned++;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_dbf_invalidate( dbf_t *dbf, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	// discard the data cache lines of the taken buffer (the producer has written it by DMA)
+#ifdef CACHE_LINE
+	port_cache_invalidate(data, dbf->size);
+#else
+	(void) dbf; (void) data;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+void *dbf_swap( dbf_t *dbf )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+	void  *ptr;
+
+	assert(dbf);
+
+	sys_lock();
+	{
+		if (dbf->count + dbf->owned + 1 < dbf->limit)
+		{
+			dbf->fill = priv_dbf_next(dbf, dbf->fill);
+			dbf->count++;
+
+			tsk = core_one_wakeup(dbf, E_SUCCESS);
+			if (tsk) priv_dbf_get(dbf, tsk->tmp.dbf.data);
+		}
+		else
+		if (dbf->owned == 0)
+		{
+			// the next buffer is the oldest filled one: drop it
+			dbf->lost++;
+			dbf->head = priv_dbf_next(dbf, dbf->head);
+			dbf->fill = priv_dbf_next(dbf, dbf->fill);
+		}
+		else
+		{
+			// the next buffer is held by the consumer: fill the active buffer again
+			dbf->lost++;
+		}
+
+		ptr = dbf_active(dbf);
+	}
+	sys_unlock();
+
+	return ptr;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_dbf_wait( dbf_t *dbf, void **data, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_SUCCESS;
+
+	assert(!port_isr_inside());
+	assert(dbf);
+	assert(data);
+
+	sys_lock();
+	{
+		if (dbf->count > 0)
+		{
+			priv_dbf_get(dbf, data);
+		}
+		else
+		{
+			System.cur->tmp.dbf.data = data;
+			event = wait(dbf, time);
+		}
+	}
+	sys_unlock();
+
+	if (event == E_SUCCESS)
+		priv_dbf_invalidate(dbf, *data);
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned dbf_waitFor( dbf_t *dbf, void **data, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_dbf_wait(dbf, data, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned dbf_waitUntil( dbf_t *dbf, void **data, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_dbf_wait(dbf, data, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned dbf_take( dbf_t *dbf, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_dbf_wait(dbf, data, IMMEDIATE, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+void dbf_release( dbf_t *dbf, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(dbf);
+	assert(dbf->owned > 0);
+
+	sys_lock();
+	{
+		assert(data == dbf->data + (dbf->head + dbf->limit - dbf->owned) % dbf->limit * dbf->size);
+		(void) data;
+
+		dbf->owned--;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned dbf_lost( dbf_t *dbf )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned lost;
+
+	assert(dbf);
+
+	sys_lock();
+	{
+		lost = dbf->lost;
+	}
+	sys_unlock();
+
+	return lost;
+}
+
+/* -------------------------------------------------------------------------- */
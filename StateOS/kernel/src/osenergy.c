@@ -0,0 +1,182 @@
+/******************************************************************************
+
+    @file    StateOS: osenergy.c
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osenergy.h"
+#include "inc/oscriticalsection.h"
+
+#if OS_TASK_ENERGY
+
+static
+const nrg_t *NrgCal = 0;
+
+static
+uint32_t NrgFreq = 0;  // frequency the rate was computed for
+
+static
+uint64_t NrgRate = 0;  // energy of one running cpu cycle (pJ, 16.16 fixed point)
+
+static
+struct { uint64_t time; uint64_t energy; } NrgState[NRG_STATES] = { { 0, 0 } };
+
+/* -------------------------------------------------------------------------- */
+
+static
+uint32_t priv_nrg_freq( void )
+{
+#if OS_CPU_SCALING
+	return port_cpu_frequency;
+#else
+	return NrgCal->freq;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_nrg_rate( uint32_t freq )
+{
+	NrgFreq = freq;
+	NrgRate = (uint64_t)NrgCal->cycle << 16;
+	if (freq)
+		NrgRate += ((uint64_t)NrgCal->run * 1000000U << 16) / freq;
+}
+
+/* -------------------------------------------------------------------------- */
+void core_nrg_run( uint32_t cyc )
+/* -------------------------------------------------------------------------- */
+{
+	uint32_t freq;
+
+	if (NrgCal == 0)
+		return;
+
+	freq = priv_nrg_freq();
+	if (freq != NrgFreq)
+		priv_nrg_rate(freq);
+
+	System.cur->energy += (cyc * NrgRate) >> 16;
+}
+
+/* -------------------------------------------------------------------------- */
+void core_nrg_sleep( unsigned state, cnt_t cnt )
+/* -------------------------------------------------------------------------- */
+{
+	uint64_t energy;
+
+	NrgState[state].time += cnt;
+
+	if (NrgCal == 0)
+		return;
+
+	energy = (uint64_t)cnt * NrgCal->sleep[state] * 1000000U / (OS_FREQUENCY);
+	NrgState[state].energy += energy;
+	IDLE.energy += energy;
+}
+
+/* -------------------------------------------------------------------------- */
+void nrg_calibrate( const nrg_t *cal )
+/* -------------------------------------------------------------------------- */
+{
+	sys_lock();
+	{
+		core_cur_account();
+		NrgCal = cal;
+		if (cal)
+			priv_nrg_rate(priv_nrg_freq());
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void nrg_sleep( unsigned state, cnt_t ticks )
+/* -------------------------------------------------------------------------- */
+{
+	assert(state < NRG_STATES);
+
+	sys_lock();
+	{
+		core_nrg_sleep(state, ticks);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+uint64_t nrg_getTask( tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	uint64_t energy;
+
+	assert(tsk);
+
+	sys_lock();
+	{
+		core_cur_account();
+		energy = tsk->energy;
+	}
+	sys_unlock();
+
+	return energy;
+}
+
+/* -------------------------------------------------------------------------- */
+void nrg_reset( tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	assert(tsk);
+
+	sys_lock();
+	{
+		core_cur_account();
+		tsk->energy = 0;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+uint64_t nrg_getState( unsigned state, uint64_t *ticks )
+/* -------------------------------------------------------------------------- */
+{
+	uint64_t energy;
+
+	assert(state < NRG_STATES);
+
+	sys_lock();
+	{
+		if (ticks)
+			*ticks = NrgState[state].time;
+		energy = NrgState[state].energy;
+	}
+	sys_unlock();
+
+	return energy;
+}
+
+#endif//OS_TASK_ENERGY
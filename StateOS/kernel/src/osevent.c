@@ -69,26 +69,26 @@ evt_t *evt_create( void )
 void evt_kill( evt_t *evt )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(evt);
 
 	sys_lock();
 	{
-		core_all_wakeup(evt, E_STOPPED);
+		core_all_detach(evt, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void evt_delete( evt_t *evt )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
-	{
-		evt_kill(evt);
-		core_sys_free(evt->res);
-	}
-	sys_unlock();
+	evt_kill(evt);
+	core_sys_free(evt->res);
 }
 
 /* -------------------------------------------------------------------------- */
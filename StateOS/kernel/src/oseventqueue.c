@@ -34,13 +34,14 @@
 #include "inc/oscriticalsection.h"
 
 /* -------------------------------------------------------------------------- */
-void evq_init( evq_t *evq, unsigned limit, unsigned *data )
+void evq_initSize( evq_t *evq, unsigned limit, void *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
 	assert(!port_isr_inside());
 	assert(evq);
 	assert(limit);
 	assert(data);
+	assert(size == sizeof(unsigned) || size == sizeof(uint16_t) || size == sizeof(uint8_t));
 
 	sys_lock();
 	{
@@ -48,12 +49,20 @@ void evq_init( evq_t *evq, unsigned limit, unsigned *data )
 
 		evq->limit = limit;
 		evq->data  = data;
+		evq->size  = size;
 	}
 	sys_unlock();
 }
 
 /* -------------------------------------------------------------------------- */
-evq_t *evq_create( unsigned limit )
+void evq_init( evq_t *evq, unsigned limit, unsigned *data )
+/* -------------------------------------------------------------------------- */
+{
+	evq_initSize(evq, limit, data, sizeof(unsigned));
+}
+
+/* -------------------------------------------------------------------------- */
+evq_t *evq_createSize( unsigned limit, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
 	evq_t *evq;
@@ -63,8 +72,8 @@ evq_t *evq_create( unsigned limit )
 
 	sys_lock();
 	{
-		evq = core_sys_alloc(ABOVE(sizeof(evq_t)) + limit * sizeof(unsigned));
-		evq_init(evq, limit, (void *)((size_t)evq + ABOVE(sizeof(evq_t))));
+		evq = core_sys_alloc(ABOVE(sizeof(evq_t)) + limit * size);
+		evq_initSize(evq, limit, (void *)((size_t)evq + ABOVE(sizeof(evq_t))), size);
 		evq->res = evq;
 	}
 	sys_unlock();
@@ -72,10 +81,19 @@ evq_t *evq_create( unsigned limit )
 	return evq;
 }
 
+/* -------------------------------------------------------------------------- */
+evq_t *evq_create( unsigned limit )
+/* -------------------------------------------------------------------------- */
+{
+	return evq_createSize(limit, sizeof(unsigned));
+}
+
 /* -------------------------------------------------------------------------- */
 void evq_kill( evq_t *evq )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(evq);
 
@@ -84,22 +102,49 @@ void evq_kill( evq_t *evq )
 		evq->count = 0;
 		evq->head  = 0;
 		evq->tail  = 0;
+#if OS_EVQ_LOCKFREE
+		evq->done  = evq->post;
+#endif
 
-		core_all_wakeup(evq, E_STOPPED);
+		core_all_detach(evq, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void evq_delete( evq_t *evq )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
+	evq_kill(evq);
+	core_sys_free(evq->res);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_evq_read( evq_t *evq, unsigned i )
+/* -------------------------------------------------------------------------- */
+{
+	switch (evq->size)
 	{
-		evq_kill(evq);
-		core_sys_free(evq->res);
+	case sizeof(uint8_t):  return ((uint8_t  *)evq->data)[i];
+	case sizeof(uint16_t): return ((uint16_t *)evq->data)[i];
+	default:               return ((unsigned *)evq->data)[i];
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_evq_write( evq_t *evq, unsigned i, unsigned event )
+/* -------------------------------------------------------------------------- */
+{
+	switch (evq->size)
+	{
+	case sizeof(uint8_t):  ((uint8_t  *)evq->data)[i] = (uint8_t) event; break;
+	case sizeof(uint16_t): ((uint16_t *)evq->data)[i] = (uint16_t)event; break;
+	default:               ((unsigned *)evq->data)[i] = event;           break;
 	}
-	sys_unlock();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -110,7 +155,7 @@ unsigned priv_evq_get( evq_t *evq )
 	unsigned event;
 	unsigned i = evq->head;
 
-	event = evq->data[i++];
+	event = priv_evq_read(evq, i++);
 
 	evq->head = (i < evq->limit) ? i : 0;
 	evq->count--;
@@ -125,7 +170,7 @@ void priv_evq_put( evq_t *evq, unsigned event )
 {
 	unsigned i = evq->tail;
 
-	evq->data[i++] = event;
+	priv_evq_write(evq, i++, event);
 
 	evq->tail = (i < evq->limit) ? i : 0;
 	evq->count++;
@@ -164,8 +209,90 @@ void priv_evq_putUpdate( evq_t *evq, const unsigned data )
 	priv_evq_put(evq, data);
 	if (evq->queue)
 		core_one_wakeup(evq, priv_evq_get(evq));
+	else
+		core_sel_notify(evq);
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_EVQ_LOCKFREE
+
+static
+evq_t * volatile Deferred = 0;
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_evq_sync( evq_t *evq )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned post = evq->post;
+
+	evq->count += post - evq->done;
+	port_mem_barrier();
+	evq->done = post;
 }
 
+/* -------------------------------------------------------------------------- */
+unsigned evq_postISR( evq_t *evq, unsigned data )
+/* -------------------------------------------------------------------------- */
+{
+	evq_t  * lst;
+	unsigned done;
+	unsigned i;
+
+	assert(evq);
+
+	done = evq->done;
+	port_mem_barrier();
+
+	if (evq->count + (evq->post - done) >= evq->limit)
+		return E_TIMEOUT;
+
+	i = evq->tail;
+	priv_evq_write(evq, i++, data);
+	evq->tail = (i < evq->limit) ? i : 0;
+
+	port_mem_barrier();
+	evq->post++;
+
+	if (evq->flag == 0)
+	{
+		evq->flag = 1;
+		do evq->link = lst = Deferred;
+		while (!port_atomic_cas((void * volatile *)&Deferred, lst, evq));
+	}
+
+	if (evq->queue)
+		port_ctx_switch();
+
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+void core_evq_handler( void )
+/* -------------------------------------------------------------------------- */
+{
+	evq_t *evq, *nxt;
+
+	do nxt = Deferred;
+	while (nxt && !port_atomic_cas((void * volatile *)&Deferred, nxt, 0));
+
+	while ((evq = nxt) != 0)
+	{
+		nxt = evq->link;
+		port_mem_barrier();
+		evq->flag = 0;
+
+		priv_evq_sync(evq);
+		while (evq->count > 0 && evq->queue)
+			core_one_wakeup(evq, priv_evq_get(evq));
+		if (evq->count > 0)
+			core_sel_notify(evq);
+	}
+}
+
+#endif//OS_EVQ_LOCKFREE
+
 /* -------------------------------------------------------------------------- */
 unsigned evq_take( evq_t *evq )
 /* -------------------------------------------------------------------------- */
@@ -176,6 +303,9 @@ unsigned evq_take( evq_t *evq )
 
 	sys_lock();
 	{
+#if OS_EVQ_LOCKFREE
+		priv_evq_sync(evq);
+#endif
 		if (evq->count > 0)
 		{
 			event = priv_evq_getUpdate(evq);
@@ -198,6 +328,9 @@ unsigned priv_evq_wait( evq_t *evq, cnt_t time, unsigned(*wait)(void*,cnt_t) )
 
 	sys_lock();
 	{
+#if OS_EVQ_LOCKFREE
+		priv_evq_sync(evq);
+#endif
 		if (evq->count > 0)
 		{
 			event = priv_evq_getUpdate(evq);
@@ -226,6 +359,65 @@ unsigned evq_waitUntil( evq_t *evq, cnt_t time )
 	return priv_evq_wait(evq, time, core_tsk_waitUntil);
 }
 
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_evq_getN( evq_t *evq, unsigned *data, unsigned max )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t  * tsk;
+	unsigned cnt = 0;
+
+	while (evq->count > 0 && cnt < max)
+		data[cnt++] = priv_evq_get(evq);
+
+	while (evq->count < evq->limit && (tsk = core_one_wakeup(evq, E_SUCCESS)) != 0)
+		priv_evq_put(evq, tsk->tmp.evq.event);
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned evq_waitN( evq_t *evq, unsigned *data, unsigned max, unsigned *got, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_SUCCESS;
+	unsigned cnt   = 0;
+
+	assert(!port_isr_inside());
+	assert(evq);
+	assert(data);
+	assert(max);
+
+	sys_lock();
+	{
+#if OS_EVQ_LOCKFREE
+		priv_evq_sync(evq);
+#endif
+		if (evq->count == 0)
+		{
+			event = core_tsk_waitFor(evq, delay);
+			if (event != E_STOPPED && event != E_TIMEOUT)
+			{
+				data[cnt++] = event;
+				event = E_SUCCESS;
+			}
+		}
+
+		if (event == E_SUCCESS)
+		{
+#if OS_EVQ_LOCKFREE
+			priv_evq_sync(evq);
+#endif
+			cnt += priv_evq_getN(evq, data + cnt, max - cnt);
+		}
+	}
+	sys_unlock();
+
+	if (got) *got = cnt;
+
+	return event;
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned evq_give( evq_t *evq, unsigned data )
 /* -------------------------------------------------------------------------- */
@@ -234,6 +426,9 @@ unsigned evq_give( evq_t *evq, unsigned data )
 
 	assert(evq);
 
+	if (evq->over)
+		return evq_push(evq, data);
+
 	sys_lock();
 	{
 		if (evq->count < evq->limit)
@@ -257,6 +452,9 @@ unsigned priv_evq_send( evq_t *evq, unsigned data, cnt_t time, unsigned(*wait)(v
 	assert(!port_isr_inside());
 	assert(evq);
 
+	if (evq->over)
+		return evq_push(evq, data);
+
 	sys_lock();
 	{
 		if (evq->count < evq->limit)
@@ -302,7 +500,10 @@ unsigned evq_push( evq_t *evq, unsigned data )
 		if (evq->count == 0 || evq->queue == 0)
 		{
 			if (evq->count == evq->limit)
+			{
 				priv_evq_skip(evq);
+				evq->drop++;
+			}
 			priv_evq_putUpdate(evq, data);
 			event = E_SUCCESS;
 		}
@@ -313,3 +514,33 @@ unsigned evq_push( evq_t *evq, unsigned data )
 }
 
 /* -------------------------------------------------------------------------- */
+void evq_setOverwrite( evq_t *evq, bool enable )
+/* -------------------------------------------------------------------------- */
+{
+	assert(evq);
+
+	sys_lock();
+	{
+		evq->over = enable;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned evq_dropped( evq_t *evq )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(evq);
+
+	sys_lock();
+	{
+		cnt = evq->drop;
+	}
+	sys_unlock();
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,86 @@
+/******************************************************************************
+
+    @file    StateOS: osexecutive.c
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osexecutive.h"
+#include "inc/oscriticalsection.h"
+
+#if OS_TIME_TRIGGER
+
+/* -------------------------------------------------------------------------- */
+void tte_start( const tta_t *tab, unsigned cnt, cnt_t frame )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned i;
+
+	assert(!port_isr_inside());
+	assert(tab);
+	assert(cnt);
+	assert(frame > 0 && frame != INFINITE);
+
+	for (i = 0; i < cnt; i++)
+		assert(tab[i].fun && tab[i].offset < frame && tab[i].period < frame);
+
+	sys_lock();
+	{
+		core_tte_start(tab, cnt, frame);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void tte_stop( void )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+
+	sys_lock();
+	{
+		core_tte_start(0, 0, 0);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned tte_late( void )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned late;
+
+	sys_lock();
+	{
+		late = core_tte_late();
+	}
+	sys_unlock();
+
+	return late;
+}
+
+#endif//OS_TIME_TRIGGER
@@ -30,6 +30,7 @@
  ******************************************************************************/
 
 #include "inc/osfastmutex.h"
+#include "inc/ostask.h"
 #include "inc/oscriticalsection.h"
 
 /* -------------------------------------------------------------------------- */
@@ -69,28 +70,74 @@ mut_t *mut_create( void )
 void mut_kill( mut_t *mut )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(mut);
 
 	sys_lock();
 	{
-		core_all_wakeup(mut, E_STOPPED);
+		core_all_detach(mut, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void mut_delete( mut_t *mut )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
+	mut_kill(mut);
+	core_sys_free(mut->res);
+}
+
+#if OS_MUT_SPIN
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_mut_spin( mut_t *mut )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t  * own;
+	unsigned cnt;
+
+	for (cnt = OS_MUT_SPIN; cnt; cnt--)
 	{
-		mut_kill(mut);
-		core_sys_free(mut->res);
+		own = mut->owner;
+
+		if (own == 0 || own == System.cur)
+			break;							// the mutex is free or already owned
+
+		if (own->id != ID_READY || own->prio < System.cur->prio)
+			break;							// the owner can't run before the current task blocks
+
+		tsk_yield();						// let the owner finish its critical region
 	}
-	sys_unlock();
 }
 
+#endif
+
+#if OS_MUT_LOCKFREE
+
+/* -------------------------------------------------------------------------- */
+static
+bool priv_mut_tryLock( mut_t *mut )
+/* -------------------------------------------------------------------------- */
+{
+	return port_atomic_cas_idle((void * volatile *)&mut->owner, 0, System.cur, (void * volatile *)&mut->queue);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+bool priv_mut_tryUnlock( mut_t *mut )
+/* -------------------------------------------------------------------------- */
+{
+	return mut->owner == System.cur && port_atomic_cas_idle((void * volatile *)&mut->owner, System.cur, 0, (void * volatile *)&mut->queue);
+}
+
+#endif
+
 /* -------------------------------------------------------------------------- */
 static
 unsigned priv_mut_wait( mut_t *mut, cnt_t time, unsigned(*wait)(void*,cnt_t) )
@@ -101,6 +148,16 @@ unsigned priv_mut_wait( mut_t *mut, cnt_t time, unsigned(*wait)(void*,cnt_t) )
 	assert(!port_isr_inside());
 	assert(mut);
 
+#if OS_MUT_LOCKFREE
+	if (priv_mut_tryLock(mut))
+		return E_SUCCESS;
+#endif
+
+#if OS_MUT_SPIN
+	if (wait != core_tsk_waitFor || time != IMMEDIATE)
+		priv_mut_spin(mut);
+#endif
+
 	sys_lock();
 	{
 		if (mut->owner == 0)
@@ -142,6 +199,11 @@ unsigned mut_give( mut_t *mut )
 	assert(!port_isr_inside());
 	assert(mut);
 
+#if OS_MUT_LOCKFREE
+	if (priv_mut_tryUnlock(mut))
+		return E_SUCCESS;
+#endif
+
 	sys_lock();
 	{
 		if (mut->owner == System.cur)
@@ -72,26 +72,28 @@ flg_t *flg_create( unsigned init )
 void flg_kill( flg_t *flg )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(flg);
 
 	sys_lock();
 	{
-		core_all_wakeup(flg, E_STOPPED);
+		flg->wait = 0;
+
+		core_all_detach(flg, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void flg_delete( flg_t *flg )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
-	{
-		flg_kill(flg);
-		core_sys_free(flg->res);
-	}
-	sys_unlock();
+	flg_kill(flg);
+	core_sys_free(flg->res);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -140,6 +142,7 @@ unsigned priv_flg_wait( flg_t *flg, unsigned flags, unsigned mode, cnt_t time, u
 		{
 			System.cur->tmp.flg.mode  = mode;
 			System.cur->tmp.flg.flags = value;
+			flg->wait |= value;
 			event = wait(flg, time);
 		}
 	}
@@ -166,25 +169,52 @@ unsigned flg_waitUntil( flg_t *flg, unsigned flags, unsigned mode, cnt_t time )
 unsigned flg_give( flg_t *flg, unsigned flags )
 /* -------------------------------------------------------------------------- */
 {
-	tsk_t *tsk;
+	tsk_t  * tsk;
+	tsk_t  * nxt;
+	unsigned wait;
 
 	assert(flg);
 
+#if OS_FLG_LOCKFREE
+	{
+		uint32_t old;
+		do old = flg->flags;
+		while (!port_atomic_cas32((volatile uint32_t *)&flg->flags, old, old | flags));
+		port_mem_barrier();
+		if (*(tsk_t * volatile *)&flg->queue == 0)
+			return old | flags;
+	}
+	// a task is waiting: the flags could have been taken in the meantime, so they are not set again
+#endif
+
 	sys_lock();
 	{
+#if OS_FLG_LOCKFREE
+		flags = flg->flags;
+#else
 		flags = flg->flags |= flags;
+#endif
 
-		for (tsk = flg->queue; tsk; tsk = tsk->obj.queue)
+		if (flags & flg->wait) // otherwise none of the waiting tasks is interested in the flags
 		{
-			if (tsk->tmp.flg.flags & flags)
+			for (tsk = flg->queue, wait = 0; tsk; tsk = nxt)
 			{
-				if ((tsk->tmp.flg.mode & flgProtect) == 0)
-					flg->flags &= ~tsk->tmp.flg.flags;
-				tsk->tmp.flg.flags &= ~flags;
-				if (tsk->tmp.flg.flags && (tsk->tmp.flg.mode & flgAll))
-					continue;
-				core_one_wakeup(tsk = tsk->back, E_SUCCESS);
+				nxt = tsk->obj.queue;
+				if (tsk->tmp.flg.flags & flags)
+				{
+					if ((tsk->tmp.flg.mode & flgProtect) == 0)
+						flg->flags &= ~tsk->tmp.flg.flags;
+					tsk->tmp.flg.flags &= ~flags;
+					if (tsk->tmp.flg.flags == 0 || (tsk->tmp.flg.mode & flgAll) == 0)
+					{
+						core_tsk_wakeup(tsk, E_SUCCESS);
+						continue;
+					}
+				}
+				wait |= tsk->tmp.flg.flags;
 			}
+
+			flg->wait = wait; // rebuilt from the tasks still waiting
 		}
 
 		flags = flg->flags;
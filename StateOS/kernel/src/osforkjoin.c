@@ -0,0 +1,201 @@
+/******************************************************************************
+
+    @file    StateOS: osforkjoin.c
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osforkjoin.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void grp_init( grp_t *grp, wpl_t *wpl )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(grp);
+	assert(wpl);
+
+	sem_init(&grp->sem, 0, semBinary);
+
+	sys_lock();
+	{
+		grp->wpl   = wpl;
+		grp->fun   = 0;
+		grp->ctx   = 0;
+		grp->next  = 0;
+		grp->end   = 0;
+		grp->grain = 0;
+		grp->count = 0;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_grp_run( grp_t *grp )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned begin;
+	unsigned end;
+
+	for (;;)
+	{
+		sys_lock();
+		{
+			begin = grp->next;
+			end   = grp->end - begin > grp->grain ? begin + grp->grain : grp->end;
+			grp->next = end;
+		}
+		sys_unlock();
+
+		if (begin >= end)
+			break;
+
+		grp->fun(grp->ctx, begin, end);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_grp_job( void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	grp_t  * grp = arg;
+	unsigned cnt;
+
+	priv_grp_run(grp);
+
+	sys_lock();
+	{
+		cnt = --grp->count;
+	}
+	sys_unlock();
+
+	if (cnt == 0)
+		sem_give(&grp->sem);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned grp_fork( grp_t *grp, unsigned begin, unsigned end, unsigned grain, grf_t *fun, void *ctx )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned chunks;
+	unsigned jobs;
+
+	assert(!port_isr_inside());
+	assert(grp);
+	assert(grp->wpl);
+	assert(grp->count == 0);
+	assert(fun);
+
+	if (grain == 0)
+		grain = 1;
+	if (end < begin)
+		end = begin;
+
+	sys_lock();
+	{
+		grp->fun   = fun;
+		grp->ctx   = ctx;
+		grp->next  = begin;
+		grp->end   = end;
+		grp->grain = grain;
+	}
+	sys_unlock();
+
+	chunks = (end - begin) / grain + ((end - begin) % grain ? 1 : 0);
+
+	for (jobs = 0; jobs < grp->wpl->size && jobs + 1 < chunks; jobs++)
+	{
+		sys_lock();
+		{
+			grp->count++;
+		}
+		sys_unlock();
+
+		if (wpl_give(grp->wpl, priv_grp_job, grp) != E_SUCCESS)
+		{
+			sys_lock();
+			{
+				grp->count--;
+			}
+			sys_unlock();
+			break;
+		}
+	}
+
+	return jobs;
+}
+
+/* -------------------------------------------------------------------------- */
+void grp_join( grp_t *grp )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(!port_isr_inside());
+	assert(grp);
+
+	priv_grp_run(grp);
+
+	for (;;)
+	{
+		sys_lock();
+		{
+			cnt = grp->count;
+		}
+		sys_unlock();
+
+		if (cnt == 0)
+			break;
+
+		if (wpl_take(grp->wpl) != E_SUCCESS)
+			sem_wait(&grp->sem);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+void par_for( wpl_t *wpl, unsigned begin, unsigned end, unsigned grain, grf_t *fun, void *ctx )
+/* -------------------------------------------------------------------------- */
+{
+	grp_t grp;
+
+	grp_init(&grp, wpl);
+	grp_fork(&grp, begin, end, grain, fun, ctx);
+	grp_join(&grp);
+
+#if OS_OBJ_STATS
+	sys_lock();
+	{
+		core_ost_remove(&grp.sem.ost); // the group lives on the stack
+	}
+	sys_unlock();
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
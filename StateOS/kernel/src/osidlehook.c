@@ -0,0 +1,217 @@
+/******************************************************************************
+
+    @file    StateOS: osidlehook.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+
+#include "inc/osidlehook.h"
+#include "inc/oscriticalsection.h"
+
+static idh_t *Hooks = 0; // registry of started hooks, ordered by priority (the highest first)
+static idh_t *Last  = 0; // hook served in the last pass of the idle task
+
+/* -------------------------------------------------------------------------- */
+void idh_init( idh_t *idh, unsigned prio, idf_t *fun, void *arg, uint32_t budget )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(idh);
+	assert(fun);
+
+	sys_lock();
+	{
+		memset(idh, 0, sizeof(idh_t));
+
+		idh->fun    = fun;
+		idh->arg    = arg;
+		idh->prio   = prio;
+		idh->budget = budget;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_idh_remove( idh_t *idh )
+/* -------------------------------------------------------------------------- */
+{
+	idh_t **ptr;
+
+	for (ptr = &Hooks; *ptr; ptr = &(*ptr)->next)
+	{
+		if (*ptr == idh)
+		{
+			*ptr = idh->next;
+			break;
+		}
+	}
+
+	if (Last == idh)
+		Last = 0;
+
+	idh->next = 0;
+	idh->run  = false;
+}
+
+/* -------------------------------------------------------------------------- */
+void idh_start( idh_t *idh )
+/* -------------------------------------------------------------------------- */
+{
+	idh_t **ptr;
+
+	assert(!port_isr_inside());
+	assert(idh);
+	assert(idh->fun);
+
+	sys_lock();
+	{
+		if (idh->run)
+			priv_idh_remove(idh);
+
+		for (ptr = &Hooks; *ptr && (*ptr)->prio >= idh->prio; ptr = &(*ptr)->next);
+
+		idh->next = *ptr;
+		*ptr = idh;
+		idh->run  = true;
+		idh->pend = true;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void idh_stop( idh_t *idh )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(idh);
+
+	sys_lock();
+	{
+		if (idh->run)
+			priv_idh_remove(idh);
+		idh->pend = false;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void idh_signal( idh_t *idh )
+/* -------------------------------------------------------------------------- */
+{
+	assert(idh);
+
+	idh->pend = true;
+}
+
+/* -------------------------------------------------------------------------- */
+bool idh_pending( idh_t *idh )
+/* -------------------------------------------------------------------------- */
+{
+	assert(idh);
+
+	return idh->pend;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+idh_t *priv_idh_next( void )
+/* -------------------------------------------------------------------------- */
+{
+	idh_t *idh;
+	idh_t *fst = 0;
+	bool   fnd = false;
+
+	for (idh = Hooks; idh; idh = idh->next)
+	{
+		if (!idh->pend)
+			continue;
+
+		if (fst == 0)
+			fst = idh;   // pending hook of the highest priority
+		else
+		if (idh->prio < fst->prio)
+			break;
+
+		if (fnd)
+			return idh;  // next pending hook of the same priority (round-robin)
+
+		if (idh == Last)
+			fnd = true;
+	}
+
+	return fst;
+}
+
+/* -------------------------------------------------------------------------- */
+bool core_idh_handler( void )
+/* -------------------------------------------------------------------------- */
+{
+	idh_t *idh;
+	bool   more;
+#ifdef HW_CYCLE_COUNTER
+	uint32_t stamp = port_cyc_time();
+#endif
+
+	sys_lock();
+	{
+		idh = priv_idh_next();
+		if (idh)
+		{
+			Last = idh;
+			idh->pend = false;
+		}
+	}
+	sys_unlock();
+
+	if (idh == 0)
+		return false;
+
+	for (;;)
+	{
+		more = idh->fun(idh->arg);
+		if (!more)
+			break;
+		idh->pend = true; // a signal received while the hook is running is never lost
+#ifdef HW_CYCLE_COUNTER
+		if (port_cyc_time() - stamp >= idh->budget)
+#endif
+			break;
+		idh->pend = false;
+	}
+
+	sys_lock();
+	{
+		more = priv_idh_next() != 0;
+	}
+	sys_unlock();
+
+	return more;
+}
+
+/* -------------------------------------------------------------------------- */
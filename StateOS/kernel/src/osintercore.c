@@ -0,0 +1,263 @@
+/******************************************************************************
+
+    @file    StateOS: osintercore.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osintercore.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_icc_clean( const volatile void *ptr, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	// write back the data cache lines of the shared memory (before the other core reads it)
+#ifdef CACHE_LINE
+	port_cache_clean((const void *)ptr, size);
+#else
+	(void) ptr; (void) size;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_icc_invalidate( const volatile void *ptr, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	// discard the data cache lines of the shared memory (after the other core has written it)
+#ifdef CACHE_LINE
+	port_cache_invalidate((const void *)ptr, size);
+#else
+	(void) ptr; (void) size;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+void icc_init( icc_t *icc, void *ring, unsigned limit, unsigned size, fun_t *bell )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(icc);
+	assert(ring);
+	assert(((size_t)ring % _ICC_LINE) == 0);
+	assert(limit && (limit & (limit - 1)) == 0);
+	assert(size);
+
+	sys_lock();
+	{
+		memset(icc, 0, sizeof(icc_t));
+
+		icc->ring = ring;
+		icc->mask = limit - 1;
+		icc->size = size;
+		icc->slot = _ICC_ROUND(size);
+		icc->bell = bell;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void icc_clear( icc_t *icc )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(icc);
+
+	icc->ring->head = 0;
+	icc->ring->tail = 0;
+	priv_icc_clean(icc->ring, sizeof(icr_t));
+}
+
+/* -------------------------------------------------------------------------- */
+static
+char *priv_icc_slot( icc_t *icc, unsigned idx )
+/* -------------------------------------------------------------------------- */
+{
+	return (char *)(icc->ring + 1) + (idx & icc->mask) * icc->slot;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_icc_get( icc_t *icc, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	icr_t  * ring = icc->ring;
+	unsigned head = ring->head;
+	char   * slot;
+
+	priv_icc_invalidate(&ring->tail, sizeof(ring->tail));
+
+	if (ring->tail == head)
+		return E_TIMEOUT;
+
+	port_mem_barrier(); // the message written by the producer core is visible
+
+	slot = priv_icc_slot(icc, head);
+	priv_icc_invalidate(slot, icc->slot);
+	memcpy(data, slot, icc->size);
+
+	port_mem_barrier(); // the message is read before the slot is released
+	ring->head = head + 1;
+	priv_icc_clean(&ring->head, sizeof(ring->head));
+
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_icc_put( icc_t *icc, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	icr_t  * ring = icc->ring;
+	unsigned tail = ring->tail;
+	char   * slot;
+
+	priv_icc_invalidate(&ring->head, sizeof(ring->head));
+
+	if (tail - ring->head > icc->mask)
+		return E_TIMEOUT;
+
+	port_mem_barrier(); // the slot released by the consumer core is not read anymore
+
+	slot = priv_icc_slot(icc, tail);
+	memcpy(slot, data, icc->size);
+	priv_icc_clean(slot, icc->slot);
+
+	port_mem_barrier(); // the message is written before it is published
+	ring->tail = tail + 1;
+	priv_icc_clean(&ring->tail, sizeof(ring->tail));
+
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_icc_wait( icc_t *icc, void *data, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(icc);
+	assert(data);
+
+	event = priv_icc_get(icc, data);
+
+	if (event != E_SUCCESS)
+	{
+		sys_lock();
+		{
+			// the doorbell interrupt can't resume the consumer between the check and the start of the wait
+			event = priv_icc_get(icc, data);
+
+			if (event != E_SUCCESS)
+			{
+				event = wait(icc, time);
+				if (event == E_SUCCESS)
+					event = priv_icc_get(icc, data);
+			}
+		}
+		sys_unlock();
+	}
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned icc_waitFor( icc_t *icc, void *data, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_icc_wait(icc, data, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned icc_waitUntil( icc_t *icc, void *data, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_icc_wait(icc, data, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned icc_take( icc_t *icc, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(icc);
+	assert(data);
+
+	return priv_icc_get(icc, data);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned icc_give( icc_t *icc, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(icc);
+	assert(icc->bell);
+	assert(data);
+
+	event = priv_icc_put(icc, data);
+
+	if (event == E_SUCCESS)
+		icc->bell(); // the tail is written back before the doorbell rings
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+void icc_notifyISR( icc_t *icc )
+/* -------------------------------------------------------------------------- */
+{
+	assert(icc);
+
+	if (icc->queue)
+	{
+		sys_lock();
+		{
+			core_one_wakeup(icc, E_SUCCESS);
+		}
+		sys_unlock();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned icc_count( icc_t *icc )
+/* -------------------------------------------------------------------------- */
+{
+	icr_t *ring = icc->ring;
+
+	assert(icc);
+
+	priv_icc_invalidate(ring, sizeof(icr_t));
+
+	return ring->tail - ring->head;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,131 @@
+/******************************************************************************
+
+    @file    StateOS: osinterruptservice.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osinterruptservice.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void ist_init( ist_t *ist, unsigned irq )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(ist);
+
+	sys_lock();
+	{
+		memset(ist, 0, sizeof(ist_t));
+
+		ist->irq = irq;
+		port_irq_mask(irq);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void ist_kill( ist_t *ist )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(ist);
+
+	sys_lock();
+	{
+		port_irq_mask(ist->irq);
+		ist->count = 0;
+
+		core_all_wakeup(ist, E_STOPPED);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_ist_wait( ist_t *ist, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(ist);
+	assert(ist->queue == 0); // only one service task
+
+	sys_lock();
+	{
+		if (ist->count > 0)
+		{
+			ist->count--;
+			event = E_SUCCESS;
+		}
+		else
+		{
+			// the interrupt is pending until the service task starts waiting
+			port_irq_unmask(ist->irq);
+			event = wait(ist, time);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned ist_waitFor( ist_t *ist, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_ist_wait(ist, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned ist_waitUntil( ist_t *ist, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_ist_wait(ist, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+void ist_handlerISR( ist_t *ist )
+/* -------------------------------------------------------------------------- */
+{
+	assert(port_isr_inside());
+	assert(ist);
+
+	port_irq_mask(ist->irq);
+
+	sys_lock();
+	{
+		// the only waiting task is the service task, it is made ready directly (no semaphore / queue bookkeeping)
+		if (core_tsk_wakeup(ist->queue, E_SUCCESS) == 0)
+			ist->count++;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
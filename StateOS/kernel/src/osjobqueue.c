@@ -52,6 +52,29 @@ void job_init( job_t *job, unsigned limit, fun_t **data )
 	sys_unlock();
 }
 
+/* -------------------------------------------------------------------------- */
+void job_initTable( job_t *job, unsigned limit, uint8_t *data, fun_t * const *table, unsigned items )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(job);
+	assert(limit);
+	assert(data);
+	assert(table);
+	assert(items && items <= UINT8_MAX + 1);
+
+	sys_lock();
+	{
+		memset(job, 0, sizeof(job_t));
+
+		job->limit = limit;
+		job->data  = data;
+		job->table = table;
+		job->items = items;
+	}
+	sys_unlock();
+}
+
 /* -------------------------------------------------------------------------- */
 job_t *job_create( unsigned limit )
 /* -------------------------------------------------------------------------- */
@@ -72,10 +95,32 @@ job_t *job_create( unsigned limit )
 	return job;
 }
 
+/* -------------------------------------------------------------------------- */
+job_t *job_createTable( unsigned limit, fun_t * const *table, unsigned items )
+/* -------------------------------------------------------------------------- */
+{
+	job_t *job;
+
+	assert(!port_isr_inside());
+	assert(limit);
+
+	sys_lock();
+	{
+		job = core_sys_alloc(ABOVE(sizeof(job_t)) + limit * sizeof(uint8_t));
+		job_initTable(job, limit, (void *)((size_t)job + ABOVE(sizeof(job_t))), table, items);
+		job->res = job;
+	}
+	sys_unlock();
+
+	return job;
+}
+
 /* -------------------------------------------------------------------------- */
 void job_kill( job_t *job )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(job);
 
@@ -85,21 +130,19 @@ void job_kill( job_t *job )
 		job->head  = 0;
 		job->tail  = 0;
 
-		core_all_wakeup(job, E_STOPPED);
+		core_all_detach(job, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void job_delete( job_t *job )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
-	{
-		job_kill(job);
-		core_sys_free(job->res);
-	}
-	sys_unlock();
+	job_kill(job);
+	core_sys_free(job->res);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -110,7 +153,10 @@ fun_t *priv_job_get( job_t *job )
 	fun_t  * fun;
 	unsigned i = job->head;
 
-	fun = job->data[i++];
+	if (job->table)
+		fun = job->table[((uint8_t *)job->data)[i++]];
+	else
+		fun = ((fun_t **)job->data)[i++];
 	job->head = (i < job->limit) ? i : 0;
 	job->count--;
 
@@ -123,8 +169,16 @@ void priv_job_put( job_t *job, fun_t *fun )
 /* -------------------------------------------------------------------------- */
 {
 	unsigned i = job->tail;
+	unsigned n;
 
-	job->data[i++] = fun;
+	if (job->table)
+	{
+		for (n = 0; n + 1 < job->items && job->table[n] != fun; n++);
+		assert(job->table[n] == fun); // job procedure must be in the table
+		((uint8_t *)job->data)[i++] = (uint8_t)n;
+	}
+	else
+		((fun_t **)job->data)[i++] = fun;
 
 	job->tail = (i < job->limit) ? i : 0;
 	job->count++;
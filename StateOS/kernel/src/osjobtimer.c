@@ -0,0 +1,299 @@
+/******************************************************************************
+
+    @file    StateOS: osjobtimer.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osjobtimer.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void jtm_init( jtm_t *jtm, job_t *job, unsigned limit, jte_t *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(jtm);
+	assert(job);
+	assert(limit);
+	assert(data);
+
+	sys_lock();
+	{
+		memset(jtm, 0, sizeof(jtm_t));
+
+		tmr_initArg(&jtm->tmr, core_jtm_timeout, jtm);
+#if OS_TIMER_TASK
+		tmr_start(&jtm->tmr, INFINITE, 0); // start the timer service task sending the jobs
+		core_tmr_remove(&jtm->tmr);
+#endif
+		jtm->job   = job;
+		jtm->limit = limit;
+		jtm->data  = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+static
+bool priv_jtm_before( jtm_t *jtm, cnt_t time1, cnt_t time2 )
+/* -------------------------------------------------------------------------- */
+{
+	return (cnt_t)(time1 - jtm->base) < (cnt_t)(time2 - jtm->base);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_jtm_up( jtm_t *jtm, unsigned i )
+/* -------------------------------------------------------------------------- */
+{
+	jte_t ent = jtm->data[i];
+	unsigned p;
+
+	while (i > 0 && priv_jtm_before(jtm, ent.time, jtm->data[p = (i - 1) / 2].time))
+	{
+		jtm->data[i] = jtm->data[p];
+		i = p;
+	}
+
+	jtm->data[i] = ent;
+
+	return i;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_jtm_down( jtm_t *jtm, unsigned i )
+/* -------------------------------------------------------------------------- */
+{
+	jte_t ent = jtm->data[i];
+	unsigned c;
+
+	while ((c = 2 * i + 1) < jtm->count)
+	{
+		if (c + 1 < jtm->count && priv_jtm_before(jtm, jtm->data[c + 1].time, jtm->data[c].time))
+			c++;
+		if (!priv_jtm_before(jtm, jtm->data[c].time, ent.time))
+			break;
+		jtm->data[i] = jtm->data[c];
+		i = c;
+	}
+
+	jtm->data[i] = ent;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_jtm_arm( jtm_t *jtm, cnt_t now )
+/* -------------------------------------------------------------------------- */
+{
+	cnt_t time;
+
+	if (jtm->tmr.id != ID_STOPPED)
+		core_tmr_remove(&jtm->tmr); // running or pending in the timer service task
+
+	if (jtm->count > 0)
+	{
+		time = jtm->data[0].time;
+		jtm->tmr.start  = now;
+		jtm->tmr.delay  = priv_jtm_before(jtm, now, time) ? (cnt_t)(time - now) : 0;
+		jtm->tmr.period = 0;
+		core_tmr_insert(&jtm->tmr, ID_TIMER);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_jtm_send( jtm_t *jtm, fun_t *fun, cnt_t delay, cnt_t period )
+/* -------------------------------------------------------------------------- */
+{
+	cnt_t    now;
+	unsigned event = E_TIMEOUT;
+
+	assert(jtm);
+	assert(fun);
+
+	sys_lock();
+	{
+		if (delay == IMMEDIATE && period == 0)
+		{
+			event = job_give(jtm->job, fun);
+		}
+		else
+		if (jtm->count < jtm->limit)
+		{
+			now = core_sys_time();
+			if (jtm->count == 0)
+				jtm->base = now;
+
+			jtm->data[jtm->count].time   = (cnt_t)(now + delay);
+			jtm->data[jtm->count].period = period;
+			jtm->data[jtm->count].fun    = fun;
+			if (priv_jtm_up(jtm, jtm->count++) == 0)
+				priv_jtm_arm(jtm, now); // the new job is the earliest one
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned jtm_sendAfter( jtm_t *jtm, fun_t *fun, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_jtm_send(jtm, fun, delay, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned jtm_sendAt( jtm_t *jtm, fun_t *fun, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	sys_lock();
+	{
+		event = priv_jtm_send(jtm, fun, (cnt_t)(time - core_sys_time()), 0);
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned jtm_sendEvery( jtm_t *jtm, fun_t *fun, cnt_t delay, cnt_t period )
+/* -------------------------------------------------------------------------- */
+{
+	assert(period);
+
+	return priv_jtm_send(jtm, fun, delay, period);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned jtm_cancel( jtm_t *jtm, fun_t *fun )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned i, j;
+	unsigned count;
+
+	assert(jtm);
+
+	sys_lock();
+	{
+		for (i = j = 0; i < jtm->count; i++)
+			if (jtm->data[i].fun != fun)
+				jtm->data[j++] = jtm->data[i];
+
+		count = jtm->count - j;
+
+		if (count > 0)
+		{
+			jtm->count = j;
+			for (i = j / 2; i-- > 0; )
+				priv_jtm_down(jtm, i); // rebuild the heap
+			priv_jtm_arm(jtm, core_sys_time());
+		}
+	}
+	sys_unlock();
+
+	return count;
+}
+
+/* -------------------------------------------------------------------------- */
+void jtm_kill( jtm_t *jtm )
+/* -------------------------------------------------------------------------- */
+{
+	assert(jtm);
+
+	sys_lock();
+	{
+		jtm->count = 0;
+		priv_jtm_arm(jtm, core_sys_time());
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned jtm_count( jtm_t *jtm )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned count;
+
+	assert(jtm);
+
+	sys_lock();
+	{
+		count = jtm->count;
+	}
+	sys_unlock();
+
+	return count;
+}
+
+/* -------------------------------------------------------------------------- */
+void core_jtm_timeout( void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	jtm_t *jtm = arg;
+	jte_t *ent = jtm->data;
+	cnt_t  now;
+
+	sys_lock();
+	{
+		now = core_sys_time();
+
+		while (jtm->count > 0 && !priv_jtm_before(jtm, now, ent->time))
+		{
+			(void) job_give(jtm->job, ent->fun); // the job is lost if the job queue is full
+
+			if (ent->period != 0)
+			{
+				do ent->time += ent->period; // expirations missed by the late timer are merged
+				while (!priv_jtm_before(jtm, now, ent->time));
+			}
+			else
+			{
+				*ent = jtm->data[--jtm->count];
+			}
+
+			priv_jtm_down(jtm, 0);
+		}
+
+		jtm->base = now;
+#if OS_TIMER_TASK
+		priv_jtm_arm(jtm, now);
+#else
+		// the timer is still at the head of the timer queue, it is restarted by the timer handler
+		jtm->tmr.start = now;
+		jtm->tmr.delay = jtm->count > 0 ? (cnt_t)(ent->time - now) : 0;
+#endif
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
@@ -70,26 +70,26 @@ lst_t *lst_create( void )
 void lst_kill( lst_t *lst )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(lst);
 
 	sys_lock();
 	{
-		core_all_wakeup(lst, E_STOPPED);
+		core_all_detach(lst, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void lst_delete( lst_t *lst )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
-	{
-		lst_kill(lst);
-		core_sys_free(lst->res);
-	}
-	sys_unlock();
+	lst_kill(lst);
+	core_sys_free(lst->res);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -45,6 +45,9 @@ void box_init( box_t *box, unsigned limit, void *data, unsigned size )
 
 	sys_lock();
 	{
+#if OS_OBJ_STATS
+		core_ost_remove(&box->ost);
+#endif
 		memset(box, 0, sizeof(box_t));
 
 		box->limit = limit * size;
@@ -79,6 +82,8 @@ box_t *box_create( unsigned limit, unsigned size )
 void box_kill( box_t *box )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(box);
 
@@ -88,21 +93,26 @@ void box_kill( box_t *box )
 		box->head  = 0;
 		box->tail  = 0;
 
-		core_all_wakeup(box, E_STOPPED);
+		core_all_detach(box, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void box_delete( box_t *box )
 /* -------------------------------------------------------------------------- */
 {
+	box_kill(box);
+#if OS_OBJ_STATS
 	sys_lock();
 	{
-		box_kill(box);
-		core_sys_free(box->res);
+		core_ost_remove(&box->ost);
 	}
 	sys_unlock();
+#endif
+	core_sys_free(box->res);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -127,12 +137,12 @@ void priv_box_get( box_t *box, char *data )
 /* -------------------------------------------------------------------------- */
 {
 	unsigned i = box->head;
-	unsigned j = 0;
 
-	do data[j++] = box->data[i++]; while (j < box->size);
+	memcpy(data, &box->data[i], box->size);
 
+	i += box->size;
 	box->head = (i < box->limit) ? i : 0;
-	box->count -= j;
+	box->count -= box->size;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -141,12 +151,12 @@ void priv_box_put( box_t *box, const char *data )
 /* -------------------------------------------------------------------------- */
 {
 	unsigned i = box->tail;
-	unsigned j = 0;
 
-	do box->data[i++] = data[j++]; while (j < box->size);
+	memcpy(&box->data[i], data, box->size);
 
+	i += box->size;
 	box->tail = (i < box->limit) ? i : 0;
-	box->count += j;
+	box->count += box->size;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -181,6 +191,7 @@ void priv_box_putUpdate( box_t *box, const char *data )
 	priv_box_put(box, data);
 	tsk = core_one_wakeup(box, E_SUCCESS);
 	if (tsk) priv_box_get(box, tsk->tmp.box.data.in);
+	else     core_sel_notify(box);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -197,6 +208,7 @@ unsigned box_take( box_t *box, void *data )
 		if (box->count > 0)
 		{
 			priv_box_getUpdate(box, data);
+			core_stat_take(box, false);
 			event = E_SUCCESS;
 		}
 	}
@@ -221,12 +233,15 @@ unsigned priv_box_wait( box_t *box, void *data, cnt_t time, unsigned(*wait)(void
 		if (box->count > 0)
 		{
 			priv_box_getUpdate(box, data);
+			core_stat_take(box, false);
 			event = E_SUCCESS;
 		}
 		else
 		{
 			System.cur->tmp.box.data.in = data;
-			event = wait(box, time);
+			event = core_stat_wait(box, time, wait);
+			if (event == E_SUCCESS)
+				core_stat_take(box, true);
 		}
 	}
 	sys_unlock();
@@ -248,6 +263,66 @@ unsigned box_waitUntil( box_t *box, void *data, cnt_t time )
 	return priv_box_wait(box, data, time, core_tsk_waitUntil);
 }
 
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_box_getN( box_t *box, char *data, unsigned max )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t  * tsk;
+	unsigned cnt = 0;
+
+	while (box->count > 0 && cnt < max)
+	{
+		priv_box_get(box, data);
+		data += box->size;
+		cnt++;
+	}
+
+	while (box->count < box->limit && (tsk = core_one_wakeup(box, E_SUCCESS)) != 0)
+		priv_box_put(box, tsk->tmp.box.data.out);
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned box_waitN( box_t *box, void *data, unsigned max, unsigned *got, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_SUCCESS;
+	unsigned cnt   = 0;
+
+	assert(!port_isr_inside());
+	assert(box);
+	assert(data);
+	assert(max);
+
+	sys_lock();
+	{
+		if (box->count == 0)
+		{
+			System.cur->tmp.box.data.in = data;
+			event = core_stat_wait(box, delay, core_tsk_waitFor);
+			if (event == E_SUCCESS)
+			{
+				core_stat_take(box, true);
+				cnt = 1;
+			}
+		}
+		else
+		{
+			core_stat_take(box, false);
+		}
+
+		if (event == E_SUCCESS)
+			cnt += priv_box_getN(box, (char *)data + cnt * box->size, max - cnt);
+	}
+	sys_unlock();
+
+	if (got) *got = cnt;
+
+	return event;
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned box_give( box_t *box, const void *data )
 /* -------------------------------------------------------------------------- */
@@ -257,6 +332,9 @@ unsigned box_give( box_t *box, const void *data )
 	assert(box);
 	assert(data);
 
+	if (box->over)
+		return box_push(box, data);
+
 	sys_lock();
 	{
 		if (box->count < box->limit)
@@ -281,6 +359,9 @@ unsigned priv_box_send( box_t *box, const void *data, cnt_t time, unsigned(*wait
 	assert(box);
 	assert(data);
 
+	if (box->over)
+		return box_push(box, data);
+
 	sys_lock();
 	{
 		if (box->count < box->limit)
@@ -291,7 +372,7 @@ unsigned priv_box_send( box_t *box, const void *data, cnt_t time, unsigned(*wait
 		else
 		{
 			System.cur->tmp.box.data.out = data;
-			event = wait(box, time);
+			event = core_stat_wait(box, time, wait);
 		}
 	}
 	sys_unlock();
@@ -327,7 +408,10 @@ unsigned box_push( box_t *box, const void *data )
 		if (box->count == 0 || box->queue == 0)
 		{
 			if (box->count == box->limit)
+			{
 				priv_box_skip(box);
+				box->drop++;
+			}
 			priv_box_putUpdate(box, data);
 			event = E_SUCCESS;
 		}
@@ -337,6 +421,36 @@ unsigned box_push( box_t *box, const void *data )
 	return event;
 }
 
+/* -------------------------------------------------------------------------- */
+void box_setOverwrite( box_t *box, bool enable )
+/* -------------------------------------------------------------------------- */
+{
+	assert(box);
+
+	sys_lock();
+	{
+		box->over = enable;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned box_dropped( box_t *box )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(box);
+
+	sys_lock();
+	{
+		cnt = box->drop;
+	}
+	sys_unlock();
+
+	return cnt;
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned box_count( box_t *box )
 /* -------------------------------------------------------------------------- */
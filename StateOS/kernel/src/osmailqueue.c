@@ -0,0 +1,288 @@
+/******************************************************************************
+
+    @file    StateOS: osmailqueue.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osmailqueue.h"
+#include "inc/ostask.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void mlq_init( mlq_t *mlq, unsigned limit, unsigned size, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(mlq);
+	assert(limit);
+	assert(size);
+	assert(data);
+
+	sys_lock();
+	{
+		memset(mlq, 0, sizeof(mlq_t));
+
+		mlq->limit = limit;
+		mlq->size  = MSIZE(size);
+		mlq->data  = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+mlq_t *mlq_create( unsigned limit, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	mlq_t *mlq;
+
+	assert(!port_isr_inside());
+	assert(limit);
+	assert(size);
+
+	sys_lock();
+	{
+		mlq = core_sys_alloc(ABOVE(sizeof(mlq_t)) + MLQ_SIZE(limit, size));
+		mlq_init(mlq, limit, size, (void *)((size_t)mlq + ABOVE(sizeof(mlq_t))));
+		mlq->res = mlq;
+	}
+	sys_unlock();
+
+	return mlq;
+}
+
+/* -------------------------------------------------------------------------- */
+void mlq_kill( mlq_t *mlq )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t hld[2];
+
+	assert(!port_isr_inside());
+	assert(mlq);
+
+	sys_lock();
+	{
+		if (mlq->head.next)
+		{
+			// posted mails are returned to the list of released mails at once
+			mlq->tail->next = mlq->free.next;
+			mlq->free.next = mlq->head.next;
+			mlq->head.next = 0;
+			mlq->tail = 0;
+		}
+		mlq->count = 0;
+
+		core_all_detach(mlq, &hld[0]);
+		core_all_detach(&mlq->alloc, &hld[1]);
+	}
+	sys_unlock();
+
+	core_all_release(&hld[0], E_STOPPED);
+	core_all_release(&hld[1], E_STOPPED);
+}
+
+/* -------------------------------------------------------------------------- */
+void mlq_delete( mlq_t *mlq )
+/* -------------------------------------------------------------------------- */
+{
+	mlq_kill(mlq);
+	core_sys_free(mlq->res);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void *priv_mlq_get( mlq_t *mlq )
+/* -------------------------------------------------------------------------- */
+{
+	que_t *ptr = mlq->free.next;
+
+	if (ptr)
+		mlq->free.next = ptr->next;
+	else
+	if (mlq->index < mlq->limit)
+		ptr = (que_t *)mlq->data + mlq->index++ * (1 + mlq->size);
+	else
+		return 0;
+
+	return ptr + 1;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void *priv_mlq_pop( mlq_t *mlq )
+/* -------------------------------------------------------------------------- */
+{
+	que_t *ptr = mlq->head.next;
+
+	if (ptr == 0)
+		return 0;
+
+	mlq->head.next = ptr->next;
+	mlq->count--;
+	return ptr + 1;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_mlq_wait( mlq_t *mlq, void **data, void *(*get)(mlq_t*), void *obj, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	void   * ptr;
+	unsigned event;
+
+	assert(mlq);
+	assert(data);
+
+	sys_lock();
+	{
+		ptr = get(mlq);
+
+		if (ptr)
+		{
+			*data = ptr;
+			event = E_SUCCESS;
+		}
+		else
+		if (wait)
+		{
+			System.cur->tmp.lst.data.in = data;
+			event = wait(obj, time);
+		}
+		else
+		{
+			event = E_TIMEOUT;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mlq_alloc( mlq_t *mlq, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_mlq_wait(mlq, data, priv_mlq_get, &mlq->alloc, 0, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mlq_allocFor( mlq_t *mlq, void **data, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_mlq_wait(mlq, data, priv_mlq_get, &mlq->alloc, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mlq_allocUntil( mlq_t *mlq, void **data, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_mlq_wait(mlq, data, priv_mlq_get, &mlq->alloc, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mlq_take( mlq_t *mlq, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_mlq_wait(mlq, data, priv_mlq_pop, mlq, 0, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mlq_waitFor( mlq_t *mlq, void **data, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_mlq_wait(mlq, data, priv_mlq_pop, mlq, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mlq_waitUntil( mlq_t *mlq, void **data, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_mlq_wait(mlq, data, priv_mlq_pop, mlq, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+void mlq_free( mlq_t *mlq, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+	que_t *ptr;
+
+	assert(mlq);
+	assert(data);
+
+	sys_lock();
+	{
+		tsk = core_one_wakeup(&mlq->alloc, E_SUCCESS);
+
+		if (tsk)
+		{
+			*tsk->tmp.lst.data.out = data;
+		}
+		else
+		{
+			ptr = (que_t *)data - 1;
+			ptr->next = mlq->free.next;
+			mlq->free.next = ptr;
+		}
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void mlq_give( mlq_t *mlq, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+	que_t *ptr;
+
+	assert(mlq);
+	assert(data);
+
+	sys_lock();
+	{
+		tsk = core_one_wakeup(mlq, E_SUCCESS);
+
+		if (tsk)
+		{
+			*tsk->tmp.lst.data.out = data;
+		}
+		else
+		{
+			ptr = (que_t *)data - 1;
+			ptr->next = 0;
+			if (mlq->head.next)
+				mlq->tail->next = ptr;
+			else
+				mlq->head.next = ptr;
+			mlq->tail = ptr;
+			mlq->count++;
+		}
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
@@ -33,26 +33,189 @@
 #include "inc/ostask.h"
 #include "inc/oscriticalsection.h"
 
+#if OS_MEM_LOCKFREE
+
+#define MEM_IDX( top ) ((top) & 0xFFFFU)               // index of the first free memory object (1-based)
+#define MEM_TOP( top, idx ) ((((top) + 0x10000U) & ~0xFFFFU) | (idx)) // next value of 'top' with updated ABA tag
+
+/* -------------------------------------------------------------------------- */
+static
+uintptr_t *priv_mem_obj( mem_t *mem, uint32_t idx )
+/* -------------------------------------------------------------------------- */
+{
+	return (uintptr_t *)mem->data + (idx - 1) * (MHEAD + mem->size);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void *priv_mem_pop( mem_t *mem )
+/* -------------------------------------------------------------------------- */
+{
+	uintptr_t *obj;
+	uint32_t   top, idx;
+
+	do
+	{
+		top = mem->top;
+		idx = MEM_IDX(top);
+		if (idx == 0)
+			return 0;
+		obj = priv_mem_obj(mem, idx);
+	}
+	while (!port_atomic_cas32(&mem->top, top, MEM_TOP(top, (uint32_t)*obj)));
+
+#if OS_MEM_HEADERLESS == 0
+	*obj = idx; // memory object in use keeps its own index
+#endif
+	return obj + MHEAD;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_mem_push( mem_t *mem, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	uintptr_t *obj = (uintptr_t *)data - MHEAD;
+#if OS_MEM_HEADERLESS
+	uint32_t   idx = (uint32_t)(obj - (uintptr_t *)mem->data) / mem->size + 1; // index computed from the position in the buffer
+#else
+	uint32_t   idx = (uint32_t)*obj;
+#endif
+	uint32_t   top;
+
+	assert(idx && idx <= mem->limit);
+
+	do
+	{
+		top = mem->top;
+		*obj = MEM_IDX(top);
+	}
+	while (!port_atomic_cas32(&mem->top, top, MEM_TOP(top, idx)));
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_mem_add( volatile unsigned *val, unsigned inc )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned old;
+
+	do old = *val;
+	while (!port_atomic_cas32((volatile uint32_t *)val, old, old + inc));
+
+	return old + inc;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_mem_peak( mem_t *mem, unsigned cnt )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned old;
+
+	do if ((old = mem->peak) >= cnt) return;
+	while (!port_atomic_cas32((volatile uint32_t *)&mem->peak, old, cnt));
+}
+
+/* -------------------------------------------------------------------------- */
+
+#else
+
+/* -------------------------------------------------------------------------- */
+static
+void *priv_mem_pop( mem_t *mem )
+/* -------------------------------------------------------------------------- */
+{
+	que_t *ptr = mem->head.next;
+
+	if (ptr == 0)
+		return 0;
+
+	mem->head.next = ptr->next;
+	return ptr + MHEAD;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_mem_push( mem_t *mem, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	que_t *ptr = (que_t *)data - MHEAD;
+
+	ptr->next = mem->head.next;
+	mem->head.next = ptr;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_mem_add( volatile unsigned *val, unsigned inc )
+/* -------------------------------------------------------------------------- */
+{
+	return *val += inc;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_mem_peak( mem_t *mem, unsigned cnt )
+/* -------------------------------------------------------------------------- */
+{
+	if (mem->peak < cnt)
+		mem->peak = cnt;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+static
+void *priv_mem_get( mem_t *mem )
+/* -------------------------------------------------------------------------- */
+{
+	void *ptr = priv_mem_pop(mem);
+
+	if (ptr)
+		priv_mem_peak(mem, priv_mem_add(&mem->count, 1));
+
+	return ptr;
+}
+
 /* -------------------------------------------------------------------------- */
 void mem_bind( mem_t *mem )
 /* -------------------------------------------------------------------------- */
 {
 	que_t  * ptr;
-	unsigned cnt;
+	unsigned idx;
 
 	assert(!port_isr_inside());
 	assert(mem);
 	assert(mem->limit);
 	assert(mem->size);
 	assert(mem->data);
+#if OS_MEM_LOCKFREE
+	assert(mem->limit <= MEM_IDX(~0U));
+#endif
 
 	sys_lock();
 	{
 		ptr = mem->data;
-		cnt = mem->limit;
 
+#if OS_MEM_LOCKFREE
+		mem->top = 0;
+#else
 		mem->head.next = 0;
-		while (cnt--) { mem_give(mem, ++ptr); ptr += mem->size; }
+#endif
+		for (idx = 1; idx <= mem->limit; idx++, ptr += MHEAD + mem->size)
+		{
+#if OS_MEM_HEADERLESS == 0
+			*(uintptr_t *)ptr = idx;
+#endif
+			priv_mem_push(mem, ptr + MHEAD);
+		}
+
+		mem->count = 0;
+		mem->peak  = 0;
+		mem->fails = 0;
 	}
 	sys_unlock();
 }
@@ -94,7 +257,7 @@ mem_t *mem_create( unsigned limit, unsigned size )
 
 	sys_lock();
 	{
-		mem = core_sys_alloc(ABOVE(sizeof(mem_t)) + limit * (1 + size) * sizeof(que_t));
+		mem = core_sys_alloc(ABOVE(sizeof(mem_t)) + limit * (MHEAD + size) * sizeof(que_t));
 		mem_init(mem, limit, size, (void *)((size_t)mem + ABOVE(sizeof(mem_t))));
 		mem->res = mem;
 	}
@@ -107,24 +270,329 @@ mem_t *mem_create( unsigned limit, unsigned size )
 void mem_kill( mem_t *mem )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(mem);
 
 	sys_lock();
 	{
-		core_all_wakeup(mem, E_STOPPED);
+		core_all_detach(mem, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void mem_delete( mem_t *mem )
 /* -------------------------------------------------------------------------- */
 {
+	mem_kill(mem);
+	core_sys_free(mem->res);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_mem_take( mem_t *mem, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	void *ptr = priv_mem_get(mem);
+
+	if (ptr == 0)
+	{
+		priv_mem_add(&mem->fails, 1);
+		return E_TIMEOUT;
+	}
+
+	*data = ptr;
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mem_take( mem_t *mem, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(mem);
+	assert(data);
+
+#if OS_MEM_LOCKFREE
+	event = priv_mem_take(mem, data);
+#else
+	sys_lock();
+	{
+		event = priv_mem_take(mem, data);
+	}
+	sys_unlock();
+#endif
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_mem_wait( mem_t *mem, void **data, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	void   * ptr;
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(mem);
+	assert(data);
+
 	sys_lock();
 	{
-		mem_kill(mem);
-		core_sys_free(mem->res);
+		ptr = priv_mem_get(mem);
+
+		if (ptr)
+		{
+			*data = ptr;
+			event = E_SUCCESS;
+		}
+		else
+		{
+			System.cur->tmp.lst.data.in = data;
+			event = wait(mem, time);
+			if (event != E_SUCCESS)
+				priv_mem_add(&mem->fails, 1);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mem_waitFor( mem_t *mem, void **data, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_mem_wait(mem, data, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mem_waitUntil( mem_t *mem, void **data, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_mem_wait(mem, data, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+void mem_give( mem_t *mem, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+#if OS_MEM_LOCKFREE
+	void  *ptr;
+#endif
+
+	assert(mem);
+	assert(data);
+
+#if OS_MEM_LOCKFREE
+	priv_mem_push(mem, data);
+	priv_mem_add(&mem->count, (unsigned)-1);
+
+	if (mem->queue)
+	{
+		sys_lock();
+		{
+			while (mem->queue && (ptr = priv_mem_get(mem)) != 0)
+			{
+				tsk = core_one_wakeup(mem, E_SUCCESS);
+				*tsk->tmp.lst.data.out = ptr;
+			}
+		}
+		sys_unlock();
+	}
+#else
+	sys_lock();
+	{
+		tsk = core_one_wakeup(mem, E_SUCCESS);
+
+		if (tsk)
+		{
+			*tsk->tmp.lst.data.out = data;
+		}
+		else
+		{
+			priv_mem_push(mem, data);
+			mem->count--;
+		}
+	}
+	sys_unlock();
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+void mem_getStats( mem_t *mem, mst_t *stats )
+/* -------------------------------------------------------------------------- */
+{
+	assert(mem);
+	assert(stats);
+
+	sys_lock();
+	{
+		stats->count = mem->count;
+		stats->peak  = mem->peak;
+		stats->fails = mem->fails;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+// get up to 'cnt' memory objects from the free list of the memory pool in one batch
+static
+unsigned priv_mem_getN( mem_t *mem, void **obj, unsigned cnt )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned got = 0;
+
+	while (got < cnt && (obj[got] = priv_mem_pop(mem)) != 0)
+		got++;
+
+	if (got)
+		priv_mem_peak(mem, priv_mem_add(&mem->count, got));
+
+	return got;
+}
+
+/* -------------------------------------------------------------------------- */
+// put 'cnt' memory objects back to the free list of the memory pool in one batch
+// (no task is waiting for a memory object)
+static
+void priv_mem_putN( mem_t *mem, void **obj, unsigned cnt )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned idx;
+
+	for (idx = 0; idx < cnt; idx++)
+		priv_mem_push(mem, obj[idx]);
+
+	priv_mem_add(&mem->count, (unsigned)-cnt);
+}
+
+/* -------------------------------------------------------------------------- */
+void mag_init( mag_t *mag, mem_t *mem, unsigned limit, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(mag);
+	assert(mem);
+	assert(limit);
+	assert(data);
+
+	sys_lock();
+	{
+		memset(mag, 0, sizeof(mag_t));
+
+		mag->mem   = mem;
+		mag->limit = limit;
+		mag->data  = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+mag_t *mag_create( mem_t *mem, unsigned limit )
+/* -------------------------------------------------------------------------- */
+{
+	mag_t *mag;
+
+	assert(!port_isr_inside());
+	assert(mem);
+	assert(limit);
+
+	sys_lock();
+	{
+		mag = core_sys_alloc(ABOVE(sizeof(mag_t)) + limit * sizeof(void *));
+		mag_init(mag, mem, limit, (void *)((size_t)mag + ABOVE(sizeof(mag_t))));
+		mag->res = mag;
+	}
+	sys_unlock();
+
+	return mag;
+}
+
+/* -------------------------------------------------------------------------- */
+void mag_flush( mag_t *mag )
+/* -------------------------------------------------------------------------- */
+{
+	assert(mag);
+
+	sys_lock();
+	{
+		while (mag->count > 0)
+			mem_give(mag->mem, mag->data[--mag->count]);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void mag_delete( mag_t *mag )
+/* -------------------------------------------------------------------------- */
+{
+	mag_flush(mag);
+	core_sys_free(mag->res);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mag_take( mag_t *mag, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_SUCCESS;
+
+	assert(mag);
+	assert(data);
+
+	sys_lock();
+	{
+		if (mag->count == 0)
+			mag->count = priv_mem_getN(mag->mem, mag->data, (mag->limit + 1) / 2);
+
+		if (mag->count > 0)
+		{
+			*data = mag->data[--mag->count];
+		}
+		else
+		{
+			priv_mem_add(&mag->mem->fails, 1);
+			event = E_TIMEOUT;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+void mag_give( mag_t *mag, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(mag);
+	assert(data);
+
+	sys_lock();
+	{
+		if (mag->mem->queue)
+		{
+			mem_give(mag->mem, data); // a task is waiting for a memory object
+		}
+		else
+		{
+			if (mag->count == mag->limit)
+			{
+				cnt = (mag->limit + 1) / 2;
+				mag->count -= cnt;
+				priv_mem_putN(mag->mem, &mag->data[mag->count], cnt);
+			}
+
+			mag->data[mag->count++] = (void *)data;
+		}
 	}
 	sys_unlock();
 }
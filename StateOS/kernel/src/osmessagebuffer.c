@@ -30,17 +30,19 @@
  ******************************************************************************/
 
 #include "inc/osmessagebuffer.h"
+#include "inc/osstreambuffer.h"
 #include "inc/ostask.h"
 #include "inc/oscriticalsection.h"
 
 /* -------------------------------------------------------------------------- */
-void msg_init( msg_t *msg, unsigned limit, void *data )
+void msg_initPrefix( msg_t *msg, unsigned limit, void *data, unsigned code )
 /* -------------------------------------------------------------------------- */
 {
 	assert(!port_isr_inside());
 	assert(msg);
 	assert(limit);
 	assert(data);
+	assert(code <= msgPrefixVar);
 
 	sys_lock();
 	{
@@ -48,12 +50,20 @@ void msg_init( msg_t *msg, unsigned limit, void *data )
 
 		msg->limit = limit;
 		msg->data  = data;
+		msg->code  = code;
 	}
 	sys_unlock();
 }
 
 /* -------------------------------------------------------------------------- */
-msg_t *msg_create( unsigned limit )
+void msg_init( msg_t *msg, unsigned limit, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	msg_initPrefix(msg, limit, data, msgPrefixWord);
+}
+
+/* -------------------------------------------------------------------------- */
+msg_t *msg_createPrefix( unsigned limit, unsigned code )
 /* -------------------------------------------------------------------------- */
 {
 	msg_t *msg;
@@ -64,7 +74,7 @@ msg_t *msg_create( unsigned limit )
 	sys_lock();
 	{
 		msg = core_sys_alloc(ABOVE(sizeof(msg_t)) + limit);
-		msg_init(msg, limit, (void *)((size_t)msg + ABOVE(sizeof(msg_t))));
+		msg_initPrefix(msg, limit, (void *)((size_t)msg + ABOVE(sizeof(msg_t))), code);
 		msg->res = msg;
 	}
 	sys_unlock();
@@ -72,10 +82,19 @@ msg_t *msg_create( unsigned limit )
 	return msg;
 }
 
+/* -------------------------------------------------------------------------- */
+msg_t *msg_create( unsigned limit )
+/* -------------------------------------------------------------------------- */
+{
+	return msg_createPrefix(limit, msgPrefixWord);
+}
+
 /* -------------------------------------------------------------------------- */
 void msg_kill( msg_t *msg )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(msg);
 
@@ -85,21 +104,19 @@ void msg_kill( msg_t *msg )
 		msg->head  = 0;
 		msg->tail  = 0;
 
-		core_all_wakeup(msg, E_STOPPED);
+		core_all_detach(msg, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void msg_delete( msg_t *msg )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
-	{
-		msg_kill(msg);
-		core_sys_free(msg->res);
-	}
-	sys_unlock();
+	msg_kill(msg);
+	core_sys_free(msg->res);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -108,25 +125,86 @@ void priv_msg_peek( msg_t *msg, char *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
 	unsigned i = msg->head;
+	unsigned n = msg->limit - i;
 
-	while (size--)
+	if (size < n)
+		memcpy(data, &msg->data[i], size);
+	else
 	{
-		*data++ = msg->data[i++];
-		if (i >= msg->limit) i = 0;
+		memcpy(data, &msg->data[i], n);
+		memcpy(data + n, msg->data, size - n);
 	}
 }
 
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_msg_peekSize( msg_t *msg, unsigned *len )
+/* -------------------------------------------------------------------------- */
+{
+	uint8_t  buf[5];
+	uint16_t half;
+	unsigned size = 0;
+	unsigned i;
+
+	switch (msg->code)
+	{
+	case msgPrefix8:
+		priv_msg_peek(msg, (void *)buf, 1);
+		size = buf[0];
+		*len = 1;
+		break;
+
+	case msgPrefix16:
+		priv_msg_peek(msg, (void *)&half, sizeof(uint16_t));
+		size = half;
+		*len = sizeof(uint16_t);
+		break;
+
+	case msgPrefixVar:
+		priv_msg_peek(msg, (void *)buf, msg->count < sizeof(buf) ? msg->count : sizeof(buf));
+		for (i = 0; buf[i] & 0x80U; i++)
+			size |= (unsigned)(buf[i] & 0x7FU) << (7 * i);
+		size |= (unsigned)buf[i] << (7 * i);
+		*len = i + 1;
+		break;
+
+	default:
+		priv_msg_peek(msg, (void *)&size, sizeof(unsigned));
+		*len = sizeof(unsigned);
+		break;
+	}
+
+	return size;
+}
+
 /* -------------------------------------------------------------------------- */
 static
 unsigned priv_msg_count( msg_t *msg )
 /* -------------------------------------------------------------------------- */
 {
-	unsigned count = msg->count;
+	unsigned len;
+
+	return (msg->count > 0) ? priv_msg_peekSize(msg, &len) : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_msg_fit( msg_t *msg, unsigned free )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned size;
+
+	if (free <= MSG_PREFIX(msg->code, 0))
+		return 0;
 
-	if (count > 0)
-		priv_msg_peek(msg, (void *)&count, sizeof(unsigned));
+	size = free - MSG_PREFIX(msg->code, free); // the varint prefix of the largest message may be one byte shorter
+	if (size + 1 + MSG_PREFIX(msg->code, size + 1) <= free)
+		size++;
 
-	return count;
+	if (msg->code == msgPrefix8  && size > UINT8_MAX)  size = UINT8_MAX;
+	if (msg->code == msgPrefix16 && size > UINT16_MAX) size = UINT16_MAX;
+
+	return size;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -134,7 +212,7 @@ static
 unsigned priv_msg_space( msg_t *msg )
 /* -------------------------------------------------------------------------- */
 {
-	return ((msg->count == 0 || msg->queue == 0) && msg->limit - msg->count > sizeof(unsigned)) ? msg->limit - msg->count - sizeof(unsigned) : 0;
+	return (msg->count == 0 || msg->queue == 0) ? priv_msg_fit(msg, msg->limit - msg->count) : 0;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -142,7 +220,7 @@ static
 unsigned priv_msg_limit( msg_t *msg )
 /* -------------------------------------------------------------------------- */
 {
-	return (msg->limit > sizeof(unsigned)) ? msg->limit - sizeof(unsigned) : 0;
+	return priv_msg_fit(msg, msg->limit);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -151,14 +229,20 @@ void priv_msg_get( msg_t *msg, char *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
 	unsigned i = msg->head;
+	unsigned n = msg->limit - i;
 
 	msg->count -= size;
-	while (size--)
+	if (size < n)
+	{
+		memcpy(data, &msg->data[i], size);
+		msg->head = i + size;
+	}
+	else
 	{
-		*data++ = msg->data[i++];
-		if (i >= msg->limit) i = 0;
+		memcpy(data, &msg->data[i], n);
+		memcpy(data + n, msg->data, size - n);
+		msg->head = size - n;
 	}
-	msg->head = i;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -167,14 +251,20 @@ void priv_msg_put( msg_t *msg, const char *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
 	unsigned i = msg->tail;
+	unsigned n = msg->limit - i;
 
 	msg->count += size;
-	while (size--)
+	if (size < n)
 	{
-		msg->data[i++] = *data++;
-		if (i >= msg->limit) i = 0;
+		memcpy(&msg->data[i], data, size);
+		msg->tail = i + size;
+	}
+	else
+	{
+		memcpy(&msg->data[i], data, n);
+		memcpy(msg->data, data + n, size - n);
+		msg->tail = size - n;
 	}
-	msg->tail = i;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -194,9 +284,10 @@ unsigned priv_msg_getSize( msg_t *msg )
 {
 	assert(msg->count);
 
-	unsigned size;
+	unsigned len;
+	unsigned size = priv_msg_peekSize(msg, &len);
 
-	priv_msg_get(msg, (void *)&size, sizeof(unsigned));
+	priv_msg_skip(msg, len);
 
 	return size;
 }
@@ -206,54 +297,146 @@ static
 void priv_msg_putSize( msg_t *msg, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
+	uint8_t  buf[5];
+	uint16_t half;
+	unsigned len;
+
 	assert(size);
 
-	priv_msg_put(msg, (const void *)&size, sizeof(unsigned));
+	switch (msg->code)
+	{
+	case msgPrefix8:
+		buf[0] = (uint8_t)size;
+		priv_msg_put(msg, (const void *)buf, 1);
+		break;
+
+	case msgPrefix16:
+		half = (uint16_t)size;
+		priv_msg_put(msg, (const void *)&half, sizeof(uint16_t));
+		break;
+
+	case msgPrefixVar:
+		for (len = 0; size >= 0x80U; len++, size >>= 7)
+			buf[len] = (uint8_t)(size | 0x80U);
+		buf[len++] = (uint8_t)size;
+		priv_msg_put(msg, (const void *)buf, len);
+		break;
+
+	default:
+		priv_msg_put(msg, (const void *)&size, sizeof(unsigned));
+		break;
+	}
 }
 
 /* -------------------------------------------------------------------------- */
 static
-unsigned priv_msg_getUpdate( msg_t *msg, char *data, unsigned size )
+unsigned priv_msg_iovSize( const iov_t *iov, unsigned cnt )
 /* -------------------------------------------------------------------------- */
 {
-	size = priv_msg_getSize(msg);
-	priv_msg_get(msg, data, size);
+	unsigned size = 0;
 
-	while (msg->queue != 0 && msg->queue->tmp.msg.size <= priv_msg_space(msg))
+	while (cnt-- > 0)
+		size += iov++->size;
+
+	return size;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_msg_getv( msg_t *msg, const iov_t *iov, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len;
+
+	for (; size > 0; iov++)
 	{
-		priv_msg_putSize(msg, msg->queue->tmp.msg.size);
-		priv_msg_put(msg, msg->queue->tmp.msg.data.out, msg->queue->tmp.msg.size);
-		msg->queue->tmp.msg.size = 0;
-		core_tsk_wakeup(msg->queue, E_SUCCESS);
+		len = iov->size < size ? iov->size : size;
+		priv_msg_get(msg, iov->data, len);
+		size -= len;
 	}
+}
 
-	return size;
+/* -------------------------------------------------------------------------- */
+static
+void priv_msg_putv( msg_t *msg, const iov_t *iov, unsigned cnt )
+/* -------------------------------------------------------------------------- */
+{
+	for (; cnt > 0; cnt--, iov++)
+		if (iov->size > 0)
+			priv_msg_put(msg, iov->data, iov->size);
 }
 
 /* -------------------------------------------------------------------------- */
 static
-void priv_msg_putUpdate( msg_t *msg, const char *data, unsigned size )
+void priv_msg_getWakeup( msg_t *msg )
 /* -------------------------------------------------------------------------- */
 {
-	assert(size <= priv_msg_space(msg));
+	tsk_t *tsk;
 
-	priv_msg_putSize(msg, size);
-	priv_msg_put(msg, data, size);
+	while ((tsk = msg->queue) != 0 && tsk->tmp.msg.size <= priv_msg_space(msg))
+	{
+		priv_msg_putSize(msg, tsk->tmp.msg.size);
+		if (tsk->tmp.msg.cnt > 0)
+			priv_msg_putv(msg, tsk->tmp.msg.data.iov, tsk->tmp.msg.cnt);
+		else
+			priv_msg_put(msg, tsk->tmp.msg.data.out, tsk->tmp.msg.size);
+		tsk->tmp.msg.size = 0;
+		core_tsk_wakeup(tsk, E_SUCCESS);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_msg_putWakeup( msg_t *msg )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t   *tsk;
+	unsigned size;
 
-	while (msg->queue != 0)
+	while ((tsk = msg->queue) != 0)
 	{
-		if (msg->queue->tmp.msg.size >= priv_msg_count(msg))
+		if (tsk->tmp.msg.size >= priv_msg_count(msg))
 		{
 			size = priv_msg_getSize(msg);
-			priv_msg_get(msg, msg->queue->tmp.msg.data.in, size);
-			msg->queue->tmp.msg.size -= size;
-			core_tsk_wakeup(msg->queue, E_SUCCESS);
+			if (tsk->tmp.msg.cnt > 0)
+				priv_msg_getv(msg, tsk->tmp.msg.data.iov, size);
+			else
+				priv_msg_get(msg, tsk->tmp.msg.data.in, size);
+			tsk->tmp.msg.size -= size;
+			core_tsk_wakeup(tsk, E_SUCCESS);
 		}
 		else
 		{
-			core_tsk_wakeup(msg->queue, E_TIMEOUT);
+			core_tsk_wakeup(tsk, E_TIMEOUT);
 		}
 	}
+
+	if (msg->count > 0)
+		core_sel_notify(msg);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_msg_getUpdate( msg_t *msg, char *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	size = priv_msg_getSize(msg);
+	priv_msg_get(msg, data, size);
+	priv_msg_getWakeup(msg);
+
+	return size;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_msg_putUpdate( msg_t *msg, const char *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(size <= priv_msg_space(msg));
+
+	priv_msg_putSize(msg, size);
+	priv_msg_put(msg, data, size);
+	priv_msg_putWakeup(msg);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -301,6 +484,7 @@ unsigned priv_msg_wait( msg_t *msg, char *data, unsigned size, cnt_t time, unsig
 		{
 			System.cur->tmp.msg.data.in = data;
 			System.cur->tmp.msg.size = size;
+			System.cur->tmp.msg.cnt = 0;
 			wait(msg, time);
 			len = size - System.cur->tmp.msg.size;
 		}
@@ -324,6 +508,60 @@ unsigned msg_waitUntil( msg_t *msg, void *data, unsigned size, cnt_t time )
 	return priv_msg_wait(msg, data, size, time, core_tsk_waitUntil);
 }
 
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_msg_waitv( msg_t *msg, const iov_t *iov, unsigned cnt, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len = 0;
+	unsigned size;
+
+	assert(!port_isr_inside());
+	assert(msg);
+	assert(iov || cnt == 0);
+
+	size = priv_msg_iovSize(iov, cnt);
+
+	sys_lock();
+	{
+		if (msg->count > 0)
+		{
+			if (size >= priv_msg_count(msg))
+			{
+				len = priv_msg_getSize(msg);
+				priv_msg_getv(msg, iov, len);
+				priv_msg_getWakeup(msg);
+			}
+		}
+		else
+		if (size > 0)
+		{
+			System.cur->tmp.msg.data.iov = iov;
+			System.cur->tmp.msg.size = size;
+			System.cur->tmp.msg.cnt = cnt;
+			wait(msg, time);
+			len = size - System.cur->tmp.msg.size;
+		}
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned msg_waitv( msg_t *msg, const iov_t *iov, unsigned cnt, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_msg_waitv(msg, iov, cnt, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned msg_waitvUntil( msg_t *msg, const iov_t *iov, unsigned cnt, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_msg_waitv(msg, iov, cnt, time, core_tsk_waitUntil);
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned msg_give( msg_t *msg, const void *data, unsigned size )
 /* -------------------------------------------------------------------------- */
@@ -333,6 +571,9 @@ unsigned msg_give( msg_t *msg, const void *data, unsigned size )
 	assert(msg);
 	assert(data);
 
+	if (msg->over)
+		return msg_push(msg, data, size);
+
 	sys_lock();
 	{
 		if (size > 0)
@@ -357,6 +598,9 @@ unsigned priv_msg_send( msg_t *msg, const char *data, unsigned size, cnt_t time,
 	assert(msg);
 	assert(data);
 
+	if (msg->over)
+		return msg_push(msg, data, size);
+
 	sys_lock();
 	{
 		if (size > 0)
@@ -368,6 +612,7 @@ unsigned priv_msg_send( msg_t *msg, const char *data, unsigned size, cnt_t time,
 			{
 				System.cur->tmp.msg.data.out = data;
 				System.cur->tmp.msg.size = size;
+				System.cur->tmp.msg.cnt = 0;
 				wait(msg, time);
 				len = size - System.cur->tmp.msg.size;
 			}
@@ -392,6 +637,65 @@ unsigned msg_sendUntil( msg_t *msg, const void *data, unsigned size, cnt_t time
 	return priv_msg_send(msg, data, size, time, core_tsk_waitUntil);
 }
 
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_msg_sendv( msg_t *msg, const iov_t *iov, unsigned cnt, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len = 0;
+	unsigned size;
+
+	assert(!port_isr_inside());
+	assert(msg);
+	assert(iov || cnt == 0);
+
+	size = priv_msg_iovSize(iov, cnt);
+
+	sys_lock();
+	{
+		if (size > 0)
+		{
+			if (size <= priv_msg_space(msg) || (msg->over && size <= priv_msg_limit(msg)))
+			{
+				while (size > priv_msg_space(msg))
+				{
+					priv_msg_skip(msg, priv_msg_getSize(msg));
+					msg->drop++;
+				}
+				priv_msg_putSize(msg, len = size);
+				priv_msg_putv(msg, iov, cnt);
+				priv_msg_putWakeup(msg);
+			}
+			else
+			if (size <= priv_msg_limit(msg) && !msg->over)
+			{
+				System.cur->tmp.msg.data.iov = iov;
+				System.cur->tmp.msg.size = size;
+				System.cur->tmp.msg.cnt = cnt;
+				wait(msg, time);
+				len = size - System.cur->tmp.msg.size;
+			}
+		}
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned msg_sendv( msg_t *msg, const iov_t *iov, unsigned cnt, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_msg_sendv(msg, iov, cnt, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned msg_sendvUntil( msg_t *msg, const iov_t *iov, unsigned cnt, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_msg_sendv(msg, iov, cnt, time, core_tsk_waitUntil);
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned msg_push( msg_t *msg, const void *data, unsigned size )
 /* -------------------------------------------------------------------------- */
@@ -406,7 +710,10 @@ unsigned msg_push( msg_t *msg, const void *data, unsigned size )
 		if ((msg->count == 0 || msg->queue == 0) && size > 0 && size <= priv_msg_limit(msg))
 		{
 			while (size > priv_msg_space(msg))
+			{
 				priv_msg_skip(msg, priv_msg_getSize(msg));
+				msg->drop++;
+			}
 			priv_msg_putUpdate(msg, data, len = size);
 		}
 	}
@@ -415,6 +722,141 @@ unsigned msg_push( msg_t *msg, const void *data, unsigned size )
 	return len;
 }
 
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_msg_splice( msg_t *msg, stm_t *src, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	const void *data;
+	unsigned    len;
+	unsigned    n;
+
+	if (size > stm_count(src))
+		size = stm_count(src);
+	if (size > priv_msg_space(msg))
+		size = priv_msg_space(msg);
+
+	if (size > 0)
+	{
+		priv_msg_putSize(msg, size);
+		for (n = size; n > 0; n -= len) // at most two segments of the source ring buffer
+		{
+			len = stm_peek(src, &data);
+			if (len > n)
+				len = n;
+			priv_msg_put(msg, data, len);
+			stm_consume(src, len);
+		}
+		priv_msg_putWakeup(msg);
+	}
+
+	return size;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned msg_splice( msg_t *msg, stm_t *src, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len;
+
+	assert(msg);
+	assert(src);
+
+	sys_lock();
+	{
+		len = priv_msg_splice(msg, src, size);
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_msg_spliceWait( msg_t *msg, stm_t *src, unsigned size, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len = 0;
+	unsigned min;
+	char     tmp;
+
+	assert(!port_isr_inside());
+	assert(msg);
+	assert(src);
+
+	sys_lock();
+	{
+		min = src->level;
+		if (min > size)
+			min = size;
+		if (min > src->limit)
+			min = src->limit;
+		if (min == 0)
+			min = 1;
+
+		if (src->count >= min || (src->count > 0 && src->queue != 0 && src->queue->tmp.stm.min == 0))
+		{
+			len = priv_msg_splice(msg, src, size);
+		}
+		else
+		if (size > 0)
+		{
+			System.cur->tmp.stm.data.in = &tmp; // wait as a reader of the stream buffer without a buffer
+			System.cur->tmp.stm.size = 0;
+			System.cur->tmp.stm.min = min;
+			wait(src, time);
+			len = priv_msg_splice(msg, src, size);
+		}
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned msg_spliceFor( msg_t *msg, stm_t *src, unsigned size, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_msg_spliceWait(msg, src, size, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned msg_spliceUntil( msg_t *msg, stm_t *src, unsigned size, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_msg_spliceWait(msg, src, size, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+void msg_setOverwrite( msg_t *msg, bool enable )
+/* -------------------------------------------------------------------------- */
+{
+	assert(msg);
+
+	sys_lock();
+	{
+		msg->over = enable;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned msg_dropped( msg_t *msg )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(msg);
+
+	sys_lock();
+	{
+		cnt = msg->drop;
+	}
+	sys_unlock();
+
+	return cnt;
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned msg_count( msg_t *msg )
 /* -------------------------------------------------------------------------- */
@@ -0,0 +1,360 @@
+/******************************************************************************
+
+    @file    StateOS: osmpmcqueue.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osmpmcqueue.h"
+#include "inc/ostask.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned *priv_mpq_slot( mpq_t *mpq, unsigned idx )
+/* -------------------------------------------------------------------------- */
+{
+	return mpq->data + idx * _MPQ_SLOT(mpq->size);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_mpq_reset( mpq_t *mpq )
+/* -------------------------------------------------------------------------- */
+{
+	mpq->head = 0;
+	mpq->tail = 0;
+
+	memset(mpq->data, 0, (mpq->mask + 1) * _MPQ_SLOT(mpq->size) * sizeof(unsigned));
+}
+
+/* -------------------------------------------------------------------------- */
+void mpq_init( mpq_t *mpq, unsigned limit, void *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(mpq);
+	assert(limit && (limit & (limit - 1)) == 0);
+	assert(data);
+	assert(size);
+
+	sys_lock();
+	{
+		memset(mpq, 0, sizeof(mpq_t));
+
+		mpq->mask = limit - 1;
+		mpq->size = size;
+		mpq->data = data;
+
+		priv_mpq_reset(mpq);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+mpq_t *mpq_create( unsigned limit, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	mpq_t *mpq;
+
+	assert(!port_isr_inside());
+	assert(limit);
+	assert(size);
+
+	sys_lock();
+	{
+		mpq = core_sys_alloc(ABOVE(sizeof(mpq_t)) + limit * _MPQ_SLOT(size) * sizeof(unsigned));
+		mpq_init(mpq, limit, (void *)((size_t)mpq + ABOVE(sizeof(mpq_t))), size);
+		mpq->res = mpq;
+	}
+	sys_unlock();
+
+	return mpq;
+}
+
+/* -------------------------------------------------------------------------- */
+void mpq_kill( mpq_t *mpq )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t hld[2];
+
+	assert(!port_isr_inside());
+	assert(mpq);
+
+	sys_lock();
+	{
+		priv_mpq_reset(mpq);
+
+		core_all_detach(mpq, &hld[0]);
+		core_all_detach(&mpq->send, &hld[1]);
+	}
+	sys_unlock();
+
+	core_all_release(&hld[0], E_STOPPED);
+	core_all_release(&hld[1], E_STOPPED);
+}
+
+/* -------------------------------------------------------------------------- */
+void mpq_delete( mpq_t *mpq )
+/* -------------------------------------------------------------------------- */
+{
+	mpq_kill(mpq);
+	core_sys_free(mpq->res);
+}
+
+/* -------------------------------------------------------------------------- */
+// lock-free: claim the slot at position 'head' and copy the mail out of it
+static
+bool priv_mpq_get( mpq_t *mpq, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned *slot;
+	unsigned  pos, idx;
+	int       dif;
+
+	for (;;)
+	{
+		pos  = mpq->head;
+		idx  = pos & mpq->mask;
+		slot = priv_mpq_slot(mpq, idx);
+		dif  = (int)(*(volatile unsigned *)slot + idx - (pos + 1));
+		if (dif < 0)
+			return false; // the slot has not been written yet: the queue is empty
+		if (dif == 0 && port_atomic_cas32((volatile uint32_t *)&mpq->head, pos, pos + 1))
+			break;
+	}
+
+	port_mem_barrier();
+	memcpy(data, slot + 1, mpq->size);
+	port_mem_barrier();
+	*(volatile unsigned *)slot = pos + mpq->mask + 1 - idx; // the slot is free for the next round
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+// lock-free: claim the slot at position 'tail' and copy the mail into it
+static
+bool priv_mpq_put( mpq_t *mpq, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned *slot;
+	unsigned  pos, idx;
+	int       dif;
+
+	for (;;)
+	{
+		pos  = mpq->tail;
+		idx  = pos & mpq->mask;
+		slot = priv_mpq_slot(mpq, idx);
+		dif  = (int)(*(volatile unsigned *)slot + idx - pos);
+		if (dif < 0)
+			return false; // the slot has not been read yet: the queue is full
+		if (dif == 0 && port_atomic_cas32((volatile uint32_t *)&mpq->tail, pos, pos + 1))
+			break;
+	}
+
+	port_mem_barrier();
+	memcpy(slot + 1, data, mpq->size);
+	port_mem_barrier();
+	*(volatile unsigned *)slot = pos + 1 - idx; // the slot holds the mail
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+// wake up a task waiting in the queue 'obj', if any
+static
+void priv_mpq_wakeup( void *obj )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t *lst = obj;
+
+	port_mem_barrier();
+	if (lst->queue == 0)
+		return;
+
+	sys_lock();
+	{
+		core_one_wakeup(lst, E_SUCCESS);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mpq_take( mpq_t *mpq, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(mpq);
+	assert(data);
+
+	if (!priv_mpq_get(mpq, data))
+		return E_TIMEOUT;
+
+	priv_mpq_wakeup(&mpq->send);
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_mpq_wait( mpq_t *mpq, void *data, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(mpq);
+	assert(data);
+
+	sys_lock();
+	{
+		for (;;)
+		{
+			// a producer publishes its mail before checking the queue of consumers,
+			// so the mail is either found here or the producer finds this task waiting
+			if (priv_mpq_get(mpq, data))
+			{
+				event = E_SUCCESS;
+				break;
+			}
+			event = wait(mpq, time);
+			if (event != E_SUCCESS)
+				break;
+			// woken up: try again, another consumer may have been faster
+		}
+	}
+	sys_unlock();
+
+	if (event == E_SUCCESS)
+		priv_mpq_wakeup(&mpq->send);
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mpq_waitFor( mpq_t *mpq, void *data, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	if (delay == IMMEDIATE || delay == INFINITE)
+		return priv_mpq_wait(mpq, data, delay, core_tsk_waitFor);
+
+	// retries after a wakeup must not extend the timeout
+	return priv_mpq_wait(mpq, data, core_sys_time() + delay, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mpq_waitUntil( mpq_t *mpq, void *data, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_mpq_wait(mpq, data, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mpq_give( mpq_t *mpq, const void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(mpq);
+	assert(data);
+
+	if (!priv_mpq_put(mpq, data))
+		return E_TIMEOUT;
+
+	priv_mpq_wakeup(mpq);
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_mpq_send( mpq_t *mpq, const void *data, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(mpq);
+	assert(data);
+
+	sys_lock();
+	{
+		for (;;)
+		{
+			if (priv_mpq_put(mpq, data))
+			{
+				event = E_SUCCESS;
+				break;
+			}
+			event = wait(&mpq->send, time);
+			if (event != E_SUCCESS)
+				break;
+			// woken up: try again, another producer may have been faster
+		}
+	}
+	sys_unlock();
+
+	if (event == E_SUCCESS)
+		priv_mpq_wakeup(mpq);
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mpq_sendFor( mpq_t *mpq, const void *data, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	if (delay == IMMEDIATE || delay == INFINITE)
+		return priv_mpq_send(mpq, data, delay, core_tsk_waitFor);
+
+	// retries after a wakeup must not extend the timeout
+	return priv_mpq_send(mpq, data, core_sys_time() + delay, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mpq_sendUntil( mpq_t *mpq, const void *data, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_mpq_send(mpq, data, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned mpq_count( mpq_t *mpq )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned head, tail;
+
+	assert(mpq);
+
+	do
+	{
+		head = mpq->head;
+		tail = mpq->tail;
+	}
+	while (head != mpq->head);
+
+	return tail - head;
+}
+
+/* -------------------------------------------------------------------------- */
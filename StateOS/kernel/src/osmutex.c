@@ -34,7 +34,7 @@
 #include "inc/oscriticalsection.h"
 
 /* -------------------------------------------------------------------------- */
-void mtx_init( mtx_t *mtx )
+void mtx_initCeiling( mtx_t *mtx, unsigned ceiling )
 /* -------------------------------------------------------------------------- */
 {
 	assert(!port_isr_inside());
@@ -42,13 +42,40 @@ void mtx_init( mtx_t *mtx )
 
 	sys_lock();
 	{
+#if OS_OBJ_STATS
+		core_ost_remove(&mtx->ost);
+#endif
 		memset(mtx, 0, sizeof(mtx_t));
+
+		mtx->ceiling = ceiling;
 	}
 	sys_unlock();
 }
 
 /* -------------------------------------------------------------------------- */
-mtx_t *mtx_create( void )
+void mtx_init( mtx_t *mtx )
+/* -------------------------------------------------------------------------- */
+{
+	mtx_initCeiling(mtx, 0);
+}
+
+/* -------------------------------------------------------------------------- */
+void mtx_initBarging( mtx_t *mtx )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(mtx);
+
+	sys_lock();
+	{
+		mtx_initCeiling(mtx, 0);
+		mtx->barging = true;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+mtx_t *mtx_createCeiling( unsigned ceiling )
 /* -------------------------------------------------------------------------- */
 {
 	mtx_t *mtx;
@@ -58,7 +85,7 @@ mtx_t *mtx_create( void )
 	sys_lock();
 	{
 		mtx = core_sys_alloc(sizeof(mtx_t));
-		mtx_init(mtx);
+		mtx_initCeiling(mtx, ceiling);
 		mtx->res = mtx;
 	}
 	sys_unlock();
@@ -66,6 +93,31 @@ mtx_t *mtx_create( void )
 	return mtx;
 }
 
+/* -------------------------------------------------------------------------- */
+mtx_t *mtx_create( void )
+/* -------------------------------------------------------------------------- */
+{
+	return mtx_createCeiling(0);
+}
+
+/* -------------------------------------------------------------------------- */
+mtx_t *mtx_createBarging( void )
+/* -------------------------------------------------------------------------- */
+{
+	mtx_t *mtx;
+
+	assert(!port_isr_inside());
+
+	sys_lock();
+	{
+		mtx = mtx_createCeiling(0);
+		mtx->barging = true;
+	}
+	sys_unlock();
+
+	return mtx;
+}
+
 /* -------------------------------------------------------------------------- */
 static
 void priv_mtx_link( mtx_t *mtx, tsk_t *tsk )
@@ -79,9 +131,32 @@ void priv_mtx_link( mtx_t *mtx, tsk_t *tsk )
 	{
 		mtx->list = tsk->mtx.list;
 		tsk->mtx.list = mtx;
+
+		if (tsk->prio < mtx->ceiling)
+		{
+			if (tsk == System.cur)
+				core_cur_raise(mtx->ceiling);
+			else
+				core_tsk_prio(tsk, mtx->ceiling);
+		}
 	}
 }
 
+/* -------------------------------------------------------------------------- */
+static
+void priv_mtx_barge( mtx_t *mtx )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+
+	// the current task has taken a free barging mutex while other tasks are still waiting for it:
+	// waiters now block on the current task and it inherits the priority of the first one
+	for (tsk = mtx->queue; tsk; tsk = tsk->obj.queue)
+		tsk->mtx.tree = System.cur;
+
+	core_tsk_prio(System.cur, System.cur->prio);
+}
+
 /* -------------------------------------------------------------------------- */
 static
 void priv_mtx_unlink( mtx_t *mtx )
@@ -106,7 +181,7 @@ void priv_mtx_unlink( mtx_t *mtx )
 		mtx->list  = 0;
 		mtx->owner = 0;
 
-		core_tsk_prio(tsk, tsk->basic);
+		core_tsk_prio(tsk, 0); // back to the basic priority
 	}
 }
 
@@ -114,6 +189,8 @@ void priv_mtx_unlink( mtx_t *mtx )
 void mtx_kill( mtx_t *mtx )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(mtx);
 
@@ -123,21 +200,67 @@ void mtx_kill( mtx_t *mtx )
 
 		mtx->count = 0;
 
-		core_all_wakeup(mtx, E_STOPPED);
+		core_all_detach(mtx, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void mtx_delete( mtx_t *mtx )
 /* -------------------------------------------------------------------------- */
 {
+	mtx_kill(mtx);
+#if OS_OBJ_STATS
 	sys_lock();
 	{
-		mtx_kill(mtx);
-		core_sys_free(mtx->res);
+		core_ost_remove(&mtx->ost);
 	}
 	sys_unlock();
+#endif
+	core_sys_free(mtx->res);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_mtx_retry( mtx_t *mtx, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	cnt_t    start = core_sys_time();
+	cnt_t    delay;
+	unsigned event;
+
+	for (;;)
+	{
+		if (mtx->owner->prio < System.cur->prio)
+			core_tsk_prio(mtx->owner, System.cur->prio);
+
+		System.cur->mtx.tree = mtx->owner;
+		event = core_stat_wait(mtx, time, wait);
+		System.cur->mtx.tree = 0;
+
+		if (event != E_SUCCESS)
+			return event;
+
+		if (mtx->owner == 0)					// the mutex is still free after the wakeup
+		{
+			priv_mtx_link(mtx, System.cur);
+			if (mtx->queue)
+				priv_mtx_barge(mtx);
+			return E_SUCCESS;
+		}
+
+		// another task has taken the mutex before the woken task was resumed, wait again for the rest of the time
+		if (wait == core_tsk_waitFor && time != INFINITE)
+		{
+			delay = core_sys_time() - start;
+			if (delay >= time)
+				return E_TIMEOUT;
+			time -= delay;
+			start += delay;
+		}
+	}
 }
 
 /* -------------------------------------------------------------------------- */
@@ -155,6 +278,9 @@ unsigned priv_mtx_wait( mtx_t *mtx, cnt_t time, unsigned(*wait)(void*,cnt_t) )
 		if (mtx->owner == 0)
 		{
 			priv_mtx_link(mtx, System.cur);
+			if (mtx->queue)
+				priv_mtx_barge(mtx);
+			core_stat_take(mtx, false);
 			event = E_SUCCESS;
 		}
 		else
@@ -163,17 +289,36 @@ unsigned priv_mtx_wait( mtx_t *mtx, cnt_t time, unsigned(*wait)(void*,cnt_t) )
 			if (mtx->count < ~0U)
 			{
 				mtx->count++;
+				core_stat_take(mtx, false);
 				event = E_SUCCESS;
 			}
 		}
 		else
+		if (mtx->ceiling)
+		{
+			assert(System.cur->basic <= mtx->ceiling);
+
+			event = core_stat_wait(mtx, time, wait);	// the owner already has the ceiling priority
+			if (event == E_SUCCESS)
+				core_stat_take(mtx, true);
+		}
+		else
+		if (mtx->barging)
+		{
+			event = priv_mtx_retry(mtx, time, wait);
+			if (event == E_SUCCESS)
+				core_stat_take(mtx, true);
+		}
+		else
 		{
 			if (mtx->owner->prio < System.cur->prio)
 				core_tsk_prio(mtx->owner, System.cur->prio);
 
 			System.cur->mtx.tree = mtx->owner;
-			event = wait(mtx, time);
+			event = core_stat_wait(mtx, time, wait);
 			System.cur->mtx.tree = 0;
+			if (event == E_SUCCESS)
+				core_stat_take(mtx, true);
 		}
 	}
 	sys_unlock();
@@ -215,7 +360,10 @@ unsigned mtx_give( mtx_t *mtx )
 			else
 			{
 				priv_mtx_unlink(mtx);
-				priv_mtx_link(mtx, core_one_wakeup(mtx, E_SUCCESS));
+				if (mtx->barging)
+					core_one_wakeup(mtx, E_SUCCESS);	// the woken task tries to lock the mutex again
+				else
+					priv_mtx_link(mtx, core_one_wakeup(mtx, E_SUCCESS));
 			}
 
 			event = E_SUCCESS;
@@ -227,3 +375,55 @@ unsigned mtx_give( mtx_t *mtx )
 }
 
 /* -------------------------------------------------------------------------- */
+
+#if OS_LIBC_MUTEX
+
+static
+mtx_t LibMutex = _MTX_INIT();
+
+static
+unsigned LibLock = 0;
+
+static
+unsigned LibCount = 0; // nesting level of the locks taken by masking interrupts
+
+/* -------------------------------------------------------------------------- */
+void core_lib_lock( void )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned lock;
+
+	if (LibCount || port_isr_inside() || port_get_lock()) // the mutex cannot be waited for
+	{
+		assert(LibCount+1);
+		assert(port_isr_inside() || LibMutex.owner == 0 || LibMutex.owner == System.cur);
+
+		lock = port_get_lock();
+		port_set_lock();
+		if (LibCount++ == 0U)
+			LibLock = lock;
+	}
+	else
+	{
+		mtx_wait(&LibMutex);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+void core_lib_unlock( void )
+/* -------------------------------------------------------------------------- */
+{
+	if (LibCount)
+	{
+		if (--LibCount == 0U)
+			port_put_lock(LibLock);
+	}
+	else
+	{
+		mtx_give(&LibMutex);
+	}
+}
+
+#endif//OS_LIBC_MUTEX
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,237 @@
+/******************************************************************************
+
+    @file    StateOS: ospacket.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/ospacket.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_pkt_release( pkt_t *pkt )
+/* -------------------------------------------------------------------------- */
+{
+	pkt_t *nxt;
+
+	while (pkt)
+	{
+		nxt = pkt->next;
+		mem_give(pkt->mem, pkt);
+		pkt = nxt;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+pkt_t *pkt_alloc( mem_t *mem, unsigned size, unsigned reserve )
+/* -------------------------------------------------------------------------- */
+{
+	pkt_t  * pkt = 0;
+	pkt_t ** nxt = &pkt;
+	void   * buf;
+	unsigned total = size;
+	unsigned room;
+
+	assert(mem);
+	assert(mem->size * sizeof(que_t) >= PKT_SIZE(reserve));
+
+	do
+	{
+		if (mem_take(mem, &buf) != E_SUCCESS)
+		{
+			priv_pkt_release(pkt);
+			return 0;
+		}
+
+		*nxt = buf;
+		(*nxt)->next   = 0;
+		(*nxt)->mem    = mem;
+		(*nxt)->offset = pkt == *nxt ? reserve : 0;
+		room = mem->size * sizeof(que_t) - PKT_SIZE((*nxt)->offset);
+		(*nxt)->length = size < room ? size : room;
+		size -= (*nxt)->length;
+		nxt = &(*nxt)->next;
+	}
+	while (size > 0);
+
+	pkt->refs  = 1;
+	pkt->total = total;
+
+	return pkt;
+}
+
+/* -------------------------------------------------------------------------- */
+pkt_t *pkt_ref( pkt_t *pkt )
+/* -------------------------------------------------------------------------- */
+{
+	assert(pkt);
+
+	sys_lock();
+	{
+		assert(pkt->refs);
+		pkt->refs++;
+	}
+	sys_unlock();
+
+	return pkt;
+}
+
+/* -------------------------------------------------------------------------- */
+void pkt_free( pkt_t *pkt )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned refs;
+
+	assert(pkt);
+
+	sys_lock();
+	{
+		assert(pkt->refs);
+		refs = --pkt->refs;
+	}
+	sys_unlock();
+
+	if (refs == 0)
+		priv_pkt_release(pkt);
+}
+
+/* -------------------------------------------------------------------------- */
+void *pkt_push( pkt_t *pkt, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(pkt);
+
+	if (size > pkt->offset)
+		return 0;
+
+	pkt->offset -= size;
+	pkt->length += size;
+	pkt->total  += size;
+
+	return pkt_data(pkt);
+}
+
+/* -------------------------------------------------------------------------- */
+void *pkt_pull( pkt_t *pkt, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(pkt);
+
+	if (size > pkt->length)
+		return 0;
+
+	pkt->offset += size;
+	pkt->length -= size;
+	pkt->total  -= size;
+
+	return pkt_data(pkt);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_pkt_copy( pkt_t *pkt, unsigned offset, char *data, unsigned size, bool write )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned done = 0;
+	unsigned len;
+
+	assert(pkt);
+	assert(data || size == 0);
+
+	for (; pkt && size > 0; pkt = pkt->next)
+	{
+		if (offset >= pkt->length)
+		{
+			offset -= pkt->length;
+			continue;
+		}
+
+		len = pkt->length - offset;
+		if (len > size)
+			len = size;
+
+		if (write)
+			memcpy((char *)pkt_data(pkt) + offset, data + done, len);
+		else
+			memcpy(data + done, (char *)pkt_data(pkt) + offset, len);
+
+		done  += len;
+		size  -= len;
+		offset = 0;
+	}
+
+	return done;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pkt_read( pkt_t *pkt, unsigned offset, void *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_pkt_copy(pkt, offset, data, size, false);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pkt_write( pkt_t *pkt, unsigned offset, const void *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_pkt_copy(pkt, offset, (char *)data, size, true);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pkt_waitFor( lst_t *lst, pkt_t **pkt, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	void   * ptr;
+	unsigned event;
+
+	assert(pkt);
+
+	event = lst_waitFor(lst, &ptr, delay);
+	if (event == E_SUCCESS)
+		*pkt = (pkt_t *)((que_t *)ptr - 1);
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pkt_take( lst_t *lst, pkt_t **pkt )
+/* -------------------------------------------------------------------------- */
+{
+	void   * ptr;
+	unsigned event;
+
+	assert(pkt);
+
+	event = lst_take(lst, &ptr);
+	if (event == E_SUCCESS)
+		*pkt = (pkt_t *)((que_t *)ptr - 1);
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
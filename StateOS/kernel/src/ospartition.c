@@ -0,0 +1,85 @@
+/******************************************************************************
+
+    @file    StateOS: ospartition.c
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/ospartition.h"
+#include "inc/oscriticalsection.h"
+
+#if OS_TASK_PARTITION
+
+/* -------------------------------------------------------------------------- */
+void prt_start( const pwn_t *tab, unsigned cnt )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned i;
+
+	assert(!port_isr_inside());
+	assert(tab);
+	assert(cnt);
+
+	for (i = 0; i < cnt; i++)
+		assert(tab[i].time > 0 && tab[i].time != INFINITE && tab[i].part != PRT_ALL);
+
+	sys_lock();
+	{
+		core_prt_start(tab, cnt);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void prt_stop( void )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+
+	sys_lock();
+	{
+		core_prt_start(0, 0);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned prt_active( void )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned part;
+
+	sys_lock();
+	{
+		part = core_prt_active();
+	}
+	sys_unlock();
+
+	return part;
+}
+
+#endif//OS_TASK_PARTITION
@@ -0,0 +1,79 @@
+/******************************************************************************
+
+    @file    StateOS: osperfcounter.c
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osperfcounter.h"
+#include "inc/oscriticalsection.h"
+
+#if OS_TASK_PERF
+
+/* -------------------------------------------------------------------------- */
+void perf_sample( void )
+/* -------------------------------------------------------------------------- */
+{
+	sys_lock();
+	{
+		core_pfc_account();
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void perf_getTask( tsk_t *tsk, pfc_t *perf, bool clear )
+/* -------------------------------------------------------------------------- */
+{
+	assert(tsk);
+	assert(perf);
+
+	sys_lock();
+	{
+		core_pfc_account();
+		*perf = tsk->perf;
+		if (clear)
+			memset(&tsk->perf, 0, sizeof(tsk->perf));
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void perf_reset( tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	assert(tsk);
+
+	sys_lock();
+	{
+		core_pfc_account();
+		memset(&tsk->perf, 0, sizeof(tsk->perf));
+	}
+	sys_unlock();
+}
+
+#endif//OS_TASK_PERF
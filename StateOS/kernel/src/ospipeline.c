@@ -0,0 +1,168 @@
+/******************************************************************************
+
+    @file    StateOS: ospipeline.c
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/ospipeline.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void stg_init( stg_t *stg, mem_t *mem, stp_t *proc, unsigned batch, unsigned limit, void **data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(stg);
+	assert(mem);
+	assert(proc);
+	assert(batch && batch <= STG_BATCH);
+
+	box_init(&stg->box, limit, data, sizeof(void *));
+
+	sys_lock();
+	{
+		stg->mem   = mem;
+		stg->next  = 0;
+		stg->proc  = proc;
+		stg->batch = batch;
+		stg->fused = false;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void stg_link( stg_t *stg, stg_t *next )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(stg);
+	assert(next);
+	assert(next != stg);
+	assert(next->mem == stg->mem);
+
+	sys_lock();
+	{
+		next->fused = false;
+		stg->next   = next;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void stg_fuse( stg_t *stg, stg_t *next )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(stg);
+	assert(next);
+	assert(next != stg);
+	assert(next->mem == stg->mem);
+
+	sys_lock();
+	{
+		next->fused = true;
+		stg->next   = next;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void *stg_alloc( stg_t *stg )
+/* -------------------------------------------------------------------------- */
+{
+	void *item;
+
+	assert(stg);
+
+	if (mem_wait(stg->mem, &item) != E_SUCCESS)
+		return 0;
+
+	return item;
+}
+
+/* -------------------------------------------------------------------------- */
+void stg_free( stg_t *stg, void *item )
+/* -------------------------------------------------------------------------- */
+{
+	assert(stg);
+	assert(item);
+
+	mem_give(stg->mem, item);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stg_put( stg_t *stg, void *item )
+/* -------------------------------------------------------------------------- */
+{
+	assert(stg);
+	assert(item);
+
+	if (stg->fused)
+	{
+		stg->proc(stg, &item, 1);
+		return E_SUCCESS;
+	}
+
+	return box_send(&stg->box, &item);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stg_send( stg_t *stg, void *item )
+/* -------------------------------------------------------------------------- */
+{
+	assert(stg);
+	assert(item);
+
+	if (stg->next)
+		return stg_put(stg->next, item);
+
+	mem_give(stg->mem, item);
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stg_run( stg_t *stg )
+/* -------------------------------------------------------------------------- */
+{
+	void   * item[STG_BATCH];
+	unsigned max = stg->batch < STG_BATCH ? stg->batch : STG_BATCH;
+	unsigned cnt;
+
+	assert(!port_isr_inside());
+	assert(stg);
+	assert(!stg->fused);
+
+	if (box_waitN(&stg->box, item, max ? max : 1, &cnt, INFINITE) != E_SUCCESS)
+		return 0;
+
+	stg->proc(stg, item, cnt);
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,377 @@
+/******************************************************************************
+
+    @file    StateOS: ospriorityjobqueue.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/ospriorityjobqueue.h"
+#include "inc/ostask.h"
+#include "inc/oscriticalsection.h"
+
+typedef struct { unsigned head; unsigned tail; } pjl_t; // first and last job slot of a priority level
+
+/* -------------------------------------------------------------------------- */
+void pjq_init( pjq_t *pjq, unsigned levels, unsigned limit, pjs_t *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(pjq);
+	assert(levels && levels <= 32);
+	assert(limit);
+	assert(data);
+
+	sys_lock();
+	{
+		memset(pjq, 0, sizeof(pjq_t));
+
+		pjq->limit  = limit;
+		pjq->levels = levels;
+		pjq->data   = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+pjq_t *pjq_create( unsigned levels, unsigned limit )
+/* -------------------------------------------------------------------------- */
+{
+	pjq_t *pjq;
+
+	assert(!port_isr_inside());
+	assert(levels && levels <= 32);
+	assert(limit);
+
+	sys_lock();
+	{
+		pjq = core_sys_alloc(ABOVE(sizeof(pjq_t)) + JSIZE(levels, limit) * sizeof(pjs_t));
+		pjq_init(pjq, levels, limit, (void *)((size_t)pjq + ABOVE(sizeof(pjq_t))));
+		pjq->res = pjq;
+	}
+	sys_unlock();
+
+	return pjq;
+}
+
+/* -------------------------------------------------------------------------- */
+void pjq_kill( pjq_t *pjq )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t hld;
+
+	assert(!port_isr_inside());
+	assert(pjq);
+
+	sys_lock();
+	{
+		pjq->count = 0;
+		pjq->map   = 0;
+		pjq->used  = 0;
+
+		core_all_detach(pjq, &hld);
+	}
+	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
+}
+
+/* -------------------------------------------------------------------------- */
+void pjq_delete( pjq_t *pjq )
+/* -------------------------------------------------------------------------- */
+{
+	pjq_kill(pjq);
+	core_sys_free(pjq->res);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+pjl_t *priv_pjq_level( pjq_t *pjq, unsigned prio )
+/* -------------------------------------------------------------------------- */
+{
+	// descriptors of priority levels follow the job slots, each one fits in a job slot
+	return (pjl_t *)(pjq->data + pjq->limit + prio);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+fun_t *priv_pjq_get( pjq_t *pjq )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned prio = port_get_msb(pjq->map);
+	pjl_t  * lvl  = priv_pjq_level(pjq, prio);
+	unsigned slot = lvl->head;
+	fun_t  * fun  = pjq->data[slot].fun;
+
+	if (slot == lvl->tail)
+		pjq->map &= ~(1U << prio);
+	else
+		lvl->head = pjq->data[slot].next;
+
+	pjq->data[slot].next = pjq->free;
+	pjq->free = slot;
+	pjq->count--;
+
+	return fun;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_pjq_put( pjq_t *pjq, fun_t *fun, unsigned prio )
+/* -------------------------------------------------------------------------- */
+{
+	pjl_t  * lvl = priv_pjq_level(pjq, prio);
+	unsigned slot;
+
+	if (pjq->count < pjq->used)
+	{
+		slot = pjq->free;
+		pjq->free = pjq->data[slot].next;
+	}
+	else
+		slot = pjq->used++;
+
+	pjq->data[slot].fun = fun;
+
+	if (pjq->map & (1U << prio))
+		pjq->data[lvl->tail].next = slot;
+	else
+	{
+		pjq->map |= 1U << prio;
+		lvl->head = slot;
+	}
+
+	lvl->tail = slot;
+	pjq->count++;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+fun_t *priv_pjq_getUpdate( pjq_t *pjq )
+/* -------------------------------------------------------------------------- */
+{
+	fun_t *fun;
+	tsk_t *tsk;
+
+	fun = priv_pjq_get(pjq);
+	tsk = core_one_wakeup(pjq, E_SUCCESS);
+	if (tsk) priv_pjq_put(pjq, tsk->tmp.pjq.fun, tsk->tmp.pjq.prio);
+
+	return fun;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_pjq_putUpdate( pjq_t *pjq, fun_t *fun, unsigned prio )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+
+	priv_pjq_put(pjq, fun, prio);
+	tsk = core_one_wakeup(pjq, E_SUCCESS);
+	if (tsk) tsk->tmp.pjq.fun = priv_pjq_get(pjq);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pjq_take( pjq_t *pjq )
+/* -------------------------------------------------------------------------- */
+{
+	fun_t  * fun;
+	unsigned event = E_TIMEOUT;
+
+	assert(pjq);
+
+	sys_lock();
+	{
+		if (pjq->count > 0)
+		{
+			fun = priv_pjq_getUpdate(pjq);
+			event = E_SUCCESS;
+		}
+
+		if (event == E_SUCCESS)
+		{
+			port_clr_lock();
+			fun();
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_pjq_wait( pjq_t *pjq, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	fun_t  * fun;
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(pjq);
+
+	sys_lock();
+	{
+		if (pjq->count > 0)
+		{
+			fun = priv_pjq_getUpdate(pjq);
+			event = E_SUCCESS;
+		}
+		else
+		{
+			event = wait(pjq, time);
+			fun = System.cur->tmp.pjq.fun;
+		}
+
+		if (event == E_SUCCESS)
+		{
+			port_clr_lock();
+			fun();
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pjq_waitFor( pjq_t *pjq, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_pjq_wait(pjq, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pjq_waitUntil( pjq_t *pjq, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_pjq_wait(pjq, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pjq_give( pjq_t *pjq, fun_t *fun, unsigned prio )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(pjq);
+	assert(fun);
+	assert(prio < pjq->levels);
+
+	sys_lock();
+	{
+		if (pjq->count < pjq->limit)
+		{
+			priv_pjq_putUpdate(pjq, fun, prio);
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_pjq_send( pjq_t *pjq, fun_t *fun, unsigned prio, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(pjq);
+	assert(fun);
+	assert(prio < pjq->levels);
+
+	sys_lock();
+	{
+		if (pjq->count < pjq->limit)
+		{
+			priv_pjq_putUpdate(pjq, fun, prio);
+			event = E_SUCCESS;
+		}
+		else
+		{
+			System.cur->tmp.pjq.fun = fun;
+			System.cur->tmp.pjq.prio = prio;
+			event = wait(pjq, time);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pjq_sendFor( pjq_t *pjq, fun_t *fun, unsigned prio, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_pjq_send(pjq, fun, prio, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pjq_sendUntil( pjq_t *pjq, fun_t *fun, unsigned prio, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_pjq_send(pjq, fun, prio, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pjq_count( pjq_t *pjq )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(pjq);
+
+	sys_lock();
+	{
+		cnt = pjq->count;
+	}
+	sys_unlock();
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pjq_space( pjq_t *pjq )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(pjq);
+
+	sys_lock();
+	{
+		cnt = pjq->limit - pjq->count;
+	}
+	sys_unlock();
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
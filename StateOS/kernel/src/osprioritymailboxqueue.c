@@ -0,0 +1,384 @@
+/******************************************************************************
+
+    @file    StateOS: osprioritymailboxqueue.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osprioritymailboxqueue.h"
+#include "inc/ostask.h"
+#include "inc/oscriticalsection.h"
+
+#define PBX_KEY( prio, seq ) (((prio) << 24) | ((seq) & 0x00FFFFFFU))
+
+/* -------------------------------------------------------------------------- */
+void pbx_init( pbx_t *pbx, unsigned limit, void *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(pbx);
+	assert(limit);
+	assert(data);
+	assert(size);
+
+	sys_lock();
+	{
+		memset(pbx, 0, sizeof(pbx_t));
+
+		pbx->limit = limit;
+		pbx->size  = size;
+		pbx->data  = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+pbx_t *pbx_create( unsigned limit, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	pbx_t *pbx;
+
+	assert(!port_isr_inside());
+	assert(limit);
+	assert(size);
+
+	sys_lock();
+	{
+		pbx = core_sys_alloc(ABOVE(sizeof(pbx_t)) + PSIZE(limit, size));
+		pbx_init(pbx, limit, (void *)((size_t)pbx + ABOVE(sizeof(pbx_t))), size);
+		pbx->res = pbx;
+	}
+	sys_unlock();
+
+	return pbx;
+}
+
+/* -------------------------------------------------------------------------- */
+void pbx_kill( pbx_t *pbx )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t hld;
+
+	assert(!port_isr_inside());
+	assert(pbx);
+
+	sys_lock();
+	{
+		pbx->count = 0;
+		pbx->used  = 0;
+
+		core_all_detach(pbx, &hld);
+	}
+	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
+}
+
+/* -------------------------------------------------------------------------- */
+void pbx_delete( pbx_t *pbx )
+/* -------------------------------------------------------------------------- */
+{
+	pbx_kill(pbx);
+	core_sys_free(pbx->res);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+bool priv_pbx_before( unsigned key1, unsigned key2 )
+/* -------------------------------------------------------------------------- */
+{
+	// higher priority first; with the same priority, lower (wrapped) sequence number first
+	if ((key1 ^ key2) >> 24)
+		return key1 > key2;
+
+	return (int32_t)((key1 - key2) << 8) < 0;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+char *priv_pbx_slot( pbx_t *pbx, unsigned slot )
+/* -------------------------------------------------------------------------- */
+{
+	return (char *)(pbx->data + 2 * pbx->limit) + slot * pbx->size;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_pbx_get( pbx_t *pbx, char *data, unsigned *prio )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned *heap = pbx->data;
+	unsigned  slot = heap[1];
+	unsigned  key, idx;
+	unsigned  i, c, n;
+
+	memcpy(data, priv_pbx_slot(pbx, slot), pbx->size);
+	if (prio) *prio = heap[0] >> 24;
+
+	// move the last entry to the root and sift it down, the released slot goes beyond the heap
+	n   = --pbx->count;
+	key = heap[2 * n];
+	idx = heap[2 * n + 1];
+	heap[2 * n + 1] = slot;
+
+	for (i = 0; (c = 2 * i + 1) < n; i = c)
+	{
+		if (c + 1 < n && priv_pbx_before(heap[2 * c + 2], heap[2 * c]))
+			c++;
+		if (!priv_pbx_before(heap[2 * c], key))
+			break;
+		heap[2 * i]     = heap[2 * c];
+		heap[2 * i + 1] = heap[2 * c + 1];
+	}
+
+	heap[2 * i]     = key;
+	heap[2 * i + 1] = idx;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_pbx_put( pbx_t *pbx, const char *data, unsigned prio )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned *heap = pbx->data;
+	unsigned  key  = PBX_KEY(prio, pbx->seq++);
+	unsigned  slot;
+	unsigned  i, p;
+
+	// free slots are stored beyond the heap, slots never used so far are taken in order
+	i = pbx->count++;
+	slot = (i < pbx->used) ? heap[2 * i + 1] : pbx->used++;
+
+	memcpy(priv_pbx_slot(pbx, slot), data, pbx->size);
+
+	for (; i > 0; i = p)
+	{
+		p = (i - 1) / 2;
+		if (!priv_pbx_before(key, heap[2 * p]))
+			break;
+		heap[2 * i]     = heap[2 * p];
+		heap[2 * i + 1] = heap[2 * p + 1];
+	}
+
+	heap[2 * i]     = key;
+	heap[2 * i + 1] = slot;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_pbx_getUpdate( pbx_t *pbx, char *data, unsigned *prio )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+
+	priv_pbx_get(pbx, data, prio);
+	tsk = core_one_wakeup(pbx, E_SUCCESS);
+	if (tsk) priv_pbx_put(pbx, tsk->tmp.pbx.data.out, tsk->tmp.pbx.prio);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_pbx_putUpdate( pbx_t *pbx, const char *data, unsigned prio )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+
+	priv_pbx_put(pbx, data, prio);
+	tsk = core_one_wakeup(pbx, E_SUCCESS);
+	if (tsk) priv_pbx_get(pbx, tsk->tmp.pbx.data.in, &tsk->tmp.pbx.prio);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pbx_take( pbx_t *pbx, void *data, unsigned *prio )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(pbx);
+	assert(data);
+
+	sys_lock();
+	{
+		if (pbx->count > 0)
+		{
+			priv_pbx_getUpdate(pbx, data, prio);
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_pbx_wait( pbx_t *pbx, void *data, unsigned *prio, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(pbx);
+	assert(data);
+
+	sys_lock();
+	{
+		if (pbx->count > 0)
+		{
+			priv_pbx_getUpdate(pbx, data, prio);
+			event = E_SUCCESS;
+		}
+		else
+		{
+			System.cur->tmp.pbx.data.in = data;
+			event = wait(pbx, time);
+			if (event == E_SUCCESS && prio)
+				*prio = System.cur->tmp.pbx.prio;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pbx_waitFor( pbx_t *pbx, void *data, unsigned *prio, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_pbx_wait(pbx, data, prio, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pbx_waitUntil( pbx_t *pbx, void *data, unsigned *prio, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_pbx_wait(pbx, data, prio, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pbx_give( pbx_t *pbx, const void *data, unsigned prio )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(pbx);
+	assert(data);
+	assert(prio <= 0xFF);
+
+	sys_lock();
+	{
+		if (pbx->count < pbx->limit)
+		{
+			priv_pbx_putUpdate(pbx, data, prio);
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_pbx_send( pbx_t *pbx, const void *data, unsigned prio, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(pbx);
+	assert(data);
+	assert(prio <= 0xFF);
+
+	sys_lock();
+	{
+		if (pbx->count < pbx->limit)
+		{
+			priv_pbx_putUpdate(pbx, data, prio);
+			event = E_SUCCESS;
+		}
+		else
+		{
+			System.cur->tmp.pbx.data.out = data;
+			System.cur->tmp.pbx.prio = prio;
+			event = wait(pbx, time);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pbx_sendFor( pbx_t *pbx, const void *data, unsigned prio, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_pbx_send(pbx, data, prio, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pbx_sendUntil( pbx_t *pbx, const void *data, unsigned prio, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_pbx_send(pbx, data, prio, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pbx_count( pbx_t *pbx )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(pbx);
+
+	sys_lock();
+	{
+		cnt = pbx->count;
+	}
+	sys_unlock();
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned pbx_space( pbx_t *pbx )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(pbx);
+
+	sys_lock();
+	{
+		cnt = pbx->limit - pbx->count;
+	}
+	sys_unlock();
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,102 @@
+/******************************************************************************
+
+    @file    StateOS: osrcu.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+
+#include "inc/osrcu.h"
+#include "inc/oscriticalsection.h"
+
+#if OS_RCU_SIZE
+
+static void   * Retired[OS_RCU_SIZE];   // blocks waiting for the end of read-side sections
+static unsigned RetiredCount = 0;
+
+/* -------------------------------------------------------------------------- */
+unsigned rcu_retire( void *ptr )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(!port_isr_inside());
+
+	if (ptr == 0)
+		return E_SUCCESS;
+
+	sys_lock();
+	{
+		if (RetiredCount < OS_RCU_SIZE)
+		{
+			Retired[RetiredCount++] = ptr;
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+bool priv_rcu_quiescent( void )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+
+	// no blocked task is inside a read-side section (checked by assertion in the kernel),
+	// so only the tasks ready to run (of the idle priority) have to be checked
+	for (tsk = IDLE.obj.next; tsk != &IDLE; tsk = tsk->obj.next)
+		if (tsk->rcu > 0)
+			return false;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+void core_rcu_reclaim( void )
+/* -------------------------------------------------------------------------- */
+{
+	void *ptr;
+
+	for (;;)
+	{
+		sys_lock();
+		{
+			ptr = RetiredCount > 0 && priv_rcu_quiescent() ? Retired[--RetiredCount] : 0;
+		}
+		sys_unlock();
+
+		if (ptr == 0)
+			break;
+
+		core_sys_free(ptr);
+	}
+}
+
+#endif//OS_RCU_SIZE
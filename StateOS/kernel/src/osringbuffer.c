@@ -0,0 +1,239 @@
+/******************************************************************************
+
+    @file    StateOS: osringbuffer.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osringbuffer.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void rng_init( rng_t *rng, unsigned limit, void *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(rng);
+	assert(limit && (limit & (limit - 1)) == 0);
+	assert(data);
+
+	sys_lock();
+	{
+		memset(rng, 0, sizeof(rng_t));
+
+		rng->mask = limit - 1;
+		rng->data = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+rng_t *rng_create( unsigned limit )
+/* -------------------------------------------------------------------------- */
+{
+	rng_t *rng;
+
+	assert(!port_isr_inside());
+	assert(limit && (limit & (limit - 1)) == 0);
+
+	sys_lock();
+	{
+		rng = core_sys_alloc(ABOVE(sizeof(rng_t)) + limit);
+		rng_init(rng, limit, (void *)((size_t)rng + ABOVE(sizeof(rng_t))));
+		rng->res = rng;
+	}
+	sys_unlock();
+
+	return rng;
+}
+
+/* -------------------------------------------------------------------------- */
+void rng_kill( rng_t *rng )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t hld;
+
+	assert(!port_isr_inside());
+	assert(rng);
+
+	sys_lock();
+	{
+		rng->head = rng->tail = 0;
+
+		core_all_detach(rng, &hld);
+	}
+	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
+}
+
+/* -------------------------------------------------------------------------- */
+void rng_delete( rng_t *rng )
+/* -------------------------------------------------------------------------- */
+{
+	rng_kill(rng);
+	core_sys_free(rng->res);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_rng_get( rng_t *rng, char *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned head = rng->head;
+	unsigned cnt  = rng->tail - head;
+	unsigned idx  = head & rng->mask;
+	unsigned len;
+
+	if (size > cnt)
+		size = cnt;
+
+	if (size > 0)
+	{
+		port_mem_barrier(); // data written by the producer is visible
+
+		len = rng->mask + 1 - idx;
+		if (len > size)
+			len = size;
+		memcpy(data, rng->data + idx, len);
+		memcpy(data + len, rng->data, size - len);
+
+		port_mem_barrier(); // data is read before the space is released
+		rng->head = head + size;
+	}
+
+	return size;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_rng_put( rng_t *rng, const char *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned tail = rng->tail;
+	unsigned cnt  = rng->mask + 1 - (tail - rng->head);
+	unsigned idx  = tail & rng->mask;
+	unsigned len;
+
+	if (size > cnt)
+		size = cnt;
+
+	if (size > 0)
+	{
+		port_mem_barrier(); // the space released by the consumer is not read anymore
+
+		len = rng->mask + 1 - idx;
+		if (len > size)
+			len = size;
+		memcpy(rng->data + idx, data, len);
+		memcpy(rng->data, data + len, size - len);
+
+		port_mem_barrier(); // data is written before it is published
+		rng->tail = tail + size;
+	}
+
+	return size;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_rng_wait( rng_t *rng, char *data, unsigned size, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len;
+
+	assert(!port_isr_inside());
+	assert(rng);
+	assert(data);
+	assert(size);
+
+	len = priv_rng_get(rng, data, size);
+
+	if (len == 0)
+	{
+		sys_lock();
+		{
+			// the producer can't publish data between the check and the start of the wait
+			len = priv_rng_get(rng, data, size);
+
+			if (len == 0 && wait(rng, time) == E_SUCCESS)
+				len = priv_rng_get(rng, data, size);
+		}
+		sys_unlock();
+	}
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rng_waitFor( rng_t *rng, void *data, unsigned size, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_rng_wait(rng, data, size, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rng_waitUntil( rng_t *rng, void *data, unsigned size, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_rng_wait(rng, data, size, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rng_take( rng_t *rng, void *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(rng);
+	assert(data);
+
+	return priv_rng_get(rng, data, size);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rng_give( rng_t *rng, const void *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len;
+
+	assert(rng);
+	assert(data);
+
+	len = priv_rng_put(rng, data, size);
+
+	if (len > 0 && rng->queue)
+	{
+		sys_lock();
+		{
+			core_one_wakeup(rng, E_SUCCESS);
+		}
+		sys_unlock();
+	}
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,304 @@
+/******************************************************************************
+
+    @file    StateOS: osrwlock.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osrwlock.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+void rwl_init( rwl_t *rwl )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(rwl);
+
+	sys_lock();
+	{
+		memset(rwl, 0, sizeof(rwl_t));
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+rwl_t *rwl_create( void )
+/* -------------------------------------------------------------------------- */
+{
+	rwl_t *rwl;
+
+	assert(!port_isr_inside());
+
+	sys_lock();
+	{
+		rwl = core_sys_alloc(sizeof(rwl_t));
+		rwl_init(rwl);
+		rwl->res = rwl;
+	}
+	sys_unlock();
+
+	return rwl;
+}
+
+/* -------------------------------------------------------------------------- */
+void rwl_kill( rwl_t *rwl )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t hld[2];
+
+	assert(!port_isr_inside());
+	assert(rwl);
+
+	sys_lock();
+	{
+		rwl->owner = 0;
+		rwl->count = 0;
+
+		core_all_detach(rwl, &hld[0]);
+		core_all_detach(&rwl->write, &hld[1]);
+	}
+	sys_unlock();
+
+	core_all_release(&hld[0], E_STOPPED);
+	core_all_release(&hld[1], E_STOPPED);
+}
+
+/* -------------------------------------------------------------------------- */
+void rwl_delete( rwl_t *rwl )
+/* -------------------------------------------------------------------------- */
+{
+	rwl_kill(rwl);
+	core_sys_free(rwl->res);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_rwl_readWakeup( rwl_t *rwl )
+/* -------------------------------------------------------------------------- */
+{
+	while (rwl->queue)
+	{
+		core_one_wakeup(rwl, E_SUCCESS);
+		rwl->count++;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_rwl_takeRead( rwl_t *rwl )
+/* -------------------------------------------------------------------------- */
+{
+	if (rwl->owner || rwl->write) // writer preference
+		return E_TIMEOUT;
+
+	rwl->count++;
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rwl_takeRead( rwl_t *rwl )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(rwl);
+
+	sys_lock();
+	{
+		event = priv_rwl_takeRead(rwl);
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_rwl_waitRead( rwl_t *rwl, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(rwl);
+
+	sys_lock();
+	{
+		event = priv_rwl_takeRead(rwl);
+
+		if (event != E_SUCCESS)
+			event = wait(rwl, time); // the lock is passed by the releasing task
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rwl_waitReadFor( rwl_t *rwl, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_rwl_waitRead(rwl, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rwl_waitReadUntil( rwl_t *rwl, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_rwl_waitRead(rwl, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rwl_giveRead( rwl_t *rwl )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(!port_isr_inside());
+	assert(rwl);
+
+	sys_lock();
+	{
+		if (rwl->count > 0)
+		{
+			if (--rwl->count == 0)
+			{
+				rwl->owner = core_one_wakeup(&rwl->write, E_SUCCESS);
+				if (rwl->owner == 0)
+					priv_rwl_readWakeup(rwl); // readers held back by a writer killed while waiting
+			}
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_rwl_takeWrite( rwl_t *rwl )
+/* -------------------------------------------------------------------------- */
+{
+	if (rwl->owner || rwl->count)
+		return E_TIMEOUT;
+
+	rwl->owner = System.cur;
+	return E_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rwl_takeWrite( rwl_t *rwl )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(rwl);
+
+	sys_lock();
+	{
+		event = priv_rwl_takeWrite(rwl);
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_rwl_waitWrite( rwl_t *rwl, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(rwl);
+	assert(rwl->owner != System.cur);
+
+	sys_lock();
+	{
+		event = priv_rwl_takeWrite(rwl);
+
+		if (event != E_SUCCESS)
+		{
+			event = wait(&rwl->write, time); // the lock is passed by the releasing task
+
+			if (event != E_SUCCESS && rwl->owner == 0 && rwl->write == 0)
+				priv_rwl_readWakeup(rwl); // readers held back by this writer
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rwl_waitWriteFor( rwl_t *rwl, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_rwl_waitWrite(rwl, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rwl_waitWriteUntil( rwl_t *rwl, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_rwl_waitWrite(rwl, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned rwl_giveWrite( rwl_t *rwl )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(!port_isr_inside());
+	assert(rwl);
+
+	sys_lock();
+	{
+		if (rwl->owner == System.cur)
+		{
+			rwl->owner = 0;
+
+			if (rwl->queue)
+				priv_rwl_readWakeup(rwl); // waiting readers get the lock in one batch
+			else
+				rwl->owner = core_one_wakeup(&rwl->write, E_SUCCESS);
+
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,215 @@
+/******************************************************************************
+
+    @file    StateOS: osselect.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osselect.h"
+#include "inc/oscriticalsection.h"
+
+#if OS_SELECT
+
+/* -------------------------------------------------------------------------- */
+
+static sel_t *Select = 0; // list of the wait-sets watching any objects
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_sel_unlink( sel_t *sel )
+/* -------------------------------------------------------------------------- */
+{
+	sel_t **ptr = &Select;
+
+	while (*ptr)
+	{
+		if (*ptr == sel)
+		{
+			*ptr = sel->next;
+			break;
+		}
+		ptr = &(*ptr)->next;
+	}
+
+	sel->next  = 0;
+	sel->flags = 0;
+	sel->count = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+void core_sel_notify( void *obj )
+/* -------------------------------------------------------------------------- */
+{
+	sel_t *sel;
+	unsigned i;
+
+	for (sel = Select; sel; sel = sel->next)
+	{
+		for (i = 0; i < sel->count; i++)
+		{
+			if (sel->obj[i] == obj)
+			{
+				if (core_one_wakeup(sel, i) == 0)
+					sel->flags |= 1U << i;
+			}
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+void sel_init( sel_t *sel )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(sel);
+
+	sys_lock();
+	{
+		memset(sel, 0, sizeof(sel_t));
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+sel_t *sel_create( void )
+/* -------------------------------------------------------------------------- */
+{
+	sel_t *sel;
+
+	assert(!port_isr_inside());
+
+	sys_lock();
+	{
+		sel = core_sys_alloc(sizeof(sel_t));
+		sel_init(sel);
+		sel->res = sel;
+	}
+	sys_unlock();
+
+	return sel;
+}
+
+/* -------------------------------------------------------------------------- */
+void sel_kill( sel_t *sel )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t hld;
+
+	assert(!port_isr_inside());
+	assert(sel);
+
+	sys_lock();
+	{
+		if (sel->count > 0)
+			priv_sel_unlink(sel);
+		core_all_detach(sel, &hld);
+	}
+	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
+}
+
+/* -------------------------------------------------------------------------- */
+void sel_delete( sel_t *sel )
+/* -------------------------------------------------------------------------- */
+{
+	sel_kill(sel);
+	core_sys_free(sel->res);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned sel_add( sel_t *sel, const void *obj )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned idx;
+
+	assert(!port_isr_inside());
+	assert(sel);
+	assert(obj);
+	assert(sel->count < OS_SELECT);
+
+	sys_lock();
+	{
+		if (sel->count == 0)
+		{
+			sel->next = Select;
+			Select = sel;
+		}
+
+		idx = sel->count++;
+		sel->obj[idx] = (void *) obj;
+		sel->flags |= 1U << idx;
+	}
+	sys_unlock();
+
+	return idx;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_sel_wait( sel_t *sel, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(sel);
+
+	sys_lock();
+	{
+		if (sel->flags)
+		{
+			event = port_get_msb(sel->flags & -sel->flags);
+			sel->flags &= ~(1U << event);
+		}
+		else
+		{
+			event = wait(sel, time);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned sel_waitFor( sel_t *sel, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_sel_wait(sel, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned sel_waitUntil( sel_t *sel, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_sel_wait(sel, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+
+#endif//OS_SELECT
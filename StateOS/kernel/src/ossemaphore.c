@@ -30,6 +30,7 @@
  ******************************************************************************/
 
 #include "inc/ossemaphore.h"
+#include "inc/ostask.h"
 #include "inc/oscriticalsection.h"
 
 /* -------------------------------------------------------------------------- */
@@ -42,6 +43,9 @@ void sem_init( sem_t *sem, unsigned init, unsigned limit )
 
 	sys_lock();
 	{
+#if OS_OBJ_STATS
+		core_ost_remove(&sem->ost);
+#endif
 		memset(sem, 0, sizeof(sem_t));
 
 		sem->count = init;
@@ -73,6 +77,8 @@ sem_t *sem_create( unsigned init, unsigned limit )
 void sem_kill( sem_t *sem )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(sem);
 
@@ -80,21 +86,102 @@ void sem_kill( sem_t *sem )
 	{
 		sem->count = 0;
 
-		core_all_wakeup(sem, E_STOPPED);
+		core_all_detach(sem, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void sem_delete( sem_t *sem )
 /* -------------------------------------------------------------------------- */
 {
+	sem_kill(sem);
+#if OS_OBJ_STATS
 	sys_lock();
 	{
-		sem_kill(sem);
-		core_sys_free(sem->res);
+		core_ost_remove(&sem->ost);
 	}
 	sys_unlock();
+#endif
+	core_sys_free(sem->res);
+}
+
+#if OS_SEM_LOCKFREE
+
+/* -------------------------------------------------------------------------- */
+static
+bool priv_sem_tryTake( sem_t *sem )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt = sem->count;
+
+	return cnt > 0 && port_atomic_cas32_idle((volatile uint32_t *)&sem->count, cnt, cnt - 1, (void * volatile *)&sem->queue);
+}
+
+#if OS_SELECT == 0
+
+/* -------------------------------------------------------------------------- */
+static
+bool priv_sem_tryGive( sem_t *sem )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt = sem->count;
+
+	return cnt < sem->limit && port_atomic_cas32_idle((volatile uint32_t *)&sem->count, cnt, cnt + 1, (void * volatile *)&sem->queue);
+}
+
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+static
+bool priv_sem_take( sem_t *sem, unsigned num )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk = sem->queue;
+
+	if (sem->count < num || (tsk && tsk->tmp.sem.num > 0))
+		return false;
+
+	while (num > 0 && core_one_wakeup(sem, E_SUCCESS))
+		num--;
+	sem->count -= num;
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+bool priv_sem_give( sem_t *sem, unsigned num )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+	unsigned cnt;
+
+	if (num > sem->limit - sem->count)
+		return false;
+
+	cnt = sem->count + num;
+	while ((tsk = sem->queue) != 0 && tsk->tmp.sem.num > 0 && tsk->tmp.sem.num <= cnt)
+	{
+		cnt -= tsk->tmp.sem.num;
+		core_tsk_wakeup(tsk, E_SUCCESS);
+	}
+
+	if (cnt > sem->count)
+	{
+		sem->count = cnt;
+		core_sel_notify(sem);
+	}
+	else
+	{
+		sem->count = cnt;
+	}
+
+	return true;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -106,12 +193,16 @@ unsigned sem_take( sem_t *sem )
 	assert(sem);
 	assert(sem->limit);
 
+#if OS_SEM_LOCKFREE && OS_OBJ_STATS == 0
+	if (priv_sem_tryTake(sem))
+		return E_SUCCESS;
+#endif
+
 	sys_lock();
 	{
-		if (sem->count > 0)
+		if (priv_sem_take(sem, 1))
 		{
-			if (core_one_wakeup(sem, E_SUCCESS) == 0)
-				sem->count--;
+			core_stat_take(sem, false);
 			event = E_SUCCESS;
 		}
 	}
@@ -122,7 +213,7 @@ unsigned sem_take( sem_t *sem )
 
 /* -------------------------------------------------------------------------- */
 static
-unsigned priv_sem_wait( sem_t *sem, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+unsigned priv_sem_wait( sem_t *sem, unsigned num, cnt_t time, unsigned(*wait)(void*,cnt_t) )
 /* -------------------------------------------------------------------------- */
 {
 	unsigned event;
@@ -130,18 +221,28 @@ unsigned priv_sem_wait( sem_t *sem, cnt_t time, unsigned(*wait)(void*,cnt_t) )
 	assert(!port_isr_inside());
 	assert(sem);
 	assert(sem->limit);
+	assert(num > 0 && num <= sem->limit);
+
+#if OS_SEM_LOCKFREE && OS_OBJ_STATS == 0
+	if (num == 1 && priv_sem_tryTake(sem))
+		return E_SUCCESS;
+#endif
 
 	sys_lock();
 	{
-		if (sem->count > 0)
+		if (priv_sem_take(sem, num))
 		{
-			if (core_one_wakeup(sem, E_SUCCESS) == 0)
-				sem->count--;
+			core_stat_take(sem, false);
 			event = E_SUCCESS;
 		}
 		else
 		{
-			event = wait(sem, time);
+			System.cur->tmp.sem.num = num;
+			event = core_stat_wait(sem, time, wait);
+			if (event == E_SUCCESS)
+				core_stat_take(sem, true);
+			else
+				priv_sem_give(sem, 0); // the next waiting task can be satisfied now
 		}
 	}
 	sys_unlock();
@@ -153,14 +254,41 @@ unsigned priv_sem_wait( sem_t *sem, cnt_t time, unsigned(*wait)(void*,cnt_t) )
 unsigned sem_waitFor( sem_t *sem, cnt_t delay )
 /* -------------------------------------------------------------------------- */
 {
-	return priv_sem_wait(sem, delay, core_tsk_waitFor);
+	return priv_sem_wait(sem, 1, delay, core_tsk_waitFor);
 }
 
 /* -------------------------------------------------------------------------- */
 unsigned sem_waitUntil( sem_t *sem, cnt_t time )
 /* -------------------------------------------------------------------------- */
 {
-	return priv_sem_wait(sem, time, core_tsk_waitUntil);
+	return priv_sem_wait(sem, 1, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned sem_takeN( sem_t *sem, unsigned num, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	if (delay == IMMEDIATE)
+	{
+		unsigned event = E_TIMEOUT;
+
+		assert(sem);
+		assert(num > 0 && num <= sem->limit);
+
+		sys_lock();
+		{
+			if (priv_sem_take(sem, num))
+			{
+				core_stat_take(sem, false);
+				event = E_SUCCESS;
+			}
+		}
+		sys_unlock();
+
+		return event;
+	}
+
+	return priv_sem_wait(sem, num, delay, core_tsk_waitFor);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -172,14 +300,34 @@ unsigned sem_give( sem_t *sem )
 	assert(sem);
 	assert(sem->limit);
 
+#if OS_SEM_LOCKFREE && OS_SELECT == 0
+	if (priv_sem_tryGive(sem))
+		return E_SUCCESS;
+#endif
+
+	sys_lock();
+	{
+		if (priv_sem_give(sem, 1))
+			event = E_SUCCESS;
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned sem_giveN( sem_t *sem, unsigned num )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(sem);
+	assert(sem->limit);
+
 	sys_lock();
 	{
-		if (sem->count < sem->limit)
-		{
-			if (core_one_wakeup(sem, E_SUCCESS) == 0)
-				sem->count++;
+		if (priv_sem_give(sem, num))
 			event = E_SUCCESS;
-		}
 	}
 	sys_unlock();
 
@@ -197,17 +345,21 @@ unsigned priv_sem_send( sem_t *sem, cnt_t time, unsigned(*wait)(void*,cnt_t) )
 	assert(sem);
 	assert(sem->limit);
 
+#if OS_SEM_LOCKFREE && OS_SELECT == 0
+	if (priv_sem_tryGive(sem))
+		return E_SUCCESS;
+#endif
+
 	sys_lock();
 	{
-		if (sem->count < sem->limit)
+		if (priv_sem_give(sem, 1))
 		{
-			if (core_one_wakeup(sem, E_SUCCESS) == 0)
-				sem->count++;
 			event = E_SUCCESS;
 		}
 		else
 		{
-			event = wait(sem, time);
+			System.cur->tmp.sem.num = 0;
+			event = core_stat_wait(sem, time, wait);
 		}
 	}
 	sys_unlock();
@@ -71,6 +71,8 @@ sig_t *sig_create( unsigned type )
 void sig_kill( sig_t *sig )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(sig);
 
@@ -78,21 +80,19 @@ void sig_kill( sig_t *sig )
 	{
 		sig->flag = 0;
 
-		core_all_wakeup(sig, E_STOPPED);
+		core_all_detach(sig, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void sig_delete( sig_t *sig )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
-	{
-		sig_kill(sig);
-		core_sys_free(sig->res);
-	}
-	sys_unlock();
+	sig_kill(sig);
+	core_sys_free(sig->res);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -166,18 +166,33 @@ void sig_give( sig_t *sig )
 	assert(sig);
 	assert((sig->type & ~sigMASK) == 0U);
 
+#if OS_SIG_LOCKFREE && OS_SELECT == 0
+	sig->flag = 1;
+	port_mem_barrier();
+	if (*(tsk_t * volatile *)&sig->queue == 0)
+		return;
+	// a task is waiting: the signal could have been taken in the meantime, so it is not set again
+#endif
+
 	sys_lock();
 	{
+#if OS_SIG_LOCKFREE == 0 || OS_SELECT
 		sig->flag = 1;
-
-		if (sig->type == sigClear)
-		{
-			if (core_one_wakeup(sig, E_SUCCESS))
-			sig->flag = 0;
-		}
-		else
+#endif
+		if (sig->flag)
 		{
-			core_all_wakeup(sig, E_SUCCESS);
+			if (sig->type == sigClear)
+			{
+				if (core_one_wakeup(sig, E_SUCCESS))
+				sig->flag = 0;
+			}
+			else
+			{
+				core_all_wakeup(sig, E_SUCCESS);
+			}
+
+			if (sig->flag)
+				core_sel_notify(sig);
 		}
 	}
 	sys_unlock();
@@ -76,6 +76,8 @@ stm_t *stm_create( unsigned limit )
 void stm_kill( stm_t *stm )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(stm);
 
@@ -85,21 +87,19 @@ void stm_kill( stm_t *stm )
 		stm->head  = 0;
 		stm->tail  = 0;
 
-		core_all_wakeup(stm, E_STOPPED);
+		core_all_detach(stm, &hld);
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void stm_delete( stm_t *stm )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
-	{
-		stm_kill(stm);
-		core_sys_free(stm->res);
-	}
-	sys_unlock();
+	stm_kill(stm);
+	core_sys_free(stm->res);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -115,7 +115,7 @@ static
 unsigned priv_stm_space( stm_t *stm )
 /* -------------------------------------------------------------------------- */
 {
-	return (stm->count == 0 || stm->queue == 0) ? stm->limit - stm->count : 0;
+	return (stm->count == 0 || stm->queue == 0 || stm->queue->tmp.stm.min > 0) ? stm->limit - stm->count : 0;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -132,14 +132,20 @@ void priv_stm_get( stm_t *stm, char *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
 	unsigned i = stm->head;
+	unsigned n = stm->limit - i;
 
 	stm->count -= size;
-	while (size--)
+	if (size < n)
+	{
+		memcpy(data, &stm->data[i], size);
+		stm->head = i + size;
+	}
+	else
 	{
-		*data++ = stm->data[i++];
-		if (i >= stm->limit) i = 0;
+		memcpy(data, &stm->data[i], n);
+		memcpy(data + n, stm->data, size - n);
+		stm->head = size - n;
 	}
-	stm->head = i;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -148,14 +154,20 @@ void priv_stm_put( stm_t *stm, const char *data, unsigned size )
 /* -------------------------------------------------------------------------- */
 {
 	unsigned i = stm->tail;
+	unsigned n = stm->limit - i;
 
 	stm->count += size;
-	while (size--)
+	if (size < n)
 	{
-		stm->data[i++] = *data++;
-		if (i >= stm->limit) i = 0;
+		memcpy(&stm->data[i], data, size);
+		stm->tail = i + size;
+	}
+	else
+	{
+		memcpy(&stm->data[i], data, n);
+		memcpy(stm->data, data + n, size - n);
+		stm->tail = size - n;
 	}
-	stm->tail = i;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -170,34 +182,29 @@ void priv_stm_skip( stm_t *stm, unsigned size )
 
 /* -------------------------------------------------------------------------- */
 static
-unsigned priv_stm_getUpdate( stm_t *stm, char *data, unsigned size )
+void priv_stm_getWakeup( stm_t *stm )
 /* -------------------------------------------------------------------------- */
 {
-	if (size > stm->count)
-		size = stm->count;
-	priv_stm_get(stm, data, size);
-
-	while (stm->queue != 0 && stm->queue->tmp.stm.size <= priv_stm_space(stm))
+	while (stm->queue != 0 && stm->queue->tmp.stm.min == 0 && stm->queue->tmp.stm.size <= priv_stm_space(stm))
 	{
 		priv_stm_put(stm, stm->queue->tmp.stm.data.out, stm->queue->tmp.stm.size);
 		stm->queue->tmp.stm.size = 0;
 		core_tsk_wakeup(stm->queue, E_SUCCESS);
 	}
-
-	return size;
 }
 
 /* -------------------------------------------------------------------------- */
 static
-void priv_stm_putUpdate( stm_t *stm, const char *data, unsigned size )
+void priv_stm_readWakeup( stm_t *stm, bool flush )
 /* -------------------------------------------------------------------------- */
 {
-	assert(size <= priv_stm_space(stm));
-
-	priv_stm_put(stm, data, size);
+	unsigned size;
 
-	while (stm->queue != 0 && (size = priv_stm_count(stm)) > 0)
+	while (stm->queue != 0 && stm->queue->tmp.stm.min > 0 && (size = priv_stm_count(stm)) > 0)
 	{
+		if (size < stm->queue->tmp.stm.min && !flush)
+			break;
+
 		if (size > stm->queue->tmp.stm.size)
 			size = stm->queue->tmp.stm.size;
 
@@ -207,6 +214,62 @@ void priv_stm_putUpdate( stm_t *stm, const char *data, unsigned size )
 	}
 }
 
+/* -------------------------------------------------------------------------- */
+static
+void priv_stm_putWakeup( stm_t *stm )
+/* -------------------------------------------------------------------------- */
+{
+	priv_stm_readWakeup(stm, false);
+
+	if (priv_stm_count(stm) > 0)
+		core_sel_notify(stm);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_stm_getUpdate( stm_t *stm, char *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	if (size > stm->count)
+		size = stm->count;
+	priv_stm_get(stm, data, size);
+	priv_stm_getWakeup(stm);
+
+	return size;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_stm_putUpdate( stm_t *stm, const char *data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(size <= priv_stm_space(stm));
+
+	priv_stm_put(stm, data, size);
+	priv_stm_putWakeup(stm);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_stm_reserved( stm_t *stm )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned size = stm->limit - stm->tail;
+	unsigned free = priv_stm_space(stm);
+
+	return (size < free) ? size : free;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_stm_peeked( stm_t *stm )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned size = stm->limit - stm->head;
+
+	return (size < stm->count) ? size : stm->count;
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned stm_take( stm_t *stm, void *data, unsigned size )
 /* -------------------------------------------------------------------------- */
@@ -231,10 +294,11 @@ unsigned stm_take( stm_t *stm, void *data, unsigned size )
 
 /* -------------------------------------------------------------------------- */
 static
-unsigned priv_stm_wait( stm_t *stm, char *data, unsigned size, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+unsigned priv_stm_wait( stm_t *stm, char *data, unsigned min, unsigned size, cnt_t time, unsigned(*wait)(void*,cnt_t) )
 /* -------------------------------------------------------------------------- */
 {
 	unsigned len = 0;
+	unsigned event;
 
 	assert(!port_isr_inside());
 	assert(stm);
@@ -242,7 +306,14 @@ unsigned priv_stm_wait( stm_t *stm, char *data, unsigned size, cnt_t time, unsig
 
 	sys_lock();
 	{
-		if (stm->count > 0)
+		if (min > size)
+			min = size;
+		if (min > priv_stm_limit(stm))
+			min = priv_stm_limit(stm);
+		if (min == 0)
+			min = 1;
+
+		if (stm->count >= min || (stm->count > 0 && stm->queue != 0 && stm->queue->tmp.stm.min == 0))
 		{
 			if (size > 0)
 				len = priv_stm_getUpdate(stm, data, size);
@@ -252,8 +323,11 @@ unsigned priv_stm_wait( stm_t *stm, char *data, unsigned size, cnt_t time, unsig
 		{
 			System.cur->tmp.stm.data.in = data;
 			System.cur->tmp.stm.size = size;
-			wait(stm, time);
+			System.cur->tmp.stm.min = min;
+			event = wait(stm, time);
 			len = size - System.cur->tmp.stm.size;
+			if (event == E_TIMEOUT && stm->count > 0)
+				len = priv_stm_getUpdate(stm, data, size);
 		}
 	}
 	sys_unlock();
@@ -265,14 +339,41 @@ unsigned priv_stm_wait( stm_t *stm, char *data, unsigned size, cnt_t time, unsig
 unsigned stm_waitFor( stm_t *stm, void *data, unsigned size, cnt_t delay )
 /* -------------------------------------------------------------------------- */
 {
-	return priv_stm_wait(stm, data, size, delay, core_tsk_waitFor);
+	return priv_stm_wait(stm, data, stm->level, size, delay, core_tsk_waitFor);
 }
 
 /* -------------------------------------------------------------------------- */
 unsigned stm_waitUntil( stm_t *stm, void *data, unsigned size, cnt_t time )
 /* -------------------------------------------------------------------------- */
 {
-	return priv_stm_wait(stm, data, size, time, core_tsk_waitUntil);
+	return priv_stm_wait(stm, data, stm->level, size, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stm_waitMin( stm_t *stm, void *data, unsigned min, unsigned max, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_stm_wait(stm, data, min, max, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stm_waitMinUntil( stm_t *stm, void *data, unsigned min, unsigned max, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_stm_wait(stm, data, min, max, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+void stm_setTrigger( stm_t *stm, unsigned level )
+/* -------------------------------------------------------------------------- */
+{
+	assert(stm);
+
+	sys_lock();
+	{
+		stm->level = level;
+	}
+	sys_unlock();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -284,10 +385,16 @@ unsigned stm_give( stm_t *stm, const void *data, unsigned size )
 	assert(stm);
 	assert(data);
 
+	if (stm->over)
+		return stm_push(stm, data, size);
+
 	sys_lock();
 	{
 		if (size > 0)
 		{
+			if (size > priv_stm_space(stm))
+				priv_stm_readWakeup(stm, true);
+
 			if (size <= priv_stm_space(stm))
 				priv_stm_putUpdate(stm, data, len = size);
 		}
@@ -308,10 +415,16 @@ unsigned priv_stm_send( stm_t *stm, const char *data, unsigned size, cnt_t time,
 	assert(stm);
 	assert(data);
 
+	if (stm->over)
+		return stm_push(stm, data, size);
+
 	sys_lock();
 	{
 		if (size > 0)
 		{
+			if (size > priv_stm_space(stm))
+				priv_stm_readWakeup(stm, true); // readers waiting for the trigger level get the data available
+
 			if (size <= priv_stm_space(stm))
 				priv_stm_putUpdate(stm, data, len = size);
 			else
@@ -319,6 +432,7 @@ unsigned priv_stm_send( stm_t *stm, const char *data, unsigned size, cnt_t time,
 			{
 				System.cur->tmp.stm.data.out = data;
 				System.cur->tmp.stm.size = size;
+				System.cur->tmp.stm.min = 0;
 				wait(stm, time);
 				len = size - System.cur->tmp.stm.size;
 			}
@@ -354,10 +468,13 @@ unsigned stm_push( stm_t *stm, const void *data, unsigned size )
 
 	sys_lock();
 	{
-		if ((stm->count == 0 || stm->queue == 0) && size > 0 && size <= priv_stm_limit(stm))
+		if ((stm->count == 0 || stm->queue == 0 || stm->queue->tmp.stm.min > 0) && size > 0 && size <= priv_stm_limit(stm))
 		{
 			if (size > priv_stm_space(stm))
+			{
+				stm->drop += size - priv_stm_space(stm);
 				priv_stm_skip(stm, size - priv_stm_space(stm));
+			}
 			priv_stm_putUpdate(stm, data, len = size);
 		}
 	}
@@ -366,6 +483,222 @@ unsigned stm_push( stm_t *stm, const void *data, unsigned size )
 	return len;
 }
 
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_stm_splice( stm_t *stm, stm_t *src, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned i = src->head;
+	unsigned n = src->limit - i;
+
+	if (size > src->count)
+		size = src->count;
+	if (size > priv_stm_space(stm))
+		size = priv_stm_space(stm);
+
+	if (size > 0)
+	{
+		if (size <= n)
+			priv_stm_put(stm, &src->data[i], size);
+		else
+		{
+			priv_stm_put(stm, &src->data[i], n);
+			priv_stm_put(stm, src->data, size - n);
+		}
+		priv_stm_skip(src, size);
+		priv_stm_getWakeup(src);
+		priv_stm_putWakeup(stm);
+	}
+
+	return size;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stm_splice( stm_t *stm, stm_t *src, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len;
+
+	assert(stm);
+	assert(src);
+	assert(stm != src);
+
+	sys_lock();
+	{
+		len = priv_stm_splice(stm, src, size);
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_stm_spliceWait( stm_t *stm, stm_t *src, unsigned size, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len = 0;
+	unsigned min;
+	char     tmp;
+
+	assert(!port_isr_inside());
+	assert(stm);
+	assert(src);
+	assert(stm != src);
+
+	sys_lock();
+	{
+		min = src->level;
+		if (min > size)
+			min = size;
+		if (min > priv_stm_limit(src))
+			min = priv_stm_limit(src);
+		if (min == 0)
+			min = 1;
+
+		if (src->count >= min || (src->count > 0 && src->queue != 0 && src->queue->tmp.stm.min == 0))
+		{
+			len = priv_stm_splice(stm, src, size);
+		}
+		else
+		if (size > 0)
+		{
+			System.cur->tmp.stm.data.in = &tmp; // wait as a reader without a buffer, the data stays in the source
+			System.cur->tmp.stm.size = 0;
+			System.cur->tmp.stm.min = min;
+			wait(src, time);
+			len = priv_stm_splice(stm, src, size);
+		}
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stm_spliceFor( stm_t *stm, stm_t *src, unsigned size, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_stm_spliceWait(stm, src, size, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stm_spliceUntil( stm_t *stm, stm_t *src, unsigned size, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_stm_spliceWait(stm, src, size, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+void stm_setOverwrite( stm_t *stm, bool enable )
+/* -------------------------------------------------------------------------- */
+{
+	assert(stm);
+
+	sys_lock();
+	{
+		stm->over = enable;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stm_dropped( stm_t *stm )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned cnt;
+
+	assert(stm);
+
+	sys_lock();
+	{
+		cnt = stm->drop;
+	}
+	sys_unlock();
+
+	return cnt;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stm_reserve( stm_t *stm, void **data, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len;
+
+	assert(stm);
+	assert(data);
+
+	sys_lock();
+	{
+		len = priv_stm_reserved(stm);
+		if (len > size)
+			len = size;
+		*data = &stm->data[stm->tail];
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+void stm_commit( stm_t *stm, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(stm);
+
+	sys_lock();
+	{
+		assert(size <= priv_stm_reserved(stm));
+
+		if (size > 0)
+		{
+			stm->count += size;
+			stm->tail  += size;
+			if (stm->tail >= stm->limit) stm->tail = 0;
+			priv_stm_putWakeup(stm);
+		}
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stm_peek( stm_t *stm, const void **data )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned len;
+
+	assert(stm);
+	assert(data);
+
+	sys_lock();
+	{
+		len = priv_stm_peeked(stm);
+		*data = &stm->data[stm->head];
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+void stm_consume( stm_t *stm, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(stm);
+
+	sys_lock();
+	{
+		assert(size <= priv_stm_peeked(stm));
+
+		if (size > 0)
+		{
+			priv_stm_skip(stm, size);
+			priv_stm_getWakeup(stm);
+		}
+	}
+	sys_unlock();
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned stm_count( stm_t *stm )
 /* -------------------------------------------------------------------------- */
@@ -29,8 +29,27 @@
 
  ******************************************************************************/
 
+#include "os.h"
 #include "inc/ostask.h"
 #include "inc/oscriticalsection.h"
+#if OS_TASK_REENT
+#include <reent.h>
+#endif
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_tsk_init( tsk_t *tsk, unsigned prio, fun_t *state, void *stack, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	memset(tsk, 0, sizeof(tsk_t));
+
+	tsk->id    = ID_STOPPED;
+	tsk->prio  = prio;
+	tsk->basic = prio;
+	tsk->state = state;
+	tsk->stack = stack;
+	tsk->top   = (stk_t *) LIMITED((char *)stack + size, stk_t);
+}
 
 /* -------------------------------------------------------------------------- */
 void tsk_init( tsk_t *tsk, unsigned prio, fun_t *state, void *stack, unsigned size )
@@ -41,24 +60,139 @@ void tsk_init( tsk_t *tsk, unsigned prio, fun_t *state, void *stack, unsigned si
 	assert(state);
 	assert(stack);
 	assert(size);
+	assert(!OS_COMPACT_TCB || prio <= UINT8_MAX);
 
 	sys_lock();
 	{
-		memset(tsk, 0, sizeof(tsk_t));
-
-		tsk->id    = ID_STOPPED;
-		tsk->prio  = prio;
-		tsk->basic = prio;
-		tsk->state = state;
-		tsk->stack = stack;
-		tsk->top   = (stk_t *) LIMITED((char *)stack + size, stk_t);
+		priv_tsk_init(tsk, prio, state, stack, size);
 
 		core_ctx_init(tsk);
+		core_tsk_register(tsk);
 		core_tsk_insert(tsk);
 	}
 	sys_unlock();
 }
 
+#if OS_TASK_REENT
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_tsk_reclaim( tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	struct _reent *reent = tsk->reent;
+
+	if (reent)
+	{
+		tsk->reent = 0;
+		if (_impure_ptr == reent)				// the current task is being stopped
+			_impure_ptr = _global_impure_ptr;
+		_reclaim_reent(reent);
+		core_sys_free(reent);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+struct _reent *tsk_reent( void )
+/* -------------------------------------------------------------------------- */
+{
+	struct _reent *reent;
+
+	assert(!port_isr_inside());
+
+	reent = System.cur->reent;
+
+	if (reent == 0)
+	{
+		reent = core_sys_alloc(sizeof(struct _reent));
+
+		if (reent == 0)
+			return _global_impure_ptr;
+
+		_REENT_INIT_PTR(reent);
+
+		sys_lock();
+		{
+			System.cur->reent = reent;
+			_impure_ptr = reent;
+		}
+		sys_unlock();
+	}
+
+	return reent;
+}
+
+#else
+
+#define priv_tsk_reclaim( tsk ) (void)( tsk )
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_CACHE
+
+// task objects created by wrk_create (control block followed by the stack), released and kept for reuse
+
+typedef struct __tsc tsc_t;
+
+struct __tsc
+{
+	tsk_t  * tsk;   // released task object
+	unsigned size;  // size of its stack
+};
+
+static tsc_t    Cache[OS_TASK_CACHE];
+static unsigned Cached = 0;
+
+/* -------------------------------------------------------------------------- */
+static
+tsk_t *priv_wrk_alloc( unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t  * tsk;
+	unsigned i = Cached;
+
+	while (i-- > 0)
+	{
+		if (Cache[i].size == size)
+		{
+			tsk = Cache[i].tsk;
+			Cache[i] = Cache[--Cached];
+			return tsk;
+		}
+	}
+
+	return core_sys_alloc(ABOVE(sizeof(tsk_t)) + size);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_tsk_free( tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	priv_tsk_reclaim(tsk);
+
+	if (tsk->obj.res == tsk && Cached < OS_TASK_CACHE &&
+	    tsk->stack == (void *)((size_t)tsk + ABOVE(sizeof(tsk_t))))
+	{
+		// the object is not touched, the current task may still be running on its stack
+		Cache[Cached].tsk  = tsk;
+		Cache[Cached].size = (unsigned)((size_t)tsk->top - (size_t)tsk->stack);
+		Cached++;
+		return;
+	}
+
+	core_sys_free(tsk->obj.res);
+}
+
+#else
+
+#define priv_wrk_alloc( size ) core_sys_alloc(ABOVE(sizeof(tsk_t)) + ( size ))
+#define priv_tsk_free( tsk )   ( priv_tsk_reclaim(tsk), core_sys_free(( tsk )->obj.res) )
+
+#endif
+
 /* -------------------------------------------------------------------------- */
 tsk_t *wrk_create( unsigned prio, fun_t *state, unsigned size )
 /* -------------------------------------------------------------------------- */
@@ -72,7 +206,7 @@ tsk_t *wrk_create( unsigned prio, fun_t *state, unsigned size )
 	sys_lock();
 	{
 		size = ABOVE(size);
-		tsk = core_sys_alloc(ABOVE(sizeof(tsk_t)) + size);
+		tsk = priv_wrk_alloc(size);
 		tsk_init(tsk, prio, state, (void *)((size_t)tsk + ABOVE(sizeof(tsk_t))), size);
 		tsk->obj.res = tsk;
 	}
@@ -81,19 +215,97 @@ tsk_t *wrk_create( unsigned prio, fun_t *state, unsigned size )
 	return tsk;
 }
 
+#if OS_TASK_RTC
+
+// stacks shared by run-to-completion tasks created by tsk_createRTC, one per priority level
+
+typedef struct __shs shs_t;
+
+struct __shs
+{
+	shs_t  * next;  // next shared stack
+	unsigned prio;  // priority of the tasks using the stack
+	unsigned size;  // size of the stack
+};
+
+static shs_t *Shared = 0;
+
+/* -------------------------------------------------------------------------- */
+void tsk_initRTC( tsk_t *tsk, unsigned prio, fun_t *state, void *stack, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(tsk);
+	assert(state);
+	assert(stack);
+	assert(size);
+	assert(!OS_EDF_PRIO || prio != OS_EDF_PRIO);
+	assert(!OS_COMPACT_TCB || prio <= UINT8_MAX);
+
+	sys_lock();
+	{
+		priv_tsk_init(tsk, prio, state, stack, size);
+
+		tsk->rtc = RTC_DONE; // the stack is not touched until the task is dispatched
+		core_ctx_init(tsk);
+		core_tsk_register(tsk);
+		core_tsk_insert(tsk);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+tsk_t *tsk_createRTC( unsigned prio, fun_t *state, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	shs_t *shs;
+	tsk_t *tsk;
+
+	assert(!port_isr_inside());
+	assert(state);
+	assert(size);
+
+	sys_lock();
+	{
+		size = ABOVE(size);
+		for (shs = Shared; shs && shs->prio != prio; shs = shs->next);
+		if (shs == 0)
+		{
+			shs = core_sys_alloc(ABOVE(sizeof(shs_t)) + size);
+#if defined(DEBUG) || OS_STACK_MONITOR
+			memset((void *)((size_t)shs + ABOVE(sizeof(shs_t))), 0xFF, size);
+#endif
+			shs->next = Shared;
+			shs->prio = prio;
+			shs->size = size;
+			Shared = shs;
+		}
+		assert(size <= shs->size);
+		tsk = core_sys_alloc(sizeof(tsk_t));
+		tsk_initRTC(tsk, prio, state, (void *)((size_t)shs + ABOVE(sizeof(shs_t))), shs->size);
+		tsk->obj.res = tsk;
+	}
+	sys_unlock();
+
+	return tsk;
+}
+
+#endif//OS_TASK_RTC
+
 /* -------------------------------------------------------------------------- */
 void tsk_start( tsk_t *tsk )
 /* -------------------------------------------------------------------------- */
 {
 	assert(!port_isr_inside());
 	assert(tsk);
-	assert(tsk->state);
+	assert(tsk->state || tsk->action);
 
 	sys_lock();
 	{
 		if (tsk->id == ID_STOPPED)
 		{
 			core_ctx_init(tsk);
+			core_tsk_register(tsk);
 			core_tsk_insert(tsk);
 		}
 	}
@@ -112,9 +324,34 @@ void tsk_startFrom( tsk_t *tsk, fun_t *state )
 	{
 		if (tsk->id == ID_STOPPED)
 		{
-			tsk->state = state;
+			tsk->state  = state;
+			tsk->action = 0;
+
+			core_ctx_init(tsk);
+			core_tsk_register(tsk);
+			core_tsk_insert(tsk);
+		}
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void tsk_startArg( tsk_t *tsk, act_t *action, void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(tsk);
+	assert(action);
+
+	sys_lock();
+	{
+		if (tsk->id == ID_STOPPED)
+		{
+			tsk->action = action;
+			tsk->arg    = arg;
 
 			core_ctx_init(tsk);
+			core_tsk_register(tsk);
 			core_tsk_insert(tsk);
 		}
 	}
@@ -130,10 +367,16 @@ void tsk_stop( void )
 
 	port_set_lock();
 
+#if OS_LAZY_FPU
+	port_fpu_release(System.cur);
+#endif
+
+	core_tsk_unregister(System.cur);
+
 	if (System.cur->join != DETACHED)
 		core_tsk_wakeup(System.cur->join, E_SUCCESS);
 	else
-		core_sys_free(System.cur->obj.res);
+		priv_tsk_free(System.cur);
 
 	core_tsk_remove(System.cur);
 
@@ -155,10 +398,17 @@ void tsk_kill( tsk_t *tsk )
 			while (tsk->mtx.list)
 				mtx_kill(tsk->mtx.list);
 
+#if OS_LAZY_FPU
+			port_fpu_release(tsk);
+#endif
+
+			core_tsk_unregister(tsk);
+
 			if (tsk->join != DETACHED)
 				core_tsk_wakeup(tsk->join, E_STOPPED);
 			else
-				core_sys_free(tsk->obj.res);
+			if (tsk == System.cur)
+				priv_tsk_free(tsk); // current task doesn't return from core_tsk_remove
 
 			if (tsk->id == ID_READY)
 				core_tsk_remove(tsk);
@@ -168,6 +418,9 @@ void tsk_kill( tsk_t *tsk )
 				core_tsk_unlink((tsk_t *)tsk, E_STOPPED);
 				core_tmr_remove((tmr_t *)tsk);
 			}
+
+			if (tsk->join == DETACHED && tsk != System.cur)
+				priv_tsk_free(tsk); // free the task object after it has been unlinked
 		}
 	}
 	sys_unlock();
@@ -229,7 +482,7 @@ unsigned tsk_join( tsk_t *tsk )
 				event = E_SUCCESS;
 
 			if (event != E_TIMEOUT) // !detached
-				core_sys_free(tsk->obj.res);
+				priv_tsk_free(tsk);
 		}
 	}
 	sys_unlock();
@@ -259,7 +512,8 @@ void tsk_flip( fun_t *state )
 
 	port_set_lock();
 
-	System.cur->state = state;
+	System.cur->state  = state;
+	System.cur->action = 0;
 
 	core_ctx_switch();
 	core_tsk_flip(System.cur->top);
@@ -270,11 +524,120 @@ void tsk_prio( unsigned prio )
 /* -------------------------------------------------------------------------- */
 {
 	assert(!port_isr_inside());
+	assert(!OS_COMPACT_TCB || prio <= UINT8_MAX);
 
 	sys_lock();
 	{
 		System.cur->basic = prio;
-		core_cur_prio(prio);
+		core_cur_prio(0);
+	}
+	sys_unlock();
+}
+
+#if OS_EDF_PRIO
+
+/* -------------------------------------------------------------------------- */
+void tsk_setDeadline( cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+
+	sys_lock();
+	{
+		core_cur_deadline(time);
+	}
+	sys_unlock();
+}
+
+#endif
+
+#if OS_TASK_THRESHOLD
+
+/* -------------------------------------------------------------------------- */
+void tsk_setThreshold( unsigned thresh )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+
+	sys_lock();
+	{
+		core_cur_threshold(thresh);
+	}
+	sys_unlock();
+}
+
+#endif
+
+#if OS_TASK_BUDGET
+
+/* -------------------------------------------------------------------------- */
+void tsk_setBudget( tsk_t *tsk, cnt_t limit, cnt_t period )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(tsk);
+	assert(limit <= period);
+
+	sys_lock();
+	{
+		core_tsk_budget(tsk, limit, period);
+	}
+	sys_unlock();
+}
+
+#endif
+
+#if OS_TASK_AGING
+
+/* -------------------------------------------------------------------------- */
+void tsk_setAging( tsk_t *tsk, unsigned ceil )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(tsk);
+#if OS_PRIO_BITMAP
+	assert(ceil < OS_PRIO_BITMAP);
+#endif
+
+	sys_lock();
+	{
+		core_tsk_aging(tsk, ceil);
+	}
+	sys_unlock();
+}
+
+#endif
+
+#if OS_TASK_PARTITION
+
+/* -------------------------------------------------------------------------- */
+void tsk_setPartition( tsk_t *tsk, unsigned part )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(tsk);
+	assert(part != PRT_ALL);
+
+	sys_lock();
+	{
+		core_prt_assign(tsk, part);
+	}
+	sys_unlock();
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+void tsk_setSlice( tsk_t *tsk, cnt_t slice )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(tsk);
+	assert(!OS_COMPACT_TCB || slice <= UINT16_MAX);
+
+	sys_lock();
+	{
+		tsk->quant = slice;
 	}
 	sys_unlock();
 }
@@ -330,6 +693,116 @@ void tsk_give( tsk_t *tsk, unsigned flags )
 	sys_unlock();
 }
 
+/* -------------------------------------------------------------------------- */
+void tsk_notify( tsk_t *tsk, unsigned action, unsigned value )
+/* -------------------------------------------------------------------------- */
+{
+	assert(tsk);
+	assert(action <= ntfAdd);
+
+	sys_lock();
+	{
+		switch (action)
+		{
+		case ntfIncrement: tsk->ntf.value++;        break;
+		case ntfOverwrite: tsk->ntf.value = value;  break;
+		case ntfSetBits:   tsk->ntf.value |= value; break;
+		case ntfAdd:       tsk->ntf.value += value; break;
+		}
+
+		tsk->ntf.state = 1;
+
+		if (tsk->ntf.queue && (tsk->ntf.value || !tsk->tmp.ntf.take))
+			core_tsk_wakeup(tsk, E_SUCCESS);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_tsk_notifyTake( cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t  * cur = System.cur;
+	unsigned event = E_SUCCESS;
+
+	assert(!port_isr_inside());
+
+	sys_lock();
+	{
+		if (cur->ntf.value == 0)
+		{
+			cur->tmp.ntf.take = 1;
+			event = wait(&cur->ntf, time);
+		}
+
+		if (event == E_SUCCESS)
+			if (--cur->ntf.value == 0)
+				cur->ntf.state = 0;
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned tsk_notifyTakeFor( cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_tsk_notifyTake(delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned tsk_notifyTakeUntil( cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_tsk_notifyTake(time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_tsk_notifyWait( unsigned *value, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t  * cur = System.cur;
+	unsigned event = E_SUCCESS;
+
+	assert(!port_isr_inside());
+
+	sys_lock();
+	{
+		if (cur->ntf.state == 0)
+		{
+			cur->tmp.ntf.take = 0;
+			event = wait(&cur->ntf, time);
+		}
+
+		if (event == E_SUCCESS)
+		{
+			if (value) *value = cur->ntf.value;
+			cur->ntf.value = 0;
+			cur->ntf.state = 0;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned tsk_notifyWaitFor( unsigned *value, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_tsk_notifyWait(value, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned tsk_notifyWaitUntil( unsigned *value, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_tsk_notifyWait(value, time, core_tsk_waitUntil);
+}
+
 /* -------------------------------------------------------------------------- */
 unsigned tsk_suspend( tsk_t *tsk )
 /* -------------------------------------------------------------------------- */
@@ -373,3 +846,180 @@ unsigned tsk_resume( tsk_t *tsk )
 }
 
 /* -------------------------------------------------------------------------- */
+unsigned tsk_enumerate( tsk_t **list, unsigned count )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t   *tsk = &IDLE;
+	unsigned drops = 0;
+	unsigned n = 0;
+	unsigned i;
+
+	assert(!port_isr_inside());
+	assert(list);
+
+	while (n < count)
+	{
+		sys_lock();
+		{
+			if (n == 0 || drops != System.drops)
+			{
+				// the next task to store may have been removed, restart the scan
+				drops = System.drops;
+				tsk = &IDLE;
+				n = 0;
+			}
+
+			for (i = 0; i < REG_CHUNK && n < count; i++)
+			{
+				list[n++] = tsk;
+				tsk = tsk->reg.next;
+				if (tsk == &IDLE)
+					count = n;
+			}
+		}
+		sys_unlock();
+	}
+
+	return n;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_TASK_STATS
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_tsk_stat( sts_t *stat, tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	stat->tsk   = tsk;
+	stat->time  = tsk->stat.time;
+	stat->count = tsk->stat.count;
+#if OS_TASK_ENERGY
+	stat->energy = tsk->energy;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned tsk_getStats( sts_t *stats, unsigned count )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t   *tsk = &IDLE;
+	unsigned n = 0;
+
+	assert(!port_isr_inside());
+	assert(stats);
+
+	if (count == 0)
+		return 0;
+
+	sys_lock();
+	{
+		core_cur_account();
+
+		do priv_tsk_stat(&stats[n++], tsk);
+		while ((tsk = tsk->reg.next) != &IDLE && n < count);
+	}
+	sys_unlock();
+
+	return n;
+}
+
+#endif//OS_TASK_STATS
+
+/* -------------------------------------------------------------------------- */
+
+#if 1000000 % (OS_FREQUENCY) == 0
+
+/* -------------------------------------------------------------------------- */
+unsigned tsk_sleepForHR( uint32_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	uint32_t start = sys_timeHR();
+	cnt_t    ticks = (cnt_t)(delay / (1000000 / (OS_FREQUENCY)));
+	unsigned event;
+
+	assert(!port_isr_inside());
+
+	if (ticks > 1)
+	{
+		event = tsk_sleepFor(ticks - 1); // ends before the end of the requested duration
+		if (event != E_TIMEOUT)
+			return event;
+	}
+
+	while (sys_timeHR() - start < delay);
+
+	return E_TIMEOUT;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_STACK_MONITOR
+
+/* -------------------------------------------------------------------------- */
+unsigned tsk_stackUsed( tsk_t *tsk )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned used = 0;
+
+	assert(!port_isr_inside());
+	assert(tsk);
+
+	sys_lock();
+	{
+		if (tsk->mark)
+		{
+			core_stk_scan(tsk, core_stk_base(tsk), ~0U);
+			used = (size_t)tsk->top - (size_t)tsk->mark;
+		}
+	}
+	sys_unlock();
+
+	return used;
+}
+
+#endif//OS_STACK_MONITOR
+
+#if OS_TASK_LATENCY
+
+/* -------------------------------------------------------------------------- */
+void tsk_getLatency( tsk_t *tsk, uint32_t *hist, bool clear )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(tsk);
+	assert(hist);
+
+	sys_lock();
+	{
+		memcpy(hist, tsk->lat.hist, sizeof(tsk->lat.hist));
+		if (clear)
+			memset(tsk->lat.hist, 0, sizeof(tsk->lat.hist));
+	}
+	sys_unlock();
+}
+
+#endif//OS_TASK_LATENCY
+
+#if OS_PERIOD_STATS
+
+/* -------------------------------------------------------------------------- */
+void tsk_setOverrunHook( tsk_t *tsk, act_t *hook )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(tsk);
+
+	sys_lock();
+	{
+		tsk->per.hook = hook;
+	}
+	sys_unlock();
+}
+
+#endif//OS_PERIOD_STATS
+
+/* -------------------------------------------------------------------------- */
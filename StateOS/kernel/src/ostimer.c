@@ -30,8 +30,15 @@
  ******************************************************************************/
 
 #include "inc/ostimer.h"
+#include "inc/ostask.h"
 #include "inc/oscriticalsection.h"
 
+/* -------------------------------------------------------------------------- */
+
+#if OS_TIMER_TASK
+static_TSK(Service, OS_TIMER_TASK, core_tmr_service); // timer service task, started with the first timer
+#endif
+
 /* -------------------------------------------------------------------------- */
 void tmr_init( tmr_t *tmr, fun_t *state )
 /* -------------------------------------------------------------------------- */
@@ -49,6 +56,23 @@ void tmr_init( tmr_t *tmr, fun_t *state )
 	sys_unlock();
 }
 
+/* -------------------------------------------------------------------------- */
+void tmr_initArg( tmr_t *tmr, act_t *action, void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(tmr);
+
+	sys_lock();
+	{
+		tmr_init(tmr, 0);
+
+		tmr->action = action;
+		tmr->arg    = arg;
+	}
+	sys_unlock();
+}
+
 /* -------------------------------------------------------------------------- */
 tmr_t *tmr_create( fun_t *state )
 /* -------------------------------------------------------------------------- */
@@ -72,30 +96,28 @@ tmr_t *tmr_create( fun_t *state )
 void tmr_kill( tmr_t *tmr )
 /* -------------------------------------------------------------------------- */
 {
+	obj_t hld;
+
 	assert(!port_isr_inside());
 	assert(tmr);
 
 	sys_lock();
 	{
+		core_all_detach(tmr, &hld);
 		if (tmr->id != ID_STOPPED)
-		{
-			core_all_wakeup(tmr, E_STOPPED);
 			core_tmr_remove(tmr);
-		}
 	}
 	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
 }
 
 /* -------------------------------------------------------------------------- */
 void tmr_delete( tmr_t *tmr )
 /* -------------------------------------------------------------------------- */
 {
-	sys_lock();
-	{
-		tmr_kill(tmr);
-		core_sys_free(tmr->obj.res);
-	}
-	sys_unlock();
+	tmr_kill(tmr);
+	core_sys_free(tmr->obj.res);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -105,6 +127,9 @@ void priv_tmr_start( tmr_t *tmr )
 {
 	assert(!port_isr_inside());
 
+#if OS_TIMER_TASK
+	tsk_start(Service);
+#endif
 	if (tmr->id != ID_STOPPED)
 		core_tmr_remove(tmr);
 	core_tmr_insert(tmr, ID_TIMER);
@@ -127,6 +152,24 @@ void tmr_start( tmr_t *tmr, cnt_t delay, cnt_t period )
 	sys_unlock();
 }
 
+/* -------------------------------------------------------------------------- */
+void tmr_startSlack( tmr_t *tmr, cnt_t delay, cnt_t period, cnt_t slack )
+/* -------------------------------------------------------------------------- */
+{
+	assert(tmr);
+
+	sys_lock();
+	{
+		tmr->start  = core_sys_time();
+		tmr->delay  = delay;
+		tmr->period = period;
+		tmr->slack  = slack;
+
+		priv_tmr_start(tmr);
+	}
+	sys_unlock();
+}
+
 /* -------------------------------------------------------------------------- */
 void tmr_startFrom( tmr_t *tmr, cnt_t delay, cnt_t period, fun_t *proc )
 /* -------------------------------------------------------------------------- */
@@ -136,6 +179,27 @@ void tmr_startFrom( tmr_t *tmr, cnt_t delay, cnt_t period, fun_t *proc )
 	sys_lock();
 	{
 		tmr->state  = proc;
+		tmr->action = 0;
+		tmr->start  = core_sys_time();
+		tmr->delay  = delay;
+		tmr->period = period;
+
+		priv_tmr_start(tmr);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void tmr_startArg( tmr_t *tmr, cnt_t delay, cnt_t period, act_t *action, void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	assert(tmr);
+
+	sys_lock();
+	{
+		tmr->state  = 0;
+		tmr->action = action;
+		tmr->arg    = arg;
 		tmr->start  = core_sys_time();
 		tmr->delay  = delay;
 		tmr->period = period;
@@ -243,3 +307,134 @@ unsigned tmr_waitUntil( tmr_t *tmr, cnt_t time )
 }
 
 /* -------------------------------------------------------------------------- */
+void tmg_init( tmg_t *tmg, unsigned limit, tmm_t *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(tmg);
+	assert(limit);
+	assert(data);
+
+	sys_lock();
+	{
+		memset(tmg, 0, sizeof(tmg_t));
+
+		tmg->limit = limit;
+		tmg->data  = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned tmg_add( tmg_t *tmg, tmr_t *tmr, cnt_t delay, cnt_t period )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+	unsigned i;
+
+	assert(!port_isr_inside());
+	assert(tmg);
+	assert(tmr);
+
+	sys_lock();
+	{
+		if (tmg->count < tmg->limit)
+		{
+			// keep the members ordered by delays, so they are merged into the timers queue in one pass
+			for (i = tmg->count++; i > 0 && tmg->data[i - 1].delay > delay; i--)
+				tmg->data[i] = tmg->data[i - 1];
+
+			tmg->data[i].tmr    = tmr;
+			tmg->data[i].delay  = delay;
+			tmg->data[i].period = period;
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+void tmg_start( tmg_t *tmg )
+/* -------------------------------------------------------------------------- */
+{
+	tmm_t *mem;
+	tmr_t *hint = 0;
+
+	assert(!port_isr_inside());
+	assert(tmg);
+
+	sys_lock();
+	{
+#if OS_TIMER_TASK
+		tsk_start(Service);
+#endif
+		tmg->base = core_sys_time();
+
+		for (mem = tmg->data; mem < tmg->data + tmg->count; mem++)
+		{
+			if (mem->tmr->id != ID_STOPPED)
+				core_tmr_remove(mem->tmr);
+
+			mem->tmr->start  = tmg->base;
+			mem->tmr->delay  = mem->delay;
+			mem->tmr->period = mem->period;
+
+			hint = core_tmr_merge(mem->tmr, ID_TIMER, hint);
+		}
+
+		core_tmr_force();
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void tmg_stop( tmg_t *tmg )
+/* -------------------------------------------------------------------------- */
+{
+	tmm_t *mem;
+
+	assert(!port_isr_inside());
+	assert(tmg);
+
+	sys_lock();
+	{
+		for (mem = tmg->data; mem < tmg->data + tmg->count; mem++)
+			if (mem->tmr->id != ID_STOPPED)
+				core_tmr_remove(mem->tmr);
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+void tmg_shift( tmg_t *tmg, cnt_t delta )
+/* -------------------------------------------------------------------------- */
+{
+	tmm_t *mem;
+	tmr_t *hint = 0;
+
+	assert(!port_isr_inside());
+	assert(tmg);
+
+	sys_lock();
+	{
+		tmg->base += delta;
+
+		for (mem = tmg->data; mem < tmg->data + tmg->count; mem++)
+		{
+			if (mem->tmr->id == ID_STOPPED || mem->tmr->delay == INFINITE)
+				continue;
+
+			core_tmr_remove(mem->tmr);
+			// the start of a timer can't be in the future, so the current countdown is extended
+			mem->tmr->delay = mem->tmr->delay < INFINITE - delta ? mem->tmr->delay + delta : INFINITE - 1;
+			hint = core_tmr_merge(mem->tmr, ID_TIMER, hint);
+		}
+
+		core_tmr_force();
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,383 @@
+/******************************************************************************
+
+    @file    StateOS: osworkerpool.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   This file provides set of functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "inc/osworkerpool.h"
+#include "inc/ostask.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+
+typedef struct __wpw wpw_t;
+
+struct __wpw // worker task owned by the worker pool
+{
+	tsk_t    tsk;   // must be the first member
+	wpl_t  * wpl;   // pool of the worker task
+};
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_wpl_worker( void )
+/* -------------------------------------------------------------------------- */
+{
+	wpw_t *wrk = (wpw_t *) System.cur;
+
+	wpl_wait(wrk->wpl);
+}
+
+/* -------------------------------------------------------------------------- */
+void wpl_init( wpl_t *wpl, unsigned limit, wpj_t *data )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(wpl);
+	assert(limit);
+	assert(data);
+
+	sys_lock();
+	{
+		memset(wpl, 0, sizeof(wpl_t));
+
+		wpl->limit = limit;
+		wpl->data  = data;
+	}
+	sys_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+wpl_t *wpl_create( unsigned limit, unsigned workers, unsigned prio, unsigned size )
+/* -------------------------------------------------------------------------- */
+{
+	wpl_t  * wpl;
+	wpw_t  * wrk;
+	unsigned i;
+
+	assert(!port_isr_inside());
+	assert(limit);
+	assert(workers);
+	assert(size);
+
+	sys_lock();
+	{
+		size = ABOVE(size);
+		wpl = core_sys_alloc(ABOVE(sizeof(wpl_t)) + ABOVE(limit * sizeof(wpj_t)) + workers * sizeof(tsk_t *));
+		wpl_init(wpl, limit, (void *)((size_t)wpl + ABOVE(sizeof(wpl_t))));
+		wpl->res  = wpl;
+		wpl->wrk  = (void *)((size_t)wpl->data + ABOVE(limit * sizeof(wpj_t)));
+
+		for (i = 0; i < workers; i++)
+		{
+			wrk = core_sys_alloc(ABOVE(sizeof(wpw_t)) + size);
+			wrk->wpl = wpl;
+			tsk_init(&wrk->tsk, prio, priv_wpl_worker, (void *)((size_t)wrk + ABOVE(sizeof(wpw_t))), size);
+			wrk->tsk.obj.res = wrk;
+			wpl->wrk[wpl->size++] = &wrk->tsk;
+		}
+	}
+	sys_unlock();
+
+	return wpl;
+}
+
+/* -------------------------------------------------------------------------- */
+void wpl_kill( wpl_t *wpl )
+/* -------------------------------------------------------------------------- */
+{
+	obj_t hld;
+
+	assert(!port_isr_inside());
+	assert(wpl);
+
+	sys_lock();
+	{
+		wpl->count = 0;
+		wpl->head  = 0;
+		wpl->tail  = 0;
+
+		core_all_detach(wpl, &hld);
+	}
+	sys_unlock();
+
+	core_all_release(&hld, E_STOPPED);
+}
+
+/* -------------------------------------------------------------------------- */
+void wpl_delete( wpl_t *wpl )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned i;
+
+	for (i = 0; i < wpl->size; i++)
+	{
+		assert(wpl->wrk[i] != System.cur);
+		tsk_delete(wpl->wrk[i]);
+	}
+
+	wpl_kill(wpl);
+	core_sys_free(wpl->res);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_wpl_get( wpl_t *wpl, wpj_t *job )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned i = wpl->head;
+
+	*job = wpl->data[i++];
+	wpl->head = (i < wpl->limit) ? i : 0;
+	wpl->count--;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_wpl_put( wpl_t *wpl, act_t *fun, void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned i = wpl->tail;
+
+	wpl->data[i].fun = fun;
+	wpl->data[i].arg = arg;
+	i++;
+
+	wpl->tail = (i < wpl->limit) ? i : 0;
+	wpl->count++;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_wpl_skip( wpl_t *wpl )
+/* -------------------------------------------------------------------------- */
+{
+	wpl->count--;
+	wpl->head++;
+	if (wpl->head == wpl->limit) wpl->head = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_wpl_getUpdate( wpl_t *wpl, wpj_t *job )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+
+	priv_wpl_get(wpl, job);
+	tsk = core_one_wakeup(wpl, E_SUCCESS);
+	if (tsk) priv_wpl_put(wpl, tsk->tmp.wpl.fun, tsk->tmp.wpl.arg);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_wpl_putUpdate( wpl_t *wpl, act_t *fun, void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	tsk_t *tsk;
+	wpj_t  job;
+
+	priv_wpl_put(wpl, fun, arg);
+	tsk = core_one_wakeup(wpl, E_SUCCESS); // only one worker is woken up for every queued job
+	if (tsk)
+	{
+		priv_wpl_get(wpl, &job);
+		tsk->tmp.wpl.fun = job.fun;
+		tsk->tmp.wpl.arg = job.arg;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned wpl_take( wpl_t *wpl )
+/* -------------------------------------------------------------------------- */
+{
+	wpj_t    job;
+	unsigned event = E_TIMEOUT;
+
+	assert(wpl);
+
+	sys_lock();
+	{
+		if (wpl->count > 0)
+		{
+			priv_wpl_getUpdate(wpl, &job);
+			event = E_SUCCESS;
+		}
+
+		if (event == E_SUCCESS)
+		{
+			port_clr_lock();
+			job.fun(job.arg);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_wpl_wait( wpl_t *wpl, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	wpj_t    job;
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(wpl);
+
+	sys_lock();
+	{
+		if (wpl->count > 0)
+		{
+			priv_wpl_getUpdate(wpl, &job);
+			event = E_SUCCESS;
+		}
+		else
+		{
+			event = wait(wpl, time);
+			job.fun = System.cur->tmp.wpl.fun;
+			job.arg = System.cur->tmp.wpl.arg;
+		}
+
+		if (event == E_SUCCESS)
+		{
+			port_clr_lock();
+			job.fun(job.arg);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned wpl_waitFor( wpl_t *wpl, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_wpl_wait(wpl, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned wpl_waitUntil( wpl_t *wpl, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_wpl_wait(wpl, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned wpl_give( wpl_t *wpl, act_t *fun, void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(wpl);
+	assert(fun);
+
+	sys_lock();
+	{
+		if (wpl->count < wpl->limit)
+		{
+			priv_wpl_putUpdate(wpl, fun, arg);
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+static
+unsigned priv_wpl_send( wpl_t *wpl, act_t *fun, void *arg, cnt_t time, unsigned(*wait)(void*,cnt_t) )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event;
+
+	assert(!port_isr_inside());
+	assert(wpl);
+	assert(fun);
+
+	sys_lock();
+	{
+		if (wpl->count < wpl->limit)
+		{
+			priv_wpl_putUpdate(wpl, fun, arg);
+			event = E_SUCCESS;
+		}
+		else
+		{
+			System.cur->tmp.wpl.fun = fun;
+			System.cur->tmp.wpl.arg = arg;
+			event = wait(wpl, time);
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned wpl_sendFor( wpl_t *wpl, act_t *fun, void *arg, cnt_t delay )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_wpl_send(wpl, fun, arg, delay, core_tsk_waitFor);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned wpl_sendUntil( wpl_t *wpl, act_t *fun, void *arg, cnt_t time )
+/* -------------------------------------------------------------------------- */
+{
+	return priv_wpl_send(wpl, fun, arg, time, core_tsk_waitUntil);
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned wpl_push( wpl_t *wpl, act_t *fun, void *arg )
+/* -------------------------------------------------------------------------- */
+{
+	unsigned event = E_TIMEOUT;
+
+	assert(wpl);
+	assert(fun);
+
+	sys_lock();
+	{
+		if (wpl->count == 0 || wpl->queue == 0)
+		{
+			if (wpl->count == wpl->limit)
+				priv_wpl_skip(wpl);
+			priv_wpl_putUpdate(wpl, fun, arg);
+			event = E_SUCCESS;
+		}
+	}
+	sys_unlock();
+
+	return event;
+}
+
+/* -------------------------------------------------------------------------- */
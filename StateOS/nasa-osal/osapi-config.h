@@ -165,4 +165,32 @@
 */
 #define OS_MAX_TIMERS         5
 
+/*
+** This define sets the maximum number of shared memory segments available
+*/
+#define OS_MAX_SHMEM_SEGMENTS 8
+
+/*
+** This define sets the number of deferred OS_printf records (0: OS_printf formats in the caller's context)
+** Deferred OS_printf only stores the format pointer and the raw arguments (at most OS_PRINTF_ARGS),
+** the record is formatted by a logger task of the lowest priority; strings passed with %s must stay valid
+** until the record is printed. Records that do not fit in the queue are counted and dropped.
+*/
+#define OS_PRINTF_QUEUE       0
+#define OS_PRINTF_ARGS        8
+
+/*
+** These defines are for the file system (volumes formatted by OS_mkfs on RAM disks or attached block devices)
+** All the volumes share one LRU cache of OS_FS_CACHE_BLOCKS blocks of OS_FS_BLOCK_SIZE bytes (the largest
+** block size of a volume). OS_write only updates the cache; dirty blocks are written back by a flush task
+** of the lowest priority every OS_FS_FLUSH_PERIOD milliseconds, or earlier when half of the cache is dirty.
+** Sequential OS_read prefetches the next OS_FS_READ_AHEAD blocks of the file (0: no read-ahead).
+*/
+#define OS_FS_BLOCK_SIZE      512
+#define OS_FS_CACHE_BLOCKS    16
+#define OS_FS_DIR_ENTRIES     64
+#define OS_FS_FLUSH_PERIOD    100
+#define OS_FS_READ_AHEAD      1
+#define OS_MAX_NUM_OPEN_DIRS  4
+
 #endif
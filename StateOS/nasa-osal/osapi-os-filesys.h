@@ -122,8 +122,6 @@
 #define _osapi_filesys_
 #include <stdio.h>
 #include <stdlib.h>
-#include <dirent.h>
-#include <sys/stat.h>
 
 #define OS_READ_ONLY        0
 #define OS_WRITE_ONLY       1
@@ -210,15 +208,51 @@ typedef struct
    uint32   FreeVolumes;           /* Total number of volumes free */
 } os_fsinfo_t; 
 
-/* modified to posix calls, since all of the 
- * applicable OSes use the posix calls */
+/* the file system is implemented by the OSAL itself (StateOS),
+ * so the file status and directory entries do not depend on posix */
 
-typedef struct stat         os_fstat_t;
-typedef DIR*                os_dirp_t;
-typedef struct dirent       os_dirent_t;
+typedef struct
+{
+   uint32   FileModeBits;          /* OS_FILESTAT_MODE_xxx */
+   int32    FileTime;              /* time of the last modification, in seconds */
+   uint32   FileSize;              /* size of the file, in bytes */
+} os_fstat_t;
+
+#define OS_FILESTAT_MODE_EXEC   0x00001
+#define OS_FILESTAT_MODE_WRITE  0x00002
+#define OS_FILESTAT_MODE_READ   0x00004
+#define OS_FILESTAT_MODE_DIR    0x10000
+
+#define OS_FILESTAT_MODE(x)     ((x).FileModeBits)
+#define OS_FILESTAT_ISDIR(x)    ((x).FileModeBits & OS_FILESTAT_MODE_DIR)
+#define OS_FILESTAT_SIZE(x)     ((x).FileSize)
+#define OS_FILESTAT_TIME(x)     ((x).FileTime)
+
+typedef struct
+{
+   char     FileName[OS_MAX_PATH_LEN];
+} os_dirent_t;
+
+#define OS_DIRENTRY_NAME(x)     ((x).FileName)
+
+typedef struct OS_dir_record *os_dirp_t;
 /* still don't know what this should be*/
 typedef unsigned long int   os_fshealth_t; 
 
+/*
+** Block device of a volume (StateOS extension)
+** 'read' and 'write' transfer one whole block of the volume block size,
+** 'sync' (optional) makes the written blocks persistent;
+** the callbacks return OS_FS_SUCCESS or OS_FS_ERROR
+*/
+typedef struct
+{
+    int32 (*read) (void *ctx, uint32 block, void *data);
+    int32 (*write)(void *ctx, uint32 block, const void *data);
+    int32 (*sync) (void *ctx);
+    void   *ctx;
+} OS_BlockDevice_t;
+
 /*
  * Exported Functions
 */
@@ -377,6 +411,16 @@ int32           OS_rmfs        (char *devname);
 */
 int32           OS_unmount     (const char *mountpoint);
 
+/*
+ * Attaches a block device to be formatted or initialized with OS_mkfs / OS_initfs (StateOS extension)
+*/
+int32           OS_BlkDevAttach (const char *devname, const OS_BlockDevice_t *dev);
+
+/*
+ * Writes back all the cached blocks of the mounted file systems (StateOS extension)
+*/
+int32           OS_FS_Sync      (void);
+
 /*
  * Returns the number of free blocks in a file system
 */
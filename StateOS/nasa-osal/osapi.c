@@ -54,6 +54,8 @@
 #include <stdarg.h>
 #include <string.h>
 #include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <osnasa.h>
 
 /* -------------------------------------------------------------------------- */
@@ -67,29 +69,108 @@ static OS_count_sem_record_t OS_count_sem_table[OS_MAX_COUNT_SEMAPHORES];
 static OS_mut_sem_record_t   OS_mut_sem_table  [OS_MAX_MUTEXES];
 static OS_task_record_t      OS_task_table     [OS_MAX_TASKS];
 static OS_timer_record_t     OS_timer_table    [OS_MAX_TIMERS];
+static OS_shmem_record_t     OS_shmem_table    [OS_MAX_SHMEM_SEGMENTS];
 
-static OS_time_t             localtime        = { 0, 0 };
-static tmr_t                 local_timer      = TMR_INIT(0);
+/*
+** table mutexes protect record allocation, release and the name index only;
+** the remaining functions validate the record without locking and call the kernel directly
+*/
+
+static mut_t                 OS_queue_mutex     = MUT_INIT();
+static mut_t                 OS_bin_sem_mutex   = MUT_INIT();
+static mut_t                 OS_count_sem_mutex = MUT_INIT();
+static mut_t                 OS_mut_sem_mutex   = MUT_INIT();
+static mut_t                 OS_task_mutex      = MUT_INIT();
+static mut_t                 OS_timer_mutex     = MUT_INIT();
+static mut_t                 OS_shmem_mutex     = MUT_INIT();
+
+static uint16                OS_queue_hash     [OS_NAME_SIZE(OS_MAX_QUEUES)];
+static uint16                OS_bin_sem_hash   [OS_NAME_SIZE(OS_MAX_BIN_SEMAPHORES)];
+static uint16                OS_count_sem_hash [OS_NAME_SIZE(OS_MAX_COUNT_SEMAPHORES)];
+static uint16                OS_mut_sem_hash   [OS_NAME_SIZE(OS_MAX_MUTEXES)];
+static uint16                OS_task_hash      [OS_NAME_SIZE(OS_MAX_TASKS)];
+static uint16                OS_timer_hash     [OS_NAME_SIZE(OS_MAX_TIMERS)];
+static uint16                OS_shmem_hash     [OS_NAME_SIZE(OS_MAX_SHMEM_SEGMENTS)];
+
+static const OS_name_index_t OS_queue_index     = { OS_queue_hash,     OS_NAME_SIZE(OS_MAX_QUEUES),           OS_queue_table[0].name,     sizeof(OS_queue_record_t) };
+static const OS_name_index_t OS_bin_sem_index   = { OS_bin_sem_hash,   OS_NAME_SIZE(OS_MAX_BIN_SEMAPHORES),   OS_bin_sem_table[0].name,   sizeof(OS_bin_sem_record_t) };
+static const OS_name_index_t OS_count_sem_index = { OS_count_sem_hash, OS_NAME_SIZE(OS_MAX_COUNT_SEMAPHORES), OS_count_sem_table[0].name, sizeof(OS_count_sem_record_t) };
+static const OS_name_index_t OS_mut_sem_index   = { OS_mut_sem_hash,   OS_NAME_SIZE(OS_MAX_MUTEXES),          OS_mut_sem_table[0].name,   sizeof(OS_mut_sem_record_t) };
+static const OS_name_index_t OS_task_index      = { OS_task_hash,      OS_NAME_SIZE(OS_MAX_TASKS),            OS_task_table[0].name,      sizeof(OS_task_record_t) };
+static const OS_name_index_t OS_timer_index     = { OS_timer_hash,     OS_NAME_SIZE(OS_MAX_TIMERS),           OS_timer_table[0].name,     sizeof(OS_timer_record_t) };
+static const OS_name_index_t OS_shmem_index     = { OS_shmem_hash,     OS_NAME_SIZE(OS_MAX_SHMEM_SEGMENTS),   OS_shmem_table[0].name,     sizeof(OS_shmem_record_t) };
+
+static uint64_t              local_offset     = 0; // local time minus system time, in system ticks
 static bool                  printf_enabled   = FALSE;
 
 /* -------------------------------------------------------------------------- */
 /*
-** OSAL local timer handler
+** OSAL name index: open-addressing hash table (linear probing) of record numbers keyed on the record name
+** must be used with the mutex of the table locked
 */
 
-static void local_timer_handler( void )
+static const char *name_of(const OS_name_index_t *idx, uint32 id)
 {
-	sys_lockISR();
+	return idx->name + id * idx->step;
+}
+
+static uint32 name_hash(const OS_name_index_t *idx, const char *name)
+{
+	uint32 hash = 2166136261U; // FNV-1a
+
+	while (*name)
+		hash = (hash ^ (uint8) *name++) * 16777619U;
+
+	return hash % idx->size;
+}
+
+static int32 name_find(const OS_name_index_t *idx, const char *name)
+{
+	uint32 i = name_hash(idx, name);
+	uint32 n;
+	uint16 e;
+
+	for (n = idx->size; n > 0; n--)
 	{
-		localtime.microsecs += 1000;
+		e = idx->hash[i];
+		if (e == OS_NAME_FREE)
+			break;
+		if (e != OS_NAME_DELETED && strcmp(name_of(idx, e - 1U), name) == 0)
+			return (int32)(e - 1U);
+		if (++i == idx->size)
+			i = 0;
+	}
 
-		if (localtime.microsecs >= 1000000)
-		{
-			localtime.microsecs = 0;
-			localtime.seconds++;
-		}
+	return -1;
+}
+
+static void name_insert(const OS_name_index_t *idx, uint32 id)
+{
+	uint32 i = name_hash(idx, name_of(idx, id));
+
+	while (idx->hash[i] != OS_NAME_FREE && idx->hash[i] != OS_NAME_DELETED)
+		if (++i == idx->size)
+			i = 0;
+
+	idx->hash[i] = (uint16)(id + 1U);
+}
+
+static void name_remove(const OS_name_index_t *idx, uint32 id)
+{
+	uint32 i = name_hash(idx, name_of(idx, id));
+
+	while (idx->hash[i] != (uint16)(id + 1U))
+		if (++i == idx->size)
+			i = 0;
+
+	idx->hash[i] = OS_NAME_DELETED;
+
+	// release deleted entries that precede a free entry, so that probe sequences stay short
+	while (idx->hash[i] == OS_NAME_DELETED && idx->hash[(i + 1U) % idx->size] == OS_NAME_FREE)
+	{
+		idx->hash[i] = OS_NAME_FREE;
+		i = (i ? i : idx->size) - 1U;
 	}
-	sys_unlockISR();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -97,10 +178,17 @@ static void local_timer_handler( void )
 ** Initialization of API
 */
 
+#if OS_PRINTF_QUEUE > 0
+static void printf_handler(void);
+static_TSK(printf_task, 1, printf_handler);
+#endif
+
 int32 OS_API_Init(void)
 {
-	tmr_startFrom(&local_timer, MSEC, MSEC, local_timer_handler);
-
+#if OS_PRINTF_QUEUE > 0
+	tsk_start(printf_task);
+#endif
+	OS_FS_Init();
 	return OS_SUCCESS;
 }
 
@@ -109,17 +197,209 @@ int32 OS_API_Init(void)
 ** Abstraction for printf statements
 */
 
+#if OS_PRINTF_QUEUE > 0
+
+/*
+** deferred printf: the caller only copies the format pointer and the raw arguments into the printf queue,
+** the logger task of the lowest priority formats the records; the format is parsed with the same function
+** at both sides, so the logger knows the type of every stored argument
+*/
+
+enum { PRINTF_TEXT, PRINTF_INT, PRINTF_LONG, PRINTF_LLONG, PRINTF_SIZE, PRINTF_INTMAX, PRINTF_PTRDIFF, PRINTF_DOUBLE, PRINTF_PTR, PRINTF_STOP };
+
+typedef union
+{
+	long long    i;
+	double       d;
+	const void * p;
+}	OS_printf_arg_t;
+
+typedef struct
+{
+	const char    * fmt;
+	OS_printf_arg_t arg[OS_PRINTF_ARGS];
+}	OS_printf_record_t;
+
+static_BOX(printf_box, OS_PRINTF_QUEUE, sizeof(OS_printf_record_t));
+static uint32 printf_lost = 0;
+
+/*
+** return the end of the conversion specification starting at 'fmt' (just after '%'),
+** its kind and the number of '*' (int) arguments preceding the value
+** PRINTF_STOP: unsupported specification (%n, %L..), the rest of the format is printed verbatim
+*/
+static const char *printf_spec(const char *fmt, unsigned *kind, unsigned *star)
+{
+	unsigned size = PRINTF_INT;
+
+	*star = 0;
+
+	if (*fmt == '%')
+	{
+		*kind = PRINTF_TEXT;
+		return fmt + 1;
+	}
+
+	while (*fmt == '-' || *fmt == '+' || *fmt == ' ' || *fmt == '#' || *fmt == '0')
+		fmt++;
+	if (*fmt == '*') { fmt++; (*star)++; } else while (*fmt >= '0' && *fmt <= '9') fmt++;
+	if (*fmt == '.')
+	{
+		fmt++;
+		if (*fmt == '*') { fmt++; (*star)++; } else while (*fmt >= '0' && *fmt <= '9') fmt++;
+	}
+
+	switch (*fmt)
+	{
+	case 'h': fmt++; if (*fmt == 'h') fmt++; break;
+	case 'l': fmt++; size = PRINTF_LONG; if (*fmt == 'l') { fmt++; size = PRINTF_LLONG; } break;
+	case 'z': fmt++; size = PRINTF_SIZE;    break;
+	case 'j': fmt++; size = PRINTF_INTMAX;  break;
+	case 't': fmt++; size = PRINTF_PTRDIFF; break;
+	}
+
+	switch (*fmt)
+	{
+	case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+		*kind = size;
+		break;
+	case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+		*kind = size == PRINTF_INT || size == PRINTF_LONG ? PRINTF_DOUBLE : PRINTF_STOP;
+		break;
+	case 's': case 'p':
+		*kind = PRINTF_PTR;
+		break;
+	default:
+		*kind = PRINTF_STOP;
+		return fmt;
+	}
+
+	return fmt + 1;
+}
+
+#define PRINTF_ARG( spec, star, a, x ) \
+	((star) == 0 ? printf(spec, x) : (star) == 1 ? printf(spec, (int)(a)[0].i, x) : printf(spec, (int)(a)[0].i, (int)(a)[1].i, x))
+
+static void printf_record(const OS_printf_record_t *rec)
+{
+	char spec[32];
+	const char *fmt = rec->fmt;
+	const char *pos, *end;
+	const OS_printf_arg_t *a;
+	unsigned n = 0, kind, star;
+
+	while ((pos = strchr(fmt, '%')) != NULL)
+	{
+		end = printf_spec(pos + 1, &kind, &star);
+		if (kind == PRINTF_STOP || n + star + (kind != PRINTF_TEXT) > OS_PRINTF_ARGS || (size_t)(end - pos) >= sizeof(spec))
+			break;
+
+		fwrite(fmt, 1, (size_t)(pos - fmt), stdout);
+		memcpy(spec, pos, (size_t)(end - pos));
+		spec[end - pos] = '\0';
+
+		a = &rec->arg[n];
+		n += star + (kind != PRINTF_TEXT);
+
+		switch (kind)
+		{
+		case PRINTF_TEXT:    putchar('%');                                                 break;
+		case PRINTF_INT:     PRINTF_ARG(spec, star, a, (int)       a[star].i);            break;
+		case PRINTF_LONG:    PRINTF_ARG(spec, star, a, (long)      a[star].i);            break;
+		case PRINTF_LLONG:   PRINTF_ARG(spec, star, a,             a[star].i);            break;
+		case PRINTF_SIZE:    PRINTF_ARG(spec, star, a, (size_t)    a[star].i);            break;
+		case PRINTF_INTMAX:  PRINTF_ARG(spec, star, a, (intmax_t)  a[star].i);            break;
+		case PRINTF_PTRDIFF: PRINTF_ARG(spec, star, a, (ptrdiff_t) a[star].i);            break;
+		case PRINTF_DOUBLE:  PRINTF_ARG(spec, star, a,             a[star].d);            break;
+		case PRINTF_PTR:     PRINTF_ARG(spec, star, a,             a[star].p);            break;
+		}
+
+		fmt = end;
+	}
+
+	fputs(fmt, stdout);
+}
+
+static void printf_handler(void)
+{
+	OS_printf_record_t rec;
+	uint32 lost;
+
+	box_wait(printf_box, &rec);
+	printf_record(&rec);
+
+	sys_lock();
+	{
+		lost = printf_lost;
+		printf_lost = 0;
+	}
+	sys_unlock();
+
+	if (lost)
+		printf("OS_printf: %lu records lost\n", (unsigned long) lost);
+
+	fflush(stdout);
+}
+
 void OS_printf(const char *fmt, ...)
 {
 	if (printf_enabled)
 	{
+		OS_printf_record_t rec;
+		const char *pos = fmt;
+		unsigned n = 0, kind, star;
 		va_list arp;
+
+		rec.fmt = fmt;
+
 		va_start(arp, fmt);
-		printf(fmt, arp);
+		while ((pos = strchr(pos, '%')) != NULL)
+		{
+			pos = printf_spec(pos + 1, &kind, &star);
+			if (kind == PRINTF_STOP || n + star + (kind != PRINTF_TEXT) > OS_PRINTF_ARGS)
+				break;
+
+			while (star-- > 0)
+				rec.arg[n++].i = va_arg(arp, int);
+
+			switch (kind)
+			{
+			case PRINTF_INT:     rec.arg[n++].i = va_arg(arp, int);          break;
+			case PRINTF_LONG:    rec.arg[n++].i = va_arg(arp, long);         break;
+			case PRINTF_LLONG:   rec.arg[n++].i = va_arg(arp, long long);    break;
+			case PRINTF_SIZE:    rec.arg[n++].i = (long long) va_arg(arp, size_t); break;
+			case PRINTF_INTMAX:  rec.arg[n++].i = va_arg(arp, intmax_t);     break;
+			case PRINTF_PTRDIFF: rec.arg[n++].i = va_arg(arp, ptrdiff_t);    break;
+			case PRINTF_DOUBLE:  rec.arg[n++].d = va_arg(arp, double);       break;
+			case PRINTF_PTR:     rec.arg[n++].p = va_arg(arp, const void *); break;
+			}
+		}
 		va_end(arp);
+
+		sys_lock();
+		{
+			if (box_give(printf_box, &rec) != E_SUCCESS)
+				printf_lost++;
+		}
+		sys_unlock();
 	}
 }
 
+#else
+
+void OS_printf(const char *fmt, ...)
+{
+	if (printf_enabled)
+	{
+		va_list arp;
+		va_start(arp, fmt);
+		vprintf(fmt, arp);
+		va_end(arp);
+	}
+}
+
+#endif
+
 void OS_printf_disable(void)
 {
 	printf_enabled = FALSE;
@@ -145,22 +425,34 @@ int32 OS_Tick2Micros(void)
 	return 1000000 / (OS_FREQUENCY);
 }
 
+/*
+** local time is derived from the 64-bit system counter, so no periodic timer is needed
+** in tick-less mode the counter must be read (or the timer interrupt must occur) at least once per its period
+*/
+
 int32 OS_GetLocalTime(OS_time_t *time_struct)
 {
+	uint64_t ticks;
+
 	sys_lock();
 	{
-		*time_struct = localtime;
+		ticks = sys_time64() + local_offset;
 	}
 	sys_unlock();
 
+	time_struct->seconds   = (uint32)(ticks / OS_FREQUENCY);
+	time_struct->microsecs = (uint32)(ticks % OS_FREQUENCY * 1000000 / OS_FREQUENCY);
+
 	return OS_SUCCESS;
 }
 
 int32 OS_SetLocalTime(OS_time_t *time_struct)
 {
+	uint64_t ticks = (uint64_t)time_struct->seconds * OS_FREQUENCY + (uint64_t)time_struct->microsecs * OS_FREQUENCY / 1000000;
+
 	sys_lock();
 	{
-		localtime = *time_struct;
+		local_offset = ticks - sys_time64();
 	}
 	sys_unlock();
 
@@ -176,11 +468,12 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name, uint32 queue_dept
 {
 	OS_queue_record_t *rec;
 	int32 status;
+	uint32 limit;
 	void *data;
 
 	(void) flags;
 
-	sys_lock();
+	mut_wait(&OS_queue_mutex);
 	{
 		if (!queue_id || !queue_name)
 			status = OS_INVALID_POINTER;
@@ -188,12 +481,7 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name, uint32 queue_dept
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_queue_table; rec < OS_queue_table + OS_MAX_QUEUES; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, queue_name) == 0)
-						break;
-
-			if (rec < OS_queue_table + OS_MAX_QUEUES)
+			if (name_find(&OS_queue_index, queue_name) >= 0)
 				status = OS_ERR_NAME_TAKEN;
 			else
 			{
@@ -205,25 +493,29 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name, uint32 queue_dept
 					status = OS_ERR_NO_FREE_IDS;
 				else
 				{
-					data = sys_alloc(queue_depth * data_size);
+					// messages are stored with varint length prefix, only the actual payload is copied
+					limit = queue_depth * (data_size + MSG_PREFIX(msgPrefixVar, data_size));
+					data = sys_alloc(limit);
 
 					if (!data)
 						status = OS_ERROR;
 					else
 					{
 						*queue_id = rec - OS_queue_table;
-						box_init(&rec->box, queue_depth, data, data_size);
-						rec->box.res = data;
+						msg_initPrefix(&rec->msg, limit, data, msgPrefixVar);
+						rec->msg.res = data;
+						rec->size = data_size;
 						strcpy(rec->name, queue_name);
 						rec->creator = OS_TaskGetId();
 						rec->used = 1;
+						name_insert(&OS_queue_index, *queue_id);
 						status = OS_SUCCESS;
 					}
 				}
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_queue_mutex);
 
 	return status;
 }
@@ -233,7 +525,7 @@ int32 OS_QueueDelete(uint32 queue_id)
 	OS_queue_record_t *rec = &OS_queue_table[queue_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_queue_mutex);
 	{
 		if (queue_id >= OS_MAX_QUEUES)
 			status = OS_ERR_INVALID_ID;
@@ -241,12 +533,13 @@ int32 OS_QueueDelete(uint32 queue_id)
 			status = OS_INVALID_POINTER;
 		else
 		{
-			box_delete(&rec->box);
 			rec->used = 0;
+			name_remove(&OS_queue_index, queue_id);
+			msg_delete(&rec->msg);
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_queue_mutex);
 
 	return status;
 }
@@ -255,30 +548,26 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size, uint32 *size_copied,
 {
 	OS_queue_record_t *rec = &OS_queue_table[queue_id];
 	int32 status;
-
-	sys_lock();
+	uint32 len;
+
+	if (queue_id >= OS_MAX_QUEUES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else if (size < rec->size)
+		status = OS_QUEUE_INVALID_SIZE;
+	else
 	{
-		if (queue_id >= OS_MAX_QUEUES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else if (size < rec->box.size)
-			status = OS_QUEUE_INVALID_SIZE;
-		else
-		{
-			timeout = (timeout == OS_PEND)  ? (int32) INFINITE  :
-			          (timeout == OS_CHECK) ? (int32) IMMEDIATE :
-			          /* else */              (int32)(timeout * MSEC);
+		timeout = (timeout == OS_PEND)  ? (int32) INFINITE  :
+		          (timeout == OS_CHECK) ? (int32) IMMEDIATE :
+		          /* else */              (int32)(timeout * MSEC);
 
-			switch (box_waitFor(&rec->box, data, timeout))
-			{
-				case E_SUCCESS: *size_copied = rec->box.size; status = OS_SUCCESS; break;
-				case E_TIMEOUT: status = timeout ? OS_QUEUE_TIMEOUT : OS_QUEUE_EMPTY; break;
-				default:        status = OS_ERROR; break;
-			}
-		}
+		len = msg_waitFor(&rec->msg, data, size, timeout);
+
+		if (len > 0)          { *size_copied = len; status = OS_SUCCESS; }
+		else if (!rec->used)  status = OS_ERROR; // the queue has been deleted
+		else                  status = timeout ? OS_QUEUE_TIMEOUT : OS_QUEUE_EMPTY;
 	}
-	sys_unlock();
 
 	return status;
 }
@@ -290,32 +579,26 @@ int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags)
 
 	(void) flags;
 
-	sys_lock();
-	{
-		if (queue_id >= OS_MAX_QUEUES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else if (size > rec->box.size)
-			status = OS_QUEUE_INVALID_SIZE;
-		else switch (box_give(&rec->box, data))
-		{
-			case E_SUCCESS: status = OS_SUCCESS;    break;
-			case E_TIMEOUT: status = OS_QUEUE_FULL; break;
-			default:        status = OS_ERROR;      break;
-		}
-	}
-	sys_unlock();
+	if (queue_id >= OS_MAX_QUEUES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else if (size == 0 || size > rec->size)
+		status = OS_QUEUE_INVALID_SIZE;
+	else if (msg_give(&rec->msg, data, size) != size)
+		status = OS_QUEUE_FULL;
+	else
+		status = OS_SUCCESS;
 
 	return status;
 }
 
 int32 OS_QueueGetIdByName(uint32 *queue_id, const char *queue_name)
 {
-	OS_queue_record_t *rec;
+	int32 id;
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_queue_mutex);
 	{
 		if (!queue_id || !queue_name)
 			status = OS_INVALID_POINTER;
@@ -323,21 +606,18 @@ int32 OS_QueueGetIdByName(uint32 *queue_id, const char *queue_name)
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_queue_table; rec < OS_queue_table + OS_MAX_QUEUES; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, queue_name) == 0)
-						break;
+			id = name_find(&OS_queue_index, queue_name);
 
-			if (rec >= OS_queue_table + OS_MAX_QUEUES)
+			if (id < 0)
 				status = OS_ERR_NAME_NOT_FOUND;
 			else
 			{
-				*queue_id = rec - OS_queue_table;
+				*queue_id = (uint32) id;
 				status = OS_SUCCESS;
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_queue_mutex);
 
 	return status;
 }
@@ -347,7 +627,7 @@ int32 OS_QueueGetInfo(uint32 queue_id, OS_queue_prop_t *queue_prop)
 	OS_queue_record_t *rec = &OS_queue_table[queue_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_queue_mutex);
 	{
 		if (queue_id >= OS_MAX_QUEUES)
 			status = OS_ERR_INVALID_ID;
@@ -360,7 +640,7 @@ int32 OS_QueueGetInfo(uint32 queue_id, OS_queue_prop_t *queue_prop)
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_queue_mutex);
 
 	return status;
 }
@@ -377,7 +657,7 @@ int32 OS_BinSemCreate(uint32 *semaphore_id, const char *sem_name, uint32 sem_ini
 
 	(void) options;
 
-	sys_lock();
+	mut_wait(&OS_bin_sem_mutex);
 	{
 		if (!semaphore_id || !sem_name)
 			status = OS_INVALID_POINTER;
@@ -385,12 +665,7 @@ int32 OS_BinSemCreate(uint32 *semaphore_id, const char *sem_name, uint32 sem_ini
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_bin_sem_table; rec < OS_bin_sem_table + OS_MAX_BIN_SEMAPHORES; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, sem_name) == 0)
-						break;
-
-			if (rec < OS_bin_sem_table + OS_MAX_BIN_SEMAPHORES)
+			if (name_find(&OS_bin_sem_index, sem_name) >= 0)
 				status = OS_ERR_NAME_TAKEN;
 			else
 			{
@@ -407,12 +682,13 @@ int32 OS_BinSemCreate(uint32 *semaphore_id, const char *sem_name, uint32 sem_ini
 					strcpy(rec->name, sem_name);
 					rec->creator = OS_TaskGetId();
 					rec->used = 1;
+					name_insert(&OS_bin_sem_index, *semaphore_id);
 					status = OS_SUCCESS;
 				}
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_bin_sem_mutex);
 
 	return status;
 }
@@ -422,7 +698,7 @@ int32 OS_BinSemDelete(uint32 semaphore_id)
 	OS_bin_sem_record_t *rec = &OS_bin_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_bin_sem_mutex);
 	{
 		if (semaphore_id >= OS_MAX_BIN_SEMAPHORES)
 			status = OS_ERR_INVALID_ID;
@@ -430,12 +706,13 @@ int32 OS_BinSemDelete(uint32 semaphore_id)
 			status = OS_INVALID_POINTER;
 		else
 		{
-			sem_delete(&rec->sem);
 			rec->used = 0;
+			name_remove(&OS_bin_sem_index, semaphore_id);
+			sem_delete(&rec->sem);
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_bin_sem_mutex);
 
 	return status;
 }
@@ -445,19 +722,15 @@ int32 OS_BinSemFlush(uint32 semaphore_id)
 	OS_bin_sem_record_t *rec = &OS_bin_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	if (semaphore_id >= OS_MAX_BIN_SEMAPHORES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else
 	{
-		if (semaphore_id >= OS_MAX_BIN_SEMAPHORES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else
-		{
-			sem_kill(&rec->sem);
-			status = OS_SUCCESS;
-		}
+		sem_kill(&rec->sem);
+		status = OS_SUCCESS;
 	}
-	sys_unlock();
 
 	return status;
 }
@@ -467,19 +740,15 @@ int32 OS_BinSemGive(uint32 semaphore_id)
 	OS_bin_sem_record_t *rec = &OS_bin_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	if (semaphore_id >= OS_MAX_BIN_SEMAPHORES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else switch (sem_give(&rec->sem))
 	{
-		if (semaphore_id >= OS_MAX_BIN_SEMAPHORES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else switch (sem_give(&rec->sem))
-		{
-			case E_SUCCESS: status = OS_SUCCESS;     break;
-			default:        status = OS_SEM_FAILURE; break;
-		}
+		case E_SUCCESS: status = OS_SUCCESS;     break;
+		default:        status = OS_SEM_FAILURE; break;
 	}
-	sys_unlock();
 
 	return status;
 }
@@ -489,19 +758,15 @@ int32 OS_BinSemTake(uint32 semaphore_id)
 	OS_bin_sem_record_t *rec = &OS_bin_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	if (semaphore_id >= OS_MAX_BIN_SEMAPHORES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else switch (sem_wait(&rec->sem))
 	{
-		if (semaphore_id >= OS_MAX_BIN_SEMAPHORES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else switch (sem_wait(&rec->sem))
-		{
-			case E_SUCCESS: status = OS_SUCCESS;     break;
-			default:        status = OS_SEM_FAILURE; break;
-		}
+		case E_SUCCESS: status = OS_SUCCESS;     break;
+		default:        status = OS_SEM_FAILURE; break;
 	}
-	sys_unlock();
 
 	return status;
 }
@@ -511,30 +776,26 @@ int32 OS_BinSemTimedWait(uint32 semaphore_id, uint32 msecs)
 	OS_bin_sem_record_t *rec = &OS_bin_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	if (semaphore_id >= OS_MAX_BIN_SEMAPHORES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else switch (sem_waitFor(&rec->sem, msecs*MSEC))
 	{
-		if (semaphore_id >= OS_MAX_BIN_SEMAPHORES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else switch (sem_waitFor(&rec->sem, msecs*MSEC))
-		{
-			case E_SUCCESS: status = OS_SUCCESS;     break;
-			case E_TIMEOUT: status = OS_SEM_TIMEOUT; break;
-			default:        status = OS_SEM_FAILURE; break;
-		}
+		case E_SUCCESS: status = OS_SUCCESS;     break;
+		case E_TIMEOUT: status = OS_SEM_TIMEOUT; break;
+		default:        status = OS_SEM_FAILURE; break;
 	}
-	sys_unlock();
 
 	return status;
 }
 
 int32 OS_BinSemGetIdByName(uint32 *semaphore_id, const char *sem_name)
 {
-	OS_bin_sem_record_t *rec;
+	int32 id;
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_bin_sem_mutex);
 	{
 		if (!semaphore_id || !sem_name)
 			status = OS_INVALID_POINTER;
@@ -542,21 +803,18 @@ int32 OS_BinSemGetIdByName(uint32 *semaphore_id, const char *sem_name)
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_bin_sem_table; rec < OS_bin_sem_table + OS_MAX_BIN_SEMAPHORES; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, sem_name) == 0)
-						break;
+			id = name_find(&OS_bin_sem_index, sem_name);
 
-			if (rec >= OS_bin_sem_table + OS_MAX_BIN_SEMAPHORES)
+			if (id < 0)
 				status = OS_ERR_NAME_NOT_FOUND;
 			else
 			{
-				*semaphore_id = rec - OS_bin_sem_table;
+				*semaphore_id = (uint32) id;
 				status = OS_SUCCESS;
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_bin_sem_mutex);
 
 	return status;
 }
@@ -566,7 +824,7 @@ int32 OS_BinSemGetInfo(uint32 semaphore_id, OS_bin_sem_prop_t *bin_prop)
 	OS_bin_sem_record_t *rec = &OS_bin_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_bin_sem_mutex);
 	{
 		if (semaphore_id >= OS_MAX_BIN_SEMAPHORES)
 			status = OS_ERR_INVALID_ID;
@@ -580,7 +838,7 @@ int32 OS_BinSemGetInfo(uint32 semaphore_id, OS_bin_sem_prop_t *bin_prop)
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_bin_sem_mutex);
 
 	return status;
 }
@@ -594,7 +852,7 @@ int32 OS_CountSemCreate(uint32 *semaphore_id, const char *sem_name, uint32 sem_i
 
 	(void) options;
 
-	sys_lock();
+	mut_wait(&OS_count_sem_mutex);
 	{
 		if (!semaphore_id || !sem_name)
 			status = OS_INVALID_POINTER;
@@ -602,12 +860,7 @@ int32 OS_CountSemCreate(uint32 *semaphore_id, const char *sem_name, uint32 sem_i
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_count_sem_table; rec < OS_count_sem_table + OS_MAX_COUNT_SEMAPHORES; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, sem_name) == 0)
-						break;
-
-			if (rec < OS_count_sem_table + OS_MAX_COUNT_SEMAPHORES)
+			if (name_find(&OS_count_sem_index, sem_name) >= 0)
 				status = OS_ERR_NAME_TAKEN;
 			else
 			{
@@ -624,12 +877,13 @@ int32 OS_CountSemCreate(uint32 *semaphore_id, const char *sem_name, uint32 sem_i
 					strcpy(rec->name, sem_name);
 					rec->creator = OS_TaskGetId();
 					rec->used = 1;
+					name_insert(&OS_count_sem_index, *semaphore_id);
 					status = OS_SUCCESS;
 				}
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_count_sem_mutex);
 
 	return status;
 }
@@ -639,7 +893,7 @@ int32 OS_CountSemDelete(uint32 semaphore_id)
 	OS_count_sem_record_t *rec = &OS_count_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_count_sem_mutex);
 	{
 		if (semaphore_id >= OS_MAX_COUNT_SEMAPHORES)
 			status = OS_ERR_INVALID_ID;
@@ -647,12 +901,13 @@ int32 OS_CountSemDelete(uint32 semaphore_id)
 			status = OS_INVALID_POINTER;
 		else
 		{
-			sem_delete(&rec->sem);
 			rec->used = 0;
+			name_remove(&OS_count_sem_index, semaphore_id);
+			sem_delete(&rec->sem);
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_count_sem_mutex);
 
 	return status;
 }
@@ -662,19 +917,15 @@ int32 OS_CountSemGive(uint32 semaphore_id)
 	OS_count_sem_record_t *rec = &OS_count_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	if (semaphore_id >= OS_MAX_COUNT_SEMAPHORES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else switch (sem_give(&rec->sem))
 	{
-		if (semaphore_id >= OS_MAX_COUNT_SEMAPHORES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else switch (sem_give(&rec->sem))
-		{
-			case E_SUCCESS: status = OS_SUCCESS;     break;
-			default:        status = OS_SEM_FAILURE; break;
-		}
+		case E_SUCCESS: status = OS_SUCCESS;     break;
+		default:        status = OS_SEM_FAILURE; break;
 	}
-	sys_unlock();
 
 	return status;
 }
@@ -684,19 +935,15 @@ int32 OS_CountSemTake(uint32 semaphore_id)
 	OS_count_sem_record_t *rec = &OS_count_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	if (semaphore_id >= OS_MAX_COUNT_SEMAPHORES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else switch (sem_wait(&rec->sem))
 	{
-		if (semaphore_id >= OS_MAX_COUNT_SEMAPHORES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else switch (sem_wait(&rec->sem))
-		{
-			case E_SUCCESS: status = OS_SUCCESS;     break;
-			default:        status = OS_SEM_FAILURE; break;
-		}
+		case E_SUCCESS: status = OS_SUCCESS;     break;
+		default:        status = OS_SEM_FAILURE; break;
 	}
-	sys_unlock();
 
 	return status;
 }
@@ -706,30 +953,26 @@ int32 OS_CountSemTimedWait(uint32 semaphore_id, uint32 msecs)
 	OS_count_sem_record_t *rec = &OS_count_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	if (semaphore_id >= OS_MAX_COUNT_SEMAPHORES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else switch (sem_waitFor(&rec->sem, msecs*MSEC))
 	{
-		if (semaphore_id >= OS_MAX_COUNT_SEMAPHORES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else switch (sem_waitFor(&rec->sem, msecs*MSEC))
-		{
-			case E_SUCCESS: status = OS_SUCCESS;     break;
-			case E_TIMEOUT: status = OS_SEM_TIMEOUT; break;
-			default:        status = OS_SEM_FAILURE; break;
-		}
+		case E_SUCCESS: status = OS_SUCCESS;     break;
+		case E_TIMEOUT: status = OS_SEM_TIMEOUT; break;
+		default:        status = OS_SEM_FAILURE; break;
 	}
-	sys_unlock();
 
 	return status;
 }
 
 int32 OS_CountSemGetIdByName(uint32 *semaphore_id, const char *sem_name)
 {
-	OS_count_sem_record_t *rec;
+	int32 id;
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_count_sem_mutex);
 	{
 		if (!semaphore_id || !sem_name)
 			status = OS_INVALID_POINTER;
@@ -737,21 +980,18 @@ int32 OS_CountSemGetIdByName(uint32 *semaphore_id, const char *sem_name)
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_count_sem_table; rec < OS_count_sem_table + OS_MAX_COUNT_SEMAPHORES; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, sem_name) == 0)
-						break;
+			id = name_find(&OS_count_sem_index, sem_name);
 
-			if (rec >= OS_count_sem_table + OS_MAX_COUNT_SEMAPHORES)
+			if (id < 0)
 				status = OS_ERR_NAME_NOT_FOUND;
 			else
 			{
-				*semaphore_id = rec - OS_count_sem_table;
+				*semaphore_id = (uint32) id;
 				status = OS_SUCCESS;
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_count_sem_mutex);
 
 	return status;
 }
@@ -761,7 +1001,7 @@ int32 OS_CountSemGetInfo(uint32 semaphore_id, OS_count_sem_prop_t *count_prop)
 	OS_count_sem_record_t *rec = &OS_count_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_count_sem_mutex);
 	{
 		if (semaphore_id >= OS_MAX_COUNT_SEMAPHORES)
 			status = OS_ERR_INVALID_ID;
@@ -775,7 +1015,7 @@ int32 OS_CountSemGetInfo(uint32 semaphore_id, OS_count_sem_prop_t *count_prop)
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_count_sem_mutex);
 
 	return status;
 }
@@ -792,7 +1032,7 @@ int32 OS_MutSemCreate(uint32 *semaphore_id, const char *sem_name, uint32 options
 
 	(void) options;
 
-	sys_lock();
+	mut_wait(&OS_mut_sem_mutex);
 	{
 		if (!semaphore_id || !sem_name)
 			status = OS_INVALID_POINTER;
@@ -800,12 +1040,7 @@ int32 OS_MutSemCreate(uint32 *semaphore_id, const char *sem_name, uint32 options
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_mut_sem_table; rec < OS_mut_sem_table + OS_MAX_MUTEXES; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, sem_name) == 0)
-						break;
-
-			if (rec < OS_mut_sem_table + OS_MAX_MUTEXES)
+			if (name_find(&OS_mut_sem_index, sem_name) >= 0)
 				status = OS_ERR_NAME_TAKEN;
 			else
 			{
@@ -822,12 +1057,13 @@ int32 OS_MutSemCreate(uint32 *semaphore_id, const char *sem_name, uint32 options
 					strcpy(rec->name, sem_name);
 					rec->creator = OS_TaskGetId();
 					rec->used = 1;
+					name_insert(&OS_mut_sem_index, *semaphore_id);
 					status = OS_SUCCESS;
 				}
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_mut_sem_mutex);
 
 	return status;
 }
@@ -837,7 +1073,7 @@ int32 OS_MutSemDelete(uint32 semaphore_id)
 	OS_mut_sem_record_t *rec = &OS_mut_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_mut_sem_mutex);
 	{
 		if (semaphore_id >= OS_MAX_MUTEXES)
 			status = OS_ERR_INVALID_ID;
@@ -845,12 +1081,13 @@ int32 OS_MutSemDelete(uint32 semaphore_id)
 			status = OS_INVALID_POINTER;
 		else
 		{
-			mtx_delete(&rec->mtx);
 			rec->used = 0;
+			name_remove(&OS_mut_sem_index, semaphore_id);
+			mtx_delete(&rec->mtx);
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_mut_sem_mutex);
 
 	return status;
 }
@@ -860,19 +1097,15 @@ int32 OS_MutSemGive(uint32 semaphore_id)
 	OS_mut_sem_record_t *rec = &OS_mut_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	if (semaphore_id >= OS_MAX_MUTEXES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else switch (mtx_give(&rec->mtx))
 	{
-		if (semaphore_id >= OS_MAX_MUTEXES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else switch (mtx_give(&rec->mtx))
-		{
-			case E_SUCCESS: status = OS_SUCCESS;     break;
-			default:        status = OS_SEM_FAILURE; break;
-		}
+		case E_SUCCESS: status = OS_SUCCESS;     break;
+		default:        status = OS_SEM_FAILURE; break;
 	}
-	sys_unlock();
 
 	return status;
 }
@@ -882,29 +1115,25 @@ int32 OS_MutSemTake(uint32 semaphore_id)
 	OS_mut_sem_record_t *rec = &OS_mut_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	if (semaphore_id >= OS_MAX_MUTEXES)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else switch (mtx_wait(&rec->mtx))
 	{
-		if (semaphore_id >= OS_MAX_MUTEXES)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else switch (mtx_wait(&rec->mtx))
-		{
-			case E_SUCCESS: status = OS_SUCCESS;     break;
-			default:        status = OS_SEM_FAILURE; break;
-		}
+		case E_SUCCESS: status = OS_SUCCESS;     break;
+		default:        status = OS_SEM_FAILURE; break;
 	}
-	sys_unlock();
 
 	return status;
 }
 
 int32 OS_MutSemGetIdByName(uint32 *semaphore_id, const char *sem_name)
 {
-	OS_mut_sem_record_t *rec;
+	int32 id;
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_mut_sem_mutex);
 	{
 		if (!semaphore_id || !sem_name)
 			status = OS_INVALID_POINTER;
@@ -912,21 +1141,18 @@ int32 OS_MutSemGetIdByName(uint32 *semaphore_id, const char *sem_name)
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_mut_sem_table; rec < OS_mut_sem_table + OS_MAX_MUTEXES; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, sem_name) == 0)
-						break;
+			id = name_find(&OS_mut_sem_index, sem_name);
 
-			if (rec >= OS_mut_sem_table + OS_MAX_MUTEXES)
+			if (id < 0)
 				status = OS_ERR_NAME_NOT_FOUND;
 			else
 			{
-				*semaphore_id = rec - OS_mut_sem_table;
+				*semaphore_id = (uint32) id;
 				status = OS_SUCCESS;
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_mut_sem_mutex);
 
 	return status;
 }
@@ -936,7 +1162,7 @@ int32 OS_MutSemGetInfo(uint32 semaphore_id, OS_mut_sem_prop_t *mut_prop)
 	OS_mut_sem_record_t *rec = &OS_mut_sem_table[semaphore_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_mut_sem_mutex);
 	{
 		if (semaphore_id >= OS_MAX_MUTEXES)
 			status = OS_ERR_INVALID_ID;
@@ -949,7 +1175,7 @@ int32 OS_MutSemGetInfo(uint32 semaphore_id, OS_mut_sem_prop_t *mut_prop)
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_mut_sem_mutex);
 
 	return status;
 }
@@ -978,7 +1204,7 @@ int32 OS_TaskCreate(uint32 *task_id, const char *task_name, osal_task_entry func
 
 	(void) flags;
 
-	sys_lock();
+	mut_wait(&OS_task_mutex);
 	{
 		if (!task_id || !task_name || !function_pointer)
 			status = OS_INVALID_POINTER;
@@ -990,12 +1216,7 @@ int32 OS_TaskCreate(uint32 *task_id, const char *task_name, osal_task_entry func
 			status = OS_ERROR;
 		else
 		{
-			for (rec = OS_task_table; rec < OS_task_table + OS_MAX_TASKS; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, task_name) == 0)
-						break;
-
-			if (rec < OS_task_table + OS_MAX_TASKS)
+			if (name_find(&OS_task_index, task_name) >= 0)
 				status = OS_ERR_NAME_TAKEN;
 			else
 			{
@@ -1017,20 +1238,23 @@ int32 OS_TaskCreate(uint32 *task_id, const char *task_name, osal_task_entry func
 					else
 					{
 						*task_id = rec - OS_task_table;
-						tsk_init(&rec->tsk, ~priority, task_handler, stack, stack_size);
-						if (stack_pointer == 0) rec->tsk.obj.res = stack;
 						strcpy(rec->name, task_name);
 						rec->creator = OS_TaskGetId();
 						rec->used = 1;
+						name_insert(&OS_task_index, *task_id);
 						rec->handler = function_pointer;
 						rec->delete_handler = NULL;
+						sys_lock();
+						tsk_init(&rec->tsk, OS_COMPACT_TCB ? (uint8) ~priority : ~priority, task_handler, stack, stack_size);
+						if (stack_pointer == 0) rec->tsk.obj.res = stack;
+						sys_unlock();
 						status = OS_SUCCESS;
 					}
 				}
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_task_mutex);
 
 	return status;
 }
@@ -1040,7 +1264,7 @@ int32 OS_TaskDelete(uint32 task_id)
 	OS_task_record_t *rec = &OS_task_table[task_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_task_mutex);
 	{
 		if (task_id >= OS_MAX_TASKS)
 			status = OS_ERR_INVALID_ID;
@@ -1050,11 +1274,17 @@ int32 OS_TaskDelete(uint32 task_id)
 		{
 			if (rec->delete_handler)
 				rec->delete_handler();
-			tsk_delete(&rec->tsk);
 			rec->used = 0;
+			name_remove(&OS_task_index, task_id);
 			status = OS_SUCCESS;
 		}
 	}
+	sys_lock();
+	{
+		mut_give(&OS_task_mutex); // the task can delete itself
+		if (status == OS_SUCCESS)
+			tsk_delete(&rec->tsk);
+	}
 	sys_unlock();
 
 	return status;
@@ -1066,7 +1296,7 @@ int32 OS_TaskInstallDeleteHandler(void *function_pointer)
 	OS_task_record_t *rec = &OS_task_table[task_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_task_mutex);
 	{
 		if (task_id >= OS_MAX_TASKS)
 			status = OS_ERR_INVALID_ID;
@@ -1078,7 +1308,7 @@ int32 OS_TaskInstallDeleteHandler(void *function_pointer)
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_task_mutex);
 
 	return status;
 }
@@ -1102,21 +1332,19 @@ int32 OS_TaskSetPriority(uint32 task_id, uint32 new_priority)
 	OS_task_record_t *rec = &OS_task_table[task_id];
 	int32 status;
 
-	sys_lock();
+	if (task_id >= OS_MAX_TASKS)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else if ((new_priority < 1) || (new_priority > 255))
+		status = OS_ERR_INVALID_PRIORITY;
+	else
 	{
-		if (task_id >= OS_MAX_TASKS)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else if ((new_priority < 1) || (new_priority > 255))
-			status = OS_ERR_INVALID_PRIORITY;
-		else
-		{
-			core_tsk_prio(&rec->tsk, rec->tsk.basic = ~new_priority);
-			status =  OS_SUCCESS;
-		}
+		sys_lock();
+		core_tsk_prio(&rec->tsk, rec->tsk.basic = ~new_priority);
+		sys_unlock();
+		status =  OS_SUCCESS;
 	}
-	sys_unlock();
 
 	return status;
 }
@@ -1140,10 +1368,10 @@ uint32 OS_TaskGetId(void)
 
 int32 OS_TaskGetIdByName(uint32 *task_id, const char *task_name)
 {
-	OS_task_record_t *rec;
+	int32 id;
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_task_mutex);
 	{
 		if (!task_id || !task_name)
 			status = OS_INVALID_POINTER;
@@ -1151,21 +1379,18 @@ int32 OS_TaskGetIdByName(uint32 *task_id, const char *task_name)
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_task_table; rec < OS_task_table + OS_MAX_TASKS; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, task_name) == 0)
-						break;
+			id = name_find(&OS_task_index, task_name);
 
-			if (rec >= OS_task_table + OS_MAX_TASKS)
+			if (id < 0)
 				status = OS_ERR_NAME_NOT_FOUND;
 			else
 			{
-				*task_id = rec - OS_task_table;
+				*task_id = (uint32) id;
 				status = OS_SUCCESS;
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_task_mutex);
 
 	return status;
 }
@@ -1175,7 +1400,7 @@ int32 OS_TaskGetInfo(uint32 task_id, OS_task_prop_t *task_prop)
 	OS_task_record_t *rec = &OS_task_table[task_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_task_mutex);
 	{
 		if (task_id >= OS_MAX_TASKS)
 			status = OS_ERR_INVALID_ID;
@@ -1185,13 +1410,13 @@ int32 OS_TaskGetInfo(uint32 task_id, OS_task_prop_t *task_prop)
 		{
 			strcpy(task_prop->name, rec->name);
 			task_prop->creator = rec->creator;
-			task_prop->stack_size = (uint32_t) rec->tsk.top - (uint32_t) rec->tsk.stack;
-			task_prop->priority = ~rec->tsk.basic;
+			task_prop->stack_size = (uint32_t)((size_t) rec->tsk.top - (size_t) rec->tsk.stack);
+			task_prop->priority = (uint8) ~rec->tsk.basic;
 			task_prop->OStask_id = (uint32) &rec->tsk;
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_task_mutex);
 
 	return status;
 }
@@ -1287,14 +1512,24 @@ int32 OS_IntLock(void)
 
 int32 OS_IntEnable(int32 Level)
 {
+#ifdef NVIC
 	NVIC_EnableIRQ((IRQn_Type)Level);
 	return OS_SUCCESS;
+#else
+	(void) Level;
+	return OS_ERR_NOT_IMPLEMENTED;
+#endif
 }
 
 int32 OS_IntDisable(int32 Level)
 {
+#ifdef NVIC
 	NVIC_DisableIRQ((IRQn_Type)Level);
 	return OS_SUCCESS;
+#else
+	(void) Level;
+	return OS_ERR_NOT_IMPLEMENTED;
+#endif
 }
 
 int32 OS_IntSetMask(uint32 mask)
@@ -1311,52 +1546,161 @@ int32 OS_IntGetMask(uint32 *mask)
 
 int32 OS_IntAck(int32 InterruptNumber)
 {
+#ifdef NVIC
 	NVIC_ClearPendingIRQ((IRQn_Type)InterruptNumber);
 	return OS_SUCCESS;
+#else
+	(void) InterruptNumber;
+	return OS_ERR_NOT_IMPLEMENTED;
+#endif
 }
 
 /* -------------------------------------------------------------------------- */
 /*
 ** Shared memory API
+** segments are allocated on the system heap and never released;
+** the address returned by OS_ShMemAttach is shared by all tasks, so data is exchanged by reference
 */
 
 int32 OS_ShMemInit(void)
 {
-	return OS_ERR_NOT_IMPLEMENTED;
+	return OS_SUCCESS;
 }
 
 int32 OS_ShMemCreate(uint32 *Id, uint32 NBytes, char *SegName)
 {
-	(void) Id;
-	(void) NBytes;
-	(void) SegName;
-	return OS_ERR_NOT_IMPLEMENTED;
+	OS_shmem_record_t *rec;
+	int32 status;
+
+	mut_wait(&OS_shmem_mutex);
+	{
+		if (!Id || !SegName)
+			status = OS_INVALID_POINTER;
+		else if (strlen(SegName) >= OS_MAX_API_NAME)
+			status = OS_ERR_NAME_TOO_LONG;
+		else if (NBytes == 0)
+			status = OS_ERROR;
+		else
+		{
+			if (name_find(&OS_shmem_index, SegName) >= 0)
+				status = OS_ERR_NAME_TAKEN;
+			else
+			{
+				for (rec = OS_shmem_table; rec < OS_shmem_table + OS_MAX_SHMEM_SEGMENTS; rec++)
+					if (rec->used == 0)
+						break;
+
+				if (rec >= OS_shmem_table + OS_MAX_SHMEM_SEGMENTS)
+					status = OS_ERR_NO_FREE_IDS;
+				else
+				{
+					rec->data = sys_alloc(NBytes);
+
+					if (rec->data == NULL)
+						status = OS_ERROR;
+					else
+					{
+						*Id = rec - OS_shmem_table;
+						mtx_init(&rec->mtx);
+						strcpy(rec->name, SegName);
+						rec->size = NBytes;
+						rec->creator = OS_TaskGetId();
+						rec->used = 1;
+						name_insert(&OS_shmem_index, *Id);
+						status = OS_SUCCESS;
+					}
+				}
+			}
+		}
+	}
+	mut_give(&OS_shmem_mutex);
+
+	return status;
 }
 
 int32 OS_ShMemSemTake(uint32 Id)
 {
-	(void) Id;
-	return OS_ERR_NOT_IMPLEMENTED;
+	OS_shmem_record_t *rec = &OS_shmem_table[Id];
+	int32 status;
+
+	if (Id >= OS_MAX_SHMEM_SEGMENTS)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else switch (mtx_wait(&rec->mtx))
+	{
+		case E_SUCCESS: status = OS_SUCCESS;     break;
+		default:        status = OS_SEM_FAILURE; break;
+	}
+
+	return status;
 }
 
 int32 OS_ShMemSemGive(uint32 Id)
 {
-	(void) Id;
-	return OS_ERR_NOT_IMPLEMENTED;
+	OS_shmem_record_t *rec = &OS_shmem_table[Id];
+	int32 status;
+
+	if (Id >= OS_MAX_SHMEM_SEGMENTS)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else switch (mtx_give(&rec->mtx))
+	{
+		case E_SUCCESS: status = OS_SUCCESS;     break;
+		default:        status = OS_SEM_FAILURE; break;
+	}
+
+	return status;
 }
 
 int32 OS_ShMemAttach(uint32 *Address, uint32 Id)
 {
-	(void) Address;
-	(void) Id;
-	return OS_ERR_NOT_IMPLEMENTED;
+	OS_shmem_record_t *rec = &OS_shmem_table[Id];
+	int32 status;
+
+	if (Address == NULL)
+		status = OS_INVALID_POINTER;
+	else if (Id >= OS_MAX_SHMEM_SEGMENTS)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else
+	{
+		*Address = (uint32)(cpuaddr) rec->data; // the API holds addresses in 32 bits
+		status = OS_SUCCESS;
+	}
+
+	return status;
 }
 
 int32 OS_ShMemGetIdByName(uint32 *ShMemId, const char *SegName)
 {
-	(void) ShMemId;
-	(void) SegName;
-	return OS_ERR_NOT_IMPLEMENTED;
+	int32 id;
+	int32 status;
+
+	mut_wait(&OS_shmem_mutex);
+	{
+		if (!ShMemId || !SegName)
+			status = OS_INVALID_POINTER;
+		else if (strlen(SegName) >= OS_MAX_API_NAME)
+			status = OS_ERR_NAME_TOO_LONG;
+		else
+		{
+			id = name_find(&OS_shmem_index, SegName);
+
+			if (id < 0)
+				status = OS_ERR_NAME_NOT_FOUND;
+			else
+			{
+				*ShMemId = (uint32) id;
+				status = OS_SUCCESS;
+			}
+		}
+	}
+	mut_give(&OS_shmem_mutex);
+
+	return status;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1366,8 +1710,18 @@ int32 OS_ShMemGetIdByName(uint32 *ShMemId, const char *SegName)
 
 int32 OS_HeapGetInfo(OS_heap_prop_t *heap_prop)
 {
-	(void) heap_prop;
-	return OS_ERR_NOT_IMPLEMENTED;
+	hst_t info;
+
+	if (heap_prop == NULL)
+		return OS_INVALID_POINTER;
+
+	sys_heapInfo(&info);
+
+	heap_prop->free_bytes         = info.free;
+	heap_prop->free_blocks        = info.blocks;
+	heap_prop->largest_free_block = info.largest;
+
+	return OS_SUCCESS;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -1412,11 +1766,7 @@ int32 OS_GetErrorName(int32 error_num, os_err_name_t *err_name)
         default: return OS_ERROR;
     }
 
-	sys_lock();
-	{
-	    strcpy((char *) err_name, error);
-	}
-	sys_unlock();
+	strcpy((char *) err_name, error);
 
     return OS_SUCCESS;
 }
@@ -1426,13 +1776,11 @@ int32 OS_GetErrorName(int32 error_num, os_err_name_t *err_name)
 ** Timer API
 */
 
-static void timer_handler(void)
+static void timer_handler(void *arg)
 {
-	void *tmp = tmr_thisISR(); // because of COSMIC compiler
-	OS_timer_record_t *rec = tmp;
-	uint32 timer_id = rec - OS_timer_table;
+	OS_timer_record_t *rec = arg;
 
-	rec->handler(timer_id);
+	rec->handler(rec - OS_timer_table);
 }
 
 int32 OS_TimerAPIInit(void)
@@ -1445,7 +1793,7 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name, uint32 *clock_acc
 	OS_timer_record_t *rec;
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_timer_mutex);
 	{
 		if (!timer_id || !timer_name || !callback_ptr)
 			status = OS_INVALID_POINTER;
@@ -1453,12 +1801,7 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name, uint32 *clock_acc
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_timer_table; rec < OS_timer_table + OS_MAX_TIMERS; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, timer_name) == 0)
-						break;
-
-			if (rec < OS_timer_table + OS_MAX_TIMERS)
+			if (name_find(&OS_timer_index, timer_name) >= 0)
 				status = OS_ERR_NAME_TAKEN;
 			else
 			{
@@ -1474,17 +1817,18 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name, uint32 *clock_acc
 						*clock_accuracy = 1000000 / (OS_FREQUENCY);
 
 					*timer_id = rec - OS_timer_table;
-					tmr_init(&rec->tmr, timer_handler);
+					tmr_initArg(&rec->tmr, timer_handler, rec);
 					strcpy(rec->name, timer_name);
 					rec->creator = OS_TaskGetId();
 					rec->used = 1;
+					name_insert(&OS_timer_index, *timer_id);
 					rec->handler = callback_ptr;
 					status = OS_SUCCESS;
 				}
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_timer_mutex);
 
 	return status;
 }
@@ -1494,19 +1838,15 @@ int32 OS_TimerSet(uint32 timer_id, uint32 start_msec, uint32 interval_msec)
 	OS_timer_record_t *rec = &OS_timer_table[timer_id];
 	int32 status;
 
-	sys_lock();
+	if (timer_id >= OS_MAX_TIMERS)
+		status = OS_ERR_INVALID_ID;
+	else if (rec->used == 0)
+		status = OS_INVALID_POINTER;
+	else
 	{
-		if (timer_id >= OS_MAX_TIMERS)
-			status = OS_ERR_INVALID_ID;
-		else if (rec->used == 0)
-			status = OS_INVALID_POINTER;
-		else
-		{
-			tmr_start(&rec->tmr, start_msec * MSEC, interval_msec * MSEC);
-			status = OS_SUCCESS;
-		}
+		tmr_start(&rec->tmr, start_msec * MSEC, interval_msec * MSEC);
+		status = OS_SUCCESS;
 	}
-	sys_unlock();
 
 	return status;
 }
@@ -1516,7 +1856,7 @@ int32 OS_TimerDelete(uint32 timer_id)
 	OS_timer_record_t *rec = &OS_timer_table[timer_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_timer_mutex);
 	{
 		if (timer_id >= OS_MAX_TIMERS)
 			status = OS_ERR_INVALID_ID;
@@ -1524,22 +1864,23 @@ int32 OS_TimerDelete(uint32 timer_id)
 			status = OS_INVALID_POINTER;
 		else
 		{
-			tmr_delete(&rec->tmr);
 			rec->used = 0;
+			name_remove(&OS_timer_index, timer_id);
+			tmr_delete(&rec->tmr);
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_timer_mutex);
 
 	return status;
 }
 
 int32 OS_TimerGetIdByName(uint32 *timer_id, const char *timer_name)
 {
-	OS_timer_record_t *rec;
+	int32 id;
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_timer_mutex);
 	{
 		if (!timer_id || !timer_name)
 			status = OS_INVALID_POINTER;
@@ -1547,21 +1888,18 @@ int32 OS_TimerGetIdByName(uint32 *timer_id, const char *timer_name)
 			status = OS_ERR_NAME_TOO_LONG;
 		else
 		{
-			for (rec = OS_timer_table; rec < OS_timer_table + OS_MAX_TIMERS; rec++)
-				if (rec->used)
-					if (strcmp(rec->name, timer_name) == 0)
-						break;
+			id = name_find(&OS_timer_index, timer_name);
 
-			if (rec >= OS_timer_table + OS_MAX_TIMERS)
+			if (id < 0)
 				status = OS_ERR_NAME_NOT_FOUND;
 			else
 			{
-				*timer_id = rec - OS_timer_table;
+				*timer_id = (uint32) id;
 				status = OS_SUCCESS;
 			}
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_timer_mutex);
 
 	return status;
 }
@@ -1571,7 +1909,7 @@ int32 OS_TimerGetInfo(uint32 timer_id, OS_timer_prop_t *timer_prop)
 	OS_timer_record_t *rec = &OS_timer_table[timer_id];
 	int32 status;
 
-	sys_lock();
+	mut_wait(&OS_timer_mutex);
 	{
 		if (timer_id >= OS_MAX_TIMERS)
 			status = OS_ERR_INVALID_ID;
@@ -1587,7 +1925,7 @@ int32 OS_TimerGetInfo(uint32 timer_id, OS_timer_prop_t *timer_prop)
 			status = OS_SUCCESS;
 		}
 	}
-	sys_unlock();
+	mut_give(&OS_timer_mutex);
 
 	return status;
 }
@@ -129,7 +129,7 @@
 ** Include the OS API modules
 */
 #include "osapi-os-core.h"
-// #include "osapi-os-filesys.h"
+#include "osapi-os-filesys.h"
 // #include "osapi-os-net.h"
 // #include "osapi-os-loader.h"
 #include "osapi-os-timer.h"
@@ -0,0 +1,1931 @@
+/******************************************************************************
+
+    @file    StateOS: osfileapi.c
+    @author  Rajmund Szymanski
+    @date    16.07.2018
+    @brief   NASA OSAPI file system implementation for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include <string.h>
+#include <osnasa.h>
+
+/*
+** layout of a volume: superblock (block 0), allocation table, directory, data blocks
+** every entry of the allocation table holds the next block of the file chain (OS_FS_FREE: free block),
+** the directory is one flat table of entries named with the full path inside the volume
+** all the metadata and data blocks are accessed through the block cache; the values are stored in native byte order
+*/
+#define OS_FS_MAGIC          0x534F4653U // 'SOFS'
+#define OS_FS_FREE           0x00000000U // free block / empty file chain
+#define OS_FS_LAST           0xFFFFFFFFU // last block of the file chain
+#define OS_FS_NONE           0xFFFFFFFFU // no block / no request
+#define OS_FS_NAME_LEN       48
+
+#define OS_FS_ATTR_FILE      0x01U
+#define OS_FS_ATTR_DIR       0x02U
+#define OS_FS_ATTR_RDONLY    0x04U
+
+typedef struct
+{
+	uint32 magic;
+	uint32 block_size;
+	uint32 num_blocks;
+	uint32 fat_start;
+	uint32 dir_start;
+	uint32 dir_entries;
+	uint32 data_start;
+}	OS_fs_super_t;
+
+typedef struct
+{
+	char   name [OS_FS_NAME_LEN]; // path inside the volume, empty: free entry
+	uint32 first;                 // first block of the file chain
+	uint32 size;
+	uint32 attr;
+	int32  time;
+}	OS_fs_entry_t;
+
+typedef struct
+{
+	uint32 vol;
+	uint32 block;  // block to prefetch (OS_FS_NONE: write back request)
+}	OS_fs_request_t;
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_FS_CACHE_BLOCKS < 2
+#error OS_FS_CACHE_BLOCKS must be at least 2
+#endif
+
+static OS_volume_record_t OS_volume_table[NUM_TABLE_ENTRIES];
+static OS_file_record_t   OS_file_table  [OS_MAX_NUM_OPEN_FILES];
+static OS_dir_record_t    OS_dir_table   [OS_MAX_NUM_OPEN_DIRS];
+static OS_cache_record_t  OS_cache_table [OS_FS_CACHE_BLOCKS];
+
+/*
+** block device transfers are performed with the file system mutex locked,
+** so the mutex must support priority inheritance (the flush task has the lowest priority)
+*/
+static mtx_t              OS_fs_mutex   = MTX_INIT();
+
+static uint32             OS_cache_clock = 0; // LRU time stamps
+static uint32             OS_cache_dirty = 0; // number of dirty cache blocks
+
+static void fs_handler(void);
+static_TSK(fs_task, 1, fs_handler);
+static_BOX(fs_box, OS_FS_CACHE_BLOCKS, sizeof(OS_fs_request_t));
+
+/* -------------------------------------------------------------------------- */
+/*
+** block devices
+*/
+
+static int32 blk_read(OS_volume_record_t *vol, uint32 block, void *data)
+{
+	if (vol->dev)
+		return vol->dev->read(vol->dev->ctx, block, data);
+
+	memcpy(data, vol->address + block * vol->block_size, vol->block_size);
+	return OS_FS_SUCCESS;
+}
+
+static int32 blk_write(OS_volume_record_t *vol, uint32 block, const void *data)
+{
+	vol->written = 1;
+
+	if (vol->dev)
+		return vol->dev->write(vol->dev->ctx, block, data);
+
+	memcpy(vol->address + block * vol->block_size, data, vol->block_size);
+	return OS_FS_SUCCESS;
+}
+
+static int32 blk_sync(OS_volume_record_t *vol)
+{
+	if (vol->written == 0)
+		return OS_FS_SUCCESS;
+
+	vol->written = 0;
+
+	if (vol->dev && vol->dev->sync)
+		return vol->dev->sync(vol->dev->ctx);
+
+	return OS_FS_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+** block cache
+*/
+
+static OS_cache_record_t *cache_find(uint32 v, uint32 block)
+{
+	OS_cache_record_t *rec;
+
+	for (rec = OS_cache_table; rec < OS_cache_table + OS_FS_CACHE_BLOCKS; rec++)
+		if (rec->vol == v + 1 && rec->block == block)
+			return rec;
+
+	return NULL;
+}
+
+static int32 cache_write(OS_cache_record_t *rec)
+{
+	if (blk_write(&OS_volume_table[rec->vol - 1], rec->block, rec->data) != OS_FS_SUCCESS)
+		return OS_FS_ERROR;
+
+	rec->dirty = 0;
+	OS_cache_dirty--;
+	return OS_FS_SUCCESS;
+}
+
+/*
+** return the cache block of the volume block, read it from the device if 'read' is set,
+** otherwise the block is cleared; the least recently used cache block is reused (written back if dirty)
+** the returned block stays valid until the next but one call of cache_get
+*/
+static OS_cache_record_t *cache_get(uint32 v, uint32 block, int read)
+{
+	OS_cache_record_t *rec = cache_find(v, block);
+
+	if (!rec)
+	{
+		OS_cache_record_t *tmp;
+
+		for (rec = tmp = OS_cache_table; tmp < OS_cache_table + OS_FS_CACHE_BLOCKS && rec->vol != 0; tmp++)
+			if (tmp->vol == 0 || (int32)(tmp->stamp - rec->stamp) < 0)
+				rec = tmp;
+
+		if (rec->dirty && cache_write(rec) != OS_FS_SUCCESS)
+			return NULL;
+
+		rec->vol = 0;
+
+		if (read && blk_read(&OS_volume_table[v], block, rec->data) != OS_FS_SUCCESS)
+			return NULL;
+
+		rec->vol = v + 1;
+		rec->block = block;
+	}
+
+	if (!read)
+		memset(rec->data, 0, sizeof(rec->data));
+
+	rec->stamp = ++OS_cache_clock;
+	return rec;
+}
+
+static void cache_dirty(OS_cache_record_t *rec)
+{
+	static const OS_fs_request_t req = { 0, OS_FS_NONE };
+
+	if (rec->dirty == 0)
+	{
+		rec->dirty = 1;
+		if (++OS_cache_dirty == OS_FS_CACHE_BLOCKS / 2 + 1)
+			box_give(fs_box, &req); // wake up the flush task
+	}
+}
+
+/*
+** write back the dirty blocks of the volume and sync the device
+*/
+static int32 cache_sync(uint32 v)
+{
+	OS_cache_record_t *rec;
+	int32 status = OS_FS_SUCCESS;
+
+	for (rec = OS_cache_table; rec < OS_cache_table + OS_FS_CACHE_BLOCKS; rec++)
+		if (rec->vol == v + 1 && rec->dirty && cache_write(rec) != OS_FS_SUCCESS)
+			status = OS_FS_ERROR;
+
+	if (blk_sync(&OS_volume_table[v]) != OS_FS_SUCCESS)
+		status = OS_FS_ERROR;
+
+	return status;
+}
+
+/*
+** discard the cached blocks of the volume
+*/
+static void cache_drop(uint32 v)
+{
+	OS_cache_record_t *rec;
+
+	for (rec = OS_cache_table; rec < OS_cache_table + OS_FS_CACHE_BLOCKS; rec++)
+	{
+		if (rec->vol == v + 1)
+		{
+			if (rec->dirty)
+				OS_cache_dirty--;
+			rec->vol = 0;
+			rec->dirty = 0;
+		}
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+** allocation table
+*/
+
+static int32 fat_get(uint32 v, uint32 block, uint32 *next)
+{
+	OS_volume_record_t *vol = &OS_volume_table[v];
+	uint32 cnt = vol->block_size / sizeof(uint32);
+	OS_cache_record_t *rec = cache_get(v, vol->fat_start + block / cnt, TRUE);
+
+	if (!rec)
+		return OS_FS_ERROR;
+
+	*next = rec->data[block % cnt];
+	return OS_FS_SUCCESS;
+}
+
+static int32 fat_set(uint32 v, uint32 block, uint32 next)
+{
+	OS_volume_record_t *vol = &OS_volume_table[v];
+	uint32 cnt = vol->block_size / sizeof(uint32);
+	OS_cache_record_t *rec = cache_get(v, vol->fat_start + block / cnt, TRUE);
+
+	if (!rec)
+		return OS_FS_ERROR;
+
+	rec->data[block % cnt] = next;
+	cache_dirty(rec);
+	return OS_FS_SUCCESS;
+}
+
+/*
+** check the next block of the file chain read from the allocation table
+*/
+static int fat_valid(OS_volume_record_t *vol, uint32 block)
+{
+	return block >= vol->data_start && block < vol->num_blocks;
+}
+
+/*
+** allocate a cleared block as the last block of a file chain
+*/
+static int32 fat_alloc(uint32 v, uint32 *block)
+{
+	OS_volume_record_t *vol = &OS_volume_table[v];
+	OS_cache_record_t *rec;
+	uint32 cnt, blk, next;
+
+	for (cnt = vol->free ? vol->num_blocks - vol->data_start : 0; cnt > 0; cnt--)
+	{
+		blk = vol->hint;
+		if (++vol->hint >= vol->num_blocks)
+			vol->hint = vol->data_start;
+
+		if (fat_get(v, blk, &next) != OS_FS_SUCCESS)
+			return OS_FS_ERROR;
+
+		if (next == OS_FS_FREE)
+		{
+			if (fat_set(v, blk, OS_FS_LAST) != OS_FS_SUCCESS || (rec = cache_get(v, blk, FALSE)) == NULL)
+				return OS_FS_ERROR;
+
+			cache_dirty(rec);
+			vol->free--;
+			*block = blk;
+			return OS_FS_SUCCESS;
+		}
+	}
+
+	return OS_FS_ERROR;
+}
+
+/*
+** release the file chain starting with the block
+*/
+static int32 fat_release(uint32 v, uint32 block)
+{
+	OS_volume_record_t *vol = &OS_volume_table[v];
+	uint32 next;
+
+	for (; block != OS_FS_FREE && block != OS_FS_LAST; block = next)
+	{
+		if (!fat_valid(vol, block) || fat_get(v, block, &next) != OS_FS_SUCCESS || fat_set(v, block, OS_FS_FREE) != OS_FS_SUCCESS)
+			return OS_FS_ERROR;
+		vol->free++;
+	}
+
+	return OS_FS_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+** directory
+*/
+
+/*
+** return the directory entry, the cache block is marked dirty if 'dirty' is set
+** the returned entry stays valid until the next but one call of cache_get
+*/
+static OS_fs_entry_t *dir_entry(uint32 v, uint32 entry, int dirty)
+{
+	OS_volume_record_t *vol = &OS_volume_table[v];
+	uint32 cnt = vol->block_size / sizeof(OS_fs_entry_t);
+	OS_cache_record_t *rec = cache_get(v, vol->dir_start + entry / cnt, TRUE);
+
+	if (!rec)
+		return NULL;
+
+	if (dirty)
+		cache_dirty(rec);
+
+	return (OS_fs_entry_t *) rec->data + entry % cnt;
+}
+
+/*
+** find the directory entry of the name (empty name: free entry)
+*/
+static int32 dir_find(uint32 v, const char *name, uint32 *entry)
+{
+	OS_fs_entry_t *ent;
+	uint32 i;
+
+	for (i = 0; i < OS_volume_table[v].dir_entries; i++)
+	{
+		if ((ent = dir_entry(v, i, FALSE)) == NULL)
+			return OS_FS_ERROR;
+
+		if (strcmp(ent->name, name) == 0)
+		{
+			*entry = i;
+			return OS_FS_SUCCESS;
+		}
+	}
+
+	return OS_FS_ERROR;
+}
+
+/*
+** check if the entry is an object of the directory 'name' (empty name: root directory)
+*/
+static int dir_child(const char *entry, const char *name)
+{
+	size_t len = strlen(name);
+
+	if (entry[0] == 0)
+		return FALSE;
+
+	if (len > 0)
+	{
+		if (strncmp(entry, name, len) != 0 || entry[len] != '/')
+			return FALSE;
+		entry += len + 1;
+	}
+
+	return strchr(entry, '/') == NULL;
+}
+
+/*
+** check if the directory is empty
+*/
+static int32 dir_empty(uint32 v, const char *name)
+{
+	OS_fs_entry_t *ent;
+	uint32 i;
+
+	for (i = 0; i < OS_volume_table[v].dir_entries; i++)
+	{
+		if ((ent = dir_entry(v, i, FALSE)) == NULL)
+			return OS_FS_ERROR;
+
+		if (dir_child(ent->name, name))
+			return OS_FS_ERROR;
+	}
+
+	return OS_FS_SUCCESS;
+}
+
+/*
+** check if the parent directory of the name exists
+*/
+static int32 dir_parent(uint32 v, const char *name)
+{
+	const char *sep = strrchr(name, '/');
+	char parent[OS_FS_NAME_LEN];
+	OS_fs_entry_t *ent;
+	uint32 entry;
+
+	if (sep == NULL)
+		return OS_FS_SUCCESS;
+
+	memcpy(parent, name, sep - name);
+	parent[sep - name] = 0;
+
+	if (dir_find(v, parent, &entry) != OS_FS_SUCCESS || (ent = dir_entry(v, entry, FALSE)) == NULL)
+		return OS_FS_ERROR;
+
+	return (ent->attr & OS_FS_ATTR_DIR) ? OS_FS_SUCCESS : OS_FS_ERROR;
+}
+
+/*
+** create the directory entry of the name
+*/
+static int32 dir_create(uint32 v, const char *name, uint32 attr, uint32 *entry)
+{
+	OS_fs_entry_t *ent;
+	OS_time_t now;
+
+	if (dir_parent(v, name) != OS_FS_SUCCESS || dir_find(v, "", entry) != OS_FS_SUCCESS)
+		return OS_FS_ERROR;
+
+	if ((ent = dir_entry(v, *entry, TRUE)) == NULL)
+		return OS_FS_ERROR;
+
+	OS_GetLocalTime(&now);
+	strcpy(ent->name, name);
+	ent->first = OS_FS_FREE;
+	ent->size = 0;
+	ent->attr = attr;
+	ent->time = (int32) now.seconds;
+	return OS_FS_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+** volumes and paths
+*/
+
+static OS_volume_record_t *vol_find(const char *devname)
+{
+	OS_volume_record_t *vol;
+
+	for (vol = OS_volume_table; vol < OS_volume_table + NUM_TABLE_ENTRIES; vol++)
+		if (vol->used && strcmp(vol->devname, devname) == 0)
+			return vol;
+
+	return NULL;
+}
+
+static OS_volume_record_t *vol_alloc(const char *devname)
+{
+	OS_volume_record_t *vol;
+
+	for (vol = OS_volume_table; vol < OS_volume_table + NUM_TABLE_ENTRIES; vol++)
+	{
+		if (vol->used == 0)
+		{
+			memset(vol, 0, sizeof(*vol));
+			strcpy(vol->devname, devname);
+			vol->used = 1;
+			return vol;
+		}
+	}
+
+	return NULL;
+}
+
+static int vol_busy(uint32 v)
+{
+	uint32 i;
+
+	for (i = 0; i < OS_MAX_NUM_OPEN_FILES; i++)
+		if (OS_file_table[i].used && OS_file_table[i].vol == v)
+			return TRUE;
+
+	for (i = 0; i < OS_MAX_NUM_OPEN_DIRS; i++)
+		if (OS_dir_table[i].used && OS_dir_table[i].vol == v)
+			return TRUE;
+
+	return FALSE;
+}
+
+/*
+** set the geometry of the volume
+*/
+static int32 vol_geometry(OS_volume_record_t *vol, uint32 blocksize, uint32 numblocks)
+{
+	uint32 fat_blocks = (numblocks * sizeof(uint32) + blocksize - 1) / blocksize;
+	uint32 dir_blocks = (OS_FS_DIR_ENTRIES * sizeof(OS_fs_entry_t) + blocksize - 1) / blocksize;
+
+	if (blocksize < 2 * sizeof(OS_fs_entry_t) || blocksize > OS_FS_BLOCK_SIZE || blocksize % sizeof(OS_fs_entry_t) != 0)
+		return OS_FS_ERROR;
+
+	if (numblocks == 0 || numblocks > UINT32_MAX / sizeof(uint32) || numblocks <= 1 + fat_blocks + dir_blocks)
+		return OS_FS_ERROR;
+
+	vol->block_size  = blocksize;
+	vol->num_blocks  = numblocks;
+	vol->fat_start   = 1;
+	vol->dir_start   = 1 + fat_blocks;
+	vol->dir_entries = dir_blocks * (blocksize / sizeof(OS_fs_entry_t));
+	vol->data_start  = 1 + fat_blocks + dir_blocks;
+	vol->hint        = vol->data_start;
+	return OS_FS_SUCCESS;
+}
+
+/*
+** format the volume
+*/
+static int32 vol_format(uint32 v, uint32 blocksize, uint32 numblocks)
+{
+	OS_volume_record_t *vol = &OS_volume_table[v];
+	OS_cache_record_t *rec;
+	OS_fs_super_t *sup;
+	uint32 blk;
+
+	vol->ready = 0;
+	cache_drop(v);
+
+	if (vol_geometry(vol, blocksize, numblocks) != OS_FS_SUCCESS)
+		return OS_FS_ERROR;
+
+	for (blk = vol->data_start; blk-- > 0; )
+	{
+		if ((rec = cache_get(v, blk, FALSE)) == NULL)
+			return OS_FS_ERROR;
+
+		cache_dirty(rec);
+	}
+
+	if ((rec = cache_get(v, 0, FALSE)) == NULL)
+		return OS_FS_ERROR;
+
+	sup = (OS_fs_super_t *) rec->data;
+	sup->magic       = OS_FS_MAGIC;
+	sup->block_size  = vol->block_size;
+	sup->num_blocks  = vol->num_blocks;
+	sup->fat_start   = vol->fat_start;
+	sup->dir_start   = vol->dir_start;
+	sup->dir_entries = vol->dir_entries;
+	sup->data_start  = vol->data_start;
+
+	for (blk = 0; blk < vol->data_start; blk++)
+		if (fat_set(v, blk, OS_FS_LAST) != OS_FS_SUCCESS)
+			return OS_FS_ERROR;
+
+	vol->free = vol->num_blocks - vol->data_start;
+
+	if (cache_sync(v) != OS_FS_SUCCESS)
+		return OS_FS_ERROR;
+
+	vol->ready = 1;
+	return OS_FS_SUCCESS;
+}
+
+/*
+** load the formatted volume and count its free blocks
+*/
+static int32 vol_load(uint32 v, uint32 blocksize, uint32 numblocks)
+{
+	OS_volume_record_t *vol = &OS_volume_table[v];
+	OS_cache_record_t *rec;
+	OS_fs_super_t *sup;
+	uint32 blk, next;
+
+	vol->ready = 0;
+	cache_drop(v);
+
+	if (vol_geometry(vol, blocksize, numblocks) != OS_FS_SUCCESS || (rec = cache_get(v, 0, TRUE)) == NULL)
+		return OS_FS_ERROR;
+
+	sup = (OS_fs_super_t *) rec->data;
+	if (sup->magic      != OS_FS_MAGIC     ||
+	    sup->block_size != vol->block_size ||
+	    sup->num_blocks != vol->num_blocks ||
+	    sup->fat_start  != vol->fat_start  ||
+	    sup->dir_start  != vol->dir_start  ||
+	    sup->data_start <= sup->dir_start  ||
+	    sup->data_start >= sup->num_blocks ||
+	    sup->dir_entries > (sup->data_start - sup->dir_start) * (blocksize / sizeof(OS_fs_entry_t)))
+		return OS_FS_ERROR;
+
+	// the directory size is taken from the volume, it might have been formatted with another OS_FS_DIR_ENTRIES
+	vol->dir_entries = sup->dir_entries;
+	vol->data_start  = sup->data_start;
+	vol->hint        = sup->data_start;
+
+	for (vol->free = 0, blk = vol->data_start; blk < vol->num_blocks; blk++)
+	{
+		if (fat_get(v, blk, &next) != OS_FS_SUCCESS)
+			return OS_FS_ERROR;
+
+		if (next == OS_FS_FREE)
+			vol->free++;
+	}
+
+	vol->ready = 1;
+	return OS_FS_SUCCESS;
+}
+
+/*
+** find the mounted volume of the absolute path and copy the path inside the volume to 'name'
+*/
+static int32 path_resolve(const char *path, uint32 *v, char *name)
+{
+	OS_volume_record_t *vol, *found = NULL;
+	size_t len = 0, cnt;
+	char *dst;
+
+	if (!path)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	if (strlen(path) >= OS_MAX_PATH_LEN)
+		return OS_FS_ERR_PATH_TOO_LONG;
+
+	if (path[0] != '/')
+		return OS_FS_ERR_PATH_INVALID;
+
+	for (vol = OS_volume_table; vol < OS_volume_table + NUM_TABLE_ENTRIES; vol++)
+	{
+		if (vol->mounted)
+		{
+			cnt = strlen(vol->mountpoint);
+			if (cnt >= len && strncmp(path, vol->mountpoint, cnt) == 0 && (path[cnt] == '/' || path[cnt] == 0))
+			{
+				found = vol;
+				len = cnt;
+			}
+		}
+	}
+
+	if (!found)
+		return OS_FS_ERR_PATH_INVALID;
+
+	*v = found - OS_volume_table;
+
+	for (path += len, dst = name; ; path += cnt)
+	{
+		while (*path == '/')
+			path++;
+
+		if (*path == 0)
+			break;
+
+		for (cnt = 0; path[cnt] != '/' && path[cnt] != 0; cnt++);
+
+		if (cnt > OS_MAX_FILE_NAME)
+			return OS_FS_ERR_NAME_TOO_LONG;
+
+		if (path[0] == '.' && (cnt == 1 || (cnt == 2 && path[1] == '.')))
+			return OS_FS_ERR_PATH_INVALID;
+
+		if ((size_t)(dst - name) + (dst > name) + cnt >= OS_FS_NAME_LEN)
+			return OS_FS_ERR_PATH_TOO_LONG;
+
+		if (dst > name)
+			*dst++ = '/';
+
+		memcpy(dst, path, cnt);
+		dst += cnt;
+	}
+
+	*dst = 0;
+	return OS_FS_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+** open files
+*/
+
+static OS_file_record_t *file_get(int32 filedes)
+{
+	if (filedes < 0 || filedes >= OS_MAX_NUM_OPEN_FILES || OS_file_table[filedes].used == 0)
+		return NULL;
+
+	return &OS_file_table[filedes];
+}
+
+static int32 file_alloc(void)
+{
+	int32 filedes;
+
+	for (filedes = 0; filedes < OS_MAX_NUM_OPEN_FILES; filedes++)
+		if (OS_file_table[filedes].used == 0)
+			return filedes;
+
+	return OS_FS_ERR_NO_FREE_FDS;
+}
+
+static int32 file_open(int32 filedes, uint32 v, uint32 entry, const char *path, int32 access)
+{
+	OS_file_record_t *rec = &OS_file_table[filedes];
+
+	memset(rec, 0, sizeof(*rec));
+	strcpy(rec->path, path);
+	rec->user   = OS_TaskGetId();
+	rec->access = access;
+	rec->vol    = v;
+	rec->entry  = entry;
+	rec->index  = OS_FS_NONE;
+	rec->used   = 1;
+
+	return filedes;
+}
+
+/*
+** check if the directory entry is opened
+*/
+static int file_busy(uint32 v, uint32 entry)
+{
+	OS_file_record_t *rec;
+
+	for (rec = OS_file_table; rec < OS_file_table + OS_MAX_NUM_OPEN_FILES; rec++)
+		if (rec->used && rec->vol == v && rec->entry == entry)
+			return TRUE;
+
+	return FALSE;
+}
+
+/*
+** return the block of the file chain with the index, starting from the cursor of the open file if possible;
+** the chain is extended with cleared blocks if 'extend' is set
+*/
+static int32 file_block(OS_file_record_t *rec, uint32 index, uint32 *block, int extend)
+{
+	OS_volume_record_t *vol = &OS_volume_table[rec->vol];
+	OS_fs_entry_t *ent;
+	uint32 cur, idx, next;
+
+	if (rec->index != OS_FS_NONE && rec->index <= index)
+	{
+		idx = rec->index;
+		cur = rec->block;
+	}
+	else
+	{
+		if ((ent = dir_entry(rec->vol, rec->entry, FALSE)) == NULL)
+			return OS_FS_ERROR;
+
+		idx = 0;
+		cur = ent->first;
+
+		if (cur == OS_FS_FREE)
+		{
+			if (!extend || fat_alloc(rec->vol, &cur) != OS_FS_SUCCESS || (ent = dir_entry(rec->vol, rec->entry, TRUE)) == NULL)
+				return OS_FS_ERROR;
+
+			ent->first = cur;
+		}
+	}
+
+	for (; idx < index; idx++, cur = next)
+	{
+		if (fat_get(rec->vol, cur, &next) != OS_FS_SUCCESS)
+			return OS_FS_ERROR;
+
+		if (next == OS_FS_LAST)
+		{
+			if (!extend || fat_alloc(rec->vol, &next) != OS_FS_SUCCESS || fat_set(rec->vol, cur, next) != OS_FS_SUCCESS)
+				return OS_FS_ERROR;
+		}
+		else
+		if (!fat_valid(vol, next))
+			return OS_FS_ERROR;
+	}
+
+	rec->index = idx;
+	rec->block = cur;
+	*block = cur;
+	return OS_FS_SUCCESS;
+}
+
+#if OS_FS_READ_AHEAD > 0
+
+/*
+** request the flush task to prefetch the next OS_FS_READ_AHEAD blocks of the file after the file position
+*/
+static void file_prefetch(OS_file_record_t *rec, uint32 size)
+{
+	OS_volume_record_t *vol = &OS_volume_table[rec->vol];
+	OS_fs_request_t req = { rec->vol, 0 };
+	uint32 first = (rec->pos + vol->block_size - 1) / vol->block_size;
+	uint32 last  = (size + vol->block_size - 1) / vol->block_size;
+	uint32 idx   = rec->index;
+	uint32 cur   = rec->block;
+
+	if (last > first + OS_FS_READ_AHEAD)
+		last = first + OS_FS_READ_AHEAD;
+
+	for (; idx + 1 < last; idx++, cur = req.block)
+	{
+		if (fat_get(rec->vol, cur, &req.block) != OS_FS_SUCCESS || !fat_valid(vol, req.block))
+			break;
+
+		if (idx + 1 >= first && cache_find(rec->vol, req.block) == NULL && box_give(fs_box, &req) != E_SUCCESS)
+			break;
+	}
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+/*
+** flush task: prefetches requested blocks and writes back the dirty blocks
+** every OS_FS_FLUSH_PERIOD milliseconds or when half of the cache is dirty
+*/
+
+static void fs_handler(void)
+{
+	static cnt_t flush = 0;
+	OS_fs_request_t req;
+	OS_cache_record_t *rec;
+	uint32 v;
+
+	if (box_waitFor(fs_box, &req, OS_FS_FLUSH_PERIOD * MSEC) == E_SUCCESS && req.block != OS_FS_NONE)
+	{
+		mtx_wait(&OS_fs_mutex);
+		{
+			if (OS_volume_table[req.vol].mounted && req.block < OS_volume_table[req.vol].num_blocks)
+				cache_get(req.vol, req.block, TRUE);
+		}
+		mtx_give(&OS_fs_mutex);
+
+		if (OS_cache_dirty <= OS_FS_CACHE_BLOCKS / 2 && sys_time() - flush < OS_FS_FLUSH_PERIOD * MSEC)
+			return;
+	}
+
+	flush = sys_time();
+
+	// write back the blocks one by one, so the tasks using the file system are not stalled
+	for (rec = OS_cache_table; rec < OS_cache_table + OS_FS_CACHE_BLOCKS; rec++)
+	{
+		mtx_wait(&OS_fs_mutex);
+		{
+			if (rec->dirty)
+				cache_write(rec);
+		}
+		mtx_give(&OS_fs_mutex);
+	}
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		for (v = 0; v < NUM_TABLE_ENTRIES; v++)
+			if (OS_volume_table[v].ready)
+				blk_sync(&OS_volume_table[v]);
+	}
+	mtx_give(&OS_fs_mutex);
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+** Standard File system API
+*/
+
+int32 OS_FS_Init(void)
+{
+	tsk_start(fs_task);
+
+	return OS_FS_SUCCESS;
+}
+
+int32 OS_creat(const char *path, int32 access)
+{
+	char name[OS_FS_NAME_LEN];
+	OS_fs_entry_t *ent;
+	OS_file_record_t *rec;
+	uint32 v, entry, first;
+	int32 status;
+
+	if (access != OS_WRITE_ONLY && access != OS_READ_WRITE)
+		return OS_FS_ERROR;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(path, &v, name);
+
+		if (status == OS_FS_SUCCESS)
+			status = file_alloc();
+
+		if (status < 0)
+			;
+		else if (name[0] == 0)
+			status = OS_FS_ERROR;
+		else if (dir_find(v, name, &entry) != OS_FS_SUCCESS)
+		{
+			if (dir_create(v, name, OS_FS_ATTR_FILE, &entry) != OS_FS_SUCCESS)
+				status = OS_FS_ERROR;
+		}
+		else if ((ent = dir_entry(v, entry, TRUE)) == NULL || (ent->attr & (OS_FS_ATTR_DIR | OS_FS_ATTR_RDONLY)))
+			status = OS_FS_ERROR;
+		else
+		{
+			// truncate the existing file
+			first = ent->first;
+			ent->first = OS_FS_FREE;
+			ent->size = 0;
+
+			for (rec = OS_file_table; rec < OS_file_table + OS_MAX_NUM_OPEN_FILES; rec++)
+				if (rec->used && rec->vol == v && rec->entry == entry)
+					rec->index = OS_FS_NONE;
+
+			if (fat_release(v, first) != OS_FS_SUCCESS)
+				status = OS_FS_ERROR;
+		}
+
+		if (status >= 0)
+			status = file_open(status, v, entry, path, access);
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_open(const char *path, int32 access, uint32 mode)
+{
+	char name[OS_FS_NAME_LEN];
+	OS_fs_entry_t *ent;
+	uint32 v, entry;
+	int32 status;
+
+	(void) mode;
+
+	if (access != OS_READ_ONLY && access != OS_WRITE_ONLY && access != OS_READ_WRITE)
+		return OS_FS_ERROR;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(path, &v, name);
+
+		if (status == OS_FS_SUCCESS)
+			status = file_alloc();
+
+		if (status < 0)
+			;
+		else if (name[0] == 0 || dir_find(v, name, &entry) != OS_FS_SUCCESS || (ent = dir_entry(v, entry, FALSE)) == NULL)
+			status = OS_FS_ERROR;
+		else if ((ent->attr & OS_FS_ATTR_DIR) || ((ent->attr & OS_FS_ATTR_RDONLY) && access != OS_READ_ONLY))
+			status = OS_FS_ERROR;
+		else
+			status = file_open(status, v, entry, path, access);
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_close(int32 filedes)
+{
+	OS_file_record_t *rec;
+	int32 status;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		rec = file_get(filedes);
+
+		if (!rec)
+			status = OS_FS_ERR_INVALID_FD;
+		else
+		{
+			rec->used = 0;
+			status = OS_FS_SUCCESS;
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_read(int32 filedes, void *buffer, uint32 nbytes)
+{
+	OS_file_record_t *rec;
+	OS_cache_record_t *blk;
+	OS_fs_entry_t *ent;
+	uint32 bs, start, size, off, len, block;
+	uint32 done = 0;
+	int32 status = OS_FS_SUCCESS;
+
+	if (!buffer)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		rec = file_get(filedes);
+
+		if (!rec)
+			status = OS_FS_ERR_INVALID_FD;
+		else if (rec->access == OS_WRITE_ONLY || (ent = dir_entry(rec->vol, rec->entry, FALSE)) == NULL)
+			status = OS_FS_ERROR;
+		else
+		{
+			bs = OS_volume_table[rec->vol].block_size;
+			start = rec->pos;
+			size = ent->size;
+
+			if (nbytes > size - rec->pos || rec->pos > size)
+				nbytes = rec->pos < size ? size - rec->pos : 0;
+
+			while (done < nbytes)
+			{
+				off = rec->pos % bs;
+				len = bs - off < nbytes - done ? bs - off : nbytes - done;
+
+				if (file_block(rec, rec->pos / bs, &block, FALSE) != OS_FS_SUCCESS || (blk = cache_get(rec->vol, block, TRUE)) == NULL)
+				{
+					status = OS_FS_ERROR;
+					break;
+				}
+
+				memcpy((uint8 *) buffer + done, (uint8 *) blk->data + off, len);
+				rec->pos += len;
+				done += len;
+			}
+
+#if OS_FS_READ_AHEAD > 0
+			if (done > 0 && start == rec->seq)
+				file_prefetch(rec, size);
+#endif
+			rec->seq = rec->pos;
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return done > 0 ? (int32) done : status;
+}
+
+int32 OS_write(int32 filedes, void *buffer, uint32 nbytes)
+{
+	OS_file_record_t *rec;
+	OS_cache_record_t *blk;
+	OS_fs_entry_t *ent;
+	OS_time_t now;
+	uint32 bs, off, len, block;
+	uint32 done = 0;
+	int32 status = OS_FS_SUCCESS;
+
+	if (!buffer)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		rec = file_get(filedes);
+
+		if (!rec)
+			status = OS_FS_ERR_INVALID_FD;
+		else if (rec->access == OS_READ_ONLY)
+			status = OS_FS_ERROR;
+		else
+		{
+			bs = OS_volume_table[rec->vol].block_size;
+
+			while (done < nbytes)
+			{
+				off = rec->pos % bs;
+				len = bs - off < nbytes - done ? bs - off : nbytes - done;
+
+				if (file_block(rec, rec->pos / bs, &block, TRUE) != OS_FS_SUCCESS || (blk = cache_get(rec->vol, block, len < bs)) == NULL)
+				{
+					status = OS_FS_ERROR;
+					break;
+				}
+
+				memcpy((uint8 *) blk->data + off, (const uint8 *) buffer + done, len);
+				cache_dirty(blk);
+				rec->pos += len;
+				done += len;
+			}
+
+			if (done > 0 && (ent = dir_entry(rec->vol, rec->entry, TRUE)) != NULL)
+			{
+				OS_GetLocalTime(&now);
+				if (ent->size < rec->pos)
+					ent->size = rec->pos;
+				ent->time = (int32) now.seconds;
+			}
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return done > 0 ? (int32) done : status;
+}
+
+int32 OS_chmod(const char *path, uint32 access)
+{
+	char name[OS_FS_NAME_LEN];
+	OS_fs_entry_t *ent;
+	uint32 v, entry;
+	int32 status;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(path, &v, name);
+
+		if (status != OS_FS_SUCCESS)
+			;
+		else if (name[0] == 0 || dir_find(v, name, &entry) != OS_FS_SUCCESS || (ent = dir_entry(v, entry, TRUE)) == NULL)
+			status = OS_FS_ERROR;
+		else if (access == OS_READ_ONLY)
+			ent->attr |= OS_FS_ATTR_RDONLY;
+		else
+			ent->attr &= ~OS_FS_ATTR_RDONLY;
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_stat(const char *path, os_fstat_t *filestats)
+{
+	char name[OS_FS_NAME_LEN];
+	OS_fs_entry_t *ent;
+	uint32 v, entry;
+	int32 status;
+
+	if (!filestats)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(path, &v, name);
+
+		if (status != OS_FS_SUCCESS)
+			;
+		else if (name[0] == 0)
+		{
+			filestats->FileModeBits = OS_FILESTAT_MODE_DIR | OS_FILESTAT_MODE_READ | OS_FILESTAT_MODE_WRITE;
+			filestats->FileTime = 0;
+			filestats->FileSize = 0;
+		}
+		else if (dir_find(v, name, &entry) != OS_FS_SUCCESS || (ent = dir_entry(v, entry, FALSE)) == NULL)
+			status = OS_FS_ERROR;
+		else
+		{
+			filestats->FileModeBits = OS_FILESTAT_MODE_READ;
+			if ((ent->attr & OS_FS_ATTR_RDONLY) == 0)
+				filestats->FileModeBits |= OS_FILESTAT_MODE_WRITE;
+			if (ent->attr & OS_FS_ATTR_DIR)
+				filestats->FileModeBits |= OS_FILESTAT_MODE_DIR;
+			filestats->FileTime = ent->time;
+			filestats->FileSize = ent->size;
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_lseek(int32 filedes, int32 offset, uint32 whence)
+{
+	OS_file_record_t *rec;
+	OS_fs_entry_t *ent;
+	int64_t pos = 0;
+	int32 status;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		rec = file_get(filedes);
+
+		if (!rec)
+			status = OS_FS_ERR_INVALID_FD;
+		else if ((ent = dir_entry(rec->vol, rec->entry, FALSE)) == NULL)
+			status = OS_FS_ERROR;
+		else
+		{
+			switch (whence)
+			{
+			case OS_SEEK_SET: pos = offset;                      break;
+			case OS_SEEK_CUR: pos = (int64_t) rec->pos  + offset; break;
+			case OS_SEEK_END: pos = (int64_t) ent->size + offset; break;
+			default:          pos = -1;                          break;
+			}
+
+			if (pos < 0 || pos > INT32_MAX)
+				status = OS_FS_ERROR;
+			else
+			{
+				rec->pos = (uint32) pos;
+				status = (int32) pos;
+			}
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_remove(const char *path)
+{
+	char name[OS_FS_NAME_LEN];
+	OS_fs_entry_t *ent;
+	uint32 v, entry, first;
+	int32 status;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(path, &v, name);
+
+		if (status != OS_FS_SUCCESS)
+			;
+		else if (name[0] == 0 || dir_find(v, name, &entry) != OS_FS_SUCCESS || file_busy(v, entry))
+			status = OS_FS_ERROR;
+		else if ((ent = dir_entry(v, entry, TRUE)) == NULL || (ent->attr & OS_FS_ATTR_DIR))
+			status = OS_FS_ERROR;
+		else
+		{
+			first = ent->first;
+			memset(ent, 0, sizeof(*ent));
+			status = fat_release(v, first);
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_rename(const char *old_filename, const char *new_filename)
+{
+	char old_name[OS_FS_NAME_LEN];
+	char new_name[OS_FS_NAME_LEN];
+	OS_file_record_t *rec;
+	OS_fs_entry_t *ent;
+	uint32 v, w, entry, other, first;
+	int32 status;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(old_filename, &v, old_name);
+
+		if (status == OS_FS_SUCCESS)
+			status = path_resolve(new_filename, &w, new_name);
+
+		if (status != OS_FS_SUCCESS)
+			;
+		else if (v != w || old_name[0] == 0 || new_name[0] == 0 || dir_find(v, old_name, &entry) != OS_FS_SUCCESS || dir_parent(v, new_name) != OS_FS_SUCCESS)
+			status = OS_FS_ERROR;
+		else if ((ent = dir_entry(v, entry, FALSE)) == NULL || ((ent->attr & OS_FS_ATTR_DIR) && dir_empty(v, old_name) != OS_FS_SUCCESS))
+			status = OS_FS_ERROR;
+		else if (strncmp(new_name, old_name, strlen(old_name)) == 0 && new_name[strlen(old_name)] == '/')
+			status = OS_FS_ERROR;
+		else if (strcmp(old_name, new_name) != 0)
+		{
+			// the existing file of the new name is replaced
+			if (dir_find(v, new_name, &other) == OS_FS_SUCCESS)
+			{
+				if (file_busy(v, other) || (ent = dir_entry(v, other, TRUE)) == NULL || (ent->attr & OS_FS_ATTR_DIR))
+					status = OS_FS_ERROR;
+				else
+				{
+					first = ent->first;
+					memset(ent, 0, sizeof(*ent));
+					status = fat_release(v, first);
+				}
+			}
+
+			if (status == OS_FS_SUCCESS && (ent = dir_entry(v, entry, TRUE)) != NULL)
+			{
+				strcpy(ent->name, new_name);
+
+				for (rec = OS_file_table; rec < OS_file_table + OS_MAX_NUM_OPEN_FILES; rec++)
+					if (rec->used && rec->vol == v && rec->entry == entry)
+						strcpy(rec->path, new_filename);
+			}
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_cp(const char *src, const char *dest)
+{
+	uint32 buf[OS_FS_BLOCK_SIZE / 2 / sizeof(uint32)];
+	int32 in, out, cnt, status;
+
+	if (!src || !dest)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	in = OS_open(src, OS_READ_ONLY, 0);
+	if (in < 0)
+		return in;
+
+	out = OS_creat(dest, OS_WRITE_ONLY);
+	if (out < 0)
+	{
+		OS_close(in);
+		return out;
+	}
+
+	while ((cnt = OS_read(in, buf, sizeof(buf))) > 0)
+		if (OS_write(out, buf, cnt) != cnt)
+			break;
+
+	status = cnt == 0 ? OS_FS_SUCCESS : OS_FS_ERROR;
+
+	OS_close(in);
+	OS_close(out);
+
+	return status;
+}
+
+int32 OS_mv(const char *src, const char *dest)
+{
+	char name[OS_FS_NAME_LEN];
+	uint32 v, w;
+	int32 status;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(src, &v, name);
+
+		if (status == OS_FS_SUCCESS)
+			status = path_resolve(dest, &w, name);
+	}
+	mtx_give(&OS_fs_mutex);
+
+	if (status != OS_FS_SUCCESS)
+		return status;
+
+	if (v == w)
+		return OS_rename(src, dest);
+
+	status = OS_cp(src, dest);
+	if (status == OS_FS_SUCCESS)
+		status = OS_remove(src);
+
+	return status;
+}
+
+int32 OS_FDGetInfo(int32 filedes, OS_FDTableEntry *fd_prop)
+{
+	OS_file_record_t *rec;
+	int32 status;
+
+	if (!fd_prop)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		rec = file_get(filedes);
+
+		if (!rec)
+		{
+			fd_prop->IsValid = FALSE;
+			status = OS_FS_ERR_INVALID_FD;
+		}
+		else
+		{
+			fd_prop->OSfd = filedes;
+			strcpy(fd_prop->Path, rec->path);
+			fd_prop->User = rec->user;
+			fd_prop->IsValid = TRUE;
+			status = OS_FS_SUCCESS;
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_FileOpenCheck(char *Filename)
+{
+	OS_file_record_t *rec;
+	int32 status = OS_FS_ERROR;
+
+	if (!Filename)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		for (rec = OS_file_table; rec < OS_file_table + OS_MAX_NUM_OPEN_FILES; rec++)
+			if (rec->used && strcmp(rec->path, Filename) == 0)
+				status = OS_FS_SUCCESS;
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_CloseAllFiles(void)
+{
+	OS_file_record_t *rec;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		for (rec = OS_file_table; rec < OS_file_table + OS_MAX_NUM_OPEN_FILES; rec++)
+			rec->used = 0;
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return OS_FS_SUCCESS;
+}
+
+int32 OS_CloseFileByName(char *Filename)
+{
+	OS_file_record_t *rec;
+	int32 status = OS_FS_ERR_PATH_INVALID;
+
+	if (!Filename)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		for (rec = OS_file_table; rec < OS_file_table + OS_MAX_NUM_OPEN_FILES; rec++)
+		{
+			if (rec->used && strcmp(rec->path, Filename) == 0)
+			{
+				rec->used = 0;
+				status = OS_FS_SUCCESS;
+			}
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+** Directory API
+*/
+
+int32 OS_mkdir(const char *path, uint32 access)
+{
+	char name[OS_FS_NAME_LEN];
+	uint32 v, entry;
+	int32 status;
+
+	(void) access;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(path, &v, name);
+
+		if (status != OS_FS_SUCCESS)
+			;
+		else if (name[0] == 0 || dir_find(v, name, &entry) == OS_FS_SUCCESS || dir_create(v, name, OS_FS_ATTR_DIR, &entry) != OS_FS_SUCCESS)
+			status = OS_FS_ERROR;
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+os_dirp_t OS_opendir(const char *path)
+{
+	char name[OS_FS_NAME_LEN];
+	OS_dir_record_t *dir = NULL;
+	OS_fs_entry_t *ent;
+	uint32 v, entry;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		if (path_resolve(path, &v, name) != OS_FS_SUCCESS)
+			;
+		else if (name[0] != 0 && (dir_find(v, name, &entry) != OS_FS_SUCCESS || (ent = dir_entry(v, entry, FALSE)) == NULL || (ent->attr & OS_FS_ATTR_DIR) == 0))
+			;
+		else
+		{
+			for (dir = OS_dir_table; dir < OS_dir_table + OS_MAX_NUM_OPEN_DIRS; dir++)
+				if (dir->used == 0)
+					break;
+
+			if (dir >= OS_dir_table + OS_MAX_NUM_OPEN_DIRS)
+				dir = NULL;
+			else
+			{
+				strcpy(dir->name, name);
+				dir->vol = v;
+				dir->entry = 0;
+				dir->used = 1;
+			}
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return dir;
+}
+
+int32 OS_closedir(os_dirp_t directory)
+{
+	int32 status;
+
+	if (!directory)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		if (directory < OS_dir_table || directory >= OS_dir_table + OS_MAX_NUM_OPEN_DIRS || directory->used == 0)
+			status = OS_FS_ERROR;
+		else
+		{
+			directory->used = 0;
+			status = OS_FS_SUCCESS;
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+void OS_rewinddir(os_dirp_t directory)
+{
+	if (directory)
+	{
+		mtx_wait(&OS_fs_mutex);
+		{
+			directory->entry = 0;
+		}
+		mtx_give(&OS_fs_mutex);
+	}
+}
+
+os_dirent_t *OS_readdir(os_dirp_t directory)
+{
+	os_dirent_t *dirent = NULL;
+	OS_fs_entry_t *ent;
+	const char *base;
+
+	if (!directory)
+		return NULL;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		while (directory->used && directory->entry < OS_volume_table[directory->vol].dir_entries)
+		{
+			if ((ent = dir_entry(directory->vol, directory->entry++, FALSE)) == NULL)
+				break;
+
+			if (dir_child(ent->name, directory->name))
+			{
+				base = strrchr(ent->name, '/');
+				strcpy(directory->dirent.FileName, base ? base + 1 : ent->name);
+				dirent = &directory->dirent;
+				break;
+			}
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return dirent;
+}
+
+int32 OS_rmdir(const char *path)
+{
+	char name[OS_FS_NAME_LEN];
+	OS_fs_entry_t *ent;
+	uint32 v, entry;
+	int32 status;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(path, &v, name);
+
+		if (status != OS_FS_SUCCESS)
+			;
+		else if (name[0] == 0 || dir_find(v, name, &entry) != OS_FS_SUCCESS || dir_empty(v, name) != OS_FS_SUCCESS)
+			status = OS_FS_ERROR;
+		else if ((ent = dir_entry(v, entry, TRUE)) == NULL || (ent->attr & OS_FS_ATTR_DIR) == 0)
+			status = OS_FS_ERROR;
+		else
+			memset(ent, 0, sizeof(*ent));
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+** System Level API
+*/
+
+int32 OS_BlkDevAttach(const char *devname, const OS_BlockDevice_t *dev)
+{
+	int32 status;
+
+	if (!devname || !dev || !dev->read || !dev->write)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	if (strlen(devname) >= OS_FS_DEV_NAME_LEN)
+		return OS_FS_ERR_PATH_TOO_LONG;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		OS_volume_record_t *vol = vol_find(devname) ? NULL : vol_alloc(devname);
+
+		if (!vol)
+			status = OS_FS_ERR_DEVICE_NOT_FREE;
+		else
+		{
+			vol->dev = dev;
+			status = OS_FS_SUCCESS;
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+/*
+** common part of OS_mkfs and OS_initfs
+** the volume of the attached block device is used, otherwise a RAM disk volume is created at 'address'
+*/
+static int32 fs_create(char *address, char *devname, char *volname, uint32 blocksize, uint32 numblocks,
+                       int32 (*init)(uint32, uint32, uint32))
+{
+	OS_volume_record_t *vol;
+	int32 status;
+
+	if (!devname || !volname)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	if (strlen(devname) >= OS_FS_DEV_NAME_LEN || strlen(volname) >= OS_FS_VOL_NAME_LEN)
+		return OS_FS_ERR_PATH_TOO_LONG;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		vol = vol_find(devname);
+
+		if (vol && vol->mounted)
+			status = OS_FS_ERR_DEVICE_NOT_FREE;
+		else if (!vol && !address)
+			status = OS_FS_ERR_DRIVE_NOT_CREATED;
+		else if (!vol && (vol = vol_alloc(devname)) == NULL)
+			status = OS_FS_ERR_DEVICE_NOT_FREE;
+		else
+		{
+			if (!vol->dev)
+				vol->address = address;
+
+			if (init(vol - OS_volume_table, blocksize, numblocks) != OS_FS_SUCCESS)
+			{
+				status = OS_FS_ERR_DRIVE_NOT_CREATED;
+				if (!vol->dev)
+					vol->used = 0;
+			}
+			else
+			{
+				strcpy(vol->volname, volname);
+				status = OS_FS_SUCCESS;
+			}
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_mkfs(char *address, char *devname, char *volname, uint32 blocksize, uint32 numblocks)
+{
+	return fs_create(address, devname, volname, blocksize, numblocks, vol_format);
+}
+
+int32 OS_mount(const char *devname, char *mountpoint)
+{
+	OS_volume_record_t *vol;
+	int32 status;
+
+	if (!devname || !mountpoint)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	if (strlen(mountpoint) >= OS_MAX_PATH_LEN)
+		return OS_FS_ERR_PATH_TOO_LONG;
+
+	if (mountpoint[0] != '/')
+		return OS_FS_ERR_PATH_INVALID;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		vol = vol_find(devname);
+
+		if (!vol || vol->ready == 0 || vol->mounted)
+			status = OS_FS_ERROR;
+		else
+		{
+			strcpy(vol->mountpoint, mountpoint);
+			vol->mounted = 1;
+			status = OS_FS_SUCCESS;
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_initfs(char *address, char *devname, char *volname, uint32 blocksize, uint32 numblocks)
+{
+	return fs_create(address, devname, volname, blocksize, numblocks, vol_load);
+}
+
+int32 OS_rmfs(char *devname)
+{
+	OS_volume_record_t *vol;
+	int32 status;
+
+	if (!devname)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		vol = vol_find(devname);
+
+		if (!vol || vol->mounted)
+			status = OS_FS_ERROR;
+		else
+		{
+			status = vol->ready ? cache_sync(vol - OS_volume_table) : OS_FS_SUCCESS;
+			cache_drop(vol - OS_volume_table);
+			vol->used = 0;
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_unmount(const char *mountpoint)
+{
+	OS_volume_record_t *vol;
+	int32 status = OS_FS_ERROR;
+
+	if (!mountpoint)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		for (vol = OS_volume_table; vol < OS_volume_table + NUM_TABLE_ENTRIES; vol++)
+		{
+			if (vol->mounted && strcmp(vol->mountpoint, mountpoint) == 0 && !vol_busy(vol - OS_volume_table))
+			{
+				status = cache_sync(vol - OS_volume_table);
+				vol->mounted = 0;
+				break;
+			}
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_FS_Sync(void)
+{
+	uint32 v;
+	int32 status = OS_FS_SUCCESS;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		for (v = 0; v < NUM_TABLE_ENTRIES; v++)
+			if (OS_volume_table[v].mounted && cache_sync(v) != OS_FS_SUCCESS)
+				status = OS_FS_ERROR;
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_fsBlocksFree(const char *name)
+{
+	char path[OS_FS_NAME_LEN];
+	uint32 v;
+	int32 status;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(name, &v, path);
+
+		if (status == OS_FS_SUCCESS)
+			status = (int32) OS_volume_table[v].free;
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_fsBytesFree(const char *name, uint64 *bytes_free)
+{
+	char path[OS_FS_NAME_LEN];
+	uint32 v;
+	int32 status;
+
+	if (!bytes_free)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(name, &v, path);
+
+		if (status == OS_FS_SUCCESS)
+			*bytes_free = (uint64) OS_volume_table[v].free * OS_volume_table[v].block_size;
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+os_fshealth_t OS_chkfs(const char *name, boolean repair)
+{
+	(void) name;
+	(void) repair;
+
+	return (os_fshealth_t) OS_FS_UNIMPLEMENTED;
+}
+
+int32 OS_FS_GetPhysDriveName(char *PhysDriveName, char *MountPoint)
+{
+	OS_volume_record_t *vol;
+	int32 status = OS_FS_ERROR;
+
+	if (!PhysDriveName || !MountPoint)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		for (vol = OS_volume_table; vol < OS_volume_table + NUM_TABLE_ENTRIES; vol++)
+		{
+			if (vol->mounted && strcmp(vol->mountpoint, MountPoint) == 0)
+			{
+				strcpy(PhysDriveName, vol->devname);
+				status = OS_FS_SUCCESS;
+				break;
+			}
+		}
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_TranslatePath(const char *VirtualPath, char *LocalPath)
+{
+	char name[OS_FS_NAME_LEN];
+	uint32 v;
+	int32 status;
+
+	if (!VirtualPath || !LocalPath)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		status = path_resolve(VirtualPath, &v, name);
+
+		// there is no host file system, the local path is the virtual path
+		if (status == OS_FS_SUCCESS)
+			strcpy(LocalPath, VirtualPath);
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return status;
+}
+
+int32 OS_GetFsInfo(os_fsinfo_t *filesys_info)
+{
+	uint32 i;
+
+	if (!filesys_info)
+		return OS_FS_ERR_INVALID_POINTER;
+
+	filesys_info->MaxFds = OS_MAX_NUM_OPEN_FILES;
+	filesys_info->FreeFds = 0;
+	filesys_info->MaxVolumes = NUM_TABLE_ENTRIES;
+	filesys_info->FreeVolumes = 0;
+
+	mtx_wait(&OS_fs_mutex);
+	{
+		for (i = 0; i < OS_MAX_NUM_OPEN_FILES; i++)
+			if (OS_file_table[i].used == 0)
+				filesys_info->FreeFds++;
+
+		for (i = 0; i < NUM_TABLE_ENTRIES; i++)
+			if (OS_volume_table[i].used == 0)
+				filesys_info->FreeVolumes++;
+	}
+	mtx_give(&OS_fs_mutex);
+
+	return OS_FS_SUCCESS;
+}
+
+/* -------------------------------------------------------------------------- */
+/*
+** Shell API
+*/
+
+int32 OS_ShellOutputToFile(char *Cmd, int32 OS_fd)
+{
+	(void) Cmd;
+	(void) OS_fd;
+
+	return OS_FS_UNIMPLEMENTED;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -45,7 +45,8 @@ extern "C" {
 */
 typedef struct
 {
-	box_t  box;
+	msg_t  msg;
+	uint32 size;
 	char   name [OS_MAX_API_NAME];
 	uint32 creator;
 	uint32 used;
@@ -114,6 +115,107 @@ typedef struct
 	void (*handler)(uint32);
 }	OS_timer_record_t;
 
+/* -------------------------------------------------------------------------- */
+/*
+** shared memory segments
+*/
+typedef struct
+{
+	mtx_t  mtx;
+	char   name [OS_MAX_API_NAME];
+	uint32 creator;
+	uint32 used;
+	void * data;   // segment memory allocated on the system heap, exchanged by reference
+	uint32 size;
+}	OS_shmem_record_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+** file system volumes
+*/
+typedef struct
+{
+	char   devname   [OS_FS_DEV_NAME_LEN];
+	char   volname   [OS_FS_VOL_NAME_LEN];
+	char   mountpoint[OS_MAX_PATH_LEN];
+	const OS_BlockDevice_t *dev; // attached block device (NULL: RAM disk)
+	char * address;  // memory of the RAM disk
+	uint32 block_size;
+	uint32 num_blocks;
+	uint32 fat_start;  // first block of the allocation table
+	uint32 dir_start;  // first block of the directory
+	uint32 dir_entries;
+	uint32 data_start; // first data block
+	uint32 free;       // number of free data blocks
+	uint32 hint;       // next block checked by the allocator
+	uint32 written;    // blocks were written since the last sync of the device
+	uint32 used;
+	uint32 ready;      // formatted or initialized
+	uint32 mounted;
+}	OS_volume_record_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+** open files
+*/
+typedef struct
+{
+	char   path [OS_MAX_PATH_LEN];
+	uint32 user;
+	uint32 used;
+	uint32 access;
+	uint32 vol;    // volume of the file
+	uint32 entry;  // directory entry of the file
+	uint32 pos;    // file position
+	uint32 index;  // index of the block 'block' in the file chain (UINT32_MAX: none)
+	uint32 block;  // cursor of the file chain
+	uint32 seq;    // position where the last read ended (sequential read detection)
+}	OS_file_record_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+** open directories
+*/
+struct OS_dir_record
+{
+	char   name [OS_MAX_PATH_LEN]; // directory inside the volume
+	uint32 used;
+	uint32 vol;
+	uint32 entry;  // next directory entry to read
+	os_dirent_t dirent;
+};
+
+typedef struct OS_dir_record OS_dir_record_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+** blocks of the file system cache
+*/
+typedef struct
+{
+	uint32 vol;    // volume + 1 (0: free cache block)
+	uint32 block;
+	uint32 stamp;  // time of the last access (LRU)
+	uint32 dirty;
+	uint32 data [OS_FS_BLOCK_SIZE / sizeof(uint32)];
+}	OS_cache_record_t;
+
+/* -------------------------------------------------------------------------- */
+/*
+** name index of records
+*/
+#define OS_NAME_FREE         0x0000U   // empty entry, terminates the probe sequence
+#define OS_NAME_DELETED      0xFFFFU   // deleted entry, the probe sequence continues
+#define OS_NAME_SIZE( max ) (2*(max)+1) // number of entries, load factor less than 0.5
+
+typedef struct
+{
+	uint16     * hash;  // entries: record number + 1, OS_NAME_FREE or OS_NAME_DELETED
+	uint32       size;  // number of entries
+	const char * name;  // name of the first record
+	uint32       step;  // size of a record
+}	OS_name_index_t;
+
 /* -------------------------------------------------------------------------- */
 
 #ifdef __cplusplus
@@ -53,6 +53,28 @@ int _mutex_initialize( unsigned *mutex )
 
 /* -------------------------------------------------------------------------- */
 
+#if OS_LIBC_MUTEX
+
+__attribute__((used))
+void _mutex_acquire( unsigned *mutex )
+{
+	(void) mutex;
+
+	core_lib_lock();    /* all library mutexes share the recursive library lock */
+}
+
+/* -------------------------------------------------------------------------- */
+
+__attribute__((used))
+void _mutex_release( unsigned *mutex )
+{
+	(void) mutex;
+
+	core_lib_unlock();
+}
+
+#else
+
 __attribute__((used))
 void _mutex_acquire( unsigned *mutex )
 {
@@ -69,6 +91,8 @@ void _mutex_release( unsigned *mutex )
 	port_put_lock(*mutex);
 }
 
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 __attribute__((used))
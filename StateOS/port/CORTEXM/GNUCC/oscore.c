@@ -32,12 +32,14 @@
 #if defined(__GNUC__) && !defined(__ARMCC_VERSION)
 
 #include "oskernel.h"
+#include "inc/ostask.h"
+#include <stddef.h>
 
 /* -------------------------------------------------------------------------- */
 
 #if __CORTEX_M < 3
 
-__attribute__((naked))
+__attribute__((naked)) __RAMFUNC
 void PendSV_Handler( void )
 {
 	__ASM volatile
@@ -89,9 +91,167 @@ void PendSV_Handler( void )
 
 /* -------------------------------------------------------------------------- */
 
-#if __CORTEX_M >= 3
+#if OS_LAZY_FPU
+
+/******************************************************************************
+ Lazy fpu context switching
+ Registers s16 - s31 stay in the fpu until another task executes fp instruction,
+ the space for them is only reserved in the context of the task using the fpu.
+ The fpu is disabled for tasks that are not the owner of the fpu registers;
+ the first fp instruction of such a task raises UsageFault (NOCP),
+ the fault handler saves registers of the previous owner and gives the fpu to the current task.
+ Registers s0 - s15 and FPSCR are preserved by the hardware (FPCCR: ASPEN, LSPEN).
+*******************************************************************************/
+
+#define FPU_ACCESS  (0xFU << 20)  // CPACR: full access to CP10 and CP11
+#define FPU_SLOT(sp) ((char *)(sp) + offsetof(ctx_t, r0))
+
+static tsk_t *Owner = &MAIN; // owner of the fpu registers s16 - s31
+
+/* -------------------------------------------------------------------------- */
+
+__STATIC_INLINE
+bool priv_fpu_used( void *sp )
+{
+	return (((ctx_t *)sp)->lr & 0x10U) == 0U; // EXC_RETURN: extended frame
+}
+
+/* -------------------------------------------------------------------------- */
+
+__STATIC_INLINE
+void priv_fpu_access( bool enable )
+{
+	if (enable)
+		SCB->CPACR |=  FPU_ACCESS;
+	else
+		SCB->CPACR &= ~FPU_ACCESS;
+	__DSB(); __ISB();
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_fpu_save( void )
+{
+	if (Owner == 0)
+		FPU->FPCCR &= ~FPU_FPCCR_LSPACT_Msk; // discard pending state of the released owner
+	else
+	if (priv_fpu_used(Owner->sp))
+		__ASM volatile ("vstmia %0, { s16 - s31 }" :: "r" (FPU_SLOT(Owner->sp)) : "memory");
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void *priv_fpu_handler( void *sp )
+{
+	tsk_t *nxt = System.cur;
+
+	if (nxt != Owner && priv_fpu_used(sp))
+	{
+		priv_fpu_access(true);
+		priv_fpu_save();
+		__ASM volatile ("vldmia %0, { s16 - s31 }" :: "r" (FPU_SLOT(sp)) : "memory");
+		Owner = nxt;
+	}
+
+	priv_fpu_access(nxt == Owner);
+
+	return sp;
+}
+
+/* -------------------------------------------------------------------------- */
+
+static
+void priv_fpu_trap( unsigned exc_return )
+{
+	if ((SCB->CFSR & SCB_CFSR_NOCP_Msk) == 0U)
+		for (;;); // other usage faults are not handled
+
+	SCB->CFSR = SCB_CFSR_NOCP_Msk;
+	priv_fpu_access(true);
+
+	if (exc_return & 0x08U) // fp instruction executed by the current task
+	{
+		if (Owner != System.cur)
+		{
+			priv_fpu_save();
+			__set_FPSCR(FPU->FPDSCR);
+			Owner = System.cur;
+		}
+	}
+	else // fp instruction executed by ISR; PendSV will restore the fpu access
+	{
+		port_ctx_switch();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void port_fpu_release( tsk_t *tsk )
+{
+	if (Owner == tsk)
+		Owner = 0;
+}
+
+/* -------------------------------------------------------------------------- */
 
 __attribute__((naked))
+void UsageFault_Handler( void )
+{
+	__ASM volatile
+	(
+"	.syntax	unified                \n"
+
+"	mov   r0,    lr                \n"
+"	b   %[priv_fpu_trap]           \n"
+
+::	[priv_fpu_trap] "i" (priv_fpu_trap)
+:	"memory"
+	);
+}
+
+/* -------------------------------------------------------------------------- */
+
+__attribute__((naked)) __RAMFUNC
+void PendSV_Handler( void )
+{
+	__ASM volatile
+	(
+"	.syntax	unified                \n"
+
+"	tst   lr,  # 4                 \n"
+"	itee  ne                       \n"
+"	mrsne r0,    PSP               \n"
+"	moveq r0,    sp                \n"
+"	subeq sp,  # 100               \n"
+"	tst   lr,  # 16                \n"
+"	it    eq                       \n"
+"	subeq r0,  # 64                \n"
+"	stmdb r0!, { r4  - r11, lr }   \n"
+
+"	bl  %[core_tsk_handler]        \n"
+"	bl  %[priv_fpu_handler]        \n"
+
+"	ldmia r0!, { r4  - r11, lr }   \n"
+"	tst   lr,  # 16                \n"
+"	it    eq                       \n"
+"	addeq r0,  # 64                \n"
+"	tst   lr,  # 4                 \n"
+"	ite   ne                       \n"
+"	msrne PSP,   r0                \n"
+"	moveq sp,    r0                \n"
+"	bx    lr                       \n"
+
+::	[core_tsk_handler] "i" (core_tsk_handler),
+	[priv_fpu_handler] "i" (priv_fpu_handler)
+:	"memory"
+	);
+}
+
+#elif __CORTEX_M >= 3
+
+__attribute__((naked)) __RAMFUNC
 void PendSV_Handler( void )
 {
 	__ASM volatile
@@ -135,6 +295,79 @@ void PendSV_Handler( void )
 
 /* -------------------------------------------------------------------------- */
 
+#if OS_SYNC_SWITCH && __CORTEX_M >= 3
+
+/******************************************************************************
+ Synchronous context switch
+ The context of the current task is stored on its stack in the same layout as
+ the context saved by PendSV (basic frame, return address 'port_ctx_resume'),
+ but only registers r4 - r11 and lr are preserved (the procedure is called).
+ The context of the next task is restored the same way, so it must have been
+ saved by port_ctx_sync (see port_ctx_ready).
+*******************************************************************************/
+
+static __RAMFUNC
+void *priv_ctx_sync( void *sp )
+{
+	SCB->ICSR = SCB_ICSR_PENDSVCLR_Msk; // pending switch is made here
+
+	return core_tsk_sync(sp);
+}
+
+/* -------------------------------------------------------------------------- */
+
+__attribute__((naked)) __RAMFUNC
+void port_ctx_sync( void )
+{
+	__ASM volatile
+	(
+"	.syntax	unified                \n"
+
+"	adr.w r2,    3f                \n"
+"	mov   r3,  # 0x01000000        \n"
+"	push  { r2, r3 }               \n" // pc, psr
+"	push  { lr }                   \n" // r14
+"	sub   sp,  # 20                \n" // r0 - r3, r12
+"	mrs   r1,    CONTROL           \n"
+"	tst   r1,  # 2                 \n"
+"	ite   ne                       \n"
+"	mvnne r12, # 2                 \n" // EXC_RETURN: thread mode, PSP
+"	mvneq r12, # 6                 \n" // EXC_RETURN: thread mode, MSP
+"	push  { r4  - r11, r12 }       \n"
+"	mov   r0,    sp                \n"
+"	sub   sp,  # 4                 \n" // stack alignment
+
+"	bl  %[priv_ctx_sync]           \n"
+
+"	ldmia r0!, { r4  - r11, r12 }  \n"
+"	ldr   lr,  [ r0, # 20 ]        \n" // r14
+"	ldr   r1,  [ r0, # 28 ]        \n" // psr
+"	adds  r0,  # 32                \n"
+"	tst   r1,  # 0x200             \n"
+"	it    ne                       \n"
+"	addne r0,  # 4                 \n" // stack alignment
+"	mrs   r1,    CONTROL           \n"
+"	tst   r12, # 4                 \n"
+"	ittee ne                       \n"
+"	msrne PSP,   r0                \n"
+"	orrne r1,    r1, # 2           \n"
+"	msreq MSP,   r0                \n"
+"	biceq r1,    r1, # 2           \n"
+"	msr   CONTROL, r1              \n"
+"	isb                            \n"
+"	.global port_ctx_resume        \n"
+"port_ctx_resume:                  \n"
+"3:	bx    lr                       \n"
+
+::	[priv_ctx_sync] "i" (priv_ctx_sync)
+:	"memory"
+	);
+}
+
+#endif//OS_SYNC_SWITCH
+
+/* -------------------------------------------------------------------------- */
+
 __attribute__((naked))
 void core_tsk_flip( void *sp )
 {
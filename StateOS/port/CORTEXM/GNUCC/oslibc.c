@@ -37,6 +37,22 @@
 
 /* -------------------------------------------------------------------------- */
 
+#if OS_LIBC_MUTEX
+
+void __malloc_lock()
+{
+	core_lib_lock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void __malloc_unlock()
+{
+	core_lib_unlock();
+}
+
+#else
+
 static unsigned LCK = 0;
 static unsigned CNT = 0;
 
@@ -64,6 +80,8 @@ void __malloc_unlock()
 		port_put_lock(LCK);
 }
 
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 caddr_t _sbrk_r( struct _reent *reent, size_t size )
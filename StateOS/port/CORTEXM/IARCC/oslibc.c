@@ -0,0 +1,107 @@
+/******************************************************************************
+
+    @file    StateOS: oslibc.c
+    @author  Rajmund Szymanski
+    @date    14.10.2026
+    @brief   This file provides set of variables and functions for StateOS.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#if defined(__ICCARM__)
+
+#include <yvals.h>
+#include "oskernel.h"
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_LIBC_MUTEX // requires the library with thread support (--threaded_lib)
+
+void __iar_system_Mtxinit( __iar_Rmtx *mutex )
+{
+	(void) mutex;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void __iar_system_Mtxdst( __iar_Rmtx *mutex )
+{
+	(void) mutex;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void __iar_system_Mtxlock( __iar_Rmtx *mutex )
+{
+	(void) mutex;
+
+	core_lib_lock();    /* all library mutexes share the recursive library lock */
+}
+
+/* -------------------------------------------------------------------------- */
+
+void __iar_system_Mtxunlock( __iar_Rmtx *mutex )
+{
+	(void) mutex;
+
+	core_lib_unlock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void __iar_file_Mtxinit( __iar_Rmtx *mutex )
+{
+	(void) mutex;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void __iar_file_Mtxdst( __iar_Rmtx *mutex )
+{
+	(void) mutex;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void __iar_file_Mtxlock( __iar_Rmtx *mutex )
+{
+	(void) mutex;
+
+	core_lib_lock();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void __iar_file_Mtxunlock( __iar_Rmtx *mutex )
+{
+	(void) mutex;
+
+	core_lib_unlock();
+}
+
+#endif // OS_LIBC_MUTEX
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __ICCARM__
@@ -44,6 +44,30 @@ extern "C" {
 #define OS_HEAP_SIZE          0 /* default system heap: all free memory       */
 #endif
 
+#ifndef OS_HEAP_TLSF
+#define OS_HEAP_TLSF          0 /* system heap uses first-fit allocator       */
+#endif
+
+#ifndef OS_HEAP_SLAB
+#define OS_HEAP_SLAB          0 /* control blocks allocated from system heap  */
+#endif
+
+#ifndef OS_HEAP_QUOTA
+#define OS_HEAP_QUOTA         0 /* system heap usage is not charged to tasks  */
+#endif
+
+#ifndef OS_HEAP_COALESCE
+#define OS_HEAP_COALESCE      0 /* free segments are merged during allocation */
+#endif
+
+#if     OS_HEAP_COALESCE && (OS_HEAP_SIZE == 0 || OS_HEAP_TLSF)
+#error  osconfig.h: OS_HEAP_COALESCE requires the first-fit system heap (OS_HEAP_SIZE without OS_HEAP_TLSF).
+#endif
+
+#ifndef OS_LIBC_MUTEX
+#define OS_LIBC_MUTEX         0 /* c library locks mask interrupts            */
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 #ifndef OS_STACK_SIZE
@@ -54,6 +78,10 @@ extern "C" {
 #define OS_IDLE_STACK       128 /* idle task stack size in bytes              */
 #endif
 
+#ifndef OS_ISR_STACK
+#define OS_ISR_STACK          0 /* exceptions use the stack of the main task  */
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 #ifndef OS_LOCK_LEVEL
@@ -72,6 +100,376 @@ extern "C" {
 
 /* -------------------------------------------------------------------------- */
 
+#ifndef OS_PRIO_BITMAP
+#define OS_PRIO_BITMAP        0 /* tasks queue without priority bitmap        */
+#endif
+
+#if     OS_PRIO_BITMAP > 1024
+#error  osconfig.h: Incorrect OS_PRIO_BITMAP value! Must be less or equal 1024.
+#endif
+
+#if     OS_PRIO_BITMAP && (OS_MAIN_PRIO >= OS_PRIO_BITMAP)
+#error  osconfig.h: Incorrect OS_MAIN_PRIO value! Must be less then OS_PRIO_BITMAP.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_EDF_PRIO
+#define OS_EDF_PRIO           0 /* no earliest-deadline-first priority level  */
+#endif
+
+#if     OS_PRIO_BITMAP && (OS_EDF_PRIO >= OS_PRIO_BITMAP)
+#error  osconfig.h: Incorrect OS_EDF_PRIO value! Must be less then OS_PRIO_BITMAP.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_COMPACT_TCB
+#define OS_COMPACT_TCB        0 /* full-size task control blocks              */
+#endif
+
+#if     OS_COMPACT_TCB && (OS_MAIN_PRIO > 255 || OS_EDF_PRIO > 255 || OS_PRIO_BITMAP > 256)
+#error  osconfig.h: OS_COMPACT_TCB requires task priorities less or equal 255.
+#endif
+
+#if     OS_COMPACT_TCB && OS_ROBIN && ((OS_FREQUENCY)/(OS_ROBIN) > 0xFFFF)
+#error  osconfig.h: OS_COMPACT_TCB requires time slice less or equal 0xFFFF ticks.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_RTC
+#define OS_TASK_RTC           0 /* no run-to-completion tasks                 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_ARENA
+#define OS_TASK_ARENA         0 /* tasks have no default arenas               */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_CACHE
+#define OS_TASK_CACHE         0 /* released work areas are freed immediately  */
+#endif
+
+#ifndef OS_TASK_REENT
+#define OS_TASK_REENT         0 /* tasks share the newlib reentrancy data     */
+#endif
+
+#if     OS_TASK_REENT && (!defined(__GNUC__) || defined(__ARMCC_VERSION))
+#error  osconfig.h: OS_TASK_REENT requires the newlib c library (GNU compiler).
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TIMER_WHEEL
+#define OS_TIMER_WHEEL        0 /* sorted timers queue without timers wheel   */
+#endif
+
+#if     OS_TIMER_WHEEL & (OS_TIMER_WHEEL - 1)
+#error  osconfig.h: Incorrect OS_TIMER_WHEEL value! Must be a power of 2.
+#endif
+
+#if     OS_TIMER_WHEEL && HW_TIMER_SIZE
+#error  osconfig.h: OS_TIMER_WHEEL is not allowed in tick-less mode.
+#endif
+
+#if     OS_TIMER_WHEEL && OS_TICKLESS_IDLE
+#error  osconfig.h: OS_TIMER_WHEEL is not allowed with OS_TICKLESS_IDLE.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TIMER_TASK
+#define OS_TIMER_TASK         0 /* timer callbacks executed by timer handler  */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_EVQ_LOCKFREE
+#define OS_EVQ_LOCKFREE       0 /* event queues without lock-free producer    */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_DEFER_SIZE
+#define OS_DEFER_SIZE         0 /* isr deferred calls are not available       */
+#endif
+
+#if     OS_DEFER_SIZE & (OS_DEFER_SIZE - 1)
+#error  osconfig.h: Incorrect OS_DEFER_SIZE value! Must be a power of 2.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_WAIT_QUEUES
+#define OS_WAIT_QUEUES        0 /* wait on address is not available           */
+#endif
+
+#if     OS_WAIT_QUEUES & (OS_WAIT_QUEUES - 1)
+#error  osconfig.h: Incorrect OS_WAIT_QUEUES value! Must be a power of 2.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_RCU_SIZE
+#define OS_RCU_SIZE           0 /* read-copy-update is not available          */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MEM_LOCKFREE
+#define OS_MEM_LOCKFREE       0 /* memory pools protected by critical section */
+#endif
+
+#ifndef OS_MEM_HEADERLESS
+#define OS_MEM_HEADERLESS     0 /* memory objects preceded by a link word     */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SEM_LOCKFREE
+#define OS_SEM_LOCKFREE       0 /* semaphores protected by critical section   */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MUT_LOCKFREE
+#define OS_MUT_LOCKFREE       0 /* fast mutexes protected by critical section */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SIG_LOCKFREE
+#define OS_SIG_LOCKFREE       0 /* signals protected by critical section      */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_FLG_LOCKFREE
+#define OS_FLG_LOCKFREE       0 /* flags protected by critical section        */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_THRESHOLD
+#define OS_TASK_THRESHOLD     0 /* tasks have no preemption thresholds        */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_BUDGET
+#define OS_TASK_BUDGET        0 /* task execution budgets are not available   */
+#endif
+
+#if     OS_TASK_BUDGET && HW_TIMER_SIZE
+#error  osconfig.h: OS_TASK_BUDGET is not allowed in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_AGING
+#define OS_TASK_AGING         0 /* ready tasks are not aged                   */
+#endif
+
+#if     OS_TASK_AGING && HW_TIMER_SIZE
+#error  osconfig.h: OS_TASK_AGING is not allowed in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_PARTITION
+#define OS_TASK_PARTITION     0 /* no time-partitioned scheduling             */
+#endif
+
+#if     OS_TASK_PARTITION && (OS_TASK_RTC || OS_RCU_SIZE)
+#error  osconfig.h: OS_TASK_PARTITION cannot be used with OS_TASK_RTC or OS_RCU_SIZE.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TIME_TRIGGER
+#define OS_TIME_TRIGGER       0 /* no time-triggered cyclic executive         */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_PERIOD_STATS
+#define OS_PERIOD_STATS       0 /* no overrun / jitter statistics of periods  */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MUT_SPIN
+#define OS_MUT_SPIN           0 /* fast mutex waiters block immediately       */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MTX_DEPTH
+#define OS_MTX_DEPTH          0 /* unlimited priority inheritance chains      */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_NOINIT
+#define OS_NOINIT             0 /* object buffers are cleared at startup      */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_STATS
+#define OS_TASK_STATS         0 /* tasks without cpu usage accounting         */
+#endif
+
+#if     OS_TASK_STATS && (__CORTEX_M < 3)
+#error  osconfig.h: OS_TASK_STATS requires the DWT cycle counter (Cortex-M3 or higher).
+#endif
+
+#ifndef OS_TASK_ENERGY
+#define OS_TASK_ENERGY        0 /* tasks without energy accounting            */
+#endif
+
+#if     OS_TASK_ENERGY && !OS_TASK_STATS
+#error  osconfig.h: OS_TASK_ENERGY requires OS_TASK_STATS.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_LATENCY
+#define OS_TASK_LATENCY       0 /* tasks without wake-to-run latency records  */
+#endif
+
+#if     OS_TASK_LATENCY && (__CORTEX_M < 3)
+#error  osconfig.h: OS_TASK_LATENCY requires the DWT cycle counter (Cortex-M3 or higher).
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_PERF
+#define OS_TASK_PERF          0 /* tasks without hardware event counters      */
+#endif
+
+#if     OS_TASK_PERF && (__CORTEX_M < 3)
+#error  osconfig.h: OS_TASK_PERF requires the DWT profiling counters (Cortex-M3 or higher).
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_LOCK_PROFILE
+#define OS_LOCK_PROFILE       0 /* critical sections are not profiled         */
+#endif
+
+#if     OS_LOCK_PROFILE && (__CORTEX_M < 3)
+#error  osconfig.h: OS_LOCK_PROFILE requires the DWT cycle counter (Cortex-M3 or higher).
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_OBJ_STATS
+#define OS_OBJ_STATS          0 /* no contention statistics of objects        */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_STACK_MONITOR
+#define OS_STACK_MONITOR      0 /* task stacks are not monitored              */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_STACK_GUARD
+#define OS_STACK_GUARD        0 /* task stacks without mpu guard region       */
+#endif
+
+#if     OS_STACK_GUARD && ((__CORTEX_M < 3) || !defined(__MPU_PRESENT) || !__MPU_PRESENT)
+#error  osconfig.h: OS_STACK_GUARD requires the mpu (Cortex-M3 or higher).
+#endif
+
+#if     OS_STACK_GUARD && (defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__))
+#error  osconfig.h: OS_STACK_GUARD is not supported on ARMv8-M Mainline, stack overflow is detected by PSPLIM.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TRACE_SIZE
+#define OS_TRACE_SIZE         0 /* kernel events are not traced               */
+#endif
+
+#if     OS_TRACE_SIZE & (OS_TRACE_SIZE - 1)
+#error  osconfig.h: Incorrect OS_TRACE_SIZE value! Must be a power of 2.
+#endif
+
+#ifndef OS_TRACE_ITM
+#define OS_TRACE_ITM          0 /* kernel events are not streamed through ITM */
+#endif
+
+#if     OS_TRACE_ITM && (__CORTEX_M < 3)
+#error  osconfig.h: OS_TRACE_ITM requires the ITM and the DWT cycle counter (Cortex-M3 or higher).
+#endif
+
+#if     OS_TRACE_ITM > 28
+#error  osconfig.h: Incorrect OS_TRACE_ITM value! Stimulus ports OS_TRACE_ITM .. OS_TRACE_ITM + 3 must exist (up to 28).
+#endif
+
+#ifndef OS_PROFILE_SIZE
+#define OS_PROFILE_SIZE       0 /* pc-sampling profiler is not used           */
+#endif
+
+#if     OS_PROFILE_SIZE & (OS_PROFILE_SIZE - 1)
+#error  osconfig.h: Incorrect OS_PROFILE_SIZE value! Must be a power of 2.
+#endif
+
+#if     OS_PROFILE_SIZE && (!defined(__GNUC__) || defined(__ARMCC_VERSION))
+#error  osconfig.h: OS_PROFILE_SIZE is only supported by the GNUCC port.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SELECT
+#define OS_SELECT             0 /* wait-set objects are not available         */
+#endif
+
+#if     OS_SELECT > 31
+#error  osconfig.h: Incorrect OS_SELECT value! Must be not greater than 31.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_LAZY_FPU
+#define OS_LAZY_FPU           0 /* fpu registers switched with every context  */
+#endif
+
+#if     OS_LAZY_FPU && !__FPU_USED
+#error  osconfig.h: OS_LAZY_FPU requires the fpu to be used.
+#endif
+
+#if     OS_LAZY_FPU && (!defined(__GNUC__) || defined(__ARMCC_VERSION))
+#error  osconfig.h: OS_LAZY_FPU is only supported by the GNUCC port.
+#endif
+
+#if     OS_LAZY_FPU && (OS_LOCK_LEVEL == 0)
+#error  osconfig.h: OS_LAZY_FPU requires OS_LOCK_LEVEL, fpu trap must be able to preempt critical sections.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SYNC_SWITCH
+#define OS_SYNC_SWITCH        0 /* all context switches made by PendSV        */
+#endif
+
+#if     OS_SYNC_SWITCH && ((!defined(__GNUC__) || defined(__ARMCC_VERSION)) || (__CORTEX_M < 3))
+#error  osconfig.h: OS_SYNC_SWITCH is only supported by the GNUCC port for Cortex-M3 and above.
+#endif
+
+#if     OS_SYNC_SWITCH && (OS_LAZY_FPU || OS_TASK_RTC || OS_TASK_PARTITION)
+#error  osconfig.h: OS_SYNC_SWITCH cannot be used with OS_LAZY_FPU, OS_TASK_RTC or OS_TASK_PARTITION.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
 #ifdef  __cplusplus
 
 #ifndef OS_FUNCTIONAL
@@ -90,6 +488,10 @@ extern "C" {
 
 #endif//OS_FUNCTIONAL
 
+#ifndef OS_FUNCTIONAL_SIZE
+#define OS_FUNCTIONAL_SIZE   16 /* capacity of c++ function object in bytes   */
+#endif
+
 #endif
 
 /* -------------------------------------------------------------------------- */
@@ -102,6 +504,14 @@ typedef uint64_t              stk_t;
 extern  stk_t               __initial_sp[];
 #define MAIN_TOP            __initial_sp
 
+/* -------------------------------------------------------------------------- */
+// the dedicated exception stack (OS_ISR_STACK), used through MSP by all handlers;
+// the main task stays on the startup stack, switched to PSP by port_sys_init
+
+#if OS_ISR_STACK
+extern  stk_t               port_isr_stack[];
+#endif
+
 /* -------------------------------------------------------------------------- */
 // task context
 
@@ -142,6 +552,85 @@ void port_ctx_init( ctx_t *ctx, fun_t *pc )
 
 #endif
 
+/* -------------------------------------------------------------------------- */
+// release the fpu registers owned by the task 'tsk'
+
+#if OS_LAZY_FPU
+
+void port_fpu_release( struct __tsk *tsk );
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// set the mpu guard region at the bottom of the task stack 'stack'
+// the region is aligned to its size, so it takes up to 2*GUARD_SIZE-1 bytes of the stack
+
+#if OS_STACK_GUARD
+
+#define GUARD_SIZE          32U // size of the stack guard region (in bytes)
+#define GUARD_REGION         7U // mpu region used for the stack guard (the highest priority)
+#define GUARD_BASE( stack ) (((uint32_t)(stack) + GUARD_SIZE - 1U) & ~(GUARD_SIZE - 1U))
+#define GUARD_TOP( stack )  (void *)(GUARD_BASE(stack) + GUARD_SIZE)
+
+__STATIC_INLINE
+void port_stk_guard( void *stack )
+{
+	MPU->RBAR = GUARD_BASE(stack) | MPU_RBAR_VALID_Msk | GUARD_REGION;
+	MPU->RASR = stack ? MPU_RASR_XN_Msk | (4U << MPU_RASR_SIZE_Pos) | MPU_RASR_ENABLE_Msk : 0U; // 32 bytes, no access
+	__DSB();
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// set the hardware stack limit at the bottom of the task stack 'stack' (ARMv8-M Mainline)
+// a push below the limit raises UsageFault (STKOF) instead of corrupting the memory
+
+#if defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__)
+
+#ifdef  HW_STACK_LIMIT
+#error  HW_STACK_LIMIT is an internal port definition!
+#endif
+
+#define HW_STACK_LIMIT
+
+__STATIC_INLINE
+void port_stk_limit( void *stack )
+{
+	__set_PSPLIM((uint32_t)stack);
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// synchronous context switch for voluntary yields of the current task (thread mode, lock held)
+// only callee-saved registers are saved; the context is stored in the layout of the exception frame
+// with the return address 'port_ctx_resume', so it can also be restored by PendSV
+
+#if OS_SYNC_SWITCH
+
+#if     defined(HW_STACK_LIMIT)
+#error  osconfig.h: OS_SYNC_SWITCH cannot be used with the hardware stack limit.
+#endif
+
+extern char port_ctx_resume[];
+
+void port_ctx_sync( void );
+
+// can the context of the next task with stack pointer 'sp' be restored by port_ctx_sync?
+__STATIC_INLINE
+bool port_ctx_ready( void *sp )
+{
+	ctx_t *ctx = (ctx_t *) sp;
+#if __FPU_USED
+	if (__get_CONTROL() & CONTROL_FPCA_Msk)
+		return false; // the current task has an active fpu context
+#endif
+	return ((uintptr_t)ctx->pc | 1U) == ((uintptr_t)port_ctx_resume | 1U) && (ctx->lr & 0x10U) != 0U; // basic frame
+}
+
+#endif
+
 /* -------------------------------------------------------------------------- */
 // is procedure inside ISR?
 
@@ -151,6 +640,27 @@ bool port_isr_inside( void )
 	return (__get_IPSR() != 0U);
 }
 
+/* -------------------------------------------------------------------------- */
+// is procedure executed in thread mode or in a kernel-aware handler?
+// handlers with the urgency higher (the priority value less) than OS_LOCK_LEVEL are not masked
+// by critical sections, so they must not use the kernel; they can only use 'sys_defer'
+
+__STATIC_INLINE
+bool port_isr_aware( void )
+{
+	uint32_t ipsr = __get_IPSR();
+
+	if (ipsr == 0U)
+		return true;
+	if (ipsr < 4U) // NMI, HardFault
+		return false;
+#if OS_LOCK_LEVEL && (__CORTEX_M >= 3)
+	return (NVIC_GetPriority((IRQn_Type)((int32_t)ipsr - 16)) >= (OS_LOCK_LEVEL));
+#else
+	return true;
+#endif
+}
+
 /* -------------------------------------------------------------------------- */
 // are interrupts masked?
 
@@ -173,6 +683,140 @@ void * port_get_sp( void )
 	return (void *) __get_PSP();
 }
 
+/* -------------------------------------------------------------------------- */
+// get index of the most significant bit set in non-zero value 'val'
+
+__STATIC_INLINE
+unsigned port_get_msb( uint32_t val )
+{
+#if __CORTEX_M >= 3
+	return 31U - __CLZ(val);
+#else
+	unsigned msb = 0;
+	if (val & 0xFFFF0000U) { val >>= 16; msb += 16; }
+	if (val & 0x0000FF00U) { val >>=  8; msb +=  8; }
+	if (val & 0x000000F0U) { val >>=  4; msb +=  4; }
+	if (val & 0x0000000CU) { val >>=  2; msb +=  2; }
+	if (val & 0x00000002U) {             msb +=  1; }
+	return msb;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+// return number of SysTick counts elapsed in the current system tick
+// must be called with interrupts masked; if the tick interrupt is already pending,
+// the counter is read again after its reload and the tick counter 'cnt' is advanced
+
+#ifdef  HW_TICK_FREQUENCY
+
+__STATIC_INLINE
+uint32_t port_tck_time( cnt_t *cnt )
+{
+	uint32_t val = SysTick->VAL;
+
+	if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		val = SysTick->VAL;
+		(*cnt)++;
+	}
+
+	return SysTick->LOAD - val;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// get current value of the cpu cycle counter
+
+#if __CORTEX_M >= 3
+
+#ifdef  HW_CYCLE_COUNTER
+#error  HW_CYCLE_COUNTER is an internal port definition!
+#endif
+
+#define HW_CYCLE_COUNTER
+
+__STATIC_INLINE
+uint32_t port_cyc_time( void )
+{
+	return DWT->CYCCNT;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// hardware performance counters of the DWT unit
+// cpi, exc, sleep, lsu and fold are 8-bit hardware counters wrapping every 256 events,
+// port_pfc_account must be called at least once per 256 counted cycles to keep the counts exact
+
+#if OS_TASK_PERF
+
+typedef struct __pfc pfc_t;
+
+struct __pfc
+{
+	uint32_t cyc;   // cpu cycles (CYCCNT)
+	uint32_t cpi;   // additional cycles of multi-cycle instructions and instruction fetch stalls (CPICNT)
+	uint32_t exc;   // cycles of exception entry / exit overhead (EXCCNT)
+	uint32_t sleep; // cycles spent in sleep mode (SLEEPCNT)
+	uint32_t lsu;   // additional cycles of load / store instructions (LSUCNT)
+	uint32_t fold;  // folded instructions, executed in zero cycles (FOLDCNT)
+};
+
+// add the events counted since the snapshot 'stamp' to 'acc' and update the snapshot
+__STATIC_INLINE
+void port_pfc_account( pfc_t *acc, pfc_t *stamp )
+{
+	pfc_t now;
+
+	now.cyc   = DWT->CYCCNT;
+	now.cpi   = DWT->CPICNT;
+	now.exc   = DWT->EXCCNT;
+	now.sleep = DWT->SLEEPCNT;
+	now.lsu   = DWT->LSUCNT;
+	now.fold  = DWT->FOLDCNT;
+
+	acc->cyc   += now.cyc - stamp->cyc;
+	acc->cpi   += (now.cpi   - stamp->cpi)   & 0xFFU;
+	acc->exc   += (now.exc   - stamp->exc)   & 0xFFU;
+	acc->sleep += (now.sleep - stamp->sleep) & 0xFFU;
+	acc->lsu   += (now.lsu   - stamp->lsu)   & 0xFFU;
+	acc->fold  += (now.fold  - stamp->fold)  & 0xFFU;
+
+	*stamp = now;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// write a trace record to ITM stimulus ports OS_TRACE_ITM .. OS_TRACE_ITM + 3 without waiting
+// return false if the record was dropped (ITM or stimulus ports disabled, stimulus fifo full)
+// a partially written record is detected by the host from the sequence of stimulus ports
+
+#if OS_TRACE_ITM
+
+__STATIC_INLINE
+bool port_trc_send( uint32_t time, uint32_t code, uint32_t obj, uint32_t arg )
+{
+	const uint32_t msk = 0xFU << OS_TRACE_ITM;
+	const uint32_t val[4] = { time, code, obj, arg };
+	unsigned i;
+
+	if ((ITM->TCR & ITM_TCR_ITMENA_Msk) == 0 || (ITM->TER & msk) != msk)
+		return false;
+
+	for (i = 0; i < 4; i++)
+	{
+		if (ITM->PORT[OS_TRACE_ITM + i].u32 == 0)
+			return false;
+		ITM->PORT[OS_TRACE_ITM + i].u32 = val[i];
+	}
+
+	return true;
+}
+
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 #if   defined(__CSMC__)
@@ -203,6 +847,92 @@ void * port_get_sp( void )
 #endif
 
 #define port_set_barrier()  __ISB()
+#define port_mem_barrier()  __DMB()
+
+/* -------------------------------------------------------------------------- */
+// atomically replace pointer '*ptr' with 'val' if it is still equal to 'old'
+
+__STATIC_INLINE
+bool port_atomic_cas( void * volatile *ptr, void *old, void *val )
+{
+#if __CORTEX_M >= 3
+	do if (__LDREXW((volatile uint32_t *)ptr) != (uint32_t)old) { __CLREX(); return false; }
+	while (__STREXW((uint32_t)val, (volatile uint32_t *)ptr));
+	return true;
+#else
+	bool  result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = (*ptr == old);
+	if (result) *ptr = val;
+	port_put_lock(lck);
+	return result;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically replace value '*ptr' with 'val' if it is still equal to 'old'
+
+__STATIC_INLINE
+bool port_atomic_cas32( volatile uint32_t *ptr, uint32_t old, uint32_t val )
+{
+#if __CORTEX_M >= 3
+	do if (__LDREXW(ptr) != old) { __CLREX(); return false; }
+	while (__STREXW(val, ptr));
+	return true;
+#else
+	bool  result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = (*ptr == old);
+	if (result) *ptr = val;
+	port_put_lock(lck);
+	return result;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically replace pointer '*ptr' with 'val' if it is still equal to 'old' and no task is waiting in queue '*que'
+// (queue can only be modified in another exception or task context, which clears the exclusive monitor)
+
+__STATIC_INLINE
+bool port_atomic_cas_idle( void * volatile *ptr, void *old, void *val, void * volatile *que )
+{
+#if __CORTEX_M >= 3
+	do if (__LDREXW((volatile uint32_t *)ptr) != (uint32_t)old || *que) { __CLREX(); return false; }
+	while (__STREXW((uint32_t)val, (volatile uint32_t *)ptr));
+	return true;
+#else
+	bool  result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = (*ptr == old && *que == 0);
+	if (result) *ptr = val;
+	port_put_lock(lck);
+	return result;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically replace value '*ptr' with 'val' if it is still equal to 'old' and no task is waiting in queue '*que'
+
+__STATIC_INLINE
+bool port_atomic_cas32_idle( volatile uint32_t *ptr, uint32_t old, uint32_t val, void * volatile *que )
+{
+#if __CORTEX_M >= 3
+	do if (__LDREXW(ptr) != old || *que) { __CLREX(); return false; }
+	while (__STREXW(val, ptr));
+	return true;
+#else
+	bool  result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = (*ptr == old && *que == 0);
+	if (result) *ptr = val;
+	port_put_lock(lck);
+	return result;
+#endif
+}
 
 /* -------------------------------------------------------------------------- */
 
@@ -226,6 +956,21 @@ void port_spn_lock( volatile unsigned *lock )
 
 #endif//__CORTEX_M
 
+/* -------------------------------------------------------------------------- */
+// mask / unmask the interrupt 'irq' in the nvic (interrupt service tasks)
+
+__STATIC_INLINE
+void port_irq_mask( unsigned irq )
+{
+	NVIC_DisableIRQ((IRQn_Type)irq);
+}
+
+__STATIC_INLINE
+void port_irq_unmask( unsigned irq )
+{
+	NVIC_EnableIRQ((IRQn_Type)irq);
+}
+
 /* -------------------------------------------------------------------------- */
 
 #ifdef __cplusplus
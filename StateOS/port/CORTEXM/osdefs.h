@@ -41,18 +41,30 @@
 #warning No compiler specific solution for __CONSTRUCTOR. __CONSTRUCTOR is ignored.
 #endif
 
+#ifndef __NOINIT
+#define __NOINIT
+#endif
+
 #elif defined(__ICCARM__)
 
 #ifndef __CONSTRUCTOR
 #define __CONSTRUCTOR
 #endif
 
+#ifndef __NOINIT
+#define __NOINIT            __no_init
+#endif
+
 #else
 
 #ifndef __CONSTRUCTOR
 #define __CONSTRUCTOR       __attribute__((constructor))
 #endif
 
+#ifndef __NOINIT
+#define __NOINIT            __attribute__((section(".noinit")))
+#endif
+
 #endif
 
 /* -------------------------------------------------------------------------- */
@@ -0,0 +1,769 @@
+/******************************************************************************
+
+    @file    StateOS: oscore.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   StateOS port file for RISC-V (RV32IMAC).
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOSCORE_H
+#define __STATEOSCORE_H
+
+#include "osbase.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_HEAP_SIZE
+#define OS_HEAP_SIZE          0 /* default system heap: all free memory       */
+#endif
+
+#ifndef OS_HEAP_TLSF
+#define OS_HEAP_TLSF          0 /* system heap uses first-fit allocator       */
+#endif
+
+#ifndef OS_HEAP_SLAB
+#define OS_HEAP_SLAB          0 /* control blocks allocated from system heap  */
+#endif
+
+#ifndef OS_HEAP_QUOTA
+#define OS_HEAP_QUOTA         0 /* system heap usage is not charged to tasks  */
+#endif
+
+#ifndef OS_HEAP_COALESCE
+#define OS_HEAP_COALESCE      0 /* free segments are merged during allocation */
+#endif
+
+#if     OS_HEAP_COALESCE && (OS_HEAP_SIZE == 0 || OS_HEAP_TLSF)
+#error  osconfig.h: OS_HEAP_COALESCE requires the first-fit system heap (OS_HEAP_SIZE without OS_HEAP_TLSF).
+#endif
+
+#ifndef OS_LIBC_MUTEX
+#define OS_LIBC_MUTEX         0 /* c library locks mask interrupts            */
+#endif
+
+#if     OS_LIBC_MUTEX
+#error  osconfig.h: OS_LIBC_MUTEX is only available on Cortex-M ports.
+#endif
+
+/* -------------------------------------------------------------------------- */
+// handlers are executed on the interrupt stack, task stacks hold only the trap frame (128 bytes)
+
+#ifndef OS_STACK_SIZE
+#define OS_STACK_SIZE       512 /* default task stack size in bytes           */
+#endif
+
+#ifndef OS_IDLE_STACK
+#define OS_IDLE_STACK       256 /* idle task stack size in bytes              */
+#endif
+
+#ifndef OS_ISR_STACK
+#define OS_ISR_STACK       1024 /* interrupt stack size in bytes              */
+#endif
+
+#if     OS_IDLE_STACK < 256
+#error  osconfig.h: Incorrect OS_IDLE_STACK value! Must be at least 256 bytes (the trap frame takes 128 bytes).
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_LOCK_LEVEL
+#define OS_LOCK_LEVEL         0 /* critical section blocks all interrupts     */
+#endif
+
+#if     OS_LOCK_LEVEL && !OS_CLIC
+#error  osconfig.h: OS_LOCK_LEVEL requires the clic (OS_CLIC), there are no interrupt levels in the clint mode.
+#endif
+
+#if     OS_LOCK_LEVEL && OS_CLIC && (OS_LOCK_LEVEL >= (1 << (CLIC_INTCTLBITS)))
+#error  osconfig.h: Incorrect OS_LOCK_LEVEL value! Must be less then 2^CLIC_INTCTLBITS.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MAIN_PRIO
+#define OS_MAIN_PRIO          0 /* priority of main process                   */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_PRIO_BITMAP
+#define OS_PRIO_BITMAP        0 /* tasks queue without priority bitmap        */
+#endif
+
+#if     OS_PRIO_BITMAP > 1024
+#error  osconfig.h: Incorrect OS_PRIO_BITMAP value! Must be less or equal 1024.
+#endif
+
+#if     OS_PRIO_BITMAP && (OS_MAIN_PRIO >= OS_PRIO_BITMAP)
+#error  osconfig.h: Incorrect OS_MAIN_PRIO value! Must be less then OS_PRIO_BITMAP.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_EDF_PRIO
+#define OS_EDF_PRIO           0 /* no earliest-deadline-first priority level  */
+#endif
+
+#if     OS_PRIO_BITMAP && (OS_EDF_PRIO >= OS_PRIO_BITMAP)
+#error  osconfig.h: Incorrect OS_EDF_PRIO value! Must be less then OS_PRIO_BITMAP.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_COMPACT_TCB
+#define OS_COMPACT_TCB        0 /* full-size task control blocks              */
+#endif
+
+#if     OS_COMPACT_TCB && (OS_MAIN_PRIO > 255 || OS_EDF_PRIO > 255 || OS_PRIO_BITMAP > 256)
+#error  osconfig.h: OS_COMPACT_TCB requires task priorities less or equal 255.
+#endif
+
+#if     OS_COMPACT_TCB && OS_ROBIN && ((OS_FREQUENCY)/(OS_ROBIN) > 0xFFFF)
+#error  osconfig.h: OS_COMPACT_TCB requires time slice less or equal 0xFFFF ticks.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_RTC
+#define OS_TASK_RTC           0 /* no run-to-completion tasks                 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_ARENA
+#define OS_TASK_ARENA         0 /* tasks have no default arenas               */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_CACHE
+#define OS_TASK_CACHE         0 /* released work areas are freed immediately  */
+#endif
+
+#ifndef OS_TASK_REENT
+#define OS_TASK_REENT         0 /* tasks share the newlib reentrancy data     */
+#endif
+
+#if     OS_TASK_REENT && (!defined(__GNUC__) || defined(__ARMCC_VERSION))
+#error  osconfig.h: OS_TASK_REENT requires the newlib c library (GNU compiler).
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TIMER_WHEEL
+#define OS_TIMER_WHEEL        0 /* sorted timers queue without timers wheel   */
+#endif
+
+#if     OS_TIMER_WHEEL & (OS_TIMER_WHEEL - 1)
+#error  osconfig.h: Incorrect OS_TIMER_WHEEL value! Must be a power of 2.
+#endif
+
+#if     OS_TIMER_WHEEL && HW_TIMER_SIZE
+#error  osconfig.h: OS_TIMER_WHEEL is not allowed in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TIMER_TASK
+#define OS_TIMER_TASK         0 /* timer callbacks executed by timer handler  */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_EVQ_LOCKFREE
+#define OS_EVQ_LOCKFREE       0 /* event queues without lock-free producer    */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_DEFER_SIZE
+#define OS_DEFER_SIZE         0 /* isr deferred calls are not available       */
+#endif
+
+#if     OS_DEFER_SIZE & (OS_DEFER_SIZE - 1)
+#error  osconfig.h: Incorrect OS_DEFER_SIZE value! Must be a power of 2.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_WAIT_QUEUES
+#define OS_WAIT_QUEUES        0 /* wait on address is not available           */
+#endif
+
+#if     OS_WAIT_QUEUES & (OS_WAIT_QUEUES - 1)
+#error  osconfig.h: Incorrect OS_WAIT_QUEUES value! Must be a power of 2.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_RCU_SIZE
+#define OS_RCU_SIZE           0 /* read-copy-update is not available          */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MEM_LOCKFREE
+#define OS_MEM_LOCKFREE       0 /* memory pools protected by critical section */
+#endif
+
+#ifndef OS_MEM_HEADERLESS
+#define OS_MEM_HEADERLESS     0 /* memory objects preceded by a link word     */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SEM_LOCKFREE
+#define OS_SEM_LOCKFREE       0 /* semaphores protected by critical section   */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MUT_LOCKFREE
+#define OS_MUT_LOCKFREE       0 /* fast mutexes protected by critical section */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SIG_LOCKFREE
+#define OS_SIG_LOCKFREE       0 /* signals protected by critical section      */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_FLG_LOCKFREE
+#define OS_FLG_LOCKFREE       0 /* flags protected by critical section        */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_THRESHOLD
+#define OS_TASK_THRESHOLD     0 /* tasks have no preemption thresholds        */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_BUDGET
+#define OS_TASK_BUDGET        0 /* task execution budgets are not available   */
+#endif
+
+#if     OS_TASK_BUDGET && HW_TIMER_SIZE
+#error  osconfig.h: OS_TASK_BUDGET is not allowed in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_AGING
+#define OS_TASK_AGING         0 /* ready tasks are not aged                   */
+#endif
+
+#if     OS_TASK_AGING && HW_TIMER_SIZE
+#error  osconfig.h: OS_TASK_AGING is not allowed in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_PARTITION
+#define OS_TASK_PARTITION     0 /* no time-partitioned scheduling             */
+#endif
+
+#if     OS_TASK_PARTITION && (OS_TASK_RTC || OS_RCU_SIZE)
+#error  osconfig.h: OS_TASK_PARTITION cannot be used with OS_TASK_RTC or OS_RCU_SIZE.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TIME_TRIGGER
+#define OS_TIME_TRIGGER       0 /* no time-triggered cyclic executive         */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_PERIOD_STATS
+#define OS_PERIOD_STATS       0 /* no overrun / jitter statistics of periods  */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MUT_SPIN
+#define OS_MUT_SPIN           0 /* fast mutex waiters block immediately       */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MTX_DEPTH
+#define OS_MTX_DEPTH          0 /* unlimited priority inheritance chains      */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_NOINIT
+#define OS_NOINIT             0 /* object buffers are cleared at startup      */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_STATS
+#define OS_TASK_STATS         0 /* tasks without cpu usage accounting         */
+#endif
+
+#ifndef OS_TASK_ENERGY
+#define OS_TASK_ENERGY        0 /* tasks without energy accounting            */
+#endif
+
+#if     OS_TASK_ENERGY && !OS_TASK_STATS
+#error  osconfig.h: OS_TASK_ENERGY requires OS_TASK_STATS.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_LATENCY
+#define OS_TASK_LATENCY       0 /* tasks without wake-to-run latency records  */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_LOCK_PROFILE
+#define OS_LOCK_PROFILE       0 /* critical sections are not profiled         */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_OBJ_STATS
+#define OS_OBJ_STATS          0 /* no contention statistics of objects        */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_STACK_MONITOR
+#define OS_STACK_MONITOR      0 /* task stacks are not monitored              */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_STACK_GUARD
+#define OS_STACK_GUARD        0 /* task stacks without mpu guard region       */
+#endif
+
+#if     OS_STACK_GUARD
+#error  osconfig.h: OS_STACK_GUARD is not supported by the RISC-V port.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TRACE_SIZE
+#define OS_TRACE_SIZE         0 /* kernel events are not traced               */
+#endif
+
+#if     OS_TRACE_SIZE & (OS_TRACE_SIZE - 1)
+#error  osconfig.h: Incorrect OS_TRACE_SIZE value! Must be a power of 2.
+#endif
+
+#ifndef OS_TASK_PERF
+#define OS_TASK_PERF          0 /* tasks without hardware event counters      */
+#endif
+
+#if     OS_TASK_PERF
+#error  osconfig.h: OS_TASK_PERF is only available on Cortex-M ports.
+#endif
+
+#ifndef OS_TRACE_ITM
+#define OS_TRACE_ITM          0 /* kernel events are not streamed through ITM */
+#endif
+
+#if     OS_TRACE_ITM
+#error  osconfig.h: OS_TRACE_ITM is only available on Cortex-M ports.
+#endif
+
+#ifndef OS_PROFILE_SIZE
+#define OS_PROFILE_SIZE       0 /* pc-sampling profiler is not used           */
+#endif
+
+#if     OS_PROFILE_SIZE & (OS_PROFILE_SIZE - 1)
+#error  osconfig.h: Incorrect OS_PROFILE_SIZE value! Must be a power of 2.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SELECT
+#define OS_SELECT             0 /* wait-set objects are not available         */
+#endif
+
+#if     OS_SELECT > 31
+#error  osconfig.h: Incorrect OS_SELECT value! Must be not greater than 31.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SYNC_SWITCH
+#define OS_SYNC_SWITCH        0 /* all context switches made by the port      */
+#endif
+
+#if     OS_SYNC_SWITCH
+#error  osconfig.h: OS_SYNC_SWITCH is only supported by the Cortex-M port.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef  __cplusplus
+
+#ifndef OS_FUNCTIONAL
+#define OS_FUNCTIONAL         1 /* include c++ functional library header      */
+#endif
+
+#ifndef OS_FUNCTIONAL_SIZE
+#define OS_FUNCTIONAL_SIZE   16 /* capacity of c++ function object in bytes   */
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+/* -------------------------------------------------------------------------- */
+
+#if     !defined(__riscv) || (__riscv_xlen != 32)
+#error  The RISC-V port supports only the RV32 cores.
+#endif
+
+#if     defined(__riscv_flen)
+#error  The RISC-V port does not save the fpu registers, use the soft-float abi (e.g. -march=rv32imac -mabi=ilp32).
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+typedef uint32_t              lck_t;
+typedef struct { uint32_t v[4]; } __attribute__((aligned(16))) stk_t;
+
+/* -------------------------------------------------------------------------- */
+// machine mode control and status registers
+
+#define MSTATUS_MIE         0x00000008U
+#define MSTATUS_MPIE        0x00000080U
+#define MSTATUS_MPP         0x00001800U
+
+#define MIE_MSIE            0x00000008U
+#define MIE_MTIE            0x00000080U
+
+#define MCAUSE_IRQ          0x80000000U
+#define MCAUSE_CODE         0x00000FFFU
+#define MCAUSE_MSI         (MCAUSE_IRQ | 3U) // machine software interrupt (context switch)
+#define MCAUSE_MTI         (MCAUSE_IRQ | 7U) // machine timer interrupt (system timer)
+
+#define __csr_read( csr )        ({ uint32_t __v; __asm volatile ("csrr %0, " #csr : "=r" (__v) :: "memory"); __v; })
+#define __csr_write( csr, val )  __asm volatile ("csrw " #csr ", %0" :: "rK" (val) : "memory")
+#define __csr_set( csr, val )    __asm volatile ("csrs " #csr ", %0" :: "rK" (val) : "memory")
+#define __csr_clr( csr, val )    __asm volatile ("csrc " #csr ", %0" :: "rK" (val) : "memory")
+
+/* -------------------------------------------------------------------------- */
+// task context (trap frame)
+
+typedef struct __ctx ctx_t;
+
+struct __ctx
+{
+	// context saved by the trap entry
+	fun_t   * pc;       // mepc
+	uint32_t  mstatus;
+	uint32_t  ra;
+	uint32_t  t0, t1, t2;
+	// callee-saved registers, saved only by the context switch
+	uint32_t  s0, s1;
+	// context saved by the trap entry
+	uint32_t  a0, a1, a2, a3, a4, a5, a6, a7;
+	// callee-saved registers, saved only by the context switch
+	uint32_t  s2, s3, s4, s5, s6, s7, s8, s9, s10, s11;
+	// context saved by the trap entry
+	uint32_t  t3, t4, t5, t6;
+	uint32_t  reserved[2]; // keeps the stack aligned to 16 bytes
+};
+
+// mret to machine mode with interrupts enabled
+#define _CTX_INIT( pc ) { pc, MSTATUS_MPP | MSTATUS_MPIE }
+
+/* -------------------------------------------------------------------------- */
+// init task context
+
+__STATIC_INLINE
+void port_ctx_init( ctx_t *ctx, fun_t *pc )
+{
+	ctx->pc      = pc;
+	ctx->mstatus = MSTATUS_MPP | MSTATUS_MPIE;
+}
+
+/* -------------------------------------------------------------------------- */
+// the interrupt stack, all handlers executed by the trap entry use it
+
+extern stk_t port_isr_stack[];
+
+/* -------------------------------------------------------------------------- */
+// is procedure inside ISR?
+// clint mode: handlers are not nested and are executed on the interrupt stack
+// clic mode: the current interrupt level (mintstatus.mil) is above zero
+
+__STATIC_INLINE
+bool port_isr_inside( void )
+{
+#if OS_CLIC
+	return (__csr_read(0xFB1) >> 24) != 0U; // mintstatus
+#else
+	uintptr_t sp;
+	__asm volatile ("mv %0, sp" : "=r" (sp));
+	return (sp - (uintptr_t)port_isr_stack) < (OS_ISR_STACK);
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+// critical sections raise the interrupt threshold (mintthresh) with OS_LOCK_LEVEL,
+// otherwise they clear the global interrupt enable bit (mstatus.MIE)
+// interrupt levels are left-justified in clicintctl, unimplemented bits read as one
+
+#if OS_LOCK_LEVEL
+
+#define LOCK_THRESHOLD     ((((OS_LOCK_LEVEL) + 1U) << (8 - (CLIC_INTCTLBITS))) - 1U)
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// is procedure executed in thread mode or in a kernel-aware handler?
+// with OS_LOCK_LEVEL, handlers of the level higher than OS_LOCK_LEVEL are not masked
+// by critical sections, so they must not use the kernel; they can only use 'sys_defer'
+
+__STATIC_INLINE
+bool port_isr_aware( void )
+{
+#if OS_LOCK_LEVEL
+	return (__csr_read(0xFB1) >> 24) <= LOCK_THRESHOLD; // mintstatus
+#else
+	return true;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+// are interrupts masked?
+
+__STATIC_INLINE
+bool port_isr_masked( void )
+{
+#if OS_LOCK_LEVEL
+	return (__csr_read(0x347) != 0U) || ((__csr_read(mstatus) & MSTATUS_MIE) == 0U); // mintthresh
+#else
+	return ((__csr_read(mstatus) & MSTATUS_MIE) == 0U);
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+// get current stack pointer
+// inside ISR: the stack pointer of the interrupted task, saved in mscratch by the trap entry
+
+__STATIC_INLINE
+void * port_get_sp( void )
+{
+	void *sp;
+	if (port_isr_inside())
+		return (void *) __csr_read(mscratch);
+	__asm volatile ("mv %0, sp" : "=r" (sp));
+	return sp;
+}
+
+/* -------------------------------------------------------------------------- */
+// get index of the most significant bit set in non-zero value 'val'
+
+__STATIC_INLINE
+unsigned port_get_msb( uint32_t val )
+{
+	return 31U - (unsigned) __builtin_clz(val);
+}
+
+/* -------------------------------------------------------------------------- */
+// return number of mtime counts elapsed in the current system tick
+// must be called with interrupts masked; if the tick interrupt is already pending,
+// the tick counter 'cnt' is advanced
+
+#ifdef  HW_TICK_FREQUENCY
+
+__STATIC_INLINE
+uint32_t port_tck_time( cnt_t *cnt )
+{
+	uint32_t tck = CLINT_MTIME[0] - (CLINT_MTIMECMP[0] - (MTIME_FREQUENCY)/(OS_FREQUENCY));
+
+	if (tck >= (MTIME_FREQUENCY)/(OS_FREQUENCY))
+	{
+		tck -= (MTIME_FREQUENCY)/(OS_FREQUENCY);
+		(*cnt)++;
+	}
+
+	return tck;
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// get current value of the cpu cycle counter
+
+#ifdef  HW_CYCLE_COUNTER
+#error  HW_CYCLE_COUNTER is an internal port definition!
+#endif
+
+#define HW_CYCLE_COUNTER
+
+__STATIC_INLINE
+uint32_t port_cyc_time( void )
+{
+	return __csr_read(mcycle);
+}
+
+/* -------------------------------------------------------------------------- */
+// wait for a signal (interrupt)
+
+#define __WFI()             __asm volatile ("wfi" ::: "memory")
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_LOCK_LEVEL
+
+#define port_get_lock()     __csr_read(0x347)
+#define port_put_lock(lck)  __csr_write(0x347, lck)
+
+#define port_set_lock()     __csr_write(0x347, LOCK_THRESHOLD)
+#define port_clr_lock()     __csr_write(0x347, 0)
+
+#else
+
+// handlers are executed with interrupts disabled, unlocking inside ISR does not enable nesting
+
+__STATIC_INLINE
+lck_t port_get_lock( void )
+{
+	return __csr_read(mstatus) & MSTATUS_MIE;
+}
+
+__STATIC_INLINE
+void port_put_lock( lck_t lck )
+{
+	__csr_clr(mstatus, MSTATUS_MIE);
+	__csr_set(mstatus, lck);
+}
+
+__STATIC_INLINE
+void port_set_lock( void )
+{
+	__csr_clr(mstatus, MSTATUS_MIE);
+}
+
+__STATIC_INLINE
+void port_clr_lock( void )
+{
+	if (!port_isr_inside())
+		__csr_set(mstatus, MSTATUS_MIE);
+}
+
+#endif
+
+#define port_set_barrier()  __asm volatile ("" ::: "memory")
+#define port_mem_barrier()  __asm volatile ("fence" ::: "memory")
+
+/* -------------------------------------------------------------------------- */
+// atomically replace pointer '*ptr' with 'val' if it is still equal to 'old'
+
+__STATIC_INLINE
+bool port_atomic_cas( void * volatile *ptr, void *old, void *val )
+{
+	return __atomic_compare_exchange_n(ptr, &old, val, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically replace value '*ptr' with 'val' if it is still equal to 'old'
+
+__STATIC_INLINE
+bool port_atomic_cas32( volatile uint32_t *ptr, uint32_t old, uint32_t val )
+{
+	return __atomic_compare_exchange_n(ptr, &old, val, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically replace pointer '*ptr' with 'val' if it is still equal to 'old' and no task is waiting in queue '*que'
+// (loads between lr and sc do not guarantee the forward progress, the critical section is used instead)
+
+__STATIC_INLINE
+bool port_atomic_cas_idle( void * volatile *ptr, void *old, void *val, void * volatile *que )
+{
+	bool  result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = (*ptr == old && *que == 0);
+	if (result) *ptr = val;
+	port_put_lock(lck);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically replace value '*ptr' with 'val' if it is still equal to 'old' and no task is waiting in queue '*que'
+
+__STATIC_INLINE
+bool port_atomic_cas32_idle( volatile uint32_t *ptr, uint32_t old, uint32_t val, void * volatile *que )
+{
+	bool  result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = (*ptr == old && *que == 0);
+	if (result) *ptr = val;
+	port_put_lock(lck);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+// mask / unmask the interrupt 'irq' (exception code of mcause) in the clic or in the 'mie' register (interrupt service tasks)
+
+__STATIC_INLINE
+void port_irq_mask( unsigned irq )
+{
+#if OS_CLIC
+	CLIC_INTIE(irq) = 0U;
+#else
+	__csr_clr(mie, 1U << irq);
+#endif
+}
+
+__STATIC_INLINE
+void port_irq_unmask( unsigned irq )
+{
+#if OS_CLIC
+	CLIC_INTIE(irq) = 1U;
+#else
+	__csr_set(mie, 1U << irq);
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//__STATEOSCORE_H
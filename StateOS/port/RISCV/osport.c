@@ -0,0 +1,373 @@
+/******************************************************************************
+
+    @file    StateOS: osport.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   StateOS port file for RISC-V (RV32IMAC).
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#if defined(__riscv) && defined(__GNUC__)
+
+#include "oskernel.h"
+
+/******************************************************************************
+ RISC-V port
+ All traps are taken in machine mode by the single trap entry (port_trap_entry).
+ The machine software interrupt (CLINT msip) plays the role of PendSV: it is the
+ only trap that saves the callee-saved registers and switches the task context.
+ The machine timer (mtime / mtimecmp) is the system timer, it is reloaded with
+ every tick or, in tick-less mode, set to the nearest time breakpoint.
+ Handlers are not nested and are executed on the interrupt stack, the trap frame
+ (128 bytes) is pushed onto the stack of the interrupted task.
+ Other interrupts are passed to the weak function port_irq_handler and
+ exceptions to the weak function port_exc_handler.
+ With OS_CLIC, non-vectored clic interrupts enter through the same trap entry;
+ vectored (selective hardware vectoring) handlers of the level above OS_LOCK_LEVEL
+ are kernel-unaware and are not masked by critical sections.
+*******************************************************************************/
+
+stk_t port_isr_stack[SSIZE(OS_ISR_STACK)];
+
+#define ISR_TOP (port_isr_stack+SSIZE(OS_ISR_STACK))
+
+/* -------------------------------------------------------------------------- */
+
+void port_trap_entry( void );
+
+__attribute__((weak))
+void port_irq_handler( unsigned id )
+{
+	(void) id;
+	for (;;);
+}
+
+__attribute__((weak))
+void port_exc_handler( uint32_t cause )
+{
+	(void) cause;
+	for (;;);
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if HW_TIMER_SIZE == 0
+static uint64_t Tick; // the next tick boundary in mtime counts
+#endif
+
+__STATIC_INLINE
+uint64_t priv_mtime( void )
+{
+	uint32_t hi, lo;
+
+	do
+	{
+		hi = CLINT_MTIME[1];
+		lo = CLINT_MTIME[0];
+	}
+	while (hi != CLINT_MTIME[1]);
+
+	return ((uint64_t) hi << 32) | lo;
+}
+
+__STATIC_INLINE
+void priv_mtimecmp( uint64_t cmp )
+{
+	// no spurious interrupt with the new high word and the old low word
+	CLINT_MTIMECMP[0] = UINT32_MAX;
+	CLINT_MTIMECMP[1] = (uint32_t)(cmp >> 32);
+	CLINT_MTIMECMP[0] = (uint32_t)(cmp);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void port_sys_init( void )
+{
+	static bool init = false;
+
+	if (init) return;
+	init = true;
+
+/******************************************************************************
+ Painting of the interrupt stack for high-water mark examination (sys_isrStackUsed)
+*******************************************************************************/
+
+	memset(port_isr_stack, 0xFF, sizeof(port_isr_stack));
+
+#if HW_TIMER_SIZE == 0
+
+/******************************************************************************
+ Non-tick-less mode: configuration of system timer
+ It must generate interrupts with frequency OS_FREQUENCY
+*******************************************************************************/
+
+	#if (MTIME_FREQUENCY)/(OS_FREQUENCY) == 0
+	#error Incorrect machine timer frequency!
+	#endif
+
+	Tick = priv_mtime() + (MTIME_FREQUENCY)/(OS_FREQUENCY);
+	priv_mtimecmp(Tick);
+
+#else //HW_TIMER_SIZE
+
+/******************************************************************************
+ Tick-less mode: configuration of system timer
+ Time breakpoint is cleared, mtime is rescaled to frequency OS_FREQUENCY
+*******************************************************************************/
+
+	port_tmr_stop();
+
+#endif//HW_TIMER_SIZE
+
+/******************************************************************************
+ Configuration of interrupts for system timer and context switch
+*******************************************************************************/
+
+	CLINT_MSIP = 0U;
+
+	#if OS_CLIC
+	CLIC_CFG = (CLIC_INTCTLBITS) << 1; // nlbits: all implemented bits of clicintctl are the level
+	CLIC_INTCTL(3) = 0U;               // the lowest level
+	CLIC_INTCTL(7) = 0U;
+	CLIC_INTIE(3) = 1U;
+	CLIC_INTIE(7) = 1U;
+	__csr_write(0x347, 0);             // mintthresh
+	__csr_write(mtvec, (uint32_t) port_trap_entry | 3U);
+	#else
+	__csr_write(mtvec, (uint32_t) port_trap_entry);
+	__csr_set(mie, MIE_MSIE | MIE_MTIE);
+	#endif
+
+	__csr_set(mstatus, MSTATUS_MIE);
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if HW_TIMER_SIZE
+
+/******************************************************************************
+ Tick-less mode: return current system time
+*******************************************************************************/
+
+#define MTIME_DIV ((MTIME_FREQUENCY)/(OS_FREQUENCY))
+
+#if     OS_TIMER_SIZE == 16
+uint16_t port_sys_time( void )
+#elif   OS_TIMER_SIZE == 32
+uint32_t port_sys_time( void )
+#else
+uint64_t port_sys_time( void )
+#endif
+{
+#if OS_TIMER_SIZE <= 32 && MTIME_DIV == 1
+	return (cnt_t) CLINT_MTIME[0];
+#else
+	return (cnt_t)(priv_mtime() / MTIME_DIV);
+#endif
+}
+
+/******************************************************************************
+ Tick-less mode: set time breakpoint
+*******************************************************************************/
+
+void port_tmr_start( uint64_t timeout )
+{
+	uint64_t now   = priv_mtime() / MTIME_DIV;
+	cnt_t    delay = (cnt_t)((cnt_t) timeout - (cnt_t) now);
+
+	priv_mtimecmp((now + delay) * MTIME_DIV);
+}
+
+#else //HW_TIMER_SIZE
+
+void port_tmr_start( uint64_t timeout ) { (void) timeout; }
+
+#endif//HW_TIMER_SIZE
+
+/******************************************************************************
+ Interrupt handler of system timer and other traps (except context switch)
+*******************************************************************************/
+
+static __RAMFUNC
+void priv_trap_handler( uint32_t cause )
+{
+	if ((cause & (MCAUSE_IRQ | MCAUSE_CODE)) == MCAUSE_MTI)
+	{
+	#if HW_TIMER_SIZE == 0
+		Tick += (MTIME_FREQUENCY)/(OS_FREQUENCY);
+		priv_mtimecmp(Tick);
+		core_prf_sample(__csr_read(mepc));
+		core_sys_tick();
+	#else
+		port_tmr_stop();
+		core_tmr_handler();
+	#endif
+	}
+	else
+	if (cause & MCAUSE_IRQ)
+	{
+		port_irq_handler(cause & MCAUSE_CODE);
+	}
+	else
+	{
+		port_exc_handler(cause);
+	}
+}
+
+/******************************************************************************
+ Trap entry (mtvec), context switch handler (PendSV)
+ Save caller-saved registers, mepc and mstatus in the trap frame on the stack
+ of the current task and keep its address in mscratch; the context switch
+ additionally saves callee-saved registers and switches the trap frame to the
+ one returned by core_tsk_handler; handlers are executed on the interrupt stack
+*******************************************************************************/
+
+__attribute__((naked, aligned(64))) __RAMFUNC
+void port_trap_entry( void )
+{
+	__asm volatile
+	(
+"	addi  sp,    sp, -128          \n"
+"	sw    ra,    8(sp)             \n"
+"	sw    t0,   12(sp)             \n"
+"	sw    t1,   16(sp)             \n"
+"	sw    t2,   20(sp)             \n"
+"	sw    a0,   32(sp)             \n"
+"	sw    a1,   36(sp)             \n"
+"	sw    a2,   40(sp)             \n"
+"	sw    a3,   44(sp)             \n"
+"	sw    a4,   48(sp)             \n"
+"	sw    a5,   52(sp)             \n"
+"	sw    a6,   56(sp)             \n"
+"	sw    a7,   60(sp)             \n"
+"	sw    t3,  104(sp)             \n"
+"	sw    t4,  108(sp)             \n"
+"	sw    t5,  112(sp)             \n"
+"	sw    t6,  116(sp)             \n"
+"	csrr  t0,    mepc              \n"
+"	csrr  t1,    mstatus           \n"
+"	sw    t0,    0(sp)             \n"
+"	sw    t1,    4(sp)             \n"
+"	csrw  mscratch, sp             \n"
+
+"	csrr  a0,    mcause            \n"
+"	li    t0,  %[mask]             \n"
+"	and   t0,    t0, a0            \n"
+"	li    t1,  %[msi]              \n"
+"	beq   t0,    t1, 1f            \n"
+
+"	la    sp,  %[top]              \n"
+"	call  %[trap_handler]          \n"
+"	csrr  sp,    mscratch          \n"
+"	j     2f                       \n"
+
+"1:	sw    s0,   24(sp)             \n"
+"	sw    s1,   28(sp)             \n"
+"	sw    s2,   64(sp)             \n"
+"	sw    s3,   68(sp)             \n"
+"	sw    s4,   72(sp)             \n"
+"	sw    s5,   76(sp)             \n"
+"	sw    s6,   80(sp)             \n"
+"	sw    s7,   84(sp)             \n"
+"	sw    s8,   88(sp)             \n"
+"	sw    s9,   92(sp)             \n"
+"	sw    s10,  96(sp)             \n"
+"	sw    s11, 100(sp)             \n"
+"	li    t0,  %[msip]             \n"
+"	sw    zero,  0(t0)             \n"
+"	mv    a0,    sp                \n"
+"	la    sp,  %[top]              \n"
+"	call  %[core_tsk_handler]      \n"
+"	mv    sp,    a0                \n"
+"	lw    s0,   24(sp)             \n"
+"	lw    s1,   28(sp)             \n"
+"	lw    s2,   64(sp)             \n"
+"	lw    s3,   68(sp)             \n"
+"	lw    s4,   72(sp)             \n"
+"	lw    s5,   76(sp)             \n"
+"	lw    s6,   80(sp)             \n"
+"	lw    s7,   84(sp)             \n"
+"	lw    s8,   88(sp)             \n"
+"	lw    s9,   92(sp)             \n"
+"	lw    s10,  96(sp)             \n"
+"	lw    s11, 100(sp)             \n"
+
+"2:	lw    t0,    0(sp)             \n"
+"	lw    t1,    4(sp)             \n"
+"	csrw  mepc,  t0                \n"
+"	csrw  mstatus, t1              \n"
+"	lw    ra,    8(sp)             \n"
+"	lw    t0,   12(sp)             \n"
+"	lw    t1,   16(sp)             \n"
+"	lw    t2,   20(sp)             \n"
+"	lw    a0,   32(sp)             \n"
+"	lw    a1,   36(sp)             \n"
+"	lw    a2,   40(sp)             \n"
+"	lw    a3,   44(sp)             \n"
+"	lw    a4,   48(sp)             \n"
+"	lw    a5,   52(sp)             \n"
+"	lw    a6,   56(sp)             \n"
+"	lw    a7,   60(sp)             \n"
+"	lw    t3,  104(sp)             \n"
+"	lw    t4,  108(sp)             \n"
+"	lw    t5,  112(sp)             \n"
+"	lw    t6,  116(sp)             \n"
+"	addi  sp,    sp, 128           \n"
+"	mret                           \n"
+
+::	[mask] "i" (MCAUSE_IRQ | MCAUSE_CODE),
+	[msi] "i" (MCAUSE_MSI),
+	[msip] "i" (CLINT_BASE),
+	[top] "i" (ISR_TOP),
+	[trap_handler] "i" (priv_trap_handler),
+	[core_tsk_handler] "i" (core_tsk_handler)
+:	"memory"
+	);
+}
+
+/* -------------------------------------------------------------------------- */
+
+__attribute__((naked))
+void core_tsk_flip( void *sp )
+{
+	__asm volatile
+	(
+"	mv    sp,  %[sp]               \n"
+"	andi  sp,    sp, -16           \n"
+"	call  %[core_tsk_loop]         \n"
+
+::	[sp] "r" (sp),
+	[core_tsk_loop] "i" (core_tsk_loop)
+:	"memory"
+	);
+}
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __riscv && __GNUC__
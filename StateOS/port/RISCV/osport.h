@@ -0,0 +1,271 @@
+/******************************************************************************
+
+    @file    StateOS: osport.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   StateOS port file for RISC-V (RV32IMAC).
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOSPORT_H
+#define __STATEOSPORT_H
+
+#include <stdint.h>
+#ifndef   NOCONFIG
+#include "osconfig.h"
+#endif
+#include "osdefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef MTIME_FREQUENCY
+#define MTIME_FREQUENCY 1000000 /* Hz, frequency of the machine timer (mtime) */
+#endif
+
+/* -------------------------------------------------------------------------- */
+// core-local interruptor of hart 0: software interrupt and machine timer
+// default addresses follow the SiFive memory map
+
+#ifndef CLINT_BASE
+#define CLINT_BASE   0x02000000U
+#endif
+
+#define CLINT_MSIP     (*(volatile uint32_t *)((CLINT_BASE) + 0x0000U))
+#define CLINT_MTIMECMP   ((volatile uint32_t *)((CLINT_BASE) + 0x4000U)) // [0]: low word, [1]: high word
+#define CLINT_MTIME      ((volatile uint32_t *)((CLINT_BASE) + 0xBFF8U)) // [0]: low word, [1]: high word
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_CLIC
+#define OS_CLIC               0 /* interrupts in the clint (direct) mode      */
+#endif
+
+/* -------------------------------------------------------------------------- */
+// core-local interrupt controller (OS_CLIC)
+// default addresses follow the SiFive memory map
+
+#if     OS_CLIC
+
+#ifndef CLIC_BASE
+#define CLIC_BASE    0x02800000U
+#endif
+
+#ifndef CLIC_INTCTLBITS
+#define CLIC_INTCTLBITS       4 /* number of implemented bits of clicintctl   */
+#endif
+
+#define CLIC_INTIE( id ) (*(volatile uint8_t *)((CLIC_BASE) + 0x0400U + (id)))
+#define CLIC_INTCTL( id )(*(volatile uint8_t *)((CLIC_BASE) + 0x0800U + (id)))
+#define CLIC_CFG         (*(volatile uint8_t *)((CLIC_BASE) + 0x0C00U))
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_FREQUENCY
+#define OS_FREQUENCY       1000 /* Hz */
+#endif
+
+#if     (MTIME_FREQUENCY) < (OS_FREQUENCY)
+#error  osconfig.h: Incorrect OS_FREQUENCY value! Must be less or equal MTIME_FREQUENCY.
+#endif
+
+/* -------------------------------------------------------------------------- */
+// !! WARNING! OS_TIMER_SIZE < HW_TIMER_SIZE may cause unexpected problems !!
+
+#ifndef OS_TIMER_SIZE
+#define OS_TIMER_SIZE        32 /* bit size of system timer counter           */
+#endif
+
+/* -------------------------------------------------------------------------- */
+// 64-bit machine timer is used as the hardware timer in tick-less mode
+
+#ifdef  HW_TIMER_SIZE
+#error  HW_TIMER_SIZE is an internal os definition!
+#elif   OS_FREQUENCY > 1000
+#define HW_TIMER_SIZE OS_TIMER_SIZE /* bit size of hardware timer             */
+#else
+#define HW_TIMER_SIZE         0 /* os does not work in tick-less mode         */
+#endif
+
+#if     OS_PROFILE_SIZE && HW_TIMER_SIZE
+#error  osconfig.h: OS_PROFILE_SIZE is not allowed in tick-less mode, samples are taken by the periodic system tick.
+#endif
+
+#if     HW_TIMER_SIZE && ((MTIME_FREQUENCY) % (OS_FREQUENCY))
+#error  osconfig.h: Incorrect OS_FREQUENCY value! MTIME_FREQUENCY must be a multiple of OS_FREQUENCY in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_ROBIN
+#define OS_ROBIN              0 /* system works in cooperative mode           */
+#endif
+
+#if     OS_ROBIN > OS_FREQUENCY
+#error  osconfig.h: Incorrect OS_ROBIN value!
+#endif
+
+#if     OS_ROBIN && HW_TIMER_SIZE
+#error  osconfig.h: OS_ROBIN is not supported by the RISC-V port in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TICKLESS_IDLE
+#define OS_TICKLESS_IDLE      0 /* system timer is not suppressed when idle   */
+#endif
+
+#if     OS_TICKLESS_IDLE
+#error  osconfig.h: OS_TICKLESS_IDLE is not supported by the RISC-V port.
+#endif
+
+/* -------------------------------------------------------------------------- */
+// return current system time
+
+#if HW_TIMER_SIZE
+
+#if     OS_TIMER_SIZE == 16
+uint16_t port_sys_time( void );
+#elif   OS_TIMER_SIZE == 32
+uint32_t port_sys_time( void );
+#else
+uint64_t port_sys_time( void );
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// clock frequency of the machine timer in non-tick-less mode (see port_sys_init)
+
+#if HW_TIMER_SIZE == 0
+
+#ifdef  HW_TICK_FREQUENCY
+#error  HW_TICK_FREQUENCY is an internal port definition!
+#else
+#define HW_TICK_FREQUENCY   (MTIME_FREQUENCY)
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// force yield system control to the next process
+
+__STATIC_INLINE
+void port_ctx_switch( void )
+{
+	CLINT_MSIP = 1U;
+}
+
+/* -------------------------------------------------------------------------- */
+// reset context switch indicator
+
+__STATIC_INLINE
+void port_ctx_reset( void )
+{
+}
+
+/* -------------------------------------------------------------------------- */
+// clear time breakpoint
+
+__STATIC_INLINE
+void port_tmr_stop( void )
+{
+#if HW_TIMER_SIZE
+	CLINT_MTIMECMP[1] = UINT32_MAX;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+// set time breakpoint
+
+void port_tmr_start( uint64_t timeout );
+
+/* -------------------------------------------------------------------------- */
+// force timer interrupt
+
+__STATIC_INLINE
+void port_tmr_force( void )
+{
+#if HW_TIMER_SIZE
+	CLINT_MTIMECMP[0] = 0U;
+	CLINT_MTIMECMP[1] = 0U;
+#endif
+}
+
+/* -------------------------------------------------------------------------- */
+// stop system timer interrupts for the low power mode managed by the application
+// not supported by the RISC-V port: return false, the system timer is not stopped
+
+__STATIC_INLINE
+bool port_sys_suspend( void )
+{
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+// restart system timer interrupts after the low power mode
+
+__STATIC_INLINE
+void port_sys_resume( void )
+{
+}
+
+/* -------------------------------------------------------------------------- */
+// handler of interrupts other than system timer and context switch (weak, may be redefined)
+// 'id': interrupt number (exception code of mcause)
+
+void port_irq_handler( unsigned id );
+
+/* -------------------------------------------------------------------------- */
+// handler of exceptions (weak, may be redefined)
+// 'cause': value of mcause
+
+void port_exc_handler( uint32_t cause );
+
+/* -------------------------------------------------------------------------- */
+// the port does not use tightly-coupled memory
+
+#define __FAST_DATA
+#define __FAST_NOINIT
+
+/* -------------------------------------------------------------------------- */
+// all code is executed from the same memory
+
+#define __RAMFUNC
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOSPORT_H
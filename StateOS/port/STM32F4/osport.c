@@ -30,6 +30,16 @@
  ******************************************************************************/
 
 #include "oskernel.h"
+#if OS_CPU_GOVERNOR
+#include "inc/ostask.h"
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_ISR_STACK
+stk_t port_isr_stack[SSIZE(OS_ISR_STACK)];
+#define ISR_TOP (port_isr_stack+SSIZE(OS_ISR_STACK))
+#endif
 
 /* -------------------------------------------------------------------------- */
 
@@ -46,6 +56,31 @@ void port_sys_init( void )
  End of check
 *******************************************************************************/
 
+#if OS_ISR_STACK
+
+/******************************************************************************
+ Configuration of the dedicated exception stack
+ Thread mode (the main task on the startup stack) is switched from MSP to PSP,
+ MSP is set to the top of the painted exception stack and is used only by handlers
+*******************************************************************************/
+
+	memset(port_isr_stack, 0xFF, sizeof(port_isr_stack));
+
+	if ((__get_CONTROL() & CONTROL_SPSEL_Msk) == 0U)
+	{
+		__set_PSP(__get_MSP());
+		__set_CONTROL(__get_CONTROL() | CONTROL_SPSEL_Msk);
+		__ISB();
+	}
+
+	__set_MSP((uint32_t)ISR_TOP);
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+#endif
+
 #if HW_TIMER_SIZE == 0
 
 /******************************************************************************
@@ -94,16 +129,17 @@ void port_sys_init( void )
 	#endif
 	TIM2->PSC  = (CPU_FREQUENCY)/(OS_FREQUENCY)/2-1;
 	TIM2->EGR  = TIM_EGR_UG;
-	TIM2->CR1  = TIM_CR1_CEN;
-	#if HW_TIMER_SIZE < OS_TIMER_SIZE
-	TIM2->DIER = TIM_DIER_UIE;
+	#if ROBIN_TIMER && OS_ROBIN_TIM2
+	TIM2->CCR2 = port_rob;
 	#endif
+	TIM2->CR1  = TIM_CR1_CEN;
+	TIM2->DIER = TIM2_DIER_BASE;
 
 /******************************************************************************
  End of configuration
 *******************************************************************************/
 
-	#if OS_ROBIN
+	#if ROBIN_TIMER && !OS_ROBIN_TIM2
 
 /******************************************************************************
  Tick-less mode with preemption: configuration of timer for context switch triggering
@@ -131,10 +167,82 @@ void port_sys_init( void )
  End of configuration
 *******************************************************************************/
 
-	#endif//OS_ROBIN
+	#endif//ROBIN_TIMER && !OS_ROBIN_TIM2
 
 #endif//HW_TIMER_SIZE
 
+#if OS_TASK_STATS || OS_TASK_PERF || OS_TRACE_ITM || (OS_TRACE_SIZE && (__CORTEX_M >= 3))
+
+/******************************************************************************
+ Configuration of cpu cycle counter for tasks accounting and kernel tracing
+*******************************************************************************/
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0U;
+	DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+#if OS_TASK_PERF
+	DWT->CPICNT = DWT->EXCCNT = DWT->SLEEPCNT = DWT->LSUCNT = DWT->FOLDCNT = 0U;
+	DWT->CTRL  |= DWT_CTRL_CPIEVTENA_Msk | DWT_CTRL_EXCEVTENA_Msk | DWT_CTRL_SLEEPEVTENA_Msk | DWT_CTRL_LSUEVTENA_Msk | DWT_CTRL_FOLDEVTENA_Msk;
+#endif
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+#endif
+
+#if OS_TRACE_ITM
+
+/******************************************************************************
+ Configuration of ITM stimulus ports for streaming of kernel events
+ the trace port (SWO pin, TPIU prescaler and protocol) is configured by the debugger
+*******************************************************************************/
+
+	ITM->LAR  = 0xC5ACCE55U; // unlock access to the ITM registers
+	ITM->TCR |= ITM_TCR_ITMENA_Msk;
+	ITM->TER |= 0xFU << OS_TRACE_ITM;
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+#endif
+
+#if OS_LAZY_FPU
+
+/******************************************************************************
+ Configuration of fpu for lazy context switching
+ UsageFault (NOCP) must be able to preempt critical sections and interrupts using the fpu
+*******************************************************************************/
+
+	FPU->FPCCR |= FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk;
+	NVIC_SetPriority(UsageFault_IRQn, 0);
+	SCB->SHCSR |= SCB_SHCSR_USGFAULTENA_Msk;
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+#endif
+
+#if OS_STACK_GUARD
+
+/******************************************************************************
+ Configuration of mpu for task stack guard regions
+ Default memory map is used as a background region, overflow causes MemManage fault
+*******************************************************************************/
+
+	MPU->CTRL   = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+	SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk;
+	__DSB();
+	__ISB();
+
+/******************************************************************************
+ End of configuration
+*******************************************************************************/
+
+#endif
+
 /******************************************************************************
  Configuration of interrupt for context switch
 *******************************************************************************/
@@ -148,28 +256,287 @@ void port_sys_init( void )
 
 /* -------------------------------------------------------------------------- */
 
+#if OS_CPU_SCALING
+
+/******************************************************************************
+ Runtime cpu clock scaling
+ The system timer is stopped for the time of the clock switch;
+ in non-tick-less mode the remaining part of the current tick is rescaled to the new SysTick frequency,
+ in tick-less mode the counter of TIM2 is preserved and only its prescaler is reloaded
+*******************************************************************************/
+
+uint32_t port_cpu_frequency = CPU_FREQUENCY;
+
+__WEAK
+uint32_t port_clk_config( uint32_t hz )
+{
+	static const uint8_t shift[] = { 0, 1, 2, 3, 4, 6, 7, 8, 9 }; // AHB prescaler: 1, 2, 4, 8, 16, 64, 128, 256, 512
+	unsigned i = 0;
+
+	while (i < sizeof(shift) - 1 && (uint32_t)(CPU_FREQUENCY) >> shift[i + 1] >= hz)
+		i++;
+
+	RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_HPRE) | ((i ? 7U + i : 0U) << RCC_CFGR_HPRE_Pos);
+	__DSB();
+
+	return (uint32_t)(CPU_FREQUENCY) >> shift[i];
+}
+
+uint32_t port_sys_setFrequency( uint32_t hz )
+{
+	#if HW_TIMER_SIZE == 0
+	uint32_t load, val, tck, ctrl;
+	#else
+	uint32_t cnt;
+	#endif
+	lck_t lck = port_get_lock();
+	port_set_lock();
+
+	#if HW_TIMER_SIZE == 0
+
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	load = SysTick->LOAD + 1U;
+	val  = SysTick->VAL;
+
+	hz = port_clk_config(hz);
+
+	tck  = hz / (OS_FREQUENCY);
+	ctrl = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk;
+	if (tck - 1U > SysTick_LOAD_RELOAD_Msk)
+	{
+		tck /= 8U; // alternate clock source (ST_FREQUENCY)
+		ctrl = SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk;
+	}
+
+	val = val ? (uint32_t)((uint64_t) val * tck / load) : tck; // counts remaining to the end of the current tick
+	if (val < 2U)
+		val = 2U;
+
+	SysTick->LOAD = val - 1U;
+	SysTick->VAL  = 0U;
+	SysTick->CTRL = ctrl;
+	SysTick->LOAD = tck - 1U;
+
+	#else //HW_TIMER_SIZE
+
+	TIM2->CR1  = 0U;
+	cnt = TIM2->CNT;
+
+	hz = port_clk_config(hz);
+
+	TIM2->PSC  = hz / (OS_FREQUENCY) / 2U - 1U;
+	TIM2->CR1  = TIM_CR1_URS; // the update event does not set UIF
+	TIM2->EGR  = TIM_EGR_UG;  // reload the prescaler, reset the counter
+	TIM2->CNT  = cnt;
+	TIM2->CR1  = TIM_CR1_CEN;
+
+	#endif//HW_TIMER_SIZE
+
+	port_cpu_frequency = hz;
+	SystemCoreClock = hz;
+
+	port_put_lock(lck);
+
+	return hz;
+}
+
+	#if OS_CPU_GOVERNOR
+
+	#if OS_TASK_STATS == 0
+	#error  osconfig.h: OS_CPU_GOVERNOR requires OS_TASK_STATS.
+	#endif
+
+/******************************************************************************
+ Cpu frequency governor
+ Every OS_CPU_GOVERNOR system ticks the load is calculated from the cpu cycles consumed by the idle task
+ and the frequency returned by port_cpu_governor is set
+*******************************************************************************/
+
+__WEAK
+uint32_t port_cpu_governor( uint32_t hz, unsigned load )
+{
+	if (load > 75U)
+		return CPU_FREQUENCY;
+	if (load < 25U && hz / 2U >= (CPU_FREQUENCY) / 16U)
+		return hz / 2U;
+	return hz;
+}
+
+static
+void priv_cpu_governor( void )
+{
+	static unsigned cnt   = 0;
+	static uint32_t stamp = 0; // cpu cycle counter at the beginning of the sampling period
+	static uint64_t idle  = 0; // cpu cycles consumed by the idle task at the beginning of the sampling period
+	uint32_t total, empty, hz;
+	unsigned load;
+
+	if (++cnt < (OS_CPU_GOVERNOR))
+		return;
+	cnt = 0;
+
+	port_set_lock();
+	{
+		core_cur_account();
+		total = port_cyc_time() - stamp;
+		empty = (uint32_t)(IDLE.stat.time - idle);
+		stamp += total;
+		idle  += empty;
+	}
+	port_clr_lock();
+
+	load = total ? 100U - (unsigned)((uint64_t) empty * 100U / total) : 100U;
+	hz = port_cpu_governor(port_cpu_frequency, load);
+	if (hz != port_cpu_frequency)
+		port_sys_setFrequency(hz);
+}
+
+	#endif//OS_CPU_GOVERNOR
+
+/******************************************************************************
+ End of the functions
+*******************************************************************************/
+
+#endif//OS_CPU_SCALING
+
+/* -------------------------------------------------------------------------- */
+
 #if HW_TIMER_SIZE == 0
 
 /******************************************************************************
  Non-tick-less mode: interrupt handler of system timer
 *******************************************************************************/
 
+	#if OS_PROFILE_SIZE
+
+static __RAMFUNC __attribute__((used))
+void priv_sys_tick( uint32_t pc )
+{
+	SysTick->CTRL;
+	core_prf_sample(pc);
+	core_sys_tick();
+	#if OS_CPU_GOVERNOR
+	priv_cpu_governor();
+	#endif
+}
+
+/* the interrupted code: return address from the exception frame on the stack selected by EXC_RETURN */
+
+__attribute__((naked)) __RAMFUNC
+void SysTick_Handler( void )
+{
+	__ASM volatile
+	(
+"	.syntax	unified                \n"
+
+"	tst   lr,  # 4                 \n"
+"	ite   eq                       \n"
+"	mrseq r0,    MSP               \n"
+"	mrsne r0,    PSP               \n"
+"	ldr   r0,  [ r0, # 24 ]        \n"
+"	b   %[priv_sys_tick]           \n"
+
+::	[priv_sys_tick] "i" (priv_sys_tick)
+:	"memory"
+	);
+}
+
+	#else
+
+__RAMFUNC
 void SysTick_Handler( void )
 {
 	SysTick->CTRL;
 	core_sys_tick();
+	#if OS_CPU_GOVERNOR
+	priv_cpu_governor();
+	#endif
 }
 
+	#endif//OS_PROFILE_SIZE
+
 /******************************************************************************
  End of the handler
 *******************************************************************************/
 
+	#if OS_TICKLESS_IDLE
+
+/******************************************************************************
+ Non-tick-less mode: suppression of system timer interrupts in the idle task
+ Sleep for up to 'ticks' system ticks, return number of skipped ticks
+ SysTick interrupt is left pending if at least one tick boundary has passed
+*******************************************************************************/
+
+	#if (CPU_FREQUENCY)/(OS_FREQUENCY)-1 <= SysTick_LOAD_RELOAD_Msk
+	#define ST_TICK  ((CPU_FREQUENCY)/(OS_FREQUENCY))
+	#define ST_CTRL  (SysTick_CTRL_CLKSOURCE_Msk|SysTick_CTRL_ENABLE_Msk|SysTick_CTRL_TICKINT_Msk)
+	#else
+	#define ST_TICK  ((ST_FREQUENCY)/(OS_FREQUENCY))
+	#define ST_CTRL  (SysTick_CTRL_ENABLE_Msk|SysTick_CTRL_TICKINT_Msk)
+	#endif
+	#define ST_LIMIT ((SysTick_LOAD_RELOAD_Msk+1)/(ST_TICK))
+
+cnt_t port_sys_sleep( cnt_t ticks )
+{
+	uint32_t val, load, tck, cnt;
+
+	if (ticks > ST_LIMIT)
+		ticks = ST_LIMIT;
+
+	SysTick->CTRL = ST_CTRL & ~SysTick_CTRL_ENABLE_Msk;
+	val = SysTick->VAL;
+
+	if (ticks < 2 || val == 0 || (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+	{
+		SysTick->CTRL = ST_CTRL;
+		__WFI();
+		return 0;
+	}
+
+	load = val + (uint32_t)(ticks - 1) * (ST_TICK) - 1;
+	SysTick->LOAD = load;
+	SysTick->VAL  = 0U;
+	SysTick->CTRL = ST_CTRL;
+
+	__DSB();
+	__WFI();
+
+	SysTick->CTRL = ST_CTRL & ~SysTick_CTRL_ENABLE_Msk;
+	tck = load - SysTick->VAL;
+	if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk)
+		tck += load + 1;
+
+	cnt = tck < val ? 0 : 1 + (tck - val) / (ST_TICK);
+	tck = val + cnt * (ST_TICK) - tck;
+
+	SysTick->LOAD = tck - 1;
+	SysTick->VAL  = 0U;
+	SysTick->CTRL = ST_CTRL;
+	SysTick->LOAD = (ST_TICK) - 1;
+
+	if (cnt == 0)
+	{
+		SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+		return 0;
+	}
+
+	SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+	return cnt - 1;
+}
+
+/******************************************************************************
+ End of the function
+*******************************************************************************/
+
+	#endif//OS_TICKLESS_IDLE
+
 #else //HW_TIMER_SIZE
 
 /******************************************************************************
  Tick-less mode: interrupt handler of system timer
 *******************************************************************************/
 
+__RAMFUNC
 void TIM2_IRQHandler( void )
 {
 	#if HW_TIMER_SIZE < OS_TIMER_SIZE
@@ -178,6 +545,16 @@ void TIM2_IRQHandler( void )
 		TIM2->SR = ~TIM_SR_UIF;
 		core_sys_tick();
 	}
+	#endif
+	#if ROBIN_TIMER && OS_ROBIN_TIM2
+	if (TIM2->SR & TIM_SR_CC2IF)
+	{
+		TIM2->SR = ~TIM_SR_CC2IF;
+		TIM2->CCR2 += port_rob;
+		core_ctx_switch();
+	}
+	#endif
+	#if TIM2_DIER_BASE
 	if (TIM2->SR & TIM_SR_CC1IF)
 	#endif
 	{
@@ -219,12 +596,64 @@ cnt_t port_sys_time( void )
  End of the function
 *******************************************************************************/
 
-	#if OS_ROBIN
+	#if ROBIN_TIMER && OS_ROBIN_TIM2
+
+/******************************************************************************
+ Tick-less mode with preemption: restart of timer for context switch triggering
+ TIM2 channel 2 is set to the deadline of the time slice of the incoming task,
+ the interrupt handler moves it by the time slice (see TIM2_IRQHandler)
+*******************************************************************************/
+
+uint32_t port_rob = (OS_FREQUENCY)/(OS_ROBIN);
+
+void port_rob_start( cnt_t slice )
+{
+	port_rob = slice ? (uint32_t) slice : (OS_FREQUENCY)/(OS_ROBIN);
+	TIM2->CCR2 = TIM2->CNT + port_rob;
+}
+
+/******************************************************************************
+ End of the function
+*******************************************************************************/
+
+	#elif ROBIN_TIMER
+
+/******************************************************************************
+ Tick-less mode with preemption: restart of timer for context switch triggering
+ SysTick is reloaded with the time slice of the incoming task
+*******************************************************************************/
+
+#if (CPU_FREQUENCY)/(OS_ROBIN)-1 <= SysTick_LOAD_RELOAD_Msk
+#define ROB_FREQUENCY (CPU_FREQUENCY)
+#else
+#define ROB_FREQUENCY (ST_FREQUENCY)
+#endif
+
+void port_rob_start( cnt_t slice )
+{
+	uint32_t load = (ROB_FREQUENCY)/(OS_ROBIN);
+
+	if (slice)
+	{
+		if (slice > (SysTick_LOAD_RELOAD_Msk + 1U) / ((ROB_FREQUENCY)/(OS_FREQUENCY)))
+			load = SysTick_LOAD_RELOAD_Msk + 1U;
+		else
+			load = (uint32_t) slice * ((ROB_FREQUENCY)/(OS_FREQUENCY));
+	}
+
+	SysTick->LOAD = load - 1U;
+	SysTick->VAL  = 0U;
+}
+
+/******************************************************************************
+ End of the function
+*******************************************************************************/
 
 /******************************************************************************
  Tick-less mode with preemption: interrupt handler for context switch triggering
 *******************************************************************************/
 
+__RAMFUNC
 void SysTick_Handler( void )
 {
 	SysTick->CTRL;
@@ -235,7 +664,7 @@ void SysTick_Handler( void )
  End of the handler
 *******************************************************************************/
 
-	#endif//OS_ROBIN
+	#endif//ROBIN_TIMER
 
 #endif//HW_TIMER_SIZE
 
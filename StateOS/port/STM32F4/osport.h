@@ -72,6 +72,10 @@ extern "C" {
 #define HW_TIMER_SIZE         0 /* os does not work in tick-less mode         */
 #endif
 
+#if     OS_PROFILE_SIZE && HW_TIMER_SIZE
+#error  osconfig.h: OS_PROFILE_SIZE is not allowed in tick-less mode, samples are taken by the periodic system tick.
+#endif
+
 /* -------------------------------------------------------------------------- */
 // alternate clock source for SysTick
 
@@ -91,6 +95,97 @@ extern "C" {
 #error  osconfig.h: Incorrect OS_ROBIN value!
 #endif
 
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_ROBIN_TIM2
+#define OS_ROBIN_TIM2         0 /* time slice measured by SysTick             */
+#endif
+
+#if     OS_ROBIN_TIM2 && !HW_TIMER_SIZE
+#error  osconfig.h: OS_ROBIN_TIM2 is only allowed in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TICKLESS_IDLE
+#define OS_TICKLESS_IDLE      0 /* system timer is not suppressed when idle   */
+#endif
+
+#if     OS_TICKLESS_IDLE && HW_TIMER_SIZE
+#error  osconfig.h: OS_TICKLESS_IDLE is not allowed in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_CPU_SCALING
+#define OS_CPU_SCALING        0 /* cpu frequency is constant (CPU_FREQUENCY)  */
+#endif
+
+#if     OS_CPU_SCALING && OS_TICKLESS_IDLE
+#error  osconfig.h: OS_CPU_SCALING is not allowed with OS_TICKLESS_IDLE.
+#endif
+
+#if     OS_CPU_SCALING && HW_TIMER_SIZE && OS_ROBIN && !OS_ROBIN_TIM2
+#error  osconfig.h: OS_CPU_SCALING requires OS_ROBIN_TIM2 in tick-less mode with preemption.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_CPU_GOVERNOR
+#define OS_CPU_GOVERNOR       0 /* cpu frequency is not scaled automatically  */
+#endif
+
+#if     OS_CPU_GOVERNOR && (!OS_CPU_SCALING || HW_TIMER_SIZE)
+#error  osconfig.h: OS_CPU_GOVERNOR requires OS_CPU_SCALING in non-tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_FAST_RAM
+#define OS_FAST_RAM           0 /* kernel data is placed in the main sram     */
+#endif
+
+/* -------------------------------------------------------------------------- */
+// placement of kernel data and stacks in the core-coupled memory (CCM)
+// CCM is zero-wait-state and is not shared with DMA, but is not accessible by DMA either
+// __FAST_DATA:   initialized data (copied from flash at startup)
+// __FAST_NOINIT: not initialized data, e.g. task stacks
+
+#if     OS_FAST_RAM && defined(__GNUC__) && !defined(__ARMCC_VERSION)
+#define __FAST_DATA         __attribute__((section(".ccm_data")))
+#define __FAST_NOINIT       __attribute__((section(".ccm")))
+#else
+#define __FAST_DATA
+#define __FAST_NOINIT
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_RAMFUNC
+#define OS_RAMFUNC            0 /* kernel hot paths are executed from flash   */
+#endif
+
+/* -------------------------------------------------------------------------- */
+// placement of the scheduler and timer hot paths in the sram
+// functions are copied from flash together with the '.data' section at startup
+// and are executed without flash wait states and ART accelerator misses
+// (cortex-m7 ports should place the '.ramfunc' section in the ITCM)
+
+#if     OS_RAMFUNC && defined(__GNUC__) && !defined(__ARMCC_VERSION)
+#define __RAMFUNC           __attribute__((section(".ramfunc")))
+#else
+#define __RAMFUNC
+#endif
+
+/* -------------------------------------------------------------------------- */
+// is the memory accessible by DMA?
+
+__STATIC_INLINE
+bool port_dma_capable( const void *ptr )
+{
+	return ((uint32_t)ptr < CCMDATARAM_BASE) || ((uint32_t)ptr > CCMDATARAM_END);
+}
+
 /* -------------------------------------------------------------------------- */
 // return current system time
 
@@ -104,6 +199,79 @@ uint32_t port_sys_time( void )
 
 #endif
 
+/* -------------------------------------------------------------------------- */
+// clock frequency of SysTick counter in non-tick-less mode (see port_sys_init)
+// not constant with OS_CPU_SCALING
+
+#if HW_TIMER_SIZE == 0 && OS_CPU_SCALING == 0
+
+#ifdef  HW_TICK_FREQUENCY
+#error  HW_TICK_FREQUENCY is an internal port definition!
+#elif  (CPU_FREQUENCY)/(OS_FREQUENCY)-1 <= SysTick_LOAD_RELOAD_Msk
+#define HW_TICK_FREQUENCY   (CPU_FREQUENCY)
+#else
+#define HW_TICK_FREQUENCY   (ST_FREQUENCY)
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// TIM2 interrupts enabled regardless of the time breakpoint (tick-less mode)
+// update: extension of the system timer counter, CC2: deadline of the time slice (OS_ROBIN_TIM2)
+
+#if HW_TIMER_SIZE
+
+#ifdef  TIM2_DIER_BASE
+#error  TIM2_DIER_BASE is an internal port definition!
+#endif
+
+#if     HW_TIMER_SIZE < OS_TIMER_SIZE && OS_ROBIN && OS_ROBIN_TIM2
+#define TIM2_DIER_BASE     (TIM_DIER_UIE | TIM_DIER_CC2IE)
+#elif   HW_TIMER_SIZE < OS_TIMER_SIZE
+#define TIM2_DIER_BASE     (TIM_DIER_UIE)
+#elif   OS_ROBIN && OS_ROBIN_TIM2
+#define TIM2_DIER_BASE     (TIM_DIER_CC2IE)
+#else
+#define TIM2_DIER_BASE      0U
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// time slice of the current task (in ticks), measured by TIM2 channel 2
+
+#if HW_TIMER_SIZE && OS_ROBIN && OS_ROBIN_TIM2
+extern uint32_t port_rob;
+#endif
+
+/* -------------------------------------------------------------------------- */
+// runtime cpu clock scaling
+
+#if OS_CPU_SCALING
+
+// current cpu frequency (Hz)
+extern uint32_t port_cpu_frequency;
+
+// switch the cpu clock to frequency 'hz' and rescale the system timer (SysTick or TIM2 prescaler)
+// the already counted part of the current system tick is preserved, so no tick is lost or duplicated
+// return the frequency actually set
+uint32_t port_sys_setFrequency( uint32_t hz );
+
+// configure the clock tree for cpu frequency 'hz', called by port_sys_setFrequency with the system timer stopped
+// default: AHB prescaler set to the largest divider of CPU_FREQUENCY giving a frequency not lower than 'hz'
+// may be redefined by the application (e.g. to reconfigure the PLL and flash latency)
+// return the frequency actually set
+uint32_t port_clk_config( uint32_t hz );
+
+#if OS_CPU_GOVERNOR
+// return cpu frequency for the 'load' (percentage of non-idle time) measured at frequency 'hz' in the last OS_CPU_GOVERNOR ticks
+// default: CPU_FREQUENCY above 75%, half of 'hz' (not lower than CPU_FREQUENCY/16) below 25%, otherwise 'hz'
+// may be redefined by the application
+uint32_t port_cpu_governor( uint32_t hz, unsigned load );
+#endif
+
+#endif
+
 /* -------------------------------------------------------------------------- */
 // force yield system control to the next process
 
@@ -120,7 +288,9 @@ __STATIC_INLINE
 void port_ctx_reset( void )
 {
 #if HW_TIMER_SIZE
-	#if OS_ROBIN
+	#if OS_ROBIN && OS_ROBIN_TIM2
+	TIM2->CCR2 = TIM2->CNT + port_rob;
+	#elif OS_ROBIN
 	SysTick->VAL = 0;
 	#endif
 #endif
@@ -133,11 +303,7 @@ __STATIC_INLINE
 void port_tmr_stop( void )
 {
 #if HW_TIMER_SIZE
-	#if HW_TIMER_SIZE < OS_TIMER_SIZE
-	TIM2->DIER = TIM_DIER_UIE;
-	#else
-	TIM2->DIER = 0;
-	#endif
+	TIM2->DIER = TIM2_DIER_BASE;
 #endif
 }
 
@@ -149,11 +315,7 @@ void port_tmr_start( uint32_t timeout )
 {
 #if HW_TIMER_SIZE
 	TIM2->CCR1 = timeout;
-	#if HW_TIMER_SIZE < OS_TIMER_SIZE
-	TIM2->DIER = TIM_DIER_CC1IE | TIM_DIER_UIE;
-	#else
-	TIM2->DIER = TIM_DIER_CC1IE;
-	#endif
+	TIM2->DIER = TIM_DIER_CC1IE | TIM2_DIER_BASE;
 #else
 	(void) timeout;
 #endif
@@ -166,8 +328,8 @@ __STATIC_INLINE
 void port_tmr_force( void )
 {
 #if HW_TIMER_SIZE
-	#if HW_TIMER_SIZE < OS_TIMER_SIZE
-	TIM2->DIER = TIM_DIER_CC1IE | TIM_DIER_UIE;
+	#if TIM2_DIER_BASE
+	TIM2->DIER = TIM_DIER_CC1IE | TIM2_DIER_BASE;
 	TIM2->EGR  = TIM_EGR_CC1G;
 	#else
 	NVIC_SetPendingIRQ(TIM2_IRQn);
@@ -175,6 +337,35 @@ void port_tmr_force( void )
 #endif
 }
 
+/* -------------------------------------------------------------------------- */
+// stop system timer interrupts for the low power mode managed by the application
+// in tick-less mode only the time breakpoint is cleared, the system timer counter keeps running
+// return true if the system timer has been stopped
+
+__STATIC_INLINE
+bool port_sys_suspend( void )
+{
+#if HW_TIMER_SIZE
+	port_tmr_stop();
+#else
+	SysTick->CTRL &= ~(SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk);
+#endif
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+// restart system timer interrupts after the low power mode
+// in tick-less mode the time breakpoint is set again by the timer handler
+
+__STATIC_INLINE
+void port_sys_resume( void )
+{
+#if HW_TIMER_SIZE == 0
+	SysTick->VAL   = 0U;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk;
+#endif
+}
+
 /* -------------------------------------------------------------------------- */
 
 #ifdef __cplusplus
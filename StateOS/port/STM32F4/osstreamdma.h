@@ -0,0 +1,111 @@
+/******************************************************************************
+
+    @file    StateOS: osstreamdma.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   DMA helper for stream buffers on STM32F4 uC.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOS_STREAMDMA_H
+#define __STATEOS_STREAMDMA_H
+
+#include "inc/osstreambuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *
+ * Name              : stm_dmaInit
+ *
+ * Description       : bind the stream buffer object to the DMA stream working in circular mode
+ *                     the DMA stream transfers bytes from the peripheral data register directly into the stream buffer
+ *                     half-transfer and transfer-complete interrupts are enabled, NVIC configuration is left to the user
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object, must be empty
+ *   dma             : pointer to DMA stream, e.g. DMA1_Stream5
+ *   channel         : DMA channel number (0..7) of the peripheral request
+ *   reg             : address of the peripheral data register, e.g. &USART2->DR
+ *
+ * Return            : none
+ *
+ * Note              : use only in thread mode
+ *                     DMA stream must be the only producer of the stream buffer object
+ *                     DMA requests of the peripheral must be enabled by the user
+ *                     data buffer of the stream buffer object must not be placed in the core-coupled memory (CCM)
+ *
+ ******************************************************************************/
+
+void stm_dmaInit( stm_t *stm, DMA_Stream_TypeDef *dma, unsigned channel, volatile void *reg );
+
+/******************************************************************************
+ *
+ * Name              : stm_dmaUpdateISR
+ *
+ * Description       : make available all bytes transferred by the DMA stream since the last update
+ *                     and resume execution of the tasks waiting for data
+ *                     if the DMA stream has overwritten unread data, the oldest data is discarded
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   dma             : pointer to DMA stream bound to the stream buffer object
+ *
+ * Return            : number of bytes made available
+ *
+ * Note              : use only in handler mode, e.g. in the peripheral idle line interrupt handler
+ *
+ ******************************************************************************/
+
+unsigned stm_dmaUpdateISR( stm_t *stm, DMA_Stream_TypeDef *dma );
+
+/******************************************************************************
+ *
+ * Name              : stm_dmaHandlerISR
+ *
+ * Description       : clear interrupt flags of the DMA stream and update the stream buffer object
+ *                     readers are resumed only on half-transfer and transfer-complete boundaries
+ *
+ * Parameters
+ *   stm             : pointer to stream buffer object
+ *   dma             : pointer to DMA stream bound to the stream buffer object
+ *
+ * Return            : number of bytes made available
+ *
+ * Note              : use only in the DMA stream interrupt handler, e.g. DMA1_Stream5_IRQHandler
+ *
+ ******************************************************************************/
+
+unsigned stm_dmaHandlerISR( stm_t *stm, DMA_Stream_TypeDef *dma );
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOS_STREAMDMA_H
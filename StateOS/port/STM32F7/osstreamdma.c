@@ -0,0 +1,140 @@
+/******************************************************************************
+
+    @file    StateOS: osstreamdma.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   DMA helper for stream buffers on STM32F7 uC.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#include "osstreamdma.h"
+#include "inc/oscriticalsection.h"
+
+/* -------------------------------------------------------------------------- */
+static
+DMA_TypeDef *priv_dma_ctrl( DMA_Stream_TypeDef *dma )
+/* -------------------------------------------------------------------------- */
+{
+	return (DMA_TypeDef *)((uint32_t)dma & ~0xFFU);
+}
+
+/* -------------------------------------------------------------------------- */
+static
+void priv_dma_clear( DMA_Stream_TypeDef *dma )
+/* -------------------------------------------------------------------------- */
+{
+	static const uint8_t shift[4] = { 0, 6, 16, 22 };
+
+	DMA_TypeDef *ctrl = priv_dma_ctrl(dma);
+	unsigned     idx  = (((uint32_t)dma & 0xFFU) - 0x10U) / 0x18U;
+	uint32_t     flg  = 0x3DU << shift[idx & 3]; // FEIF, DMEIF, TEIF, HTIF, TCIF
+
+	if (idx < 4)
+		ctrl->LIFCR = flg;
+	else
+		ctrl->HIFCR = flg;
+}
+
+/* -------------------------------------------------------------------------- */
+void stm_dmaInit( stm_t *stm, DMA_Stream_TypeDef *dma, unsigned channel, volatile void *reg )
+/* -------------------------------------------------------------------------- */
+{
+	assert(!port_isr_inside());
+	assert(stm);
+	assert(stm->limit <= UINT16_MAX);
+	assert(port_dma_capable(stm->data));
+	assert(((uint32_t)stm->data % CACHE_LINE) == 0);
+	assert((stm->limit % CACHE_LINE) == 0);
+	assert(dma);
+	assert(channel < 8);
+	assert(reg);
+
+	sys_lock();
+	{
+		assert(stm->count == 0);
+
+		stm->head = 0;
+		stm->tail = 0;
+	}
+	sys_unlock();
+
+	RCC->AHB1ENR |= (priv_dma_ctrl(dma) == DMA1) ? RCC_AHB1ENR_DMA1EN : RCC_AHB1ENR_DMA2EN;
+
+	dma->CR &= ~DMA_SxCR_EN;
+	while (dma->CR & DMA_SxCR_EN);
+	priv_dma_clear(dma);
+
+	dma->PAR  = (uint32_t) reg;
+	dma->M0AR = (uint32_t) stm->data;
+	dma->NDTR = stm->limit;
+	dma->FCR  = 0;
+	dma->CR   = (channel << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE | DMA_SxCR_EN;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stm_dmaUpdateISR( stm_t *stm, DMA_Stream_TypeDef *dma )
+/* -------------------------------------------------------------------------- */
+{
+	const void *next;
+	void     *data;
+	unsigned  pos;
+	unsigned  len;
+	unsigned  cnt;
+
+	assert(stm);
+	assert(dma);
+
+	sys_lock();
+	{
+		pos = stm->limit - dma->NDTR;
+		if (pos >= stm->limit) pos = 0;
+		len = (pos >= stm->tail) ? pos - stm->tail : pos + stm->limit - stm->tail;
+
+		if (len > stm_spaceISR(stm))				// unread data has been overwritten
+			while ((cnt = stm_peekISR(stm, &next)) > 0)
+				stm_consumeISR(stm, cnt);
+
+		for (pos = len; pos > 0; pos -= cnt)
+		{
+			cnt = stm_reserveISR(stm, &data, pos);
+			port_cache_invalidate(data, cnt);
+			stm_commitISR(stm, cnt);
+		}
+	}
+	sys_unlock();
+
+	return len;
+}
+
+/* -------------------------------------------------------------------------- */
+unsigned stm_dmaHandlerISR( stm_t *stm, DMA_Stream_TypeDef *dma )
+/* -------------------------------------------------------------------------- */
+{
+	priv_dma_clear(dma);
+
+	return stm_dmaUpdateISR(stm, dma);
+}
+
+/* -------------------------------------------------------------------------- */
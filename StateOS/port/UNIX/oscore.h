@@ -0,0 +1,665 @@
+/******************************************************************************
+
+    @file    StateOS: oscore.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   StateOS port file for x86-64 POSIX hosts.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOSCORE_H
+#define __STATEOSCORE_H
+
+#include <unistd.h>
+#include "osbase.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_HEAP_SIZE
+#define OS_HEAP_SIZE          0 /* default system heap: all free memory       */
+#endif
+
+#ifndef OS_HEAP_TLSF
+#define OS_HEAP_TLSF          0 /* system heap uses first-fit allocator       */
+#endif
+
+#ifndef OS_HEAP_SLAB
+#define OS_HEAP_SLAB          0 /* control blocks allocated from system heap  */
+#endif
+
+#ifndef OS_HEAP_QUOTA
+#define OS_HEAP_QUOTA         0 /* system heap usage is not charged to tasks  */
+#endif
+
+#ifndef OS_HEAP_COALESCE
+#define OS_HEAP_COALESCE      0 /* free segments are merged during allocation */
+#endif
+
+#if     OS_HEAP_COALESCE && (OS_HEAP_SIZE == 0 || OS_HEAP_TLSF)
+#error  osconfig.h: OS_HEAP_COALESCE requires the first-fit system heap (OS_HEAP_SIZE without OS_HEAP_TLSF).
+#endif
+
+#ifndef OS_LIBC_MUTEX
+#define OS_LIBC_MUTEX         0 /* c library locks mask interrupts            */
+#endif
+
+#if     OS_LIBC_MUTEX
+#error  osconfig.h: OS_LIBC_MUTEX is only available on Cortex-M ports.
+#endif
+
+/* -------------------------------------------------------------------------- */
+// host signal frames are pushed onto the stack of the interrupted task
+
+#ifndef OS_STACK_SIZE
+#define OS_STACK_SIZE     16384 /* default task stack size in bytes           */
+#endif
+
+#ifndef OS_IDLE_STACK
+#define OS_IDLE_STACK     16384 /* idle task stack size in bytes              */
+#endif
+
+#ifndef OS_ISR_STACK
+#define OS_ISR_STACK          0 /* dedicated interrupt stack not supported    */
+#endif
+
+#if     OS_ISR_STACK
+#error  osconfig.h: OS_ISR_STACK is not supported by the host port.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_LOCK_LEVEL
+#define OS_LOCK_LEVEL         0 /* critical section blocks all interrupts     */
+#endif
+
+#if     OS_LOCK_LEVEL
+#error  osconfig.h: OS_LOCK_LEVEL is not supported by the host port.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MAIN_PRIO
+#define OS_MAIN_PRIO          0 /* priority of main process                   */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_PRIO_BITMAP
+#define OS_PRIO_BITMAP        0 /* tasks queue without priority bitmap        */
+#endif
+
+#if     OS_PRIO_BITMAP > 1024
+#error  osconfig.h: Incorrect OS_PRIO_BITMAP value! Must be less or equal 1024.
+#endif
+
+#if     OS_PRIO_BITMAP && (OS_MAIN_PRIO >= OS_PRIO_BITMAP)
+#error  osconfig.h: Incorrect OS_MAIN_PRIO value! Must be less then OS_PRIO_BITMAP.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_EDF_PRIO
+#define OS_EDF_PRIO           0 /* no earliest-deadline-first priority level  */
+#endif
+
+#if     OS_PRIO_BITMAP && (OS_EDF_PRIO >= OS_PRIO_BITMAP)
+#error  osconfig.h: Incorrect OS_EDF_PRIO value! Must be less then OS_PRIO_BITMAP.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_COMPACT_TCB
+#define OS_COMPACT_TCB        0 /* full-size task control blocks              */
+#endif
+
+#if     OS_COMPACT_TCB && (OS_MAIN_PRIO > 255 || OS_EDF_PRIO > 255 || OS_PRIO_BITMAP > 256)
+#error  osconfig.h: OS_COMPACT_TCB requires task priorities less or equal 255.
+#endif
+
+#if     OS_COMPACT_TCB && OS_ROBIN && ((OS_FREQUENCY)/(OS_ROBIN) > 0xFFFF)
+#error  osconfig.h: OS_COMPACT_TCB requires time slice less or equal 0xFFFF ticks.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_RTC
+#define OS_TASK_RTC           0 /* no run-to-completion tasks                 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_ARENA
+#define OS_TASK_ARENA         0 /* tasks have no default arenas               */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_CACHE
+#define OS_TASK_CACHE         0 /* released work areas are freed immediately  */
+#endif
+
+#ifndef OS_TASK_REENT
+#define OS_TASK_REENT         0 /* tasks share the newlib reentrancy data     */
+#endif
+
+#if     OS_TASK_REENT
+#error  osconfig.h: OS_TASK_REENT is not supported by the host port.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TIMER_WHEEL
+#define OS_TIMER_WHEEL        0 /* sorted timers queue without timers wheel   */
+#endif
+
+#if     OS_TIMER_WHEEL & (OS_TIMER_WHEEL - 1)
+#error  osconfig.h: Incorrect OS_TIMER_WHEEL value! Must be a power of 2.
+#endif
+
+#if     OS_TIMER_WHEEL && HW_TIMER_SIZE
+#error  osconfig.h: OS_TIMER_WHEEL is not allowed in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TIMER_TASK
+#define OS_TIMER_TASK         0 /* timer callbacks executed by timer handler  */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_EVQ_LOCKFREE
+#define OS_EVQ_LOCKFREE       0 /* event queues without lock-free producer    */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_DEFER_SIZE
+#define OS_DEFER_SIZE         0 /* isr deferred calls are not available       */
+#endif
+
+#if     OS_DEFER_SIZE & (OS_DEFER_SIZE - 1)
+#error  osconfig.h: Incorrect OS_DEFER_SIZE value! Must be a power of 2.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_WAIT_QUEUES
+#define OS_WAIT_QUEUES        0 /* wait on address is not available           */
+#endif
+
+#if     OS_WAIT_QUEUES & (OS_WAIT_QUEUES - 1)
+#error  osconfig.h: Incorrect OS_WAIT_QUEUES value! Must be a power of 2.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_RCU_SIZE
+#define OS_RCU_SIZE           0 /* read-copy-update is not available          */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MEM_LOCKFREE
+#define OS_MEM_LOCKFREE       0 /* memory pools protected by critical section */
+#endif
+
+#ifndef OS_MEM_HEADERLESS
+#define OS_MEM_HEADERLESS     0 /* memory objects preceded by a link word     */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SEM_LOCKFREE
+#define OS_SEM_LOCKFREE       0 /* semaphores protected by critical section   */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MUT_LOCKFREE
+#define OS_MUT_LOCKFREE       0 /* fast mutexes protected by critical section */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SIG_LOCKFREE
+#define OS_SIG_LOCKFREE       0 /* signals protected by critical section      */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_FLG_LOCKFREE
+#define OS_FLG_LOCKFREE       0 /* flags protected by critical section        */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_THRESHOLD
+#define OS_TASK_THRESHOLD     0 /* tasks have no preemption thresholds        */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_BUDGET
+#define OS_TASK_BUDGET        0 /* task execution budgets are not available   */
+#endif
+
+#if     OS_TASK_BUDGET && HW_TIMER_SIZE
+#error  osconfig.h: OS_TASK_BUDGET is not allowed in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_AGING
+#define OS_TASK_AGING         0 /* ready tasks are not aged                   */
+#endif
+
+#if     OS_TASK_AGING && HW_TIMER_SIZE
+#error  osconfig.h: OS_TASK_AGING is not allowed in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_PARTITION
+#define OS_TASK_PARTITION     0 /* no time-partitioned scheduling             */
+#endif
+
+#if     OS_TASK_PARTITION && (OS_TASK_RTC || OS_RCU_SIZE)
+#error  osconfig.h: OS_TASK_PARTITION cannot be used with OS_TASK_RTC or OS_RCU_SIZE.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TIME_TRIGGER
+#define OS_TIME_TRIGGER       0 /* no time-triggered cyclic executive         */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_PERIOD_STATS
+#define OS_PERIOD_STATS       0 /* no overrun / jitter statistics of periods  */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MUT_SPIN
+#define OS_MUT_SPIN           0 /* fast mutex waiters block immediately       */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_MTX_DEPTH
+#define OS_MTX_DEPTH          0 /* unlimited priority inheritance chains      */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_NOINIT
+#define OS_NOINIT             0 /* object buffers are cleared at startup      */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_STATS
+#define OS_TASK_STATS         0 /* tasks without cpu usage accounting         */
+#endif
+
+#ifndef OS_TASK_ENERGY
+#define OS_TASK_ENERGY        0 /* tasks without energy accounting            */
+#endif
+
+#if     OS_TASK_ENERGY && !OS_TASK_STATS
+#error  osconfig.h: OS_TASK_ENERGY requires OS_TASK_STATS.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TASK_LATENCY
+#define OS_TASK_LATENCY       0 /* tasks without wake-to-run latency records  */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_LOCK_PROFILE
+#define OS_LOCK_PROFILE       0 /* critical sections are not profiled         */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_OBJ_STATS
+#define OS_OBJ_STATS          0 /* no contention statistics of objects        */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_STACK_MONITOR
+#define OS_STACK_MONITOR      0 /* task stacks are not monitored              */
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_STACK_GUARD
+#define OS_STACK_GUARD        0 /* task stacks without mpu guard region       */
+#endif
+
+#if     OS_STACK_GUARD
+#error  osconfig.h: OS_STACK_GUARD is not supported by the host port.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TRACE_SIZE
+#define OS_TRACE_SIZE         0 /* kernel events are not traced               */
+#endif
+
+#if     OS_TRACE_SIZE & (OS_TRACE_SIZE - 1)
+#error  osconfig.h: Incorrect OS_TRACE_SIZE value! Must be a power of 2.
+#endif
+
+#ifndef OS_TASK_PERF
+#define OS_TASK_PERF          0 /* tasks without hardware event counters      */
+#endif
+
+#if     OS_TASK_PERF
+#error  osconfig.h: OS_TASK_PERF is only available on Cortex-M ports.
+#endif
+
+#ifndef OS_TRACE_ITM
+#define OS_TRACE_ITM          0 /* kernel events are not streamed through ITM */
+#endif
+
+#if     OS_TRACE_ITM
+#error  osconfig.h: OS_TRACE_ITM is only available on Cortex-M ports.
+#endif
+
+#ifndef OS_PROFILE_SIZE
+#define OS_PROFILE_SIZE       0 /* pc-sampling profiler is not used           */
+#endif
+
+#if     OS_PROFILE_SIZE & (OS_PROFILE_SIZE - 1)
+#error  osconfig.h: Incorrect OS_PROFILE_SIZE value! Must be a power of 2.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SELECT
+#define OS_SELECT             0 /* wait-set objects are not available         */
+#endif
+
+#if     OS_SELECT > 31
+#error  osconfig.h: Incorrect OS_SELECT value! Must be not greater than 31.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_SYNC_SWITCH
+#define OS_SYNC_SWITCH        0 /* all context switches made by the port      */
+#endif
+
+#if     OS_SYNC_SWITCH
+#error  osconfig.h: OS_SYNC_SWITCH is only supported by the Cortex-M port.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef  __cplusplus
+
+#ifndef OS_FUNCTIONAL
+#define OS_FUNCTIONAL         1 /* include c++ functional library header      */
+#endif
+
+#ifndef OS_FUNCTIONAL_SIZE
+#define OS_FUNCTIONAL_SIZE   32 /* capacity of c++ function object in bytes   */
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+typedef uint32_t              lck_t;
+typedef struct { uint64_t v[2]; } __attribute__((aligned(16))) stk_t;
+
+/* -------------------------------------------------------------------------- */
+// task context
+
+typedef struct __ctx ctx_t;
+
+struct __ctx
+{
+	// context saved by the software (callee-saved registers)
+	uintptr_t reserved; // keeps the stack aligned to 16 bytes
+	uintptr_t r15, r14, r13;
+	fun_t   * r12;      // initial task function, used by port_ctx_start
+	uintptr_t rbx, rbp;
+	void   ( *rip )( void );
+	uintptr_t ret;      // dummy return address of the initial task function
+};
+
+// start a new task: clear the handler mode and jump to the function stored in r12
+void port_ctx_start( void );
+
+#define _CTX_INIT( pc ) { 0, 0, 0, 0, pc, 0, 0, port_ctx_start, 0 }
+
+/* -------------------------------------------------------------------------- */
+// init task context
+
+__STATIC_INLINE
+void port_ctx_init( ctx_t *ctx, fun_t *pc )
+{
+	ctx->r12 = pc;
+	ctx->rip = port_ctx_start;
+	ctx->ret = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+// emulation of the interrupt controller
+
+extern volatile lck_t    port_lck; // interrupts are masked
+extern volatile unsigned port_isr; // a handler (timer / context switch) is executed
+extern volatile unsigned port_pnd; // pending handlers
+
+#define PND_TIMER  1U // system timer handler is pending
+#define PND_SWITCH 2U // context switch handler is pending
+
+// execute all pending handlers if interrupts are not masked and no handler is executed
+void port_sys_pending( void );
+
+/* -------------------------------------------------------------------------- */
+// is procedure inside ISR?
+
+__STATIC_INLINE
+bool port_isr_inside( void )
+{
+	return (port_isr != 0U);
+}
+
+/* -------------------------------------------------------------------------- */
+// is procedure executed in thread mode or in a kernel-aware handler?
+// all emulated handlers are masked by critical sections
+
+__STATIC_INLINE
+bool port_isr_aware( void )
+{
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+// are interrupts masked?
+
+__STATIC_INLINE
+bool port_isr_masked( void )
+{
+	return (port_lck != 0U);
+}
+
+/* -------------------------------------------------------------------------- */
+// get current stack pointer
+
+__STATIC_INLINE
+void * port_get_sp( void )
+{
+	void *sp;
+	__asm volatile ("mov %%rsp, %0" : "=r" (sp));
+	return sp;
+}
+
+/* -------------------------------------------------------------------------- */
+// get index of the most significant bit set in non-zero value 'val'
+
+__STATIC_INLINE
+unsigned port_get_msb( uint32_t val )
+{
+	return 31U - (unsigned) __builtin_clz(val);
+}
+
+/* -------------------------------------------------------------------------- */
+// get current value of the cpu cycle counter
+
+#ifdef  HW_CYCLE_COUNTER
+#error  HW_CYCLE_COUNTER is an internal port definition!
+#endif
+
+#define HW_CYCLE_COUNTER
+
+__STATIC_INLINE
+uint32_t port_cyc_time( void )
+{
+	return (uint32_t) __builtin_ia32_rdtsc();
+}
+
+/* -------------------------------------------------------------------------- */
+// wait for a signal (interrupt)
+
+#define __WFI()             pause()
+
+/* -------------------------------------------------------------------------- */
+
+__STATIC_INLINE
+lck_t port_get_lock( void )
+{
+	return port_lck;
+}
+
+__STATIC_INLINE
+void port_put_lock( lck_t lck )
+{
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+	port_lck = lck;
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+	if (lck == 0U && port_pnd != 0U)
+		port_sys_pending();
+}
+
+__STATIC_INLINE
+void port_set_lock( void )
+{
+	port_lck = 1U;
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+}
+
+__STATIC_INLINE
+void port_clr_lock( void )
+{
+	port_put_lock(0U);
+}
+
+#define port_set_barrier()  __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#define port_mem_barrier()  __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/* -------------------------------------------------------------------------- */
+// atomically replace pointer '*ptr' with 'val' if it is still equal to 'old'
+
+__STATIC_INLINE
+bool port_atomic_cas( void * volatile *ptr, void *old, void *val )
+{
+	return __atomic_compare_exchange_n(ptr, &old, val, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically replace value '*ptr' with 'val' if it is still equal to 'old'
+
+__STATIC_INLINE
+bool port_atomic_cas32( volatile uint32_t *ptr, uint32_t old, uint32_t val )
+{
+	return __atomic_compare_exchange_n(ptr, &old, val, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically replace pointer '*ptr' with 'val' if it is still equal to 'old' and no task is waiting in queue '*que'
+
+__STATIC_INLINE
+bool port_atomic_cas_idle( void * volatile *ptr, void *old, void *val, void * volatile *que )
+{
+	bool  result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = (*ptr == old && *que == 0);
+	if (result) *ptr = val;
+	port_put_lock(lck);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+// atomically replace value '*ptr' with 'val' if it is still equal to 'old' and no task is waiting in queue '*que'
+
+__STATIC_INLINE
+bool port_atomic_cas32_idle( volatile uint32_t *ptr, uint32_t old, uint32_t val, void * volatile *que )
+{
+	bool  result;
+	lck_t lck = port_get_lock();
+	port_set_lock();
+	result = (*ptr == old && *que == 0);
+	if (result) *ptr = val;
+	port_put_lock(lck);
+	return result;
+}
+
+/* -------------------------------------------------------------------------- */
+// mask / unmask the interrupt 'irq' (interrupt service tasks)
+// there is no interrupt controller in the host simulation, simulated interrupts are never masked
+
+__STATIC_INLINE
+void port_irq_mask( unsigned irq )
+{
+	(void) irq;
+}
+
+__STATIC_INLINE
+void port_irq_unmask( unsigned irq )
+{
+	(void) irq;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//__STATEOSCORE_H
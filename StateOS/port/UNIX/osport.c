@@ -0,0 +1,292 @@
+/******************************************************************************
+
+    @file    StateOS: osport.c
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   StateOS port file for POSIX hosts.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#if defined(__unix__) && defined(__x86_64__) && defined(__GNUC__)
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // REG_RIP
+#endif
+
+#include <signal.h>
+#include <ucontext.h>
+#include <time.h>
+#include <sys/time.h>
+#include "oskernel.h"
+
+/******************************************************************************
+ Host simulation port
+ Tasks run in a single host thread, each on its own task stack.
+ Interrupts are emulated: masking sets flag 'port_lck', the host interval timer
+ (SIGALRM) plays the role of the system timer and the context switch handler
+ (PendSV) is executed when the last pending condition is cleared.
+ Host signal frames are pushed onto the stack of the interrupted task, so task
+ stacks must be much greater than on the target. Library functions that are
+ not async-signal-safe should be called from tasks inside critical sections.
+*******************************************************************************/
+
+volatile lck_t    port_lck = 0;
+volatile unsigned port_isr = 0;
+volatile unsigned port_pnd = 0;
+
+/* -------------------------------------------------------------------------- */
+
+#if OS_PROFILE_SIZE
+static volatile uintptr_t Sample = 0; // address of the code interrupted by the last timer signal
+#endif
+
+static
+void priv_sig_handler( int sig, siginfo_t *info, void *ctx )
+{
+	(void) sig;
+	(void) info;
+
+#if OS_PROFILE_SIZE
+	Sample = (uintptr_t)((ucontext_t *) ctx)->uc_mcontext.gregs[REG_RIP];
+#else
+	(void) ctx;
+#endif
+	__atomic_fetch_or(&port_pnd, PND_TIMER, __ATOMIC_SEQ_CST);
+	port_sys_pending();
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if HW_TIMER_SIZE
+
+static struct timespec Base;
+
+static
+void priv_tmr_set( uint64_t usec )
+{
+	struct itimerval tv = { { 0, 0 }, { (time_t)(usec / 1000000), (suseconds_t)(usec % 1000000) } };
+
+	setitimer(ITIMER_REAL, &tv, NULL);
+}
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+void port_sys_init( void )
+{
+	static bool init = false;
+	struct sigaction sa;
+
+	if (init) return;
+	init = true;
+
+	sa.sa_sigaction = priv_sig_handler;
+	sa.sa_flags     = SA_SIGINFO | SA_NODEFER | SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGALRM, &sa, NULL);
+
+#if HW_TIMER_SIZE == 0
+
+/******************************************************************************
+ Non-tick-less mode: configuration of system timer
+ It must generate interrupts with frequency OS_FREQUENCY
+*******************************************************************************/
+
+	{
+		struct itimerval tv = { { 0, 1000000 / (OS_FREQUENCY) }, { 0, 1000000 / (OS_FREQUENCY) } };
+
+		setitimer(ITIMER_REAL, &tv, NULL);
+	}
+
+#else //HW_TIMER_SIZE
+
+/******************************************************************************
+ Tick-less mode: configuration of system timer
+ The host monotonic clock is rescaled to frequency OS_FREQUENCY
+*******************************************************************************/
+
+	clock_gettime(CLOCK_MONOTONIC, &Base);
+
+#endif//HW_TIMER_SIZE
+}
+
+/* -------------------------------------------------------------------------- */
+
+#if HW_TIMER_SIZE
+
+/******************************************************************************
+ Tick-less mode: return current system time
+*******************************************************************************/
+
+#if     OS_TIMER_SIZE == 16
+uint16_t port_sys_time( void )
+#elif   OS_TIMER_SIZE == 32
+uint32_t port_sys_time( void )
+#else
+uint64_t port_sys_time( void )
+#endif
+{
+	struct timespec ts;
+	uint64_t nsec;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	nsec = (uint64_t)(ts.tv_sec - Base.tv_sec) * 1000000000U + (uint64_t)ts.tv_nsec - (uint64_t)Base.tv_nsec;
+
+	return (cnt_t)(nsec / (1000000000U / (OS_FREQUENCY)));
+}
+
+/******************************************************************************
+ Tick-less mode: set / clear time breakpoint, force timer interrupt
+*******************************************************************************/
+
+void port_tmr_stop( void )
+{
+	priv_tmr_set(0);
+}
+
+void port_tmr_start( uint64_t timeout )
+{
+	cnt_t    delay = (cnt_t)((cnt_t) timeout - port_sys_time());
+	uint64_t usec  = (uint64_t) delay * 1000000U / (OS_FREQUENCY);
+
+	priv_tmr_set(usec ? usec : 1);
+}
+
+void port_tmr_force( void )
+{
+	__atomic_fetch_or(&port_pnd, PND_TIMER, __ATOMIC_SEQ_CST);
+	port_sys_pending();
+}
+
+#else //HW_TIMER_SIZE
+
+void port_tmr_stop ( void )             {}
+void port_tmr_start( uint64_t timeout ) { (void) timeout; }
+void port_tmr_force( void )             {}
+
+#endif//HW_TIMER_SIZE
+
+/* -------------------------------------------------------------------------- */
+
+void port_ctx_switch( void )
+{
+	__atomic_fetch_or(&port_pnd, PND_SWITCH, __ATOMIC_SEQ_CST);
+	port_sys_pending();
+}
+
+/******************************************************************************
+ Context switch handler (PendSV)
+ Save callee-saved registers on the stack of the current task, switch the
+ stack pointer to the one returned by core_tsk_handler and restore registers
+*******************************************************************************/
+
+__attribute__((naked))
+static
+void priv_ctx_swap( void )
+{
+	__asm volatile
+	(
+"	push  %%rbp                    \n"
+"	push  %%rbx                    \n"
+"	push  %%r12                    \n"
+"	push  %%r13                    \n"
+"	push  %%r14                    \n"
+"	push  %%r15                    \n"
+"	sub   $8,    %%rsp             \n"
+"	mov   %%rsp, %%rdi             \n"
+"	call  core_tsk_handler         \n"
+"	mov   %%rax, %%rsp             \n"
+"	add   $8,    %%rsp             \n"
+"	pop   %%r15                    \n"
+"	pop   %%r14                    \n"
+"	pop   %%r13                    \n"
+"	pop   %%r12                    \n"
+"	pop   %%rbx                    \n"
+"	pop   %%rbp                    \n"
+"	ret                            \n"
+	::: "memory"
+	);
+}
+
+/* -------------------------------------------------------------------------- */
+
+__attribute__((naked))
+void port_ctx_start( void )
+{
+	__asm volatile
+	(
+"	movl  $0,    port_isr(%%rip)   \n"
+"	jmp  *%%r12                    \n"
+	::: "memory"
+	);
+}
+
+/* -------------------------------------------------------------------------- */
+
+__attribute__((naked))
+void core_tsk_flip( void *sp )
+{
+	__asm volatile
+	(
+"	mov   %[sp], %%rsp             \n"
+"	and   $-16,  %%rsp             \n"
+"	call  core_tsk_loop            \n"
+	:: [sp] "r" (sp) : "memory"
+	);
+}
+
+/******************************************************************************
+ Emulation of the interrupt controller: execute pending handlers
+*******************************************************************************/
+
+void port_sys_pending( void )
+{
+	while (port_lck == 0U && port_isr == 0U && port_pnd != 0U)
+	{
+		port_isr = 1U;
+
+		if (__atomic_fetch_and(&port_pnd, ~PND_TIMER, __ATOMIC_SEQ_CST) & PND_TIMER)
+		{
+		#if HW_TIMER_SIZE == 0
+			core_prf_sample(Sample);
+			core_sys_tick();
+		#else
+			core_tmr_handler();
+		#endif
+		}
+		else
+		if (__atomic_fetch_and(&port_pnd, ~PND_SWITCH, __ATOMIC_SEQ_CST) & PND_SWITCH)
+		{
+			priv_ctx_swap();
+		}
+
+		port_isr = 0U;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+#endif // __unix__ && __x86_64__ && __GNUC__
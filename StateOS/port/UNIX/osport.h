@@ -0,0 +1,177 @@
+/******************************************************************************
+
+    @file    StateOS: osport.h
+    @author  Rajmund Szymanski
+    @date    20.08.2018
+    @brief   StateOS port file for POSIX hosts.
+
+ ******************************************************************************
+
+   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+
+   Permission is hereby granted, free of charge, to any person obtaining a copy
+   of this software and associated documentation files (the "Software"), to
+   deal in the Software without restriction, including without limitation the
+   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+   sell copies of the Software, and to permit persons to whom the Software is
+   furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+   IN THE SOFTWARE.
+
+ ******************************************************************************/
+
+#ifndef __STATEOSPORT_H
+#define __STATEOSPORT_H
+
+#include <stdint.h>
+#ifndef   NOCONFIG
+#include "osconfig.h"
+#endif
+#include "osdefs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_FREQUENCY
+#define OS_FREQUENCY       1000 /* Hz */
+#endif
+
+/* -------------------------------------------------------------------------- */
+// !! WARNING! OS_TIMER_SIZE < HW_TIMER_SIZE may cause unexpected problems !!
+
+#ifndef OS_TIMER_SIZE
+#define OS_TIMER_SIZE        32 /* bit size of system timer counter           */
+#endif
+
+/* -------------------------------------------------------------------------- */
+// host monotonic clock is used as the hardware timer in tick-less mode
+
+#ifdef  HW_TIMER_SIZE
+#error  HW_TIMER_SIZE is an internal os definition!
+#elif   OS_FREQUENCY > 1000
+#define HW_TIMER_SIZE OS_TIMER_SIZE /* bit size of hardware timer             */
+#else
+#define HW_TIMER_SIZE         0 /* os does not work in tick-less mode         */
+#endif
+
+#if     OS_PROFILE_SIZE && HW_TIMER_SIZE
+#error  osconfig.h: OS_PROFILE_SIZE is not allowed in tick-less mode, samples are taken by the periodic system tick.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_ROBIN
+#define OS_ROBIN              0 /* system works in cooperative mode           */
+#endif
+
+#if     OS_ROBIN > OS_FREQUENCY
+#error  osconfig.h: Incorrect OS_ROBIN value!
+#endif
+
+#if     OS_ROBIN && HW_TIMER_SIZE
+#error  osconfig.h: OS_ROBIN is not supported by the host port in tick-less mode.
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#ifndef OS_TICKLESS_IDLE
+#define OS_TICKLESS_IDLE      0 /* system timer is not suppressed when idle   */
+#endif
+
+#if     OS_TICKLESS_IDLE
+#error  osconfig.h: OS_TICKLESS_IDLE is not supported by the host port.
+#endif
+
+/* -------------------------------------------------------------------------- */
+// return current system time
+
+#if HW_TIMER_SIZE
+
+#if     OS_TIMER_SIZE == 16
+uint16_t port_sys_time( void );
+#elif   OS_TIMER_SIZE == 32
+uint32_t port_sys_time( void );
+#else
+uint64_t port_sys_time( void );
+#endif
+
+#endif
+
+/* -------------------------------------------------------------------------- */
+// force yield system control to the next process
+
+void port_ctx_switch( void );
+
+/* -------------------------------------------------------------------------- */
+// reset context switch indicator
+
+__STATIC_INLINE
+void port_ctx_reset( void )
+{
+}
+
+/* -------------------------------------------------------------------------- */
+// clear time breakpoint
+
+void port_tmr_stop( void );
+
+/* -------------------------------------------------------------------------- */
+// set time breakpoint
+
+void port_tmr_start( uint64_t timeout );
+
+/* -------------------------------------------------------------------------- */
+// force timer interrupt
+
+void port_tmr_force( void );
+
+/* -------------------------------------------------------------------------- */
+// stop system timer interrupts for the low power mode managed by the application
+// not supported by the host port: return false, the system timer is not stopped
+
+__STATIC_INLINE
+bool port_sys_suspend( void )
+{
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+// restart system timer interrupts after the low power mode
+
+__STATIC_INLINE
+void port_sys_resume( void )
+{
+}
+
+/* -------------------------------------------------------------------------- */
+// the host has no core-coupled memory
+
+#define __FAST_DATA
+#define __FAST_NOINIT
+
+/* -------------------------------------------------------------------------- */
+// the host executes all code from the same memory
+
+#define __RAMFUNC
+
+/* -------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif
+
+/* -------------------------------------------------------------------------- */
+
+#endif//__STATEOSPORT_H
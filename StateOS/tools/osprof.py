@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+#******************************************************************************
+#
+#   @file    StateOS: osprof.py
+#   @author  Rajmund Szymanski
+#   @date    20.08.2018
+#   @brief   Report of the StateOS statistical pc-sampling profiler buffer.
+#
+#******************************************************************************
+#
+#   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a copy
+#   of this software and associated documentation files (the "Software"), to
+#   deal in the Software without restriction, including without limitation the
+#   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+#   sell copies of the Software, and to permit persons to whom the Software is
+#   furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+#   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+#   IN THE SOFTWARE.
+#
+#
+#   usage: osprof.py <dump> -n <names> [-t] [-l <lines>]
+#
+#   dump      : binary memory dump of the PROFILE object, e.g. made with gdb:
+#               dump binary value prof.bin PROFILE
+#   names     : text file with lines '<address> [<size>] <type> <name>', e.g. made with nm:
+#               arm-none-eabi-nm -n -S firmware.elf
+#               code addresses are mapped to the nearest preceding code symbol (types T, t, W, w),
+#               task addresses are mapped to the symbols of their objects
+#   -t        : print a separate histogram for every task
+#   lines     : max number of functions printed in every histogram (all by default)
+#
+#******************************************************************************
+
+import argparse
+import bisect
+import collections
+import struct
+import sys
+
+PRF_MAGIC = 0x46525053
+
+HEADER = struct.Struct('<4I')
+RECORD = struct.Struct('<2I')
+
+CODE = ('T', 't', 'W', 'w')
+
+def load_names(path):
+	names = {}
+	funcs = []
+	with open(path) as f:
+		for line in f:
+			fields = line.split()
+			if len(fields) < 2:
+				continue
+			try:
+				addr = int(fields[0], 16)
+			except ValueError:
+				continue
+			size = None
+			if len(fields) >= 4:
+				try:
+					size = int(fields[1], 16)
+				except ValueError:
+					pass
+			kind = fields[-2] if len(fields) >= 3 else 'T'
+			names[addr] = fields[-1]
+			if kind in CODE:
+				funcs.append((addr & ~1, size, fields[-1])) # thumb symbols have bit 0 set
+	funcs.sort()
+	return names, funcs
+
+def locate(funcs, addrs, pc):
+	i = bisect.bisect_right(addrs, pc) - 1
+	if i < 0:
+		return None
+	addr, size, name = funcs[i]
+	if size is not None and pc >= addr + size:
+		return None
+	return name
+
+def decode(data):
+	if len(data) < HEADER.size:
+		raise ValueError('dump too short')
+	magic, size, head, rate = HEADER.unpack_from(data, 0)
+	if magic != PRF_MAGIC:
+		raise ValueError('invalid magic number: 0x%08X' % magic)
+	if len(data) < HEADER.size + size * RECORD.size:
+		raise ValueError('dump too short for %d samples' % size)
+	count = min(head, size)
+	samples = [RECORD.unpack_from(data, HEADER.size + (n % size) * RECORD.size) for n in range(head - count, head)]
+	return samples, head, rate
+
+def report(title, hist, total, lines):
+	print('%s: %u samples' % (title, total))
+	for name, cnt in hist.most_common(lines):
+		print('  %6.2f%% %8u  %s' % (cnt * 100.0 / total, cnt, name))
+
+def main():
+	parser = argparse.ArgumentParser(description='Report StateOS pc-sampling profiler buffer.')
+	parser.add_argument('dump')
+	parser.add_argument('-n', '--names', required=True)
+	parser.add_argument('-t', '--tasks', action='store_true')
+	parser.add_argument('-l', '--lines', type=int, default=None)
+	args = parser.parse_args()
+
+	names, funcs = load_names(args.names)
+	addrs = [f[0] for f in funcs]
+	func = lambda pc: locate(funcs, addrs, pc) or '0x%08X' % pc
+	task = lambda tsk: names.get(tsk, '0x%08X' % tsk)
+
+	with open(args.dump, 'rb') as f:
+		data = f.read()
+
+	try:
+		samples, head, rate = decode(data)
+	except ValueError as e:
+		sys.exit('osprof: %s' % e)
+
+	if not samples:
+		sys.exit('osprof: no samples')
+
+	print('%u samples stored of %u taken, %u Hz, %.3f s' % (len(samples), head, rate, len(samples) / float(rate or 1)))
+
+	hist = collections.Counter(func(pc) for pc, tsk in samples)
+	tsks = collections.Counter(task(tsk) for pc, tsk in samples)
+	report('tasks', tsks, len(samples), None)
+	report('functions', hist, len(samples), args.lines)
+
+	if args.tasks:
+		for name, cnt in tsks.most_common():
+			hist = collections.Counter(func(pc) for pc, tsk in samples if task(tsk) == name)
+			report('task %s' % name, hist, cnt, args.lines)
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+#******************************************************************************
+#
+#   @file    StateOS: osswo.py
+#   @author  Rajmund Szymanski
+#   @date    20.08.2018
+#   @brief   Capture of the StateOS kernel events streamed through ITM / SWO.
+#
+#******************************************************************************
+#
+#   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a copy
+#   of this software and associated documentation files (the "Software"), to
+#   deal in the Software without restriction, including without limitation the
+#   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+#   sell copies of the Software, and to permit persons to whom the Software is
+#   furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+#   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+#   IN THE SOFTWARE.
+#
+#******************************************************************************
+#
+#   usage: osswo.py <capture> [-p <port>] [-f <frequency>] [-n <names>] [-j <json>]
+#
+#   capture   : raw ITM byte stream captured from the SWO pin (or '-' for stdin),
+#               e.g. made with openocd: tpiu config internal swo.bin uart off <cpu frequency>
+#               or streamed live: nc localhost <port> | osswo.py -
+#   port      : first ITM stimulus port of the kernel events (OS_TRACE_ITM), default: 1
+#   frequency : cpu frequency in Hz (CPU_FREQUENCY),
+#               timestamps are printed as raw cycle counts when omitted
+#   names     : text file with lines '<address> <name>', e.g. made with nm:
+#               arm-none-eabi-nm -n firmware.elf
+#   json      : write the timeline of running tasks and interrupt handlers
+#               in the trace event format (chrome://tracing, ui.perfetto.dev)
+#
+#   every kernel event is a record of four words (time, code, obj, arg) written to
+#   four consecutive stimulus ports; records dropped by the target are counted there
+#   in TRACE_LOST, records broken by the probe or by an overflow are counted here
+#
+#******************************************************************************
+
+import argparse
+import json
+import sys
+
+import ostrace
+
+class Decoder:
+	def __init__(self, port):
+		self.port = port
+		self.record = []
+		self.state = None  # pending packet: [bytes left, port, payload bytes] or None
+		self.skip = 0      # bytes left of a packet which is not decoded
+		self.cont = False  # protocol packet with continuation bytes in progress
+		self.broken = 0    # number of incomplete records
+		self.overflows = 0 # number of overflow packets
+
+	def _word(self, port, value):
+		idx = port - self.port
+		if idx < 0 or idx > 3:
+			return None
+		if idx != len(self.record):
+			if self.record:
+				self.broken += 1
+			self.record = []
+			if idx != 0:
+				self.broken += 1
+				return None
+		self.record.append(value)
+		if len(self.record) < 4:
+			return None
+		rec, self.record = tuple(self.record), []
+		return rec
+
+	def feed(self, data):
+		for byte in data:
+			if self.state:
+				self.state[2].append(byte)
+				self.state[0] -= 1
+				if self.state[0] == 0:
+					_, port, payload = self.state
+					self.state = None
+					if len(payload) == 4:
+						rec = self._word(port, int.from_bytes(payload, 'little'))
+						if rec:
+							yield rec
+				continue
+			if self.skip:
+				self.skip -= 1
+				continue
+			if self.cont:
+				self.cont = (byte & 0x80) != 0
+				continue
+			if byte == 0x00 or byte == 0x80:
+				continue  # synchronization packet
+			if byte == 0x70:
+				self.overflows += 1
+				if self.record:
+					self.broken += 1
+					self.record = []
+				continue
+			size = byte & 0x03
+			if size == 0:
+				self.cont = (byte & 0x80) != 0  # timestamp or extension packet
+				continue
+			size = 4 if size == 3 else size
+			if byte & 0x04:
+				self.skip = size  # hardware source packet (DWT)
+			else:
+				self.state = [size, byte >> 3, bytearray()]
+
+def chunks(path):
+	f = sys.stdin.buffer if path == '-' else open(path, 'rb')
+	with f:
+		while True:
+			data = f.read1(4096) if hasattr(f, 'read1') else f.read(4096)
+			if not data:
+				break
+			yield data
+
+def main():
+	parser = argparse.ArgumentParser(description='Decode StateOS kernel events streamed through ITM / SWO.')
+	parser.add_argument('capture')
+	parser.add_argument('-p', '--port', type=int, default=1)
+	parser.add_argument('-f', '--frequency', type=float, default=0)
+	parser.add_argument('-n', '--names')
+	parser.add_argument('-j', '--json')
+	args = parser.parse_args()
+
+	names = ostrace.load_names(args.names) if args.names else {}
+	name = lambda addr: names.get(addr, '0x%08X' % addr)
+	usec = lambda cyc: cyc * 1e6 / args.frequency if args.frequency else cyc
+
+	decoder = Decoder(args.port)
+	events = []
+	running = None  # (task, start) of the running task
+	first = None
+	last = 0
+	high = 0        # upper bits of the unwrapped 32-bit cycle counter
+
+	try:
+		for data in chunks(args.capture):
+			for time, code, obj, arg in decoder.feed(data):
+				if first is None:
+					first = last = time
+				if time < last and last - time > 0x80000000:
+					high += 1 << 32
+				last = time
+				stamp = high + time - first
+				if args.frequency:
+					text = '%14.3f us' % usec(stamp)
+				else:
+					text = '%10u cyc' % stamp
+				print('%s  %s' % (text, ostrace.describe(code, obj, arg, name)), flush=True)
+				if not args.json:
+					continue
+				if code == 3:
+					if running:
+						events.append({'name': name(running[0]), 'ph': 'X', 'pid': 0, 'tid': 'tasks',
+						               'ts': usec(running[1]), 'dur': usec(stamp - running[1])})
+					running = (obj, stamp)
+				elif code in (7, 8):
+					events.append({'name': 'isr %u' % arg, 'ph': 'B' if code == 7 else 'E', 'pid': 0, 'tid': 'isr',
+					               'ts': usec(stamp)})
+				else:
+					events.append({'name': ostrace.EVENTS.get(code, 'event %u' % code), 'ph': 'i', 's': 't', 'pid': 0,
+					               'tid': 'tasks', 'ts': usec(stamp), 'args': {'obj': name(obj), 'arg': arg}})
+	except KeyboardInterrupt:
+		pass
+
+	if args.json:
+		with open(args.json, 'w') as f:
+			json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, f)
+
+	sys.stderr.write('osswo: %u incomplete records, %u overflow packets\n' % (decoder.broken, decoder.overflows))
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+#******************************************************************************
+#
+#   @file    StateOS: ostrace.py
+#   @author  Rajmund Szymanski
+#   @date    20.08.2018
+#   @brief   Decoder of the StateOS kernel events trace buffer.
+#
+#******************************************************************************
+#
+#   Copyright (c) 2018 Rajmund Szymanski. All rights reserved.
+#
+#   Permission is hereby granted, free of charge, to any person obtaining a copy
+#   of this software and associated documentation files (the "Software"), to
+#   deal in the Software without restriction, including without limitation the
+#   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+#   sell copies of the Software, and to permit persons to whom the Software is
+#   furnished to do so, subject to the following conditions:
+#
+#   The above copyright notice and this permission notice shall be included
+#   in all copies or substantial portions of the Software.
+#
+#   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+#   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+#   IN THE SOFTWARE.
+#
+#******************************************************************************
+#
+#   usage: ostrace.py <dump> [-f <frequency>] [-n <names>]
+#
+#   dump      : binary memory dump of the TRACE object, e.g. made with gdb:
+#               dump binary value trace.bin TRACE
+#   frequency : timestamp frequency in Hz (CPU_FREQUENCY or OS_FREQUENCY),
+#               timestamps are printed as raw values when omitted
+#   names     : text file with lines '<address> <name>', e.g. made with nm:
+#               arm-none-eabi-nm -n firmware.elf
+#
+#******************************************************************************
+
+import argparse
+import struct
+import sys
+
+TRC_MAGIC = 0x43525453
+
+HEADER = struct.Struct('<4I')
+RECORD = struct.Struct('<4I')
+
+EVENTS = {
+	1: 'insert',
+	2: 'remove',
+	3: 'switch',
+	4: 'expire',
+	5: 'wait',
+	6: 'wakeup',
+	7: 'isr',
+	8: 'isrend',
+}
+
+WAKEUP = {
+	0x00000000: 'E_SUCCESS',
+	0xFFFFFFFF: 'E_STOPPED',
+	0xFFFFFFFE: 'E_TIMEOUT',
+}
+
+def load_names(path):
+	names = {}
+	with open(path) as f:
+		for line in f:
+			fields = line.split()
+			if len(fields) >= 2:
+				try:
+					names[int(fields[0], 16)] = fields[-1]
+				except ValueError:
+					pass
+	return names
+
+def describe(code, obj, arg, name):
+	event = EVENTS.get(code, 'event %u' % code)
+	if code in (1, 2):
+		info = 'prio %u' % arg
+	elif code in (3, 5):
+		info = name(arg)
+	elif code == 6:
+		info = WAKEUP.get(arg, '%u' % arg)
+	elif code in (7, 8):
+		info = 'id %u' % arg
+	else:
+		info = ''
+	return '%-6s %-24s %s' % (event, name(obj) if code not in (7, 8) else '-', info)
+
+def decode(data):
+	if len(data) < HEADER.size:
+		raise ValueError('dump too short')
+	magic, size, head, unit = HEADER.unpack_from(data, 0)
+	if magic != TRC_MAGIC:
+		raise ValueError('invalid magic number: 0x%08X' % magic)
+	if len(data) < HEADER.size + size * RECORD.size:
+		raise ValueError('dump too short for %d records' % size)
+	count = min(head, size)
+	for n in range(head - count, head):
+		yield RECORD.unpack_from(data, HEADER.size + (n % size) * RECORD.size), unit
+
+def main():
+	parser = argparse.ArgumentParser(description='Decode StateOS kernel trace buffer.')
+	parser.add_argument('dump')
+	parser.add_argument('-f', '--frequency', type=float, default=0)
+	parser.add_argument('-n', '--names')
+	args = parser.parse_args()
+
+	names = load_names(args.names) if args.names else {}
+	name = lambda addr: names.get(addr, '0x%08X' % addr)
+
+	with open(args.dump, 'rb') as f:
+		data = f.read()
+
+	first = None
+	try:
+		for (time, code, obj, arg), unit in decode(data):
+			if first is None:
+				first = time
+			delta = (time - first) & 0xFFFFFFFF
+			if args.frequency:
+				stamp = '%14.3f us' % (delta * 1e6 / args.frequency)
+			else:
+				stamp = '%10u %s' % (delta, 'cyc' if unit else 'tck')
+			print('%s  %s' % (stamp, describe(code, obj, arg, name)))
+	except ValueError as e:
+		sys.exit('ostrace: %s' % e)
+
+if __name__ == '__main__':
+	main()
@@ -52,6 +52,10 @@
 // critical sections protection level
 // OS_LOCK_LEVEL == 0 or  __CORTEX_M <  3 => entrance to a critical section blocks all interrupts
 // OS_LOCK_LEVEL >  0 and __CORTEX_M >= 3 => entrance to a critical section blocks interrupts with urgency lower or equal (the priority value greater or equal) than OS_LOCK_LEVEL
+//                                          interrupts with higher urgency are kernel-unaware (zero-latency): they must not use kernel functions
+//                                          except 'sys_defer' (OS_DEFER_SIZE), which is checked by assertion in critical sections
+// RISC-V port: OS_LOCK_LEVEL >  0 requires OS_CLIC, entrance to a critical section raises the interrupt threshold (mintthresh)
+//              to OS_LOCK_LEVEL, interrupts of the level higher than OS_LOCK_LEVEL are kernel-unaware
 // default value: 0
 #define OS_LOCK_LEVEL         0
 
@@ -60,6 +64,107 @@
 // default value: 0 (the same as priority of idle process)
 #define OS_MAIN_PRIO          0
 
+// ----------------------------
+// tasks queue mode, number of priority levels indexed by the ready bitmap
+// OS_PRIO_BITMAP == 0 => tasks queue is searched linearly, any priority value is allowed
+// OS_PRIO_BITMAP >  0 => tasks queue is indexed by the ready bitmap, priorities of all tasks must be less then OS_PRIO_BITMAP
+// maximum value: 1024
+// default value: 0
+// #define OS_PRIO_BITMAP        0
+
+// ----------------------------
+// earliest-deadline-first priority level
+// OS_EDF_PRIO == 0 => tasks of equal priority are scheduled in fifo (round-robin) order
+// OS_EDF_PRIO >  0 => ready tasks with priority OS_EDF_PRIO are ordered by their absolute deadlines (earliest first);
+//                     the deadline is set by 'tsk_sleepNext' / 'tmr_waitNext' to the end of the next period
+//                     or explicitly with 'tsk_setDeadline'; tasks of other priorities are scheduled as usual
+// OS_EDF_PRIO must be less then OS_PRIO_BITMAP (if set)
+// default value: 0
+// #define OS_EDF_PRIO           0
+
+// ----------------------------
+// task control block layout
+// OS_COMPACT_TCB == 0 => task priorities and time slices are full-size fields
+// OS_COMPACT_TCB >  0 => task priorities are bytes packed with the task's id and time slices are 16-bit fields,
+//                        12 bytes per task are saved on 32-bit targets; use together with OS_TIMER_SIZE == 16
+//                        to shorten also the delays; task priorities must be less or equal 255
+// default value: 0
+// #define OS_COMPACT_TCB        0
+
+// ----------------------------
+// run-to-completion tasks
+// OS_TASK_RTC == 0 => all tasks have their own stacks
+// OS_TASK_RTC >  0 => functions 'tsk_initRTC' / 'tsk_createRTC' start tasks executing their states to completion
+//                     once per notification; such tasks do not keep a context between the executions
+//                     and all of them of the same priority share one stack
+// default value: 0
+// #define OS_TASK_RTC           0
+
+// ----------------------------
+// default arenas of tasks
+// OS_TASK_ARENA == 0 => functions 'arn_setDefault' / 'arn_getDefault' / 'arn_allocDefault' are not available
+// OS_TASK_ARENA >  0 => every task holds a pointer to its default arena (arn_t), temporary objects of the task
+//                       are taken from that arena with 'arn_allocDefault' instead of the system heap
+// default value: 0
+// #define OS_TASK_ARENA         0
+
+// ----------------------------
+// cache of released task objects, maximum number of cached work areas (control block and stack)
+// OS_TASK_CACHE == 0 => work areas created by 'wrk_create' are returned to the system heap when released
+// OS_TASK_CACHE >  0 => up to OS_TASK_CACHE released work areas are kept and reused by 'wrk_create' for stacks of the same size
+// default value: 0
+// #define OS_TASK_CACHE         0
+
+// ----------------------------
+// newlib reentrancy structures of tasks (GNU compiler)
+// OS_TASK_REENT == 0 => all tasks share the global newlib reentrancy structure (errno, stdio streams, strtok, ...)
+// OS_TASK_REENT >  0 => a task calling 'tsk_reent' gets its own reentrancy structure, allocated on the system heap at the first call;
+//                       '_impure_ptr' is switched at every context switch; other tasks keep using the global structure;
+//                       the structure is reclaimed when the task object is returned to the system heap
+// default value: 0
+// #define OS_TASK_REENT         0
+
+// ----------------------------
+// timers queue mode, number of spokes of the timers wheel
+// OS_TIMER_WHEEL == 0 => timers queue is sorted, inserting a timer is proportional to the number of running timers
+// OS_TIMER_WHEEL >  0 => running timers are hashed into OS_TIMER_WHEEL spokes by their expiration time, inserting a timer takes constant time
+// OS_TIMER_WHEEL must be a power of 2 and is not allowed in tick-less mode (OS_FREQUENCY > 1000)
+// default value: 0
+// #define OS_TIMER_WHEEL        0
+
+// ----------------------------
+// idle mode
+// OS_TICKLESS_IDLE == 0 => system timer generates interrupts with frequency OS_FREQUENCY also when idle
+// OS_TICKLESS_IDLE >  0 => system timer interrupts are suppressed in the idle task until the nearest timeout
+// OS_TICKLESS_IDLE is not allowed in tick-less mode (OS_FREQUENCY > 1000) and together with OS_TIMER_WHEEL
+// default value: 0
+// #define OS_TICKLESS_IDLE      0
+
+// ----------------------------
+// runtime cpu clock scaling (STM32 ports)
+// OS_CPU_SCALING == 0 => cpu frequency is constant (CPU_FREQUENCY)
+// OS_CPU_SCALING >  0 => port_sys_setFrequency switches the cpu clock (port_clk_config) and rescales SysTick / TIM2 without losing system ticks
+// OS_CPU_SCALING is not allowed together with OS_TICKLESS_IDLE and requires OS_ROBIN_TIM2 in tick-less mode with preemption
+// default value: 0
+// #define OS_CPU_SCALING        0
+
+// ----------------------------
+// cpu frequency governor (STM32 ports), period of load measurement (in system ticks)
+// OS_CPU_GOVERNOR == 0 => cpu frequency is only changed by the application
+// OS_CPU_GOVERNOR >  0 => every OS_CPU_GOVERNOR ticks the frequency is chosen by port_cpu_governor from the idle time of the last period
+// OS_CPU_GOVERNOR requires OS_CPU_SCALING and OS_TASK_STATS and is not allowed in tick-less mode (OS_FREQUENCY > 1000)
+// default value: 0
+// #define OS_CPU_GOVERNOR       0
+
+// ----------------------------
+// timer service task, priority of the task executing timer callbacks
+// OS_TIMER_TASK == 0 => timer callbacks are executed by the timer interrupt handler with the kernel locked
+// OS_TIMER_TASK >  0 => expired timers are handed over in a batch to the timer service task with priority OS_TIMER_TASK,
+//                       callbacks are preemptible and the timer handler returns in time independent of the callbacks;
+//                       callbacks must not block and expirations missed by a late periodic callback are merged
+// default value: 0
+// #define OS_TIMER_TASK         0
+
 // ----------------------------
 // os heap size in bytes
 // OS_HEAP_SIZE == 0 => functions 'xxx_create' use 'malloc' provided with the compiler libraries
@@ -67,6 +172,403 @@
 // default value: 0
 #define OS_HEAP_SIZE          0
 
+// ----------------------------
+// os heap allocator (used only when OS_HEAP_SIZE > 0)
+// OS_HEAP_TLSF == 0 => first-fit allocator, allocation time depends on heap fragmentation
+// OS_HEAP_TLSF >  0 => two-level segregated fit allocator, allocation and release take bounded time
+// default value: 0
+// #define OS_HEAP_TLSF          0
+
+// ----------------------------
+// slab allocator for kernel control blocks (number of objects in each size class: 16, 32 and 64 bytes)
+// OS_HEAP_SLAB == 0 => all objects are allocated from the system heap
+// OS_HEAP_SLAB >  0 => objects up to 64 bytes (semaphores, mutexes, timers, ...) are taken from memory pools in O(1) time,
+//                      larger objects and requests exceeding the pool capacity are allocated from the system heap
+// default value: 0
+// #define OS_HEAP_SLAB          0
+
+// ----------------------------
+// system heap quotas
+// OS_HEAP_QUOTA == 0 => functions 'sys_heapQuota' / 'sys_quotaInfo' are not available
+// OS_HEAP_QUOTA >  0 => every memory segment allocated from the system heap records its owner (heap quota of the allocating task)
+//                       in its header, live bytes are tracked per owner and allocations exceeding the quota fail at once;
+//                       objects taken from the slab pools (OS_HEAP_SLAB) are not charged
+// default value: 0
+// #define OS_HEAP_QUOTA         0
+
+// ----------------------------
+// incremental coalescing of the first-fit system heap (number of segments visited in one pass)
+// OS_HEAP_COALESCE == 0 => adjacent free memory segments are merged by the allocation walk
+// OS_HEAP_COALESCE >  0 => adjacent free memory segments are merged by the idle task, OS_HEAP_COALESCE segments in one pass
+//                          with interrupts enabled between the passes; the allocation walk does not merge segments,
+//                          only an allocation that fails with merges pending coalesces the whole heap and retries;
+//                          requires OS_HEAP_SIZE > 0, not available with OS_HEAP_TLSF
+// default value: 0
+// #define OS_HEAP_COALESCE      0
+
+// ----------------------------
+// locks of the c library (newlib __malloc_lock, ARM / IAR library mutexes) on Cortex-M ports
+// OS_LIBC_MUTEX == 0 => library locks mask interrupts for the whole duration of the guarded call (e.g. 'malloc')
+// OS_LIBC_MUTEX >  0 => library locks use one recursive kernel mutex with priority inheritance; interrupts are masked
+//                       only in handler mode and inside critical sections, where the mutex cannot be waited for;
+//                       library calls guarded by the locks must not be used in handler mode while a task is inside them
+// default value: 0
+// #define OS_LIBC_MUTEX         0
+
+// ----------------------------
+// fast mutex adaptive waiting, max number of spin iterations before blocking
+// OS_MUT_SPIN == 0 => a task waiting for an owned fast mutex blocks immediately and the mutex is handed over on release
+// OS_MUT_SPIN >  0 => a waiting task first yields the cpu up to OS_MUT_SPIN times while the owner is ready to run,
+//                     then blocks; the owner of a short critical region can release and take the mutex again without a handover
+// default value: 0
+// #define OS_MUT_SPIN           0
+
+// ----------------------------
+// mutex priority inheritance depth, max number of tasks in a chain of mutex owners updated by one priority change
+// OS_MTX_DEPTH == 0 => the priority is propagated along the whole chain of owners
+// OS_MTX_DEPTH >  0 => propagation stops after OS_MTX_DEPTH tasks, bounding the time spent in the critical section
+//                     (owners deeper in the chain keep their previous priority until they are updated again)
+// default value: 0
+// #define OS_MTX_DEPTH          0
+
+// ----------------------------
+// event queue lock-free producer
+// OS_EVQ_LOCKFREE == 0 => all event queue functions use critical sections
+// OS_EVQ_LOCKFREE >  0 => function 'evq_postISR' is available, single isr producer never masks interrupts
+//                         and blocked consumer is woken from the context switch handler
+// default value: 0
+// #define OS_EVQ_LOCKFREE       0
+
+// ----------------------------
+// deferred interrupt work
+// OS_DEFER_SIZE == 0 => function 'sys_defer' is not available
+// OS_DEFER_SIZE >  0 => size of the lock-free ring of deferred calls; interrupt handlers queue calls with 'sys_defer'
+//                       without masking interrupts and the context switch handler executes them before choosing the next task
+// OS_DEFER_SIZE must be a power of 2
+// default value: 0
+// #define OS_DEFER_SIZE         0
+
+// ----------------------------
+// wait on address (futex-style blocking for user lock-free structures)
+// OS_WAIT_QUEUES == 0 => functions 'sys_waitAddr' / 'sys_wakeAddr' are not available
+// OS_WAIT_QUEUES >  0 => number of wait queues; a waiting task is placed in the queue selected by a hash of the address,
+//                        addresses sharing a queue are told apart by 'sys_wakeAddr'
+// OS_WAIT_QUEUES must be a power of 2
+// default value: 0
+// #define OS_WAIT_QUEUES        0
+
+// ----------------------------
+// read-copy-update (deferred reclamation of read-mostly data)
+// OS_RCU_SIZE == 0 => functions 'rcu_readLock' / 'rcu_readUnlock' / 'rcu_retire' are not available
+// OS_RCU_SIZE >  0 => size of the list of retired blocks; every task gets a counter of nested read-side sections
+//                     and the idle task frees the retired blocks when no task is inside a read-side section
+// default value: 0
+// #define OS_RCU_SIZE           0
+
+// ----------------------------
+// memory pool lock-free fast path
+// OS_MEM_LOCKFREE == 0 => all memory pool functions use critical sections
+// OS_MEM_LOCKFREE >  0 => functions 'mem_take' / 'mem_give' use lock-free stack of free objects (tagged index, LDREX / STREX),
+//                         'mem_give' enters critical section only when a task is waiting; memory pool can hold up to 65535 objects
+// default value: 0
+// #define OS_MEM_LOCKFREE       0
+
+// ----------------------------
+// memory pool headerless objects
+// OS_MEM_HEADERLESS == 0 => every memory object is preceded by a link word (que_t), used by the free list of the memory pool
+//                           and by list objects (lst_t); memory objects can be transferred to list objects
+// OS_MEM_HEADERLESS >  0 => the link of the free list is stored inside the free memory object itself,
+//                           memory objects have no per-object overhead; memory objects can't be transferred to list objects
+// default value: 0
+// #define OS_MEM_HEADERLESS     0
+
+// ----------------------------
+// semaphore lock-free fast path
+// OS_SEM_LOCKFREE == 0 => all semaphore functions use critical sections
+// OS_SEM_LOCKFREE >  0 => semaphore value is updated with LDREX / STREX (Cortex-M3 and above) when no task is waiting,
+//                         critical section is entered only when a task is waiting or the semaphore can't be taken / given;
+//                         'sem_give' / 'sem_send' keep the critical section when OS_SELECT is set
+// default value: 0
+// #define OS_SEM_LOCKFREE       0
+
+// ----------------------------
+// fast mutex lock-free fast path
+// OS_MUT_LOCKFREE == 0 => all fast mutex functions use critical sections
+// OS_MUT_LOCKFREE >  0 => owner of a fast mutex is updated with LDREX / STREX (Cortex-M3 and above) when no task is waiting,
+//                         critical section is entered only when the fast mutex is owned by another task or a task is waiting for it
+// default value: 0
+// #define OS_MUT_LOCKFREE       0
+
+// ----------------------------
+// signal lock-free fast path
+// OS_SIG_LOCKFREE == 0 => all signal functions use critical sections
+// OS_SIG_LOCKFREE >  0 => 'sig_give' sets the signal with a single store and enters critical section only when a task is waiting;
+//                         'sig_give' keeps the critical section when OS_SELECT is set
+// default value: 0
+// #define OS_SIG_LOCKFREE       0
+
+// ----------------------------
+// flag lock-free fast path
+// OS_FLG_LOCKFREE == 0 => all flag functions use critical sections
+// OS_FLG_LOCKFREE >  0 => 'flg_give' sets the flags with LDREX / STREX (Cortex-M3 and above) and enters critical section
+//                         only when a task is waiting
+// default value: 0
+// #define OS_FLG_LOCKFREE       0
+
+// ----------------------------
+// placement of object buffers
+// OS_NOINIT == 0 => stacks and data buffers defined with OS_XXX / static_XXX macros are zeroed by the startup code
+// OS_NOINIT >  0 => stacks and data buffers defined with OS_XXX / static_XXX macros are placed in the '.noinit' section
+//                   and are not zeroed at startup; these macros must then be used only at file scope or as static_XXX
+// individual objects can be placed there regardless of OS_NOINIT with OS_XXX_NOINIT / static_XXX_NOINIT macros
+// (tasks, stream buffers, message buffers, mailbox queues, memory pools)
+// default value: 0
+// #define OS_NOINIT             0
+
+// ----------------------------
+// placement of kernel data in the core-coupled memory (STM32F4, gcc)
+// OS_FAST_RAM == 0 => kernel control data (System, MAIN, IDLE, WAIT, ready bitmap, timers wheel) and idle stack are placed in the main sram
+// OS_FAST_RAM >  0 => kernel control data and idle stack are placed in the zero-wait-state CCM, not contending with DMA on the bus matrix;
+//                     task stacks can be placed there with __FAST_NOINIT, e.g.: __FAST_NOINIT static stk_t stack[SSIZE(size)];
+//                     CCM is not accessible by DMA, stream buffers used with stm_dmaInit must not be placed there
+// default value: 0
+// #define OS_FAST_RAM           0
+
+// ----------------------------
+// placement of the kernel hot paths in the sram (STM32F4, gcc)
+// OS_RAMFUNC == 0 => context switch handler, system timer handlers and ready / timers queue helpers are executed from flash
+// OS_RAMFUNC >  0 => these functions are placed in the '.ramfunc' section, copied to the sram with '.data' at startup,
+//                    and are executed without flash wait states and ART accelerator misses
+//                    compare BENCH_SWITCH and BENCH_TICK in examples/_bench_kernel.c_
+// default value: 0
+// #define OS_RAMFUNC            0
+
+// ----------------------------
+// timer of the round-robin time slice in tick-less mode (STM32F4, STM32F7)
+// OS_ROBIN_TIM2 == 0 => SysTick is reloaded with the time slice of the incoming task and triggers the context switch
+// OS_ROBIN_TIM2 >  0 => TIM2 channel 2 compares the deadline of the time slice, channel 1 is the time breakpoint of the timers queue;
+//                       SysTick is not used, both deadlines are served by the TIM2 interrupt handler
+// default value: 0
+// #define OS_ROBIN_TIM2         0
+
+// ----------------------------
+// tasks cpu usage accounting
+// OS_TASK_STATS == 0 => no accounting
+// OS_TASK_STATS >  0 => context switch handler records cpu cycles (DWT->CYCCNT) and switch count of every task,
+//                       function 'tsk_getStats' takes a snapshot of all tasks; requires Cortex-M3 or higher
+// default value: 0
+// #define OS_TASK_STATS         0
+
+// ----------------------------
+// tasks energy accounting
+// OS_TASK_ENERGY == 0 => no energy accounting
+// OS_TASK_ENERGY >  0 => cpu cycles of every task are converted into energy (pJ) with calibration constants set by 'nrg_calibrate'
+//                        and the current cpu frequency (port_cpu_frequency with OS_CPU_SCALING); time spent in low-power states
+//                        (idle sleep with OS_TICKLESS_IDLE and states reported by 'nrg_sleep') is charged to the idle task and recorded per state;
+//                        function 'tsk_getStats' / 'nrg_getTask' take a snapshot; requires OS_TASK_STATS
+// default value: 0
+// #define OS_TASK_ENERGY        0
+
+// ----------------------------
+// wake-to-run latency of tasks
+// OS_TASK_LATENCY == 0 => no latency records
+// OS_TASK_LATENCY >  0 => time from the wakeup of a task to the context switch to it is recorded with the cpu cycle counter
+//                         in log2 histogram of the task (LAT_BUCKETS entries); function 'tsk_getLatency' takes a snapshot;
+//                         requires Cortex-M3 or higher
+// default value: 0
+// #define OS_TASK_LATENCY       0
+
+// ----------------------------
+// hardware performance counters of tasks
+// OS_TASK_PERF == 0 => no per-task performance counters
+// OS_TASK_PERF >  0 => DWT counters (CYCCNT, CPICNT, EXCCNT, SLEEPCNT, LSUCNT, FOLDCNT) are attributed to the running task
+//                      at every context switch and system tick; functions 'perf_get' / 'perf_getTask' take a snapshot;
+//                      the event counters are 8-bit and wrap every 256 events, call 'perf_sample' from a fast periodic
+//                      interrupt for exact counts; requires Cortex-M3 or higher, not available on other ports
+// default value: 0
+// #define OS_TASK_PERF          0
+
+// ----------------------------
+// critical sections profiling
+// OS_LOCK_PROFILE == 0 => critical sections are not measured
+// OS_LOCK_PROFILE >  0 => every outermost sys_lock / sys_unlock section is timed with the cpu cycle counter (DWT->CYCCNT),
+//                         maximum length and log2 histogram are recorded per call site (__FILE__ / __LINE__);
+//                         time spent by a task blocked inside the section is not counted;
+//                         function 'sys_lockProfile' returns the list of recorded sites; requires Cortex-M3 or higher
+// default value: 0
+// #define OS_LOCK_PROFILE       0
+
+// ----------------------------
+// contention statistics of mutexes, semaphores and mailbox queues
+// OS_OBJ_STATS == 0 => no statistics
+// OS_OBJ_STATS >  0 => every mutex, semaphore and mailbox queue object counts acquisitions, acquisitions after a blocking wait,
+//                      blocking waits, cumulative and maximum time of the waits (in ticks);
+//                      function 'sys_objStats' returns the list of objects with recorded statistics;
+//                      the lock-free fast path of semaphores (OS_SEM_LOCKFREE) is not used
+// default value: 0
+// #define OS_OBJ_STATS          0
+
+// ----------------------------
+// preemption thresholds of tasks
+// OS_TASK_THRESHOLD == 0 => every ready task of higher priority preempts the running task at once
+// OS_TASK_THRESHOLD >  0 => function 'tsk_setThreshold' sets the preemption threshold of the current task; while the task is running
+//                           only tasks of priority above the threshold preempt it, other ready tasks wait until it blocks or yields
+// default value: 0
+// #define OS_TASK_THRESHOLD     0
+
+// ----------------------------
+// task execution budgets
+// OS_TASK_BUDGET == 0 => tasks can consume cpu time without limits
+// OS_TASK_BUDGET >  0 => function 'tsk_setBudget' limits the number of system ticks a task can run within its replenishment period;
+//                        a task that exhausts its budget is demoted to the lowest priority (0) until the next period
+//                        (priority inheritance of mutexes still applies); not allowed in tick-less mode
+// default value: 0
+// #define OS_TASK_BUDGET        0
+
+// ----------------------------
+// priority aging of ready tasks
+// OS_TASK_AGING == 0 => ready tasks are scheduled by strict priority and can be starved
+// OS_TASK_AGING >  0 => a ready task with the aging ceiling set by 'tsk_setAging' is raised by one priority level
+//                       every OS_TASK_AGING ticks it waits for the cpu, up to the ceiling; the raised priority is kept
+//                       until the first tick after the task has got the cpu; the tick handler walks the ready queue,
+//                       i.e. O(number of ready tasks) with every tick; not allowed in tick-less mode
+// default value: 0
+// #define OS_TASK_AGING         0
+
+// ----------------------------
+// time-partitioned scheduling
+// OS_TASK_PARTITION == 0 => all ready tasks are scheduled by priority
+// OS_TASK_PARTITION >  0 => function 'prt_start' starts the major frame: a cyclic table of windows timed by the system timer;
+//                           within each window only the tasks of the partition of the window ('tsk_setPartition')
+//                           and unpartitioned tasks are scheduled by priority; cannot be used with OS_TASK_RTC,
+//                           OS_RCU_SIZE or OS_SYNC_SWITCH
+// default value: 0
+// #define OS_TASK_PARTITION     0
+
+// ----------------------------
+// time-triggered cyclic executive
+// OS_TIME_TRIGGER == 0 => no time-triggered activities
+// OS_TIME_TRIGGER >  0 => function 'tte_start' starts the major frame: a static table of activities (function, offset, period)
+//                         released at exact offsets by the system timer (the hardware timer compare in tick-less mode);
+//                         activities run to completion in the system timer handler without touching the ready queue,
+//                         tasks are scheduled by priority in the slack between them
+// default value: 0
+// #define OS_TIME_TRIGGER       0
+
+// ----------------------------
+// periodic tasks health statistics
+// OS_PERIOD_STATS == 0 => overruns of periodic tasks are caught up silently
+// OS_PERIOD_STATS >  0 => 'tsk_sleepNext' / 'tmr_waitNext' count overruns (the next release time has already passed),
+//                         execute optional callback set with 'tsk_setOverrunHook' and record the maximum release jitter;
+//                         functions 'tsk_getOverruns' / 'tsk_getJitter' return the statistics of the task
+// default value: 0
+// #define OS_PERIOD_STATS       0
+
+// ----------------------------
+// task stack high-water mark monitoring
+// OS_STACK_MONITOR == 0 => task stacks are painted only in DEBUG mode, no monitoring
+// OS_STACK_MONITOR >  0 => task stack is painted when the task is started, the idle task examines the unused part
+//                          of stacks of all tasks incrementally (in short critical sections) and updates their
+//                          high-water marks; function 'tsk_stackUsed' returns the maximum stack usage of the task
+// default value: 0
+// #define OS_STACK_MONITOR      0
+
+// ----------------------------
+// task stack guard region
+// OS_STACK_GUARD == 0 => stack overflow is checked by assertion in DEBUG mode only
+// OS_STACK_GUARD >  0 => context switch handler programs mpu region 7 as a no-access region at the bottom
+//                        of stack of the incoming task, overflow causes immediate MemManage fault;
+//                        the guard region (32 bytes aligned to its size) takes up to 63 bytes of every task stack;
+//                        requires the mpu (Cortex-M3 or higher)
+// default value: 0
+// #define OS_STACK_GUARD        0
+
+// ----------------------------
+// kernel events trace buffer size (number of records)
+// OS_TRACE_SIZE == 0 => kernel events are not traced, hooks generate no code
+// OS_TRACE_SIZE >  0 => task insert / remove / switch / wait / wakeup and timer expiration events are stored in buffer TRACE,
+//                       the oldest record is overwritten; use StateOS/tools/ostrace.py to decode a memory dump of the buffer
+// OS_TRACE_SIZE must be a power of 2
+// default value: 0
+// #define OS_TRACE_SIZE         0
+
+// ----------------------------
+// live streaming of kernel events through ITM / SWO
+// OS_TRACE_ITM == 0 => kernel events are not streamed
+// OS_TRACE_ITM >  0 => every traced kernel event (see OS_TRACE_SIZE; also isr entry / exit recorded with 'sys_traceIsrEnter' /
+//                      'sys_traceIsrExit') is written as four words to ITM stimulus ports OS_TRACE_ITM .. OS_TRACE_ITM + 3,
+//                      timestamped with the cpu cycle counter; the kernel never waits for the stimulus fifo: events that
+//                      don't fit are dropped and counted in TRACE_LOST; the trace port (SWO) is configured by the debugger;
+//                      use StateOS/tools/osswo.py to decode a capture of the SWO stream; works with or without OS_TRACE_SIZE;
+//                      requires Cortex-M3 or higher
+// OS_TRACE_ITM must be in range 1 .. 28
+// default value: 0
+// #define OS_TRACE_ITM          0
+
+// ----------------------------
+// statistical pc-sampling profiler buffer size (number of samples)
+// OS_PROFILE_SIZE == 0 => profiler is not used
+// OS_PROFILE_SIZE >  0 => on every system tick the address of the interrupted code and the current task are stored
+//                         in buffer PROFILE, the oldest sample is overwritten; 'sys_profileReset' discards all samples;
+//                         use StateOS/tools/osprof.py to build per-function / per-task histograms from a memory dump of the buffer;
+//                         requires the periodic system tick (not allowed in tick-less mode), on cortex-m only the GNUCC port
+// OS_PROFILE_SIZE must be a power of 2
+// default value: 0
+// #define OS_PROFILE_SIZE       0
+
+// ----------------------------
+// maximum number of objects watched by a wait-set object (sel_t)
+// OS_SELECT == 0 => wait-set objects are not available, give paths of the objects generate no additional code
+// OS_SELECT >  0 => semaphores, signals, mailbox queues, stream buffers, message buffers and event queues notify
+//                   the wait-sets they were added to when they become ready; a task blocks on several objects at once with 'sel_wait'
+//                   the c++20 coroutine scheduler (CoScheduler) requires wait-sets and watches up to OS_SELECT awaited objects
+// OS_SELECT must not be greater than 31
+// default value: 0
+// #define OS_SELECT             0
+
+// ----------------------------
+// lazy fpu context switching (Cortex-M4F / M7 with GNUCC only)
+// OS_LAZY_FPU == 0 => registers s16 - s31 are saved / restored with every context switch of a task using the fpu
+// OS_LAZY_FPU == 1 => registers s16 - s31 stay in the fpu until another task executes fp instruction (UsageFault NOCP trap),
+//                     OS_LOCK_LEVEL is required and interrupts of the highest priority (0) must not use the fpu
+// default value: 0
+// #define OS_LAZY_FPU           0
+
+// ----------------------------
+// synchronous context switch for voluntary yields (Cortex-M3 and above with GNUCC only)
+// OS_SYNC_SWITCH == 0 => all context switches are made by PendSV exception
+// OS_SYNC_SWITCH == 1 => 'tsk_yield' switches to the next task of the same priority with a function call, saving only r4 - r11 and lr,
+//                        when the context of the next task was saved the same way; otherwise and for switches triggered by interrupts PendSV is used;
+//                        the switch runs on the stack of the yielding task, OS_LAZY_FPU, OS_TASK_RTC and the hardware stack limit (ARMv8-M) are not supported
+// default value: 0
+// #define OS_SYNC_SWITCH        0
+
+// ----------------------------
+// interrupt controller mode (RISC-V)
+// OS_CLIC == 0 => clint (direct) mode, the trap entry dispatches all interrupts, machine external interrupt is passed to 'port_irq_handler'
+// OS_CLIC >  0 => clic mode, non-vectored interrupts enter through the same trap entry, the interrupt level (mintstatus) tells if the
+//                 procedure is inside ISR; required by OS_LOCK_LEVEL; addresses and CLIC_INTCTLBITS follow the SiFive memory map by default
+// default value: 0
+// #define OS_CLIC               0
+
+// ----------------------------
+// interrupt stack size in bytes (RISC-V and Cortex-M)
+// RISC-V: handlers executed by the trap entry run on the interrupt stack, stacks of the tasks hold only the trap frame (128 bytes)
+// Cortex-M: OS_ISR_STACK == 0 => exceptions run on MSP, shared with the main task (startup stack, MAIN_TOP)
+//           OS_ISR_STACK >  0 => port_sys_init switches the main task to PSP (it stays on the startup stack)
+//                                and sets MSP to the top of the dedicated exception stack of OS_ISR_STACK bytes,
+//                                so the startup stack is sized for the main task only
+// the interrupt stack is painted by port_sys_init, function 'sys_isrStackUsed' returns its high-water mark
+// default value: 1024 (RISC-V), 0 (Cortex-M)
+// #define OS_ISR_STACK       1024
+
+// ----------------------------
+// capacity of c++ function object FUN_t in bytes (used with OS_FUNCTIONAL)
+// function objects (lambdas with captures) are stored in place without using the heap,
+// they must be trivially copyable and not greater than OS_FUNCTIONAL_SIZE
+// default value: 16
+// #define OS_FUNCTIONAL_SIZE   16
+
 // ----------------------------
 // default task stack size in bytes
 // default value: 256
@@ -82,3 +584,22 @@
 // available values: 16, 32, 64
 // default value: 32
 #define OS_TIMER_SIZE        32
+
+// ----------------------------
+// cmsis-rtos2 static object pools (number of objects of each type)
+// OS_THREAD_NUM, OS_TIMER_NUM, OS_EVFLAGS_NUM, OS_MUTEX_NUM, OS_SEMAPHORE_NUM, OS_MEMPOOL_NUM, OS_MSGQUEUE_NUM
+// == 0 => objects created without control block memory ('cb_mem') are allocated from the system heap
+// >  0 => such objects are taken from the static pool of the type in O(1) time, the system heap is used when the pool is empty;
+//         a pooled thread gets a stack of OS_STACK_SIZE bytes, a pooled memory pool / message queue gets OS_MEMPOOL_MEM / OS_MSGQUEUE_MEM bytes of data storage
+// default value: 0
+// #define OS_THREAD_NUM         0
+
+// ----------------------------
+// inline fast paths of the hot cmsis-rtos2 calls
+// (osThreadFlagsSet/Wait, osEventFlagsSet/Wait, osMutexAcquire/Release, osSemaphoreAcquire/Release,
+//  osMemoryPoolAlloc/Free, osMessageQueuePut/Get)
+// == 0 => the calls are out-of-line functions of cmsis_os2.c
+// == 1 => the calls are expanded inline in the caller: the native kernel call and a table-based status translation;
+//         the out-of-line functions remain available e.g. for prebuilt middleware and function pointers
+// default value: 0
+// #define OS_CMSIS_INLINE       0
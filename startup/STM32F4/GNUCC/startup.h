@@ -43,6 +43,9 @@ extern unsigned       __data_size [];
 extern unsigned        __bss_start[];
 extern unsigned        __bss_end  [];
 extern unsigned        __bss_size [];
+extern unsigned  __ccm_data_init_start[];
+extern unsigned       __ccm_data_start[];
+extern unsigned       __ccm_data_end  [];
 
 extern void(*__preinit_array_start[])();
 extern void(*__preinit_array_end  [])();
@@ -58,12 +61,45 @@ extern void(*   __fini_array_end  [])();
 __STATIC_INLINE
 void __startup_memcpy( unsigned *dst_, unsigned *end_, unsigned *src_ )
 {
+#if __CORTEX_M >= 3
+	/* Copy 8-word bursts with LDM / STM */
+	while (end_ - dst_ >= 8)
+	__ASM volatile
+	(
+"	ldmia %[src]!, { r3-r6, r8-r11 } \n"
+"	stmia %[dst]!, { r3-r6, r8-r11 } \n"
+	:	[dst] "+r" (dst_), [src] "+r" (src_)
+	:
+	:	"r3", "r4", "r5", "r6", "r8", "r9", "r10", "r11", "memory"
+	);
+#endif
 	while (dst_ < end_) *dst_++ = *src_++;
 }
 
 __STATIC_INLINE
 void __startup_memset( unsigned *dst_, unsigned *end_, unsigned val_ )
 {
+#if __CORTEX_M >= 3
+	/* Fill 8-word bursts with STM */
+	if (end_ - dst_ >= 8)
+	__ASM volatile
+	(
+"	mov   r3,  %[val]                \n"
+"	mov   r4,  %[val]                \n"
+"	mov   r5,  %[val]                \n"
+"	mov   r6,  %[val]                \n"
+"	mov   r8,  %[val]                \n"
+"	mov   r9,  %[val]                \n"
+"	mov   r10, %[val]                \n"
+"	mov   r11, %[val]                \n"
+"1:	stmia %[dst]!, { r3-r6, r8-r11 } \n"
+"	cmp   %[dst], %[lim]             \n"
+"	bls   1b                         \n"
+	:	[dst] "+r" (dst_)
+	:	[lim] "r" (end_ - 8), [val] "r" (val_)
+	:	"r3", "r4", "r5", "r6", "r8", "r9", "r10", "r11", "cc", "memory"
+	);
+#endif
 	while (dst_ < end_) *dst_++ = val_;
 }
 
@@ -72,8 +108,11 @@ void __startup_data_init( void )
 {
 	/* Initialize the data segment */
 	__startup_memcpy(__data_start, __data_end, __data_init_start);
+	/* Initialize the data segment in the core-coupled memory */
+	__startup_memcpy(__ccm_data_start, __ccm_data_end, __ccm_data_init_start);
 	/* Zero fill the bss segment */
 	__startup_memset(__bss_start, __bss_end, 0);
+	/* The noinit segment is left as it is */
 }
 
 #ifndef USE_CRT